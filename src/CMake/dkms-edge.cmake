@@ -59,6 +59,7 @@ SET (XRT_DKMS_DRIVER_SRCS
   zocl/Makefile
   zocl/zocl_aie.c
   zocl/zocl_bo.c
+  zocl/zocl_cma_pool.c
   zocl/zocl_cu.c
   zocl/zocl_dma.c
   zocl/zocl_drv.c
@@ -105,6 +106,7 @@ SET (XRT_DKMS_COMMON_XRT_DRV_INCLUDES
   common/drv/include/xrt_cu.h
   common/drv/include/xrt_xclbin.h
   common/drv/include/kds_stat.h
+  common/drv/include/xrt_drv_trace.h
   )
 
 SET (XRT_DKMS_CORE_EDGE_INCLUDES
@@ -68,6 +68,7 @@ SET (XRT_DKMS_DRIVER_SRCS
   xocl/userpf/common.h
   xocl/userpf/xocl_bo.c
   xocl/userpf/xocl_bo.h
+  xocl/userpf/xocl_pin_cache.c
   xocl/userpf/xocl_drm.c
   xocl/userpf/xocl_ioctl.c
   xocl/userpf/xocl_sysfs.c
@@ -306,6 +307,7 @@ SET (XRT_DKMS_COMMON_XRT_DRV_INCLUDES
   common/drv/include/xrt_ert.h
   common/drv/include/cu_xgq.h
   common/drv/include/xgq_execbuf.h
+  common/drv/include/xrt_drv_trace.h
   )
 
 SET (XRT_DKMS_ABS_SRCS)
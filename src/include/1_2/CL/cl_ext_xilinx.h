@@ -238,6 +238,67 @@ xclGetComputeUnitInfo(cl_kernel             kernel,
 #define XCL_COMPUTE_UNIT_CONNECTIONS  0x1322 // connectivity
 #define XCL_COMPUTE_UNIT_BASE_ADDRESS 0x1323 // base address
 
+/**
+ * Unified shared memory (USM) allocations
+ *
+ * USM allocations are referenced by pointer rather than by cl_mem.
+ * A pointer into a USM allocation can be set directly as global
+ * kernel argument with clSetKernelArgSVMPointer, no map or unmap is
+ * required before or after kernel execution.
+ *
+ * @xclHostMemAlloc:   host memory accessible by the device, returns
+ *                     host pointer
+ * @xclSharedMemAlloc: host memory accessed by host and device, the
+ *                     device accesses the memory in place
+ * @xclDeviceMemAlloc: device memory, returns device address which
+ *                     must not be dereferenced by host
+ *
+ * @context
+ *   Context of device
+ * @device
+ *   Device for allocation, may be NULL if context has one device
+ * @size
+ *   Size in bytes of allocation
+ * @errcode_ret
+ *   Error code, ignored if NULL
+ *
+ * Host and shared allocations require a host memory bank (HOST[0])
+ * in the xclbin loaded on the device.
+ *
+ * CL_INVALID_CONTEXT     : if context is not a valid context
+ * CL_INVALID_DEVICE      : if device is not in context, or if device
+ *                          is NULL and context has multiple devices
+ * CL_INVALID_BUFFER_SIZE : if size is 0
+ * CL_INVALID_OPERATION   : if no program is loaded on device, or if
+ *                          device has no host memory bank
+ */
+extern CL_API_ENTRY void* CL_API_CALL
+xclHostMemAlloc(cl_context context,
+                cl_device_id device,
+                size_t size,
+                cl_int* errcode_ret);
+
+extern CL_API_ENTRY void* CL_API_CALL
+xclSharedMemAlloc(cl_context context,
+                  cl_device_id device,
+                  size_t size,
+                  cl_int* errcode_ret);
+
+extern CL_API_ENTRY void* CL_API_CALL
+xclDeviceMemAlloc(cl_context context,
+                  cl_device_id device,
+                  size_t size,
+                  cl_int* errcode_ret);
+
+/**
+ * Free a USM allocation
+ *
+ * CL_INVALID_VALUE: if ptr is not returned by a USM allocation function
+ */
+extern CL_API_ENTRY cl_int CL_API_CALL
+xclMemFree(cl_context context,
+           void* ptr);
+
 /*
   Host Accessible Program Scope Globals
 */
@@ -24,12 +24,166 @@
 #include <pybind11/stl_bind.h>
 
 // C++11 includes
+#include <map>
 #include <mutex>
+#include <stdexcept>
 #include <thread>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
+namespace {
+
+// Set kernel arguments of a run from a sequence of Python objects,
+// buffer objects are set as global arguments, anything else as int
+void
+set_args(xrt::run& r, const py::handle& args)
+{
+    int i = 0;
+    for (auto item : args) {
+        if (py::isinstance<xrt::bo>(item))
+            r.set_arg(i, item.cast<xrt::bo&>());
+        else
+            r.set_arg<int>(i, item.cast<int>());
+        i++;
+    }
+}
+
+// asyncio futures waiting for completion of runs.  One completion
+// callback is added per run implementation, the callback resolves
+// all futures pending on the run when it completes.
+class async_waiters
+{
+    using run_key = const void*;
+    using waiter = std::pair<py::object, py::object>;  // event loop, future
+
+    std::mutex m_mutex;
+    std::map<run_key, std::weak_ptr<xrt::run_impl>> m_registered;
+    std::map<run_key, std::vector<waiter>> m_pending;
+
+    static void
+    resolve(std::vector<waiter>& waiters, ert_cmd_state state)
+    {
+        // never destroyed, must not outlive the interpreter
+        static auto set_result = new py::cpp_function([](py::object fut, ert_cmd_state st) {
+            if (!fut.attr("done")().cast<bool>())
+                fut.attr("set_result")(st);
+        });
+
+        for (auto& w : waiters) {
+            try {
+                w.first.attr("call_soon_threadsafe")(*set_result, w.second, state);
+            }
+            catch (const py::error_already_set&) {
+                // event loop is closed, nobody is waiting
+            }
+        }
+        waiters.clear();
+    }
+
+    // Called by XRT when a run completes, without the GIL
+    static void
+    notify(const void* key, ert_cmd_state state, void*)
+    {
+        auto& self = instance();
+        std::vector<waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lk(self.m_mutex);
+            auto itr = self.m_pending.find(key);
+            if (itr == self.m_pending.end() || itr->second.empty())
+                return;
+            waiters = std::move(itr->second);
+            self.m_pending.erase(itr);
+        }
+
+        py::gil_scoped_acquire acquire;
+        resolve(waiters, state);
+    }
+
+    // Resolve the future if the run has already completed
+    void
+    resolve_if_done(xrt::run& r, const py::object& fut)
+    {
+        auto state = r.state();
+        if (state < ERT_CMD_STATE_COMPLETED || state == ERT_CMD_STATE_SUBMITTED)
+            return;
+
+        std::vector<waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            auto itr = m_pending.find(r.get_handle().get());
+            if (itr == m_pending.end())
+                return;
+            auto& list = itr->second;
+            for (auto w = list.begin(); w != list.end(); ++w) {
+                if (w->second.is(fut)) {
+                    waiters.push_back(std::move(*w));
+                    list.erase(w);
+                    break;
+                }
+            }
+        }
+        resolve(waiters, state);
+    }
+
+public:
+    static async_waiters&
+    instance()
+    {
+        static auto waiters = new async_waiters;  // never destroyed, used by XRT threads
+        return *waiters;
+    }
+
+    // Return asyncio future resolved with the run state on completion
+    py::object
+    wait(xrt::run& r)
+    {
+        auto loop = py::module::import("asyncio").attr("get_event_loop")();
+        auto fut = loop.attr("create_future")();
+        auto& handle = r.get_handle();
+        run_key key = handle.get();
+
+        bool add_callback = false;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_pending[key].emplace_back(loop, fut);
+            auto itr = m_registered.find(key);
+            if (itr == m_registered.end() || itr->second.expired()) {
+                m_registered[key] = handle;
+                add_callback = true;
+            }
+        }
+
+        if (add_callback) {
+            try {
+                py::gil_scoped_release release;
+                r.add_callback(ERT_CMD_STATE_COMPLETED, &async_waiters::notify, nullptr);
+            }
+            catch (const std::exception&) {
+                // Callbacks cannot be added to a run that was started
+                // without any, wait for it in an executor thread.
+                {
+                    std::lock_guard<std::mutex> lk(m_mutex);
+                    m_registered.erase(key);
+                    m_pending.erase(key);
+                }
+                auto wait = py::cpp_function([r]() mutable {
+                    py::gil_scoped_release release;
+                    return r.wait(0);
+                });
+                return loop.attr("run_in_executor")(py::none(), wait);
+            }
+        }
+
+        resolve_if_done(r, fut);
+        return fut;
+    }
+};
+
+} // namespace
+
 PYBIND11_MAKE_OPAQUE(std::vector<xrt::xclbin::ip>);
 
 PYBIND11_MODULE(pyxrt, m) {
@@ -59,7 +213,8 @@ PYBIND11_MODULE(pyxrt, m) {
         .value("ERT_CMD_STATE_TIMEOUT", ert_cmd_state::ERT_CMD_STATE_TIMEOUT)
         .value("ERT_CMD_STATE_NORESPONSE", ert_cmd_state::ERT_CMD_STATE_NORESPONSE)
         .value("ERT_CMD_STATE_SKERROR", ert_cmd_state::ERT_CMD_STATE_SKERROR)
-        .value("ERT_CMD_STATE_SKCRASHED", ert_cmd_state::ERT_CMD_STATE_SKCRASHED);
+        .value("ERT_CMD_STATE_SKCRASHED", ert_cmd_state::ERT_CMD_STATE_SKCRASHED)
+        .value("ERT_CMD_STATE_EXPIRED", ert_cmd_state::ERT_CMD_STATE_EXPIRED);
 
     py::enum_<xrt::info::device>(m, "xrt_info_device", "Device feature and sensor information")
         .value("bdf", xrt::info::device::bdf)
@@ -99,9 +254,11 @@ PYBIND11_MODULE(pyxrt, m) {
                           return new xrt::device(bfd);
                       }))
         .def("load_xclbin", [](xrt::device& d, const std::string& xclbin) {
+                                py::gil_scoped_release release;
                                 return d.load_xclbin(xclbin);
                             }, "Load an xclbin given the path to the device")
         .def("load_xclbin", [](xrt::device& d, const xrt::xclbin& xclbin) {
+                                py::gil_scoped_release release;
                                 return d.load_xclbin(xclbin);
                             }, "Load the xclbin to the device")
         .def("get_xclbin_uuid", &xrt::device::get_xclbin_uuid, "Return the UUID object representing the xclbin loaded on the device")
@@ -155,6 +312,7 @@ PYBIND11_MODULE(pyxrt, m) {
         .def(py::init<>())
         .def(py::init<const xrt::kernel &>())
         .def("start", [](xrt::run& r){
+                          py::gil_scoped_release release;
                           r.start();
                       }, "Start one execution of a run")
         .def("set_arg", [](xrt::run& r, int i, xrt::bo& item){
@@ -164,11 +322,16 @@ PYBIND11_MODULE(pyxrt, m) {
                             r.set_arg<int&>(i, item);
                         }, "Set a specific kernel scalar argument for this run")
         .def("wait", ([](xrt::run& r)  {
+                           py::gil_scoped_release release;
                            return r.wait(0);
                       }), "Wait for the run to complete")
         .def("wait", ([](xrt::run& r, unsigned int timeout_ms)  {
+                          py::gil_scoped_release release;
                           return r.wait(timeout_ms);
                       }), "Wait for the specified milliseconds for the run to complete")
+        .def("wait_async", [](xrt::run& r) {
+                                return async_waiters::instance().wait(r);
+                            }, "Return an asyncio future that completes with the run state when the run completes")
         .def("state", &xrt::run::state, "Check the current state of a run object")
         .def("add_callback", &xrt::run::add_callback, "Add a callback function for run state");
 
@@ -186,26 +349,27 @@ PYBIND11_MODULE(pyxrt, m) {
                            return new xrt::kernel(d, u, n, m);
                        }))
         .def("__call__", [](xrt::kernel& k, py::args args) -> xrt::run {
-                             int i = 0;
                              xrt::run r(k);
-
-                             for (auto item : args) {
-                                 try {
-                                     r.set_arg(i, item.cast<xrt::bo>());
-                                 }
-                                 catch (std::exception e) {  }
-
-                                 try {
-                                     r.set_arg<int>(i, item.cast<int>());
-                                 }
-                                 catch (std::exception e) {  }
-
-                                 i++;
+                             set_args(r, args);
+                             {
+                                 py::gil_scoped_release release;
+                                 r.start();
                              }
-
-                             r.start();
                              return r;
                          })
+        .def("launch_many", [](xrt::kernel& k, py::iterable arg_list) {
+                                std::vector<xrt::run> runs;
+                                for (auto args : arg_list) {
+                                    runs.emplace_back(k);
+                                    set_args(runs.back(), args);
+                                }
+                                {
+                                    py::gil_scoped_release release;
+                                    for (auto& r : runs)
+                                        r.start();
+                                }
+                                return runs;
+                            }, "Start one run per sequence of arguments and return the list of runs")
         .def("group_id", &xrt::kernel::group_id, "Get the memory bank group id of an kernel argument");
 
 
@@ -214,7 +378,7 @@ PYBIND11_MODULE(pyxrt, m) {
  * xrt::bo
  *
  */
-    py::class_<xrt::bo> pybo(m, "bo", "Represents a buffer object");
+    py::class_<xrt::bo> pybo(m, "bo", py::buffer_protocol(), "Represents a buffer object");
 
     py::enum_<xrt::bo::flags>(pybo, "flags", "Buffer object creation flags")
         .value("normal", xrt::bo::flags::normal)
@@ -229,20 +393,51 @@ PYBIND11_MODULE(pyxrt, m) {
         .def(py::init<xrt::bo, size_t, size_t>(), "Create a sub-buffer of an existing buffer object of specifed size and offset in the existing buffer")
         .def("write", ([](xrt::bo &b, py::buffer pyb, size_t seek)  {
                            py::buffer_info info = pyb.request();
+                           py::gil_scoped_release release;
                            b.write(info.ptr, info.itemsize * info.size , seek);
                        }), "Write the provided data into the buffer object starting at specified offset")
         .def("read", ([](xrt::bo &b, size_t size, size_t skip) {
                           py::array_t<char> result = py::array_t<char>(size);
                           py::buffer_info bufinfo = result.request();
-                          b.read(bufinfo.ptr, size, skip);
+                          {
+                              py::gil_scoped_release release;
+                              b.read(bufinfo.ptr, size, skip);
+                          }
                           return result;
                       }), "Read from the buffer object requested number of bytes starting from specified offset")
+        .def("readinto", ([](xrt::bo &b, py::buffer pyb, size_t skip) {
+                              py::buffer_info info = pyb.request(true);
+                              size_t size = info.itemsize * info.size;
+                              py::gil_scoped_release release;
+                              b.read(info.ptr, size, skip);
+                              return size;
+                          }), "Read from the buffer object into a writable buffer, e.g. a numpy array, "
+                              "starting from specified offset; returns number of bytes read")
         .def("sync", ([](xrt::bo &b, xclBOSyncDirection dir, size_t size, size_t offset)  {
+                          py::gil_scoped_release release;
                           b.sync(dir, size, offset);
                       }), "Synchronize (DMA or cache flush/invalidation) the buffer in the requested direction")
         .def("map", ([](xrt::bo &b)  {
                          return py::memoryview::from_memory(b.map(), b.size());
                      }), "Create a byte accessible memory view of the buffer object")
+        .def("array", ([](py::object self, py::dtype dtype, std::vector<py::ssize_t> shape)  {
+                           auto& b = self.cast<xrt::bo&>();
+                           auto itemsize = static_cast<size_t>(dtype.itemsize());
+                           if (shape.empty())
+                               shape.push_back(b.size() / itemsize);
+                           size_t count = 1;
+                           for (auto dim : shape)
+                               count *= dim;
+                           if (count * itemsize > b.size())
+                               throw std::out_of_range("Array shape exceeds buffer object size");
+                           // The array refers to the mapped buffer and keeps the buffer object alive
+                           return py::array(dtype, shape, b.map(), self);
+                       }), py::arg("dtype"), py::arg("shape") = std::vector<py::ssize_t>(),
+             "Create a numpy array of specified dtype and shape over the mapped buffer object without copying")
+        .def_buffer([](xrt::bo &b) -> py::buffer_info {
+                        return py::buffer_info(b.map(), 1, py::format_descriptor<uint8_t>::format(), 1,
+                                               { static_cast<py::ssize_t>(b.size()) }, { 1 });
+                    })
         .def("size", &xrt::bo::size, "Return the size of the buffer object")
         .def("address", &xrt::bo::address, "Return the device physical address of the buffer object");
 
@@ -314,13 +509,15 @@ py::class_<xrt::graph>(m, "graph")
     .def("get_timestamp", &xrt::graph::get_timestamp)
     .def("run", &xrt::graph::run)
     .def("wait", ([](xrt::graph &g, uint64_t cycles)  {
+                      py::gil_scoped_release release;
                       g.wait(cycles);
                   }))
     .def("wait", ([](xrt::graph &g, std::chrono::milliseconds timeout_ms)  {
+                      py::gil_scoped_release release;
                       g.wait(timeout_ms);
                   }))
     .def("suspend", &xrt::graph::suspend)
     .def("resume", &xrt::graph::resume)
-    .def("end", &xrt::graph::end);
+    .def("end", &xrt::graph::end, py::call_guard<py::gil_scoped_release>());
 #endif
 }
@@ -120,6 +120,40 @@ public:
   {
     device->read_graph_rtp(handle, port, buffer, size);
   }
+
+  void
+  update_rtps(const std::vector<xrt::graph::port_update>& updates)
+  {
+    std::vector<const char*> ports;
+    std::vector<const char*> buffers;
+    std::vector<size_t> sizes;
+    ports.reserve(updates.size());
+    buffers.reserve(updates.size());
+    sizes.reserve(updates.size());
+    for (auto& update : updates) {
+      ports.push_back(update.port_name.c_str());
+      buffers.push_back(reinterpret_cast<const char*>(update.value));
+      sizes.push_back(update.bytes);
+    }
+    device->update_graph_rtp_batch(handle, ports.data(), buffers.data(), sizes.data(), updates.size());
+  }
+
+  void
+  read_rtps(const std::vector<xrt::graph::port_read>& reads)
+  {
+    std::vector<const char*> ports;
+    std::vector<char*> buffers;
+    std::vector<size_t> sizes;
+    ports.reserve(reads.size());
+    buffers.reserve(reads.size());
+    sizes.reserve(reads.size());
+    for (auto& read : reads) {
+      ports.push_back(read.port_name.c_str());
+      buffers.push_back(reinterpret_cast<char*>(read.value));
+      sizes.push_back(read.bytes);
+    }
+    device->read_graph_rtp_batch(handle, ports.data(), buffers.data(), sizes.data(), reads.size());
+  }
 };
 
 }
@@ -313,6 +347,20 @@ read_port(const std::string& port_name, void* value, size_t bytes)
   handle->read_rtp(port_name.c_str(), reinterpret_cast<char *>(value), bytes);
 }
 
+void
+graph::
+update_ports(const std::vector<port_update>& updates)
+{
+  handle->update_rtps(updates);
+}
+
+void
+graph::
+read_ports(const std::vector<port_read>& reads)
+{
+  handle->read_rtps(reads);
+}
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
@@ -71,6 +71,18 @@ public:
   virtual xclBufferHandle
   get_exec_bo() const = 0;
 
+  /**
+   * get_exec_bo_offset() - get offset of command within command buffer
+   *
+   * Non zero only when the command is a slot of a slab allocated
+   * command buffer.
+   */
+  virtual size_t
+  get_exec_bo_offset() const
+  {
+    return 0;
+  }
+
   /**
    * notify() - notify of state change
    */
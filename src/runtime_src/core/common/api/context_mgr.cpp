@@ -8,12 +8,14 @@
 #include "core/common/debug.h"
 #include "core/common/device.h"
 
+#include <algorithm>
 #include <bitset>
 #include <chrono>
 #include <condition_variable>
 #include <limits>
 #include <map>
 #include <mutex>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -92,6 +94,49 @@ public:
     ctx.reset(idx);
     m_cv.notify_all();
   }
+
+  // Open contexts on multiple cus with one device call when none of
+  // the cus is in the process of being closed.
+  void
+  open(const xrt::uuid& uuid, const std::vector<cuidx_type>& ipidxs, bool shared)
+  {
+    auto is_open = [this](cuidx_type ipidx) { return get_ctx(ipidx).test(ctxidx(ipidx)); };
+    std::unique_lock<std::mutex> ul(m_mutex);
+    while (std::any_of(ipidxs.begin(), ipidxs.end(), is_open)) {
+      if (m_cv.wait_for(ul, 100ms) == std::cv_status::timeout)
+        throw std::runtime_error("aquiring cu context timed out");
+    }
+
+    std::vector<unsigned int> indices;
+    indices.reserve(ipidxs.size());
+    for (auto ipidx : ipidxs)
+      indices.push_back(ipidx.index);
+    m_device->open_contexts(uuid.get(), indices.data(), indices.size(), shared);
+
+    for (auto ipidx : ipidxs)
+      get_ctx(ipidx).set(ctxidx(ipidx));
+  }
+
+  // Close contexts on multiple cus with one device call and notify
+  // threads that might be waiting to open these cus
+  void
+  close(const xrt::uuid& uuid, const std::vector<cuidx_type>& ipidxs)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    std::vector<unsigned int> indices;
+    indices.reserve(ipidxs.size());
+    for (auto ipidx : ipidxs) {
+      if (!get_ctx(ipidx).test(ctxidx(ipidx)))
+        throw std::runtime_error("ctx " + std::to_string(ipidx.index) + " not open");
+      indices.push_back(ipidx.index);
+    }
+
+    m_device->close_contexts(uuid.get(), indices.data(), indices.size());
+
+    for (auto ipidx : ipidxs)
+      get_ctx(ipidx).reset(ctxidx(ipidx));
+    m_cv.notify_all();
+  }
 };
 
 // Get (and create) context manager for device.
@@ -142,4 +187,42 @@ close_context(xrt_core::device* device, const xrt::uuid& uuid, cuidx_type cuidx)
   throw std::runtime_error("No context manager for device");
 }
 
+void
+open_contexts(xrt_core::device* device, const xrt::uuid& uuid, const std::vector<cuidx_type>& cuidxs, bool shared)
+{
+  if (cuidxs.empty())
+    return;
+
+  if (cuidxs.size() == 1) {
+    open_context(device, uuid, cuidxs.front(), shared);
+    return;
+  }
+
+  if (auto ctxmgr = get_device_context_mgr(device)) {
+    ctxmgr->open(uuid, cuidxs, shared);
+    return;
+  }
+
+  throw std::runtime_error("No context manager for device");
+}
+
+void
+close_contexts(xrt_core::device* device, const xrt::uuid& uuid, const std::vector<cuidx_type>& cuidxs)
+{
+  if (cuidxs.empty())
+    return;
+
+  if (cuidxs.size() == 1) {
+    close_context(device, uuid, cuidxs.front());
+    return;
+  }
+
+  if (auto ctxmgr = get_device_context_mgr(device)) {
+    ctxmgr->close(uuid, cuidxs);
+    return;
+  }
+
+  throw std::runtime_error("No context manager for device");
+}
+
 }} // context_mgr, xrt_core
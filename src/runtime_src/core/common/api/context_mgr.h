@@ -6,6 +6,7 @@
 #include "core/include/xrt/xrt_uuid.h"
 #include "core/common/cuidx_type.h"
 #include <memory>
+#include <vector>
 
 // This file defines APIs for compute unit (ip) context management
 // It is used by xrt::kernel and xrt::ip implementation.
@@ -59,5 +60,28 @@ open_context(xrt_core::device* device, const xrt::uuid& uuid, cuidx_type cuidx,
 // The function throws if no context is open on specified CU.
 void
 close_context(xrt_core::device* device, const xrt::uuid& uuid, cuidx_type cuidx);
+
+// Open device contexts on multiple compute units
+//
+// @device: device to open contexts on
+// @uuid:   xclbin uuid with the CUs
+// @cuidxs: indices of CUs
+// @shared: open in shared (true) or exclusive mode (false)
+//
+// Same as open_context for each CU, but the contexts are opened
+// with one call to the device.  Either all contexts are opened or
+// none.
+void
+open_contexts(xrt_core::device* device, const xrt::uuid& uuid, const std::vector<cuidx_type>& cuidxs, bool shared);
+
+// Close previously opened device contexts on multiple compute units
+//
+// @device: device to close contexts on
+// @uuid:   xclbin uuid with the CUs
+// @cuidxs: indices of CUs
+//
+// The function throws if no context is open on any specified CU.
+void
+close_contexts(xrt_core::device* device, const xrt::uuid& uuid, const std::vector<cuidx_type>& cuidxs);
  
 }} // context_mgr, xrt_core
@@ -27,6 +27,12 @@ namespace xrt_core { namespace enqueue {
 void
 done(xrt::event_impl* ev);
 
+// Create an event that is not associated with an event queue.  The
+// event is completed by calling done() and can be used as dependency
+// of enqueued events.
+xrt::event
+create_event();
+
 } // event
   
 }
@@ -19,6 +19,7 @@
 #include "core/common/config_reader.h"
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 
 #ifdef _WIN32
 # pragma warning( disable : 4996 )
@@ -93,6 +94,16 @@ managed_start(command* cmd)
     sws::managed_start(cmd);
 }
 
+// Schedule a list of commands for execution on either sws or kds.
+void
+managed_start(const std::vector<command*>& cmds)
+{
+  if (kds_enabled())
+    kds::managed_start(cmds);
+  else
+    sws::managed_start(cmds);
+}
+
 // Schedule a command for execution on either sws or kds. Use poll
 // execution, meaning host must explicitly call unmanaged_wait() to
 // wait for command completion
@@ -105,6 +116,16 @@ unmanaged_start(command* cmd)
     sws::unmanaged_start(cmd);
 }
 
+// Schedule a list of commands for execution using poll execution.
+void
+unmanaged_start(const std::vector<command*>& cmds)
+{
+  if (kds_enabled())
+    kds::unmanaged_start(cmds);
+  else
+    sws::unmanaged_start(cmds);
+}
+
 // Wait for a command to complete execution.  This function must be
 // called in poll mode scheduling, and is safe to call in push mode.
 void
@@ -134,11 +155,9 @@ init(xrt_core::device* device)
   };
   static X x;
 
-  static bool started = false;
-  if (!started) {
-    start();
-    started = true;
-  }
+  // concurrent first use of devices starts kds or sws once
+  static std::once_flag started;
+  std::call_once(started, [] { start(); });
 
   if (kds_enabled())
     kds::init(device);
@@ -35,12 +35,25 @@ namespace sws {
 void
 managed_start(command* cmd);
 
+inline void
+managed_start(const std::vector<command*>& cmds)
+{
+  for (auto cmd : cmds)
+    managed_start(cmd);
+}
+
 inline void
 unmanaged_start(command* cmd)
 {
   managed_start(cmd);
 }
 
+inline void
+unmanaged_start(const std::vector<command*>& cmds)
+{
+  managed_start(cmds);
+}
+
 void
 unmanaged_wait(const command* cmd);
 
@@ -70,9 +83,15 @@ namespace kds {
 void
 managed_start(command* cmd);
 
+void
+managed_start(const std::vector<command*>& cmds);
+
 void
 unmanaged_start(command* cmd);
 
+void
+unmanaged_start(const std::vector<command*>& cmds);
+
 void
 unmanaged_wait(const command* cmd);
 
@@ -99,6 +118,12 @@ namespace exec {
 void
 managed_start(command* cmd);
 
+// Schedule a list of commands for execution on either sws or kds.
+// Same as managed_start(command*) except that kds submits all
+// commands in one shim call and wakes the execution monitor once.
+void
+managed_start(const std::vector<command*>& cmds);
+
 // Schedule a command for execution on either sws or kds. Use poll
 // execution, meaning host must explicitly call unmanaged_wait() to
 // wait for command completion.  This function starts / schedules
@@ -108,6 +133,12 @@ XRT_CORE_COMMON_EXPORT
 void
 unmanaged_start(command* cmd);
 
+// Schedule a list of commands for execution using poll execution.
+// The commands are submitted in one shim call if supported.
+XRT_CORE_COMMON_EXPORT
+void
+unmanaged_start(const std::vector<command*>& cmds);
+
 // Wait for a command to complete execution.  This function must be
 // called in poll mode (unmanaged) scheduling, and is safe to call in
 // push mode.  The function provides a thread safe interface to
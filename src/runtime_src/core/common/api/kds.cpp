@@ -18,10 +18,14 @@
 #include "exec.h"
 #include "ert.h"
 #include "command.h"
+#include "core/common/config_reader.h"
 #include "core/common/device.h"
+#include "core/common/message.h"
 #include "core/common/thread.h"
 #include "core/common/debug.h"
+#include "core/common/usdt.h"
 
+#include <chrono>
 #include <memory>
 #include <cstring>
 #include <cerrno>
@@ -54,10 +58,87 @@ completed(xrt_core::command* cmd)
   return (get_command_state(cmd) >= ERT_CMD_STATE_COMPLETED);
 }
 
+// Read state of command packet that is concurrently updated by
+// driver.  Volatile access prevents caching of the value when
+// spinning.
+inline bool
+completed(const volatile ert_packet* pkt)
+{
+  return (pkt->state >= ERT_CMD_STATE_COMPLETED);
+}
+
+inline void
+cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+// Wait policy for unmanaged command completion, see
+// xrt_core::config::get_exec_wait_policy()
+enum class wait_policy { interrupt, hybrid, busy_poll };
+
+static wait_policy
+get_wait_policy()
+{
+  static auto policy = [] {
+    auto value = xrt_core::config::get_exec_wait_policy();
+    if (value == "hybrid")
+      return wait_policy::hybrid;
+    if (value == "busy_poll")
+      return wait_policy::busy_poll;
+    if (value != "interrupt")
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Unknown exec_wait_policy '" + value + "', using interrupt");
+    return wait_policy::interrupt;
+  }();
+  return policy;
+}
+
+// spin() - Spin on command state for a bounded time
+//
+// @pkt:        Command packet to spin on
+// @timeout_ms: Caller timeout, 0 means no timeout
+// Return:      true if command completed while spinning
+//
+// With wait_policy::hybrid the spin is bounded by the configured
+// spin time, with wait_policy::busy_poll the spin is bounded by
+// the timeout only.  Spinning trades a CPU for the latency of an
+// interrupt and scheduler wakeup round trip, which dominates the
+// wait for short running kernels.
+static bool
+spin(const ert_packet* pkt, size_t timeout_ms)
+{
+  auto policy = get_wait_policy();
+  if (policy == wait_policy::interrupt)
+    return false;
+
+  bool forever = (policy == wait_policy::busy_poll && !timeout_ms);
+  auto duration = (policy == wait_policy::busy_poll)
+    ? std::chrono::nanoseconds(std::chrono::milliseconds(timeout_ms))
+    : std::chrono::nanoseconds(xrt_core::config::get_exec_wait_spin_ns());
+  auto end = std::chrono::steady_clock::now() + duration;
+  do {
+    for (int i = 0; i < 64; ++i) {
+      if (completed(pkt))
+        return true;
+      cpu_relax();
+    }
+  } while (forever || std::chrono::steady_clock::now() < end);
+
+  return completed(pkt);
+}
+
 inline void
 notify_host(xrt_core::command* cmd, ert_cmd_state state)
 {
   XRT_DEBUGF("xrt_core::kds::command(%d), [running->done]\n", cmd->get_uid());
+  XRT_USDT(notify_host, cmd, static_cast<int>(state));
   auto retain = cmd->shared_from_this();
   cmd->notify(state);
 }
@@ -72,11 +153,12 @@ notify_host(xrt_core::command* cmd)
 // class kds_device - kds book keeping data for command scheduling
 //
 // @device: The core device used for shim level calls
-// @exec_wait_mutex: Synchronize acces to exec_wait
+// @exec_wait_mutex: Synchronize access to waiters and polling
+// @waiters: Threads waiting for command completion
+// @polling: True while a waiter is in shim level exec_wait
 // @work_mutex: Syncrhonize monitor thread with launched commands
 // @work_cond: Kick off monitor thread when there are new commands
 // @monitor_thread: Thread for asynchronous monitoring of command execution
-// @exec_wait_call_count:  Count of number of calls to exec wait
 // @stop: Stop the monitor thread
 //
 // This class is per xrt_core::device. The class constructor starts a
@@ -85,12 +167,27 @@ notify_host(xrt_core::command* cmd)
 // be called explicitly to wait for command completion.
 class kds_device
 {
+  // A thread waiting for completion of a command, or for any
+  // completion if pkt is nullptr.
+  struct waiter
+  {
+    const ert_packet* pkt;
+    std::condition_variable cv;
+    bool woken = false;
+
+    explicit
+    waiter(const ert_packet* p)
+      : pkt(p)
+    {}
+  };
+
   xrt_core::device* device;
   std::mutex exec_wait_mutex;
+  std::vector<waiter*> waiters;
+  bool polling = false;
   std::mutex work_mutex;
   std::condition_variable work_cond;
   command_queue_type submitted_cmds;
-  uint64_t exec_wait_call_count = 0;
   bool stop = false;
 
   // thread can be constructed only after data members are initialized
@@ -182,7 +279,7 @@ class kds_device
 public:
   // Constructor starts monitor thread
   kds_device(xrt_core::device* dev)
-      : device(dev), monitor_thread(xrt_core::thread(&kds_device::monitor, this))
+      : device(dev), monitor_thread(xrt_core::thread(xrt_core::thread_class::scheduler, &kds_device::monitor, this))
   {}
 
   // Destructor stops and joins monitor thread
@@ -193,58 +290,96 @@ public:
     monitor_thread.join();
   }
 
-  // Thread safe shim level exec wait call.   This function allows
-  // multiple threads to call exec_wait through same device handle.
-  //
-  // In multi-threaded applications it is possible that a call to shim
-  // level exec_wait by one thread covers completion for other
-  // threads.  Without careful synchronization, a thread that calls
-  // device->exec_wait could end up being stuck either forever or
-  // until some other unrelated command completes.  This function
-  // prevents that scenario from happening.
+  // wait() - Thread safe shim level exec wait
   //
-  // Thread local storage keeps a call count that syncs with the
-  // number of times device->exec_wait has been called. If thread
-  // local call count is different from the global count, then this
-  // function resets the thread local call count and return without
-  // calling shim exec_wait.
+  // Shim level exec_wait is a poll on the device that returns when
+  // any command of this process completes, so only one waiting
+  // thread at a time polls the device.  When the poll returns, the
+  // polling thread wakes exactly the waiters whose command completed
+  // and the waiters for any completion; the other waiters keep
+  // sleeping.  If the polling thread is done waiting, it hands the
+  // poll to one of the remaining waiters.
   //
-  // The specified timeout has effect only when underlying xclExecWait
-  // times out. The timeout can be masked if device is busy and many
-  // commands complete with the specified timeout.
+  // The specified timeout has effect only when no command completes
+  // within the timeout.  The timeout can be masked if device is busy
+  // and many commands complete within the specified timeout.
   std::cv_status
-  exec_wait(size_t timeout_ms=0)
+  wait(const ert_packet* pkt, size_t timeout_ms)
   {
-    static thread_local uint64_t thread_exec_wait_call_count = 0;
-    std::lock_guard<std::mutex> lk(exec_wait_mutex);
-
-    if (thread_exec_wait_call_count != exec_wait_call_count) {
-      // some other thread has called exec_wait and may have
-      // covered this thread's commands, synchronize thread
-      // local call count and return to caller.
-      thread_exec_wait_call_count = exec_wait_call_count;
-      return std::cv_status::no_timeout;
-    }
-
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
     auto status = std::cv_status::no_timeout;
-    if (timeout_ms) {
-      // device exec_wait is a system poll which returns
-      // 0 when specified timeout is exceeded without any
-      // file descriptors to read
-      if (device->exec_wait(static_cast<int>(timeout_ms)) == 0)
+    waiter self(pkt);
+
+    std::unique_lock<std::mutex> lk(exec_wait_mutex);
+    waiters.push_back(&self);
+
+    while (!self.woken && !(pkt && completed(pkt))) {
+      if (polling) {
+        auto pred = [this, &self] { return self.woken || !polling; };
+        if (!timeout_ms)
+          self.cv.wait(lk, pred);
+        else if (!self.cv.wait_until(lk, deadline, pred)) {
+          status = std::cv_status::timeout;
+          break;
+        }
+        continue;
+      }
+
+      // Poll the device on behalf of all waiters.  Device exec_wait
+      // is a system poll which returns 0 when the specified timeout
+      // is exceeded without any command having completed
+      int poll_ms = 1000;
+      if (timeout_ms) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>
+          (deadline - std::chrono::steady_clock::now()).count();
+        poll_ms = static_cast<int>(std::clamp<decltype(remaining)>(remaining, 1, poll_ms));
+      }
+
+      polling = true;
+      lk.unlock();
+      auto ret = device->exec_wait(poll_ms);
+      XRT_USDT(exec_wait_return, device, ret);
+      lk.lock();
+      polling = false;
+
+      if (ret) {
+        for (auto w : waiters) {
+          if (w != &self && (!w->pkt || completed(w->pkt))) {
+            w->woken = true;
+            w->cv.notify_one();
+          }
+        }
+        if (!pkt)
+          break;
+      }
+      else if (timeout_ms && std::chrono::steady_clock::now() >= deadline) {
         status = std::cv_status::timeout;
-    }
-    else {
-      // wait for ever for some command to complete
-      while (device->exec_wait(1000) == 0) {}
+        break;
+      }
     }
 
-    // synchronize this thread with total call count
-    thread_exec_wait_call_count = ++exec_wait_call_count;
+    waiters.erase(std::find(waiters.begin(), waiters.end(), &self));
+
+    // Hand the poll to a waiter that is still waiting
+    if (!polling) {
+      auto itr = std::find_if(waiters.begin(), waiters.end(), [](auto w) { return !w->woken; });
+      if (itr != waiters.end())
+        (*itr)->cv.notify_one();
+    }
 
     return status;
   }
 
+  // exec_wait() - Wait for any command completion
+  //
+  // Used by the monitor thread, which tracks completion of all
+  // managed commands.
+  std::cv_status
+  exec_wait(size_t timeout_ms=0)
+  {
+    return wait(nullptr, timeout_ms);
+  }
+
   // exec_wait() - Wait for specific command completion with optional timeout
   //
   // Wait for command completion
@@ -253,11 +388,11 @@ public:
   exec_wait(const xrt_core::command* cmd, size_t timeout_ms=0)
   {
     auto pkt = cmd->get_ert_packet();
-    while (pkt->state < ERT_CMD_STATE_COMPLETED) {
-      // return immediately on timeout
-      if (exec_wait(timeout_ms) == std::cv_status::timeout)
-        return std::cv_status::timeout;
-    }
+    if (!spin(pkt, timeout_ms) && get_wait_policy() == wait_policy::busy_poll)
+      return std::cv_status::timeout;
+
+    if (!completed(pkt) && wait(pkt, timeout_ms) == std::cv_status::timeout)
+      return std::cv_status::timeout;
 
     // notify_host is not strictly necessary for unmanaged
     // command execution but provides a central place to update
@@ -275,7 +410,28 @@ public:
   void
   exec_buf(xrt_core::command* cmd)
   {
-    device->exec_buf(cmd->get_exec_bo());
+    if (auto offset = cmd->get_exec_bo_offset())
+      device->exec_buf_at(cmd->get_exec_bo(), offset);
+    else
+      device->exec_buf(cmd->get_exec_bo());
+  }
+
+  // exec_buf() - Submit a list of commands for execution
+  //
+  // Same as exec_buf(cmd) except that all exec buffers are passed
+  // to the shim in one call.
+  void
+  exec_buf(const command_queue_type& cmds)
+  {
+    static thread_local std::vector<xclBufferHandle> bos;
+    static thread_local std::vector<size_t> offsets;
+    bos.clear();
+    offsets.clear();
+    for (auto cmd : cmds) {
+      bos.push_back(cmd->get_exec_bo());
+      offsets.push_back(cmd->get_exec_bo_offset());
+    }
+    device->exec_buf_batch(bos.data(), offsets.data(), bos.size());
   }
 
   // launch() - Submit a command for managed execution
@@ -288,6 +444,7 @@ public:
   launch(xrt_core::command* cmd)
   {
     XRT_DEBUGF("xrt_core::kds::command(%d) [new->submitted->running]\n", cmd->get_uid());
+    XRT_USDT(kds_launch, cmd, cmd->get_exec_bo());
 
     // Store command so completion can be tracked.  Make sure this is
     // done prior to exec_buf as exec_wait can otherwise be missed.
@@ -314,21 +471,63 @@ public:
     // exec_buf call so that actual execution doesn't have to wait.
     work_cond.notify_one();
   }
+
+  // launch() - Submit a list of commands for managed execution
+  //
+  // All commands are stored for completion tracking before the
+  // batch is submitted, and the monitor thread is woken up once
+  // for the entire batch.
+  void
+  launch(const command_queue_type& cmds)
+  {
+    if (cmds.empty())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lk(work_mutex);
+      submitted_cmds.insert(submitted_cmds.end(), cmds.begin(), cmds.end());
+    }
+
+    try {
+      exec_buf(cmds);
+    }
+    catch (...) {
+      // Remove the commands that were not submitted, a failing shim
+      // leaves these in new state.
+      std::lock_guard<std::mutex> lk(work_mutex);
+      submitted_cmds.erase
+        (std::remove_if(submitted_cmds.begin(), submitted_cmds.end(),
+                        [&cmds](auto cmd) {
+                          return get_command_state(cmd) == ERT_CMD_STATE_NEW
+                            && std::find(cmds.begin(), cmds.end(), cmd) != cmds.end();
+                        }),
+         submitted_cmds.end());
+      throw;
+    }
+
+    work_cond.notify_one();
+  }
 }; // kds_device
 
-// Statically allocated kds_device object for each core deviced
+// Statically allocated kds_device object for each core deviced.
+// The map owns the kds_device objects, the core device caches its
+// kds_device for lookup without locking.
+static std::mutex kds_devices_mutex;
 static std::map<const xrt_core::device*, std::unique_ptr<kds_device>> kds_devices;
 
 // Get or create kds_device object from core device
 static kds_device*
 get_kds_device(xrt_core::device* device)
 {
-  auto itr = kds_devices.find(device);
-  if (itr != kds_devices.end())
-    return (*itr).second.get();
-
-  auto iitr = kds_devices.insert(std::make_pair(device, std::make_unique<kds_device>(device)));
-  return (iitr.first)->second.get();
+  if (auto kdev = static_cast<kds_device*>(device->get_exec_state()))
+    return kdev;
+
+  std::lock_guard<std::mutex> lk(kds_devices_mutex);
+  auto& kdev = kds_devices[device];
+  if (!kdev)
+    kdev = std::make_unique<kds_device>(device);
+  device->set_exec_state(kdev.get());
+  return kdev.get();
 }
 
 // Get or existing kds_device object from core device.  Throw if
@@ -336,10 +535,9 @@ get_kds_device(xrt_core::device* device)
 static kds_device*
 get_kds_device_or_error(const xrt_core::device* device)
 {
-  auto itr = kds_devices.find(device);
-  if (itr == kds_devices.end())
-    throw std::runtime_error("internal error: missing kds device");
-  return (*itr).second.get();
+  if (auto kdev = static_cast<kds_device*>(device->get_exec_state()))
+    return kdev;
+  throw std::runtime_error("internal error: missing kds device");
 }
 
 // Get kds_device from command object.  Throws if kds_device
@@ -381,6 +579,18 @@ unmanaged_start(xrt_core::command* cmd)
   kdev->exec_buf(cmd);
 }
 
+// Start unmanaged execution of a list of commands that all belong
+// to the same device.  The commands are submitted in one shim call.
+void
+unmanaged_start(const std::vector<xrt_core::command*>& cmds)
+{
+  if (cmds.empty())
+    return;
+
+  auto kdev = get_kds_device(cmds.front());
+  kdev->exec_buf(cmds);
+}
+
 // Start managed command execution.   The command is monitored
 // for completion and notified when completed.  It is undefined
 // behavior to call unmanaged_wait for a managed command.  While
@@ -393,6 +603,19 @@ managed_start(xrt_core::command* cmd)
   kdev->launch(cmd);
 }
 
+// Start managed execution of a list of commands that all belong to
+// the same device.  The commands are submitted in one shim call and
+// the command monitor is notified once for the entire list.
+void
+managed_start(const std::vector<xrt_core::command*>& cmds)
+{
+  if (cmds.empty())
+    return;
+
+  auto kdev = get_kds_device(cmds.front());
+  kdev->launch(cmds);
+}
+
 // Alias for managed_start
 void
 schedule(xrt_core::command* cmd)
@@ -405,9 +628,11 @@ void
 start()
 {}
 
+// Called at exit, core devices may be gone and are not accessed
 void
 stop()
 {
+  std::lock_guard<std::mutex> lk(kds_devices_mutex);
   kds_devices.clear();
 }
 
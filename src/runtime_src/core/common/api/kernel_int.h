@@ -89,6 +89,10 @@ XRT_CORE_COMMON_EXPORT
 void
 pop_callback(const xrt::run& run);
 
+XRT_CORE_COMMON_EXPORT
+xrt_core::device*
+get_core_device(const xrt::run& run);
+
 }} // kernel_int, xrt_core
 
 #endif
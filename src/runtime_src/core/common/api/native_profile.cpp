@@ -17,6 +17,7 @@
 #define XRT_CORE_COMMON_SOURCE
 
 #include "native_profile.h"
+#include "core/common/config_reader.h"
 #include "core/common/module_loader.h"
 #include "core/common/utils.h"
 #include "core/common/dlfcn.h"
@@ -33,24 +34,43 @@ bool load()
   return true ;
 }
 
-// Callbacks for generic start/stop function tracking
-std::function<void (const char*, unsigned long long int)> function_start_cb ;
-std::function<void (const char*, unsigned long long int, unsigned long long int)> function_end_cb ;
+using start_type      = void (*)(const char*, unsigned long long int) ;
+using sync_start_type = void (*)(const char*, unsigned long long int, bool) ;
+using end_type        = void (*)(const char*, unsigned long long int,
+                                 unsigned long long int) ;
+using end_sync_type   = void (*)(const char*, unsigned long long int,
+                                 unsigned long long int, bool,
+                                 unsigned long long int) ;
+
+// Callbacks for generic start/stop function tracking.  These are
+// called directly, they are set before the state becomes enabled.
+static start_type function_start_cb = nullptr ;
+static end_type function_end_cb = nullptr ;
 
 // Callbacks for individual functions to track start/stop and statistics
-  std::function<void (const char*, unsigned long long int, bool)> sync_start_cb ;
-std::function<void (const char*, unsigned long long int, unsigned long long int, bool, unsigned long long int)> sync_end_cb ;
-  
-void register_functions(void* handle)
+static sync_start_type sync_start_cb = nullptr ;
+static end_sync_type sync_end_cb = nullptr ;
+
+std::atomic<trace_state> state {trace_state::unknown} ;
+
+bool initialize()
 {
-  using start_type      = void (*)(const char*, unsigned long long int) ;
-  using sync_start_type = void (*)(const char*, unsigned long long int, bool) ;
-  using end_type        = void (*)(const char*, unsigned long long int,
-                                   unsigned long long int) ;
-  using end_sync_type   = void (*)(const char*, unsigned long long int,
-                                   unsigned long long int, bool,
-                                   unsigned long long int) ;
+  // With the addition of the generic "host_trace" feature, we have to
+  //  check if we should load the plugin.  We only want to load it if
+  //  native_xrt_trace is specified or if we are the topmost layer and
+  //  host_trace was specified.  Concurrent first calls wait here until
+  //  the plugin is loaded.
+  static const bool s_load_native =
+    (xrt_core::config::get_native_xrt_trace() ||
+     xrt_core::utils::load_host_trace()) ? load() : false;
+
+  state.store(s_load_native ? trace_state::enabled : trace_state::disabled,
+              std::memory_order_release) ;
+  return s_load_native ;
+}
 
+void register_functions(void* handle)
+{
   // Generic callbacks
   function_start_cb =
     reinterpret_cast<start_type>(xrt_core::dlsym(handle, "native_function_start")) ;
@@ -77,21 +97,6 @@ void register_functions(void* handle)
 void warning_function()
 {}
 
-api_call_logger::
-api_call_logger(const char* function)
-  : m_funcid(0), m_fullname(function)
-{
-  // With the addition of the generic "host_trace" feature, we have to
-  //  check if we should load the plugin.  We only want to load it if
-  //  native_xrt_trace is specified or if we are the topmost layer and
-  //  host_trace was specified
-  static bool s_load_native =
-    (xrt_core::config::get_native_xrt_trace() ||
-     xrt_core::utils::load_host_trace()) ? load() : false;
-  if (s_load_native) return;
-
-}
-
 generic_api_call_logger::
 generic_api_call_logger(const char* function)
   : api_call_logger(function)
@@ -21,6 +21,8 @@
 #include "core/common/config_reader.h"
 #include "core/include/xrt.h"
 
+#include <atomic>
+
 /**
  * This file contains the callback mechanisms for connecting the
  * Native XRT API (C/C++ layer) to the XDP plugin
@@ -34,17 +36,50 @@ bool load() ;
 void register_functions(void* handle) ;
 void warning_function() ;
 
-// An instance of the api_call_logger class will be created
-//  in every function we are monitoring.  The constructor marks the
-//  start time, and the destructor marks the end time
+#if defined(__GNUC__)
+# define XRT_NATIVE_PROFILE_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+# define XRT_NATIVE_PROFILE_UNLIKELY(x) (x)
+#endif
+
+// Whether native API trace is enabled is decided once, on the first
+// profiled call, by reading xrt.ini and loading the plugin if needed.
+// The result is cached in this flag.
+enum class trace_state : unsigned char { unknown, disabled, enabled } ;
+XRT_CORE_COMMON_EXPORT
+extern std::atomic<trace_state> state ;
+
+// Decide the state on the first call, false if trace is disabled
+XRT_CORE_COMMON_EXPORT
+bool
+initialize() ;
+
+// When trace is disabled, a profiled API call costs one load of the
+// flag and a predicted not taken branch, the plugin is never loaded.
+// The acquire pairs with setting the flag after the callbacks are
+// registered, it is a plain load on x86.
+inline bool
+enabled()
+{
+  auto s = state.load(std::memory_order_acquire) ;
+  if (XRT_NATIVE_PROFILE_UNLIKELY(s != trace_state::disabled))
+    return s == trace_state::enabled || initialize() ;
+  return false ;
+}
+
+// An instance of the api_call_logger class will be created on the
+//  stack of every function we are monitoring, only when trace is
+//  enabled.  The constructor marks the start time, and the destructor
+//  marks the end time
 class api_call_logger
 {
  protected:
   uint64_t m_funcid ;
   const char* m_fullname = nullptr ;
  public:
-  explicit api_call_logger(const char* function);
-  virtual ~api_call_logger() = default ;
+  explicit api_call_logger(const char* function)
+    : m_funcid(0), m_fullname(function)
+  {}
 } ;
 
 class generic_api_call_logger : public api_call_logger
@@ -57,15 +92,14 @@ class generic_api_call_logger : public api_call_logger
   void operator=(generic_api_call_logger&& x) = delete ;
  public:
   explicit generic_api_call_logger(const char* function) ;
-  ~generic_api_call_logger() override ;
+  ~generic_api_call_logger() ;
 } ;
 
 template <typename Callable, typename ...Args>
 auto
 profiling_wrapper(const char* function, Callable&& f, Args&&...args)
 {
-  if (xrt_core::config::get_native_xrt_trace() ||
-      xrt_core::config::get_host_trace()) {
+  if (enabled()) {
     generic_api_call_logger log_object(function) ;
     return f(std::forward<Args>(args)...) ;
   }
@@ -89,15 +123,14 @@ class sync_logger : public api_call_logger
 
  public:
   explicit sync_logger(const char* function, bool w, size_t s);
-  ~sync_logger() override ;
+  ~sync_logger() ;
 } ;
 
 template <typename Callable, typename ...Args>
 auto
 profiling_wrapper_sync(const char* function, xclBOSyncDirection dir, size_t size, Callable&& f, Args&&...args)
 {
-  if (xrt_core::config::get_native_xrt_trace() ||
-      xrt_core::config::get_host_trace()) {
+  if (enabled()) {
     sync_logger log_object(function, (dir == XCL_BO_SYNC_BO_TO_DEVICE), size);
     return f(std::forward<Args>(args)...) ;
   }
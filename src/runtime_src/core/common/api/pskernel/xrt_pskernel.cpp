@@ -197,8 +197,6 @@ struct device_type
   xrt_core::bo_cache exec_buffer_cache;
   uint32_t uid; // internal unique id for debug
 
-  static constexpr unsigned int cache_size = 128;
-
   static uint32_t
   create_uid()
   {
@@ -209,19 +207,21 @@ struct device_type
   explicit
   device_type(xrtDeviceHandle dhdl)
     : core_device(xrt_core::device_int::get_core_device(dhdl))
-    , exec_buffer_cache(core_device->get_device_handle(), cache_size)
+    , exec_buffer_cache(core_device->get_device_handle(), xrt_core::config::get_exec_buffer_cache_size())
     , uid(create_uid())
   {
     XRT_DEBUGF("device_type::device_type(%d)\n", uid);
+    exec_buffer_cache.prewarm(xrt_core::config::get_exec_buffer_cache_prewarm());
   }
 
   explicit
   device_type(std::shared_ptr<xrt_core::device> cdev)
     : core_device(std::move(cdev))
-    , exec_buffer_cache(core_device->get_device_handle(), cache_size)
+    , exec_buffer_cache(core_device->get_device_handle(), xrt_core::config::get_exec_buffer_cache_size())
     , uid(create_uid())
   {
     XRT_DEBUGF("device_type::device_type(%d)\n", uid);
+    exec_buffer_cache.prewarm(xrt_core::config::get_exec_buffer_cache_prewarm());
   }
 
   // NOLINTNEXTLINE(modernize-use-equals-default)
@@ -1466,6 +1466,12 @@ class psrun_impl
   std::unique_ptr<arg_setter> asetter;    // helper to populate payload data
   bool encode_cumasks = false;            // indicate if cmd cumasks must be re-encoded
 
+  // Global buffers set as arguments are held by the run object.  The
+  // soft kernel daemon caches its mapping of a buffer by physical
+  // address, holding the buffer keeps that address, and the cached
+  // mapping, valid for all starts of the run.
+  std::map<size_t, xrt::bo> bos;
+
 public:
   uint32_t
   get_uid() const
@@ -1536,6 +1542,7 @@ public:
     , cmd(std::make_shared<kernel_command>(kernel->get_device()))
     , data(clone_command_data(rhs))
     , uid(create_uid())
+    , bos(rhs->bos)
   {
     XRT_DEBUGF("psrun_impl::psrun_impl(%d)\n" , uid);
   }
@@ -1586,6 +1593,7 @@ public:
   set_arg_value(const argument& arg, const xrt::bo& bo)
   {
     get_arg_setter()->set_arg_value(arg, bo);
+    bos[arg.index()] = bo;
   }
 
   void
@@ -32,12 +32,14 @@
 #include "core/common/thread.h"
 #include "core/common/xclbin_parser.h"
 #include <limits>
+#include <atomic>
 #include <bitset>
 #include <vector>
 #include <list>
 #include <map>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
 #include <cstring>
 
 #ifdef _WIN32
@@ -90,12 +92,6 @@ const value_type AP_CONTINUE = 0x10;
 // profiling hook
 static bool cu_trace_enabled = false;
 
-////////////////////////////////////////////////////////////////
-// Command completion for unmanaged commands
-////////////////////////////////////////////////////////////////
-static std::mutex s_cmd_complete_mutex;
-static std::condition_variable s_cmd_complete_cond;
-
 ////////////////////////////////////////////////////////////////
 // Forward declarations
 ////////////////////////////////////////////////////////////////
@@ -167,12 +163,7 @@ public:
 
   // Notify host of command completion
   void
-  notify_host() const
-  {
-    auto retain = m_cmd->shared_from_this();
-    m_cmd->notify(ERT_CMD_STATE_COMPLETED);
-    s_cmd_complete_cond.notify_one();
-  }
+  notify_host() const;
 
   // Notify of start of cu with idx
   void
@@ -295,18 +286,6 @@ public:
 
 using xcmd_ptr = std::shared_ptr<xocl_cmd>;
 
-////////////////////////////////////////////////////////////////
-// List of new pending xocl_cmd objects
-//
-// @s_pending_cmds: populated from user space with new commands for buffer objects
-// @s_num_pending: number of pending commands
-//
-// Scheduler copies pending commands to its private queue when necessary
-////////////////////////////////////////////////////////////////
-static std::vector<xcmd_ptr> s_pending_cmds;
-static std::mutex s_pending_mutex;
-static std::atomic<unsigned int> s_num_pending {0};
-
 ////////////////////////////////////////////////////////////////
 // class xocl_cu represents a compute unit on a device
 //
@@ -625,19 +604,21 @@ public:
 // class xocl_scheduler: The scheduler data structure
 //
 // @m_command_queue: all the commands managed by scheduler
+// @m_pending: new commands populated by user threads
+// @m_num_pending: number of pending commands
 //
 // The scheduler babysits all commands launched by user. It
 // transitions the commands from state to state until the command
 // completes.
 //
-// The scheduler runs on its own thread and manages command execution
-// on execution cores.  An execution core is 1-1 with a scheduler, but
-// a scheduler can manage any number of cores.  Because the scheduler
-// is the only client of an exec_core, and exec_core is the only
-// client of xocl_cu, no locking is necessary is any of the data
-// structures.  Exception is the pending command list which is copied
-// to the scheduler command queue, the pending list is populated by
-// user thread, and harvested by scheduler thread.
+// Each device has its own scheduler running on its own thread, so
+// that devices are scheduled independently of each other.  Because
+// the scheduler is the only client of its exec_core, and exec_core
+// is the only client of xocl_cu, no locking is necessary is any of
+// the data structures.  Exception is the pending command list which
+// is populated by user threads and harvested in one swap by the
+// scheduler thread, and the completion condition which user threads
+// wait on.
 ////////////////////////////////////////////////////////////////
 class xocl_scheduler
 {
@@ -647,28 +628,37 @@ class xocl_scheduler
   bool                       m_stop = false;
   std::list<xcmd_ptr>        m_command_queue;
 
+  std::vector<xcmd_ptr>      m_pending;
+  std::atomic<unsigned int>  m_num_pending {0};
+
+  // Command completion for unmanaged commands
+  std::mutex                 m_complete_mutex;
+  std::condition_variable    m_complete;
+
+  std::thread                m_thread;
+
   // if command has completed in the iteration
   bool                       m_cmd_completed = false;
 
-  // Copy pending commands into command queue.
+  // Move pending commands into command queue.
   void
   queue_cmds()
   {
-    std::lock_guard<std::mutex> lk(s_pending_mutex);
-    for (auto itr=s_pending_cmds.begin(); itr!=s_pending_cmds.end(); ) {
-      auto xcmd = (*itr);
-      auto exec = xcmd->get_exec();
-      if (exec->get_scheduler()==this) {
-        XRT_DEBUGF("xcmd(%d) [new->queued]\n",xcmd->get_uid());
-        itr = s_pending_cmds.erase(itr);
-        xcmd->set_int_state(ERT_CMD_STATE_QUEUED);
-        m_command_queue.push_back(std::move(xcmd));
-      }
-      else {
-        ++itr;
-      }
+    if (!m_num_pending)
+      return;
+
+    std::vector<xcmd_ptr> pending;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      pending.swap(m_pending);
+      m_num_pending = 0;
+    }
+
+    for (auto& xcmd : pending) {
+      XRT_DEBUGF("xcmd(%d) [new->queued]\n",xcmd->get_uid());
+      xcmd->set_int_state(ERT_CMD_STATE_QUEUED);
+      m_command_queue.push_back(std::move(xcmd));
     }
-    s_num_pending = s_pending_cmds.size();
   }
 
   // Transition command to submitted state if possible
@@ -758,20 +748,20 @@ class xocl_scheduler
   wait()
   {
     std::unique_lock<std::mutex> lk(m_mutex);
-    while (!m_stop && !s_num_pending && m_command_queue.empty())
+    while (!m_stop && !m_num_pending && m_command_queue.empty())
       m_work.wait(lk);
 
     if (m_stop) {
-      if (!m_command_queue.empty() || s_num_pending)
+      if (!m_command_queue.empty() || m_num_pending)
         throw std::runtime_error("software scheduler stopping while there are active commands");
     }
 
-    if (s_num_pending || m_cmd_completed)
+    if (m_num_pending || m_cmd_completed)
       return;
 
     // Sleep if no new pending commands or no running command have completed
     // throttle polling for cu completion
-    if (auto us = xrt_core::config::get_polling_throttle())
+    if (auto us = xrt_core::config::get_snapshot().polling_throttle)
       std::this_thread::sleep_for(std::chrono::microseconds(us));
   }
 
@@ -785,48 +775,111 @@ class xocl_scheduler
     iterate_cmds();
   }
 
+  // Run the scheduler until it is stopped
+  void
+  run()
+  {
+    while (!m_stop)
+      loop();
+  }
+
 public:
 
-  // Wake up the scheduler if it is waiting
+  ~xocl_scheduler()
+  {
+    stop();
+  }
+
+  // Add a new command and wake up the scheduler if it is waiting
   void
-  notify()
+  submit(xcmd_ptr xcmd)
   {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_pending.push_back(std::move(xcmd));
+    ++m_num_pending;
     m_work.notify_one();
   }
 
-  // Run the scheduler until it is stopped
+  // Wake up host threads waiting for command completion
   void
-  run()
+  notify_complete()
   {
-    while (!m_stop)
-      loop();
+    std::lock_guard<std::mutex> lk(m_complete_mutex);
+    m_complete.notify_all();
+  }
+
+  // Wait for a command managed by this scheduler to complete
+  void
+  wait_complete(const ert_packet* pkt)
+  {
+    std::unique_lock<std::mutex> lk(m_complete_mutex);
+    while (pkt->state < ERT_CMD_STATE_COMPLETED)
+      m_complete.wait(lk);
+  }
+
+  // Start the scheduler thread
+  void
+  start()
+  {
+    if (m_thread.joinable())
+      return;
+
+    m_stop = false;
+    m_thread = xrt_core::thread(xrt_core::thread_class::scheduler, &xocl_scheduler::run, this);
   }
 
-  // Stop the scheduler
+  // Stop the scheduler and wait for its thread to exit
   void
   stop()
   {
-    std::lock_guard<std::mutex> lk(m_mutex);
-    m_stop = true;
-    m_work.notify_one();
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+      m_work.notify_one();
+    }
+
+    if (m_thread.joinable())
+      m_thread.join();
   }
 
 };
 
+void
+xocl_cmd::
+notify_host() const
+{
+  auto retain = m_cmd->shared_from_this();
+  m_cmd->notify(ERT_CMD_STATE_COMPLETED);
+  m_exec->get_scheduler()->notify_complete();
+}
+
 ////////////////////////////////////////////////////////////////
-// One static scheduler currently on a single thread
-static xocl_scheduler s_global_scheduler;
-static std::thread s_scheduler_thread;
-static bool s_running=false;
+// Each device has an execution core and a scheduler on its own
+// thread.  The scheduler is started when sws is started.
+struct device_sws
+{
+  std::unique_ptr<xocl_scheduler> scheduler;
+  std::unique_ptr<exec_core> exec;
 
-// Each device has a execution core
-static std::map<const xrt_core::device*, std::unique_ptr<exec_core>> s_device_exec_core;
+  ~device_sws()
+  {
+    // stop scheduler thread before destroying the core it manages
+    scheduler.reset();
+  }
+};
+
+// The map owns the per device state, the core device caches its
+// exec_core for lookup without locking.
+static bool s_running=false;
+static std::mutex s_device_sws_mutex;
+static std::map<const xrt_core::device*, device_sws> s_device_sws;
 
-// Thread routine for scheduler loop
-static void
-scheduler_loop()
+static exec_core*
+get_exec_core(const xrt_core::device* device)
 {
-  s_global_scheduler.run();
+  if (auto exec = static_cast<exec_core*>(device->get_exec_state()))
+    return exec;
+  throw std::runtime_error("internal error: missing sws device");
 }
 
 } // namespace
@@ -836,16 +889,8 @@ namespace xrt_core { namespace sws {
 void
 managed_start(xrt_core::command* cmd)
 {
-  auto device = cmd->get_device();
-
-  auto& exec = s_device_exec_core[device];
-  auto xcmd = xocl_cmd::create(exec.get(),cmd);
-  auto scheduler = exec->get_scheduler();
-
-  std::lock_guard<std::mutex> lk(s_pending_mutex);
-  s_pending_cmds.push_back(xcmd);
-  ++s_num_pending;
-  scheduler->notify();
+  auto exec = get_exec_core(cmd->get_device());
+  exec->get_scheduler()->submit(xocl_cmd::create(exec,cmd));
 }
 
 // The software scheduler manages all command execution but upper
@@ -855,30 +900,31 @@ managed_start(xrt_core::command* cmd)
 void
 unmanaged_wait(const xrt_core::command* cmd)
 {
-  auto ert_pkt = cmd->get_ert_packet();
-  std::unique_lock<std::mutex> lk(s_cmd_complete_mutex);
-  while (ert_pkt->state < ERT_CMD_STATE_COMPLETED)
-    s_cmd_complete_cond.wait(lk);
+  auto exec = get_exec_core(cmd->get_device());
+  exec->get_scheduler()->wait_complete(cmd->get_ert_packet());
 }
 
 void
 start()
 {
+  std::lock_guard<std::mutex> lk(s_device_sws_mutex);
   if (s_running)
     throw std::runtime_error("software command scheduler is already started");
 
-  s_scheduler_thread = xrt_core::thread(scheduler_loop);
+  for (auto& entry : s_device_sws)
+    entry.second.scheduler->start();
   s_running = true;
 }
 
 void
 stop()
 {
+  std::lock_guard<std::mutex> lk(s_device_sws_mutex);
   if (!s_running)
     return;
 
-  s_global_scheduler.stop();
-  s_scheduler_thread.join();
+  for (auto& entry : s_device_sws)
+    entry.second.scheduler->stop();
 
   s_running = false;
 }
@@ -910,10 +956,15 @@ init(xrt_core::device* xdev)
   // create execution core for this device
   cu_trace_enabled = xrt_core::config::get_opencl_summary();
 
-  s_device_exec_core.erase(xdev);
-  s_device_exec_core.insert
-    (std::make_pair
-     (xdev,std::make_unique<exec_core>(xdev,&s_global_scheduler,slots,amap)));
+  std::lock_guard<std::mutex> lk(s_device_sws_mutex);
+  xdev->set_exec_state(nullptr);
+  s_device_sws.erase(xdev);
+  auto& dsws = s_device_sws[xdev];
+  dsws.scheduler = std::make_unique<xocl_scheduler>();
+  dsws.exec = std::make_unique<exec_core>(xdev,dsws.scheduler.get(),slots,amap);
+  xdev->set_exec_state(dsws.exec.get());
+  if (s_running)
+    dsws.scheduler->start();
 }
 
 }} // sws,xrt
@@ -21,10 +21,16 @@
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
 #include "core/include/experimental/xrt_bo.h"
 #include "core/include/experimental/xrt_aie.h"
+#include "core/include/experimental/xrt_bo_async.h"
+#include "core/include/experimental/xrt_bo_dirty.h"
+#include "core/include/experimental/xrt_bo_fill.h"
+#include "core/include/experimental/xrt_bo_pool.h"
+#include "core/include/experimental/xrt_bo_striped.h"
 #include "native_profile.h"
 #include "bo.h"
 
 #include "device_int.h"
+#include "enqueue.h"
 #include "handle.h"
 #include "kernel_int.h"
 #include "core/common/device.h"
@@ -32,15 +38,31 @@
 #include "core/common/message.h"
 #include "core/common/query_requests.h"
 #include "core/common/system.h"
+#include "core/common/task.h"
+#include "core/common/thread.h"
+#include "core/common/usdt.h"
 #include "core/common/unistd.h"
 #include "core/common/xclbin_parser.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <exception>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define XRT_BO_NONTEMPORAL
+#endif
+
 #ifdef _WIN32
 # pragma warning( disable : 4244 4100 4996 4505 )
 #endif
@@ -106,6 +128,53 @@ is_aligned_ptr(const void* p)
   return p && (reinterpret_cast<uintptr_t>(p) % get_alignment())==0;
 }
 
+// Fill host range with repeated pattern, doubling the filled range
+// with each copy
+inline void
+fill_host_range(char* dst, const void* pattern, size_t pattern_size, size_t sz)
+{
+  std::memcpy(dst, pattern, pattern_size);
+  for (size_t filled = pattern_size; filled < sz; ) {
+    auto n = std::min(filled, sz - filled);
+    std::memcpy(dst + filled, dst, n);
+    filled += n;
+  }
+}
+
+// Copy with non-temporal stores that bypass the CPU cache.  The head
+// of dst is copied with memcpy to get 16 byte alignment for streaming
+// stores, the tail is copied with memcpy.
+inline void
+nontemporal_memcpy(void* dst, const void* src, size_t sz)
+{
+#ifdef XRT_BO_NONTEMPORAL
+  constexpr size_t align = sizeof(__m128i);
+  auto d = static_cast<char*>(dst);
+  auto s = static_cast<const char*>(src);
+
+  auto head = std::min(sz, (align - (reinterpret_cast<uintptr_t>(d) % align)) % align);
+  std::memcpy(d, s, head);
+  d += head; s += head; sz -= head;
+
+  for (; sz >= 4 * align; d += 4 * align, s += 4 * align, sz -= 4 * align) {
+    auto v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    auto v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + align));
+    auto v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 2 * align));
+    auto v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 3 * align));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d), v0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + align), v1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 2 * align), v2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 3 * align), v3);
+  }
+
+  // order streaming stores before subsequent sync of the buffer
+  _mm_sfence();
+  std::memcpy(d, s, sz);
+#else
+  std::memcpy(dst, src, sz);
+#endif
+}
+
 inline void
 send_exception_message(const char* msg)
 {
@@ -122,6 +191,61 @@ send_exception_message(const std::string& msg)
 
 namespace xrt {
 
+// class dirty_ranges - Modified ranges of a buffer object
+//
+// Ranges are page aligned and kept disjoint and non-adjacent in a
+// map from start offset to end offset, so that each range is synced
+// with exactly one transfer.
+class dirty_ranges
+{
+  std::mutex m_mutex;
+  std::map<size_t, size_t> m_ranges;
+
+public:
+  void
+  mark(size_t begin, size_t end)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+
+    // first range that may overlap or touch [begin, end)
+    auto itr = m_ranges.upper_bound(begin);
+    if (itr != m_ranges.begin() && std::prev(itr)->second >= begin)
+      --itr;
+
+    while (itr != m_ranges.end() && itr->first <= end) {
+      begin = std::min(begin, itr->first);
+      end = std::max(end, itr->second);
+      itr = m_ranges.erase(itr);
+    }
+
+    m_ranges.emplace(begin, end);
+  }
+
+  // Call sync(size, offset) on each range, a range is removed
+  // when its sync succeeded
+  template <typename SyncFunction>
+  size_t
+  sync(SyncFunction&& sync)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    size_t bytes = 0;
+    for (auto itr = m_ranges.begin(); itr != m_ranges.end(); ) {
+      auto size = itr->second - itr->first;
+      sync(size, itr->first);
+      bytes += size;
+      itr = m_ranges.erase(itr);
+    }
+    return bytes;
+  }
+
+  void
+  clear()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_ranges.clear();
+  }
+};
+
 // class bo_impl - Base class for buffer objects
 //
 // [bo_impl]: base class
@@ -173,6 +297,7 @@ protected:
   mutable bo::flags flags = no_flags;           // NOLINT flags per bo properties
   mutable xclBufferExportHandle export_handle = null_export; // NOLINT export handle if exported
   bool free_bo;                                 // NOLINT should dtor free bo
+  dirty_ranges dirty;                           // NOLINT explicitly marked modified ranges
 
 public:
   explicit bo_impl(size_t sz)
@@ -268,7 +393,11 @@ public:
     if (sz + seek > size)
       throw xrt_core::error(-EINVAL,"attempting to write past buffer size");
     auto hbuf = static_cast<char*>(get_hbuf()) + seek;
-    std::memcpy(hbuf, src, sz);
+    static size_t nontemporal = xrt_core::config::get_bo_write_nontemporal_threshold();
+    if (nontemporal && sz >= nontemporal)
+      nontemporal_memcpy(hbuf, src, sz);
+    else
+      std::memcpy(hbuf, src, sz);
   }
 
   void
@@ -296,6 +425,15 @@ public:
       return;
     }
 
+#ifndef XRT_EDGE
+    // imported buffers are copied by the driver DMA engine, this
+    // includes dma-bufs from peer devices without host mapping
+    if (!is_sw_emulation() && (is_imported() || src->is_imported())) {
+      device->copy_bo(get_xcl_handle(), src->get_xcl_handle(), sz, dst_offset, src_offset);
+      return;
+    }
+#endif
+
     // try copying with m2m
     try {
       auto m2m = xrt_core::device_query<xrt_core::query::m2m>(get_device());
@@ -330,6 +468,62 @@ public:
     copy_through_host(src, sz, src_offset, dst_offset);
   }
 
+  // Check if buffers can be copied without going through host
+  bool
+  has_device_copy() const
+  {
+    try {
+      auto m2m = xrt_core::device_query<xrt_core::query::m2m>(get_device());
+      if (xrt_core::query::m2m::to_bool(m2m))
+        return true;
+    }
+    catch (const std::exception&) {
+    }
+
+    return xrt_core::config::get_cdma();
+  }
+
+  // Fill range with repeated pattern.  If buffers can be copied on
+  // device, only the first bytes of the range are seeded with the
+  // pattern from host, the remainder is filled by device side copies
+  // within the buffer that double the filled range with each copy.
+  // The host side buffer, if any, is not updated by device copies.
+  virtual void
+  fill(const void* pattern, size_t pattern_size, size_t sz, size_t offset)
+  {
+    if (!pattern_size || !sz || sz % pattern_size)
+      throw xrt_core::system_error(EINVAL, "fill size must be a positive multiple of pattern size");
+    if (sz + offset > size)
+      throw xrt_core::system_error(EINVAL, "filling past buffer size");
+
+    auto hbuf = static_cast<char*>(get_hbuf());
+    if (hbuf && !has_device_copy()) {
+      fill_host_range(hbuf + offset, pattern, pattern_size, sz);
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, offset);
+      return;
+    }
+
+    constexpr size_t max_seed_size = 64 * 1024;
+    auto seed = std::min(sz, std::max(pattern_size, (max_seed_size / pattern_size) * pattern_size));
+    if (hbuf) {
+      fill_host_range(hbuf + offset, pattern, pattern_size, seed);
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, seed, offset);
+    }
+    else {
+      // device only buffer, seed through staging buffer in same bank
+      xrt::bo staging(device->get_user_handle(), seed, XRT_BO_FLAGS_NONE, static_cast<xrt::memory_group>(get_group_id()));
+      fill_host_range(staging.map<char*>(), pattern, pattern_size, seed);
+      staging.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      copy(staging.get_handle().get(), seed, 0, offset);
+    }
+
+    for (size_t filled = seed; filled < sz; ) {
+      auto n = std::min(filled, sz - filled);
+      copy(this, n, offset, offset + filled);
+      filled += n;
+    }
+  }
+
   void
   copy_with_export(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset)
   {
@@ -339,6 +533,66 @@ public:
     copy(src_import_bo.get_handle().get(), sz, src_offset, dst_offset);
   }
 
+  // Copy one range through host side buffers
+  void
+  copy_range_through_host(const bo_impl* src, const char* src_hbuf, char* dst_hbuf,
+                          size_t sz, size_t src_offset, size_t dst_offset)
+  {
+    // sync to src to ensure data integrity, logically const
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) // special case
+    const_cast<bo_impl*>(src)->sync(XCL_BO_SYNC_BO_FROM_DEVICE, sz, src_offset);
+
+    // copy host side buffer
+    std::memcpy(dst_hbuf + dst_offset, src_hbuf + src_offset, sz);
+
+    // sync modified host buffer to device
+    sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, dst_offset);
+  }
+
+  // Copy through host in chunks.  Each thread claims the next chunk
+  // and copies it through host, so while one thread syncs a chunk
+  // from the source device, other threads copy or sync preceding
+  // chunks to the destination device.  The first error stops all
+  // threads and is rethrown.
+  void
+  copy_chunks_through_host(const bo_impl* src, const char* src_hbuf, char* dst_hbuf,
+                           size_t sz, size_t src_offset, size_t dst_offset,
+                           size_t chunk_size, unsigned int threads)
+  {
+    auto num_chunks = (sz + chunk_size - 1) / chunk_size;
+    std::atomic<size_t> next {0};
+    std::atomic<bool> stop {false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto copier = [&] {
+      try {
+        for (auto chunk = next++; chunk < num_chunks && !stop; chunk = next++) {
+          auto offset = chunk * chunk_size;
+          auto bytes = std::min(chunk_size, sz - offset);
+          copy_range_through_host(src, src_hbuf, dst_hbuf, bytes, src_offset + offset, dst_offset + offset);
+        }
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lk(error_mutex);
+        if (!error)
+          error = std::current_exception();
+        stop = true;
+      }
+    };
+
+    std::vector<std::thread> workers;
+    auto num_workers = std::min<size_t>(threads, num_chunks);
+    for (size_t idx = 1; idx < num_workers; ++idx)
+      workers.emplace_back(xrt_core::thread(xrt_core::thread_class::dma, copier));
+    copier();  // calling thread is a copier also
+    for (auto& worker : workers)
+      worker.join();
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
   void
   copy_through_host(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset)
   {
@@ -350,15 +604,14 @@ public:
     if (!dst_hbuf)
       throw xrt_core::system_error(EINVAL, "No host side buffer in destination buffer");
 
-    // sync to src to ensure data integrity, logically const
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) // special case
-    const_cast<bo_impl*>(src)->sync(XCL_BO_SYNC_BO_FROM_DEVICE, sz, src_offset);
-
-    // copy host side buffer
-    std::memcpy(dst_hbuf + dst_offset, src_hbuf + src_offset, sz);
+    static size_t chunk_size = xrt_core::config::get_copy_through_host_chunk_size();
+    static unsigned int threads = xrt_core::config::get_copy_through_host_threads();
+    if (!chunk_size || threads < 2 || sz <= chunk_size) {
+      copy_range_through_host(src, src_hbuf, dst_hbuf, sz, src_offset, dst_offset);
+      return;
+    }
 
-    // sync modified host buffer to device
-    sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, dst_offset);
+    copy_chunks_through_host(src, src_hbuf, dst_hbuf, sz, src_offset, dst_offset, chunk_size, threads);
   }
 
 #ifdef XRT_ENABLE_AIE
@@ -367,6 +620,19 @@ public:
   {
     device->sync_aie_bo(bo, port.c_str(), dir, sz, offset);
   }
+
+  // Enqueue GMIO transfer without waiting, return id for wait_aie()
+  uint64_t
+  submit_aie(xrt::bo& bo, const std::string& port, xclBOSyncDirection dir, size_t sz, size_t offset)
+  {
+    return device->submit_aie_bo(bo, port.c_str(), dir, sz, offset);
+  }
+
+  void
+  wait_aie(const std::string& port, uint64_t id)
+  {
+    device->wait_gmio_transfer(port.c_str(), id);
+  }
 #endif
 
   virtual void
@@ -386,6 +652,103 @@ public:
     device->sync_bo(handle, dir, sz, offset);
   }
 
+  // Submit sync to the shim without waiting for completion, done is
+  // called with the error code when the sync completes.  Returns
+  // false if the buffer cannot be synced asynchronously by the shim.
+  virtual bool
+  submit_sync(xclBOSyncDirection dir, size_t sz, size_t offset, std::function<void(int)> done)
+  {
+    return device->submit_sync_bo(handle, dir, sz, offset, std::move(done));
+  }
+
+  // Sync many (offset, size) ranges of this buffer in one call to the
+  // shim, which syncs them with as few driver calls as it can
+  using range_list = std::vector<std::pair<size_t, size_t>>;
+  virtual void
+  sync_ranges(xclBOSyncDirection dir, const range_list& ranges)
+  {
+    auto count = ranges.size();
+    std::vector<xclBufferHandle> bos(count, handle);
+    std::vector<xclBOSyncDirection> dirs(count, dir);
+    std::vector<size_t> sizes;
+    std::vector<size_t> offsets;
+    sizes.reserve(count);
+    offsets.reserve(count);
+    for (const auto& range : ranges) {
+      offsets.push_back(range.first);
+      sizes.push_back(range.second);
+    }
+    device->sync_bo_batch(bos.data(), dirs.data(), sizes.data(), offsets.data(), count);
+  }
+
+  // Sync depth slices of height rows of width bytes.  Rows that are
+  // adjacent in the buffer are merged, so a region without gaps is
+  // synced as one range.
+  void
+  sync_region(xclBOSyncDirection dir, size_t width, size_t height, size_t depth,
+              size_t pitch, size_t slice_pitch, size_t offset)
+  {
+    if (!width || !height || !depth)
+      return;
+
+    if (pitch < width || (depth > 1 && slice_pitch / pitch < height))
+      throw xrt_core::error(-EINVAL, "Invalid pitch when syncing buffer region");
+
+    // Check the region is inside the buffer without overflowing
+    auto fits = [](size_t count, size_t step, size_t& room) {
+      if (count && count > room / step)
+        return false;
+      room -= count * step;
+      return true;
+    };
+    size_t room = (offset <= size) ? size - offset : 0;
+    if (offset > size || !fits(depth - 1, slice_pitch, room) || !fits(height - 1, pitch, room) || width > room)
+      throw xrt_core::error(-EINVAL, "Invalid region when syncing buffer");
+
+    range_list ranges;
+    for (size_t slice = 0; slice < depth; ++slice) {
+      for (size_t row = 0; row < height; ++row) {
+        auto row_offset = offset + slice * slice_pitch + row * pitch;
+        if (!ranges.empty() && ranges.back().first + ranges.back().second == row_offset)
+          ranges.back().second += width;
+        else
+          ranges.emplace_back(row_offset, width);
+      }
+    }
+
+    if (ranges.size() == 1)
+      sync(dir, ranges.front().second, ranges.front().first);
+    else
+      sync_ranges(dir, ranges);
+  }
+
+  void
+  mark_dirty(size_t sz, size_t offset)
+  {
+    if (sz + offset > size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when marking buffer dirty");
+
+    // Round out to page boundaries clamped to buffer size
+    auto align = get_alignment();
+    auto begin = (offset / align) * align;
+    auto end = std::min(((offset + sz + align - 1) / align) * align, size);
+    dirty.mark(begin, end);
+  }
+
+  size_t
+  sync_dirty()
+  {
+    return dirty.sync([this](size_t sz, size_t offset) {
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, sz, offset);
+    });
+  }
+
+  void
+  clear_dirty()
+  {
+    dirty.clear();
+  }
+
   virtual uint64_t
   get_address() const
   {
@@ -461,6 +824,28 @@ public:
   }
 };
 
+#if defined(__linux__)
+// class buffer_mbuf - XRT allocated host side buffer
+//
+// XRT allocated host side buffer mapped with huge pages and/or
+// bound to the NUMA node of the device.
+class buffer_mbuf : public bo_impl
+{
+  xrt_core::mmap_ptr_type mbuf;
+
+public:
+  buffer_mbuf(xclDeviceHandle dhdl, xclBufferHandle bhdl, size_t sz, xrt_core::mmap_ptr_type&& b)
+    : bo_impl(dhdl, bhdl, sz), mbuf(std::move(b))
+  {}
+
+  void*
+  get_hbuf() const override
+  {
+    return mbuf.get();
+  }
+};
+#endif
+
 // class buffer_kbuf - Kernel driver host side buffer
 //
 // Kernel driver allocated host side buffer.  The host side buffer
@@ -502,7 +887,11 @@ public:
 // The exported buffer handle is an opaque type from a call
 // to export_buffer() on a buffer to be exported.  The exported
 // buffer can be imported within same process or from another
-// process (linux pidfd support required)
+// process (linux pidfd support required).  On Linux the export
+// handle is a dma-buf file descriptor, which can also come from
+// a non XRT exporter such as an RDMA NIC or a GPU.  Such buffers
+// may not be mappable to host, but can be copied to and from
+// buffers of the importing device by the driver's DMA engine.
 class buffer_import : public bo_impl
 {
   void* hbuf;
@@ -632,6 +1021,19 @@ public:
     }
   }
 
+  bool
+  submit_sync(xclBOSyncDirection, size_t, size_t, std::function<void(int)>) override
+  {
+    return false;
+  }
+
+  void
+  sync_ranges(xclBOSyncDirection dir, const range_list& ranges) override
+  {
+    for (const auto& range : ranges)
+      sync(dir, range.second, range.first);
+  }
+
   void
   copy(const bo_impl* src, size_t sz, size_t src_offset, size_t dst_offset) override
   {
@@ -691,6 +1093,40 @@ public:
     // sync through parent buffer, which handles nodma case also
     m_parent->sync(dir, sz, off);
   }
+
+  bool
+  submit_sync(xclBOSyncDirection dir, size_t sz, size_t offset, std::function<void(int)> done) override
+  {
+    size_t off = offset + m_offset;
+    if (off + sz > m_parent->get_size())
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing sub buffer");
+
+    return m_parent->submit_sync(dir, sz, off, std::move(done));
+  }
+
+  void
+  sync_ranges(xclBOSyncDirection dir, const range_list& ranges) override
+  {
+    range_list parent_ranges;
+    parent_ranges.reserve(ranges.size());
+    for (const auto& range : ranges) {
+      size_t off = range.first + m_offset;
+      if (off + range.second > m_parent->get_size())
+        throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing sub buffer");
+      parent_ranges.emplace_back(off, range.second);
+    }
+
+    m_parent->sync_ranges(dir, parent_ranges);
+  }
+
+  void
+  fill(const void* pattern, size_t pattern_size, size_t sz, size_t offset) override
+  {
+    if (offset + sz > size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when filling sub buffer");
+
+    m_parent->fill(pattern, pattern_size, sz, offset + m_offset);
+  }
 };
 
 // class buffer_xbuf - Wrapper for extern managed xclBufferHandle
@@ -724,6 +1160,18 @@ public:
     throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
   }
 
+  void
+  sync_ranges(xclBOSyncDirection, const range_list&) override
+  {
+    throw xrt_core::error(std::errc::not_supported, "no sync of xcl managed BOs");
+  }
+
+  bool
+  submit_sync(xclBOSyncDirection, size_t, size_t, std::function<void(int)>) override
+  {
+    return false;
+  }
+
   bool
   is_sub() const override
   {
@@ -837,6 +1285,76 @@ alloc_hbuf(xclDeviceHandle dhdl, xrt_core::aligned_ptr_type&& hbuf, size_t sz, x
   return boh;
 }
 
+#if defined(__linux__)
+static size_t
+get_host_buffer_page_size()
+{
+  static size_t page_size = [] {
+    auto value = xrt_core::config::get_host_buffer_huge_pages();
+    if (value == "2M")
+      return size_t(2) << 20;
+    if (value == "1G")
+      return size_t(1) << 30;
+    if (value != "none")
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Ignoring invalid Runtime.host_buffer_huge_pages '" + value + "'");
+    return size_t(0);
+  }();
+  return page_size;
+}
+
+// NUMA node of device, -1 if unknown.  Cached per device id
+static int
+get_numa_node(xclDeviceHandle dhdl)
+{
+  static std::mutex mutex;
+  static std::map<unsigned int, int> nodes;
+
+  auto device = xrt_core::get_userpf_device(dhdl);
+  std::lock_guard<std::mutex> lk(mutex);
+  auto itr = nodes.find(device->get_device_id());
+  if (itr != nodes.end())
+    return itr->second;
+
+  int node = -1;
+  try {
+    node = std::stoi(xrt_core::device_query<xrt_core::query::numa_node>(device));
+  }
+  catch (const std::exception&) {
+  }
+  nodes.emplace(device->get_device_id(), node);
+  return node;
+}
+
+// Host backing with huge pages and/or NUMA binding per xrt.ini.
+// Returns nullptr if not configured or if the mapping failed, in
+// which case the caller falls back to aligned allocation.
+static std::shared_ptr<xrt::bo_impl>
+alloc_mbuf(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
+{
+  static bool numa_local = xrt_core::config::get_host_buffer_numa_local();
+  auto page_size = get_host_buffer_page_size();
+  if (!page_size && !numa_local)
+    return nullptr;
+
+  xrt_core::mmap_ptr_type mbuf;
+  try {
+    mbuf = xrt_core::mmap_alloc(sz, page_size, numa_local ? get_numa_node(dhdl) : -1);
+  }
+  catch (const std::exception& ex) {
+    static std::once_flag warn;
+    std::call_once(warn, [&ex] {
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              std::string(ex.what()) + ", falling back to system pages for host buffers");
+    });
+    return nullptr;
+  }
+
+  auto handle = alloc_bo(dhdl, mbuf.get(), sz, flags, grp);
+  return std::make_shared<xrt::buffer_mbuf>(dhdl, handle, sz, std::move(mbuf));
+}
+#endif
+
 static std::shared_ptr<xrt::bo_impl>
 alloc_dbuf(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags, xrtMemoryGroup grp)
 {
@@ -862,6 +1380,9 @@ alloc_nodma(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags, xrtMemoryGroup grp)
 static std::shared_ptr<xrt::bo_impl>
 alloc(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
 {
+  // Memory group requires xclbin to be loaded, see xrt::load_xclbin_async
+  xrt_core::get_userpf_device(dhdl)->wait_pending_load();
+
   auto type = flags & ~XRT_BO_FLAGS_MEMIDX_MASK;
   switch (type) {
   case 0:
@@ -872,6 +1393,10 @@ alloc(xclDeviceHandle dhdl, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
       // In DC scenario, for sw_emu, use the xclAllocBO and xclMapBO instead of xclAllocUserPtrBO,
       // which helps to remove the extra copy in sw_emu.
       return alloc_kbuf(dhdl, sz, flags, grp);
+#if defined(__linux__)
+    else if (auto boh = alloc_mbuf(dhdl, sz, flags, grp))
+      return boh;
+#endif
     else
       return alloc_hbuf(dhdl, xrt_core::aligned_alloc(get_alignment(), sz), sz, flags, grp);
 #endif
@@ -897,6 +1422,7 @@ alloc_xbuf(xclDeviceHandle dhdl, xclBufferHandle xhdl)
 static std::shared_ptr<xrt::bo_impl>
 alloc_userptr(xclDeviceHandle dhdl, void* userptr, size_t sz, xrtBufferFlags flags, xrtMemoryGroup grp)
 {
+  xrt_core::get_userpf_device(dhdl)->wait_pending_load();
   return alloc_ubuf(dhdl, userptr, sz, flags, grp);
 }
 
@@ -906,10 +1432,75 @@ alloc_import(xclDeviceHandle dhdl, xclBufferExportHandle ehdl)
   return std::make_shared<xrt::buffer_import>(dhdl, ehdl);
 }
 
+// Buffers imported from other processes keyed by device, pid, and
+// export handle.  A repeated import of a buffer that is still
+// referenced in this process shares the imported buffer rather than
+// importing again.  An entry is used only if the export handle of the
+// other process still refers to the same buffer as the local export
+// of the imported buffer, which also fails if the other process has
+// exited.  Entries of released buffers are pruned on insertion.
+namespace {
+
+struct import_cache
+{
+  using key_type = std::tuple<const xrt_core::device*, pid_t, xclBufferExportHandle>;
+  std::mutex mutex;
+  std::map<key_type, std::weak_ptr<xrt::bo_impl>> imports;
+};
+
+static import_cache&
+get_import_cache()
+{
+  static import_cache cache;
+  return cache;
+}
+
+static bool
+is_valid_import(const std::shared_ptr<xrt::bo_impl>& bo, pid_t pid, xclBufferExportHandle ehdl)
+{
+  try {
+    return bo->get_device()->is_same_export(pid, ehdl, bo->export_buffer());
+  }
+  catch (const std::exception&) {
+    return false;
+  }
+}
+
+} // namespace
+
 static std::shared_ptr<xrt::bo_impl>
 alloc_import_from_pid(xclDeviceHandle dhdl, xrt::pid_type pid, xclBufferExportHandle ehdl)
 {
-  return std::make_shared<xrt::buffer_import>(dhdl, pid, ehdl);
+  auto& cache = get_import_cache();
+  import_cache::key_type key{xrt_core::get_userpf_device(dhdl).get(), pid.pid, ehdl};
+
+  {
+    std::lock_guard<std::mutex> lk(cache.mutex);
+    auto itr = cache.imports.find(key);
+    if (itr != cache.imports.end()) {
+      if (auto bo = itr->second.lock()) {
+        if (is_valid_import(bo, pid.pid, ehdl))
+          return bo;
+      }
+      cache.imports.erase(itr);
+    }
+  }
+
+  std::shared_ptr<xrt::bo_impl> bo = std::make_shared<xrt::buffer_import>(dhdl, pid, ehdl);
+
+  // Cache only if the import can be validated when reused
+  if (!is_valid_import(bo, pid.pid, ehdl))
+    return bo;
+
+  std::lock_guard<std::mutex> lk(cache.mutex);
+  for (auto itr = cache.imports.begin(); itr != cache.imports.end();) {
+    if (itr->second.expired())
+      itr = cache.imports.erase(itr);
+    else
+      ++itr;
+  }
+  cache.imports[key] = bo;
+  return bo;
 }
 
 static std::shared_ptr<xrt::bo_impl>
@@ -1145,7 +1736,30 @@ sync(xclBOSyncDirection dir, size_t size, size_t offset)
 {
   return xdp::native::profiling_wrapper_sync("xrt::bo::sync", dir, size,
     [this, dir, size, offset]{
+      XRT_USDT(bo_sync_begin, handle.get(), static_cast<int>(dir), size, offset);
       handle->sync(dir, size, offset);
+      XRT_USDT(bo_sync_end, handle.get(), static_cast<int>(dir));
+    });
+}
+
+void
+bo::
+sync_2d(xclBOSyncDirection dir, size_t width, size_t height, size_t pitch, size_t offset)
+{
+  return xdp::native::profiling_wrapper_sync("xrt::bo::sync_2d", dir, width * height,
+    [this, dir, width, height, pitch, offset]{
+      handle->sync_region(dir, width, height, 1, pitch, 0, offset);
+    });
+}
+
+void
+bo::
+sync_3d(xclBOSyncDirection dir, size_t width, size_t height, size_t depth,
+        size_t pitch, size_t slice_pitch, size_t offset)
+{
+  return xdp::native::profiling_wrapper_sync("xrt::bo::sync_3d", dir, width * height * depth,
+    [this, dir, width, height, depth, pitch, slice_pitch, offset]{
+      handle->sync_region(dir, width, height, depth, pitch, slice_pitch, offset);
     });
 }
 
@@ -1204,6 +1818,965 @@ sync(const std::string& port, xclBOSyncDirection dir, size_t sz, size_t offset)
 }} // namespace aie, xrt
 #endif
 
+////////////////////////////////////////////////////////////////
+// xrt_bo_async C++ experimental API implmentations (xrt_bo_async.h)
+////////////////////////////////////////////////////////////////
+namespace {
+
+// Worker threads executing asynchronous buffer syncs.  A sync
+// blocks its worker for the duration of the DMA, so syncs do not
+// share workers with run completion callbacks.
+class sync_dispatch
+{
+  xrt_core::task::queue m_queue;
+  std::vector<std::thread> m_workers;
+
+public:
+  explicit
+  sync_dispatch(unsigned int workers)
+  {
+    for (unsigned int idx = 0; idx < workers; ++idx)
+      m_workers.emplace_back(xrt_core::thread(xrt_core::thread_class::dma, xrt_core::task::worker, std::ref(m_queue)));
+  }
+
+  ~sync_dispatch()
+  {
+    m_queue.stop();
+    for (auto& worker : m_workers)
+      worker.join();
+  }
+
+  sync_dispatch(const sync_dispatch&) = delete;
+  sync_dispatch(sync_dispatch&&) = delete;
+  sync_dispatch& operator=(sync_dispatch&) = delete;
+  sync_dispatch& operator=(sync_dispatch&&) = delete;
+
+  // Return pool or nullptr if syncs should be executed inline
+  static sync_dispatch*
+  get()
+  {
+    static auto workers = xrt_core::config::get_bo_sync_threads();
+    static sync_dispatch pool(workers);
+    return workers ? &pool : nullptr;
+  }
+
+  template <typename Callable>
+  void
+  dispatch(Callable&& fcn)
+  {
+    m_queue.addWork(xrt_core::task::task(std::forward<Callable>(fcn)));
+  }
+};
+
+// Execute op asynchronously by a sync worker and return an event
+// that is complete when op is done
+template <typename Callable>
+static xrt::sync_event
+async_dispatch(Callable&& op)
+{
+  auto promise = std::make_shared<std::promise<void>>();
+  std::shared_future<void> result = promise->get_future();
+  auto ev = xrt_core::enqueue::create_event();
+
+  auto task = [promise, evp = ev.get_impl(), op = std::forward<Callable>(op)] {
+    try {
+      op();
+      promise->set_value();
+    }
+    catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+    xrt_core::enqueue::done(evp.get());
+  };
+
+  if (auto pool = sync_dispatch::get())
+    pool->dispatch(std::move(task));
+  else
+    task();
+
+  return {std::move(ev), std::move(result)};
+}
+
+// Submit the sync of one range directly to the shim, which completes
+// the event from its DMA workers.  Returns an empty event if the
+// buffer cannot be synced asynchronously by the shim.
+static xrt::sync_event
+async_submit_range(const xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t offset)
+{
+  if (!sync_dispatch::get())
+    return {};
+
+  auto promise = std::make_shared<std::promise<void>>();
+  std::shared_future<void> result = promise->get_future();
+  auto ev = xrt_core::enqueue::create_event();
+
+  // The done function keeps the buffer alive until the sync completes
+  auto done = [promise, evp = ev.get_impl(), bo](int err) {
+    if (err)
+      promise->set_exception(std::make_exception_ptr(xrt_core::system_error(err, "unable to sync BO")));
+    else
+      promise->set_value();
+    xrt_core::enqueue::done(evp.get());
+  };
+
+  if (!bo.get_handle()->submit_sync(dir, size, offset, std::move(done)))
+    return {};
+
+  return {std::move(ev), std::move(result)};
+}
+
+static xrt::sync_event
+async_sync_ranges(std::vector<xrt::sync_range>&& ranges)
+{
+  return async_dispatch([ranges = std::move(ranges)] {
+    for (const auto& range : ranges)
+      range.bo.get_handle()->sync(range.dir, range.size, range.offset);
+  });
+}
+
+} // namespace
+
+namespace xrt {
+
+sync_event
+async_sync(const xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t offset)
+{
+  return xdp::native::profiling_wrapper("xrt::async_sync", [&bo, dir, size, offset]{
+    if (auto ev = async_submit_range(bo, dir, size, offset))
+      return ev;
+
+    std::vector<sync_range> ranges;
+    ranges.emplace_back(bo, dir, size, offset);
+    return async_sync_ranges(std::move(ranges));
+  });
+}
+
+sync_event
+sync_batch(std::vector<sync_range> ranges)
+{
+  return xdp::native::profiling_wrapper("xrt::sync_batch", [&ranges]{
+    return async_sync_ranges(std::move(ranges));
+  });
+}
+
+sync_event
+async_copy(const xrt::bo& dst, const xrt::bo& src, size_t size,
+           size_t dst_offset, size_t src_offset)
+{
+  return xdp::native::profiling_wrapper("xrt::async_copy",
+    [&dst, &src, size, dst_offset, src_offset]{
+      // The task holds the buffers until the copy is done
+      return async_dispatch([dst, src, size, dst_offset, src_offset] {
+        dst.get_handle()->copy(src.get_handle().get(), size, src_offset, dst_offset);
+      });
+    });
+}
+
+} // xrt
+
+#ifdef XRT_ENABLE_AIE
+namespace xrt { namespace aie {
+
+sync_event
+async_sync(const xrt::aie::bo& bo, const std::string& port, xclBOSyncDirection dir, size_t size, size_t offset)
+{
+  return xdp::native::profiling_wrapper("xrt::aie::async_sync", [&bo, &port, dir, size, offset]{
+    // The transfer is enqueued to the GMIO channel in order by the
+    // calling thread, only the wait for completion is asynchronous
+    xrt::bo xbo = bo;
+    auto id = xbo.get_handle()->submit_aie(xbo, port, dir, size, offset);
+    return async_dispatch([xbo, port, id] {
+      xbo.get_handle()->wait_aie(port, id);
+    });
+  });
+}
+
+sync_event
+async_sync(const xrt::aie::bo& bo, const std::string& port, xclBOSyncDirection dir)
+{
+  return async_sync(bo, port, dir, bo.size(), 0);
+}
+
+}} // namespace aie, xrt
+#endif
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_fill C++ experimental API implmentations (xrt_bo_fill.h)
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+void
+fill(const xrt::bo& bo, const void* pattern, size_t pattern_size, size_t size, size_t offset)
+{
+  xdp::native::profiling_wrapper("xrt::fill", [&bo, pattern, pattern_size, size, offset]{
+    bo.get_handle()->fill(pattern, pattern_size, size, offset);
+  });
+}
+
+sync_event
+async_fill(const xrt::bo& bo, const void* pattern, size_t pattern_size, size_t size, size_t offset)
+{
+  return xdp::native::profiling_wrapper("xrt::async_fill", [&bo, pattern, pattern_size, size, offset]{
+    // copy pattern, caller may release it before fill executes
+    auto data = static_cast<const char*>(pattern);
+    std::vector<char> copy(data, data + pattern_size);
+    return async_dispatch([bo, copy = std::move(copy), size, offset] {
+      bo.get_handle()->fill(copy.data(), copy.size(), size, offset);
+    });
+  });
+}
+
+} // xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_pool C++ experimental API implmentations (xrt_bo_pool.h)
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+// class buffer_pooled - Buffer object allocated from a bo_pool
+//
+// The pooled buffer is a view of a backing buffer of a pool size
+// class.  When the pooled buffer is deleted, the backing buffer is
+// returned to the pool if the pool still exists.
+class buffer_pooled : public bo_impl
+{
+  std::shared_ptr<bo_impl> m_backing;
+  std::weak_ptr<bo_pool_impl> m_pool;
+
+public:
+  buffer_pooled(std::shared_ptr<bo_impl> backing, size_t size, std::weak_ptr<bo_pool_impl> pool)
+    : bo_impl(backing.get(), size)
+    , m_backing(std::move(backing))
+    , m_pool(std::move(pool))
+  {}
+
+  ~buffer_pooled() override;
+
+  buffer_pooled(const buffer_pooled&) = delete;
+  buffer_pooled(buffer_pooled&&) = delete;
+  buffer_pooled& operator=(buffer_pooled&) = delete;
+  buffer_pooled& operator=(buffer_pooled&&) = delete;
+
+  void*
+  get_hbuf() const override
+  {
+    return m_backing->get_hbuf();
+  }
+
+  uint64_t
+  get_address() const override
+  {
+    return m_backing->get_address();
+  }
+
+  void
+  sync(xclBOSyncDirection dir, size_t sz, size_t offset) override
+  {
+    if (offset + sz > size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing pooled buffer");
+
+    // sync through backing buffer, which handles nodma case also
+    m_backing->sync(dir, sz, offset);
+  }
+
+  bool
+  submit_sync(xclBOSyncDirection dir, size_t sz, size_t offset, std::function<void(int)> done) override
+  {
+    if (offset + sz > size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing pooled buffer");
+
+    return m_backing->submit_sync(dir, sz, offset, std::move(done));
+  }
+
+  void
+  sync_ranges(xclBOSyncDirection dir, const range_list& ranges) override
+  {
+    for (const auto& range : ranges) {
+      if (range.first + range.second > size)
+        throw xrt_core::error(-EINVAL, "Invalid offset and size when syncing pooled buffer");
+    }
+
+    m_backing->sync_ranges(dir, ranges);
+  }
+
+  void
+  fill(const void* pattern, size_t pattern_size, size_t sz, size_t offset) override
+  {
+    if (offset + sz > size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size when filling pooled buffer");
+
+    m_backing->fill(pattern, pattern_size, sz, offset);
+  }
+};
+
+// class bo_pool_impl - Idle backing buffers per size class
+class bo_pool_impl : public std::enable_shared_from_this<bo_pool_impl>
+{
+  static constexpr size_t min_class_size = 4096;
+  static constexpr size_t max_pow2_class_size = 1024 * 1024;
+
+  std::shared_ptr<xrt_core::device> m_device;  // keep device alive
+  xclDeviceHandle m_dhdl;
+  xrtBufferFlags m_flags;
+  xrt::memory_group m_grp;
+
+  std::map<size_t, std::vector<std::shared_ptr<bo_impl>>> m_idle; // per size class
+  size_t m_low_water = 0;
+  size_t m_high_water = 0;
+  xrt::bo_pool::stats m_stats {};
+  mutable std::mutex m_mutex;
+
+  static size_t
+  size_class(size_t size)
+  {
+    if (size > max_pow2_class_size)
+      return ((size + max_pow2_class_size - 1) / max_pow2_class_size) * max_pow2_class_size;
+
+    size_t cls = min_class_size;
+    while (cls < size)
+      cls <<= 1;
+    return cls;
+  }
+
+  // Remove idle buffers until at or below bytes, the removed buffers
+  // are returned so that they can be freed outside the lock.
+  std::vector<std::shared_ptr<bo_impl>>
+  evict(size_t bytes)
+  {
+    std::vector<std::shared_ptr<bo_impl>> evicted;
+    for (auto itr = m_idle.rbegin(); itr != m_idle.rend() && m_stats.idle_bytes > bytes; ++itr) {
+      auto& idle = itr->second;
+      while (!idle.empty() && m_stats.idle_bytes > bytes) {
+        evicted.push_back(std::move(idle.back()));
+        idle.pop_back();
+        m_stats.idle_bytes -= itr->first;
+        --m_stats.idle_buffers;
+        ++m_stats.freed;
+      }
+    }
+    return evicted;
+  }
+
+public:
+  bo_pool_impl(const xrt::device& device, xrt::memory_group grp, xrt::bo::flags flags)
+    : m_device(device.get_handle())
+    , m_dhdl(device)
+    , m_flags(adjust_buffer_flags(device, flags, grp))
+    , m_grp(grp)
+  {}
+
+  xrt::bo
+  alloc(size_t sz)
+  {
+    if (!sz)
+      throw xrt_core::system_error(EINVAL, "size must be a positive number");
+
+    auto cls = size_class(sz);
+    std::shared_ptr<bo_impl> backing;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      ++m_stats.allocs;
+      auto& idle = m_idle[cls];
+      if (!idle.empty()) {
+        backing = std::move(idle.back());
+        idle.pop_back();
+        m_stats.idle_bytes -= cls;
+        --m_stats.idle_buffers;
+        ++m_stats.hits;
+      }
+      else {
+        ++m_stats.misses;
+      }
+    }
+
+    if (!backing)
+      backing = ::alloc(m_dhdl, cls, m_flags, m_grp);
+
+    return xrt::bo{std::make_shared<buffer_pooled>(std::move(backing), sz, weak_from_this())};
+  }
+
+  void
+  recycle(std::shared_ptr<bo_impl>&& backing)
+  {
+    auto cls = backing->get_size();
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_high_water && m_stats.idle_bytes + cls > m_high_water) {
+      ++m_stats.freed;
+      return;  // backing is freed by caller
+    }
+
+    m_idle[cls].push_back(std::move(backing));
+    m_stats.idle_bytes += cls;
+    ++m_stats.idle_buffers;
+  }
+
+  void
+  set_watermarks(size_t low, size_t high)
+  {
+    if (high && low > high)
+      throw xrt_core::system_error(EINVAL, "low water mark exceeds high water mark");
+
+    std::vector<std::shared_ptr<bo_impl>> evicted;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_low_water = low;
+    m_high_water = high;
+    if (m_high_water)
+      evicted = evict(m_high_water);
+  }
+
+  void
+  trim()
+  {
+    std::vector<std::shared_ptr<bo_impl>> evicted;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    evicted = evict(m_low_water);
+  }
+
+  xrt::bo_pool::stats
+  get_stats() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_stats;
+  }
+};
+
+buffer_pooled::
+~buffer_pooled()
+{
+  if (auto pool = m_pool.lock())
+    pool->recycle(std::move(m_backing));
+}
+
+bo_pool::
+bo_pool(const xrt::device& device, xrt::memory_group grp, xrt::bo::flags flags)
+  : detail::pimpl<bo_pool_impl>(std::make_shared<bo_pool_impl>(device, grp, flags))
+{}
+
+xrt::bo
+bo_pool::
+alloc(size_t size)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_pool::alloc", [this, size]{
+    return handle->alloc(size);
+  });
+}
+
+void
+bo_pool::
+set_watermarks(size_t low, size_t high)
+{
+  handle->set_watermarks(low, high);
+}
+
+void
+bo_pool::
+trim()
+{
+  xdp::native::profiling_wrapper("xrt::bo_pool::trim", [this]{
+    handle->trim();
+  });
+}
+
+bo_pool::stats
+bo_pool::
+get_stats() const
+{
+  return handle->get_stats();
+}
+
+// class bo_arena_impl - Bump allocator in a reserved buffer
+class bo_arena_impl
+{
+  xrt::bo m_region;
+  mutable std::mutex m_mutex;
+  size_t m_next = 0;
+
+public:
+  bo_arena_impl(const xrt::device& device, size_t capacity, xrt::memory_group grp, xrt::bo::flags flags)
+    : m_region(device, capacity, flags, grp)
+  {}
+
+  xrt::bo
+  alloc(size_t size, size_t align)
+  {
+    if (!size)
+      throw xrt_core::error(EINVAL, "Arena buffer size must be positive");
+    if (!align || (align & (align - 1)))
+      throw xrt_core::error(EINVAL, "Arena buffer alignment must be a power of 2");
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto offset = (m_next + align - 1) & ~(align - 1);
+    if (offset + size > m_region.size())
+      throw xrt_core::error(ENOMEM, "Arena capacity exhausted allocating " + std::to_string(size) + " bytes");
+
+    m_next = offset + size;
+    return {m_region, size, offset};
+  }
+
+  void
+  reset()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_next = 0;
+  }
+
+  size_t
+  used() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_next;
+  }
+
+  size_t
+  capacity() const
+  {
+    return m_region.size();
+  }
+};
+
+bo_arena::
+bo_arena(const xrt::device& device, size_t capacity, xrt::memory_group grp, xrt::bo::flags flags)
+  : detail::pimpl<bo_arena_impl>(std::make_shared<bo_arena_impl>(device, capacity, grp, flags))
+{}
+
+xrt::bo
+bo_arena::
+alloc(size_t size, size_t align)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_arena::alloc", [this, size, align]{
+    return handle->alloc(size, align);
+  });
+}
+
+void
+bo_arena::
+reset()
+{
+  handle->reset();
+}
+
+size_t
+bo_arena::
+used() const
+{
+  return handle->used();
+}
+
+size_t
+bo_arena::
+capacity() const
+{
+  return handle->capacity();
+}
+
+// class buffer_heaped - Buffer object allocated from a bo_heap
+//
+// The heaped buffer is a view of a sub-buffer of the heap buffer.
+// When the heaped buffer is deleted, its range is returned to the
+// heap if the heap still exists.
+class buffer_heaped : public bo_impl
+{
+  std::shared_ptr<bo_impl> m_backing;
+  size_t m_offset;
+  std::weak_ptr<bo_heap_impl> m_heap;
+
+public:
+  buffer_heaped(std::shared_ptr<bo_impl> backing, size_t size, size_t offset, std::weak_ptr<bo_heap_impl> heap)
+    : bo_impl(backing.get(), size)
+    , m_backing(std::move(backing))
+    , m_offset(offset)
+    , m_heap(std::move(heap))
+  {}
+
+  ~buffer_heaped() override;
+
+  buffer_heaped(const buffer_heaped&) = delete;
+  buffer_heaped(buffer_heaped&&) = delete;
+  buffer_heaped& operator=(buffer_heaped&) = delete;
+  buffer_heaped& operator=(buffer_heaped&&) = delete;
+
+  void*
+  get_hbuf() const override
+  {
+    return m_backing->get_hbuf();
+  }
+
+  uint64_t
+  get_address() const override
+  {
+    return m_backing->get_address();
+  }
+
+  void
+  sync(xclBOSyncDirection dir, size_t sz, size_t offset) override
+  {
+    m_backing->sync(dir, sz, offset);
+  }
+
+  bool
+  submit_sync(xclBOSyncDirection dir, size_t sz, size_t offset, std::function<void(int)> done) override
+  {
+    return m_backing->submit_sync(dir, sz, offset, std::move(done));
+  }
+
+  void
+  sync_ranges(xclBOSyncDirection dir, const range_list& ranges) override
+  {
+    m_backing->sync_ranges(dir, ranges);
+  }
+
+  void
+  fill(const void* pattern, size_t pattern_size, size_t sz, size_t offset) override
+  {
+    m_backing->fill(pattern, pattern_size, sz, offset);
+  }
+};
+
+// class bo_heap_impl - Best fit allocator in a reserved buffer
+//
+// Free ranges are kept by offset so that a released range is merged
+// with its neighbours in logarithmic time.
+class bo_heap_impl : public std::enable_shared_from_this<bo_heap_impl>
+{
+  xrt::bo m_region;
+  mutable std::mutex m_mutex;
+  std::map<size_t, size_t> m_free;  // offset -> size
+  size_t m_used = 0;
+
+public:
+  bo_heap_impl(const xrt::device& device, size_t capacity, xrt::memory_group grp, xrt::bo::flags flags)
+    : m_region(device, capacity, flags, grp)
+  {
+    m_free.emplace(0, m_region.size());
+  }
+
+  xrt::bo
+  alloc(size_t size, size_t align)
+  {
+    if (!size)
+      throw xrt_core::error(EINVAL, "Heap buffer size must be positive");
+    if (!align || (align & (align - 1)))
+      throw xrt_core::error(EINVAL, "Heap buffer alignment must be a power of 2");
+
+    size_t offset = 0;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      auto best = m_free.end();
+      for (auto itr = m_free.begin(); itr != m_free.end(); ++itr) {
+        auto aligned = (itr->first + align - 1) & ~(align - 1);
+        if (aligned + size > itr->first + itr->second)
+          continue;
+        if (best == m_free.end() || itr->second < best->second)
+          best = itr;
+      }
+      if (best == m_free.end())
+        throw xrt_core::error(ENOMEM, "Heap has no free range for " + std::to_string(size) + " bytes");
+
+      auto start = best->first;
+      auto end = best->first + best->second;
+      offset = (start + align - 1) & ~(align - 1);
+      m_free.erase(best);
+      if (offset > start)
+        m_free.emplace(start, offset - start);
+      if (offset + size < end)
+        m_free.emplace(offset + size, end - offset - size);
+      m_used += size;
+    }
+
+    auto backing = xrt::bo{m_region, size, offset}.get_handle();
+    return xrt::bo{std::make_shared<buffer_heaped>(std::move(backing), size, offset, weak_from_this())};
+  }
+
+  void
+  release(size_t offset, size_t size)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_used -= size;
+    auto itr = m_free.emplace(offset, size).first;
+
+    auto next = std::next(itr);
+    if (next != m_free.end() && itr->first + itr->second == next->first) {
+      itr->second += next->second;
+      m_free.erase(next);
+    }
+
+    if (itr != m_free.begin()) {
+      auto prev = std::prev(itr);
+      if (prev->first + prev->second == itr->first) {
+        prev->second += itr->second;
+        m_free.erase(itr);
+      }
+    }
+  }
+
+  size_t
+  used() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_used;
+  }
+
+  size_t
+  largest_free() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    size_t largest = 0;
+    for (const auto& range : m_free)
+      largest = std::max(largest, range.second);
+    return largest;
+  }
+
+  size_t
+  capacity() const
+  {
+    return m_region.size();
+  }
+};
+
+buffer_heaped::
+~buffer_heaped()
+{
+  if (auto heap = m_heap.lock())
+    heap->release(m_offset, size);
+}
+
+bo_heap::
+bo_heap(const xrt::device& device, size_t capacity, xrt::memory_group grp, xrt::bo::flags flags)
+  : detail::pimpl<bo_heap_impl>(std::make_shared<bo_heap_impl>(device, capacity, grp, flags))
+{}
+
+xrt::bo
+bo_heap::
+alloc(size_t size, size_t align)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_heap::alloc", [this, size, align]{
+    return handle->alloc(size, align);
+  });
+}
+
+size_t
+bo_heap::
+used() const
+{
+  return handle->used();
+}
+
+size_t
+bo_heap::
+largest_free() const
+{
+  return handle->largest_free();
+}
+
+size_t
+bo_heap::
+capacity() const
+{
+  return handle->capacity();
+}
+
+} // xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_striped C++ experimental API implmentations (xrt_bo_striped.h)
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+// class striped_bo_impl - Logical buffer interleaved across banks
+class striped_bo_impl
+{
+  size_t m_size;
+  size_t m_stripe_size;
+  std::vector<xrt::bo> m_banks;
+
+  // Call op(bank, bank_offset, logical_offset, bytes) for each stripe
+  // segment of the logical range [offset, offset + sz)
+  template <typename Operation>
+  void
+  for_each_segment(size_t sz, size_t offset, Operation&& op)
+  {
+    if (sz + offset > m_size)
+      throw xrt_core::error(-EINVAL, "Invalid offset and size of striped buffer access");
+
+    auto nbanks = m_banks.size();
+    for (auto end = offset + sz; offset < end; ) {
+      auto stripe = offset / m_stripe_size;
+      auto stripe_offset = offset % m_stripe_size;
+      auto bytes = std::min(m_stripe_size - stripe_offset, end - offset);
+      auto bank_offset = (stripe / nbanks) * m_stripe_size + stripe_offset;
+      op(m_banks[stripe % nbanks], bank_offset, offset, bytes);
+      offset += bytes;
+    }
+  }
+
+public:
+  striped_bo_impl(const xrt::device& device, size_t size, const std::vector<xrt::memory_group>& banks,
+                  size_t stripe_size)
+    : m_size(size)
+    , m_stripe_size(stripe_size)
+  {
+    if (!size || !stripe_size)
+      throw xrt_core::error(-EINVAL, "Striped buffer size and stripe size must be positive");
+    if (banks.empty())
+      throw xrt_core::error(-EINVAL, "Striped buffer requires at least one bank");
+
+    auto stripes = (size + stripe_size - 1) / stripe_size;
+    auto bank_stripes = (stripes + banks.size() - 1) / banks.size();
+    for (auto grp : banks)
+      m_banks.emplace_back(device, bank_stripes * stripe_size, xrt::bo::flags::normal, grp);
+  }
+
+  size_t
+  get_size() const
+  {
+    return m_size;
+  }
+
+  size_t
+  get_stripe_size() const
+  {
+    return m_stripe_size;
+  }
+
+  const std::vector<xrt::bo>&
+  get_banks() const
+  {
+    return m_banks;
+  }
+
+  void
+  write(const void* src, size_t sz, size_t seek)
+  {
+    auto data = static_cast<const char*>(src);
+    for_each_segment(sz, seek, [data, seek](xrt::bo& bo, size_t bank_offset, size_t offset, size_t bytes) {
+      bo.write(data + (offset - seek), bytes, bank_offset);
+    });
+  }
+
+  void
+  read(void* dst, size_t sz, size_t skip)
+  {
+    auto data = static_cast<char*>(dst);
+    for_each_segment(sz, skip, [data, skip](xrt::bo& bo, size_t bank_offset, size_t offset, size_t bytes) {
+      bo.read(data + (offset - skip), bytes, bank_offset);
+    });
+  }
+
+  void
+  sync(xclBOSyncDirection dir)
+  {
+    // fan out one sync per bank, wait for all before reporting error
+    std::vector<xrt::sync_event> events;
+    events.reserve(m_banks.size());
+    for (const auto& bo : m_banks)
+      events.push_back(xrt::async_sync(bo, dir));
+
+    std::exception_ptr eptr;
+    for (const auto& ev : events) {
+      try {
+        ev.get();
+      }
+      catch (...) {
+        if (!eptr)
+          eptr = std::current_exception();
+      }
+    }
+
+    if (eptr)
+      std::rethrow_exception(eptr);
+  }
+};
+
+striped_bo::
+striped_bo(const xrt::device& device, size_t size, const std::vector<xrt::memory_group>& banks,
+           size_t stripe_size)
+  : detail::pimpl<striped_bo_impl>(std::make_shared<striped_bo_impl>(device, size, banks, stripe_size))
+{}
+
+size_t
+striped_bo::
+size() const
+{
+  return handle->get_size();
+}
+
+size_t
+striped_bo::
+stripe_size() const
+{
+  return handle->get_stripe_size();
+}
+
+size_t
+striped_bo::
+num_banks() const
+{
+  return handle->get_banks().size();
+}
+
+xrt::bo
+striped_bo::
+get_bank_bo(size_t idx) const
+{
+  return handle->get_banks().at(idx);
+}
+
+void
+striped_bo::
+write(const void* src, size_t size, size_t seek)
+{
+  xdp::native::profiling_wrapper("xrt::striped_bo::write", [this, src, size, seek]{
+    handle->write(src, size, seek);
+  });
+}
+
+void
+striped_bo::
+read(void* dst, size_t size, size_t skip)
+{
+  xdp::native::profiling_wrapper("xrt::striped_bo::read", [this, dst, size, skip]{
+    handle->read(dst, size, skip);
+  });
+}
+
+void
+striped_bo::
+sync(xclBOSyncDirection dir)
+{
+  xdp::native::profiling_wrapper("xrt::striped_bo::sync", [this, dir]{
+    handle->sync(dir);
+  });
+}
+
+} // xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_dirty C++ experimental API implmentations (xrt_bo_dirty.h)
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+void
+mark_dirty(const xrt::bo& bo, size_t size, size_t offset)
+{
+  bo.get_handle()->mark_dirty(size, offset);
+}
+
+size_t
+sync_dirty(const xrt::bo& bo)
+{
+  return xdp::native::profiling_wrapper("xrt::sync_dirty", [&bo]{
+    return bo.get_handle()->sync_dirty();
+  });
+}
+
+void
+clear_dirty(const xrt::bo& bo)
+{
+  bo.get_handle()->clear_dirty();
+}
+
+} // xrt
+
 ////////////////////////////////////////////////////////////////
 // xrt_bo API implmentations (xrt_bo.h)
 ////////////////////////////////////////////////////////////////
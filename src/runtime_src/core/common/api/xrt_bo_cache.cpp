@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// This file implements XRT content cache APIs as declared in
+// core/include/experimental/xrt_bo_cache.h
+#define XCL_DRIVER_DLL_EXPORT  // exporting xrt_bo_cache.h
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+
+#include "core/include/experimental/xrt_bo_cache.h"
+
+#include "core/common/debug.h"
+
+#include "native_profile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#ifdef __linux__
+# include <cerrno>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace {
+
+// 128-bit hash of content, two 64-bit lanes consuming a word at a
+// time.  Not cryptographic, keys must be supplied by the caller if
+// the content is untrusted.
+static std::string
+content_hash(const void* data, size_t size)
+{
+  constexpr uint64_t m1 = 0x9e3779b97f4a7c15ULL;
+  constexpr uint64_t m2 = 0xc2b2ae3d27d4eb4fULL;
+  auto fmix = [](uint64_t h) {
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  };
+
+  uint64_t h1 = size ^ 0x243f6a8885a308d3ULL;
+  uint64_t h2 = size ^ 0x13198a2e03707344ULL;
+  auto bytes = static_cast<const unsigned char*>(data);
+  size_t words = size / sizeof(uint64_t);
+  for (size_t i = 0; i < words; ++i) {
+    uint64_t w;
+    std::memcpy(&w, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+    h1 = (h1 ^ w) * m1;
+    h1 ^= h1 >> 29;
+    h2 = (h2 + w) * m2;
+    h2 = (h2 << 31) | (h2 >> 33);
+  }
+
+  uint64_t tail = 0;
+  std::memcpy(&tail, bytes + words * sizeof(uint64_t), size % sizeof(uint64_t));
+  h1 = fmix((h1 ^ tail) * m1);
+  h2 = fmix((h2 + tail) * m2 ^ h1);
+
+  char buf[33];
+  std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+                static_cast<unsigned long long>(h1), static_cast<unsigned long long>(h2));
+  return buf;
+}
+
+#ifdef __linux__
+static std::string
+registry_dir(const xrt::device& device, const xrt::uuid& xclbin_id)
+{
+  std::string id;
+  try {
+    id = device.get_info<xrt::info::device::bdf>();
+  }
+  catch (const std::exception&) {
+    id = "edge";
+  }
+  for (auto& c : id)
+    if (c == ':' || c == '/')
+      c = '_';
+
+  std::string dir = "/dev/shm/xrt_bo_cache";
+  for (const auto& sub : {std::string{}, "/" + id, "/" + id + "/" + xclbin_id.to_string()}) {
+    auto path = dir + sub;
+    if (::mkdir(path.c_str(), 0777) && errno != EEXIST)
+      return {};
+  }
+  return dir + "/" + id + "/" + xclbin_id.to_string();
+}
+#endif
+
+} // namespace
+
+namespace xrt {
+
+// class bo_content_cache_impl - LRU cache of device resident content
+//
+// Entries are ordered most recently used first.  A shared cache
+// publishes each uploaded buffer as a registry file named by the hash
+// of the entry key, holding the pid and export handle of the owning
+// process.  Other processes import the buffer through pidfd.
+class bo_content_cache_impl
+{
+  struct entry
+  {
+    std::string key;
+    xrt::bo bo;
+    bool published;
+  };
+
+  xrt::device m_device;
+  std::string m_registry;      // empty if not shared
+  size_t m_capacity;
+
+  mutable std::mutex m_mutex;
+  std::list<entry> m_lru;
+  std::unordered_map<std::string, std::list<entry>::iterator> m_index;
+  bo_content_cache::stats m_stats {};
+
+  std::string
+  registry_file(const std::string& key) const
+  {
+    return m_registry + "/" + content_hash(key.data(), key.size());
+  }
+
+  bool
+  is_referenced(const entry& e) const
+  {
+    return e.bo.get_handle().use_count() > 1;
+  }
+
+  xrt::bo
+  import(const std::string& key, size_t size)
+  {
+#ifdef __linux__
+    if (m_registry.empty())
+      return {};
+
+    std::ifstream istr(registry_file(key));
+    pid_t pid = 0;
+    xclBufferExportHandle ehdl = 0;
+    size_t sz = 0;
+    if (!(istr >> pid >> ehdl >> sz) || pid == ::getpid() || sz != size)
+      return {};
+
+    try {
+      xrt::bo bo{static_cast<xclDeviceHandle>(m_device), xrt::pid_type{pid}, ehdl};
+      if (bo.size() == size)
+        return bo;
+    }
+    catch (const std::exception& ex) {
+      // Owner exited or is not accessible, content is uploaded and
+      // republished by this process
+      XRT_DEBUGF("bo_content_cache: import from pid %d failed: %s\n", pid, ex.what());
+    }
+#endif
+    return {};
+  }
+
+  bool
+  publish(const std::string& key, xrt::bo& bo)
+  {
+#ifdef __linux__
+    if (m_registry.empty())
+      return false;
+
+    try {
+      auto ehdl = bo.export_buffer();
+      auto path = registry_file(key);
+      auto tmp = path + "." + std::to_string(::getpid());
+      {
+        std::ofstream ostr(tmp);
+        ostr << ::getpid() << ' ' << ehdl << ' ' << bo.size() << '\n';
+        if (!ostr)
+          return false;
+      }
+      // Rename is atomic, readers see the old or the new owner
+      return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+    catch (const std::exception&) {
+    }
+#endif
+    return false;
+  }
+
+  void
+  unpublish(const entry& e)
+  {
+#ifdef __linux__
+    if (!e.published)
+      return;
+
+    // Remove registry file only if still owned by this process
+    auto path = registry_file(e.key);
+    std::ifstream istr(path);
+    pid_t pid = 0;
+    if ((istr >> pid) && pid == ::getpid())
+      ::unlink(path.c_str());
+#endif
+  }
+
+  void
+  evict(std::list<entry>::iterator itr)
+  {
+    unpublish(*itr);
+    m_stats.bytes -= itr->bo.size();
+    --m_stats.buffers;
+    ++m_stats.evictions;
+    m_index.erase(itr->key);
+    m_lru.erase(itr);
+  }
+
+  // Evict least recently used unreferenced buffers until the cache
+  // holds at most limit bytes.  Returns number of evicted buffers.
+  size_t
+  evict_until(size_t limit)
+  {
+    size_t count = 0;
+    auto itr = m_lru.end();
+    while (itr != m_lru.begin() && m_stats.bytes > limit) {
+      auto victim = std::prev(itr);
+      if (is_referenced(*victim)) {
+        itr = victim;
+        continue;
+      }
+      evict(victim);
+      ++count;
+    }
+    return count;
+  }
+
+  xrt::bo
+  upload(const void* data, size_t size, xrt::memory_group grp)
+  {
+    xrt::bo bo;
+    try {
+      bo = xrt::bo{m_device, size, xrt::bo::flags::normal, grp};
+    }
+    catch (const std::exception&) {
+      // Memory pressure, release unreferenced buffers and retry
+      if (!evict_until(0))
+        throw;
+      bo = xrt::bo{m_device, size, xrt::bo::flags::normal, grp};
+    }
+    bo.write(data);
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    return bo;
+  }
+
+public:
+  bo_content_cache_impl(const xrt::device& device, const xrt::uuid& xclbin_id, size_t capacity, bool shared)
+    : m_device(device)
+    , m_capacity(capacity)
+  {
+#ifdef __linux__
+    if (shared)
+      m_registry = registry_dir(device, xclbin_id);
+#endif
+  }
+
+  ~bo_content_cache_impl()
+  {
+    for (const auto& e : m_lru)
+      unpublish(e);
+  }
+
+  bo_content_cache_impl(const bo_content_cache_impl&) = delete;
+  bo_content_cache_impl& operator=(const bo_content_cache_impl&) = delete;
+
+  xrt::bo
+  get(const std::string& key, const void* data, size_t size, xrt::memory_group grp)
+  {
+    auto ekey = key + "@" + std::to_string(grp);
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    ++m_stats.lookups;
+    auto itr = m_index.find(ekey);
+    if (itr != m_index.end()) {
+      ++m_stats.hits;
+      m_lru.splice(m_lru.begin(), m_lru, itr->second);
+      return itr->second->bo;
+    }
+
+    bool published = false;
+    auto bo = import(ekey, size);
+    if (bo) {
+      ++m_stats.imports;
+    }
+    else {
+      ++m_stats.misses;
+      bo = upload(data, size, grp);
+      published = publish(ekey, bo);
+    }
+
+    m_lru.push_front({ekey, bo, published});
+    m_index.emplace(std::move(ekey), m_lru.begin());
+    ++m_stats.buffers;
+    m_stats.bytes += size;
+
+    if (m_capacity)
+      evict_until(m_capacity);
+
+    return bo;
+  }
+
+  xrt::bo
+  get(const void* data, size_t size, xrt::memory_group grp)
+  {
+    return get("#" + content_hash(data, size) + ":" + std::to_string(size), data, size, grp);
+  }
+
+  void
+  set_capacity(size_t bytes)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_capacity = bytes;
+    if (m_capacity)
+      evict_until(m_capacity);
+  }
+
+  void
+  clear()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    evict_until(0);
+  }
+
+  bo_content_cache::stats
+  get_stats() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_stats;
+  }
+};
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_cache C++ experimental API implmentations
+// (xrt_bo_cache.h)
+////////////////////////////////////////////////////////////////
+bo_content_cache::
+bo_content_cache(const xrt::device& device, const xrt::uuid& xclbin_id, size_t capacity, bool shared)
+  : detail::pimpl<bo_content_cache_impl>(std::make_shared<bo_content_cache_impl>(device, xclbin_id, capacity, shared))
+{}
+
+xrt::bo
+bo_content_cache::
+get(const void* data, size_t size, xrt::memory_group grp)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_content_cache::get", [this, data, size, grp]{
+    return handle->get(data, size, grp);
+  });
+}
+
+xrt::bo
+bo_content_cache::
+get(const std::string& key, const void* data, size_t size, xrt::memory_group grp)
+{
+  return xdp::native::profiling_wrapper("xrt::bo_content_cache::get", [this, &key, data, size, grp]{
+    return handle->get(key, data, size, grp);
+  });
+}
+
+void
+bo_content_cache::
+set_capacity(size_t bytes)
+{
+  handle->set_capacity(bytes);
+}
+
+void
+bo_content_cache::
+clear()
+{
+  xdp::native::profiling_wrapper("xrt::bo_content_cache::clear", [this]{
+    handle->clear();
+  });
+}
+
+bo_content_cache::stats
+bo_content_cache::
+get_stats() const
+{
+  return handle->get_stats();
+}
+
+} // xrt
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// This file implements XRT file transfer APIs as declared in
+// core/include/experimental/xrt_bo_file.h
+#define XCL_DRIVER_DLL_EXPORT  // exporting xrt_bo_file.h
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+
+#include "core/include/experimental/xrt_bo_file.h"
+
+#include "core/common/error.h"
+
+#include "native_profile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+# include <cerrno>
+# include <fcntl.h>
+# include <linux/aio_abi.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+namespace {
+
+// Size of a P2P BAR remap window, XOCL_P2P_CHUNK_SIZE in the driver.
+// I/O requests are split so that none straddles two windows.
+constexpr size_t p2p_window = 256 * 1024 * 1024;
+
+// Alignment required for direct I/O
+constexpr size_t direct_align = 4096;
+
+#ifdef __linux__
+
+class file_descriptor
+{
+  int m_fd = -1;
+public:
+  file_descriptor(const std::string& path, int flags)
+    : m_fd(::open(path.c_str(), flags | O_CLOEXEC, 0644))
+  {}
+
+  ~file_descriptor()
+  {
+    if (m_fd >= 0)
+      ::close(m_fd);
+  }
+
+  file_descriptor(const file_descriptor&) = delete;
+  file_descriptor& operator=(const file_descriptor&) = delete;
+
+  int
+  get() const
+  {
+    return m_fd;
+  }
+};
+
+// Linux native asynchronous I/O through raw system calls, no libaio
+// dependency.  With O_DIRECT the requests are queued to the block
+// device without blocking the submitting thread.
+class aio_context
+{
+  aio_context_t m_ctx = 0;
+
+public:
+  explicit
+  aio_context(unsigned int depth)
+  {
+    if (::syscall(SYS_io_setup, depth, &m_ctx))
+      m_ctx = 0;
+  }
+
+  ~aio_context()
+  {
+    if (m_ctx)
+      ::syscall(SYS_io_destroy, m_ctx);
+  }
+
+  aio_context(const aio_context&) = delete;
+  aio_context& operator=(const aio_context&) = delete;
+
+  explicit
+  operator bool() const
+  {
+    return m_ctx != 0;
+  }
+
+  bool
+  submit(iocb* cb)
+  {
+    return ::syscall(SYS_io_submit, m_ctx, 1, &cb) == 1;
+  }
+
+  long
+  reap(long nr, io_event* events)
+  {
+    long ret;
+    while ((ret = ::syscall(SYS_io_getevents, m_ctx, 1, nr, events, nullptr)) < 0 && errno == EINTR);
+    return ret;
+  }
+};
+
+// Bytes of the request at offset, limited to end of P2P window
+static size_t
+request_length(size_t offset, size_t remaining, size_t request_size)
+{
+  auto len = std::min(remaining, request_size);
+  return std::min(len, p2p_window - offset % p2p_window);
+}
+
+// Synchronous fallback, one request at a time
+static void
+transfer_sync(int fd, bool read, char* buf, size_t size, uint64_t file_offset,
+              size_t bo_offset, const xrt::file_io_options& options, xrt::file_io_stats& stats)
+{
+  size_t done = 0;
+  while (done < size) {
+    auto len = request_length(bo_offset + done, size - done, options.request_size);
+    auto off = static_cast<off_t>(file_offset + done);
+    auto ret = read
+      ? ::pread(fd, buf + done, len, off)
+      : ::pwrite(fd, buf + done, len, off);
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret < 0)
+      throw xrt_core::system_error(errno, read ? "file read failed" : "file write failed");
+    ++stats.requests;
+    if (ret == 0)
+      break;  // EOF
+    done += ret;
+    stats.bytes += ret;
+  }
+}
+
+// Keep up to queue_depth requests in flight.  Returns false if native
+// AIO is not available.
+static bool
+transfer_async(int fd, bool read, char* buf, size_t size, uint64_t file_offset,
+               size_t bo_offset, const xrt::file_io_options& options, xrt::file_io_stats& stats)
+{
+  auto depth = std::max(options.queue_depth, 1u);
+  aio_context ctx(depth);
+  if (!ctx)
+    return false;
+
+  std::vector<iocb> cbs(depth);
+  std::vector<unsigned int> free_slots;
+  for (unsigned int slot = depth; slot; --slot)
+    free_slots.push_back(slot - 1);
+  std::vector<io_event> events(depth);
+
+  size_t next = 0;
+  bool eof = false;
+  int error = 0;
+  while ((next < size && !eof && !error) || free_slots.size() < depth) {
+    while (next < size && !eof && !error && !free_slots.empty()) {
+      auto slot = free_slots.back();
+      auto len = request_length(bo_offset + next, size - next, options.request_size);
+      auto& cb = cbs[slot];
+      std::memset(&cb, 0, sizeof(cb));
+      cb.aio_data = slot;
+      cb.aio_fildes = fd;
+      cb.aio_lio_opcode = read ? IOCB_CMD_PREAD : IOCB_CMD_PWRITE;
+      cb.aio_buf = reinterpret_cast<uint64_t>(buf + next);
+      cb.aio_nbytes = len;
+      cb.aio_offset = static_cast<int64_t>(file_offset + next);
+      if (!ctx.submit(&cb)) {
+        if (errno == EAGAIN && free_slots.size() < depth)
+          break;  // reap before submitting more
+        error = errno;
+        break;
+      }
+      free_slots.pop_back();
+      next += len;
+      ++stats.requests;
+    }
+
+    if (free_slots.size() == depth)
+      break;
+
+    auto nr = ctx.reap(depth - free_slots.size(), events.data());
+    if (nr < 0)
+      throw xrt_core::system_error(errno, "io_getevents failed");
+
+    for (long i = 0; i < nr; ++i) {
+      auto slot = static_cast<unsigned int>(events[i].data);
+      auto res = events[i].res;
+      free_slots.push_back(slot);
+      if (res < 0) {
+        error = static_cast<int>(-res);
+        continue;
+      }
+      stats.bytes += res;
+      if (static_cast<uint64_t>(res) < cbs[slot].aio_nbytes) {
+        if (!read)
+          error = EIO;
+        eof = true;
+      }
+    }
+  }
+
+  if (error)
+    throw xrt_core::system_error(error, read ? "file read failed" : "file write failed");
+  return true;
+}
+
+static xrt::file_io_stats
+transfer(xrt::bo bo, const std::string& path, bool read, size_t size,
+         uint64_t file_offset, size_t bo_offset, const xrt::file_io_options& options)
+{
+  if (bo_offset + size > bo.size())
+    throw xrt_core::system_error(EINVAL, "file transfer exceeds buffer size");
+
+  auto start = std::chrono::steady_clock::now();
+  xrt::file_io_stats stats;
+
+  bool p2p = bo.get_flags() == xrt::bo::flags::p2p;
+  if (!read && !p2p)
+    bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE, size, bo_offset);
+
+  auto buf = bo.map<char*>() + bo_offset;
+  int flags = read ? O_RDONLY : (O_WRONLY | O_CREAT);
+  file_descriptor buffered(path, flags);
+  if (buffered.get() < 0)
+    throw xrt_core::system_error(errno, "failed to open '" + path + "'");
+
+  // Direct I/O of the aligned body, the tail is transferred buffered
+  size_t body = 0;
+  if (options.direct && file_offset % direct_align == 0
+      && reinterpret_cast<uintptr_t>(buf) % direct_align == 0)
+    body = size - size % direct_align;
+
+  size_t done = 0;
+  if (body) {
+    file_descriptor direct(path, flags | O_DIRECT);
+    if (direct.get() >= 0) {
+      stats.direct = true;
+      if (!transfer_async(direct.get(), read, buf, body, file_offset, bo_offset, options, stats))
+        transfer_sync(direct.get(), read, buf, body, file_offset, bo_offset, options, stats);
+      done = stats.bytes;
+    }
+  }
+
+  // Remaining bytes, unless a read already hit EOF
+  if (done < size && (done == body || !stats.direct))
+    transfer_sync(buffered.get(), read, buf + done, size - done, file_offset + done,
+                  bo_offset + done, options, stats);
+
+  if (read && !p2p && stats.bytes)
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, stats.bytes, bo_offset);
+
+  stats.duration = std::chrono::steady_clock::now() - start;
+  return stats;
+}
+
+#else
+
+static xrt::file_io_stats
+transfer(xrt::bo, const std::string&, bool, size_t, uint64_t, size_t, const xrt::file_io_options&)
+{
+  throw xrt_core::system_error(ENOSYS, "file transfer to buffer objects not supported on this platform");
+}
+
+#endif
+
+} // namespace
+
+namespace xrt {
+
+////////////////////////////////////////////////////////////////
+// xrt_bo_file C++ experimental API implmentations
+// (xrt_bo_file.h)
+////////////////////////////////////////////////////////////////
+file_io_stats
+read_file(const xrt::bo& bo, const std::string& path, size_t size,
+          uint64_t file_offset, size_t bo_offset, const file_io_options& options)
+{
+  return xdp::native::profiling_wrapper("xrt::read_file", [&]{
+    return transfer(bo, path, true, size, file_offset, bo_offset, options);
+  });
+}
+
+file_io_stats
+write_file(const xrt::bo& bo, const std::string& path, size_t size,
+           uint64_t file_offset, size_t bo_offset, const file_io_options& options)
+{
+  return xdp::native::profiling_wrapper("xrt::write_file", [&]{
+    return transfer(bo, path, false, size, file_offset, bo_offset, options);
+  });
+}
+
+} // xrt
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// This file implements XRT command graph APIs as declared in
+// core/include/experimental/xrt_command_graph.h
+#define XCL_DRIVER_DLL_EXPORT  // exporting xrt_command_graph.h
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+#include "core/include/experimental/xrt_command_graph.h"
+#include "core/include/experimental/xrt_coro.h"
+
+#include "kernel_int.h"
+#include "native_profile.h"
+
+#include "core/common/debug.h"
+#include "core/common/error.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace xrt {
+
+// class command_graph_impl - recorded DAG of operations
+//
+// Nodes are stored in recording order which is a topological order
+// since a node can depend only on previously recorded nodes.  The
+// successors and the dependency count of each node are computed
+// while recording, so replay is a matter of resetting the pending
+// dependency counts and starting the root nodes.
+//
+// A run node is started with a one-shot completion notification
+// which is called from XRT's command completion path.  The
+// notification counts down the pending dependencies of the node's
+// successors, and starts successors that are ready.  Sync and copy
+// nodes execute synchronously in the thread that made them ready.
+class command_graph_impl : public std::enable_shared_from_this<command_graph_impl>
+{
+  using node = command_graph::node;
+
+  struct node_type
+  {
+    std::function<void()> op;         // sync or copy operation
+    xrt::run run;                     // run operation
+    std::vector<node> successors;     // nodes depending on this node
+    unsigned int num_deps = 0;        // number of nodes this node depends on
+  };
+
+  xrt_core::device* m_core_device;
+  std::vector<node_type> m_nodes;
+  std::vector<node> m_roots;
+
+  // Replay state
+  std::unique_ptr<std::atomic<unsigned int>[]> m_pending; // pending deps per node
+  std::unique_ptr<std::atomic<bool>[]> m_skip;            // skip node per failed dep
+  std::atomic<size_t> m_remaining {0};                    // nodes not yet done
+  mutable std::mutex m_mutex;
+  mutable std::condition_variable m_done;
+  std::exception_ptr m_error;
+  bool m_recorded = false;
+
+  node
+  add_node(node_type&& nd, const std::vector<node>& deps)
+  {
+    if (m_recorded)
+      throw xrt_core::error(EPERM, "Cannot add node to replayed command graph");
+
+    auto id = static_cast<node>(m_nodes.size());
+    for (auto dep : deps) {
+      if (dep >= id)
+        throw xrt_core::error(EINVAL, "Command graph node depends on unknown node");
+      m_nodes[dep].successors.push_back(id);
+    }
+
+    nd.num_deps = static_cast<unsigned int>(deps.size());
+    if (deps.empty())
+      m_roots.push_back(id);
+    m_nodes.push_back(std::move(nd));
+    return id;
+  }
+
+  void
+  set_error(std::exception_ptr eptr)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_error)
+      m_error = std::move(eptr);
+  }
+
+  // Node id is done, possibly failed.  Start successors that become
+  // ready.  Successors of failed nodes are skipped, but still counted
+  // as done to keep the graph accounting intact.
+  void
+  done(node id, bool failed)
+  {
+    for (auto succ : m_nodes[id].successors) {
+      if (failed)
+        m_skip[succ] = true;
+      if (--m_pending[succ] == 0)
+        start(succ);
+    }
+
+    if (--m_remaining == 0) {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_done.notify_all();
+    }
+  }
+
+  void
+  start(node id)
+  {
+    auto& nd = m_nodes[id];
+    if (m_skip[id]) {
+      done(id, true);
+      return;
+    }
+
+    if (nd.run) {
+      // Keep graph alive while commands are in flight
+      auto self = shared_from_this();
+      try {
+        xrt::coro::detail::start(nd.run, [self, id](ert_cmd_state state) {
+          bool failed = (state != ERT_CMD_STATE_COMPLETED);
+          if (failed)
+            self->set_error(std::make_exception_ptr
+                            (xrt_core::error(EIO, "Command graph run node failed with state "
+                                             + std::to_string(state))));
+          self->done(id, failed);
+        });
+      }
+      catch (...) {
+        set_error(std::current_exception());
+        done(id, true);
+      }
+      return;
+    }
+
+    bool failed = false;
+    try {
+      nd.op();
+    }
+    catch (...) {
+      set_error(std::current_exception());
+      failed = true;
+    }
+    done(id, failed);
+  }
+
+public:
+  explicit
+  command_graph_impl(const xrt::device& device)
+    : m_core_device(device.get_handle().get())
+  {}
+
+  node
+  add_run(const xrt::run& run, const std::vector<node>& deps)
+  {
+    if (xrt_core::kernel_int::get_core_device(run) != m_core_device)
+      throw xrt_core::error(EINVAL, "Run object is not for command graph device");
+
+    auto itr = std::find_if(m_nodes.begin(), m_nodes.end(),
+                            [&run](const auto& nd) { return nd.run && nd.run.get_handle() == run.get_handle(); });
+    if (itr != m_nodes.end())
+      throw xrt_core::error(EINVAL, "Run object is already recorded in command graph");
+
+    node_type nd;
+    nd.run = run;
+    return add_node(std::move(nd), deps);
+  }
+
+  node
+  add_op(std::function<void()>&& op, const std::vector<node>& deps)
+  {
+    node_type nd;
+    nd.op = std::move(op);
+    return add_node(std::move(nd), deps);
+  }
+
+  void
+  replay()
+  {
+    if (m_remaining)
+      throw xrt_core::error(EBUSY, "Command graph is executing");
+
+    if (m_nodes.empty())
+      return;
+
+    if (!m_recorded) {
+      m_pending = std::make_unique<std::atomic<unsigned int>[]>(m_nodes.size());
+      m_skip = std::make_unique<std::atomic<bool>[]>(m_nodes.size());
+      m_recorded = true;
+    }
+
+    for (size_t idx = 0; idx < m_nodes.size(); ++idx) {
+      m_pending[idx] = m_nodes[idx].num_deps;
+      m_skip[idx] = false;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_error = nullptr;
+    }
+
+    m_remaining = m_nodes.size();
+    for (auto root : m_roots)
+      start(root);
+  }
+
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout_ms) const
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (timeout_ms.count()) {
+      if (!m_done.wait_for(lk, timeout_ms, [this] { return m_remaining == 0; }))
+        return std::cv_status::timeout;
+    }
+    else {
+      m_done.wait(lk, [this] { return m_remaining == 0; });
+    }
+
+    if (m_error)
+      std::rethrow_exception(m_error);
+
+    return std::cv_status::no_timeout;
+  }
+
+  size_t
+  size() const
+  {
+    return m_nodes.size();
+  }
+};
+
+} // xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_command_graph C++ experimental API implmentations
+// see experimental/xrt_command_graph.h
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+command_graph::
+command_graph(const xrt::device& device)
+  : detail::pimpl<command_graph_impl>(std::make_shared<command_graph_impl>(device))
+{}
+
+command_graph::node
+command_graph::
+add_run(const xrt::run& run, const std::vector<node>& deps)
+{
+  return handle->add_run(run, deps);
+}
+
+command_graph::node
+command_graph::
+add_sync(const xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t offset,
+         const std::vector<node>& deps)
+{
+  return handle->add_op([sbo = bo, dir, size, offset]() mutable { sbo.sync(dir, size, offset); }, deps);
+}
+
+command_graph::node
+command_graph::
+add_copy(const xrt::bo& dst, const xrt::bo& src, size_t size,
+         size_t dst_offset, size_t src_offset, const std::vector<node>& deps)
+{
+  return handle->add_op([dbo = dst, src, size, dst_offset, src_offset]() mutable {
+      dbo.copy(src, size, src_offset, dst_offset);
+    }, deps);
+}
+
+void
+command_graph::
+replay()
+{
+  xdp::native::profiling_wrapper("xrt::command_graph::replay", [this]{
+    handle->replay();
+  });
+}
+
+std::cv_status
+command_graph::
+wait(const std::chrono::milliseconds& timeout_ms) const
+{
+  return xdp::native::profiling_wrapper("xrt::command_graph::wait", [this, &timeout_ms]{
+    return handle->wait(timeout_ms);
+  });
+}
+
+size_t
+command_graph::
+size() const
+{
+  return handle->size();
+}
+
+} // xrt
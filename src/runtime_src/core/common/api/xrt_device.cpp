@@ -22,6 +22,7 @@
 
 #include "core/include/xrt/xrt_device.h"
 #include "core/include/xrt/xrt_aie.h"
+#include "core/include/experimental/xrt_device_async.h"
 
 #include "core/common/system.h"
 #include "core/common/device.h"
@@ -32,6 +33,7 @@
 #include "core/common/info_platform.h"
 #include "core/common/query_requests.h"
 
+#include "enqueue.h"
 #include "handle.h"
 #include "native_profile.h"
 #include "xclbin_int.h" // Non public xclbin APIs
@@ -40,7 +42,10 @@
 
 #include <map>
 #include <vector>
+#include <exception>
 #include <fstream>
+#include <future>
+#include <thread>
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 )
@@ -344,6 +349,91 @@ get_info_std(info::device param, const xrt::detail::abi& abi) const
 
 } // xrt
 
+////////////////////////////////////////////////////////////////
+// xrt_device_async C++ experimental API implmentations (xrt_device_async.h)
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+load_event
+load_xclbin_async(const xrt::device& device, const xrt::xclbin& xclbin, load_progress_callback progress)
+{
+  return xdp::native::profiling_wrapper("xrt::load_xclbin_async", [&device, &xclbin, &progress]{
+    auto core_device = device.get_handle();
+    auto promise = std::make_shared<std::promise<xrt::uuid>>();
+    std::shared_future<xrt::uuid> result = promise->get_future();
+
+    // Kernel construction and buffer allocation wait for the load
+    // through the core device, errors are reported by the event only.
+    auto done = std::make_shared<std::promise<void>>();
+    core_device->set_pending_load(done->get_future().share());
+
+    auto notify = [progress = std::move(progress)] (load_stage stage) {
+      try {
+        if (progress)
+          progress(stage);
+      }
+      catch (...) {
+      }
+    };
+
+    // Loading takes seconds so it is not executed by a worker pool
+    // shared with short operations such as syncs
+    auto ev = xrt_core::enqueue::create_event();
+    std::thread([core_device, xclbin, promise, done, evp = ev.get_impl(), notify] {
+      notify(load_stage::started);
+      std::exception_ptr eptr;
+      try {
+        notify(load_stage::downloading);
+        core_device->load_xclbin(xclbin);
+        notify(load_stage::registered);
+      }
+      catch (...) {
+        eptr = std::current_exception();
+      }
+
+      core_device->set_pending_load({});
+      done->set_value();
+      if (eptr) {
+        notify(load_stage::failed);
+        promise->set_exception(eptr);
+      }
+      else {
+        notify(load_stage::completed);
+        promise->set_value(xclbin.get_uuid());
+      }
+      xrt_core::enqueue::done(evp.get());
+    }).detach();
+
+    return load_event{std::move(ev), std::move(result)};
+  });
+}
+
+void
+stage_xclbin(const xrt::device& device, const xrt::xclbin& xclbin)
+{
+  xdp::native::profiling_wrapper("xrt::stage_xclbin", [&device, &xclbin]{
+    device.get_handle()->stage_xclbin(xclbin);
+  });
+}
+
+void
+unstage_xclbin(const xrt::device& device, const xrt::uuid& xclbin_id)
+{
+  xdp::native::profiling_wrapper("xrt::unstage_xclbin", [&device, &xclbin_id]{
+    device.get_handle()->unstage_xclbin(xclbin_id);
+  });
+}
+
+void
+switch_xclbin(const xrt::device& device, const xrt::uuid& xclbin_id)
+{
+  xdp::native::profiling_wrapper("xrt::switch_xclbin", [&device, &xclbin_id]{
+    device.get_handle()->switch_xclbin(xclbin_id);
+  });
+}
+
+} // xrt
+
 #ifdef XRT_ENABLE_AIE
 ////////////////////////////////////////////////////////////////
 // xrt_aie_device C++ API implmentations (xrt_aie.h)
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// This file implements XRT device clock APIs as declared in
+// core/include/experimental/xrt_device_clock.h
+#define XCL_DRIVER_DLL_EXPORT  // exporting xrt_device_clock.h
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+
+#include "core/include/experimental/xrt_device_clock.h"
+
+#include "core/common/clock_correlation.h"
+#include "core/common/device.h"
+
+#include <cmath>
+
+namespace {
+
+static std::shared_ptr<xrt_core::clock_correlation>
+get_clock(const xrt::device& device)
+{
+  return xrt_core::clock_correlation::get(device.get_handle()->get_device_id());
+}
+
+} // namespace
+
+namespace xrt { namespace device_clock {
+
+std::chrono::steady_clock::time_point
+device_to_host(const xrt::device& device, uint64_t ticks)
+{
+  auto host_ns = get_clock(device)->device_to_host_ns(ticks);
+  auto steady_ns = static_cast<int64_t>(std::llround(host_ns)) + xrt_core::clock_correlation::steady_offset_ns();
+  return std::chrono::steady_clock::time_point
+    (std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(steady_ns)));
+}
+
+void
+add_sample(const xrt::device& device, uint64_t ticks, std::chrono::steady_clock::time_point host)
+{
+  auto steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(host.time_since_epoch()).count();
+  auto host_ns = static_cast<int64_t>(steady_ns) - xrt_core::clock_correlation::steady_offset_ns();
+  get_clock(device)->add_sample(ticks, static_cast<uint64_t>(host_ns));
+}
+
+void
+set_nominal_rate(const xrt::device& device, double mhz)
+{
+  get_clock(device)->set_nominal_rate(mhz);
+}
+
+bool
+is_trained(const xrt::device& device)
+{
+  return get_clock(device)->is_trained();
+}
+
+}} // device_clock, xrt
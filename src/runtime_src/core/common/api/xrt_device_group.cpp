@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// This file implements XRT device group APIs as declared in
+// core/include/experimental/xrt_device_group.h
+#define XCL_DRIVER_DLL_EXPORT  // exporting xrt_device_group.h
+#define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+
+#include "core/include/experimental/xrt_device_group.h"
+#include "core/include/experimental/xrt_bo_async.h"
+#include "core/include/experimental/xrt_device_async.h"
+
+#include "core/common/error.h"
+
+#include "native_profile.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace xrt {
+
+class device_group_impl
+{
+public:
+  std::vector<xrt::device> m_devices;
+
+  explicit
+  device_group_impl(std::vector<xrt::device>&& devices)
+    : m_devices(std::move(devices))
+  {
+    if (m_devices.empty())
+      throw xrt_core::error(EINVAL, "Device group must have at least one device");
+  }
+
+  const xrt::device&
+  get_device(size_t idx) const
+  {
+    if (idx >= m_devices.size())
+      throw xrt_core::error(EINVAL, "Invalid device index in group: " + std::to_string(idx));
+    return m_devices[idx];
+  }
+
+  xrt::uuid
+  load_xclbin(const xrt::xclbin& xclbin)
+  {
+    std::vector<xrt::load_event> loads;
+    loads.reserve(m_devices.size());
+    for (const auto& device : m_devices)
+      loads.push_back(xrt::load_xclbin_async(device, xclbin));
+
+    // Wait for all loads before reporting the first error
+    std::exception_ptr eptr;
+    xrt::uuid uuid;
+    for (auto& load : loads) {
+      try {
+        uuid = load.get();
+      }
+      catch (...) {
+        if (!eptr)
+          eptr = std::current_exception();
+      }
+    }
+
+    if (eptr)
+      std::rethrow_exception(eptr);
+
+    return uuid;
+  }
+};
+
+class group_kernel_impl
+{
+  std::shared_ptr<device_group_impl> m_group;
+  std::vector<xrt::kernel> m_kernels;
+
+  // Runs started per device, pruned of completed runs when a device
+  // is selected.  The number of runs left is the load of the device.
+  std::mutex m_mutex;
+  std::vector<std::vector<xrt::run>> m_inflight;
+
+  static bool
+  is_done(const xrt::run& run)
+  {
+    auto state = run.state();
+    return state >= ERT_CMD_STATE_COMPLETED && state != ERT_CMD_STATE_SUBMITTED;
+  }
+
+public:
+  group_kernel_impl(std::shared_ptr<device_group_impl> group, const xrt::uuid& xclbin_id,
+                    const std::string& name, xrt::kernel::cu_access_mode mode)
+    : m_group(std::move(group))
+    , m_inflight(m_group->m_devices.size())
+  {
+    m_kernels.reserve(m_group->m_devices.size());
+    for (const auto& device : m_group->m_devices)
+      m_kernels.emplace_back(device, xclbin_id, name, mode);
+  }
+
+  const device_group_impl*
+  get_group() const
+  {
+    return m_group.get();
+  }
+
+  const xrt::kernel&
+  get_kernel(size_t idx) const
+  {
+    if (idx >= m_kernels.size())
+      throw xrt_core::error(EINVAL, "Invalid device index in group: " + std::to_string(idx));
+    return m_kernels[idx];
+  }
+
+  size_t
+  select_device()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    size_t selected = 0;
+    size_t min_load = std::numeric_limits<size_t>::max();
+    for (size_t idx = 0; idx < m_inflight.size(); ++idx) {
+      auto& runs = m_inflight[idx];
+      runs.erase(std::remove_if(runs.begin(), runs.end(), is_done), runs.end());
+      if (runs.size() < min_load) {
+        min_load = runs.size();
+        selected = idx;
+      }
+    }
+    return selected;
+  }
+
+  void
+  add_run(size_t idx, const xrt::run& run)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_inflight.at(idx).push_back(run);
+  }
+};
+
+class group_bo_impl
+{
+  std::vector<xrt::bo> m_bos;
+
+public:
+  group_bo_impl(const device_group_impl* group, size_t size, xrt::bo::flags flags, xrt::memory_group grp)
+  {
+    m_bos.reserve(group->m_devices.size());
+    for (const auto& device : group->m_devices)
+      m_bos.emplace_back(device, size, flags, grp);
+  }
+
+  size_t
+  size() const
+  {
+    return m_bos.front().size();
+  }
+
+  const xrt::bo&
+  get_bo(size_t idx) const
+  {
+    if (idx >= m_bos.size())
+      throw xrt_core::error(EINVAL, "Invalid device index in group: " + std::to_string(idx));
+    return m_bos[idx];
+  }
+
+  void
+  write(const void* src, size_t size, size_t seek)
+  {
+    for (auto& bo : m_bos)
+      bo.write(src, size, seek);
+  }
+
+  // Each replica is synced by its own DMA engine, so the syncs are
+  // submitted together and waited for after
+  void
+  sync(xclBOSyncDirection dir, size_t size, size_t offset)
+  {
+    std::vector<xrt::sync_event> syncs;
+    syncs.reserve(m_bos.size());
+    for (auto& bo : m_bos)
+      syncs.push_back(xrt::async_sync(bo, dir, size, offset));
+
+    std::exception_ptr eptr;
+    for (auto& sync : syncs) {
+      try {
+        sync.get();
+      }
+      catch (...) {
+        if (!eptr)
+          eptr = std::current_exception();
+      }
+    }
+
+    if (eptr)
+      std::rethrow_exception(eptr);
+  }
+};
+
+////////////////////////////////////////////////////////////////
+// xrt_device_group C++ experimental API implmentations
+// (xrt_device_group.h)
+////////////////////////////////////////////////////////////////
+static std::vector<xrt::device>
+open_devices(const std::vector<unsigned int>& indices)
+{
+  std::vector<xrt::device> devices;
+  devices.reserve(indices.size());
+  for (auto idx : indices)
+    devices.emplace_back(idx);
+  return devices;
+}
+
+device_group::
+device_group(const std::vector<unsigned int>& indices)
+  : handle(std::make_shared<device_group_impl>(open_devices(indices)))
+{}
+
+device_group::
+device_group(std::vector<xrt::device> devices)
+  : handle(std::make_shared<device_group_impl>(std::move(devices)))
+{}
+
+xrt::uuid
+device_group::
+load_xclbin(const xrt::xclbin& xclbin)
+{
+  return xdp::native::profiling_wrapper("xrt::device_group::load_xclbin", [this, &xclbin]{
+    return handle->load_xclbin(xclbin);
+  });
+}
+
+size_t
+device_group::
+size() const
+{
+  return handle->m_devices.size();
+}
+
+xrt::device
+device_group::
+get_device(size_t index) const
+{
+  return handle->get_device(index);
+}
+
+group_kernel::
+group_kernel(const device_group& group, const xrt::uuid& xclbin_id, const std::string& name,
+             xrt::kernel::cu_access_mode mode)
+  : handle(xdp::native::profiling_wrapper("xrt::group_kernel::group_kernel", [&group, &xclbin_id, &name, mode]{
+      return std::make_shared<group_kernel_impl>(group.get_handle(), xclbin_id, name, mode);
+    }))
+{}
+
+xrt::bo
+group_kernel::
+replica(const group_bo& arg, size_t device_index)
+{
+  return arg.get_bo(device_index);
+}
+
+xrt::kernel
+group_kernel::
+get_kernel(size_t device_index) const
+{
+  return handle->get_kernel(device_index);
+}
+
+int
+group_kernel::
+group_id(int argno) const
+{
+  return handle->get_kernel(0).group_id(argno);
+}
+
+size_t
+group_kernel::
+select_device() const
+{
+  return handle->select_device();
+}
+
+void
+group_kernel::
+add_run(size_t device_index, const xrt::run& run)
+{
+  handle->add_run(device_index, run);
+}
+
+group_bo::
+group_bo(const device_group& group, size_t size, xrt::bo::flags flags, xrt::memory_group grp)
+  : handle(std::make_shared<group_bo_impl>(group.get_handle().get(), size, flags, grp))
+{}
+
+group_bo::
+group_bo(const group_kernel& kernel, int argno, size_t size, xrt::bo::flags flags)
+  : handle(std::make_shared<group_bo_impl>(kernel.get_handle()->get_group(), size, flags, kernel.group_id(argno)))
+{}
+
+size_t
+group_bo::
+size() const
+{
+  return handle->size();
+}
+
+xrt::bo
+group_bo::
+get_bo(size_t device_index) const
+{
+  return handle->get_bo(device_index);
+}
+
+void
+group_bo::
+write(const void* src, size_t size, size_t seek)
+{
+  handle->write(src, size, seek);
+}
+
+void
+group_bo::
+sync(xclBOSyncDirection dir, size_t size, size_t offset)
+{
+  xdp::native::profiling_wrapper("xrt::group_bo::sync", [this, dir, size, offset]{
+    handle->sync(dir, size, offset);
+  });
+}
+
+} // xrt
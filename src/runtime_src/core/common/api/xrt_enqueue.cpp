@@ -21,6 +21,8 @@
 #include "core/include/experimental/xrt_enqueue.h"
 
 #include "core/common/debug.h"
+#include "core/common/task.h"
+#include "core/common/thread.h"
 
 #include <memory>
 #include <vector>
@@ -29,6 +31,7 @@
 #include <set>
 #include <functional>
 #include <algorithm>
+#include <atomic>
 #include <thread>
 #include <mutex>
 
@@ -38,6 +41,75 @@
 
 namespace {
 
+// Allocator for event objects.  Blocks are recycled through a per
+// thread free list rather than returned to the heap, so steady state
+// enqueuing of events does not allocate.  A block released on a
+// different thread than it was allocated on is recycled by the
+// releasing thread.
+template <typename T>
+class event_allocator
+{
+  struct free_list
+  {
+    static constexpr size_t max_blocks = 1024;
+    std::vector<void*> blocks;
+
+    ~free_list()
+    {
+      for (auto block : blocks)
+        ::operator delete(block);
+    }
+  };
+
+  static free_list&
+  get_free_list()
+  {
+    static thread_local free_list list;
+    return list;
+  }
+
+public:
+  using value_type = T;
+
+  event_allocator() = default;
+
+  template <typename U>
+  event_allocator(const event_allocator<U>&)
+  {}
+
+  T*
+  allocate(size_t n)
+  {
+    if (n != 1)
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+
+    auto& list = get_free_list();
+    if (list.blocks.empty())
+      return static_cast<T*>(::operator new(sizeof(T)));
+
+    auto block = list.blocks.back();
+    list.blocks.pop_back();
+    return static_cast<T*>(block);
+  }
+
+  void
+  deallocate(T* p, size_t n)
+  {
+    auto& list = get_free_list();
+    if (n != 1 || list.blocks.size() >= free_list::max_blocks) {
+      ::operator delete(p);
+      return;
+    }
+    list.blocks.push_back(p);
+  }
+
+  template <typename U>
+  bool operator==(const event_allocator<U>&) const { return true; }
+
+  template <typename U>
+  bool operator!=(const event_allocator<U>&) const { return false; }
+};
+
 }
 
 namespace xrt {
@@ -60,11 +132,19 @@ class event_impl : public std::enable_shared_from_this<event_impl>
   mutable std::condition_variable m_wait_done;
   event_queue::task m_task;
   event_queue_impl* m_event_queue = nullptr;
+  std::shared_ptr<event_impl> m_self;  // retained while enqueued
   std::vector<event_impl*> m_chain;
-  unsigned int m_wait_count = 0;
+  std::atomic<unsigned int> m_wait_count {0};
   unsigned int m_uid = 0;
   bool m_done = false;
 
+  static unsigned int
+  create_uid()
+  {
+    static std::atomic<unsigned int> count {0};
+    return count++;
+  }
+
 public:
   // Chain this event to argument event.  This increments
   // the wait count on the argument event, which cannot
@@ -77,7 +157,7 @@ public:
       return;
     m_chain.push_back(ev);
     ++ev->m_wait_count;
-    XRT_DEBUGF("event_impl(%d) chains ev(%d) ev_wc(%d)\n", m_uid, ev->m_uid, ev->m_wait_count);
+    XRT_DEBUGF("event_impl(%d) chains ev(%d) ev_wc(%d)\n", m_uid, ev->m_uid, ev->m_wait_count.load());
   }
 
   // Try to submit this event for execution.  This function
@@ -85,6 +165,8 @@ public:
   // for execution through its associated event queue, where
   // it will be picked up by an event handler and executed.
   //
+  // The wait count is atomic, submitting does not lock the event.
+  //
   // Return: true if wait_count is zero and event was submitted
   // for execution, false otherwise
   bool
@@ -96,11 +178,12 @@ public:
   // This function is called when the event is enqueued on the
   // event queue.  
   //
-  // This event is removed from the event queue when it completes.
+  // The event retains ownership of itself until it completes.
   bool
   submit(event_queue_impl* evq)
   {
     m_event_queue = evq;
+    m_self = shared_from_this();
     return submit();
   }
 
@@ -160,16 +243,22 @@ public:
   event_impl(event_queue::task&& t, const std::vector<event_queue::event>& deps)
     : m_task(std::move(t))
     , m_wait_count(1)
+    , m_uid(create_uid())
   {
-    static unsigned int count = 0;
-    m_uid = count++;
     XRT_DEBUGF("event_impl::event_impl(%d)\n", m_uid);
-    std::lock_guard<std::mutex> lk(m_mutex);
     for (auto& ev : deps)
       if (auto& impl = ev.get_impl())
         impl->chain(this);
   }
 
+  // Construct event without a task.  The event is not enqueued and
+  // is completed by the asynchronous operation it represents.
+  event_impl()
+    : m_uid(create_uid())
+  {
+    XRT_DEBUGF("event_impl::event_impl(%d) no task\n", m_uid);
+  }
+
   // Event destructor added for debuggability.
   ~event_impl()
   {
@@ -182,69 +271,71 @@ public:
 // Manages enqueued tasks in form of events that form an event graph
 // based on dependencies between the events.
 //
-// When an event is enqueued it is added to the set of events to
-// retain ownership of the event. As part of enqueuing the event, the
-// event is associated with the event queue by attempting to submit
-// it.
+// When an event is enqueued it retains ownership of itself until it
+// completes. As part of enqueuing the event, the event is associated
+// with the event queue by attempting to submit it.
 //
 // If all event dependencies have been satisfied, the event moves to
 // submitted state where it added the event queues task queue.  The
-// task queue is serviced by one or more event handlers that execute
-// the events in first-in-first-out order.
+// task queue is serviced by one or more event handlers.  The task
+// queue is a work stealing queue, events submitted by a handler, for
+// example events chained to an event completed by the handler, are
+// executed by the same handler unless stolen by an idle handler.
+// Events submitted by other threads are executed in
+// first-in-first-out order.
+//
+// When an event executed by a handler submits another event, the
+// first such event is executed by the same handler right after
+// without a round trip through the task queue.
 //
 // An event queue is associated with one or more event handlers, which
 // participate in ownership of the queue.
 class event_queue_impl
 {
-  // Event comparator for heterogenous lookup of events
-  struct event_cmp
+  // Handler executing on calling thread, and the event to execute
+  // next by that handler
+  struct handler_context
   {
-    using event_ptr = std::shared_ptr<event_impl>;
-    using is_transparent = void;
-    bool operator() (const event_ptr& lhs, const event_ptr& rhs) const { return lhs < rhs; }
-    bool operator() (const event_ptr& lhs, const event_impl* rhs) const { return lhs.get() < rhs; }
-    bool operator() (const event_impl* lhs, const event_ptr& rhs) const { return lhs < rhs.get(); }
+    event_queue_impl* queue = nullptr;
+    event_impl* next = nullptr;
   };
-  
-  std::queue<event_impl*> m_queue;                           // task queue
-  std::set<std::shared_ptr<event_impl>, event_cmp> m_events; // enqueued events
-  std::mutex m_mutex;
-  std::condition_variable m_work;
+
+  static handler_context&
+  get_context()
+  {
+    static thread_local handler_context ctx;
+    return ctx;
+  }
+
+  xrt_core::task::wsqueue<event_impl*> m_queue;    // task queue
 
 public:
   // Enqueue an event and try submit it.
   void
   enqueue(const std::shared_ptr<event_impl>& event)
   {
-    {
-      std::lock_guard<std::mutex> lk(m_mutex);
-      m_events.insert(event);
-    }
     event->submit(this);
   }
 
   // Submit argument event by inserting it in the queue that is
-  // serviced by event handlers.  Notify the handlers that work
-  // is ready.
+  // serviced by event handlers.  If called by a handler of this
+  // queue, the event becomes the event the handler executes next
+  // unless the handler already has one.
   void
   submit(event_impl* ev)
   {
-    std::lock_guard<std::mutex> lk(m_mutex);
-    m_queue.push(ev);
-    m_work.notify_one();
+    auto& ctx = get_context();
+    if (ctx.queue == this && !ctx.next) {
+      ctx.next = ev;
+      return;
+    }
+    m_queue.addWork(std::move(ev));
   }
 
-  // Upon completion, the event is removed from the ownership
-  // retaining set, which effectively deletes the event if no
-  // other objects participate in the events ownership.
+  // Execute an event and events it makes ready that are submitted
+  // inline.  Used by event handlers of this queue.
   void
-  remove(event_impl* ev)
-  {
-    std::lock_guard<std::mutex> lk(m_mutex);
-    auto itr = m_events.find(ev);
-    if (itr != m_events.end())
-      m_events.erase(itr);
-  }
+  execute(event_impl* ev);
 
   // Notify any waiting for work from this queue. Used by event
   // handler destructor to force termination of the event handler
@@ -252,31 +343,17 @@ public:
   void
   notify()
   {
-    std::lock_guard<std::mutex> lk(m_mutex);
-    m_work.notify_all();
+    m_queue.notify();
   }
 
   // Get work from the queue.  This function is used by
   // event handlers to wait for event that are ready to
-  // be executed.  The function pops of events from the
-  // front of the queue.
+  // be executed.  Returns nullptr when stop is set and
+  // the queue is notified.
   event_impl*
-  get_work()
+  get_work(const std::atomic<bool>& stop)
   {
-    std::unique_lock<std::mutex> lk(m_mutex);
-    // notify() need to be able to wake up handlers waiting
-    // for tasks, so wait is deliberately not using 'while'
-    if (m_queue.empty())
-      m_work.wait(lk);
-
-    // return null task if no real ones
-    if (m_queue.empty())
-      return nullptr;
-
-    // first in first out
-    auto e = std::move(m_queue.front());
-    m_queue.pop();
-    return e;
+    return m_queue.getWork(stop);
   }
 };
   
@@ -285,14 +362,27 @@ bool
 event_impl::
 submit()
 {
-  std::lock_guard<std::mutex> lk(m_mutex);
-  XRT_DEBUGF("event_impl::submit(%d) wc(%d)\n", m_uid, m_wait_count);
+  XRT_DEBUGF("event_impl::submit(%d) wc(%d)\n", m_uid, m_wait_count.load());
   if (--m_wait_count)
     return false;
   
   m_event_queue->submit(this);
   return true;
 }
+
+void
+event_queue_impl::
+execute(event_impl* ev)
+{
+  auto& ctx = get_context();
+  ctx.queue = this;
+  while (ev) {
+    ev->execute();
+    ev = ctx.next;
+    ctx.next = nullptr;
+  }
+  ctx.queue = nullptr;
+}
   
 // See comment block in event::impl::done() declaration.
 void
@@ -301,6 +391,9 @@ done()
 {
   XRT_DEBUGF("event_impl::done(%d)\n", m_uid);
 
+  // Release ownership of self when done
+  auto self = std::move(m_self);
+
   // Must only change done in critical section
   {
     std::lock_guard<std::mutex> lk(m_mutex);
@@ -310,8 +403,6 @@ done()
 
   for (auto& ev : m_chain)
     ev->submit();
-
-  m_event_queue->remove(this);
 }
 
 // class event_handler_impl - insulated implementation of xrt::event_handler
@@ -336,8 +427,8 @@ class event_handler_impl
   run()
   {
     while (!m_stop)
-      if (auto e = m_event_queue->get_work())
-        e->execute();
+      if (auto e = m_event_queue->get_work(m_stop))
+        m_event_queue->execute(e);
   }
   
 public:
@@ -346,7 +437,7 @@ public:
     : m_retain(q)
     , m_event_queue(q.get_impl())
   {
-    m_handler = std::thread(&event_handler_impl::run, this);
+    m_handler = xrt_core::thread(xrt_core::thread_class::scheduler, &event_handler_impl::run, this);
   }
 
   // Destruct event handler requesting event queue to notify waiting
@@ -382,6 +473,12 @@ done(xrt::event_impl* ev)
   ev->done();
 }
 
+xrt::event
+create_event()
+{
+  return xrt::event{std::allocate_shared<xrt::event_impl>(event_allocator<xrt::event_impl>{})};
+}
+
 }} // namespace enqueue, xrt_core
 
 ////////////////////////////////////////////////////////////////
@@ -404,7 +501,7 @@ add_event(const event& ev)
 event_queue::
 event::
 event(task&& t, const std::vector<event>& deps)
-  : m_impl(std::make_shared<event_impl>(std::move(t), deps))
+  : m_impl(std::allocate_shared<event_impl>(event_allocator<event_impl>{}, std::move(t), deps))
 {}
 
 void
@@ -34,10 +34,19 @@
 #include <boost/format.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <string>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <cstring>
 
+#ifdef __linux__
+# include <sys/eventfd.h>
+# include <unistd.h>
+#endif
+
 #ifdef _WIN32
 # pragma warning( disable : 4996)
 #endif
@@ -260,6 +269,201 @@ public:
 
 };
 
+// class error_subscription_impl - queue of asynchronous errors of a device
+//
+// A thread blocks in poll() on the xocl_errors sysfs node, which the
+// driver notifies when it records an error, and queues errors newer
+// than the last seen timestamp in a ring of fixed capacity.  The wait
+// times out periodically to check for destruction, and to catch up
+// with drivers that do not notify the node, or do not have it at all
+// (edge), in which case the errors are polled at that interval.
+class error_subscription_impl
+{
+  using record = std::pair<xrtErrorCode, xrtErrorTime>;
+
+  static constexpr int wait_ms = 500;
+
+  std::shared_ptr<xrt_core::device> m_device;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<record> m_ring;
+  size_t m_head = 0;
+  size_t m_count = 0;
+  uint64_t m_dropped = 0;
+  xrtErrorTime m_last = 0;
+
+  int m_efd = -1;
+  std::atomic<bool> m_stop {false};
+  std::thread m_thread;
+
+  std::vector<record>
+  get_errors() const
+  {
+    std::vector<record> errors;
+    try {
+      auto buf = xrt_core::device_query<xrt_core::query::xocl_errors>(m_device);
+      for (const auto& err : xrt_core::query::xocl_errors::to_errors(buf))
+        errors.emplace_back(err.err_code, err.ts);
+      return errors;
+    }
+    catch (const xrt_core::query::no_such_key&) {
+    }
+    for (const auto& line : xrt_core::device_query<xrt_core::query::error>(m_device))
+      errors.emplace_back(xrt_core::query::error::to_value(line));
+    return errors;
+  }
+
+  // Block until driver signals a change of the errors or timeout
+  void
+  wait_for_change()
+  {
+    try {
+      xrt_core::device_query<xrt_core::query::xocl_errors_wait>
+        (m_device, xrt_core::query::xocl_errors_wait::timeout_type{wait_ms});
+      return;
+    }
+    catch (const std::exception&) {
+      // no_such_key or node not pollable, fall back to polling
+    }
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_cv.wait_for(lk, std::chrono::milliseconds(wait_ms), [this] { return m_stop.load(); });
+  }
+
+  void
+  push(const record& rec)
+  {
+    if (m_count == m_ring.size()) {
+      m_head = (m_head + 1) % m_ring.size();
+      --m_count;
+      ++m_dropped;
+    }
+    m_ring[(m_head + m_count) % m_ring.size()] = rec;
+    ++m_count;
+  }
+
+  void
+  update(const std::vector<record>& errors)
+  {
+    uint64_t added = 0;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (const auto& rec : errors) {
+      if (rec.second <= m_last)
+        continue;
+      push(rec);
+      ++added;
+    }
+    for (const auto& rec : errors)
+      m_last = std::max(m_last, rec.second);
+
+    if (!added)
+      return;
+
+#ifdef __linux__
+    if (m_efd >= 0 && ::write(m_efd, &added, sizeof(added)) < 0)
+      xrt_core::send_exception_message("error_subscription: eventfd write failed");
+#endif
+    m_cv.notify_all();
+  }
+
+  void
+  run()
+  {
+    while (!m_stop) {
+      wait_for_change();
+      if (m_stop)
+        break;
+      try {
+        update(get_errors());
+      }
+      catch (const std::exception& ex) {
+        xrt_core::send_exception_message(ex.what());
+      }
+    }
+  }
+
+  std::vector<error>
+  drain()
+  {
+    std::vector<error> errors;
+    errors.reserve(m_count);
+    for (; m_count; --m_count, m_head = (m_head + 1) % m_ring.size())
+      errors.emplace_back(m_ring[m_head].first, m_ring[m_head].second);
+
+#ifdef __linux__
+    // Reset eventfd counter, the fd is non-blocking
+    uint64_t val = 0;
+    if (m_efd >= 0)
+      (void) ::read(m_efd, &val, sizeof(val));
+#endif
+    return errors;
+  }
+
+public:
+  error_subscription_impl(std::shared_ptr<xrt_core::device> device, size_t capacity)
+    : m_device(std::move(device))
+    , m_ring(std::max<size_t>(capacity, 1))
+  {
+    // Errors recorded before the subscription are not reported
+    for (const auto& rec : get_errors())
+      m_last = std::max(m_last, rec.second);
+
+#ifdef __linux__
+    m_efd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_efd < 0)
+      throw xrt_core::system_error(errno, "error_subscription: failed to create eventfd");
+#endif
+
+    m_thread = std::thread([this] { run(); });
+  }
+
+  ~error_subscription_impl()
+  {
+    m_stop = true;
+    m_cv.notify_all();
+    m_thread.join();
+#ifdef __linux__
+    ::close(m_efd);
+#endif
+  }
+
+  error_subscription_impl(const error_subscription_impl&) = delete;
+  error_subscription_impl& operator=(const error_subscription_impl&) = delete;
+
+  int
+  get_fd() const
+  {
+    return m_efd;
+  }
+
+  std::vector<error>
+  read()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return drain();
+  }
+
+  std::vector<error>
+  wait(std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    auto pred = [this] { return m_count > 0; };
+    if (timeout.count())
+      m_cv.wait_for(lk, timeout, pred);
+    else
+      m_cv.wait(lk, pred);
+    return drain();
+  }
+
+  uint64_t
+  get_dropped() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_dropped;
+  }
+};
+
+
 } //namespace
 
 ////////////////////////////////////////////////////////////////
@@ -306,6 +510,45 @@ to_string() const
   });
 }
 
+error_subscription::
+error_subscription(const xrt::device& device, size_t capacity)
+  : handle(xdp::native::profiling_wrapper("xrt::error_subscription::error_subscription", [&device, capacity]{
+      return std::make_shared<xrt::error_subscription_impl>(device.get_handle(), capacity);
+    }))
+{}
+
+int
+error_subscription::
+get_fd() const
+{
+  return handle->get_fd();
+}
+
+std::vector<error>
+error_subscription::
+read()
+{
+  return xdp::native::profiling_wrapper("xrt::error_subscription::read", [this]{
+    return handle->read();
+  });
+}
+
+std::vector<error>
+error_subscription::
+wait(std::chrono::milliseconds timeout)
+{
+  return xdp::native::profiling_wrapper("xrt::error_subscription::wait", [this, timeout]{
+    return handle->wait(timeout);
+  });
+}
+
+uint64_t
+error_subscription::
+get_dropped() const
+{
+  return handle->get_dropped();
+}
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
@@ -28,11 +28,20 @@
 #include "core/common/error.h"
 #include "core/common/xclbin_parser.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+# include <sys/epoll.h>
+# include <unistd.h>
+#endif
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 4996)
@@ -118,6 +127,117 @@ public:
     // Waits for interrupt, or return on timeout
     return device->wait_ip_interrupt(handle, static_cast<int32_t>(timeout.count()));
   }
+
+  xclInterruptNotifyHandle
+  get_notify_handle() const
+  {
+    return handle;
+  }
+};
+
+// class ip_wait_set_impl - Multiplex interrupt notify handles
+//
+// On Linux the interrupt notify handles are file descriptors that can
+// be polled.  The set is an epoll instance with the index of each
+// interrupt as event data.
+class ip_wait_set_impl
+{
+  std::vector<std::shared_ptr<ip::interrupt_impl>> m_interrupts;
+  mutable std::mutex m_mutex;
+#ifdef __linux__
+  int m_epfd;
+
+  // Collect ready interrupts from epoll, returns number of events
+  int
+  poll(std::vector<epoll_event>& events, int timeout_ms, std::vector<bool>& fired,
+       std::vector<size_t>& indices) const
+  {
+    auto n = ::epoll_wait(m_epfd, events.data(), static_cast<int>(events.size()), timeout_ms);
+    if (n < 0 && errno != EINTR)
+      throw xrt_core::system_error(errno, "ip_wait_set: epoll_wait failed");
+
+    for (int i = 0; i < n; ++i) {
+      auto idx = static_cast<size_t>(events[i].data.u64);
+      if (!fired[idx]) {
+        fired[idx] = true;
+        indices.push_back(idx);
+      }
+    }
+    return n;
+  }
+#endif
+
+public:
+  ip_wait_set_impl()
+  {
+#ifdef __linux__
+    m_epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_epfd < 0)
+      throw xrt_core::system_error(errno, "ip_wait_set: epoll_create1 failed");
+#else
+    throw xrt_core::error(std::errc::not_supported, "ip_wait_set");
+#endif
+  }
+
+  ~ip_wait_set_impl()
+  {
+#ifdef __linux__
+    ::close(m_epfd);
+#endif
+  }
+
+  ip_wait_set_impl(const ip_wait_set_impl&) = delete;
+  ip_wait_set_impl(ip_wait_set_impl&&) = delete;
+  ip_wait_set_impl& operator=(ip_wait_set_impl&) = delete;
+  ip_wait_set_impl& operator=(ip_wait_set_impl&&) = delete;
+
+  size_t
+  add(std::shared_ptr<ip::interrupt_impl> intr)
+  {
+    if (!intr)
+      throw xrt_core::error(EINVAL, "ip_wait_set: invalid interrupt object");
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto idx = m_interrupts.size();
+#ifdef __linux__
+    epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = idx;
+    if (::epoll_ctl(m_epfd, EPOLL_CTL_ADD, intr->get_notify_handle(), &ev))
+      throw xrt_core::system_error(errno, "ip_wait_set: failed to add interrupt");
+#endif
+    m_interrupts.push_back(std::move(intr));
+    return idx;
+  }
+
+  std::vector<size_t>
+  wait(const std::chrono::milliseconds& timeout, const std::chrono::microseconds& coalesce) const
+  {
+    std::vector<size_t> indices;
+#ifdef __linux__
+    std::vector<std::shared_ptr<ip::interrupt_impl>> interrupts;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      interrupts = m_interrupts;
+    }
+    if (interrupts.empty())
+      return indices;
+
+    std::vector<epoll_event> events(interrupts.size());
+    std::vector<bool> fired(interrupts.size(), false);
+    auto timeout_ms = timeout.count() ? static_cast<int>(timeout.count()) : -1;
+    if (poll(events, timeout_ms, fired, indices) > 0 && coalesce.count()
+        && indices.size() < interrupts.size()) {
+      std::this_thread::sleep_for(coalesce);
+      poll(events, 0, fired, indices);
+    }
+
+    // Acknowledge and re-enable fired interrupts
+    for (auto idx : indices)
+      interrupts[idx]->wait();
+#endif
+    return indices;
+  }
 };
 
 // struct ip_impl - The internals of an xrt::ip
@@ -275,6 +395,16 @@ public:
       device->xwrite(XCL_ADDR_KERNEL_CTRL, ipctx.get_address() + offset, &data, 4);
   }
 
+  ip::register_window
+  get_register_window() const
+  {
+    if (!has_reg_read_write())
+      throw xrt_core::error(std::errc::not_supported, "register window");
+
+    auto window = device->get_reg_window(ipctx.get_idx());
+    return {window.first, std::min<size_t>(window.second, ipctx.get_size())};
+  }
+
   std::shared_ptr<ip::interrupt_impl>
   get_interrupt()
   {
@@ -314,7 +444,7 @@ write_register(uint32_t offset, uint32_t data)
 {
   xdp::native::profiling_wrapper("xrt::ip::write_register",[this, offset, data]{
     handle->write_register(offset, data);
-  }) ;
+  });
 }
 
 uint32_t
@@ -323,7 +453,16 @@ read_register(uint32_t offset) const
 {
   return xdp::native::profiling_wrapper("xrt::ip::read_register", [this, offset] {
     return handle->read_register(offset);
-  }) ;
+  });
+}
+
+ip::register_window
+ip::
+get_register_window() const
+{
+  return xdp::native::profiling_wrapper("xrt::ip::get_register_window", [this] {
+    return handle->get_register_window();
+  });
 }
 
 xrt::ip::interrupt
@@ -370,6 +509,30 @@ wait(const std::chrono::milliseconds& timeout) const
   return std::cv_status::no_timeout;
 }
 
+////////////////////////////////////////////////////////////////
+// xrt::ip_wait_set
+////////////////////////////////////////////////////////////////
+ip_wait_set::
+ip_wait_set()
+  : detail::pimpl<ip_wait_set_impl>(std::make_shared<ip_wait_set_impl>())
+{}
+
+size_t
+ip_wait_set::
+add(const xrt::ip::interrupt& intr)
+{
+  return handle->add(intr.get_handle());
+}
+
+std::vector<size_t>
+ip_wait_set::
+wait(const std::chrono::milliseconds& timeout, const std::chrono::microseconds& coalesce) const
+{
+  return xdp::native::profiling_wrapper("xrt::ip_wait_set::wait", [this, &timeout, &coalesce] {
+    return handle->wait(timeout, coalesce);
+  });
+}
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
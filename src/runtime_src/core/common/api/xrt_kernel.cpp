@@ -19,8 +19,12 @@
 // core/include/experimental/xrt_kernel.h
 #define XCL_DRIVER_DLL_EXPORT  // exporting xrt_kernel.h
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
+#include "core/include/experimental/xrt_coro.h"
 #include "core/include/experimental/xrt_kernel.h"
 #include "core/include/experimental/xrt_mailbox.h"
+#include "core/include/experimental/xrt_run_template.h"
+#include "core/include/experimental/xrt_runlist.h"
+#include "core/include/experimental/xrt_typed_kernel.h"
 #include "core/include/experimental/xrt_xclbin.h"
 #include "core/include/ert.h"
 #include "core/include/ert_fa.h"
@@ -37,6 +41,7 @@
 #include "xclbin_int.h"
 
 #include "core/common/bo_cache.h"
+#include "core/common/bo_slab.h"
 #include "core/common/config_reader.h"
 #include "core/common/cuidx_type.h"
 #include "core/common/device.h"
@@ -44,6 +49,9 @@
 #include "core/common/error.h"
 #include "core/common/message.h"
 #include "core/common/system.h"
+#include "core/common/task.h"
+#include "core/common/thread.h"
+#include "core/common/usdt.h"
 #include "core/common/xclbin_parser.h"
 
 #include <boost/format.hpp>
@@ -54,12 +62,22 @@
 #include <condition_variable>
 #include <chrono>
 #include <cstdarg>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <stdexcept>
 #include <fstream>
+#include <thread>
+#include <list>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 using namespace std::chrono_literals;
@@ -139,6 +157,14 @@ constexpr uint32_t MAILBOX_OUTPUT_CTRL = (1 << 10);
 constexpr size_t max_cus = 128;
 constexpr size_t cus_per_word = 32;
 
+// Host monotonic time in ns, same clock as driver command timestamps
+uint64_t
+monotonic_ns()
+{
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
 XRT_CORE_UNUSED // debug enabled function
 std::string
 debug_cmd_packet(const std::string& msg, const ert_packet* pkt)
@@ -255,6 +281,16 @@ is_sw_emulation()
   return swem;
 }
 
+// Slab allocated exec buffers are opt-in as they require driver
+// support for submitting a command at an offset in the exec buffer.
+// Emulation shims do not support offsets.
+inline bool
+use_exec_buffer_slab()
+{
+  static bool slab = xrt_core::config::get_exec_buffer_slab() && !std::getenv("XCL_EMULATION_MODE");
+  return slab;
+}
+
 inline bool
 has_reg_read_write()
 {
@@ -280,6 +316,62 @@ value_to_uint32_vector(ValueType value)
   return value_to_uint32_vector(&value, sizeof(value));
 }
 
+// class callback_dispatch - Worker pool for run completion callbacks
+//
+// Callbacks registered with xrt::run::add_callback are executed by
+// workers of this pool rather than by the thread that observed the
+// command completion.  Completion of managed commands is observed by
+// the device command monitor thread, which would otherwise be
+// blocked by a slow callback from notifying completion of any other
+// command on the device.
+//
+// The number of workers is Runtime.exec_callback_threads, a value of
+// 0 disables the pool in which case callbacks are executed inline.
+class callback_dispatch
+{
+  xrt_core::task::queue m_queue;
+  std::vector<std::thread> m_workers;
+
+public:
+  explicit
+  callback_dispatch(unsigned int workers)
+  {
+    auto cpus = xrt_core::config::get_exec_callback_cpu_affinity();
+    for (unsigned int idx = 0; idx < workers; ++idx) {
+      m_workers.emplace_back(xrt_core::thread(xrt_core::thread_class::scheduler, xrt_core::task::worker, std::ref(m_queue)));
+      xrt_core::detail::set_cpu_affinity(m_workers.back(), cpus);
+    }
+  }
+
+  ~callback_dispatch()
+  {
+    m_queue.stop();
+    for (auto& worker : m_workers)
+      worker.join();
+  }
+
+  callback_dispatch(const callback_dispatch&) = delete;
+  callback_dispatch(callback_dispatch&&) = delete;
+  callback_dispatch& operator=(callback_dispatch&) = delete;
+  callback_dispatch& operator=(callback_dispatch&&) = delete;
+
+  // Return pool or nullptr if callbacks should be executed inline
+  static callback_dispatch*
+  get()
+  {
+    static auto workers = xrt_core::config::get_exec_callback_threads();
+    static callback_dispatch pool(workers);
+    return workers ? &pool : nullptr;
+  }
+
+  template <typename Callable>
+  void
+  dispatch(Callable&& fcn)
+  {
+    m_queue.addWork(xrt_core::task::task(std::forward<Callable>(fcn)));
+  }
+};
+
 // struct device_type - Extends xrt_core::device
 //
 // This struct is not really needed.
@@ -290,10 +382,9 @@ struct device_type
 {
   std::shared_ptr<xrt_core::device> core_device;
   xrt_core::bo_cache exec_buffer_cache;
+  std::unique_ptr<xrt_core::bo_slab> exec_buffer_slab;
   uint32_t uid; // internal unique id for debug
 
-  static constexpr unsigned int cache_size = 128;
-
   static uint32_t
   create_uid()
   {
@@ -304,19 +395,23 @@ struct device_type
   explicit
   device_type(xrtDeviceHandle dhdl)
     : core_device(xrt_core::device_int::get_core_device(dhdl))
-    , exec_buffer_cache(core_device->get_device_handle(), cache_size)
+    , exec_buffer_cache(core_device->get_device_handle(), xrt_core::config::get_exec_buffer_cache_size())
+    , exec_buffer_slab(use_exec_buffer_slab() ? std::make_unique<xrt_core::bo_slab>(core_device->get_device_handle()) : nullptr)
     , uid(create_uid())
   {
     XRT_DEBUGF("device_type::device_type(%d)\n", uid);
+    exec_buffer_cache.prewarm(xrt_core::config::get_exec_buffer_cache_prewarm());
   }
 
   explicit
   device_type(std::shared_ptr<xrt_core::device> cdev)
     : core_device(std::move(cdev))
-    , exec_buffer_cache(core_device->get_device_handle(), cache_size)
+    , exec_buffer_cache(core_device->get_device_handle(), xrt_core::config::get_exec_buffer_cache_size())
+    , exec_buffer_slab(use_exec_buffer_slab() ? std::make_unique<xrt_core::bo_slab>(core_device->get_device_handle()) : nullptr)
     , uid(create_uid())
   {
     XRT_DEBUGF("device_type::device_type(%d)\n", uid);
+    exec_buffer_cache.prewarm(xrt_core::config::get_exec_buffer_cache_prewarm());
   }
 
   // NOLINTNEXTLINE(modernize-use-equals-default)
@@ -330,13 +425,42 @@ struct device_type
   device_type& operator=(device_type&) = delete;
   device_type& operator=(device_type&&) = delete;
 
+  // create_exec_buf() - allocate a command buffer
+  //
+  // @size: bytes required by command, 0 if unknown
+  //
+  // When slab allocation is enabled, commands of known size are
+  // carved out of a slab, otherwise the command buffer is a page
+  // from the exec buffer cache.
   template <typename CommandType>
   xrt_core::bo_cache::cmd_bo<CommandType>
-  create_exec_buf()
+  create_exec_buf(size_t size = 0)
   {
+    if (exec_buffer_slab && size && size <= xrt_core::bo_slab::max_size())
+      return exec_buffer_slab->alloc<CommandType>(size);
+
     return exec_buffer_cache.alloc<CommandType>();
   }
 
+  template <typename CommandType>
+  void
+  release_exec_buf(xrt_core::bo_cache::cmd_bo<CommandType>& bo)
+  {
+    if (exec_buffer_slab && exec_buffer_slab->owns(bo.first))
+      exec_buffer_slab->release(bo);
+    else
+      exec_buffer_cache.release(bo);
+  }
+
+  // Offset of command within command buffer, non zero for slab
+  // allocated commands only
+  template <typename CommandType>
+  size_t
+  get_exec_buf_offset(const xrt_core::bo_cache::cmd_bo<CommandType>& bo)
+  {
+    return exec_buffer_slab ? exec_buffer_slab->offset(bo) : 0;
+  }
+
   xrt_core::device*
   get_core_device() const
   {
@@ -384,6 +508,132 @@ private:
   std::bitset<size> m_bitset;
 };
 
+// class fa_ring - Descriptor ring of a user managed fast adapter CU
+//
+// The descriptor slots assigned to the CU by the kernel driver are
+// mapped into the process.  A descriptor is written to the next slot
+// and the CU is started by writing the slot device address to the
+// descriptor address registers.  Completion is tracked with the CU
+// task count register, descriptors complete in order.  At most
+// min(slots, CU FIFO depth) descriptors are outstanding.
+class fa_ring
+{
+  // Fast adapter registers, see fast_adapter.c
+  static constexpr uint32_t mswr = 0x0;
+  static constexpr uint32_t lswr = 0x4;
+  static constexpr uint32_t tcr = 0x14;
+  static constexpr uint32_t fdr = 0x1c;
+
+  xrt_core::device* m_device;
+  uint32_t m_cuidx;
+  xrt_core::fa_desc_window m_window;
+  uint32_t m_credits;
+
+  std::mutex m_mutex;
+  uint32_t m_head = 0;        // next slot
+  uint32_t m_desc_msw;        // current value of MSW register
+  uint32_t m_task_count;      // last read task count register
+  uint64_t m_issued = 0;      // descriptors started
+  uint64_t m_completed = 0;   // descriptors completed
+
+  uint32_t
+  read_register(uint32_t offset) const
+  {
+    uint32_t value = 0;
+    m_device->reg_read(m_cuidx, offset, &value);
+    return value;
+  }
+
+  // Read task count and account for completed descriptors, the
+  // unsigned difference is correct across register wrap around.
+  // Called with m_mutex held
+  void
+  update()
+  {
+    auto task_count = read_register(tcr);
+    m_completed += static_cast<uint32_t>(task_count - m_task_count);
+    m_task_count = task_count;
+  }
+
+public:
+  fa_ring(xrt_core::device* device, uint32_t cuidx)
+    : m_device(device)
+    , m_cuidx(cuidx)
+    , m_window(device->map_fa_desc(cuidx))
+    , m_credits(std::min(m_window.num_slots, read_register(fdr)))
+    , m_desc_msw(read_register(mswr))
+    , m_task_count(read_register(tcr))
+  {}
+
+  ~fa_ring()
+  {
+    try {
+      m_device->unmap_fa_desc(m_window);
+    }
+    catch (...) {
+    }
+  }
+
+  fa_ring(const fa_ring&) = delete;
+  fa_ring(fa_ring&&) = delete;
+  fa_ring& operator=(fa_ring&) = delete;
+  fa_ring& operator=(fa_ring&&) = delete;
+
+  size_t
+  get_slot_size() const
+  {
+    return m_window.slot_size;
+  }
+
+  // Write descriptor to next slot and start the CU.  Waits for a
+  // credit if the maximum number of descriptors are outstanding.
+  // Returns sequence number used to check for completion.
+  uint64_t
+  start(const uint32_t* desc, size_t words)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    while (m_issued - m_completed >= m_credits) {
+      update();
+      if (m_issued - m_completed >= m_credits)
+        std::this_thread::yield();
+    }
+
+    // Status word is written last, the CU reads a complete descriptor
+    auto slot = m_window.base + m_head * (m_window.slot_size / sizeof(uint32_t));
+    auto vslot = const_cast<volatile uint32_t*>(slot);
+    for (size_t w = 1; w < words; ++w)
+      vslot[w] = desc[w];
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    vslot[0] = desc[0];
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto addr = m_window.dev_addr + static_cast<uint64_t>(m_head) * m_window.slot_size;
+    auto desc_msw = static_cast<uint32_t>(addr >> 32);
+    if (desc_msw != m_desc_msw) {
+      m_device->reg_write(m_cuidx, mswr, desc_msw);
+      m_desc_msw = desc_msw;
+    }
+
+    // Write of LSW starts the CU
+    m_device->reg_write(m_cuidx, lswr, static_cast<uint32_t>(addr));
+
+    if (++m_head == m_window.num_slots)
+      m_head = 0;
+
+    return ++m_issued;
+  }
+
+  // Check if descriptor with sequence number is completed
+  bool
+  done(uint64_t seq)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_completed < seq)
+      update();
+    return m_completed >= seq;
+  }
+};
+
 // struct ip_context - Manages process access to CUs
 //
 // Constructing a kernel object opens a context on the CUs associated
@@ -474,16 +724,20 @@ public:
   using access_mode = xrt::kernel::cu_access_mode;
   static constexpr unsigned int virtual_cu_idx = std::numeric_limits<unsigned int>::max();
 
-  // open() - open a context in a specific IP/CU
+  // open() - open contexts in specific IPs/CUs
   //
-  // @device:    Device on which context should opened
-  // @xclbin:    xclbin containeing the IP definition
-  // @ip:        The ip_data defintion for this IP from the xclbin
-  // @cuidx:     Index of CU used when opening context and populating cmd pkt
-  // @am:        Access mode, how this CU should be opened
-  static std::shared_ptr<ip_context>
-  open(xrt_core::device* device, const xrt::xclbin& xclbin, const xrt::xclbin::ip& ip,
-       xrt_core::cuidx_type cuidx, access_mode am)
+  // @device:    Device on which contexts should opened
+  // @xclbin:    xclbin containeing the IP definitions
+  // @cus:       The ip_data defintion for each IP from the xclbin paired
+  //             with the index of CU used when opening context and
+  //             populating cmd pkt
+  // @am:        Access mode, how the CUs should be opened
+  //
+  // The contexts of IPs that are not already opened are acquired
+  // together with one call to the context manager.
+  static std::vector<std::shared_ptr<ip_context>>
+  open(xrt_core::device* device, const xrt::xclbin& xclbin,
+       const std::vector<std::pair<xrt::xclbin::ip, xrt_core::cuidx_type>>& cus, access_mode am)
   {
     // Slightly complicated handling of shared ownership of ip_context objects.
     // Contexts are managed per device.
@@ -497,18 +751,36 @@ public:
     static std::map<xrt_core::device*, domain_to_ips> dev2ips;
     std::lock_guard<std::mutex> lk(mutex);
     auto& dom2ips = dev2ips[device]; // domain -> ip_context_list
-    auto& ips = dom2ips[cuidx.domain];
-    auto ipctx = ips[cuidx.domain_index].lock();
-    if (!ipctx) {
-      // NOLINTNEXTLINE(modernize-make-shared)  used in weak_ptr
-      ipctx = std::shared_ptr<ip_context>(new ip_context(device, xclbin, ip, cuidx, am));
-      ips[cuidx.domain_index] = ipctx;
+
+    std::vector<std::shared_ptr<ip_context>> ipctxs;
+    std::vector<std::shared_ptr<ip_context>> created;
+    std::vector<xrt_core::cuidx_type> cuidxs;
+    for (const auto& cu : cus) {
+      auto cuidx = cu.second;
+      auto& ips = dom2ips[cuidx.domain];
+      auto ipctx = ips[cuidx.domain_index].lock();
+      if (!ipctx) {
+        // Context is opened below along with other new ip_contexts
+        // NOLINTNEXTLINE(modernize-make-shared)  used in weak_ptr
+        ipctx = std::shared_ptr<ip_context>(new ip_context(device, xclbin, cu.first, cuidx, access_mode::none));
+        ips[cuidx.domain_index] = ipctx;
+        created.push_back(ipctx);
+        cuidxs.push_back(cuidx);
+      }
+      else if (ipctx->access != am) {
+        throw std::runtime_error("Conflicting access mode for IP(" + std::to_string(cuidx.index) + ")");
+      }
+      ipctxs.push_back(std::move(ipctx));
     }
 
-    if (ipctx->access != am)
-      throw std::runtime_error("Conflicting access mode for IP(" + std::to_string(cuidx.index) + ")");
+    if (am != access_mode::none && !cuidxs.empty()) {
+      auto xid = xclbin.get_uuid();
+      xrt_core::context_mgr::open_contexts(device, xid, cuidxs, std::underlying_type<access_mode>::type(am));
+      for (auto& ipctx : created)
+        ipctx->access = am;
+    }
 
-    return ipctx;
+    return ipctxs;
   }
 
   // open() - open a context on the device virtual CU
@@ -587,9 +859,76 @@ public:
     return args.get_arg_memidx(argidx);
   }
 
+  // Hand the compute unit over to user space.  The scheduler in the
+  // kernel driver rejects commands for the compute unit until the
+  // context is closed.  Requires exclusive access.
+  void
+  open_user_managed()
+  {
+    std::lock_guard<std::mutex> lk(ucu_mutex);
+    if (user_managed)
+      return;
+
+    if (access != access_mode::exclusive)
+      throw xrt_core::error(EPERM, "Compute unit must be opened in exclusive mode to be user managed");
+
+    ucu_handle = device->open_ip_interrupt_notify(idx.domain_index);
+#ifndef _WIN32
+    if (ucu_handle < 0)
+      throw xrt_core::system_error(-ucu_handle, "Failed to hand over compute unit(" + std::to_string(idx.index) + ")");
+#endif
+    user_managed = true;
+  }
+
+  // Hand a fast adapter compute unit over to user space and map its
+  // descriptor slots.  Returns false, with the compute unit managed
+  // by the kernel driver, if the slots cannot be mapped or are too
+  // small for descriptors of desc_bytes.
+  bool
+  open_fa_ring(size_t desc_bytes)
+  {
+    open_user_managed();
+
+    std::lock_guard<std::mutex> lk(ucu_mutex);
+    if (fa)
+      return true;
+
+    try {
+      fa = std::make_unique<fa_ring>(device, idx.domain_index);
+      if (fa->get_slot_size() >= desc_bytes)
+        return true;
+      fa.reset();
+    }
+    catch (const std::exception&) {
+    }
+
+    device->close_ip_interrupt_notify(ucu_handle);
+    user_managed = false;
+    return false;
+  }
+
+  fa_ring*
+  get_fa_ring() const
+  {
+    return fa.get();
+  }
+
   ~ip_context()
   {
-    xrt_core::context_mgr::close_context(device, xid, idx);
+    // unmap descriptor slots before giving the cu back to the driver
+    fa.reset();
+
+    if (user_managed) {
+      try {
+        device->close_ip_interrupt_notify(ucu_handle);
+      }
+      catch (...) {
+      }
+    }
+
+    // A context is open if the access mode is specified
+    if (access != access_mode::none)
+      xrt_core::context_mgr::close_context(device, xid, idx);
   }
 
   ip_context(const ip_context&) = delete;
@@ -634,6 +973,11 @@ private:
   uint64_t address;         // cache base address for programming
   size_t size;              // cache address space size
   access_mode access;       // compute unit access mode
+
+  std::mutex ucu_mutex;                  // sync handover to user space
+  xclInterruptNotifyHandle ucu_handle{}; // handle of user managed cu
+  bool user_managed = false;             // cu is handed over to user space
+  std::unique_ptr<fa_ring> fa;           // descriptor ring of user managed fa cu
 };
 
 // Remove when c++17
@@ -649,11 +993,21 @@ public:
   using callback_function_type = std::function<void(ert_cmd_state)>;
   using callback_list = std::vector<callback_function_type>;
 
+  // Tag for construction with deferred exec buffer allocation
+  struct deferred_type {};
+  static constexpr deferred_type deferred {};
+
 public:
+  // kernel_command() - construct command
+  //
+  // @dev:  device to execute command on
+  // @size: bytes required by command packet, 0 if unknown
   explicit
-  kernel_command(std::shared_ptr<device_type> dev)
+  kernel_command(std::shared_ptr<device_type> dev, size_t size = 0)
     : m_device(std::move(dev))
-    , m_execbuf(m_device->create_exec_buf<ert_start_kernel_cmd>())
+    , m_execbuf(m_device->create_exec_buf<ert_start_kernel_cmd>(size))
+    , m_execbuf_offset(m_device->get_exec_buf_offset(*m_execbuf))
+    , m_packet(reinterpret_cast<ert_packet*>(m_execbuf->second))
     , m_done(true)
   {
     static unsigned int count = 0;
@@ -661,11 +1015,33 @@ public:
     XRT_DEBUGF("kernel_command::kernel_command(%d)\n", m_uid);
   }
 
+  // kernel_command() - construct command with deferred exec buffer
+  //
+  // @dev:  device to execute command on
+  // @size: bytes required by command packet
+  //
+  // The command packet is populated in host memory and copied to an
+  // exec buffer by materialize() before the command is first
+  // submitted.  Commands that are never started never allocate an
+  // exec buffer.
+  kernel_command(std::shared_ptr<device_type> dev, size_t size, deferred_type)
+    : m_device(std::move(dev))
+    , m_shadow((size + sizeof(uint32_t) - 1) / sizeof(uint32_t), 0)
+    , m_execbuf_offset(0)
+    , m_packet(reinterpret_cast<ert_packet*>(m_shadow.data()))
+    , m_done(true)
+  {
+    static unsigned int count = 0;
+    m_uid = count++;
+    XRT_DEBUGF("kernel_command::kernel_command(%d) deferred\n", m_uid);
+  }
+
   ~kernel_command() override
   {
     XRT_DEBUGF("kernel_command::~kernel_command(%d)\n", m_uid);
     // This is problematic, bo_cache should return managed BOs
-    m_device->exec_buffer_cache.release(m_execbuf);
+    if (m_execbuf)
+      m_device->release_exec_buf(*m_execbuf);
   }
 
   kernel_command(const kernel_command&) = delete;
@@ -673,6 +1049,36 @@ public:
   kernel_command& operator=(kernel_command&) = delete;
   kernel_command& operator=(kernel_command&&) = delete;
 
+  // materialize() - allocate the exec buffer of a deferred command
+  //
+  // Copies the packet populated in host memory to the exec buffer.
+  // Returns the address of the packet before materialization so
+  // that pointers into the packet can be rebased, or nullptr if the
+  // exec buffer was already allocated.
+  ert_packet*
+  materialize()
+  {
+    if (m_execbuf)
+      return nullptr;
+
+    auto bytes = m_shadow.size() * sizeof(uint32_t);
+    m_execbuf.emplace(m_device->create_exec_buf<ert_start_kernel_cmd>(bytes));
+    m_execbuf_offset = m_device->get_exec_buf_offset(*m_execbuf);
+    std::memcpy(m_execbuf->second, m_shadow.data(), bytes);
+
+    auto shadow = m_packet;
+    m_packet = reinterpret_cast<ert_packet*>(m_execbuf->second);
+    return shadow;
+  }
+
+  // Release host memory of a materialized deferred command, the
+  // caller must no longer reference the old packet
+  void
+  release_shadow()
+  {
+    std::vector<uint32_t>().swap(m_shadow);
+  }
+
   void
   encode_compute_units(const std::bitset<max_cus>& cumask, size_t num_cumasks)
   {
@@ -752,6 +1158,33 @@ public:
       m_callbacks->pop_back();
   }
 
+  // Execute callbacks on callback dispatch pool if enabled.  The
+  // dispatched task shares ownership of this command.  The one-shot
+  // notification if any is called after registered callbacks.
+  void
+  dispatch_callbacks(ert_cmd_state state, callback_function_type&& once)
+  {
+    auto pool = callback_dispatch::get();
+    if (!pool) {
+      run_callbacks(state);
+      if (once)
+        once(state);
+      return;
+    }
+
+    auto self = std::static_pointer_cast<kernel_command>(shared_from_this());
+    pool->dispatch([self, state, once = std::move(once)] {
+      try {
+        self->run_callbacks(state);
+        if (once)
+          once(state);
+      }
+      catch (const std::exception& ex) {
+        xrt_core::send_exception_message(std::string("run callback failed: ") + ex.what());
+      }
+    });
+  }
+
   // Run registered callbacks.
   void
   run_callbacks(ert_cmd_state state) const
@@ -779,26 +1212,54 @@ public:
       (*cb)(state);
   }
 
-  // Submit the command for execution.
+  // Prepare the command for execution.
   // The argument event, if valid, means execution is event based
   // which means that event must be notified upon completion.
+  // The argument notify, if valid, is called once upon completion
+  // of this execution.
+  // Returns true if the command must be managed by the scheduler.
+  bool
+  prepare_run(const std::shared_ptr<xrt::event_impl>& event, callback_function_type&& notify = nullptr)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_done)
+      throw std::runtime_error("bad command state, can't launch");
+    m_event = event;
+    m_notify = std::move(notify);
+    m_managed = ( m_event || m_notify || (m_callbacks && !m_callbacks->empty()) );
+    m_done = false;
+    if (m_timestamps)
+      reset_timestamps();
+    return m_managed;
+  }
+
+  // Revert a prepared command that could not be submitted
   void
-  run(const std::shared_ptr<xrt::event_impl>& event = nullptr)
+  unprepare_run()
   {
-    {
-      std::lock_guard<std::mutex> lk(m_mutex);
-      if (!m_done)
-        throw std::runtime_error("bad command state, can't launch");
-      m_event = event;
-      m_managed = ( m_event || (m_callbacks && !m_callbacks->empty()) );
-      m_done = false;
-    }
-    if (m_managed)
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_event.reset();
+    m_notify = nullptr;
+    m_done = true;
+  }
+
+  // Submit a prepared command for execution
+  void
+  submit(bool managed)
+  {
+    if (managed)
       xrt_core::exec::managed_start(this);
     else
       xrt_core::exec::unmanaged_start(this);
   }
 
+  // Submit the command for execution.
+  void
+  run(const std::shared_ptr<xrt::event_impl>& event = nullptr)
+  {
+    submit(prepare_run(event));
+  }
+
   // Wait for command completion
   ert_cmd_state
   wait() const
@@ -832,13 +1293,81 @@ public:
     return get_state();
   }
 
+  // Enable or disable driver recording of command timestamps.  Takes
+  // effect at next start of the command.
+  void
+  enable_timestamps(bool enable)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_done)
+      throw xrt_core::error(EBUSY, "Cannot change timestamps of running command");
+    m_timestamps = enable;
+    get_ert_cmd<ert_start_kernel_cmd*>()->stat_enabled = enable ? 1 : 0;
+  }
+
+  // Set deadline of the command in ns, 0 for none.  The deadline is
+  // carried after the payload and timestamps of the command.
+  void
+  set_deadline(uint64_t ns)
+  {
+    auto pkt = get_ert_cmd<ert_start_kernel_cmd*>();
+    if (!ns && !pkt->deadline)
+      return;
+#ifdef __GNUC__
+    pkt->deadline = ns ? 1 : 0;
+    if (ns)
+      *ert_start_kernel_deadline(pkt) = ns;
+#else
+    throw xrt_core::error(ENOTSUP, "Command deadlines are not supported");
+#endif
+  }
+
+  // Set scheduling priority of the command.  Takes effect at next
+  // start of the command.
+  void
+  set_priority(xrt::run::priority_type priority)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_done)
+      throw xrt_core::error(EBUSY, "Cannot change priority of running command");
+    get_ert_cmd<ert_start_kernel_cmd*>()->priority = static_cast<uint32_t>(priority);
+  }
+
+  // Timestamps of last execution of this command.  Host stamps are
+  // recorded by XRT, the remaining stamps are written by the driver
+  // into the exec buffer following the command payload.
+  xrt::run::timestamps
+  get_timestamps() const
+  {
+    xrt::run::timestamps ts;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_timestamps)
+      return ts;
+
+    ts.host_start = m_host_start;
+    ts.host_notify = m_host_notify;
+#ifdef __GNUC__
+    auto pkt = get_ert_cmd<ert_start_kernel_cmd*>();
+    if (!pkt->stat_enabled)
+      return ts;
+
+    auto state = static_cast<ert_cmd_state>(pkt->state);
+    auto stamps = ert_start_kernel_timestamps(pkt)->skc_timestamps;
+    ts.driver_receive = stamps[ERT_CMD_STATE_NEW];
+    ts.cu_dispatch = stamps[ERT_CMD_STATE_RUNNING];
+    if (state >= ERT_CMD_STATE_COMPLETED && state < ERT_CMD_STATE_MAX)
+      ts.cu_done = stamps[state];
+#endif
+    return ts;
+  }
+
   ////////////////////////////////////////////////////////////////
   // Implement xrt_core::command API
   ////////////////////////////////////////////////////////////////
   ert_packet*
   get_ert_packet() const override
   {
-    return reinterpret_cast<ert_packet*>(m_execbuf.second);
+    return m_packet;
   }
 
   xrt_core::device*
@@ -850,7 +1379,13 @@ public:
   xclBufferHandle
   get_exec_bo() const override
   {
-    return m_execbuf.first;
+    return m_execbuf ? m_execbuf->first : XRT_NULL_BO;
+  }
+
+  size_t
+  get_exec_bo_offset() const override
+  {
+    return m_execbuf_offset;
   }
 
   void
@@ -858,19 +1393,23 @@ public:
   {
     bool complete = false;
     bool callbacks = false;
+    callback_function_type once;
     if (s>=ERT_CMD_STATE_COMPLETED) {
       std::lock_guard<std::mutex> lk(m_mutex);
       XRT_DEBUGF("kernel_command::notify() m_uid(%d) m_state(%d)\n", m_uid, s);
       complete = m_done = true;
+      if (m_timestamps)
+        m_host_notify = monotonic_ns();
       callbacks = (m_callbacks && !m_callbacks->empty());
+      std::swap(once, m_notify);
       if (m_event)
         xrt_core::enqueue::done(m_event.get());
     }
 
     if (complete) {
       m_exec_done.notify_all();
-      if (callbacks)
-        run_callbacks(s);
+      if (callbacks || once)
+        dispatch_callbacks(s, std::move(once));
 
       // Clear the event if any.  This must be last since if used, it
       // holds the lifeline to this command object which could end up
@@ -881,17 +1420,36 @@ public:
   }
 
 private:
+  // Clear stamps of previous execution, mutex must be locked
+  void
+  reset_timestamps()
+  {
+    m_host_start = monotonic_ns();
+    m_host_notify = 0;
+#ifdef __GNUC__
+    auto stamps = ert_start_kernel_timestamps(get_ert_cmd<ert_start_kernel_cmd*>());
+    std::fill(std::begin(stamps->skc_timestamps), std::end(stamps->skc_timestamps), 0);
+#endif
+  }
+
   std::shared_ptr<device_type> m_device;
   std::shared_ptr<xrt::event_impl> m_event;
-  execbuf_type m_execbuf; // underlying execution buffer
+  std::vector<uint32_t> m_shadow; // packet of deferred command until materialized
+  std::optional<execbuf_type> m_execbuf; // underlying execution buffer
+  size_t m_execbuf_offset; // offset of command in execution buffer
+  ert_packet* m_packet;    // packet in exec buffer or shadow
   unsigned int m_uid = 0;
   bool m_managed = false;
   bool m_done = false;
+  bool m_timestamps = false;  // driver records command timestamps
+  uint64_t m_host_start = 0;  // monotonic ns when command was started
+  uint64_t m_host_notify = 0; // monotonic ns when host saw completion
 
   mutable std::mutex m_mutex;
   mutable std::condition_variable m_exec_done;
 
   std::unique_ptr<callback_list> m_callbacks;
+  callback_function_type m_notify; // one-shot completion notification
 };
 
 // class argument - get argument value from va_arg
@@ -1189,6 +1747,61 @@ public:
 
 namespace xrt {
 
+// abort_commands() - Abort started commands in batches
+//
+// @device: device on which commands execute
+// @cmds:   commands to abort
+// Return:  state of each command after it was aborted or completed
+//
+// One abort command lists up to max_abort_handles commands, the
+// scheduler walks the CU queues once per abort command rather than
+// once per aborted command.  All abort commands are submitted before
+// any is waited on.  Commands that are done when this function is
+// called are not aborted, their state is returned as is.
+static std::vector<ert_cmd_state>
+abort_commands(const std::shared_ptr<device_type>& device, const std::vector<kernel_command*>& cmds)
+{
+  // handles that fit in one exec buffer page, the handles are 64-bit
+  // aligned so the payload starts with one word of padding
+  constexpr size_t handles_offset = offsetof(ert_abort_cmd, exec_bo_handles);
+  constexpr size_t max_abort_handles = (4096 - handles_offset) / sizeof(uint64_t);
+
+  std::vector<kernel_command*> started;
+  for (auto cmd : cmds)
+    if (!cmd->is_done())
+      started.push_back(cmd);
+
+  std::vector<std::shared_ptr<kernel_command>> aborts;
+  for (size_t idx = 0; idx < started.size(); idx += max_abort_handles) {
+    auto num = std::min(max_abort_handles, started.size() - idx);
+    auto bytes = handles_offset + num * sizeof(uint64_t);
+    auto abort_cmd = std::make_shared<kernel_command>(device, bytes);
+    auto abort_pkt = abort_cmd->get_ert_cmd<ert_abort_cmd*>();
+    abort_pkt->state = ERT_CMD_STATE_NEW;
+    abort_pkt->count = static_cast<uint32_t>((bytes - sizeof(abort_pkt->header)) / sizeof(uint32_t));
+    abort_pkt->opcode = ERT_ABORT;
+    abort_pkt->type = ERT_CTRL;
+    // slab allocated commands are identified by handle and offset
+    for (size_t i = 0; i < num; ++i) {
+      auto cmd = started[idx + i];
+      abort_pkt->exec_bo_handles[i] =
+        to_uint64_t(cmd->get_exec_bo()) | (static_cast<uint64_t>(cmd->get_exec_bo_offset()) << 32);
+    }
+    abort_cmd->run();
+    aborts.push_back(std::move(abort_cmd));
+  }
+
+  for (const auto& abort_cmd : aborts)
+    abort_cmd->wait();
+
+  // wait for aborted commands, return their state
+  std::vector<ert_cmd_state> states;
+  states.reserve(cmds.size());
+  for (auto cmd : cmds)
+    states.push_back(cmd->is_done() ? cmd->get_state() : cmd->wait());
+  return states;
+}
+
 // struct kernel_impl - The internals of an xrtKernelHandle
 //
 // An single object of kernel_type can be shared with multiple
@@ -1229,6 +1842,18 @@ private:
   control_type protocol = control_type::none; // Default opcode
   uint32_t uid;                        // Internal unique id for debug
 
+  // Mapped register space of single compute unit, if any
+  std::once_flag reg_window_flag;
+  std::pair<uint32_t*, size_t> reg_window {nullptr, 0};
+
+  // CUs connected to memory group per (argument index, group index)
+  std::mutex connectivity_mutex;
+  std::map<std::pair<size_t, int32_t>, std::bitset<max_cus>> connectivity;
+
+  // Run objects of this kernel, for aborting all outstanding runs
+  std::mutex runs_mutex;
+  std::set<run_impl*> runs;
+
   // Compute data for FAST_ADAPTER descriptor use (see ert_fa.h)
   //
   // Compute argument descriptor entry offset and compute total
@@ -1290,6 +1915,31 @@ private:
       amend_ap_args();
   }
 
+  // Register space of the compute unit mapped into the process for
+  // batched access of count registers at offset, nullptr if the shim
+  // does not map the register space or the range is outside of it
+  volatile uint32_t*
+  get_reg_window(uint32_t offset, size_t count, bool force)
+  {
+    if (!has_reg_read_write())
+      return nullptr;
+
+    auto idx = get_cuidx_or_error(offset + (count - 1) * 4, force);
+    std::call_once(reg_window_flag, [this, idx] {
+      try {
+        reg_window = device->core_device->get_reg_window(idx);
+      }
+      catch (const std::exception&) {
+        // not supported by shim, access registers one at a time
+      }
+    });
+
+    if (!reg_window.first || offset + count * 4 > reg_window.second)
+      return nullptr;
+
+    return reg_window.first + offset / 4;
+  }
+
   unsigned int
   get_cuidx_or_error(size_t offset, bool force=false) const
   {
@@ -1408,16 +2058,20 @@ public:
     if (kernel_cus.empty())
       throw std::runtime_error("No compute units matching '" + nm + "'");
 
+    std::vector<std::pair<xrt::xclbin::ip, xrt_core::cuidx_type>> cus;
     for (const auto& cu : kernel_cus) {
       if (cu.get_control_type() == xrt::xclbin::ip::control_type::none)
         throw xrt_core::error(ENOTSUP, "AP_CTRL_NONE is only supported by XRT native API xrt::ip");
 
       auto cuidx = device->core_device->get_cuidx(cu.get_name(), xclbin_id);
-      ipctxs.emplace_back(ip_context::open(device->get_core_device(), xclbin, cu, cuidx, am));
+      cus.emplace_back(cu, cuidx);
       cumask.set(cuidx.domain_index);
       num_cumasks = std::max<size_t>(num_cumasks, (cuidx.domain_index / cus_per_word) + 1);
     }
 
+    // contexts of all compute units are acquired together
+    ipctxs = ip_context::open(device->get_core_device(), xclbin, cus, am);
+
     // set kernel protocol
     protocol = get_ip_control(kernel_cus);
 
@@ -1430,6 +2084,8 @@ public:
 
     // amend args with computed data based on kernel protocol
     amend_args();
+
+    XRT_USDT(kernel_construct, this, name.c_str());
   }
 
   ~kernel_impl()
@@ -1460,6 +2116,12 @@ public:
     return properties.counted_auto_restart;
   }
 
+  size_t
+  get_auto_restart_counter_offset() const
+  {
+    return properties.auto_restart_counter_offset;
+  }
+
   kernel_type
   get_kernel_type() const
   {
@@ -1488,27 +2150,90 @@ public:
     return name;
   }
 
-  const std::bitset<max_cus>&
-  get_cumask() const
+  // Track run objects of this kernel
+  void
+  add_run(run_impl* run)
   {
-    return cumask;
+    std::lock_guard<std::mutex> lk(runs_mutex);
+    runs.insert(run);
   }
 
-  size_t
-  get_num_cumasks() const
+  void
+  remove_run(run_impl* run)
   {
-    return num_cumasks;
+    std::lock_guard<std::mutex> lk(runs_mutex);
+    runs.erase(run);
   }
 
-  const std::vector<ipctx>&
-  get_ips() const
+  // Call fcn on each run object of this kernel while runs cannot be
+  // added or removed
+  template <typename Function>
+  void
+  for_each_run(Function&& fcn)
   {
-    return ipctxs;
+    std::lock_guard<std::mutex> lk(runs_mutex);
+    for (auto run : runs)
+      fcn(run);
   }
 
-  control_type
-  get_ip_control_protocol() const
-  {
+  const std::bitset<max_cus>&
+  get_cumask() const
+  {
+    return cumask;
+  }
+
+  // Compute units of this kernel with argument at argidx connected
+  // to memory group grpidx.  Computed once per argument and group,
+  // such that repeated binding of buffers does not check every
+  // compute unit's connectivity again.
+  const std::bitset<max_cus>&
+  get_arg_connectivity(size_t argidx, int32_t grpidx)
+  {
+    std::lock_guard<std::mutex> lk(connectivity_mutex);
+    auto key = std::make_pair(argidx, grpidx);
+    auto itr = connectivity.find(key);
+    if (itr != connectivity.end())
+      return itr->second;
+
+    std::bitset<max_cus> connected;
+    for (const auto& ip : ipctxs)
+      if (ip->valid_connection(argidx, grpidx))
+        connected.set(ip->get_cuidx());
+    return connectivity.emplace(key, connected).first->second;
+  }
+
+  size_t
+  get_num_cumasks() const
+  {
+    return num_cumasks;
+  }
+
+  // Number of 4 byte words in the CU register map
+  size_t
+  get_regmap_size() const
+  {
+    return regmap_size;
+  }
+
+  // Bytes required by a start kernel command packet including
+  // space for command state timestamps
+  size_t
+  get_exec_buf_size() const
+  {
+    auto pkt_size = (1 + num_cumasks + regmap_size) * sizeof(uint32_t);  // +1 for header
+    auto aligned = (pkt_size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    return aligned + sizeof(cu_cmd_state_timestamps) + sizeof(uint64_t); // + deadline
+  }
+
+  const std::vector<ipctx>&
+  get_ips() const
+  {
+    return ipctxs;
+  }
+
+  control_type
+  get_ip_control_protocol() const
+  {
     return protocol;
   }
 
@@ -1562,6 +2287,21 @@ public:
   void
   read_register_n(uint32_t offset, size_t count, uint32_t* out)
   {
+    if (!count)
+      return;
+
+    if (auto window = get_reg_window(offset, count, true)) {
+      for (size_t n = 0; n < count; ++n)
+        out[n] = window[n];
+      return;
+    }
+
+    if (!has_reg_read_write()) {
+      get_cuidx_or_error(offset + (count - 1) * 4, true);
+      device->core_device->xread(XCL_ADDR_KERNEL_CTRL, ipctxs.back()->get_address() + offset, out, count * 4);
+      return;
+    }
+
     for (size_t n = 0; n < count; ++n)
       out[n] = read_register(offset + n * 4, true);
   }
@@ -1570,6 +2310,21 @@ public:
   void
   write_register_n(uint32_t offset, size_t count, uint32_t* data)
   {
+    if (!count)
+      return;
+
+    if (auto window = get_reg_window(offset, count, false)) {
+      for (size_t n = 0; n < count; ++n)
+        window[n] = data[n];
+      return;
+    }
+
+    if (!has_reg_read_write()) {
+      get_cuidx_or_error(offset + (count - 1) * 4);
+      device->core_device->xwrite(XCL_ADDR_KERNEL_CTRL, ipctxs.back()->get_address() + offset, data, count * 4);
+      return;
+    }
+
     for (size_t n = 0; n < count; ++n)
       write_register(offset + n * 4, *(data + n));
   }
@@ -1612,6 +2367,7 @@ public:
 class run_impl
 {
   friend class mailbox_impl;
+  friend class direct_impl;
   using ipctx = std::shared_ptr<ip_context>;
   using control_type = kernel_impl::control_type;
   using kernel_type = kernel_impl::kernel_type;
@@ -1772,37 +2528,51 @@ class run_impl
   bool
   validate_ip_arg_connectivity(size_t argidx, int32_t grpidx)
   {
-    // remove ips that don't meet requested connectivity
-    auto itr = std::remove_if(ips.begin(), ips.end(),
-                   [argidx, grpidx] (const auto& ip) {
-                     return !ip->valid_connection(argidx, grpidx);
-                   });
+    // cumask has the cus of the ips controlled by this run
+    const auto& connected = kernel->get_arg_connectivity(argidx, grpidx);
+    auto remaining = cumask & connected;
 
     // if no ips are left then error
-    if (itr == ips.begin())
+    if (remaining.none())
       return false;
 
     // no ips were removed
-    if (itr == ips.end())
+    if (remaining == cumask)
       return true;
 
-    // update the cumask to set remaining cus, note that removed
-    // cus, while not erased, are no longer valid per move sematics
-    cumask.reset();
-    std::for_each(ips.begin(), itr, [this](const auto& ip) { cumask.set(ip->get_cuidx()); });
+    // remove ips that don't meet requested connectivity
+    auto itr = std::remove_if(ips.begin(), ips.end(),
+                   [&connected] (const auto& ip) {
+                     return !connected.test(ip->get_cuidx());
+                   });
 
     // erase the removed ips and mark that CUs must be
     // encoded in command packet.
     ips.erase(itr,ips.end());
+    cumask = remaining;
     encode_cumasks = true;
     return true;
   }
 
+  // With Runtime.trusted_arg_connectivity, a buffer that was
+  // validated for an argument of this run is not validated again.
+  // Connectivity filtering only ever removes ips, so the ips of the
+  // run remain valid for the buffer, unless the buffer is freed and
+  // another buffer in a different bank reuses its handle.
   xrt::bo
   validate_bo_at_index(size_t index, const xrt::bo& bo)
   {
-    if (validate_ip_arg_connectivity(index, xrt_core::bo::group_id(bo)))
+    static bool trusted = xrt_core::config::get_trusted_arg_connectivity();
+    auto entry = std::make_pair(index, static_cast<const void*>(bo.get_handle().get()));
+    if (trusted && std::find(trusted_bos.begin(), trusted_bos.end(), entry) != trusted_bos.end())
+      return bo;
+
+    if (validate_ip_arg_connectivity(index, xrt_core::bo::group_id(bo))) {
+      constexpr size_t max_trusted_bos = 64;
+      if (trusted && trusted_bos.size() < max_trusted_bos)
+        trusted_bos.push_back(entry);
       return bo;
+    }
 
     auto fmt = boost::format
       ("Kernel %s has no compute units with connectivity required for global argument at index %d. "
@@ -1825,6 +2595,8 @@ class run_impl
     auto rhs_pkt = rhs->cmd->get_ert_packet();
     pkt->header = rhs_pkt->header;
     pkt->state = ERT_CMD_STATE_NEW;
+    reinterpret_cast<ert_start_kernel_cmd*>(pkt)->stat_enabled = 0; // timestamps are per run
+    reinterpret_cast<ert_start_kernel_cmd*>(pkt)->deadline = 0;     // deadlines are per start
     std::copy_n(rhs_pkt->data, rhs_pkt->count, pkt->data);
     return pkt->data + (rhs->data - rhs_pkt->data);
   }
@@ -1836,10 +2608,13 @@ class run_impl
   xrt_core::device* core_device;          // convenience, in scope of kernel
   std::shared_ptr<kernel_command> cmd;    // underlying command object
   std::shared_ptr<xrt::event_impl> event; // event based execution, nullptr otherwise
+  callback_function_type notify;          // one-shot completion notification, if any
+  uint64_t deadline = 0;                  // one-shot start deadline in ns, if any
   uint32_t* data;                         // command argument data payload @0x0
   uint32_t uid;                           // internal unique id for debug
   std::unique_ptr<arg_setter> asetter;    // helper to populate payload data
   bool encode_cumasks = false;            // indicate if cmd cumasks must be re-encoded
+  std::vector<std::pair<size_t, const void*>> trusted_bos; // validated (argidx, bo)
 
 public:
   uint32_t
@@ -1893,11 +2668,12 @@ public:
     , ips(kernel->get_ips())
     , cumask(kernel->get_cumask())
     , core_device(kernel->get_core_device())      // cache core device
-    , cmd(std::make_shared<kernel_command>(kernel->get_device()))
+    , cmd(std::make_shared<kernel_command>(kernel->get_device(), kernel->get_exec_buf_size()))
     , data(kernel->initialize_command(cmd.get())) // default encodes CUs
     , uid(create_uid())
   {
     XRT_DEBUGF("run_impl::run_impl(%d)\n" , uid);
+    kernel->add_run(this);
   }
 
   // Clones a run impl, so that the clone can be executed concurrently
@@ -1908,18 +2684,37 @@ public:
     , ips(rhs->ips)
     , cumask(rhs->cumask)
     , core_device(rhs->core_device)
-    , cmd(std::make_shared<kernel_command>(kernel->get_device()))
+    , cmd(std::make_shared<kernel_command>(kernel->get_device(), kernel->get_exec_buf_size()))
     , data(clone_command_data(rhs))
     , uid(create_uid())
     , encode_cumasks(rhs->encode_cumasks)
   {
     XRT_DEBUGF("run_impl::run_impl(%d)\n" , uid);
+    kernel->add_run(this);
+  }
+
+  // Derives a run impl from a run template.  The command packet is
+  // copied to host memory and the exec buffer is allocated when the
+  // run is first started.
+  run_impl(const run_impl* rhs, kernel_command::deferred_type tag)
+    : kernel(rhs->kernel)
+    , ips(rhs->ips)
+    , cumask(rhs->cumask)
+    , core_device(rhs->core_device)
+    , cmd(std::make_shared<kernel_command>(kernel->get_device(), kernel->get_exec_buf_size(), tag))
+    , data(clone_command_data(rhs))
+    , uid(create_uid())
+    , encode_cumasks(rhs->encode_cumasks)
+  {
+    XRT_DEBUGF("run_impl::run_impl(%d) deferred\n" , uid);
+    kernel->add_run(this);
   }
 
   virtual
   ~run_impl()
   {
     XRT_DEBUGF("run_impl::~run_impl(%d)\n" , uid);
+    kernel->remove_run(this);
   }
 
   run_impl(const run_impl&) = delete;
@@ -1971,6 +2766,13 @@ public:
     return cumask;
   }
 
+  // Argument data payload of command packet
+  uint32_t*
+  get_arg_data() const
+  {
+    return data;
+  }
+
   arg_range<uint8_t>
   get_arg_value(const argument& arg)
   {
@@ -2064,6 +2866,20 @@ public:
     throw xrt_core::error(EINVAL, "No such kernel argument '" + argnm + "'");
   }
 
+  // Allocate the exec buffer of a run derived from a template and
+  // rebase the argument payload into the exec buffer
+  void
+  materialize()
+  {
+    auto shadow = cmd->materialize();
+    if (!shadow)
+      return;
+
+    data = cmd->get_ert_packet()->data + (data - shadow->data);
+    asetter.reset();  // refers to old payload
+    cmd->release_shadow();
+  }
+
   // If this run object's cus were filtered compared to kernel cus
   // then update the command packet encoded cus.
   void
@@ -2076,19 +2892,68 @@ public:
     encode_cumasks = false;
   }
 
-  // start() - start the run object (execbuf)
-  virtual void
-  start()
-  {
+  // prepare_start() - prepare the run object for submission
+  //
+  // Encodes compute units and marks the underlying command as
+  // running.  Returns true if the command must be managed by the
+  // scheduler.  The prepared command must be submitted either using
+  // start() or as part of a runlist.
+  virtual bool
+  prepare_start()
+  {
+    materialize();
     encode_compute_units();
+    cmd->set_deadline(deadline);
+    deadline = 0;
 
     auto pkt = cmd->get_ert_packet();
     pkt->state = ERT_CMD_STATE_NEW;
 
     XRT_DEBUG_CALL(debug_cmd_packet(kernel->get_name(), pkt));
 
-    cmd->run(event);
+    auto managed = cmd->prepare_run(event, std::move(notify));
     event.reset();
+    notify = nullptr;
+    return managed;
+  }
+
+  // start() - start the run object (execbuf)
+  virtual void
+  start()
+  {
+    auto managed = prepare_start();
+    XRT_USDT(run_start, static_cast<xrt_core::command*>(cmd.get()), cmd->get_exec_bo());
+    cmd->submit(managed);
+  }
+
+  // start() - start the run object with one-shot notification
+  //
+  // @fcn: function called once when this execution completes
+  //
+  // The notification is called from XRT's completion path, it is
+  // not registered as a callback of the run object.
+  void
+  start(callback_function_type&& fcn)
+  {
+    notify = std::move(fcn);
+    try {
+      cmd->submit(prepare_start());
+    }
+    catch (...) {
+      notify = nullptr;
+      throw;
+    }
+  }
+
+  // start() - start the run object with a deadline
+  //
+  // @tp: time by which the command must be started on a CU
+  void
+  start(const std::chrono::steady_clock::time_point& tp)
+  {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    deadline = std::max<uint64_t>(ns, 1);
+    start();
   }
 
   void
@@ -2100,12 +2965,10 @@ public:
     if (!kernel->get_auto_restart_counters())
       throw xrt_core::error(ENOSYS, "No auto-restart counters found for kernel");
 
-    // TODO: find offset once in meta data
-    constexpr size_t counter_offset = 0x10;
     uint32_t value = iterations.iterations;
     if (!value)
       value = std::numeric_limits<uint32_t>::max();
-    set_offset_value(counter_offset, &value, sizeof(value));
+    set_offset_value(kernel->get_auto_restart_counter_offset(), &value, sizeof(value));
     start();
   }
 
@@ -2119,10 +2982,8 @@ public:
       throw xrt_core::error(ENOSYS, "Support for auto restart counters have not been implemented");
 
     // Clear AUTO_RESTART bit if set, then wait() for completion
-    // TODO: find offset once in meta data
-    constexpr size_t counter_offset = 0x10;
     uint32_t value = 0;
-    set_offset_value(counter_offset, &value, sizeof(value));
+    set_offset_value(kernel->get_auto_restart_counter_offset(), &value, sizeof(value));
     wait(std::chrono::milliseconds{0});
   }
 
@@ -2136,43 +2997,67 @@ public:
       return cmd->get_state();
     }
 
-    // create and populate abort command
-    auto abort_cmd = std::make_shared<kernel_command>(kernel->get_device());
-    auto abort_pkt = abort_cmd->get_ert_cmd<ert_abort_cmd*>();
-    abort_pkt->state = ERT_CMD_STATE_NEW;
-    abort_pkt->count = sizeof(abort_pkt->exec_bo_handle) / sizeof(uint32_t);
-    abort_pkt->opcode = ERT_ABORT;
-    abort_pkt->type = ERT_CTRL;
-    abort_pkt->exec_bo_handle = to_uint64_t(cmd->get_exec_bo());
-
-    // schedule abort command and wait for it to complete
-    abort_cmd->run();
-    abort_cmd->wait();
-
-    // wait for current run command to be aborted, return cmd status
-    return cmd->wait();
+    // schedule abort command and wait for current run command to
+    // be aborted, return cmd status
+    return abort_commands(kernel->get_device(), {cmd.get()}).front();
   }
 
   // wait() - wait for execution to complete
-  ert_cmd_state
+  virtual ert_cmd_state
   wait(const std::chrono::milliseconds& timeout_ms) const
   {
     return timeout_ms.count() ? cmd->wait(timeout_ms) : cmd->wait();
   }
 
   // state() - get current execution state
-  ert_cmd_state
+  virtual ert_cmd_state
   state() const
   {
     auto pkt = cmd->get_ert_packet();
     return static_cast<ert_cmd_state>(pkt->state);
   }
 
+  void
+  enable_timestamps(bool enable)
+  {
+    cmd->enable_timestamps(enable);
+  }
+
+  xrt::run::timestamps
+  get_timestamps() const
+  {
+    return cmd->get_timestamps();
+  }
+
+  void
+  set_priority(xrt::run::priority_type priority)
+  {
+    cmd->set_priority(priority);
+  }
+
   ert_packet*
   get_ert_packet() const
   {
     return cmd->get_ert_packet();
   }
+
+  kernel_command*
+  get_command() const
+  {
+    return cmd.get();
+  }
+
+  const std::shared_ptr<kernel_command>&
+  get_shared_command() const
+  {
+    return cmd;
+  }
+
+  xrt_core::device*
+  get_core_device() const
+  {
+    return core_device;
+  }
 };
 
 // class mailbox_impl - Extension of run_impl for mailbox support
@@ -2209,6 +3094,7 @@ class mailbox_impl : public run_impl
 
       // write single 4 byte value to mailbox 
       mbox->mailbox_wait();
+      mbox->m_read_valid = false;
       mbox->kernel->write_register(offset, *(data32 + offset / wsize));
     }
 
@@ -2220,6 +3106,7 @@ class mailbox_impl : public run_impl
       // write argument value to mailbox
       // arg size is always a multiple of 4 bytes
       mbox->mailbox_wait();
+      mbox->m_read_valid = false;
       mbox->kernel->write_register_n(arg.offset(), arg.size() / wsize, data32 + arg.offset() / wsize);
     }
 
@@ -2228,8 +3115,10 @@ class mailbox_impl : public run_impl
     {
       // read arg size bytes from mailbox at arg offset
       // arg size is alwaus a multiple of 4 bytes
+      // all args are already read by a completed async_read()
       mbox->mailbox_wait();
-      mbox->kernel->read_register_n(arg.offset(), arg.size() / wsize, data32 + arg.offset() / wsize);
+      if (!mbox->m_read_valid)
+        mbox->kernel->read_register_n(arg.offset(), arg.size() / wsize, data32 + arg.offset() / wsize);
       return run_impl::hs_arg_setter::get_arg_value(arg);
     }
   };
@@ -2279,10 +3168,118 @@ class mailbox_impl : public run_impl
       throw xrt_core::system_error(EPERM, "Mailbox is write-only");
   }
 
+  // Wait for mailbox to become idle from async worker, backing off
+  // rather than spinning since an auto restart kernel may not update
+  // the mailbox until its next iteration
+  void
+  mailbox_wait_async()
+  {
+    auto backoff = std::chrono::microseconds(1);
+    while (m_busy) {
+      poll();
+      if (!m_busy)
+        break;
+      std::this_thread::sleep_for(backoff);
+      backoff = std::min(backoff * 2, std::chrono::microseconds(128));
+    }
+  }
+
+  // Range of argument registers in words
+  std::pair<size_t, size_t>
+  arg_words() const
+  {
+    size_t lo = SIZE_MAX;
+    size_t hi = 0;
+    for (const auto& arg : kernel->get_args()) {
+      lo = std::min(lo, arg.offset() / wsize);
+      hi = std::max(hi, (arg.offset() + arg.size() + wsize - 1) / wsize);
+    }
+    return {lo, hi};
+  }
+
+  // Host copies of mailbox, initialized from command payload.
+  // Called with m_stage_mutex locked.
+  void
+  init_stage()
+  {
+    if (!m_stage[0].empty())
+      return;
+
+    m_stage[0].assign(data, data + kernel->get_regmap_size());
+    m_stage[1] = m_stage[0];
+  }
+
+  void
+  async_worker()
+  {
+    std::unique_lock<std::mutex> lk(m_async_mutex);
+    while (true) {
+      m_async_cv.wait(lk, [this] { return m_async_stop || !m_async_ops.empty(); });
+      if (m_async_ops.empty())
+        return;
+
+      auto op = std::move(m_async_ops.front());
+      m_async_ops.pop_front();
+      lk.unlock();
+      op();
+      lk.lock();
+    }
+  }
+
+  // Execute op in order on the async worker and return an event that
+  // is complete when op is done
+  template <typename Callable>
+  xrt::sync_event
+  async_dispatch(Callable&& op)
+  {
+    auto promise = std::make_shared<std::promise<void>>();
+    std::shared_future<void> result = promise->get_future();
+    auto ev = xrt_core::enqueue::create_event();
+
+    auto task = [promise, evp = ev.get_impl(), op = std::forward<Callable>(op)] {
+      try {
+        op();
+        promise->set_value();
+      }
+      catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+      xrt_core::enqueue::done(evp.get());
+    };
+
+    std::lock_guard<std::mutex> lk(m_async_mutex);
+    if (!m_async_worker.joinable())
+      m_async_worker = xrt_core::thread(xrt_core::thread_class::general, &mailbox_impl::async_worker, this);
+    m_async_ops.push_back(std::move(task));
+    m_async_cv.notify_one();
+    return {std::move(ev), std::move(result)};
+  }
+
+  static constexpr size_t wsize = sizeof(uint32_t);  // register word size
+
   uint32_t m_ctrlreg = 0;   // last CU ctrl reg read
   bool m_busy = false;      // true after initiating write() or read()
   bool m_readonly = false;    // 
   bool m_writeonly = false;   // 
+  bool m_read_valid = false;  // args read by async_read() since last update
+
+  // Asynchronous operations, executed in order by worker thread
+  std::mutex m_async_mutex;
+  std::condition_variable m_async_cv;
+  std::deque<std::function<void()>> m_async_ops;
+  std::thread m_async_worker;
+  bool m_async_stop = false;
+
+  // Double buffered host copy of mailbox.  Arguments are staged in
+  // the front buffer while the back buffer is written to the mailbox
+  // by a pending async_write()
+  std::mutex m_stage_mutex;
+  std::condition_variable m_stage_cv;
+  std::array<std::vector<uint32_t>, 2> m_stage;
+  size_t m_front = 0;
+  size_t m_dirty_lo = SIZE_MAX;  // staged words [lo, hi)
+  size_t m_dirty_hi = 0;
+  bool m_back_busy = false;
 
 public:
   explicit
@@ -2296,6 +3293,109 @@ public:
     m_writeonly = (mtype == mailbox_type::in);
   }
 
+  ~mailbox_impl() override
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_async_mutex);
+      m_async_stop = true;
+    }
+    m_async_cv.notify_all();
+    if (m_async_worker.joinable())
+      m_async_worker.join();
+  }
+
+  mailbox_impl(const mailbox_impl&) = delete;
+  mailbox_impl(mailbox_impl&&) = delete;
+  mailbox_impl& operator=(mailbox_impl&) = delete;
+  mailbox_impl& operator=(mailbox_impl&&) = delete;
+
+  // stage argument value in front buffer
+  void
+  stage_arg_at_index(int index, const void* value, size_t bytes)
+  {
+    mailbox_writeable_or_error();
+    auto& arg = kernel->get_arg(index);
+    std::lock_guard<std::mutex> lk(m_stage_mutex);
+    init_stage();
+    auto front = reinterpret_cast<uint8_t*>(m_stage[m_front].data());
+    std::memcpy(front + arg.offset(), value, std::min(arg.size(), bytes));
+    m_dirty_lo = std::min(m_dirty_lo, arg.offset() / wsize);
+    m_dirty_hi = std::max(m_dirty_hi, (arg.offset() + arg.size() + wsize - 1) / wsize);
+  }
+
+  void
+  stage_arg_at_index(int index, const xrt::bo& bo)
+  {
+    if (!validate_ip_arg_connectivity(index, xrt_core::bo::group_id(bo)))
+      throw xrt_core::error(EINVAL, "Buffer is not connected to compute unit for argument " + std::to_string(index));
+    auto value = bo.address();
+    stage_arg_at_index(index, &value, sizeof(value));
+  }
+
+  // write staged arguments to hw, then request kernel to copy mailbox
+  xrt::sync_event
+  async_write()
+  {
+    mailbox_writeable_or_error();
+    std::unique_lock<std::mutex> lk(m_stage_mutex);
+    init_stage();
+    m_stage_cv.wait(lk, [this] { return !m_back_busy; });
+
+    // swap buffers, staging continues from the snapshot
+    auto back = m_front;
+    auto lo = m_dirty_lo;
+    auto hi = m_dirty_hi;
+    m_front ^= 1;
+    m_stage[m_front] = m_stage[back];
+    m_dirty_lo = SIZE_MAX;
+    m_dirty_hi = 0;
+    m_back_busy = true;
+    lk.unlock();
+
+    return async_dispatch([this, back, lo, hi] {
+      auto release = [this] {
+        std::lock_guard<std::mutex> lk(m_stage_mutex);
+        m_back_busy = false;
+        m_stage_cv.notify_all();
+      };
+
+      try {
+        mailbox_wait_async();
+        if (lo < hi)
+          kernel->write_register_n(static_cast<uint32_t>(lo * wsize), hi - lo, m_stage[back].data() + lo);
+      }
+      catch (...) {
+        release();
+        throw;
+      }
+      release();
+
+      kernel->write_register(0x0, m_ctrlreg | MAILBOX_INPUT_CTRL);
+      m_busy = true;
+      m_read_valid = false;
+      mailbox_wait_async();
+    });
+  }
+
+  // request kernel to update mailbox, then read all arguments
+  xrt::sync_event
+  async_read()
+  {
+    mailbox_readable_or_error();
+    return async_dispatch([this] {
+      m_read_valid = false;
+      mailbox_wait_async();
+      kernel->write_register(0x0, m_ctrlreg | MAILBOX_OUTPUT_CTRL);
+      m_busy = true;
+      mailbox_wait_async();
+
+      auto words = arg_words();
+      if (words.first < words.second)
+        kernel->read_register_n(static_cast<uint32_t>(words.first * wsize), words.second - words.first, data + words.first);
+      m_read_valid = true;
+    });
+  }
+
   // write mailbox to hw
   void
   write()
@@ -2304,6 +3404,7 @@ public:
     mailbox_idle_or_error();
     kernel->write_register(0x0, m_ctrlreg | MAILBOX_INPUT_CTRL);
     m_busy = true;
+    m_read_valid = false;
   }
 
   // read hw to mailbox
@@ -2314,6 +3415,7 @@ public:
     mailbox_idle_or_error();
     kernel->write_register(0x0, m_ctrlreg | MAILBOX_OUTPUT_CTRL);
     m_busy = true;
+    m_read_valid = false;
   }
 
   // blocking read directly from mailbox
@@ -2344,8 +3446,8 @@ public:
     throw xrt_core::error("Mailbox not supported for non pl kernel types");
   }
 
-  void
-  start() override
+  bool
+  prepare_start() override
   {
     // sync command payload to mailbox if necessary
     write();
@@ -2356,7 +3458,299 @@ public:
     pkt->count = kernel->get_num_cumasks() + ap_ctrl_reserved;
 
     // Regular start
-    run_impl::start();
+    return run_impl::prepare_start();
+  }
+};
+
+// class direct_impl - Extension of run_impl for direct CU start
+//
+// Used when Runtime.direct_cu_start is enabled for a PL kernel with
+// a single AP_CTRL_HS, AP_CTRL_CHAIN, or FAST_ADAPTER compute unit
+// opened in exclusive mode.  The compute unit is handed over to user
+// space, the kernel driver only manages its ownership.  The run
+// writes the command payload to the CU register map, starts the CU,
+// and polls the CU control register for completion, such that no
+// command goes through the scheduler in the kernel driver.
+//
+// A FAST_ADAPTER run writes its descriptor to the descriptor ring of
+// the CU (see fa_ring) and polls the CU task count for completion.
+//
+// Completion callbacks, events, and runlists require the scheduler and
+// are not supported.
+class direct_impl : public run_impl
+{
+  static constexpr uint32_t ap_start = 0x1;
+  static constexpr uint32_t ap_done = 0x2;
+  static constexpr uint32_t ap_idle = 0x4;
+  static constexpr uint32_t ap_continue = 0x10;
+  static constexpr size_t ap_ctrl_reserved = 4; // control registers
+
+  [[noreturn]] static void
+  not_supported()
+  {
+    throw xrt_core::error(ENOTSUP, "Callbacks, events, and runlists are not supported with Runtime.direct_cu_start");
+  }
+
+  uint64_t fa_seq = 0; // sequence number of started fa descriptor
+
+  // Read CU control register once, complete the run if CU is done.
+  // Reading the control register clears AP_DONE.
+  bool
+  poll() const
+  {
+    if (auto fa = ips.front()->get_fa_ring()) {
+      if (!fa->done(fa_seq))
+        return false;
+    }
+    else {
+      auto ctrlreg = kernel->read_register(0x0);
+      if (!(ctrlreg & (ap_done | ap_idle)))
+        return false;
+
+      if (kernel->get_ip_control_protocol() == control_type::chain)
+        kernel->write_register(0x0, ap_continue);
+    }
+
+    get_ert_packet()->state = ERT_CMD_STATE_COMPLETED;
+    cmd->notify(ERT_CMD_STATE_COMPLETED);
+    return true;
+  }
+
+public:
+  explicit
+  direct_impl(const std::shared_ptr<kernel_impl>& k)
+    : run_impl(k)
+  {
+    ips.front()->open_user_managed();
+  }
+
+  // Clone of a direct run, the compute unit is already user managed
+  explicit
+  direct_impl(const direct_impl* rhs)
+    : run_impl(rhs)
+  {}
+
+  // Derived from a run template, a direct run never submits its
+  // command so the exec buffer is never allocated
+  direct_impl(const direct_impl* rhs, kernel_command::deferred_type tag)
+    : run_impl(rhs, tag)
+  {}
+
+  // Check if a kernel qualifies for direct CU start
+  static bool
+  enabled(const kernel_impl* k)
+  {
+    if (!xrt_core::config::get_direct_cu_start() || !has_reg_read_write())
+      return false;
+
+    auto protocol = k->get_ip_control_protocol();
+    const auto& ips = k->get_ips();
+    if (k->get_kernel_type() != kernel_type::pl
+        || ips.size() != 1
+        || ips.front()->get_access_mode() != ip_context::access_mode::exclusive)
+      return false;
+
+    // Fast adapter requires descriptor slots mapped from the driver
+    if (protocol == control_type::fa)
+      return ips.front()->open_fa_ring(k->get_regmap_size() * sizeof(uint32_t));
+
+    return (protocol == control_type::hs || protocol == control_type::chain);
+  }
+
+  ////////////////////////////////////////////////////////////////
+  // xrt::run_impl overrides
+  ////////////////////////////////////////////////////////////////
+  bool
+  prepare_start() override
+  {
+    not_supported();
+  }
+
+  void
+  start() override
+  {
+    if (cmd->prepare_run(event)) {
+      cmd->unprepare_run();
+      not_supported();
+    }
+    event.reset();
+
+    auto pkt = get_ert_packet();
+    pkt->state = ERT_CMD_STATE_RUNNING;
+
+    auto regmap_size = kernel->get_regmap_size();
+    if (auto fa = ips.front()->get_fa_ring()) {
+      fa_seq = fa->start(data, regmap_size);
+      return;
+    }
+
+    constexpr size_t wsize = sizeof(uint32_t);
+    kernel->write_register_n(ap_ctrl_reserved * wsize, regmap_size - ap_ctrl_reserved, data + ap_ctrl_reserved);
+    kernel->write_register(0x0, ap_start);
+  }
+
+  ert_cmd_state
+  wait(const std::chrono::milliseconds& timeout_ms) const override
+  {
+    auto end = std::chrono::steady_clock::now() + timeout_ms;
+    while (!cmd->is_done() && !poll()) {
+      if (timeout_ms.count() && std::chrono::steady_clock::now() > end)
+        return ERT_CMD_STATE_TIMEOUT;
+      std::this_thread::yield();
+    }
+
+    return state();
+  }
+
+  ert_cmd_state
+  state() const override
+  {
+    if (!cmd->is_done())
+      poll();
+    return run_impl::state();
+  }
+};
+
+// class run_template_impl - Snapshot of a run object
+//
+// The snapshot is itself a deferred run that is never started, so
+// neither the template nor runs created from it allocate an exec
+// buffer until a created run is started.
+class run_template_impl
+{
+  std::shared_ptr<run_impl> m_proto;
+
+  static std::shared_ptr<run_impl>
+  derive(const run_impl* rimpl)
+  {
+    if (auto direct = dynamic_cast<const direct_impl*>(rimpl))
+      return std::make_shared<direct_impl>(direct, kernel_command::deferred);
+
+    return std::make_shared<run_impl>(rimpl, kernel_command::deferred);
+  }
+
+public:
+  explicit
+  run_template_impl(const xrt::run& run)
+    : m_proto(derive(run.get_handle().get()))
+  {}
+
+  xrt::run
+  create() const
+  {
+    return xrt::run{derive(m_proto.get())};
+  }
+};
+
+// class runlist_impl - A list of run objects submitted together
+//
+// The run objects are prepared individually and then submitted to
+// the scheduler as one batch, such that the shim is called once and
+// the command monitor is woken up once per batch rather than once
+// per run.  All run objects must be for the same device.
+class runlist_impl
+{
+  xrt_core::device* m_core_device;
+  std::vector<xrt::run> m_runs;
+
+  // Scratch lists of commands, reused between executions to avoid
+  // heap allocation on the execution path.
+  std::vector<xrt_core::command*> m_managed;
+  std::vector<xrt_core::command*> m_unmanaged;
+
+  bool m_submitted = false;
+
+public:
+  explicit
+  runlist_impl(const xrt::device& device)
+    : m_core_device(device.get_handle().get())
+  {}
+
+  void
+  add(xrt::run run)
+  {
+    if (m_submitted)
+      throw xrt_core::error(EBUSY, "Cannot add run object to runlist while runlist is executing");
+
+    const auto& rimpl = run.get_handle();
+    if (!rimpl)
+      throw xrt_core::error(EINVAL, "Cannot add empty run object to runlist");
+
+    if (rimpl->get_core_device() != m_core_device)
+      throw xrt_core::error(EINVAL, "Run object device does not match runlist device");
+
+    m_runs.push_back(std::move(run));
+  }
+
+  void
+  execute()
+  {
+    if (m_submitted)
+      throw xrt_core::error(EBUSY, "Runlist is already executing");
+
+    m_managed.clear();
+    m_unmanaged.clear();
+    try {
+      for (const auto& run : m_runs) {
+        const auto& rimpl = run.get_handle();
+        auto& cmds = rimpl->prepare_start() ? m_managed : m_unmanaged;
+        cmds.push_back(rimpl->get_command());
+      }
+    }
+    catch (...) {
+      // Revert runs that were prepared prior to the failure
+      for (auto cmd : m_managed)
+        static_cast<kernel_command*>(cmd)->unprepare_run();
+      for (auto cmd : m_unmanaged)
+        static_cast<kernel_command*>(cmd)->unprepare_run();
+      throw;
+    }
+
+    m_submitted = true;
+    xrt_core::exec::managed_start(m_managed);
+    xrt_core::exec::unmanaged_start(m_unmanaged);
+  }
+
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout_ms)
+  {
+    if (!m_submitted)
+      return std::cv_status::no_timeout;
+
+    if (!timeout_ms.count()) {
+      for (const auto& run : m_runs)
+        run.wait();
+      m_submitted = false;
+      return std::cv_status::no_timeout;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout_ms;
+    for (const auto& run : m_runs) {
+      auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>
+        (deadline - std::chrono::steady_clock::now());
+      if (remaining.count() <= 0)
+        remaining = 1ms;
+      if (run.wait(remaining) == ERT_CMD_STATE_TIMEOUT)
+        return std::cv_status::timeout;
+    }
+
+    m_submitted = false;
+    return std::cv_status::no_timeout;
+  }
+
+  void
+  reset()
+  {
+    if (m_submitted)
+      throw xrt_core::error(EBUSY, "Cannot reset runlist while runlist is executing");
+
+    m_runs.clear();
+  }
+
+  size_t
+  size() const
+  {
+    return m_runs.size();
   }
 };
 
@@ -2567,18 +3961,86 @@ get_run_update(xrtRunHandle rhdl)
 static std::unique_ptr<xrt::run_impl>
 alloc_run(const std::shared_ptr<xrt::kernel_impl>& khdl)
 {
-  return khdl->has_mailbox()
-    ? std::make_unique<xrt::mailbox_impl>(khdl)
-    : std::make_unique<xrt::run_impl>(khdl);
+  if (khdl->has_mailbox())
+    return std::make_unique<xrt::mailbox_impl>(khdl);
+
+  if (xrt::direct_impl::enabled(khdl.get()))
+    return std::make_unique<xrt::direct_impl>(khdl);
+
+  return std::make_unique<xrt::run_impl>(khdl);
 }
 
+// Process wide cache of kernel objects.  Enabled when
+// Runtime.kernel_cache_size is non zero.  Construction of a kernel
+// object parses the kernel meta data and opens compute unit
+// contexts, which is costly for applications that create a kernel
+// object per request.  The cache shares ownership of the most
+// recently used kernel objects, so a kernel object constructed with
+// same device, xclbin, name, and access mode as a cached one is
+// simply shared.  Kernel objects have no per-instance mutable state,
+// all execution state is in run objects.
+class kernel_cache
+{
+  using key_type = std::tuple<xrt_core::device*, xrt::uuid, std::string, xrt::kernel::cu_access_mode>;
+  using entry_type = std::pair<key_type, std::shared_ptr<xrt::kernel_impl>>;
+
+  std::list<entry_type> m_entries;   // most recently used first
+  size_t m_max_size;
+  std::mutex m_mutex;
+
+public:
+  explicit
+  kernel_cache(size_t size)
+    : m_max_size(size)
+  {}
+
+  static kernel_cache*
+  get()
+  {
+    static size_t size = xrt_core::config::get_kernel_cache_size();
+    if (!size)
+      return nullptr;
+
+    static kernel_cache cache(size);
+    return &cache;
+  }
+
+  template <typename Allocator>
+  std::shared_ptr<xrt::kernel_impl>
+  get_or_alloc(key_type&& key, Allocator&& alloc)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto itr = std::find_if(m_entries.begin(), m_entries.end(),
+                            [&key](const auto& entry) { return entry.first == key; });
+    if (itr != m_entries.end()) {
+      m_entries.splice(m_entries.begin(), m_entries, itr);
+      return m_entries.front().second;
+    }
+
+    auto kernel = alloc();
+    m_entries.emplace_front(std::move(key), kernel);
+    if (m_entries.size() > m_max_size)
+      m_entries.pop_back();
+    return kernel;
+  }
+};
+
 static std::shared_ptr<xrt::kernel_impl>
 alloc_kernel(const std::shared_ptr<device_type>& dev,
 	     const xrt::uuid& xclbin_id,
 	     const std::string& name,
 	     xrt::kernel::cu_access_mode mode)
 {
-  return std::make_shared<xrt::kernel_impl>(dev, xclbin_id, name, mode) ;
+  // Kernel requires xclbin to be loaded, see xrt::load_xclbin_async
+  dev->get_core_device()->wait_pending_load();
+
+  auto cache = kernel_cache::get();
+  if (!cache)
+    return std::make_shared<xrt::kernel_impl>(dev, xclbin_id, name, mode);
+
+  return cache->get_or_alloc
+    ({dev->get_core_device(), xclbin_id, name, mode},
+     [&] { return std::make_shared<xrt::kernel_impl>(dev, xclbin_id, name, mode); });
 }
 
 static std::shared_ptr<xrt::mailbox_impl>
@@ -2722,7 +4184,11 @@ set_arg_at_index(const xrt::run& run, size_t idx, const void* value, size_t byte
 xrt::run
 clone(const xrt::run& run)
 {
-  return xrt::run{std::make_shared<xrt::run_impl>(run.get_handle().get())};
+  auto rimpl = run.get_handle().get();
+  if (auto direct = dynamic_cast<const xrt::direct_impl*>(rimpl))
+    return xrt::run{std::make_shared<xrt::direct_impl>(direct)};
+
+  return xrt::run{std::make_shared<xrt::run_impl>(rimpl)};
 }
 
 const std::bitset<max_cus>&
@@ -2743,6 +4209,12 @@ pop_callback(const xrt::run& run)
   run.get_handle()->pop_callback();
 }
 
+xrt_core::device*
+get_core_device(const xrt::run& run)
+{
+  return run.get_handle()->get_core_device();
+}
+
 xrt::xclbin::ip::control_type
 get_control_protocol(const xrt::run& run)
 {
@@ -2811,6 +4283,16 @@ start(const autostart& iterations)
   handle->start(iterations);
 }
 
+void
+run::
+start(const std::chrono::steady_clock::time_point& deadline)
+{
+  xdp::native::profiling_wrapper
+    ("xrt::run::start", [this, &deadline]{
+    handle->start(deadline);
+    });
+}
+
 void
 run::
 stop()
@@ -2825,6 +4307,31 @@ abort()
   return handle->abort();
 }
 
+std::vector<ert_cmd_state>
+run::
+abort(const std::vector<run>& runs)
+{
+  return xdp::native::profiling_wrapper("xrt::run::abort", [&runs] {
+    // abort commands per device on which they execute
+    std::map<std::shared_ptr<device_type>, std::vector<size_t>> devices;
+    for (size_t idx = 0; idx < runs.size(); ++idx)
+      devices[runs[idx].get_handle()->get_kernel()->get_device()].push_back(idx);
+
+    std::vector<ert_cmd_state> states(runs.size(), ERT_CMD_STATE_MAX);
+    for (const auto& [device, indices] : devices) {
+      std::vector<kernel_command*> cmds;
+      cmds.reserve(indices.size());
+      for (auto idx : indices)
+        cmds.push_back(runs[idx].get_handle()->get_command());
+
+      auto aborted = abort_commands(device, cmds);
+      for (size_t i = 0; i < indices.size(); ++i)
+        states[indices[i]] = aborted[i];
+    }
+    return states;
+  });
+}
+
 ert_cmd_state
 run::
 wait(const std::chrono::milliseconds& timeout_ms) const
@@ -2844,6 +4351,27 @@ state() const
   });
 }
 
+void
+run::
+enable_timestamps(bool enable)
+{
+  handle->enable_timestamps(enable);
+}
+
+run::timestamps
+run::
+get_timestamps() const
+{
+  return handle->get_timestamps();
+}
+
+void
+run::
+set_priority(priority_type priority)
+{
+  handle->set_priority(priority);
+}
+
 int
 run::
 get_arg_index(const std::string& argnm) const
@@ -2947,6 +4475,30 @@ write_register(uint32_t offset, uint32_t data)
   });
 }
 
+size_t
+kernel::
+abort_all()
+{
+  return xdp::native::profiling_wrapper("xrt::kernel::abort_all", [this]{
+    // share ownership of started commands, run objects may be
+    // destroyed while commands are aborted
+    std::vector<std::shared_ptr<kernel_command>> started;
+    handle->for_each_run([&started](run_impl* run) {
+      auto& cmd = run->get_shared_command();
+      if (!cmd->is_done())
+        started.push_back(cmd);
+    });
+
+    std::vector<kernel_command*> cmds;
+    cmds.reserve(started.size());
+    for (const auto& cmd : started)
+      cmds.push_back(cmd.get());
+
+    auto states = abort_commands(handle->get_device(), cmds);
+    return static_cast<size_t>(std::count(states.begin(), states.end(), ERT_CMD_STATE_ABORT));
+  });
+}
+
 
 int
 kernel::
@@ -3022,7 +4574,188 @@ set_arg_at_index(int index, const xrt::bo& glb)
   handle->set_arg_at_index(index, glb);
 }
 
+void
+mailbox::
+stage_arg_at_index(int index, const void* value, size_t bytes)
+{
+  handle->stage_arg_at_index(index, value, bytes);
+}
+
+void
+mailbox::
+stage_arg_at_index(int index, const xrt::bo& glb)
+{
+  handle->stage_arg_at_index(index, glb);
+}
+
+xrt::sync_event
+mailbox::
+async_write()
+{
+  return xdp::native::profiling_wrapper("xrt::mailbox::async_write", [this]{
+    return handle->async_write();
+  });
+}
+
+xrt::sync_event
+mailbox::
+async_read()
+{
+  return xdp::native::profiling_wrapper("xrt::mailbox::async_read", [this]{
+    return handle->async_read();
+  });
 }
+
+}
+////////////////////////////////////////////////////////////////
+// xrt_run_template C++ experimental API implmentations
+// see experimental/xrt_run_template.h
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+run_template::
+run_template(const xrt::run& run)
+  : detail::pimpl<run_template_impl>(std::make_shared<run_template_impl>(run))
+{}
+
+xrt::run
+run_template::
+create() const
+{
+  return xdp::native::profiling_wrapper("xrt::run_template::create", [this]{
+    return handle->create();
+  });
+}
+
+} // namespace xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_runlist C++ experimental API implmentations
+// see experimental/xrt_runlist.h
+////////////////////////////////////////////////////////////////
+namespace xrt {
+
+runlist::
+runlist(const xrt::device& device)
+  : detail::pimpl<runlist_impl>(std::make_shared<runlist_impl>(device))
+{}
+
+void
+runlist::
+add(const xrt::run& run)
+{
+  handle->add(run);
+}
+
+void
+runlist::
+execute()
+{
+  xdp::native::profiling_wrapper("xrt::runlist::execute", [this]{
+    handle->execute();
+  });
+}
+
+std::cv_status
+runlist::
+wait(const std::chrono::milliseconds& timeout_ms) const
+{
+  return xdp::native::profiling_wrapper("xrt::runlist::wait", [this, &timeout_ms]{
+    return handle->wait(timeout_ms);
+  });
+}
+
+void
+runlist::
+reset()
+{
+  handle->reset();
+}
+
+size_t
+runlist::
+size() const
+{
+  return handle->size();
+}
+
+} // xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_coro C++ experimental API implmentations
+// see experimental/xrt_coro.h
+////////////////////////////////////////////////////////////////
+namespace xrt { namespace coro { namespace detail {
+
+void
+start(const xrt::run& run, std::function<void(ert_cmd_state)> notify)
+{
+  xdp::native::profiling_wrapper("xrt::coro::start", [&run, &notify]{
+    run.get_handle()->start(std::move(notify));
+  });
+}
+
+void
+dispatch(std::function<void()> fcn)
+{
+  if (auto pool = callback_dispatch::get())
+    pool->dispatch(std::move(fcn));
+  else
+    fcn();
+}
+
+}}} // detail, coro, xrt
+
+////////////////////////////////////////////////////////////////
+// xrt_typed_kernel C++ experimental API implmentations
+// see experimental/xrt_typed_kernel.h
+////////////////////////////////////////////////////////////////
+namespace xrt { namespace detail { namespace typed_args {
+
+void
+get_offsets(const xrt::kernel& kernel, const arg_kind* kinds, const size_t* sizes,
+            size_t count, size_t* offsets)
+{
+  using xarg = xrt_core::xclbin::kernel_argument;
+  const auto& kimpl = kernel.get_handle();
+
+  if (kimpl->get_kernel_type() != kernel_impl::kernel_type::pl
+      || kimpl->get_ip_control_protocol() == kernel_impl::control_type::fa)
+    throw xrt_core::error(std::errc::not_supported,
+                          "Kernel " + kimpl->get_name() + " does not support typed arguments");
+
+  const auto& args = kimpl->get_args();
+  if (args.size() != count)
+    throw xrt_core::error(EINVAL, "Kernel " + kimpl->get_name() + " has " + std::to_string(args.size())
+                          + " arguments, typed signature has " + std::to_string(count));
+
+  for (size_t idx = 0; idx < count; ++idx) {
+    const auto& arg = args[idx];
+    arg.valid_or_error();
+
+    auto type = arg.type();
+    if (kinds[idx] == arg_kind::scalar && type != xarg::argtype::scalar)
+      throw xrt_core::error(EINVAL, "Typed argument " + std::to_string(idx) + " must be xrt::bo");
+
+    if (kinds[idx] == arg_kind::global && type != xarg::argtype::global && type != xarg::argtype::constant)
+      throw xrt_core::error(EINVAL, "Typed argument " + std::to_string(idx) + " must be scalar");
+
+    if (sizes[idx] != arg.size())
+      throw xrt_core::error(EINVAL, "Typed argument " + std::to_string(idx) + " has size "
+                            + std::to_string(sizes[idx]) + ", expected " + std::to_string(arg.size()));
+
+    offsets[idx] = arg.offset();
+  }
+}
+
+uint32_t*
+get_payload(const xrt::run& run)
+{
+  return run.get_handle()->get_arg_data();
+}
+
+}}} // typed_args, detail, xrt
+
 ////////////////////////////////////////////////////////////////
 // xrt_kernel API implmentations (xrt_kernel.h)
 ////////////////////////////////////////////////////////////////
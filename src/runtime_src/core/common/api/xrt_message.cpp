@@ -17,7 +17,7 @@ namespace detail {
 bool
 enabled(level lvl)
 {
-  return xrt_core::config::get_verbosity() >= static_cast<int>(lvl);
+  return xrt_core::config::get_snapshot().verbosity >= static_cast<unsigned int>(lvl);
 }
 
 } // detail
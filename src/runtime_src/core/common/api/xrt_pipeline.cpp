@@ -21,11 +21,16 @@
 #include "core/include/experimental/xrt_pipeline.h"
 
 #include "core/common/debug.h"
+#include "core/common/error.h"
+#include "core/common/time.h"
 
 #include <memory>
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 )
@@ -37,11 +42,128 @@ namespace {
 
 namespace xrt {
 
+// class pipeline_impl - insulated implementation of xrt::pipeline
+//
+// Each execution of the pipeline enqueues per stage a dispatch
+// marker, the stage itself, and a completion recorder.  The marker
+// depends on the previous stage and is what flow control attaches
+// dependencies to:
+//
+//  - markers of a stage depend on the marker of the previous
+//    execution, so executions are dispatched to a stage in order
+//  - with concurrency N, the marker of execution f depends on
+//    completion of the stage for execution f-N, which serializes
+//    executions f, f+N, f+2N, ... and bounds the stage to N
+//    concurrent executions
+//  - with capacity C of the next stage, the marker of execution f
+//    depends on the marker of the next stage for execution f-C,
+//    which bounds the executions between the two stages to C
+//
+// Capacity of the first stage is enforced by execute() which waits
+// for earlier executions to be dispatched.
+//
+// The marker and recorder callables are enqueued by reference, so
+// they are owned by a frame object that is retained until all its
+// callables have executed.
 class pipeline_impl : public std::enable_shared_from_this<pipeline_impl>
 {
+  struct frame
+  {
+    std::vector<std::function<void()>> tasks;  // markers and recorders
+    std::vector<unsigned long> dispatch_ns;    // per stage dispatch time
+    size_t remaining = 0;                      // stages not yet recorded
+  };
+
+  struct stage_state
+  {
+    size_t concurrency = 0;         // effective concurrency, 0 unbounded
+    size_t capacity = 0;            // capacity of queue in front of stage
+    std::deque<xrt::event> markers; // dispatch markers of past executions
+    std::deque<xrt::event> events;  // stage events of past executions
+    pipeline::stage_stats stats;
+    unsigned long first_ns = 0;     // time of first dispatch
+  };
+
   event_queue m_queue;
   unsigned long m_uid;
   std::vector<pipeline::stage> m_stages;
+  std::vector<pipeline::stage_options> m_options;
+  std::vector<stage_state> m_state;
+  std::deque<std::unique_ptr<frame>> m_frames;
+  uint64_t m_executions = 0;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  void
+  init_state()
+  {
+    m_options.resize(m_stages.size());
+    m_state.resize(m_stages.size());
+    for (size_t idx = 0; idx < m_stages.size(); ++idx) {
+      auto& st = m_state[idx];
+      auto instances = m_stages[idx].instances();
+      st.concurrency = m_options[idx].concurrency;
+      st.capacity = m_options[idx].capacity;
+      if (instances > 1) {
+        if (st.concurrency > instances)
+          throw xrt_core::error(EINVAL, "pipeline stage concurrency exceeds number of instances");
+        if (!st.concurrency)
+          st.concurrency = instances;
+      }
+    }
+  }
+
+  // Frames are released in order once all their callables executed
+  void
+  reap()
+  {
+    while (!m_frames.empty() && m_frames.front()->remaining == 0)
+      m_frames.pop_front();
+  }
+
+  void
+  dispatched(frame* fr, size_t idx)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto now = xrt_core::time_ns();
+    auto& st = m_state[idx];
+    fr->dispatch_ns[idx] = now;
+    if (!st.stats.dispatched++)
+      st.first_ns = now;
+    if (idx == 0)
+      m_cv.notify_all();
+  }
+
+  void
+  completed(frame* fr, size_t idx)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto now = xrt_core::time_ns();
+    auto& stats = m_state[idx].stats;
+    auto latency = now - fr->dispatch_ns[idx];
+    ++stats.completed;
+    stats.latency_ns += latency;
+    stats.max_latency_ns = std::max<uint64_t>(stats.max_latency_ns, latency);
+    stats.elapsed_ns = now - m_state[idx].first_ns;
+    if (--fr->remaining == 0)
+      m_cv.notify_all();
+  }
+
+  static void
+  retain(std::deque<xrt::event>& history, xrt::event ev, size_t depth)
+  {
+    history.push_back(std::move(ev));
+    while (history.size() > depth)
+      history.pop_front();
+  }
+
+  // Event of execution 'back' executions before the current one, or
+  // empty event if there is no such execution
+  static xrt::event
+  past(const std::deque<xrt::event>& history, size_t back)
+  {
+    return (back && history.size() >= back) ? history[history.size() - back] : xrt::event{};
+  }
 
 public:
   // Construct the pipeline implementation
@@ -53,23 +175,99 @@ public:
     XRT_DEBUGF("pipeline_impl::pipeline_impl(%d)\n", m_uid);
   }
 
-  // Event destructor added for debuggability.
+  // Destructor waits for enqueued callables owned by the pipeline
   ~pipeline_impl()
   {
     XRT_DEBUGF("pipeline_impl::~pipeline_impl(%d)\n", m_uid);
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_cv.wait(lk, [this] {
+      return std::all_of(m_frames.begin(), m_frames.end(), [](const auto& fr) { return fr->remaining == 0; });
+    });
   }
 
   xrt::event
-  execute(xrt::event event)
+  execute(xrt::event event, bool block)
   {
-    for (auto& s : m_stages)
-      event = s.enqueue(m_queue, {event});
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (m_stages.empty())
+      return event;
+
+    if (m_state.empty())
+      init_state();
+
+    reap();
+
+    // Backpressure when too many executions are not yet dispatched
+    // to the first stage
+    if (auto capacity = m_state[0].capacity) {
+      auto full = [this, capacity] { return m_executions - m_state[0].stats.dispatched >= capacity; };
+      if (full() && !block)
+        return {};
+      m_cv.wait(lk, [&full] { return !full(); });
+    }
+
+    auto nstages = m_stages.size();
+    auto fr = std::make_unique<frame>();
+    fr->tasks.reserve(2 * nstages); // callables are enqueued by reference
+    fr->dispatch_ns.resize(nstages);
+    fr->remaining = nstages;
+    auto frp = fr.get();
+    auto execution = m_executions++;
+
+    for (size_t idx = 0; idx < nstages; ++idx) {
+      auto& st = m_state[idx];
+      std::vector<xrt::event> deps;
+      for (auto& ev : {event
+                      , past(st.markers, 1)
+                      , past(st.events, st.concurrency)
+                      , idx + 1 < nstages ? past(m_state[idx + 1].markers, m_state[idx + 1].capacity) : xrt::event{}})
+        if (ev)
+          deps.push_back(ev);
+
+      fr->tasks.emplace_back([this, frp, idx] { dispatched(frp, idx); });
+      auto marker = m_queue.enqueue_with_waitlist(fr->tasks.back(), deps);
+
+      auto instance = st.concurrency ? execution % std::min(st.concurrency, m_stages[idx].instances()) : 0;
+      event = m_stages[idx].enqueue(m_queue, {marker}, instance);
+
+      fr->tasks.emplace_back([this, frp, idx] { completed(frp, idx); });
+      m_queue.enqueue_with_waitlist(fr->tasks.back(), {event});
+
+      retain(st.markers, std::move(marker), std::max<size_t>(st.capacity, 1));
+      retain(st.events, event, st.concurrency);
+    }
+
+    m_frames.push_back(std::move(fr));
     return event;
   }
 
+  void
+  set_stage_options(size_t idx, const pipeline::stage_options& opts)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (idx >= m_stages.size())
+      throw xrt_core::error(EINVAL, "pipeline stage index out of range");
+    if (!m_state.empty())
+      throw xrt_core::error(EPERM, "pipeline options cannot change after pipeline is executed");
+    m_options.resize(m_stages.size());
+    m_options[idx] = opts;
+  }
+
+  pipeline::stage_stats
+  get_stage_stats(size_t idx) const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (idx >= m_stages.size())
+      throw xrt_core::error(EINVAL, "pipeline stage index out of range");
+    return idx < m_state.size() ? m_state[idx].stats : pipeline::stage_stats{};
+  }
+
   const pipeline::stage&
   add_stage(pipeline::stage&& s)
   {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!m_state.empty())
+      throw xrt_core::error(EPERM, "pipeline stages cannot be added after pipeline is executed");
     m_stages.push_back(std::move(s));
     return m_stages.back(); // bug, cannot return reference (vector resize)
   }
@@ -92,7 +290,28 @@ xrt::event
 pipeline::
 execute(xrt::event event)
 {
-  return m_impl->execute(event);
+  return m_impl->execute(event, true);
+}
+
+xrt::event
+pipeline::
+try_execute(xrt::event event)
+{
+  return m_impl->execute(event, false);
+}
+
+void
+pipeline::
+set_stage_options(size_t idx, const stage_options& opts)
+{
+  m_impl->set_stage_options(idx, opts);
+}
+
+pipeline::stage_stats
+pipeline::
+get_stage_stats(size_t idx) const
+{
+  return m_impl->get_stage_stats(idx);
 }
 
 const pipeline::stage&
@@ -21,8 +21,10 @@
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
 #include "core/include/experimental/xrt_xclbin.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
+#include "core/common/memalign.h"
 #include "core/common/message.h"
 #include "core/common/query_requests.h"
 #include "core/common/xclbin_parser.h"
@@ -37,6 +39,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include <array>
+#include <cstdio>
 #include <fstream>
 #include <numeric>
 #include <regex>
@@ -46,9 +49,14 @@
 
 #ifdef _WIN32
 # include "windows/uuid.h"
+# include <process.h>
 # pragma warning( disable : 4244 4267 4996)
 #else
 # include <linux/uuid.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
 #endif
 
 namespace {
@@ -90,6 +98,36 @@ read_xclbin(const std::string& fnm)
   return header;
 }
 
+#ifndef _WIN32
+// Map xclbin file read-only.  Pages of the mapping are read from the
+// page cache only when accessed, so sections that are never decoded
+// are never read.
+static xrt_core::mmap_ptr_type
+map_xclbin(const std::string& fnm)
+{
+  if (fnm.empty())
+    throw std::runtime_error("No xclbin specified");
+
+  auto fd = ::open(fnm.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw std::runtime_error("Failed to open file '" + fnm + "' for reading");
+
+  struct stat st {};
+  if (::fstat(fd, &st) || st.st_size <= 0) {
+    ::close(fd);
+    throw std::runtime_error("Failed to stat file '" + fnm + "'");
+  }
+
+  auto size = static_cast<size_t>(st.st_size);
+  auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // mapping holds a reference to the file
+  if (addr == MAP_FAILED)
+    throw std::runtime_error("Failed to map file '" + fnm + "'");
+
+  return xrt_core::mmap_ptr_type{addr, xrt_core::mmap_ptr_deleter{size}};
+}
+#endif
+
 static std::vector<char>
 copy_axlf(const axlf* top)
 {
@@ -100,6 +138,250 @@ copy_axlf(const axlf* top)
   return header;
 }
 
+// struct xml_metadata - kernel meta data parsed from EMBEDDED_METADATA
+//
+// The XML parsing dominates construction of xclbin meta data, so the
+// parsed result can be cached on disk keyed by xclbin uuid, see
+// xrt.ini Runtime.xclbin_metadata_cache_dir.
+struct xml_metadata
+{
+  std::string project_name;
+  std::string fpga_device_name;
+  std::vector<xrt_core::xclbin::kernel_object> kernels;
+  std::vector<xrt_core::xclbin::kernel_properties> properties; // per kernel
+
+  static constexpr char magic[8] = {'X','R','T','X','M','E','T','2'};
+
+  static xml_metadata
+  parse(const char* xml, size_t xml_size)
+  {
+    xml_metadata md;
+    md.project_name = xrt_core::xclbin::get_project_name(xml, xml_size);
+    md.fpga_device_name = xrt_core::xclbin::get_fpga_device_name(xml, xml_size);
+    md.kernels = xrt_core::xclbin::get_kernels(xml, xml_size);
+    for (const auto& kernel : md.kernels)
+      md.properties.push_back(xrt_core::xclbin::get_kernel_properties(xml, xml_size, kernel.name));
+    return md;
+  }
+
+  // Binary serialization, integers are native endian uint64_t and
+  // strings are length prefixed.  The cache file is only valid on
+  // the host that wrote it.
+  class writer
+  {
+    std::ostream& m_os;
+  public:
+    explicit writer(std::ostream& os) : m_os(os) {}
+
+    void
+    put(uint64_t value)
+    {
+      m_os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void
+    put(const std::string& str)
+    {
+      put(str.size());
+      m_os.write(str.data(), str.size());
+    }
+  };
+
+  class reader
+  {
+    std::istream& m_is;
+  public:
+    explicit reader(std::istream& is) : m_is(is) {}
+
+    uint64_t
+    get()
+    {
+      uint64_t value = 0;
+      if (!m_is.read(reinterpret_cast<char*>(&value), sizeof(value)))
+        throw std::runtime_error("truncated xclbin meta data cache");
+      return value;
+    }
+
+    template <typename EnumType>
+    EnumType
+    get_enum()
+    {
+      return static_cast<EnumType>(get());
+    }
+
+    std::string
+    get_string()
+    {
+      auto size = get();
+      if (size > (1ULL << 24))
+        throw std::runtime_error("corrupt xclbin meta data cache");
+      std::string str(size, '\0');
+      if (!m_is.read(&str[0], size))
+        throw std::runtime_error("truncated xclbin meta data cache");
+      return str;
+    }
+  };
+
+  void
+  write(std::ostream& os, size_t xml_size) const
+  {
+    os.write(magic, sizeof(magic));
+    writer w(os);
+    w.put(xml_size);
+    w.put(project_name);
+    w.put(fpga_device_name);
+    w.put(kernels.size());
+    for (size_t kidx = 0; kidx < kernels.size(); ++kidx) {
+      const auto& kernel = kernels[kidx];
+      w.put(kernel.name);
+      w.put(kernel.range);
+      w.put(kernel.sw_reset);
+      w.put(kernel.args.size());
+      for (const auto& arg : kernel.args) {
+        w.put(arg.name);
+        w.put(arg.hosttype);
+        w.put(arg.port);
+        w.put(arg.port_width);
+        w.put(arg.index);
+        w.put(arg.offset);
+        w.put(arg.size);
+        w.put(arg.hostsize);
+        w.put(arg.fa_desc_offset);
+        w.put(static_cast<uint64_t>(arg.type));
+        w.put(static_cast<uint64_t>(arg.dir));
+      }
+
+      const auto& props = properties[kidx];
+      w.put(props.name);
+      w.put(static_cast<uint64_t>(props.type));
+      w.put(props.counted_auto_restart);
+      w.put(props.auto_restart_counter_offset);
+      w.put(static_cast<uint64_t>(props.mailbox));
+      w.put(props.address_range);
+      w.put(props.sw_reset);
+      w.put(props.workgroupsize);
+      for (auto value : props.compileworkgroupsize)
+        w.put(value);
+      for (auto value : props.maxworkgroupsize)
+        w.put(value);
+      w.put(props.stringtable.size());
+      for (const auto& entry : props.stringtable) {
+        w.put(entry.first);
+        w.put(entry.second);
+      }
+    }
+  }
+
+  // Read cached meta data, throws if the cache does not match
+  static xml_metadata
+  read(std::istream& is, size_t xml_size)
+  {
+    char hdr[sizeof(magic)] = {0};
+    if (!is.read(hdr, sizeof(hdr)) || !std::equal(hdr, hdr + sizeof(hdr), magic))
+      throw std::runtime_error("invalid xclbin meta data cache");
+
+    reader r(is);
+    if (r.get() != xml_size)
+      throw std::runtime_error("stale xclbin meta data cache");
+
+    xml_metadata md;
+    md.project_name = r.get_string();
+    md.fpga_device_name = r.get_string();
+    auto nkernels = r.get();
+    for (uint64_t kidx = 0; kidx < nkernels; ++kidx) {
+      xrt_core::xclbin::kernel_object kernel;
+      kernel.name = r.get_string();
+      kernel.range = r.get();
+      kernel.sw_reset = r.get() != 0;
+      auto nargs = r.get();
+      for (uint64_t aidx = 0; aidx < nargs; ++aidx) {
+        xrt_core::xclbin::kernel_argument arg;
+        arg.name = r.get_string();
+        arg.hosttype = r.get_string();
+        arg.port = r.get_string();
+        arg.port_width = r.get();
+        arg.index = r.get();
+        arg.offset = r.get();
+        arg.size = r.get();
+        arg.hostsize = r.get();
+        arg.fa_desc_offset = r.get();
+        arg.type = r.get_enum<xrt_core::xclbin::kernel_argument::argtype>();
+        arg.dir = r.get_enum<xrt_core::xclbin::kernel_argument::direction>();
+        kernel.args.push_back(std::move(arg));
+      }
+      md.kernels.push_back(std::move(kernel));
+
+      xrt_core::xclbin::kernel_properties props;
+      props.name = r.get_string();
+      props.type = r.get_enum<xrt_core::xclbin::kernel_properties::kernel_type>();
+      props.counted_auto_restart = r.get();
+      props.auto_restart_counter_offset = r.get();
+      props.mailbox = r.get_enum<xrt_core::xclbin::kernel_properties::mailbox_type>();
+      props.address_range = r.get();
+      props.sw_reset = r.get() != 0;
+      props.workgroupsize = r.get();
+      for (auto& value : props.compileworkgroupsize)
+        value = r.get();
+      for (auto& value : props.maxworkgroupsize)
+        value = r.get();
+      auto nstrings = r.get();
+      for (uint64_t sidx = 0; sidx < nstrings; ++sidx) {
+        auto key = static_cast<uint32_t>(r.get());
+        props.stringtable.emplace(key, r.get_string());
+      }
+      md.properties.push_back(std::move(props));
+    }
+    return md;
+  }
+
+  // Get meta data from cache directory if present and valid, else
+  // parse the XML and update the cache.  Cache errors are not fatal.
+  static xml_metadata
+  get(const xrt::uuid& uuid, const char* xml, size_t xml_size)
+  {
+    static auto dir = xrt_core::config::get_xclbin_metadata_cache_dir();
+    if (dir.empty())
+      return parse(xml, xml_size);
+
+    auto path = dir + "/" + uuid.to_string() + ".xmlmeta";
+    try {
+      std::ifstream is(path, std::ios::binary);
+      if (is)
+        return read(is, xml_size);
+    }
+    catch (const std::exception& ex) {
+      xrt_core::message::send(xrt_core::message::severity_level::debug, "XRT",
+                              "Ignoring xclbin meta data cache '" + path + "': " + ex.what());
+    }
+
+    auto md = parse(xml, xml_size);
+
+    // write to temporary file and rename, so concurrent processes
+    // never observe a partially written cache file
+#ifdef _WIN32
+    auto pid = _getpid();
+#else
+    auto pid = ::getpid();
+#endif
+    auto tmp = path + "." + std::to_string(pid);
+    {
+      std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+      if (os)
+        md.write(os, xml_size);
+      if (!os) {
+        std::remove(tmp.c_str());
+        return md;
+      }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()))
+      std::remove(tmp.c_str());
+
+    return md;
+  }
+};
+
+constexpr char xml_metadata::magic[8];
+
 // Default implementation to get the name of an element
 template <typename ElementType>
 static std::string
@@ -431,42 +713,30 @@ class xclbin_impl
     // Pre-condition for this function is that init_mems() and init_ips()
     // have been called.
     static std::vector<xclbin::kernel>
-    init_kernels(const xclbin_impl* ximpl, const std::vector<xclbin::ip>& ips)
+    init_kernels(xml_metadata& md, const std::vector<xclbin::ip>& ips)
     {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      if (!xml.first)
-        return {};
-
       // get kernel CUs from xclbin meta data
       std::vector<xclbin::kernel> kernels;
-      for (auto& kernel : xrt_core::xclbin::get_kernels(xml.first, xml.second)) {
-        auto props = xrt_core::xclbin::get_kernel_properties(xml.first, xml.second, kernel.name);
+      for (size_t kidx = 0; kidx < md.kernels.size(); ++kidx) {
+        auto& kernel = md.kernels[kidx];
         std::vector<xclbin::ip> cus;
         copy_if_name_match(ips.begin(), ips.end(), std::back_inserter(cus), kernel.name);
         kernels.emplace_back
           (std::make_shared<xclbin::kernel_impl>
-           (std::move(kernel.name), std::move(props), std::move(cus), std::move(kernel.args)));
+           (std::move(kernel.name), std::move(md.properties[kidx]), std::move(cus), std::move(kernel.args)));
       }
 
       return kernels;
     }
 
-    static std::string
-    init_project_name(const xclbin_impl* ximpl)
+    // init_xml_metadata() - parse XML meta data or get it from cache
+    static xml_metadata
+    init_xml_metadata(const xclbin_impl* ximpl)
     {
       auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
       return xml.first
-        ? xrt_core::xclbin::get_project_name(xml.first, xml.second)
-        : "";
-    }
-
-    static std::string
-    init_fpga_device_name(const xclbin_impl* ximpl)
-    {
-      auto xml = ximpl->get_axlf_section(EMBEDDED_METADATA);
-      return xml.first
-        ? xrt_core::xclbin::get_fpga_device_name(xml.first, xml.second)
-        : "";
+        ? xml_metadata::get(ximpl->get_uuid(), xml.first, xml.second)
+        : xml_metadata{};
     }
 
     // init_mem_encoding() - compress memory indices
@@ -542,12 +812,16 @@ class xclbin_impl
     // xclbin_info() - constructor for xclbin meta data
     explicit
     xclbin_info(const xrt::xclbin_impl* impl)
+      : xclbin_info(impl, init_xml_metadata(impl))
+    {}
+
+    xclbin_info(const xrt::xclbin_impl* impl, xml_metadata&& md)
       : m_ximpl(impl)
-      , m_project_name(init_project_name(m_ximpl))
-      , m_fpga_device_name(init_fpga_device_name(m_ximpl))
+      , m_project_name(std::move(md.project_name))
+      , m_fpga_device_name(std::move(md.fpga_device_name))
       , m_mems(init_mems(m_ximpl))
       , m_ips(init_ips(m_ximpl, m_mems))
-      , m_kernels(init_kernels(m_ximpl, m_ips))
+      , m_kernels(init_kernels(md, m_ips))
       , m_membank_encoding(init_mem_encoding(m_mems))
     {}
   };
@@ -710,22 +984,31 @@ public:
 // class xclbin_full - Implementation of full xclbin
 //
 // A full xclbin is constructed from a file on disk or from a complete
-// binary images for file content
+// binary images for file content.  A file is memory mapped unless
+// disabled in xrt.ini (Runtime.xclbin_mmap), in which case, or if the
+// mapping fails, the file is read into memory.  Sections refer to the
+// raw data and are not copied.
 class xclbin_full : public xclbin_impl
 {
-  std::vector<char> m_axlf;    // complete copy of xclbin raw data
+  std::vector<char> m_axlf;    // copy of xclbin raw data unless mapped
+#ifndef _WIN32
+  xrt_core::mmap_ptr_type m_mapping; // mapping of xclbin file
+#endif
+  const char* m_data = nullptr;      // raw data, either copy or mapping
+  size_t m_size = 0;                 // size of raw data
   const axlf* m_top = nullptr; // axlf pointer to the raw data
   uuid m_uuid;                 // uuid of xclbin
 
   // sections within this xclbin
-  std::multimap<axlf_section_kind, std::vector<char>> m_axlf_sections;
+  std::multimap<axlf_section_kind, std::pair<const char*, size_t>> m_axlf_sections;
 
   void
   emplace_section(const axlf_section_header* hdr, axlf_section_kind kind)
   {
-    auto section_data = reinterpret_cast<const char*>(m_top) + hdr->m_sectionOffset;
-    std::vector<char> data{section_data, section_data + hdr->m_sectionSize};
-    m_axlf_sections.emplace(kind , std::move(data));
+    if (hdr->m_sectionOffset + hdr->m_sectionSize > m_size)
+      throw std::runtime_error("Invalid xclbin, section exceeds file size");
+    auto section_data = m_data + hdr->m_sectionOffset;
+    m_axlf_sections.emplace(kind, std::make_pair(section_data, static_cast<size_t>(hdr->m_sectionSize)));
   }
 
   void
@@ -740,9 +1023,14 @@ class xclbin_full : public xclbin_impl
   void
   init_axlf()
   {
-    const axlf* tmp = reinterpret_cast<const axlf*>(m_axlf.data());
+    if (m_size < sizeof(axlf))
+      throw std::runtime_error("Invalid xclbin");
+    const axlf* tmp = reinterpret_cast<const axlf*>(m_data);
     if (strncmp(tmp->m_magic, "xclbin2", strlen("xclbin2")) != 0) // Future: Do not hardcode "xclbin2"
       throw std::runtime_error("Invalid xclbin");
+    if (tmp->m_header.m_numSections
+        && sizeof(axlf) + (tmp->m_header.m_numSections - 1) * sizeof(axlf_section_header) > m_size)
+      throw std::runtime_error("Invalid xclbin, section headers exceed file size");
     m_top = tmp;
 
     m_uuid = uuid(m_top->m_header.uuid);
@@ -764,14 +1052,37 @@ class xclbin_full : public xclbin_impl
   void
   init()
   {
+#ifndef _WIN32
+    if (m_mapping) {
+      m_data = static_cast<const char*>(m_mapping.get());
+      m_size = m_mapping.get_deleter().size;
+      init_axlf();
+      return;
+    }
+#endif
+    m_data = m_axlf.data();
+    m_size = m_axlf.size();
     init_axlf();
   }
 
 public:
   explicit
   xclbin_full(const std::string& filename)
-    : m_axlf(read_xclbin(filename))
   {
+#ifndef _WIN32
+    static bool use_mmap = xrt_core::config::get_xclbin_mmap();
+    if (use_mmap) {
+      try {
+        m_mapping = map_xclbin(filename);
+      }
+      catch (const std::exception&) {
+        // revert to reading file, which reports errors
+      }
+    }
+    if (!m_mapping)
+#endif
+      m_axlf = read_xclbin(filename);
+
     init();
   }
 
@@ -825,7 +1136,7 @@ public:
   {
     auto itr = m_axlf_sections.find(kind);
     return itr != m_axlf_sections.end()
-      ? std::make_pair((*itr).second.data(), (*itr).second.size())
+      ? (*itr).second
       : std::make_pair(nullptr, size_t(0));
   }
 
@@ -840,7 +1151,7 @@ public:
       std::vector<std::pair<const char*, size_t>> return_sections;
 
       for (auto itr = result.first; itr != result.second; itr++)
-        return_sections.emplace_back(std::make_pair(itr->second.data(), itr->second.size()));
+        return_sections.emplace_back(itr->second);
 
       return return_sections;
     }
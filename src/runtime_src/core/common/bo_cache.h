@@ -1,5 +1,5 @@
 /**
- * Copyright (C) 2019 Xilinx, Inc
+ * Copyright (C) 2019-2022 Xilinx, Inc
  *
  * Licensed under the Apache License, Version 2.0 (the "License"). You may
  * not use this file except in compliance with the License. A copy of the
@@ -21,9 +21,13 @@
 #include "device.h"
 #include "ert.h"
 
-#include <vector>
-#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning( push )
@@ -32,8 +36,16 @@
 
 namespace xrt_core {
 
-// Create a cache of CMD BO objects -- for now only used for M2M -- to reduce
-// the overhead of BO life cycle management.
+// Create a cache of CMD BO objects to reduce the overhead of BO life
+// cycle management.
+//
+// The cache is two levels.  A shared depot protected by a mutex holds
+// the bulk of cached BOs.  In front of the depot is a fixed number of
+// per-thread magazines, small stacks of BOs that a thread claims with
+// an atomic exchange, so that a thread that repeatedly allocates and
+// releases BOs never touches the depot mutex.  A thread falls back to
+// the depot when its magazine is empty or full, or if another thread
+// that hashes to the same slot currently holds the magazine.
 class bo_cache {
 public:
   // Helper typedef for std::pair. Note the elements are const so that the
@@ -46,6 +58,18 @@ private:
   // POWER9 pagesize maybe more than 4K, xocl would upsize the allocation to the
   // correct pagesize. unmap always unmaps the full page.
   static const size_t mBOSize = 4096;
+
+  // Max number of BOs held by one magazine
+  static constexpr size_t mMagazineMaxSize = 16;
+
+  // Max number of magazines, threads are hashed to a magazine slot
+  static constexpr size_t mMagazineMaxSlots = 64;
+
+  struct magazine
+  {
+    std::vector<cmd_bo<void>> bos;
+  };
+
   std::shared_ptr<device> mDevice;
   // Maximum number of BOs that can be cached in the pool. Value of 0 indicates
   // caching should be disabled.
@@ -53,18 +77,66 @@ private:
   std::vector<cmd_bo<void>> mCmdBOCache;
   std::mutex mCacheMutex;
 
+  // Magazine slots, a nullptr slot is currently claimed by a thread
+  size_t mMagazineSize = 0;
+  std::vector<std::unique_ptr<magazine>> mMagazines;
+  std::unique_ptr<std::atomic<magazine*>[]> mSlots;
+
+  static size_t
+  thread_slot()
+  {
+    static std::atomic<size_t> count {0};
+    static thread_local size_t slot = count++;
+    return slot;
+  }
+
+  void
+  init_magazines()
+  {
+    auto slots = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), mMagazineMaxSlots);
+
+    // Magazines get at most half of the cache capacity, the rest
+    // stays in the depot which is shared by all threads
+    mMagazineSize = std::min(mMagazineMaxSize, mCacheMaxSize / (2 * slots));
+    if (!mMagazineSize)
+      return;
+
+    mSlots = std::make_unique<std::atomic<magazine*>[]>(slots);
+    for (size_t idx = 0; idx < slots; ++idx) {
+      mMagazines.emplace_back(std::make_unique<magazine>());
+      mMagazines.back()->bos.reserve(mMagazineSize);
+      mSlots[idx] = mMagazines.back().get();
+    }
+  }
+
+  std::atomic<magazine*>*
+  get_slot()
+  {
+    return mMagazineSize ? &mSlots[thread_slot() % mMagazines.size()] : nullptr;
+  }
+
 public:
   bo_cache(xclDeviceHandle handle, unsigned int max_size)
     : mDevice(get_userpf_device(handle)), mCacheMaxSize(max_size)
-  {}
+  {
+    init_magazines();
+  }
 
   ~bo_cache()
   {
     std::lock_guard<std::mutex> lock(mCacheMutex);
     for (auto& bo : mCmdBOCache)
       destroy(bo);
+    for (auto& mag : mMagazines)
+      for (auto& bo : mag->bos)
+        destroy(bo);
   }
 
+  bo_cache(const bo_cache&) = delete;
+  bo_cache(bo_cache&&) = delete;
+  bo_cache& operator=(const bo_cache&) = delete;
+  bo_cache& operator=(bo_cache&&) = delete;
+
   template<typename T>
   cmd_bo<T>
   alloc()
@@ -80,12 +152,38 @@ public:
     release_impl(std::make_pair(bo.first, static_cast<void *>(bo.second)));
   }
 
+  // Populate the shared cache with up to 'count' BOs so that the
+  // first 'count' allocations do not have to allocate and map a BO.
+  void
+  prewarm(size_t count)
+  {
+    count = std::min<size_t>(count, mCacheMaxSize);
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    while (mCmdBOCache.size() < count) {
+      auto execHandle = mDevice->alloc_bo(mBOSize, XCL_BO_FLAGS_EXECBUF);
+      mCmdBOCache.emplace_back(execHandle, mDevice->map_bo(execHandle, true));
+    }
+  }
+
 private:
   cmd_bo<void>
   alloc_impl()
   {
     if (mCacheMaxSize) {
-      // If caching is enabled first look up in the BO cache
+      // Thread local magazine first, this is lock free
+      if (auto slot = get_slot()) {
+        if (auto mag = slot->exchange(nullptr, std::memory_order_acquire)) {
+          if (!mag->bos.empty()) {
+            auto bo = mag->bos.back();
+            mag->bos.pop_back();
+            slot->store(mag, std::memory_order_release);
+            return bo;
+          }
+          slot->store(mag, std::memory_order_release);
+        }
+      }
+
+      // If caching is enabled look up in the shared BO cache
       std::lock_guard<std::mutex> lock(mCacheMutex);
       if (!mCmdBOCache.empty()) {
         auto bo = mCmdBOCache.back();
@@ -102,9 +200,21 @@ private:
   release_impl(const cmd_bo<void> &bo)
   {
     if (mCacheMaxSize) {
+      // Thread local magazine first, this is lock free
+      if (auto slot = get_slot()) {
+        if (auto mag = slot->exchange(nullptr, std::memory_order_acquire)) {
+          bool cached = mag->bos.size() < mMagazineSize;
+          if (cached)
+            mag->bos.push_back(bo);
+          slot->store(mag, std::memory_order_release);
+          if (cached)
+            return;
+        }
+      }
+
       // If caching is enabled and BO cache is not fully populated add this the cache
       std::lock_guard<std::mutex> lock(mCacheMutex);
-      if (mCmdBOCache.size() < mCacheMaxSize) {
+      if (mCmdBOCache.size() + mMagazines.size() * mMagazineSize < mCacheMaxSize) {
         mCmdBOCache.push_back(bo);
         return;
       }
@@ -0,0 +1,177 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef core_common_bo_slab_h_
+#define core_common_bo_slab_h_
+
+#include "system.h"
+#include "device.h"
+#include "bo_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace xrt_core {
+
+// Slab allocator for CMD BOs.
+//
+// Most command packets are a few hundred bytes, yet a CMD BO from
+// bo_cache is a full page which costs an alloc_bo and map_bo per
+// command.  The slab allocates one large CMD BO and carves it into
+// equally sized slots.  Slot sizes are powers of two from
+// mMinSlotSize to mMaxSlotSize and each slab serves one slot size.
+//
+// A slot is returned as a cmd_bo whose handle is the slab BO and
+// whose pointer is the slot address.  The offset of the slot within
+// the slab must be passed along with the BO handle when submitting
+// the command, which requires a driver that accepts an exec buffer
+// offset.
+class bo_slab {
+public:
+  template <typename CommandType>
+  using cmd_bo = bo_cache::cmd_bo<CommandType>;
+
+private:
+  static constexpr size_t mSlabSize = 2 * 1024 * 1024;
+  static constexpr size_t mMinSlotSize = 256;
+  static constexpr size_t mMaxSlotSize = 4096;
+  static constexpr size_t mNumClasses = 5;  // 256, 512, 1K, 2K, 4K
+
+  struct slab
+  {
+    xclBufferHandle handle;
+    char* base;
+    size_t slot_size;
+  };
+
+  std::shared_ptr<device> mDevice;
+  std::vector<slab> mSlabs;
+  std::array<std::vector<cmd_bo<void>>, mNumClasses> mFree;
+  std::mutex mMutex;
+
+  static size_t
+  size_class(size_t size)
+  {
+    size_t cls = 0;
+    for (auto slot_size = mMinSlotSize; slot_size < size; slot_size <<= 1)
+      ++cls;
+    return cls;
+  }
+
+  const slab*
+  find(xclBufferHandle handle) const
+  {
+    auto itr = std::find_if(mSlabs.begin(), mSlabs.end(),
+                            [handle](const auto& s) { return s.handle == handle; });
+    return itr != mSlabs.end() ? &(*itr) : nullptr;
+  }
+
+  // Allocate a new slab and give its slots to the free list of cls
+  void
+  grow(size_t cls)
+  {
+    auto slot_size = mMinSlotSize << cls;
+    auto handle = mDevice->alloc_bo(mSlabSize, XCL_BO_FLAGS_EXECBUF);
+    auto base = static_cast<char*>(mDevice->map_bo(handle, true));
+    mSlabs.push_back({handle, base, slot_size});
+
+    auto& free = mFree[cls];
+    for (auto offset = mSlabSize; offset >= slot_size; offset -= slot_size)
+      free.emplace_back(handle, base + offset - slot_size);
+  }
+
+public:
+  explicit
+  bo_slab(xclDeviceHandle handle)
+    : mDevice(get_userpf_device(handle))
+  {}
+
+  ~bo_slab()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto& s : mSlabs) {
+      mDevice->unmap_bo(s.handle, s.base);
+      mDevice->free_bo(s.handle);
+    }
+  }
+
+  bo_slab(const bo_slab&) = delete;
+  bo_slab(bo_slab&&) = delete;
+  bo_slab& operator=(const bo_slab&) = delete;
+  bo_slab& operator=(bo_slab&&) = delete;
+
+  // Largest command size that can be served from a slab
+  static constexpr size_t
+  max_size()
+  {
+    return mMaxSlotSize;
+  }
+
+  // Allocate a slot of at least size bytes, the slot is zero
+  // initialized as a newly allocated BO would be.
+  template <typename T>
+  cmd_bo<T>
+  alloc(size_t size)
+  {
+    if (!size || size > mMaxSlotSize)
+      throw std::runtime_error("bad slab slot size: " + std::to_string(size));
+
+    auto cls = size_class(size);
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFree[cls].empty())
+      grow(cls);
+    auto bo = mFree[cls].back();
+    mFree[cls].pop_back();
+    std::fill_n(static_cast<char*>(bo.second), mMinSlotSize << cls, 0);
+    return std::make_pair(bo.first, static_cast<T*>(bo.second));
+  }
+
+  template <typename T>
+  void
+  release(cmd_bo<T>& bo)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto s = find(bo.first);
+    if (!s)
+      throw std::runtime_error("CMD BO is not from slab");
+    mFree[size_class(s->slot_size)].emplace_back(bo.first, static_cast<void*>(bo.second));
+  }
+
+  // Check if a CMD BO was allocated from this slab
+  bool
+  owns(xclBufferHandle handle)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return find(handle) != nullptr;
+  }
+
+  // Byte offset of a slot within its slab BO
+  template <typename T>
+  size_t
+  offset(const cmd_bo<T>& bo)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto s = find(bo.first);
+    return s ? static_cast<size_t>(reinterpret_cast<char*>(bo.second) - s->base) : 0;
+  }
+};
+
+} // xrt_core
+
+#endif
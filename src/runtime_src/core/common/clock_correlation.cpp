@@ -0,0 +1,280 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#define XRT_CORE_COMMON_SOURCE
+#include "clock_correlation.h"
+
+#include "debug.h"
+#include "thread.h"
+#include "time.h"
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <thread>
+
+namespace {
+
+// Number of recent samples used for the fit
+constexpr size_t max_samples = 64;
+
+// Slope is fitted only when samples span at least this much host
+// time, shorter spans are dominated by sampling jitter
+constexpr uint64_t min_fit_span_ns = 1000000000;
+
+// Fitted slopes further than this from the nominal slope indicate bad
+// samples and are rejected
+constexpr double max_drift = 1.0e-3;
+
+// Clock training data is accurate up to 3 seconds, 500 ms is a
+// reasonable interval
+constexpr auto train_interval = std::chrono::milliseconds(500);
+
+// class trainer_service - Call registered trainers periodically
+//
+// One thread for all devices.  The thread is started with the first
+// trainer and idles when no trainers are registered.
+class trainer_service
+{
+  using trainer_type = xrt_core::clock_correlation::trainer_type;
+  using trainer_handle = xrt_core::clock_correlation::trainer_handle;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<trainer_handle, trainer_type> m_trainers;
+  trainer_handle m_next = 1;
+  trainer_handle m_running = 0;
+  bool m_stop = false;
+  std::thread m_thread;
+
+  void
+  run()
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    while (!m_stop) {
+      // Trainers are called without the lock, so trainers can be
+      // added and removed concurrently
+      auto itr = m_trainers.begin();
+      while (itr != m_trainers.end() && !m_stop) {
+        auto hdl = itr->first;
+        auto fcn = itr->second;
+        m_running = hdl;
+        lk.unlock();
+        try {
+          fcn();
+        }
+        catch (const std::exception& ex) {
+          XRT_DEBUGF("clock training failed: %s\n", ex.what());
+        }
+        lk.lock();
+        m_running = 0;
+        m_cv.notify_all();
+        itr = m_trainers.upper_bound(hdl);
+      }
+
+      if (m_trainers.empty())
+        m_cv.wait(lk, [this] { return m_stop || !m_trainers.empty(); });
+      else
+        m_cv.wait_for(lk, train_interval, [this] { return m_stop; });
+    }
+  }
+
+public:
+  ~trainer_service()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  trainer_handle
+  add(trainer_type fcn)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto hdl = m_next++;
+    m_trainers.emplace(hdl, std::move(fcn));
+    if (!m_thread.joinable())
+      m_thread = xrt_core::thread(xrt_core::thread_class::profile, &trainer_service::run, this);
+    m_cv.notify_all();
+    return hdl;
+  }
+
+  void
+  remove(trainer_handle hdl)
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_trainers.erase(hdl);
+    m_cv.wait(lk, [this, hdl] { return m_running != hdl; });
+  }
+};
+
+static trainer_service&
+get_trainer_service()
+{
+  static trainer_service service;
+  return service;
+}
+
+} // namespace
+
+namespace xrt_core {
+
+std::shared_ptr<clock_correlation>
+clock_correlation::
+get(unsigned int device_id)
+{
+  static std::mutex mutex;
+  static std::map<unsigned int, std::shared_ptr<clock_correlation>> devices;
+
+  std::lock_guard<std::mutex> lk(mutex);
+  auto& clock = devices[device_id];
+  if (!clock)
+    clock = std::make_shared<clock_correlation>();
+  return clock;
+}
+
+clock_correlation::trainer_handle
+clock_correlation::
+add_trainer(trainer_type fcn)
+{
+  return get_trainer_service().add(std::move(fcn));
+}
+
+void
+clock_correlation::
+remove_trainer(trainer_handle handle)
+{
+  get_trainer_service().remove(handle);
+}
+
+int64_t
+clock_correlation::
+steady_offset_ns()
+{
+  static const int64_t offset = [] {
+    auto host = static_cast<int64_t>(time_ns());
+    auto steady = std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now().time_since_epoch()).count();
+    return static_cast<int64_t>(steady) - host;
+  }();
+  return offset;
+}
+
+void
+clock_correlation::
+set_nominal_rate(double mhz)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  m_nominal_slope = (mhz > 0.0) ? 1000.0 / mhz : 0.0;
+  if (m_samples.empty())
+    m_model.slope = m_nominal_slope;
+  else
+    fit();
+}
+
+void
+clock_correlation::
+add_sample(uint64_t device_ticks, uint64_t host_ns)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_samples.size() == max_samples)
+    m_samples.pop_front();
+  m_samples.push_back({device_ticks, host_ns});
+  fit();
+}
+
+void
+clock_correlation::
+reset()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  m_samples.clear();
+  m_model = model{};
+  m_model.slope = m_nominal_slope;
+}
+
+bool
+clock_correlation::
+is_trained() const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return !m_samples.empty();
+}
+
+double
+clock_correlation::
+device_to_host_ns(uint64_t device_ticks) const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto dx = static_cast<int64_t>(device_ticks - m_model.ref_ticks);
+  return m_model.ref_host + m_model.slope * static_cast<double>(dx);
+}
+
+// Fit model to samples, called with lock held.  Samples are taken
+// relative to the most recent sample, so differences are small and
+// exact in double precision.
+void
+clock_correlation::
+fit()
+{
+  const auto& last = m_samples.back();
+  model m;
+  m.ref_ticks = last.device_ticks;
+  m.ref_host = static_cast<double>(last.host_ns);
+  m.slope = m_nominal_slope;
+
+  auto span = static_cast<int64_t>(last.host_ns - m_samples.front().host_ns);
+  bool enough = m_nominal_slope
+    ? (m_samples.size() >= 3 && span >= static_cast<int64_t>(min_fit_span_ns))
+    : (m_samples.size() >= 2);
+
+  if (enough) {
+    double n = static_cast<double>(m_samples.size());
+    double mx = 0.0;
+    double my = 0.0;
+    for (const auto& s : m_samples) {
+      mx += static_cast<double>(static_cast<int64_t>(s.device_ticks - last.device_ticks));
+      my += static_cast<double>(static_cast<int64_t>(s.host_ns - last.host_ns));
+    }
+    mx /= n;
+    my /= n;
+
+    double sxx = 0.0;
+    double sxy = 0.0;
+    for (const auto& s : m_samples) {
+      auto dx = static_cast<double>(static_cast<int64_t>(s.device_ticks - last.device_ticks)) - mx;
+      auto dy = static_cast<double>(static_cast<int64_t>(s.host_ns - last.host_ns)) - my;
+      sxx += dx * dx;
+      sxy += dx * dy;
+    }
+
+    auto slope = (sxx > 0.0) ? sxy / sxx : 0.0;
+    if (slope > 0.0 && (!m_nominal_slope || std::abs(slope / m_nominal_slope - 1.0) <= max_drift)) {
+      // Fitted line passes through the centroid of the samples
+      m.slope = slope;
+      m.ref_host = static_cast<double>(last.host_ns) + my - slope * mx;
+    }
+  }
+
+  m_model = m;
+}
+
+} // xrt_core
@@ -0,0 +1,173 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xrt_core_common_clock_correlation_h_
+#define xrt_core_common_clock_correlation_h_
+
+#include "config.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace xrt_core {
+
+/**
+ * class clock_correlation - Correlate a device clock with host time
+ *
+ * One object per device maintains a linear model
+ *    host_ns = slope * device_ticks + offset
+ * from samples of device ticks taken at known host times.  Host time
+ * is xrt_core::time_ns().
+ *
+ * Until samples span long enough for an accurate fit, the slope is
+ * the nominal period of the device clock and the offset is taken from
+ * the most recent sample.  Thereafter the slope is fitted by least
+ * squares over a window of recent samples, which corrects for drift
+ * of the device clock relative to its nominal rate.
+ *
+ * Samples are added by whoever can observe the device clock, for
+ * example trace offload decoding clock training packets.  Observers
+ * that must periodically initiate sampling register a trainer, which
+ * is called at low frequency by one process wide thread shared by all
+ * devices.
+ */
+class clock_correlation
+{
+public:
+  using trainer_type = std::function<void()>;
+  using trainer_handle = uint64_t;
+
+  /**
+   * get() - Get the clock correlation of a device
+   *
+   * @device_id: Index of device (xrt_core::device::get_device_id())
+   * Return:     Shared clock correlation object of device
+   */
+  XRT_CORE_COMMON_EXPORT
+  static std::shared_ptr<clock_correlation>
+  get(unsigned int device_id);
+
+  /**
+   * add_trainer() - Register function to call periodically
+   *
+   * @fcn:   Function initiating sampling of the device clock
+   * Return: Handle to pass to remove_trainer()
+   *
+   * Trainers are called sequentially every 500 ms.
+   */
+  XRT_CORE_COMMON_EXPORT
+  static trainer_handle
+  add_trainer(trainer_type fcn);
+
+  /**
+   * remove_trainer() - Unregister trainer
+   *
+   * The trainer is not running and will not be called again when
+   * this function returns.  Must not be called from a trainer.
+   */
+  XRT_CORE_COMMON_EXPORT
+  static void
+  remove_trainer(trainer_handle handle);
+
+  /**
+   * steady_offset_ns() - Offset of steady_clock time from time_ns()
+   *
+   * Add to a host time in the time_ns() domain to get ns since the
+   * epoch of std::chrono::steady_clock.
+   */
+  XRT_CORE_COMMON_EXPORT
+  static int64_t
+  steady_offset_ns();
+
+  /**
+   * set_nominal_rate() - Set nominal device clock rate
+   *
+   * @mhz: Clock rate in MHz, 0 if unknown
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  set_nominal_rate(double mhz);
+
+  /**
+   * add_sample() - Add correlated device and host time
+   *
+   * @device_ticks: Device clock value
+   * @host_ns:      Host time in time_ns() domain at device_ticks
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  add_sample(uint64_t device_ticks, uint64_t host_ns);
+
+  /**
+   * reset() - Discard all samples
+   *
+   * Called when the device clock is reset, e.g. when a new xclbin is
+   * loaded.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  reset();
+
+  /**
+   * is_trained() - Check if at least one sample has been added
+   */
+  XRT_CORE_COMMON_EXPORT
+  bool
+  is_trained() const;
+
+  /**
+   * device_to_host_ns() - Convert device ticks to host time
+   *
+   * @device_ticks: Device clock value
+   * Return:        Host time in ns in time_ns() domain
+   *
+   * Before any sample is added, the offset is 0.
+   */
+  XRT_CORE_COMMON_EXPORT
+  double
+  device_to_host_ns(uint64_t device_ticks) const;
+
+private:
+  struct sample
+  {
+    uint64_t device_ticks;
+    uint64_t host_ns;
+  };
+
+  // Model is host_ns = ref_host + slope * (device_ticks - ref_ticks)
+  // referenced to a recent sample to preserve precision of doubles
+  struct model
+  {
+    uint64_t ref_ticks = 0;
+    double ref_host = 0.0;
+    double slope = 0.0;
+  };
+
+  void
+  fit();
+
+  mutable std::mutex m_mutex;
+  std::deque<sample> m_samples;
+  double m_nominal_slope = 0.0; // ns per tick, 0 if unknown
+  model m_model;
+};
+
+} // xrt_core
+
+#endif
@@ -280,6 +280,79 @@ debug(std::ostream& ostr, const std::string& ini)
   return ostr;
 }
 
+std::atomic<const snapshot*> current_snapshot {nullptr};
+
+const snapshot*
+init_snapshot()
+{
+  // Defaults, including values derived from other keys, are those of
+  // the cached accessors.
+  static const snapshot initial = {
+    get_verbosity(),
+    get_polling_throttle(),
+    get_ert_polling(),
+    get_cmdbo_cache(),
+    get_exec_buffer_cache_size(),
+    get_exec_buffer_cache_prewarm(),
+    get_exec_buffer_slab(),
+    get_exec_wait_policy(),
+    get_exec_wait_spin_ns(),
+    get_exec_callback_threads(),
+    get_bo_sync_threads(),
+    get_copy_through_host_chunk_size(),
+    get_copy_through_host_threads(),
+    get_host_buffer_huge_pages(),
+    get_host_buffer_numa_local(),
+    get_bo_write_nontemporal_threshold(),
+    get_xclbin_mmap(),
+    get_xclbin_metadata_cache_dir(),
+    get_kernel_cache_size(),
+    get_native_xrt_trace(),
+    get_host_trace()
+  };
+
+  const snapshot* expected = nullptr;
+  current_snapshot.compare_exchange_strong(expected, &initial, std::memory_order_acq_rel);
+  return current_snapshot.load(std::memory_order_acquire);
+}
+
 } // detail
 
+void
+reload(const std::string& ini)
+{
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lk(mutex);
+
+  // Keys missing from the reread file default to the initial values
+  const auto& init = *detail::init_snapshot();
+  tree::instance()->reread(ini);
+
+  // Previous snapshots are never freed, readers may hold references
+  // to them indefinitely.  Reloads are rare.
+  auto ss = new snapshot(init);
+  ss->verbosity = detail::get_uint_value("Runtime.verbosity", init.verbosity);
+  ss->polling_throttle = detail::get_uint_value("Runtime.polling_throttle", init.polling_throttle);
+  ss->ert_polling = get_enable_flat() || detail::get_bool_value("Runtime.ert_polling", init.ert_polling);
+  ss->cmdbo_cache = detail::get_uint_value("Runtime.cmdbo_cache", init.cmdbo_cache);
+  ss->exec_buffer_cache_size = detail::get_uint_value("Runtime.exec_buffer_cache_size", init.exec_buffer_cache_size);
+  ss->exec_buffer_cache_prewarm = detail::get_uint_value("Runtime.exec_buffer_cache_prewarm", init.exec_buffer_cache_prewarm);
+  ss->exec_buffer_slab = detail::get_bool_value("Runtime.exec_buffer_slab", init.exec_buffer_slab);
+  ss->exec_wait_policy = detail::get_string_value("Runtime.exec_wait_policy", init.exec_wait_policy);
+  ss->exec_wait_spin_ns = detail::get_uint_value("Runtime.exec_wait_spin_ns", init.exec_wait_spin_ns);
+  ss->exec_callback_threads = detail::get_uint_value("Runtime.exec_callback_threads", init.exec_callback_threads);
+  ss->bo_sync_threads = detail::get_uint_value("Runtime.bo_sync_threads", init.bo_sync_threads);
+  ss->copy_through_host_chunk_size = detail::get_uint_value("Runtime.copy_through_host_chunk_size", init.copy_through_host_chunk_size);
+  ss->copy_through_host_threads = detail::get_uint_value("Runtime.copy_through_host_threads", init.copy_through_host_threads);
+  ss->host_buffer_huge_pages = detail::get_string_value("Runtime.host_buffer_huge_pages", init.host_buffer_huge_pages);
+  ss->host_buffer_numa_local = detail::get_bool_value("Runtime.host_buffer_numa_local", init.host_buffer_numa_local);
+  ss->bo_write_nontemporal_threshold = detail::get_uint_value("Runtime.bo_write_nontemporal_threshold", init.bo_write_nontemporal_threshold);
+  ss->xclbin_mmap = detail::get_bool_value("Runtime.xclbin_mmap", init.xclbin_mmap);
+  ss->xclbin_metadata_cache_dir = detail::get_string_value("Runtime.xclbin_metadata_cache_dir", init.xclbin_metadata_cache_dir);
+  ss->kernel_cache_size = detail::get_uint_value("Runtime.kernel_cache_size", init.kernel_cache_size);
+  ss->native_xrt_trace = detail::get_bool_value("Debug.native_xrt_trace", init.native_xrt_trace);
+  ss->host_trace = detail::get_bool_value("Debug.host_trace", init.host_trace);
+  detail::current_snapshot.store(ss, std::memory_order_release);
+}
+
 }}
@@ -18,6 +18,7 @@
 #define xrtcore_config_reader_h_
 
 #include "core/common/config.h"
+#include <atomic>
 #include <string>
 #include <iosfwd>
 
@@ -181,6 +182,16 @@ get_power_profile()
   return value;
 }
 
+// Interval at which the AIM, AM, and ASM counters of all devices are
+// sampled while the application runs, 0 to only read them at kernel
+// boundaries and at the end
+inline unsigned int
+get_device_counter_sampling_interval_ms()
+{
+  static unsigned int value = detail::get_uint_value("Debug.device_counter_sampling_interval_ms", 0) ;
+  return value ;
+}
+
 inline unsigned int
 get_power_profile_interval_ms()
 {
@@ -234,6 +245,16 @@ get_noc_profile_interval_ms()
   return value;
 }
 
+// Polling interval of NoC counters in us, overrides
+// noc_profile_interval_ms when non zero
+inline unsigned int
+get_noc_profile_interval_us()
+{
+  // NOLINTNEXTLINE
+  static unsigned int value = detail::get_uint_value("Debug.noc_profile_interval_us", 0);
+  return value;
+}
+
 inline std::string
 get_stall_trace()
 {
@@ -252,6 +273,61 @@ get_continuous_trace()
   return value;
 }
 
+// Format of trace files, "csv" or "binary".  Binary traces are
+// converted to csv offline with xdp::convertBinaryTrace
+inline std::string
+get_trace_file_format()
+{
+  static std::string value = detail::get_string_value("Debug.trace_file_format", "csv");
+  return value;
+}
+
+// Comma separated list of "api:N" entries, 1 in N calls of the api
+// are traced, "*:N" applies to apis not listed.  Empty traces all calls.
+inline std::string
+get_api_trace_sampling()
+{
+  static std::string value = detail::get_string_value("Debug.api_trace_sampling", "");
+  return value;
+}
+
+// Approximate memory in MB that profiling may use to retain trace
+// events until they are written, 0 for no limit.  When the limit is
+// reached the oldest events are dropped.
+inline unsigned int
+get_trace_memory_limit_mb()
+{
+  static unsigned int value = detail::get_uint_value("Debug.trace_memory_limit_mb", 0);
+  return value;
+}
+
+// Also write all trace events to a Perfetto trace file
+inline bool
+get_perfetto_trace()
+{
+  static bool value = detail::get_bool_value("Debug.perfetto_trace", false);
+  return value;
+}
+
+// Port on the loopback interface on which profiling counters are
+// served in the Prometheus text format while the application runs,
+// 0 to disable
+inline unsigned int
+get_live_metrics_port()
+{
+  static unsigned int value = detail::get_uint_value("Debug.live_metrics_port", 0);
+  return value;
+}
+
+// Timestamp host events with the invariant TSC of x86 processors
+// rather than steady_clock.  Ignored if the TSC is not invariant.
+inline bool
+get_tsc_timestamps()
+{
+  static bool value = detail::get_bool_value("Debug.tsc_timestamps", false);
+  return value;
+}
+
 inline unsigned int
 get_trace_buffer_offload_interval_ms()
 {
@@ -406,6 +482,16 @@ get_aie_profile_shim_metrics()
   return value;
 }
 
+// Time HAL buffer transfers (xclSyncBO, xclWriteBO, xclReadBO,
+// xclCopyBO) into per device histograms by transfer size, without
+// generating trace
+inline bool
+get_hal_transfer_stats()
+{
+  static bool value = detail::get_bool_value("Debug.hal_transfer_stats", false);
+  return value;
+}
+
 inline bool
 get_lop_trace()
 {
@@ -413,6 +499,15 @@ get_lop_trace()
   return value;
 }
 
+// Low overhead trace records events into per thread buffers mapped to
+// lop_trace.bin, converted offline with xdp::convertLOPBinaryTrace
+inline bool
+get_lop_trace_binary()
+{
+  static bool value = detail::get_bool_value("Debug.lop_trace_binary", false);
+  return value;
+}
+
 inline bool
 get_vitis_ai_profile()
 {
@@ -427,6 +522,15 @@ get_pl_deadlock_detection()
   return value;
 }
 
+// Interval at which the PL deadlock detector is first polled.  The
+// interval backs off while no deadlock is found.
+inline unsigned int
+get_pl_deadlock_detection_interval_ms()
+{
+  static unsigned int value = detail::get_uint_value("Debug.pl_deadlock_detection_interval_ms", 100);
+  return value;
+}
+
 inline bool
 get_api_checks()
 {
@@ -448,6 +552,20 @@ get_logging()
   return value;
 }
 
+inline bool
+get_logging_async()
+{
+  static bool value = detail::get_bool_value("Runtime.runtime_log_async",false);
+  return value;
+}
+
+inline unsigned int
+get_logging_queue_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.runtime_log_queue_size",4096);
+  return value;
+}
+
 inline unsigned int
 get_verbosity()
 {
@@ -463,6 +581,44 @@ get_dma_threads()
   return value;
 }
 
+/**
+ * Size in bytes of the chunks that large OpenCL buffer syncs are split
+ * into.  A sync of at least two chunks is spread over the DMA channel
+ * workers of the device so that the chunks are transferred
+ * concurrently.  A value of 0 syncs each buffer in one transfer.
+ */
+inline unsigned int
+get_dma_chunk_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.dma_chunk_size",16*1024*1024);
+  return value;
+}
+
+/**
+ * Bind DMA channel worker threads to the CPUs of the NUMA node of the
+ * device.  Ignored if Runtime.cpu_affinity is specified.
+ */
+inline bool
+get_dma_numa_affinity()
+{
+  static bool value = detail::get_bool_value("Runtime.dma_numa_affinity",false);
+  return value;
+}
+
+/**
+ * Recycle OpenCL kernel printf buffers across kernel launches.  The
+ * buffer of a completed launch is read back, printed, and reinitialized
+ * by a background thread instead of by commands enqueued on the
+ * command queue after each launch.  Printf output is asynchronous to
+ * completion of the launch in this mode.
+ */
+inline bool
+get_printf_ring_buffer()
+{
+  static bool value = detail::get_bool_value("Runtime.printf_ring_buffer",false);
+  return value;
+}
+
 inline unsigned int
 get_polling_throttle()
 {
@@ -565,6 +721,30 @@ get_ert_polling()
   return value;
 }
 
+/**
+ * Number of command completions the driver accumulates before waking
+ * waiting threads.  Completions are never held back longer than
+ * ert_moderate_us.  A value of 0 or 1 wakes on every completion.
+ */
+inline unsigned int
+get_ert_moderate_count()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.ert_moderate_count",0);
+  return value;
+}
+
+/**
+ * Maximum microseconds the driver holds back a command completion
+ * from waiting threads when ert_moderate_count is set.  A value of 0
+ * disables completion moderation.
+ */
+inline unsigned int
+get_ert_moderate_us()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.ert_moderate_us",0);
+  return value;
+}
+
 
 /**
  * Enable embedded scheduler CUDMA module
@@ -669,6 +849,281 @@ get_cmdbo_cache()
   return value;
 }
 
+/**
+ * Max number of exec buffers cached per device by the native XRT
+ * kernel APIs.  A value of 0 disables caching.
+ */
+inline unsigned int
+get_exec_buffer_cache_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_buffer_cache_size",128);
+  return value;
+}
+
+/**
+ * Number of exec buffers to pre-allocate in the per device exec
+ * buffer cache when the device is first used by the native XRT
+ * kernel APIs.
+ */
+inline unsigned int
+get_exec_buffer_cache_prewarm()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_buffer_cache_prewarm",0);
+  return value;
+}
+
+/**
+ * Carve kernel command packets out of large slab allocated exec
+ * buffers rather than one exec buffer per command.  Requires a
+ * driver that accepts an exec buffer offset.
+ */
+inline bool
+get_exec_buffer_slab()
+{
+  static bool value = detail::get_bool_value("Runtime.exec_buffer_slab",false);
+  return value;
+}
+
+/**
+ * Policy for waiting on command completion
+ *  interrupt: wait for device interrupt (default)
+ *  hybrid:    spin on command state for exec_wait_spin_ns
+ *             before waiting for device interrupt
+ *  busy_poll: spin on command state until completion or timeout
+ */
+inline std::string
+get_exec_wait_policy()
+{
+  static std::string value = detail::get_string_value("Runtime.exec_wait_policy","interrupt");
+  return value;
+}
+
+/**
+ * Nanoseconds to spin on command state before waiting for device
+ * interrupt when exec_wait_policy is hybrid.
+ */
+inline unsigned int
+get_exec_wait_spin_ns()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_wait_spin_ns",20000);
+  return value;
+}
+
+/**
+ * Number of worker threads executing run completion callbacks.  A
+ * value of 0 executes callbacks on the thread that observed command
+ * completion, which is the command monitor thread.
+ */
+inline unsigned int
+get_exec_callback_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.exec_callback_threads",1);
+  return value;
+}
+
+/**
+ * CPU affinity of completion callback threads, e.g. {2,3}.  The
+ * default is Runtime.cpu_affinity.
+ */
+inline std::string
+get_exec_callback_cpu_affinity()
+{
+  static std::string value = detail::get_string_value("Runtime.exec_callback_cpu_affinity","default");
+  return value;
+}
+
+/**
+ * Number of worker threads executing asynchronous buffer syncs,
+ * e.g. xrt::async_sync().  A value of 0 executes the sync in the
+ * calling thread.
+ */
+inline unsigned int
+get_bo_sync_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.bo_sync_threads",2);
+  return value;
+}
+
+/**
+ * Maximum number of buffer descriptors in flight per GMIO channel.
+ * The default of 0 uses all descriptors supported by the DMA.
+ */
+inline unsigned int
+get_gmio_queue_depth()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.gmio_queue_depth",0);
+  return value;
+}
+
+/**
+ * Sync cacheable buffer objects on edge with data cache maintenance
+ * issued from user space by virtual address, rather than through the
+ * sync ioctl.  Only buffers mapped into the process are synced this
+ * way, other syncs still use the ioctl.
+ */
+inline bool
+get_edge_user_cache_sync()
+{
+  static bool value = detail::get_bool_value("Runtime.edge_user_cache_sync", false);
+  return value;
+}
+
+/**
+ * Start and poll the compute unit of an exclusively opened kernel
+ * directly through its mapped register space, rather than submitting
+ * commands to the scheduler in the kernel driver.  The driver only
+ * manages ownership of the compute unit.  Applies to kernels with a
+ * single AP_CTRL_HS, AP_CTRL_CHAIN, or FAST_ADAPTER compute unit, and
+ * avoids the kernel round trip per run.  FAST_ADAPTER descriptors are
+ * written to descriptor slots mapped from the kernel driver.
+ */
+inline bool
+get_direct_cu_start()
+{
+  static bool value = detail::get_bool_value("Runtime.direct_cu_start", false);
+  return value;
+}
+
+/**
+ * Skip the memory connectivity check when a buffer is bound again to
+ * the same argument of a run object it was already validated for.
+ * The application guarantees that a buffer is not freed while bound
+ * to a run object, since a new buffer in a different memory bank
+ * could otherwise reuse the freed buffer and pass unchecked.
+ */
+inline bool
+get_trusted_arg_connectivity()
+{
+  static bool value = detail::get_bool_value("Runtime.trusted_arg_connectivity", false);
+  return value;
+}
+
+/**
+ * Chunk size in bytes for copying buffers through host memory, when
+ * the buffers cannot be copied by the device.  Copies larger than one
+ * chunk are pipelined such that syncing from source, host copy, and
+ * syncing to destination of different chunks overlap.  A value of 0
+ * copies the entire buffer in one pass.
+ */
+inline unsigned int
+get_copy_through_host_chunk_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.copy_through_host_chunk_size",8*1024*1024);
+  return value;
+}
+
+/**
+ * Number of threads copying chunks when copying buffers through host
+ * memory.  Each thread syncs, copies, and syncs back one chunk at a
+ * time, so with three or more threads all phases overlap.
+ */
+inline unsigned int
+get_copy_through_host_threads()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.copy_through_host_threads",3);
+  return value;
+}
+
+/**
+ * Page size of XRT allocated host backing of normal buffer objects.
+ * One of "none" (system pages), "2M", or "1G".  Huge pages are taken
+ * from the hugetlbfs pool reserved by the system administrator; if
+ * the pool is exhausted the buffer falls back to system pages.
+ */
+inline std::string
+get_host_buffer_huge_pages()
+{
+  static std::string value = detail::get_string_value("Runtime.host_buffer_huge_pages","none");
+  return value;
+}
+
+/**
+ * Bind XRT allocated host backing of normal buffer objects to the
+ * NUMA node of the device, so that DMA transfers do not cross the
+ * socket interconnect.
+ */
+inline bool
+get_host_buffer_numa_local()
+{
+  static bool value = detail::get_bool_value("Runtime.host_buffer_numa_local",false);
+  return value;
+}
+
+/**
+ * Directory on a hugetlbfs mount with 1G pages backing the host
+ * memory bank.  The pages are held by a file per device in this
+ * directory, so they remain reserved for the device across
+ * processes.  Empty maps anonymous 1G pages each time the bank is
+ * enabled.
+ */
+inline std::string
+get_host_mem_hugetlbfs()
+{
+  static std::string value = detail::get_string_value("Runtime.host_mem_hugetlbfs","");
+  return value;
+}
+
+/**
+ * NUMA node of the pages backing the host memory bank.  One of
+ * "device" (node of the device), "none", or a node number.
+ */
+inline std::string
+get_host_mem_numa_node()
+{
+  static std::string value = detail::get_string_value("Runtime.host_mem_numa_node","device");
+  return value;
+}
+
+/**
+ * Minimum size in bytes of xrt::bo::write() that is copied with
+ * non-temporal stores, which bypass the host CPU cache so that
+ * streaming writes of input buffers do not evict the working set of
+ * the application.  The default of 0 disables non-temporal copies.
+ */
+inline unsigned int
+get_bo_write_nontemporal_threshold()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.bo_write_nontemporal_threshold",0);
+  return value;
+}
+
+/**
+ * Memory map xclbin files constructed into xrt::xclbin objects rather
+ * than reading them into memory.  The file must not be modified while
+ * the xclbin object exists.
+ */
+inline bool
+get_xclbin_mmap()
+{
+  static bool value = detail::get_bool_value("Runtime.xclbin_mmap",true);
+  return value;
+}
+
+/**
+ * Directory of cached kernel meta data parsed from the XML section of
+ * xclbins, one file per xclbin uuid.  The directory must exist and be
+ * writable.  The default of no directory disables the cache.
+ */
+inline std::string
+get_xclbin_metadata_cache_dir()
+{
+  static std::string value = detail::get_string_value("Runtime.xclbin_metadata_cache_dir","");
+  return value;
+}
+
+/**
+ * Number of kernel objects retained in a process wide cache keyed by
+ * device, xclbin, kernel name, and access mode.  A cached kernel holds
+ * its compute unit contexts open, which prevents loading another
+ * xclbin on the device.  The default of 0 disables the cache.
+ */
+inline unsigned int
+get_kernel_cache_size()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.kernel_cache_size",0);
+  return value;
+}
+
 inline std::string
 get_hw_em_driver()
 {
@@ -812,6 +1267,90 @@ get_flag_sw_emu_kernel_debug()
   return value;
 }
 
+// Bound on CU commands the software emulation scheduler runs at once,
+// 0 for no bound.  A bound of 1 runs commands in submission order.
+inline unsigned int
+get_sw_emu_cu_threads()
+{
+  static unsigned int value = detail::get_uint_value("Emulation.sw_emu_cu_threads", 0);
+  return value;
+}
+
+/**
+ * struct snapshot - Typed snapshot of performance related settings
+ *
+ * Hot paths read plain fields of the current snapshot rather than
+ * calling the cached accessors above, each of which tests a function
+ * local static.  Fields are documented by their accessor.
+ *
+ * The snapshot is built on first use.  reload() rereads an ini file
+ * and atomically publishes a new snapshot, references to a previous
+ * snapshot remain valid.
+ */
+struct snapshot
+{
+  // Runtime section
+  unsigned int verbosity;                        // get_verbosity()
+  unsigned int polling_throttle;                 // get_polling_throttle()
+  bool ert_polling;                              // get_ert_polling()
+  unsigned int cmdbo_cache;                      // get_cmdbo_cache()
+  unsigned int exec_buffer_cache_size;           // get_exec_buffer_cache_size()
+  unsigned int exec_buffer_cache_prewarm;        // get_exec_buffer_cache_prewarm()
+  bool exec_buffer_slab;                         // get_exec_buffer_slab()
+  std::string exec_wait_policy;                  // get_exec_wait_policy()
+  unsigned int exec_wait_spin_ns;                // get_exec_wait_spin_ns()
+  unsigned int exec_callback_threads;            // get_exec_callback_threads()
+  unsigned int bo_sync_threads;                  // get_bo_sync_threads()
+  unsigned int copy_through_host_chunk_size;     // get_copy_through_host_chunk_size()
+  unsigned int copy_through_host_threads;        // get_copy_through_host_threads()
+  std::string host_buffer_huge_pages;            // get_host_buffer_huge_pages()
+  bool host_buffer_numa_local;                   // get_host_buffer_numa_local()
+  unsigned int bo_write_nontemporal_threshold;   // get_bo_write_nontemporal_threshold()
+  bool xclbin_mmap;                              // get_xclbin_mmap()
+  std::string xclbin_metadata_cache_dir;         // get_xclbin_metadata_cache_dir()
+  unsigned int kernel_cache_size;                // get_kernel_cache_size()
+
+  // Debug section
+  bool native_xrt_trace;                         // get_native_xrt_trace()
+  bool host_trace;                               // get_host_trace()
+};
+
+namespace detail {
+
+// Current snapshot, nullptr until first use
+XRT_CORE_COMMON_EXPORT
+extern std::atomic<const snapshot*> current_snapshot;
+
+// Build and publish the initial snapshot
+XRT_CORE_COMMON_EXPORT
+const snapshot*
+init_snapshot();
+
+}
+
+/**
+ * get_snapshot() - Current snapshot of performance related settings
+ */
+inline const snapshot&
+get_snapshot()
+{
+  auto ss = detail::current_snapshot.load(std::memory_order_acquire);
+  return ss ? *ss : *detail::init_snapshot();
+}
+
+/**
+ * reload() - Reread ini file and publish a new snapshot
+ *
+ * @ini: Path to ini file
+ *
+ * Only snapshot fields are reloaded, the cached accessors above keep
+ * their values.  A key not present in the reread file keeps its value
+ * from process start.
+ */
+XRT_CORE_COMMON_EXPORT
+void
+reload(const std::string& ini);
+
 }} // config,xrt_core
 
 #endif
@@ -43,6 +43,39 @@
 #pragma warning ( disable : 4996 )
 #endif
 
+namespace {
+
+// Query requests whose result does not change for the lifetime of a
+// device object.  Cached results of these never expire.
+bool
+is_static_query(xrt_core::query::key_type key)
+{
+  using key_type = xrt_core::query::key_type;
+  switch (key) {
+  case key_type::pcie_vendor:
+  case key_type::pcie_device:
+  case key_type::pcie_subsystem_vendor:
+  case key_type::pcie_subsystem_id:
+  case key_type::pcie_link_speed_max:
+  case key_type::pcie_express_lane_width_max:
+  case key_type::pcie_bdf:
+  case key_type::rom_vbnv:
+  case key_type::rom_ddr_bank_size_gb:
+  case key_type::rom_ddr_bank_count_max:
+  case key_type::rom_fpga_name:
+  case key_type::rom_uuid:
+  case key_type::rom_time_since_epoch:
+  case key_type::xmc_serial_num:
+  case key_type::xmc_board_name:
+  case key_type::interface_uuids:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
 namespace xrt_core {
 
 device::
@@ -93,6 +126,61 @@ get_xclbin_uuid() const
   return m_xclbin ? m_xclbin.get_uuid() : uuid{};
 }
 
+boost::any
+device::
+get_cached_query(query::key_type query_key, std::chrono::milliseconds max_age,
+                 const std::function<boost::any()>& fetch) const
+{
+  auto now = std::chrono::steady_clock::now();
+  auto is_static = is_static_query(query_key);
+  {
+    std::lock_guard<std::mutex> lk(m_query_cache_mutex);
+    auto itr = m_query_cache.find(query_key);
+    if (itr != m_query_cache.end() && (is_static || now - (*itr).second.time <= max_age))
+      return (*itr).second.value;
+  }
+
+  // Query without holding the lock, concurrent callers may both query
+  // the device, the last result is cached.
+  auto value = fetch();
+  if (is_static || max_age.count()) {
+    std::lock_guard<std::mutex> lk(m_query_cache_mutex);
+    m_query_cache[query_key] = {now, value};
+  }
+  return value;
+}
+
+void
+device::
+clear_query_cache() const
+{
+  std::lock_guard<std::mutex> lk(m_query_cache_mutex);
+  m_query_cache.clear();
+}
+
+void
+device::
+set_pending_load(std::shared_future<void> load)
+{
+  std::lock_guard<std::mutex> lk(m_load_mutex);
+  if (load.valid() && m_pending_load.valid())
+    throw error(EBUSY, "xclbin load is already pending");
+  m_pending_load = std::move(load);
+}
+
+void
+device::
+wait_pending_load() const
+{
+  std::shared_future<void> load;
+  {
+    std::lock_guard<std::mutex> lk(m_load_mutex);
+    load = m_pending_load;
+  }
+  if (load.valid())
+    load.wait();
+}
+
 // Unforunately there are two independent entry points into loading an
 // xclbin.  One is this function via xrt::device::load_xclbin(), the
 // other is xclLoadXclBin(). The two entrypoints converge in
@@ -141,6 +229,58 @@ load_xclbin(const uuid& xclbin_id)
 #endif
 }
 
+void
+device::
+stage_xclbin(const xrt::xclbin& xclbin)
+{
+  try {
+    stage_axlf(xclbin.get_axlf());
+  }
+  catch (const std::system_error& ex) {
+    // Shim without staging support, the xclbin is staged by this
+    // object only and is downloaded in full when switched to
+    if (ex.code() != std::errc::not_supported)
+      throw;
+  }
+
+  std::lock_guard<std::mutex> lk(m_stage_mutex);
+  m_staged[xclbin.get_uuid()] = xclbin;
+}
+
+void
+device::
+unstage_xclbin(const uuid& xclbin_id)
+{
+  {
+    std::lock_guard<std::mutex> lk(m_stage_mutex);
+    if (!m_staged.erase(xclbin_id))
+      throw error(EINVAL, "xclbin is not staged");
+  }
+
+  try {
+    unstage_axlf(xclbin_id.get());
+  }
+  catch (const std::system_error&) {
+    // Not staged by the shim or the driver evicted it
+  }
+}
+
+void
+device::
+switch_xclbin(const uuid& xclbin_id)
+{
+  xrt::xclbin xclbin;
+  {
+    std::lock_guard<std::mutex> lk(m_stage_mutex);
+    auto itr = m_staged.find(xclbin_id);
+    if (itr == m_staged.end())
+      throw error(EINVAL, "xclbin is not staged");
+    xclbin = itr->second;
+  }
+
+  load_xclbin(xclbin);
+}
+
 xrt::xclbin
 device::
 get_xclbin(const uuid& xclbin_id) const
@@ -162,6 +302,9 @@ register_axlf(const axlf* top)
   if (!m_xclbin || m_xclbin.get_uuid() != uuid(top->m_header.uuid))
       m_xclbin = xrt::xclbin{top};
 
+  // Cached query results may depend on previously loaded xclbin
+  clear_query_cache();
+
   // Compute CU sort order, kernel driver zocl and xocl now assign and
   // control the sort order, which is accessible via a query request.
   // For emulation old xclbin_parser::get_cus is used.
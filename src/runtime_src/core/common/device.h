@@ -29,11 +29,17 @@
 #include "core/include/xrt.h"
 #include "core/include/experimental/xrt_xclbin.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <vector>
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 #include <boost/any.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/optional/optional.hpp>
@@ -158,6 +164,10 @@ public:
   query() const
   {
     auto& qr = lookup_query(QueryRequestType::key);
+    if (auto age = m_query_cache_age.load(std::memory_order_relaxed))
+      return get_cached_query(QueryRequestType::key, std::chrono::milliseconds(age), [this, &qr] {
+        return qr.get(this);
+      });
     return qr.get(this);
   }
 
@@ -176,6 +186,70 @@ public:
     return qr.get(this, std::forward<Args>(args)...);
   }
 
+  /**
+   * cached_query() - Query the device, allowing a stale result
+   *
+   * @QueryRequestType: Template parameter identifying a specific query request
+   * @max_age: Maximum age of a previously cached result
+   * Return: QueryRequestType::result_type value wrapped as boost::any.
+   *
+   * A result cached within max_age is returned without calling the
+   * query request.  Results of static query requests, e.g. pcie_bdf,
+   * never expire.  The cache is cleared when an xclbin is loaded.
+   */
+  template <typename QueryRequestType>
+  boost::any
+  cached_query(std::chrono::milliseconds max_age) const
+  {
+    return get_cached_query(QueryRequestType::key, max_age, [this] {
+      return lookup_query(QueryRequestType::key).get(this);
+    });
+  }
+
+  /**
+   * set_query_cache_age() - Serve all queries through the query cache
+   *
+   * @max_age: Maximum age of cached results, 0 to query the device always
+   *
+   * Tools that build one snapshot of the device from many queries,
+   * e.g. reports, set this so repeated requests are queried only once.
+   * Queries taking arguments are not cached.
+   */
+  void
+  set_query_cache_age(std::chrono::milliseconds max_age) const
+  {
+    m_query_cache_age = max_age.count();
+  }
+
+  /**
+   * clear_query_cache() - Discard all cached query results
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  clear_query_cache() const;
+
+  /**
+   * set_pending_load() - Register an asynchronous xclbin load
+   *
+   * @load: Future that is ready when load is done, or an invalid
+   *   future to clear a pending load.
+   *
+   * Throws if a load is already pending.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  set_pending_load(std::shared_future<void> load);
+
+  /**
+   * wait_pending_load() - Wait for a pending asynchronous xclbin load
+   *
+   * Returns immediately if no load is pending.  Errors of the load
+   * are not rethrown, they are reported to the caller of the load.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  wait_pending_load() const;
+
   /**
    * update() - Update a given property for this device
    *
@@ -205,6 +279,29 @@ public:
   void
   load_xclbin(const uuid& xclbin_id);
 
+  /**
+   * stage_xclbin() - Stage an xclbin for fast switching
+   *
+   * The xclbin is kept by this device object and, if supported by the
+   * shim, validated and copied to the driver without programming the
+   * device.  A later switch_xclbin() of the staged xclbin neither
+   * re-reads nor re-parses the xclbin.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  stage_xclbin(const xrt::xclbin& xclbin);
+
+  XRT_CORE_COMMON_EXPORT
+  void
+  unstage_xclbin(const uuid& xclbin_id);
+
+  /**
+   * switch_xclbin() - Load a staged xclbin
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  switch_xclbin(const uuid& xclbin_id);
+
 
   // Get the currently loaded xclbin
   // Throws if xclbin uuid does match
@@ -323,6 +420,30 @@ public:
   std::pair<size_t, size_t>
   get_ert_slots() const;
 
+  /**
+   * get_exec_state() - Get command execution state of device
+   *
+   * Return: State set by set_exec_state() or nullptr
+   *
+   * The state is created and owned by the command execution layer
+   * (kds or sws) and is cached with the device so that commands
+   * find it without a lookup.
+   */
+  void*
+  get_exec_state() const
+  {
+    return m_exec_state.load(std::memory_order_acquire);
+  }
+
+  /**
+   * set_exec_state() - Cache command execution state of device
+   */
+  void
+  set_exec_state(void* state) const
+  {
+    m_exec_state.store(state, std::memory_order_release);
+  }
+
   // Move all these 'pt' functions out the class interface
   virtual void get_info(boost::property_tree::ptree&) const {}
   /**
@@ -370,9 +491,32 @@ public:
   }
 
  private:
+  XRT_CORE_COMMON_EXPORT
+  boost::any
+  get_cached_query(query::key_type query_key, std::chrono::milliseconds max_age,
+                   const std::function<boost::any()>& fetch) const;
+
+  struct cached_result
+  {
+    std::chrono::steady_clock::time_point time;
+    boost::any value;
+  };
+
   id_type m_device_id;
   mutable boost::optional<bool> m_nodma = boost::none;
 
+  mutable std::mutex m_query_cache_mutex;
+  mutable std::map<query::key_type, cached_result> m_query_cache;
+  mutable std::atomic<std::chrono::milliseconds::rep> m_query_cache_age {0};
+
+  mutable std::atomic<void*> m_exec_state {nullptr};
+
+  mutable std::mutex m_load_mutex;
+  std::shared_future<void> m_pending_load;
+
+  std::mutex m_stage_mutex;
+  std::map<uuid, xrt::xclbin> m_staged;  // staged xclbins by uuid
+
   std::map<std::string, cuidx_type> m_cu2idx; // cu name mapping to cuidx
   std::vector<uint64_t> m_cus;           // cu base addresses in expeced sort order
   xrt::xclbin m_xclbin;                  // currently loaded xclbin
@@ -416,6 +560,57 @@ device_query(const std::shared_ptr<device>& device, Args&&... args)
   return boost::any_cast<typename QueryRequestType::result_type>(ret);
 }
 
+/**
+ * device_query_cached() - Retrieve query request data, allowing a stale result
+ *
+ * @device : device to retrieve data for
+ * @max_age : maximum age of a cached result
+ * Return: value per QueryRequestType
+ *
+ * Use for polling loops, e.g. monitoring, that tolerate results that
+ * are up to max_age old.
+ */
+template <typename QueryRequestType>
+inline typename QueryRequestType::result_type
+device_query_cached(const device* device, std::chrono::milliseconds max_age)
+{
+  auto ret = device->cached_query<QueryRequestType>(max_age);
+  return boost::any_cast<typename QueryRequestType::result_type>(ret);
+}
+
+template <typename QueryRequestType>
+inline typename QueryRequestType::result_type
+device_query_cached(const std::shared_ptr<device>& device, std::chrono::milliseconds max_age)
+{
+  return device_query_cached<QueryRequestType>(device.get(), max_age);
+}
+
+/**
+ * device_query_many() - Retrieve data of several query requests
+ *
+ * @device : device to retrieve data for
+ * @max_age : maximum age of cached results, 0 to always query
+ * Return: tuple of values per QueryRequestTypes
+ *
+ * Example:
+ *   auto res = device_query_many<query::pcie_bdf, query::rom_vbnv>(device);
+ *   auto& vbnv = std::get<1>(res);
+ */
+template <typename ...QueryRequestTypes>
+inline std::tuple<typename QueryRequestTypes::result_type...>
+device_query_many(const device* device, std::chrono::milliseconds max_age = std::chrono::milliseconds{0})
+{
+  return std::tuple<typename QueryRequestTypes::result_type...>
+    {device_query_cached<QueryRequestTypes>(device, max_age)...};
+}
+
+template <typename ...QueryRequestTypes>
+inline std::tuple<typename QueryRequestTypes::result_type...>
+device_query_many(const std::shared_ptr<device>& device, std::chrono::milliseconds max_age = std::chrono::milliseconds{0})
+{
+  return device_query_many<QueryRequestTypes...>(device.get(), max_age);
+}
+
 template <typename QueryRequestType, typename ...Args>
 inline void
 device_update(const device* device, Args&&... args)
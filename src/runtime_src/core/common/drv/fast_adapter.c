@@ -102,10 +102,19 @@ static void cu_fa_start(void *core)
 	u32 desc_msw = cu_fa->paddr >> 32;
 	u32 desc_lsw = (u32)cu_fa->paddr;
 
-	cu_fa->run_cnts++;
-
-	if (kds_echo || !cu_fa->cmdmem)
+	if (kds_echo || !cu_fa->cmdmem) {
+		cu_fa->run_cnts++;
 		return;
+	}
+
+	/* The CU was started from user space while user managed */
+	if (unlikely(READ_ONCE(cu_fa->resync)) && !cu_fa->run_cnts) {
+		cu_fa->task_cnt = cu_read32(cu_fa, TCR);
+		cu_fa->desc_msw = cu_read32(cu_fa, MSWR);
+		WRITE_ONCE(cu_fa->resync, 0);
+	}
+
+	cu_fa->run_cnts++;
 
 	/* The MSW of descriptor is fixed */
 	if (desc_msw != cu_fa->desc_msw) {
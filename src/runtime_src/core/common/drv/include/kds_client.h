@@ -18,6 +18,7 @@
 #include <linux/pid.h>
 #include <linux/device.h>
 #include <linux/uuid.h>
+#include <linux/hrtimer.h>
 
 #include "xrt_cu.h"
 #include "kds_stat.h"
@@ -52,8 +53,15 @@ struct kds_client_ctx {
  * @virt_cu_ref: Reference count of virtual CU
  * @cu_bitmap: bitmap of opening CU
  * @scu_bitmap: bitmap of opening SCU
+ * @last_cu: CU of previous command, used by CU affinity policy
+ * @weight: Commands run per turn on a CU with fair share, from the
+ *	    nice value of the process that opened the client
  * @waitq: Wait queue for poll client
  * @event: Events to notify user client
+ * @moderate_cnt: Completions accumulated before waking @waitq
+ * @moderate_us: Maximum microseconds a completion is held back
+ * @unsignaled: Completions not yet signaled on @waitq
+ * @moderate_timer: Wakes @waitq when @moderate_us expires
  */
 struct kds_client {
 	struct list_head	  link;
@@ -70,6 +78,8 @@ struct kds_client {
 
 	DECLARE_BITMAP(cu_bitmap, MAX_CUS);
 	DECLARE_BITMAP(scu_bitmap, MAX_CUS);
+	int			  last_cu;
+	u32			  weight;
 	/* Per client statistics. Use percpu variable for two reasons
 	 * 1. no lock is need while modifying these counters
 	 * 2. do not need to worry about cache false share
@@ -86,6 +96,10 @@ struct kds_client {
 	 */
 	wait_queue_head_t	  waitq ____cacheline_aligned_in_smp;
 	atomic_t		  event;
+	u32			  moderate_cnt;
+	u32			  moderate_us;
+	atomic_t		  unsignaled;
+	struct hrtimer		  moderate_timer;
 };
 
 /* Macros to operates client statistics */
@@ -98,4 +112,7 @@ struct kds_client {
 #define client_stat_dec(client, field) \
 	this_stat_dec((client)->stats, field)
 
+#define client_stat_add(client, field, val) \
+	this_stat_add((client)->stats, field, val)
+
 #endif
@@ -40,6 +40,7 @@ enum kds_opcode {
  * KDS_ERROR:		Command is error out
  * KDS_ABORT:		Command is abort
  * KDS_TIMEOUT:		Command is timeout
+ * KDS_EXPIRED:		Command deadline passed before it was started
  */
 enum kds_status {
 	KDS_NEW = 0,
@@ -49,6 +50,7 @@ enum kds_status {
 	KDS_ERROR,
 	KDS_ABORT,
 	KDS_TIMEOUT,
+	KDS_EXPIRED,
 	KDS_STAT_MAX,
 };
 
@@ -80,6 +82,7 @@ struct kds_command {
 	u32			 opcode;
 	struct list_head	 list;
 	u32			 payload_alloc;
+	u32			 payload_cache;
 	u32			 payload_type;
 	void			*info;
 	size_t			 isize;
@@ -89,6 +92,9 @@ struct kds_command {
 	void			*priv;
 
 	unsigned int		 tick;
+	u32			 priority;
+	/* CLOCK_MONOTONIC ns to start the command by, 0 for none */
+	u64			 deadline;
 	u32			 timestamp_enabled;
 	u64			 timestamp[KDS_STAT_MAX];
 
@@ -107,6 +113,7 @@ struct kds_command {
 	u32			*u_execbuf;
 	void			*gem_obj;
 	u32			 exec_bo_handle;
+	u32			 exec_bo_offset;
 	/* to notify inkernel exec completion */
 	struct in_kernel_cb	*inkern_cb;
 };
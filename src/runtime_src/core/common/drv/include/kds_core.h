@@ -70,6 +70,24 @@ struct kds_scu_mgmt {
 	struct cu_stats __percpu *cu_stats;
 };
 
+/* CU selection policy when a command can run on more than one CU
+ *
+ * KDS_CU_POLICY_USAGE:       CU with least completed commands
+ * KDS_CU_POLICY_INFLIGHT:    CU with least in-flight commands
+ * KDS_CU_POLICY_ROUND_ROBIN: Next CU in turn
+ * KDS_CU_POLICY_AFFINITY:    Same CU as client's previous command,
+ *                            unless that CU has KDS_AFFINITY_SLACK more
+ *                            in-flight commands than the least busy CU
+ */
+enum kds_cu_policy {
+	KDS_CU_POLICY_USAGE = 0,
+	KDS_CU_POLICY_INFLIGHT,
+	KDS_CU_POLICY_ROUND_ROBIN,
+	KDS_CU_POLICY_AFFINITY,
+	KDS_CU_POLICY_MAX,
+};
+#define KDS_AFFINITY_SLACK	2
+
 /* the MSB of cu_refs is used for exclusive flag */
 #define CU_EXCLU_MASK		0x80000000
 struct kds_cu_mgmt {
@@ -81,6 +99,14 @@ struct kds_cu_mgmt {
 	u32			  cu_refs[MAX_CUS];
 	struct cu_stats __percpu *cu_stats;
 	int			  rw_shared;
+	int			  policy;
+	atomic_t		  rr_next;
+	struct xrt_cu_sched	  sched;
+	/* Adaptive polling state, see kds_poll_busy_cus() */
+	DECLARE_BITMAP(poll_cus, MAX_CUS);
+	u64			  poll_done[MAX_CUS];
+	u64			  poll_ts[MAX_CUS];
+	u64			  poll_period[MAX_CUS];
 };
 
 #define cu_stat_read(cu_mgmt, field) \
@@ -130,6 +156,12 @@ struct cmdmem_info {
  * @cu_intr: CU or ERT interrupt. 1 for CU, 0 for ERT.
  * @anon_client: driver own kds client used with driver generated command
  * @polling_thread: poll CUs when ERT is disabled
+ * @interval: polling thread sleep in microseconds, the maximum sleep
+ *	      in adaptive mode
+ * @polling_adaptive: poll only busy CUs and sleep based on how often
+ *		      their commands complete
+ * @moderate_cnt: completions a client accumulates before it is woken up
+ * @moderate_us: maximum microseconds a completion is held back
  */
 struct kds_sched {
 	struct list_head	clients;
@@ -153,6 +185,9 @@ struct kds_sched {
 	int			polling_start;
 	int			polling_stop;
 	u32			interval;
+	bool			polling_adaptive;
+	u32			moderate_cnt;
+	u32			moderate_us;
 };
 
 int kds_init_sched(struct kds_sched *kds);
@@ -161,6 +196,7 @@ int kds_init_client(struct kds_sched *kds, struct kds_client *client);
 void kds_fini_sched(struct kds_sched *kds);
 int kds_fini_ert(struct kds_sched *kds);
 void kds_fini_client(struct kds_sched *kds, struct kds_client *client);
+void kds_client_signal(struct kds_client *client);
 void kds_reset(struct kds_sched *kds);
 int kds_cfg_update(struct kds_sched *kds);
 void kds_cus_irq_enable(struct kds_sched *kds, bool enable);
@@ -180,9 +216,12 @@ int kds_add_context(struct kds_sched *kds, struct kds_client *client,
 int kds_del_context(struct kds_sched *kds, struct kds_client *client,
 		    struct kds_ctx_info *info);
 int kds_open_ucu(struct kds_sched *kds, struct kds_client *client, u32 cu_idx);
+int kds_map_fa_desc(struct kds_sched *kds, struct kds_client *client,
+		    int idx, unsigned long size, u64 *addrp);
 int kds_map_cu_addr(struct kds_sched *kds, struct kds_client *client,
 		    int idx, unsigned long size, u32 *addrp);
 int kds_add_command(struct kds_sched *kds, struct kds_command *xcmd);
+int kds_add_commands(struct kds_sched *kds, struct kds_command **xcmds, int num);
 /* Use this function in xclbin download flow for config commands */
 int kds_submit_cmd_and_wait(struct kds_sched *kds, struct kds_command *xcmd);
 
@@ -195,6 +234,8 @@ int kds_ip_layout2cu_info(struct ip_layout *ip_layout, struct xrt_cu_info cu_inf
 int store_kds_echo(struct kds_sched *kds, const char *buf, size_t count,
 		   int *echo);
 ssize_t show_kds_stat(struct kds_sched *kds, char *buf);
+int store_kds_cu_policy(struct kds_sched *kds, const char *buf, size_t count);
+ssize_t show_kds_cu_policy(struct kds_sched *kds, char *buf);
 ssize_t show_kds_custat_raw(struct kds_sched *kds, char *buf);
 ssize_t show_kds_scustat_raw(struct kds_sched *kds, char *buf);
 #endif
@@ -36,6 +36,12 @@ struct client_stats {
 	unsigned long		scu_s_cnt[MAX_CUS];
 	/* Per soft CU counter that counts when a command is completed or error */
 	unsigned long		scu_c_cnt[MAX_CUS];
+	/* Sum of submit to complete time of commands with timestamps */
+	u64			lat_ns;
+	/* Number of commands in lat_ns */
+	u64			lat_cnt;
+	/* Number of commands dropped because their deadline passed */
+	u64			expired;
 };
 
 struct cu_stats {
@@ -58,6 +64,9 @@ struct cu_stats {
 #define this_stat_dec(statp, field) \
 	this_cpu_add((statp)->field, -1)
 
+#define this_stat_add(statp, field, val) \
+	this_cpu_add((statp)->field, val)
+
 #define stat_read(statp, field)					\
 ({								\
 	typeof((statp)->field) res = 0;				\
@@ -253,6 +253,16 @@ struct xrt_cu_log {
 #define CU_LOG_STAGE_SQ		3
 #define CU_LOG_STAGE_CQ		4
 
+/* Run queue dispatch policy, shared by the CUs of a scheduler
+ * @fair_share: clients take turns on the CU instead of FIFO order
+ * @client_depth: maximum commands of a client running on a CU with
+ *		  fair share, 0 for no limit
+ */
+struct xrt_cu_sched {
+	u32			  fair_share;
+	u32			  client_depth;
+};
+
 /* Supported event type */
 struct xrt_cu {
 	struct device		 *dev;
@@ -262,6 +272,8 @@ struct xrt_cu {
 	struct list_head	  pq;
 	spinlock_t		  pq_lock;
 	u32			  num_pq;
+	/* pending commands with other than normal priority */
+	u32			  num_pq_prio;
 	/* high priority queue */
 	struct list_head	  hpq;
 	spinlock_t		  hpq_lock;
@@ -276,6 +288,10 @@ struct xrt_cu {
 	/* run queue */
 	struct list_head	  rq ____cacheline_aligned_in_smp;
 	u32			  num_rq;
+	/* fair share turn, see select_rq_cmd() */
+	struct xrt_cu_sched	 *sched;
+	struct kds_client	 *rr_client;
+	u32			  rr_left;
 	/* submitted queue */
 	struct list_head	  sq;
 	u32			  num_sq;
@@ -284,6 +300,8 @@ struct xrt_cu {
 	u32			  num_cq;
 	struct semaphore	  sem;
 	struct semaphore	  sem_cu;
+	/* Commands submitted to this CU and not yet completed */
+	atomic_t		  inflight;
 	void			 *core;
 	u32			  stop;
 	bool			  bad_state;
@@ -445,13 +463,21 @@ u32 round_up_to_next_power2(u32 size)
  * 3. Check if submitted command is completed or not
  */
 void xrt_cu_submit(struct xrt_cu *xcu, struct kds_command *xcmd);
+void xrt_cu_submit_list(struct xrt_cu *xcu, struct list_head *cmds, u32 num);
 void xrt_cu_hpq_submit(struct xrt_cu *xcu, struct kds_command *xcmd);
 void xrt_cu_abort(struct xrt_cu *xcu, struct kds_client *client);
 bool xrt_cu_abort_done(struct xrt_cu *xcu, struct kds_client *client);
 int xrt_cu_cfg_update(struct xrt_cu *xcu, int intr);
 int xrt_fa_cfg_update(struct xrt_cu *xcu, u64 bar, u64 dev, void __iomem *vaddr, u32 num_slots);
 int xrt_is_fa(struct xrt_cu *xcu, u32 *size);
+int xrt_fa_get_desc(struct xrt_cu *xcu, u64 *bar, u64 *dev, u32 *slot_sz, u32 *num_slots);
+void xrt_fa_resync(struct xrt_cu *xcu);
 int xrt_cu_get_protocol(struct xrt_cu *xcu);
+
+static inline u32 xrt_cu_inflight(struct xrt_cu *xcu)
+{
+	return atomic_read(&xcu->inflight);
+}
 u32 xrt_cu_get_status(struct xrt_cu *xcu);
 int xrt_cu_regmap_size(struct xrt_cu *xcu);
 
@@ -503,6 +529,7 @@ struct xrt_cu_fa {
 	void __iomem		*vaddr;
 	void __iomem		*cmdmem;
 	u64			 paddr;
+	u64			 bar_paddr;
 	u32			 slot_sz;
 	u32			 num_slots;
 	u32			 head_slot;
@@ -512,6 +539,7 @@ struct xrt_cu_fa {
 	int			 credits;
 	int			 run_cnts;
 	u64			 check_count;
+	int			 resync;
 };
 
 int xrt_cu_fa_init(struct xrt_cu *xcu);
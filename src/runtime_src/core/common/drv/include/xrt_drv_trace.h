@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: GPL-2.0 OR Apache-2.0 */
+/*
+ * Xilinx Kernel Driver Scheduler tracepoints
+ *
+ * Copyright (C) 2022 Xilinx, Inc. All rights reserved.
+ *
+ * This file is dual-licensed; you may select either the GNU General Public
+ * License version 2 or Apache License, Version 2.0.
+ *
+ * The tracepoints follow a command from submission to notification,
+ *   xrt:xrt_kds_submit      command is added to KDS
+ *   xrt:xrt_cu_dispatch     command is started on a CU
+ *   xrt:xrt_cu_done         CU reports the command done
+ *   xrt:xrt_cu_notify       host is notified of the command completion
+ * e.g.
+ *   % perf record -e 'xrt:*' -a
+ * The command is identified by its exec_bo_handle, which is also passed
+ * to the xrt:run_start and xrt:kds_launch user space probes.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM xrt
+
+#if !defined(_XRT_DRV_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _XRT_DRV_TRACE_H
+
+#include <linux/tracepoint.h>
+#include "kds_command.h"
+
+TRACE_EVENT(xrt_kds_submit,
+	TP_PROTO(struct kds_command *xcmd),
+	TP_ARGS(xcmd),
+	TP_STRUCT__entry(
+		__field(const void *, xcmd)
+		__field(u32, exec_bo_handle)
+		__field(u32, type)
+		__field(u32, opcode)
+	),
+	TP_fast_assign(
+		__entry->xcmd = xcmd;
+		__entry->exec_bo_handle = xcmd->exec_bo_handle;
+		__entry->type = xcmd->type;
+		__entry->opcode = xcmd->opcode;
+	),
+	TP_printk("xcmd=%p bo=%u type=%u opcode=%u", __entry->xcmd,
+		__entry->exec_bo_handle, __entry->type, __entry->opcode)
+);
+
+DECLARE_EVENT_CLASS(xrt_cu_cmd,
+	TP_PROTO(int cu_idx, struct kds_command *xcmd),
+	TP_ARGS(cu_idx, xcmd),
+	TP_STRUCT__entry(
+		__field(int, cu_idx)
+		__field(const void *, xcmd)
+		__field(u32, exec_bo_handle)
+		__field(int, status)
+	),
+	TP_fast_assign(
+		__entry->cu_idx = cu_idx;
+		__entry->xcmd = xcmd;
+		__entry->exec_bo_handle = xcmd->exec_bo_handle;
+		__entry->status = xcmd->status;
+	),
+	TP_printk("cu=%d xcmd=%p bo=%u status=%d", __entry->cu_idx,
+		__entry->xcmd, __entry->exec_bo_handle, __entry->status)
+);
+
+DEFINE_EVENT(xrt_cu_cmd, xrt_cu_dispatch,
+	TP_PROTO(int cu_idx, struct kds_command *xcmd),
+	TP_ARGS(cu_idx, xcmd)
+);
+
+DEFINE_EVENT(xrt_cu_cmd, xrt_cu_done,
+	TP_PROTO(int cu_idx, struct kds_command *xcmd),
+	TP_ARGS(cu_idx, xcmd)
+);
+
+DEFINE_EVENT(xrt_cu_cmd, xrt_cu_notify,
+	TP_PROTO(int cu_idx, struct kds_command *xcmd),
+	TP_ARGS(cu_idx, xcmd)
+);
+
+#endif /* _XRT_DRV_TRACE_H */
+
+/* Header is found through the driver include path */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE xrt_drv_trace
+#include <trace/define_trace.h>
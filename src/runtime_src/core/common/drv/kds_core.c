@@ -18,8 +18,103 @@
 #include <linux/fs.h>
 #include <linux/poll.h>
 #include <linux/anon_inodes.h>
+#include <linux/math64.h>
+#include <linux/timekeeping.h>
 #include "kds_core.h"
 
+#define CREATE_TRACE_POINTS
+#include "xrt_drv_trace.h"
+
+/* Commands and payloads are allocated from caches shared by all
+ * devices. Payloads up to 4KB come from power of 2 sized caches,
+ * larger payloads from kmalloc. Usage of the caches is reported in
+ * /proc/slabinfo.
+ */
+#define KDS_PAYLOAD_MIN_SHIFT	6
+#define KDS_PAYLOAD_MAX_SHIFT	12
+#define KDS_PAYLOAD_CACHES	(KDS_PAYLOAD_MAX_SHIFT - KDS_PAYLOAD_MIN_SHIFT + 1)
+#define KDS_PAYLOAD_KMALLOC	KDS_PAYLOAD_CACHES
+
+static DEFINE_MUTEX(kds_cache_lock);
+static int kds_cache_users;
+static struct kmem_cache *kds_cmd_cache;
+static struct kmem_cache *kds_payload_caches[KDS_PAYLOAD_CACHES];
+static const char *kds_payload_cache_names[KDS_PAYLOAD_CACHES] = {
+	"xrt_kds_payload_64",
+	"xrt_kds_payload_128",
+	"xrt_kds_payload_256",
+	"xrt_kds_payload_512",
+	"xrt_kds_payload_1024",
+	"xrt_kds_payload_2048",
+	"xrt_kds_payload_4096",
+};
+
+static void kds_destroy_caches(void)
+{
+	int i;
+
+	for (i = 0; i < KDS_PAYLOAD_CACHES; i++) {
+		if (kds_payload_caches[i])
+			kmem_cache_destroy(kds_payload_caches[i]);
+		kds_payload_caches[i] = NULL;
+	}
+
+	if (kds_cmd_cache)
+		kmem_cache_destroy(kds_cmd_cache);
+	kds_cmd_cache = NULL;
+}
+
+static int kds_get_caches(void)
+{
+	int ret = 0;
+	int i;
+
+	mutex_lock(&kds_cache_lock);
+	if (kds_cache_users++)
+		goto out;
+
+	kds_cmd_cache = kmem_cache_create("xrt_kds_cmd", sizeof(struct kds_command),
+					  0, SLAB_HWCACHE_ALIGN, NULL);
+	if (!kds_cmd_cache)
+		goto err;
+
+	for (i = 0; i < KDS_PAYLOAD_CACHES; i++) {
+		kds_payload_caches[i] =
+			kmem_cache_create(kds_payload_cache_names[i],
+					  1 << (KDS_PAYLOAD_MIN_SHIFT + i),
+					  0, 0, NULL);
+		if (!kds_payload_caches[i])
+			goto err;
+	}
+	goto out;
+
+err:
+	kds_destroy_caches();
+	kds_cache_users--;
+	ret = -ENOMEM;
+out:
+	mutex_unlock(&kds_cache_lock);
+	return ret;
+}
+
+static void kds_put_caches(void)
+{
+	mutex_lock(&kds_cache_lock);
+	if (!--kds_cache_users)
+		kds_destroy_caches();
+	mutex_unlock(&kds_cache_lock);
+}
+
+/* Index of smallest payload cache that fits size */
+static inline u32 kds_payload_cache_idx(u32 size)
+{
+	if (size <= (1 << KDS_PAYLOAD_MIN_SHIFT))
+		return 0;
+	if (size > (1 << KDS_PAYLOAD_MAX_SHIFT))
+		return KDS_PAYLOAD_KMALLOC;
+	return fls(size - 1) - KDS_PAYLOAD_MIN_SHIFT;
+}
+
 /* for sysfs */
 int store_kds_echo(struct kds_sched *kds, const char *buf, size_t count,
 		   int *echo)
@@ -77,6 +172,43 @@ ssize_t show_kds_custat_raw(struct kds_sched *kds, char *buf)
 	return sz;
 }
 
+static const char *kds_cu_policy_names[KDS_CU_POLICY_MAX] = {
+	[KDS_CU_POLICY_USAGE]		= "usage",
+	[KDS_CU_POLICY_INFLIGHT]	= "inflight",
+	[KDS_CU_POLICY_ROUND_ROBIN]	= "round_robin",
+	[KDS_CU_POLICY_AFFINITY]	= "affinity",
+};
+
+int store_kds_cu_policy(struct kds_sched *kds, const char *buf, size_t count)
+{
+	int i;
+
+	for (i = 0; i < KDS_CU_POLICY_MAX; ++i) {
+		if (sysfs_streq(buf, kds_cu_policy_names[i])) {
+			WRITE_ONCE(kds->cu_mgmt.policy, i);
+			return count;
+		}
+	}
+
+	return -EINVAL;
+}
+
+ssize_t show_kds_cu_policy(struct kds_sched *kds, char *buf)
+{
+	ssize_t sz = 0;
+	int policy = READ_ONCE(kds->cu_mgmt.policy);
+	int i;
+
+	/* Same format as other sysfs choice nodes, e.g. "[inflight]" */
+	for (i = 0; i < KDS_CU_POLICY_MAX; ++i)
+		sz += scnprintf(buf+sz, PAGE_SIZE - sz,
+				(i == policy) ? "[%s] " : "%s ",
+				kds_cu_policy_names[i]);
+	sz += scnprintf(buf+sz, PAGE_SIZE - sz, "\n");
+
+	return sz;
+}
+
 /* Each line is a PS kernel, format:
  * "idx kernel_name status usage"
  */
@@ -172,6 +304,78 @@ kds_wake_up_poll(struct kds_sched *kds)
 	return 0;
 }
 
+/* Adaptive polling sleeps at most this long if kds->interval is 0 */
+#define KDS_POLL_MAX_US		1000
+/* Adaptive polling spins instead of sleeping less than this */
+#define KDS_POLL_SPIN_NS	(2 * NSEC_PER_USEC)
+
+/**
+ * kds_poll_busy_cus - Process CUs with outstanding commands
+ *
+ * @kds: KDS scheduler
+ * @sleep_ns: Returns how long the polling thread can sleep
+ *
+ * Only CUs in the poll_cus bitmap are processed.  A CU's bit is set
+ * when a command is dispatched to it and cleared once it is idle.
+ *
+ * For each CU the average time between command completions is kept,
+ * which under load is the kernel duration.  The sleep is half of the
+ * shortest average over the busy CUs, so short kernels are polled
+ * without sleeping while long running kernels let the thread sleep.
+ *
+ * Returns the number of busy CUs.
+ */
+static int kds_poll_busy_cus(struct kds_sched *kds, u64 *sleep_ns)
+{
+	struct kds_cu_mgmt *cu_mgmt = &kds->cu_mgmt;
+	u32 max_us = kds->interval ? kds->interval : KDS_POLL_MAX_US;
+	u64 now = ktime_get_raw_fast_ns();
+	struct xrt_cu *xcu;
+	int busy_cnt = 0;
+	u64 done;
+	int i;
+
+	*sleep_ns = (u64)max_us * NSEC_PER_USEC;
+	for_each_set_bit(i, cu_mgmt->poll_cus, MAX_CUS) {
+		/* Clear before processing, a dispatch sets it again */
+		clear_bit(i, cu_mgmt->poll_cus);
+		xcu = cu_mgmt->xcus[i];
+		if (!xcu)
+			continue;
+
+		/* Restart the measurement when CU was idle */
+		if (!cu_mgmt->poll_ts[i]) {
+			cu_mgmt->poll_ts[i] = now;
+			cu_mgmt->poll_done[i] = xcu->cu_stat.usage;
+		}
+
+		if (xrt_cu_process_queues(xcu) != XCU_BUSY) {
+			cu_mgmt->poll_ts[i] = 0;
+			continue;
+		}
+		set_bit(i, cu_mgmt->poll_cus);
+		busy_cnt++;
+
+		done = xcu->cu_stat.usage;
+		if (done != cu_mgmt->poll_done[i]) {
+			u64 period = div64_u64(now - cu_mgmt->poll_ts[i],
+					       done - cu_mgmt->poll_done[i]);
+
+			/* Moving average over about 4 completions */
+			if (cu_mgmt->poll_period[i])
+				period = (3 * cu_mgmt->poll_period[i] + period) / 4;
+			cu_mgmt->poll_period[i] = period;
+			cu_mgmt->poll_done[i] = done;
+			cu_mgmt->poll_ts[i] = now;
+		}
+
+		if (cu_mgmt->poll_period[i])
+			*sleep_ns = min(*sleep_ns, cu_mgmt->poll_period[i] / 2);
+	}
+
+	return busy_cnt;
+}
+
 static int kds_polling_thread(void *data)
 {
 	struct kds_sched *kds = (struct kds_sched *)data;
@@ -180,8 +384,19 @@ static int kds_polling_thread(void *data)
 	int busy_cnt = 0;
 	int loop_cnt = 0;
 	int cu_idx = 0;
+	u64 sleep_ns;
+	u32 sleep_us;
 
 	while (!kds->polling_stop) {
+		if (kds->polling_adaptive) {
+			busy_cnt = kds_poll_busy_cus(kds, &sleep_ns);
+			if (busy_cnt && sleep_ns >= KDS_POLL_SPIN_NS) {
+				sleep_us = div_u64(sleep_ns, NSEC_PER_USEC);
+				usleep_range(sleep_us, sleep_us + 3);
+			}
+			goto next;
+		}
+
 		busy_cnt = 0;
 		for (cu_idx = 0; cu_idx < MAX_CUS; cu_idx++) {
 			if (!xcus[cu_idx])
@@ -198,6 +413,8 @@ static int kds_polling_thread(void *data)
 		if (kds->interval > 0)
 			usleep_range(kds->interval, kds->interval + 3);
 
+next:
+
 		/* Avoid large num_rq leads to more 120 sec blocking */
 		if (++loop_cnt == 8) {
 			loop_cnt = 0;
@@ -268,6 +485,103 @@ kds_scu_config(struct kds_scu_mgmt *scu_mgmt, struct kds_command *xcmd)
 	return 0;
 }
 
+/* CU with minimum completed commands */
+static uint8_t
+least_usage_cu(struct kds_cu_mgmt *cu_mgmt, uint8_t *valid_cus, int num_valid)
+{
+	uint8_t index = valid_cus[0];
+	u64 min_usage = cu_stat_read(cu_mgmt, usage[index]);
+	u64 usage;
+	int i;
+
+	for (i = 1; i < num_valid; ++i) {
+		usage = cu_stat_read(cu_mgmt, usage[valid_cus[i]]);
+		if (usage < min_usage) {
+			min_usage = usage;
+			index = valid_cus[i];
+		}
+	}
+
+	return index;
+}
+
+/* CU with minimum in-flight commands, ties are broken by usage so that
+ * an idle device behaves as with KDS_CU_POLICY_USAGE.
+ */
+static uint8_t
+least_inflight_cu(struct kds_cu_mgmt *cu_mgmt, uint8_t *valid_cus,
+		  int num_valid, u32 *min_inflight)
+{
+	uint8_t index = valid_cus[0];
+	u32 min = xrt_cu_inflight(cu_mgmt->xcus[index]);
+	u64 min_usage = cu_stat_read(cu_mgmt, usage[index]);
+	u64 usage;
+	u32 inflight;
+	int i;
+
+	for (i = 1; i < num_valid; ++i) {
+		inflight = xrt_cu_inflight(cu_mgmt->xcus[valid_cus[i]]);
+		if (inflight > min)
+			continue;
+
+		usage = cu_stat_read(cu_mgmt, usage[valid_cus[i]]);
+		if (inflight < min || usage < min_usage) {
+			min = inflight;
+			min_usage = usage;
+			index = valid_cus[i];
+		}
+	}
+
+	if (min_inflight)
+		*min_inflight = min;
+	return index;
+}
+
+/**
+ * select_cu_idx - Select CU among valid CUs per CU policy
+ *
+ * @cu_mgmt: CU management
+ * @client: Client submitting the command
+ * @valid_cus: CUs the command may run on and are in client context
+ * @num_valid: Number of valid CUs, must be greater than 1
+ *
+ * The in-flight count of a CU is read without lock, the selection is a
+ * best effort based on a snapshot of the CU queues.
+ */
+static uint8_t
+select_cu_idx(struct kds_cu_mgmt *cu_mgmt, struct kds_client *client,
+	      uint8_t *valid_cus, int num_valid)
+{
+	uint8_t index;
+	u32 min_inflight;
+	int last;
+	int i;
+
+	switch (READ_ONCE(cu_mgmt->policy)) {
+	case KDS_CU_POLICY_INFLIGHT:
+		return least_inflight_cu(cu_mgmt, valid_cus, num_valid, NULL);
+	case KDS_CU_POLICY_ROUND_ROBIN:
+		i = atomic_inc_return(&cu_mgmt->rr_next);
+		return valid_cus[(u32)i % num_valid];
+	case KDS_CU_POLICY_AFFINITY:
+		index = least_inflight_cu(cu_mgmt, valid_cus, num_valid,
+					  &min_inflight);
+		last = READ_ONCE(client->last_cu);
+		for (i = 0; last >= 0 && i < num_valid; ++i) {
+			if (valid_cus[i] != last)
+				continue;
+			if (xrt_cu_inflight(cu_mgmt->xcus[last]) <=
+			    min_inflight + KDS_AFFINITY_SLACK)
+				index = last;
+			break;
+		}
+		WRITE_ONCE(client->last_cu, index);
+		return index;
+	default:
+		return least_usage_cu(cu_mgmt, valid_cus, num_valid);
+	}
+}
+
 /**
  * acquire_cu_idx - Get ready CU index
  *
@@ -287,8 +601,6 @@ acquire_cu_idx(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 	uint8_t valid_cus[MAX_CUS];
 	int num_valid = 0;
 	uint8_t index;
-	u64 usage;
-	u64 min_usage;
 	int i;
 
 	num_marked = cu_mask_to_cu_idx(xcmd, user_cus);
@@ -313,13 +625,7 @@ acquire_cu_idx(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 		return -EINVAL;
 	}
 
-	/* Find out the CU with minimum usage */
-	for (i = 1, index = valid_cus[0]; i < num_valid; ++i) {
-		usage = cu_stat_read(cu_mgmt, usage[valid_cus[i]]);
-		min_usage = cu_stat_read(cu_mgmt, usage[index]);
-		if (usage < min_usage)
-			index = valid_cus[i];
-	}
+	index = select_cu_idx(cu_mgmt, client, valid_cus, num_valid);
 
 out:
 	if (xrt_cu_get_protocol(cu_mgmt->xcus[index]) == CTRL_NONE) {
@@ -369,6 +675,7 @@ kds_cu_dispatch(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 
 	xrt_cu_submit(cu_mgmt->xcus[cu_idx], xcmd);
 	set_xcmd_timestamp(xcmd, KDS_QUEUED);
+	set_bit(cu_idx, cu_mgmt->poll_cus);
 	return 0;
 }
 
@@ -376,6 +683,11 @@ static void
 kds_cu_abort_cmd(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 {
 	struct kds_sched *kds;
+	/* An abort command listing more than one command is broadcast to
+	 * all CUs, a single command is only on one CU.
+	 */
+	bool batch = xcmd->isize > sizeof(u64);
+	int status = KDS_ERROR;
 	int i;
 
 	/* Broadcast abort command to each CU and let CU finds out how to abort
@@ -385,6 +697,7 @@ kds_cu_abort_cmd(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 		if (!cu_mgmt->xcus[i])
 			continue;
 
+		set_bit(i, cu_mgmt->poll_cus);
 		xrt_cu_hpq_submit(cu_mgmt->xcus[i], xcmd);
 
 		if (xcmd->status == KDS_NEW)
@@ -396,13 +709,18 @@ kds_cu_abort_cmd(struct kds_cu_mgmt *cu_mgmt, struct kds_command *xcmd)
 			kds_info(xcmd->client, "CU(%d) hangs, reset device", i);
 		}
 
-		xcmd->cb.notify_host(xcmd, xcmd->status);
-		xcmd->cb.free(xcmd);
-		return;
+		/* Keep the worst status of the CUs that found commands */
+		if (status == KDS_ERROR || xcmd->status != KDS_COMPLETED)
+			status = xcmd->status;
+
+		if (!batch)
+			break;
+
+		xcmd->status = KDS_NEW;
 	}
 
-	/* Command is not found in any CUs and any queues */
-	xcmd->status = KDS_ERROR;
+	/* KDS_ERROR if command is not found in any CUs and any queues */
+	xcmd->status = status;
 	xcmd->cb.notify_host(xcmd, xcmd->status);
 	xcmd->cb.free(xcmd);
 }
@@ -743,6 +1061,8 @@ static int kds_ucu_release(struct inode *inode, struct file *filp)
 	struct xrt_cu *xcu = filp->private_data;
 
 	xcu->user_manage_irq(xcu, false);
+	if (xrt_is_fa(xcu, NULL))
+		xrt_fa_resync(xcu);
 	clear_bit(0, xcu->is_ucu);
 
 	return 0;
@@ -884,6 +1204,8 @@ int kds_init_sched(struct kds_sched *kds)
 	mutex_init(&kds->lock);
 	mutex_init(&kds->cu_mgmt.lock);
 	mutex_init(&kds->scu_mgmt.lock);
+	kds->cu_mgmt.policy = KDS_CU_POLICY_INFLIGHT;
+	atomic_set(&kds->cu_mgmt.rr_next, 0);
 	kds->num_client = 0;
 	kds->bad_state = 0;
 	/* At this point, I don't know if ERT subdev exist or not */
@@ -892,7 +1214,7 @@ int kds_init_sched(struct kds_sched *kds)
 	init_completion(&kds->comp);
 	init_waitqueue_head(&kds->wait_queue);
 
-	return 0;
+	return kds_get_caches();
 }
 
 void kds_fini_sched(struct kds_sched *kds)
@@ -901,13 +1223,15 @@ void kds_fini_sched(struct kds_sched *kds)
 	mutex_destroy(&kds->cu_mgmt.lock);
 
 	free_percpu(kds->cu_mgmt.cu_stats);
+	kds_put_caches();
 }
 
 struct kds_command *kds_alloc_command(struct kds_client *client, u32 size)
 {
 	struct kds_command *xcmd;
+	u32 idx;
 
-	xcmd = kzalloc(sizeof(struct kds_command), GFP_KERNEL);
+	xcmd = kmem_cache_zalloc(kds_cmd_cache, GFP_KERNEL);
 	if (!xcmd)
 		return NULL;
 
@@ -921,13 +1245,18 @@ struct kds_command *kds_alloc_command(struct kds_client *client, u32 size)
 	if (size == 0)
 		goto done;
 
-	xcmd->info = kzalloc(size, GFP_KERNEL);
+	idx = kds_payload_cache_idx(size);
+	if (idx == KDS_PAYLOAD_KMALLOC)
+		xcmd->info = kzalloc(size, GFP_KERNEL);
+	else
+		xcmd->info = kmem_cache_zalloc(kds_payload_caches[idx], GFP_KERNEL);
 	if (!xcmd->info) {
-		kfree(xcmd);
+		kmem_cache_free(kds_cmd_cache, xcmd);
 		return NULL;
 	}
 	xcmd->isize = size;
 	xcmd->payload_alloc = 1;
+	xcmd->payload_cache = idx;
 
 done:
 	return xcmd;
@@ -938,9 +1267,13 @@ void kds_free_command(struct kds_command *xcmd)
 	if (!xcmd)
 		return;
 
-	if (xcmd->payload_alloc)
-		kfree(xcmd->info);
-	kfree(xcmd);
+	if (xcmd->payload_alloc) {
+		if (xcmd->payload_cache == KDS_PAYLOAD_KMALLOC)
+			kfree(xcmd->info);
+		else
+			kmem_cache_free(kds_payload_caches[xcmd->payload_cache], xcmd->info);
+	}
+	kmem_cache_free(kds_cmd_cache, xcmd);
 }
 
 int kds_add_command(struct kds_sched *kds, struct kds_command *xcmd)
@@ -951,6 +1284,8 @@ int kds_add_command(struct kds_sched *kds, struct kds_command *xcmd)
 	BUG_ON(!xcmd->cb.notify_host);
 	BUG_ON(!xcmd->cb.free);
 
+	trace_xrt_kds_submit(xcmd);
+
 	/* TODO: Check if command is blocked */
 
 	/* Command is good to submit */
@@ -972,6 +1307,95 @@ int kds_add_command(struct kds_sched *kds, struct kds_command *xcmd)
 	return err;
 }
 
+/* Queue CU start commands xcmds[0..num), which have a CU selected, to
+ * the CU pending queues. Commands to the same CU are queued together.
+ */
+static void
+kds_cu_dispatch_batch(struct kds_cu_mgmt *cu_mgmt, struct kds_command **xcmds,
+		      int num)
+{
+	LIST_HEAD(cmds);
+	int cu_idx;
+	u32 cnt;
+	int i, j;
+
+	for (i = 0; i < num; i++) {
+		if (!xcmds[i])
+			continue;
+
+		cu_idx = xcmds[i]->cu_idx;
+		cnt = 0;
+		for (j = i; j < num; j++) {
+			if (!xcmds[j] || xcmds[j]->cu_idx != cu_idx)
+				continue;
+
+			set_xcmd_timestamp(xcmds[j], KDS_QUEUED);
+			list_add_tail(&xcmds[j]->list, &cmds);
+			xcmds[j] = NULL;
+			cnt++;
+		}
+		xrt_cu_submit_list(cu_mgmt->xcus[cu_idx], &cmds, cnt);
+		set_bit(cu_idx, cu_mgmt->poll_cus);
+	}
+}
+
+/* Submit many commands of a client in one call. Consecutive start
+ * commands handled by CUs are queued with one acquisition of each CU
+ * pending queue lock and the polling thread is woken up once for them.
+ * Other commands are submitted in order as by kds_add_command().
+ *
+ * All commands are consumed. A command that fails is completed with
+ * KDS_ERROR and the first error is returned.
+ */
+int kds_add_commands(struct kds_sched *kds, struct kds_command **xcmds, int num)
+{
+	struct kds_cu_mgmt *cu_mgmt = &kds->cu_mgmt;
+	struct kds_command *xcmd;
+	bool dispatched = false;
+	int start = 0;
+	int err = 0;
+	int ret;
+	int i;
+
+	for (i = 0; i <= num; i++) {
+		xcmd = (i < num) ? xcmds[i] : NULL;
+		if (xcmd && xcmd->type == KDS_CU && xcmd->opcode == OP_START) {
+			BUG_ON(!xcmd->cb.notify_host);
+			BUG_ON(!xcmd->cb.free);
+
+			trace_xrt_kds_submit(xcmd);
+			do {
+				ret = acquire_cu_idx(cu_mgmt, xcmd);
+			} while (ret == -EAGAIN);
+			if (ret < 0) {
+				xcmd->cb.notify_host(xcmd, KDS_ERROR);
+				xcmd->cb.free(xcmd);
+				xcmds[i] = NULL;
+				err = err ? err : ret;
+			} else {
+				dispatched = true;
+			}
+			continue;
+		}
+
+		/* Queue the preceding start commands before this one */
+		kds_cu_dispatch_batch(cu_mgmt, xcmds + start, i - start);
+		start = i + 1;
+		if (!xcmd)
+			continue;
+
+		ret = kds_add_command(kds, xcmd);
+		err = err ? err : ret;
+	}
+
+	if (dispatched && (kds->ert_disable || kds->xgq_enable)) {
+		kds->polling_start = 1;
+		wake_up_interruptible(&kds->wait_queue);
+	}
+
+	return err;
+}
+
 int kds_submit_cmd_and_wait(struct kds_sched *kds, struct kds_command *xcmd)
 {
 	struct kds_client *client = xcmd->client;
@@ -1000,6 +1424,42 @@ int kds_submit_cmd_and_wait(struct kds_sched *kds, struct kds_command *xcmd)
 	return 0;
 }
 
+static enum hrtimer_restart kds_client_moderate_expire(struct hrtimer *timer)
+{
+	struct kds_client *client =
+		container_of(timer, struct kds_client, moderate_timer);
+
+	atomic_set(&client->unsignaled, 0);
+	wake_up_interruptible(&client->waitq);
+	return HRTIMER_NORESTART;
+}
+
+/* Signal a command completion to the client.
+ * With completion moderation, waiters are woken up once moderate_cnt
+ * completions accumulated or the oldest unsignaled completion is
+ * moderate_us old. The event count is always updated, so that a
+ * waiter that polls without sleeping sees every completion.
+ */
+void kds_client_signal(struct kds_client *client)
+{
+	u32 cnt = READ_ONCE(client->moderate_cnt);
+	u32 us = READ_ONCE(client->moderate_us);
+
+	atomic_inc(&client->event);
+
+	if (cnt <= 1 || !us ||
+	    atomic_inc_return(&client->unsignaled) >= cnt) {
+		atomic_set(&client->unsignaled, 0);
+		wake_up_interruptible(&client->waitq);
+		return;
+	}
+
+	if (!hrtimer_is_queued(&client->moderate_timer))
+		hrtimer_start(&client->moderate_timer,
+			      ns_to_ktime((u64)us * NSEC_PER_USEC),
+			      HRTIMER_MODE_REL);
+}
+
 int kds_init_client(struct kds_sched *kds, struct kds_client *client)
 {
 	client->stats = alloc_percpu(struct client_stats);
@@ -1007,12 +1467,20 @@ int kds_init_client(struct kds_sched *kds, struct kds_client *client)
 		return -ENOMEM;
 
 	client->pid = get_pid(task_pid(current));
+	client->last_cu = -1;
+	/* nice 19 to -20 is weight 1 to 40 */
+	client->weight = 20 - task_nice(current);
 	mutex_init(&client->lock);
 
 	init_waitqueue_head(&client->waitq);
 	atomic_set(&client->event, 0);
+	atomic_set(&client->unsignaled, 0);
+	hrtimer_init(&client->moderate_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	client->moderate_timer.function = kds_client_moderate_expire;
 
 	mutex_lock(&kds->lock);
+	client->moderate_cnt = kds->moderate_cnt;
+	client->moderate_us = kds->moderate_us;
 	list_add_tail(&client->link, &kds->clients);
 	kds->num_client++;
 	mutex_unlock(&kds->lock);
@@ -1095,6 +1563,7 @@ void kds_fini_client(struct kds_sched *kds, struct kds_client *client)
 
 	put_pid(client->pid);
 	mutex_destroy(&client->lock);
+	hrtimer_cancel(&client->moderate_timer);
 
 	mutex_lock(&kds->lock);
 	list_del(&client->link);
@@ -1226,6 +1695,49 @@ int kds_map_cu_addr(struct kds_sched *kds, struct kds_client *client,
 	return 0;
 }
 
+/* Map descriptor slots of a fast adapter CU to user space. The CU
+ * must be user managed, then KDS does not use the slots. The slots
+ * must be page aligned, else other CUs slots would be exposed.
+ */
+int kds_map_fa_desc(struct kds_sched *kds, struct kds_client *client,
+		    int idx, unsigned long size, u64 *addrp)
+{
+	struct kds_cu_mgmt *cu_mgmt = &kds->cu_mgmt;
+	struct xrt_cu *xcu;
+	u64 bar, dev;
+	u32 slot_sz, num_slots;
+
+	BUG_ON(!mutex_is_locked(&client->lock));
+	if ((idx >= MAX_CUS) || (!cu_mgmt->xcus[idx])) {
+		kds_err(client, "cu(%d) out of range\n", idx);
+		return -EINVAL;
+	}
+
+	if (!test_bit(idx, client->cu_bitmap)) {
+		kds_err(client, "cu(%d) isn't reserved\n", idx);
+		return -EINVAL;
+	}
+
+	xcu = cu_mgmt->xcus[idx];
+	if (!test_bit(0, xcu->is_ucu)) {
+		kds_err(client, "cu(%d) isn't user managed\n", idx);
+		return -EINVAL;
+	}
+
+	if (xrt_fa_get_desc(xcu, &bar, &dev, &slot_sz, &num_slots) || !num_slots) {
+		kds_err(client, "cu(%d) has no descriptor slots\n", idx);
+		return -EINVAL;
+	}
+
+	if (!PAGE_ALIGNED(bar) || size > (unsigned long)slot_sz * num_slots) {
+		kds_err(client, "cu(%d) descriptor slots can't be mapped\n", idx);
+		return -EINVAL;
+	}
+
+	*addrp = bar;
+	return 0;
+}
+
 static inline void
 insert_cu(struct kds_cu_mgmt *cu_mgmt, int i, struct xrt_cu *xcu)
 {
@@ -1251,6 +1763,7 @@ int kds_add_cu(struct kds_sched *kds, struct xrt_cu *xcu)
 	/* Get a free slot in kds for this CU */
 	for (i = 0; i < MAX_CUS; i++) {
 		if (cu_mgmt->xcus[i] == NULL) {
+			xcu->sched = &cu_mgmt->sched;
 			insert_cu(cu_mgmt, i, xcu);
 			++cu_mgmt->num_cus;
 			break;
@@ -1275,6 +1788,8 @@ int kds_del_cu(struct kds_sched *kds, struct xrt_cu *xcu)
 		cu_mgmt->xcus[i] = NULL;
 		--cu_mgmt->num_cus;
 		cu_stat_write(cu_mgmt, usage[i], 0);
+		cu_mgmt->poll_ts[i] = 0;
+		cu_mgmt->poll_period[i] = 0;
 		break;
 	}
 
@@ -1487,10 +2002,19 @@ static int kds_fa_assign_cmdmem(struct kds_sched *kds)
 int kds_cfg_update(struct kds_sched *kds)
 {
 	struct kds_cu_mgmt *cu_mgmt = &kds->cu_mgmt;
+	struct kds_client *client;
 	struct xrt_cu *xcu;
 	int ret = 0;
 	int i;
 
+	/* Update completion moderation of opened clients */
+	mutex_lock(&kds->lock);
+	list_for_each_entry(client, &kds->clients, link) {
+		WRITE_ONCE(client->moderate_cnt, kds->moderate_cnt);
+		WRITE_ONCE(client->moderate_us, kds->moderate_us);
+	}
+	mutex_unlock(&kds->lock);
+
 	/* Update PLRAM CU */
 	if (kds->cmdmem.bo) {
 		ret = kds_fa_assign_cmdmem(kds);
@@ -1756,6 +2280,9 @@ void start_skrnl_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 		xcmd->timestamp_enabled = 1;
 		set_xcmd_timestamp(xcmd, KDS_NEW);
 	}
+	xcmd->priority = ecmd->priority;
+	if (ecmd->deadline)
+		xcmd->deadline = *ert_start_kernel_deadline(ecmd);
 
 	xcmd->cu_mask[0] = ecmd->cu_mask;
 	memcpy(&xcmd->cu_mask[1], ecmd->data, ecmd->extra_cu_masks);
@@ -1776,6 +2303,9 @@ void start_krnl_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 		xcmd->timestamp_enabled = 1;
 		set_xcmd_timestamp(xcmd, KDS_NEW);
 	}
+	xcmd->priority = ecmd->priority;
+	if (ecmd->deadline)
+		xcmd->deadline = *ert_start_kernel_deadline(ecmd);
 
 	xcmd->cu_mask[0] = ecmd->cu_mask;
 	memcpy(&xcmd->cu_mask[1], ecmd->data, ecmd->extra_cu_masks);
@@ -1789,7 +2319,11 @@ void start_krnl_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 	 * first 4 control registers
 	 */
 	xcmd->isize = (ecmd->count - xcmd->num_mask - 4) * sizeof(u32);
-	memcpy(xcmd->info, &ecmd->data[4 + ecmd->extra_cu_masks], xcmd->isize);
+	/* Without payload buffer, the register map is used in place */
+	if (xcmd->payload_alloc)
+		memcpy(xcmd->info, &ecmd->data[4 + ecmd->extra_cu_masks], xcmd->isize);
+	else
+		xcmd->info = &ecmd->data[4 + ecmd->extra_cu_masks];
 	xcmd->payload_type = REGMAP;
 	ecmd->type = ERT_CU;
 }
@@ -1804,6 +2338,9 @@ void start_krnl_kv_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 		xcmd->timestamp_enabled = 1;
 		set_xcmd_timestamp(xcmd, KDS_NEW);
 	}
+	xcmd->priority = ecmd->priority;
+	if (ecmd->deadline)
+		xcmd->deadline = *ert_start_kernel_deadline(ecmd);
 
 	xcmd->cu_mask[0] = ecmd->cu_mask;
 	memcpy(&xcmd->cu_mask[1], ecmd->data, ecmd->extra_cu_masks);
@@ -1816,7 +2353,11 @@ void start_krnl_kv_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 	 * (count - (1 + extra_cu_masks)).
 	 */
 	xcmd->isize = (ecmd->count - xcmd->num_mask) * sizeof(u32);
-	memcpy(xcmd->info, &ecmd->data[ecmd->extra_cu_masks], xcmd->isize);
+	/* Without payload buffer, the key value pairs are used in place */
+	if (xcmd->payload_alloc)
+		memcpy(xcmd->info, &ecmd->data[ecmd->extra_cu_masks], xcmd->isize);
+	else
+		xcmd->info = &ecmd->data[ecmd->extra_cu_masks];
 	xcmd->payload_type = KEY_VAL;
 	ecmd->type = ERT_CU;
 }
@@ -1831,6 +2372,9 @@ void start_fa_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 		xcmd->timestamp_enabled = 1;
 		set_xcmd_timestamp(xcmd, KDS_NEW);
 	}
+	xcmd->priority = ecmd->priority;
+	if (ecmd->deadline)
+		xcmd->deadline = *ert_start_kernel_deadline(ecmd);
 
 	xcmd->cu_mask[0] = ecmd->cu_mask;
 	memcpy(&xcmd->cu_mask[1], ecmd->data, ecmd->extra_cu_masks);
@@ -1848,10 +2392,24 @@ void start_fa_ecmd2xcmd(struct ert_start_kernel_cmd *ecmd,
 
 void abort_ecmd2xcmd(struct ert_abort_cmd *ecmd, struct kds_command *xcmd)
 {
-	u32 *exec_bo_handle = xcmd->info;
+	/* The handles are 64 bits aligned, so payload starts with a word
+	 * of padding.
+	 */
+	size_t pad = offsetof(struct ert_abort_cmd, exec_bo_handles) - sizeof(ecmd->header);
+	size_t bytes = ecmd->count * sizeof(u32);
+	size_t num = (bytes > pad) ? (bytes - pad) / sizeof(u64) : 0;
+
+	/* Older user space sets count 2 for the single handle */
+	if (!num && ecmd->count == 2)
+		num = 1;
 
+	/* Lower 32 bits of each handle is the BO handle, upper 32 bits is
+	 * the offset of the command within the BO. xcmd->info is sized by
+	 * ecmd->count and holds the complete list.
+	 */
 	xcmd->opcode = OP_ABORT;
-	*exec_bo_handle = ecmd->exec_bo_handle;
+	memcpy(xcmd->info, ecmd->exec_bo_handles, num * sizeof(u64));
+	xcmd->isize = num * sizeof(u64);
 }
 
 void set_xcmd_timestamp(struct kds_command *xcmd, enum kds_status s)
@@ -13,6 +13,7 @@
 #include <linux/delay.h>
 #include "kds_client.h"
 #include "xrt_cu.h"
+#include "xrt_drv_trace.h"
 
 inline void xrt_cu_circ_produce(struct xrt_cu *xcu, u32 stage, uintptr_t cmd)
 {
@@ -156,11 +157,13 @@ static inline void process_cq(struct xrt_cu *xcu)
 		xcmd = list_first_entry(&xcu->cq, struct kds_command, list);
 		set_xcmd_timestamp(xcmd, xcmd->status);
 		xrt_cu_circ_produce(xcu, CU_LOG_STAGE_CQ, (uintptr_t)xcmd);
+		trace_xrt_cu_notify(xcu->info.cu_idx, xcmd);
 		xcmd->cb.notify_host(xcmd, xcmd->status);
 		list_del(&xcmd->list);
 		xcmd->cb.free(xcmd);
 		--xcu->num_cq;
 		xcu->cu_stat.usage++;
+		atomic_dec(&xcu->inflight);
 	}
 }
 
@@ -213,6 +216,7 @@ static inline void __process_sq(struct xrt_cu *xcu)
 			xcmd->status = KDS_COMPLETED;
 			--xcu->done_cnt;
 			xrt_cu_circ_produce(xcu, CU_LOG_STAGE_SQ, (uintptr_t)xcmd);
+			trace_xrt_cu_done(xcu->info.cu_idx, xcmd);
 		} else if (unlikely(ev_client)) {
 			/* Client event happens rarely */
 			if (xcmd->client != ev_client)
@@ -265,6 +269,77 @@ static inline void process_sq(struct xrt_cu *xcu)
 	__process_sq(xcu);
 }
 
+static inline u32
+client_running(struct xrt_cu *xcu, struct kds_client *client)
+{
+	struct kds_command *xcmd;
+	u32 cnt = 0;
+
+	list_for_each_entry(xcmd, &xcu->sq, list) {
+		if (xcmd->client == client)
+			++cnt;
+	}
+
+	return cnt;
+}
+
+/**
+ * select_rq_cmd() - Select the next command to run
+ * @xcu: Target XRT CU
+ *
+ * In FIFO order by default. With fair share, the client of the last
+ * started command runs up to its weight of commands in a turn, then
+ * the turn goes to the client with the oldest command among the other
+ * clients. Clients with client_depth commands running on the CU are
+ * skipped.
+ *
+ * Return: command to run, or NULL if no client may run a command
+ */
+static inline struct kds_command *select_rq_cmd(struct xrt_cu *xcu)
+{
+	struct kds_command *xcmd;
+	struct kds_command *curr = NULL;
+	struct kds_command *other = NULL;
+	struct kds_client *full = NULL;
+	u32 depth;
+
+	/* High priority commands are at the head and are not subject to
+	 * fair share
+	 */
+	xcmd = list_first_entry(&xcu->rq, struct kds_command, list);
+	if (xcmd->priority == ERT_CMD_PRIORITY_HIGH)
+		return xcmd;
+
+	if (!xcu->sched || !READ_ONCE(xcu->sched->fair_share))
+		return xcmd;
+
+	depth = READ_ONCE(xcu->sched->client_depth);
+	list_for_each_entry(xcmd, &xcu->rq, list) {
+		if (depth && xcu->num_sq >= depth) {
+			/* Commands of a client are usually adjacent */
+			if (xcmd->client == full)
+				continue;
+			if (client_running(xcu, xcmd->client) >= depth) {
+				full = xcmd->client;
+				continue;
+			}
+		}
+
+		if (xcmd->client == xcu->rr_client) {
+			if (xcu->rr_left)
+				return xcmd;
+			if (!curr)
+				curr = xcmd;
+		} else if (!other) {
+			other = xcmd;
+			if (!xcu->rr_left)
+				break;
+		}
+	}
+
+	return other ? other : curr;
+}
+
 /**
  * process_rq() - Process run queue
  * @xcu: Target XRT CU
@@ -282,9 +357,14 @@ static inline int process_rq(struct xrt_cu *xcu)
 	if (!xcu->num_rq)
 		return 0;
 
-	xcmd = list_first_entry(&xcu->rq, struct kds_command, list);
-
 	ev_client = first_event_client_or_null(xcu);
+	if (unlikely(xcu->bad_state || ev_client))
+		xcmd = list_first_entry(&xcu->rq, struct kds_command, list);
+	else
+		xcmd = select_rq_cmd(xcu);
+	if (!xcmd)
+		return 0;
+
 	if (unlikely(xcu->bad_state || (ev_client == xcmd->client))) {
 		xcmd->status = KDS_ABORT;
 		dst_q = &xcu->cq;
@@ -292,6 +372,14 @@ static inline int process_rq(struct xrt_cu *xcu)
 		goto move_cmd;
 	}
 
+	/* Drop command that can no longer start in time */
+	if (unlikely(xcmd->deadline) && ktime_get_ns() > xcmd->deadline) {
+		xcmd->status = KDS_EXPIRED;
+		dst_q = &xcu->cq;
+		dst_len = &xcu->num_cq;
+		goto move_cmd;
+	}
+
 	if (!xrt_cu_get_credit(xcu))
 		return 0;
 
@@ -303,6 +391,13 @@ static inline int process_rq(struct xrt_cu *xcu)
 	xrt_cu_start(xcu);
 	set_xcmd_timestamp(xcmd, KDS_RUNNING);
 	xrt_cu_circ_produce(xcu, CU_LOG_STAGE_RQ, (uintptr_t)xcmd);
+	trace_xrt_cu_dispatch(xcu->info.cu_idx, xcmd);
+
+	if (xcmd->client != xcu->rr_client || !xcu->rr_left) {
+		xcu->rr_client = xcmd->client;
+		xcu->rr_left = xcmd->client->weight;
+	}
+	--xcu->rr_left;
 
 	dst_q = &xcu->sq;
 	dst_len = &xcu->num_sq;
@@ -320,15 +415,56 @@ move_cmd:
 	return 1;
 }
 
+static inline u32 priority_rank(struct kds_command *xcmd)
+{
+	switch (xcmd->priority) {
+	case ERT_CMD_PRIORITY_HIGH:
+		return 0;
+	case ERT_CMD_PRIORITY_BULK:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+/**
+ * queue_by_priority() - Move commands to run queue by priority
+ * @xcu: Target XRT CU
+ * @cmds: Commands to move
+ *
+ * The run queue is ordered high, normal, bulk. Each command is placed
+ * after the commands of the same or higher priority, so the order of
+ * commands with the same priority is kept.
+ */
+static inline void queue_by_priority(struct xrt_cu *xcu, struct list_head *cmds)
+{
+	struct kds_command *xcmd;
+	struct kds_command *next;
+	struct kds_command *pos;
+	u32 rank;
+
+	list_for_each_entry_safe(xcmd, next, cmds, list) {
+		rank = priority_rank(xcmd);
+		list_for_each_entry_reverse(pos, &xcu->rq, list) {
+			if (priority_rank(pos) <= rank)
+				break;
+		}
+		/* pos is the list head if no such command */
+		list_move(&xcmd->list, &pos->list);
+	}
+}
+
 /**
  * process_pq() - Process pending queue
  * @xcu: Target XRT CU
  *
- * Move all of the pending queue commands to the tail of run queue
- * and re-initialized pending queue
+ * Move all of the pending queue commands to the run queue and
+ * re-initialized pending queue. Commands are appended to the tail of
+ * run queue unless priorities are in use.
  */
 static inline void process_pq(struct xrt_cu *xcu)
 {
+	struct kds_command *last;
 	unsigned long flags;
 
 	/* Get pending queue command number without lock.
@@ -339,53 +475,84 @@ static inline void process_pq(struct xrt_cu *xcu)
 		return;
 	spin_lock_irqsave(&xcu->pq_lock, flags);
 	if (xcu->num_pq) {
-		list_splice_tail_init(&xcu->pq, &xcu->rq);
+		last = xcu->num_rq ?
+			list_last_entry(&xcu->rq, struct kds_command, list) : NULL;
+		if (xcu->num_pq_prio ||
+		    (last && last->priority == ERT_CMD_PRIORITY_BULK))
+			queue_by_priority(xcu, &xcu->pq);
+		else
+			list_splice_tail_init(&xcu->pq, &xcu->rq);
 		xcu->num_rq += xcu->num_pq;
 		xcu->num_pq = 0;
+		xcu->num_pq_prio = 0;
 	}
 	spin_unlock_irqrestore(&xcu->pq_lock, flags);
 	if (xcu->max_running < xcu->num_rq)
 		xcu->max_running = xcu->num_rq;
 }
 
+/* The abort command carries a list of isize / 8 execbuf handles. Lower 32
+ * bits of each is the BO handle, upper 32 bits is the offset of the command
+ * within the BO.
+ */
+static inline bool
+abort_cmd_match(struct kds_command *abort_cmd, struct kds_command *xcmd)
+{
+	u64 *handles = abort_cmd->info;
+	size_t num = abort_cmd->isize / sizeof(u64);
+	size_t i;
+
+	for (i = 0; i < num; i++) {
+		if (xcmd->exec_bo_handle == lower_32_bits(handles[i]) &&
+		    xcmd->exec_bo_offset == upper_32_bits(handles[i]))
+			return true;
+	}
+
+	return false;
+}
+
 static inline void
 try_abort_cmd(struct xrt_cu *xcu, struct kds_command *abort_cmd)
 {
 	struct kds_command *xcmd;
 	struct kds_command *tmp;
-	u32 handle;
+	bool reset = false;
 
-	/* Never call this function on the performance critical path */
-	handle = *(u32 *)abort_cmd->info;
+	/* Never call this function on the performance critical path.
+	 * All listed commands that are not yet submitted to the CU are
+	 * aborted in one pass over the running queue.
+	 */
 	list_for_each_entry_safe(xcmd, tmp, &xcu->rq, list) {
-		if (xcmd->exec_bo_handle != handle)
+		if (!abort_cmd_match(abort_cmd, xcmd))
 			continue;
 
-		/* Found the xcmd to abort! */
-		abort_cmd->status = KDS_COMPLETED;
+		/* Found a xcmd to abort! */
+		if (abort_cmd->status == KDS_NEW)
+			abort_cmd->status = KDS_COMPLETED;
 
-		xcu_info(xcu, "Abort command(%d) on running queue", handle);
+		xcu_info(xcu, "Abort command(%d) on running queue", xcmd->exec_bo_handle);
 		xcmd->status = KDS_ABORT;
 		move_to_queue(xcmd, &xcu->cq, &xcu->num_cq);
 		--xcu->num_rq;
-		return;
 	}
 
 	list_for_each_entry_safe(xcmd, tmp, &xcu->sq, list) {
-		if (xcmd->exec_bo_handle != handle)
+		if (!abort_cmd_match(abort_cmd, xcmd))
 			continue;
 
-		xcu_info(xcu, "Abort command(%d) on submitted queue", handle);
-		/* Found the xcmd to abort! */
-		if (!xcu->info.sw_reset) {
+		xcu_info(xcu, "Abort command(%d) on submitted queue", xcmd->exec_bo_handle);
+		/* Found a xcmd to abort! The CU is reset at most once per
+		 * abort command.
+		 */
+		if (!reset && !xcu->info.sw_reset) {
 			xcu_warn(xcu, "No sw resset. Device goto bad state");
 			abort_cmd->status = KDS_ABORT;
 			xcu->bad_state = true;
-		} else {
+		} else if (!reset) {
 			xcu_info(xcu, "Try reset CU(%d)", xcu->info.cu_idx);
 			/* TODO: Not support CU with hardware queue.
 			 *
-			 * Since we only abort one command, not sure
+			 * Since we only abort listed commands, not sure
 			 * what to do when this command is in hardware
 			 * queue with other commands.
 			 * In this case, if we still want to reset CU,
@@ -396,18 +563,18 @@ try_abort_cmd(struct xrt_cu *xcu, struct kds_command *abort_cmd)
 				/* re-initial this cu */
 				xrt_cu_put_credit(xcu, 1);
 
-				abort_cmd->status = KDS_COMPLETED;
+				if (abort_cmd->status == KDS_NEW)
+					abort_cmd->status = KDS_COMPLETED;
 			} else {
 				abort_cmd->status = KDS_TIMEOUT;
 				xcu->bad_state = true;
 			}
 		}
+		reset = true;
 
 		xcmd->status = KDS_ABORT;
 		move_to_queue(xcmd, &xcu->cq, &xcu->num_cq);
 		--xcu->num_sq;
-
-		return;
 	}
 }
 
@@ -553,15 +720,44 @@ void xrt_cu_submit(struct xrt_cu *xcu, struct kds_command *xcmd)
 	/* Add command to pending queue
 	 * wakeup CU thread if it is the first command
 	 */
+	atomic_inc(&xcu->inflight);
 	spin_lock_irqsave(&xcu->pq_lock, flags);
 	list_add_tail(&xcmd->list, &xcu->pq);
 	++xcu->num_pq;
+	if (xcmd->priority != ERT_CMD_PRIORITY_NORMAL)
+		++xcu->num_pq_prio;
 	first_command = (xcu->num_pq == 1);
 	spin_unlock_irqrestore(&xcu->pq_lock, flags);
 	if (first_command)
 		up(&xcu->sem);
 }
 
+/* Add num commands linked on cmds to pending queue in one lock acquisition.
+ * The cmds list is empty on return.
+ */
+void xrt_cu_submit_list(struct xrt_cu *xcu, struct list_head *cmds, u32 num)
+{
+	struct kds_command *xcmd;
+	unsigned long flags;
+	bool first_command = false;
+	u32 num_prio = 0;
+
+	list_for_each_entry(xcmd, cmds, list) {
+		if (xcmd->priority != ERT_CMD_PRIORITY_NORMAL)
+			++num_prio;
+	}
+
+	atomic_add(num, &xcu->inflight);
+	spin_lock_irqsave(&xcu->pq_lock, flags);
+	first_command = (xcu->num_pq == 0);
+	list_splice_tail_init(cmds, &xcu->pq);
+	xcu->num_pq += num;
+	xcu->num_pq_prio += num_prio;
+	spin_unlock_irqrestore(&xcu->pq_lock, flags);
+	if (first_command)
+		up(&xcu->sem);
+}
+
 void xrt_cu_hpq_submit(struct xrt_cu *xcu, struct kds_command *xcmd)
 {
 	unsigned long flags;
@@ -723,6 +919,7 @@ int xrt_fa_cfg_update(struct xrt_cu *xcu, u64 bar, u64 dev, void __iomem *vaddr,
 	if (bar == 0) {
 		cu_fa->cmdmem = NULL;
 		cu_fa->paddr = 0;
+		cu_fa->bar_paddr = 0;
 		cu_fa->slot_sz = 0;
 		cu_fa->num_slots = 0;
 		return 0;
@@ -732,6 +929,7 @@ int xrt_fa_cfg_update(struct xrt_cu *xcu, u64 bar, u64 dev, void __iomem *vaddr,
 
 	cu_fa->cmdmem = vaddr;
 	cu_fa->paddr = dev;
+	cu_fa->bar_paddr = bar;
 	cu_fa->slot_sz = slot_size;
 	cu_fa->num_slots = num_slots;
 
@@ -741,6 +939,34 @@ int xrt_fa_cfg_update(struct xrt_cu *xcu, u64 bar, u64 dev, void __iomem *vaddr,
 	return 0;
 }
 
+/* Get descriptor slots of a fast adapter CU. The slots are assigned
+ * by xrt_fa_cfg_update(), num_slots is 0 if not assigned.
+ */
+int xrt_fa_get_desc(struct xrt_cu *xcu, u64 *bar, u64 *dev, u32 *slot_sz, u32 *num_slots)
+{
+	struct xrt_cu_fa *cu_fa = xcu->core;
+
+	if (!xrt_is_fa(xcu, NULL))
+		return -EINVAL;
+
+	*bar = cu_fa->bar_paddr;
+	*dev = cu_fa->paddr;
+	*slot_sz = cu_fa->slot_sz;
+	*num_slots = cu_fa->num_slots;
+	return 0;
+}
+
+/* A user managed fast adapter CU was started from user space. The
+ * task count and descriptor address registers no longer match the
+ * values cached by the CU, reload them before next start.
+ */
+void xrt_fa_resync(struct xrt_cu *xcu)
+{
+	struct xrt_cu_fa *cu_fa = xcu->core;
+
+	WRITE_ONCE(cu_fa->resync, 1);
+}
+
 int xrt_cu_get_protocol(struct xrt_cu *xcu)
 {
 	return xcu->info.protocol;
@@ -800,6 +1026,7 @@ int xrt_cu_init(struct xrt_cu *xcu)
 	xcu->run_timeout = 0;
 	sema_init(&xcu->sem, 0);
 	sema_init(&xcu->sem_cu, 0);
+	atomic_set(&xcu->inflight, 0);
 
 	INIT_LIST_HEAD(&xcu->hpq);
 	spin_lock_init(&xcu->hpq_lock);
@@ -28,15 +28,56 @@
 
 #include <stdexcept>
 #include <condition_variable>
+#include <functional>
+#include <utility>
 
 // Internal shim function forward declarations
 int xclUpdateSchedulerStat(xclDeviceHandle handle);
 int xclInternalResetDevice(xclDeviceHandle handle, xclResetKind kind);
 int xclCmaEnable(xclDeviceHandle handle, bool enable, uint64_t total_size);
 int xclCloseExportHandle(xclBufferExportHandle);
+int xclExecBufAt(xclDeviceHandle handle, unsigned int cmdBO, size_t offset);
+int xclExecBufBatch(xclDeviceHandle handle, const xclBufferHandle* cmdBOs, const size_t* offsets, size_t count);
+int xclOpenContextBatch(xclDeviceHandle handle, const xuid_t xclbinId, const unsigned int* ipIndices,
+                        size_t count, bool shared);
+int xclCloseContextBatch(xclDeviceHandle handle, const xuid_t xclbinId, const unsigned int* ipIndices,
+                         size_t count);
+int xclRegWindow(xclDeviceHandle handle, uint32_t ipIndex, uint32_t** base, uint32_t* size);
+int xclMapFaDesc(xclDeviceHandle handle, uint32_t ipIndex, uint32_t** base, uint64_t* devAddr,
+                 uint32_t* slotSize, uint32_t* numSlots);
+int xclUnmapFaDesc(xclDeviceHandle handle, uint32_t* base, size_t size);
+int xclStageXclBin(xclDeviceHandle handle, const struct axlf* buffer);
+int xclUnstageXclBin(xclDeviceHandle handle, const xuid_t xclbinId);
+int xclSyncBOSubmit(xclDeviceHandle handle, xclBufferHandle boHandle, xclBOSyncDirection dir,
+                    size_t size, size_t offset, void (*done)(void*, int), void* data);
+int xclSyncBOBatch(xclDeviceHandle handle, const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+                   const size_t* sizes, const size_t* offsets, size_t count);
+int xclGraphUpdateRTPBatch(xclGraphHandle ghdl, const char** ports, const char** buffers,
+                           const size_t* sizes, size_t count);
+int xclGraphReadRTPBatch(xclGraphHandle ghdl, const char** ports, char** buffers,
+                         const size_t* sizes, size_t count);
+int xclSyncBOAIESubmit(xclDeviceHandle handle, xrt::bo& bo, const char* gmioName, xclBOSyncDirection dir,
+                       size_t size, size_t offset, uint64_t* id);
+int xclGMIOWaitTransfer(xclDeviceHandle handle, const char* gmioName, uint64_t id);
 
 namespace xrt_core {
 
+/**
+ * struct fa_desc_window - Descriptor slots of a fast adapter IP
+ *
+ * @base:      Slots mapped into the process
+ * @dev_addr:  Device address of first slot
+ * @slot_size: Bytes per slot
+ * @num_slots: Number of slots
+ */
+struct fa_desc_window
+{
+  uint32_t* base;
+  uint64_t dev_addr;
+  uint32_t slot_size;
+  uint32_t num_slots;
+};
+
 /**
  * struct ishim - Shim API implemented by core libraries
  *
@@ -53,6 +94,38 @@ struct ishim
   virtual void
   close_context(const xuid_t xclbin_uuid, unsigned int ip_index) = 0;
 
+  // Open contexts on multiple IPs in one call.  Shims that support
+  // bulk contexts override, default is one open_context per IP.
+  // Either all contexts are opened or none.
+  virtual void
+  open_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count, bool shared)
+  {
+    size_t idx = 0;
+    try {
+      for (; idx < count; ++idx)
+        open_context(xclbin_uuid, ip_indices[idx], shared);
+    }
+    catch (...) {
+      while (idx--) {
+        try {
+          close_context(xclbin_uuid, ip_indices[idx]);
+        }
+        catch (...) {
+        }
+      }
+      throw;
+    }
+  }
+
+  // Close contexts on multiple IPs in one call.  Shims that support
+  // bulk contexts override, default is one close_context per IP.
+  virtual void
+  close_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count)
+  {
+    for (size_t idx = 0; idx < count; ++idx)
+      close_context(xclbin_uuid, ip_indices[idx]);
+  }
+
   virtual xclBufferHandle
   alloc_bo(size_t size, unsigned int flags) = 0;
 
@@ -77,12 +150,39 @@ struct ishim
   import_bo(pid_t, xclBufferExportHandle)
   { throw xrt_core::error(std::errc::not_supported,"import_bo(pid, hdl)"); }
 
+  // Check if export handle of process pid refers to the same buffer
+  // as export handle of this process.  Used to validate a cached
+  // import, a shim that cannot tell returns false.
+  virtual bool
+  is_same_export(pid_t, xclBufferExportHandle, xclBufferExportHandle) const
+  { return false; }
+
   virtual void
   copy_bo(xclBufferHandle dst, xclBufferHandle src, size_t size, size_t dst_offset, size_t src_offset) = 0;
 
   virtual void
   sync_bo(xclBufferHandle bo, xclBOSyncDirection dir, size_t size, size_t offset) = 0;
 
+  // Sync multiple buffer ranges in one call.  Shims that support
+  // batched syncs override, default is one sync_bo per range.
+  virtual void
+  sync_bo_batch(const xclBufferHandle* bos, const xclBOSyncDirection* dirs,
+                const size_t* sizes, const size_t* offsets, size_t count)
+  {
+    for (size_t idx = 0; idx < count; ++idx)
+      sync_bo(bos[idx], dirs[idx], sizes[idx], offsets[idx]);
+  }
+
+  // Submit a sync without waiting for the DMA to complete. The
+  // done function is called with 0 or an error code on completion.
+  // Returns false if the shim cannot sync asynchronously, in which
+  // case nothing has been submitted.
+  virtual bool
+  submit_sync_bo(xclBufferHandle, xclBOSyncDirection, size_t, size_t, std::function<void(int)>)
+  {
+    return false;
+  }
+
   virtual void*
   map_bo(xclBufferHandle boh, bool write) = 0;
 
@@ -98,6 +198,24 @@ struct ishim
   virtual void
   reg_write(uint32_t ipidx, uint32_t offset, uint32_t data) = 0;
 
+  // Get register space of an IP mapped into the process for direct
+  // access, returns base and size in bytes.  Only shims that map IP
+  // register space override.
+  virtual std::pair<uint32_t*, size_t>
+  get_reg_window(uint32_t)
+  { throw xrt_core::error(std::errc::not_supported,"get_reg_window()"); }
+
+  // Map descriptor slots of a user managed fast adapter IP into the
+  // process for direct descriptor submission.  Only shims that map
+  // descriptor slots override.
+  virtual fa_desc_window
+  map_fa_desc(uint32_t)
+  { throw xrt_core::error(std::errc::not_supported,"map_fa_desc()"); }
+
+  virtual void
+  unmap_fa_desc(const fa_desc_window&)
+  { throw xrt_core::error(std::errc::not_supported,"unmap_fa_desc()"); }
+
   virtual void
   xread(enum xclAddressSpace addr_space, uint64_t offset, void* buffer, size_t size) const = 0;
 
@@ -113,12 +231,43 @@ struct ishim
   virtual void
   exec_buf(xclBufferHandle boh) = 0;
 
+  // Submit command at byte offset within a slab exec buffer.  Only
+  // shims whose driver accepts an exec buffer offset override.
+  virtual void
+  exec_buf_at(xclBufferHandle boh, size_t offset)
+  {
+    if (offset)
+      throw xrt_core::error(std::errc::not_supported,"exec_buf_at()");
+    exec_buf(boh);
+  }
+
+  // Submit multiple exec buffers in one call.  Shims that support
+  // batched submission override, default is one exec_buf per buffer.
+  // Offsets is optional, when nullptr all commands are at offset 0.
+  virtual void
+  exec_buf_batch(const xclBufferHandle* bos, const size_t* offsets, size_t count)
+  {
+    for (size_t idx = 0; idx < count; ++idx)
+      exec_buf_at(bos[idx], offsets ? offsets[idx] : 0);
+  }
+
   virtual int
   exec_wait(int timeout_ms) const = 0;
 
   virtual void
   load_axlf(const axlf*) = 0;
 
+  // Validate and copy an xclbin to the driver without programming
+  // it, so that a later load of the xclbin is not copied again.  Only
+  // shims with driver support for staging override.
+  virtual void
+  stage_axlf(const axlf*)
+  { throw xrt_core::error(std::errc::not_supported,"stage_axlf()"); }
+
+  virtual void
+  unstage_axlf(const xuid_t)
+  { throw xrt_core::error(std::errc::not_supported,"unstage_axlf()"); }
+
   virtual void
   reclock(const uint16_t* target_freq_mhz) = 0;
 
@@ -204,6 +353,24 @@ struct ishim
   virtual void
   read_graph_rtp(xclGraphHandle handle, const char* port, char* buffer, size_t size) = 0;
 
+  // Update or read multiple graph RTP ports in one call.  Shims that
+  // support batched RTP access override, default is one call per port.
+  virtual void
+  update_graph_rtp_batch(xclGraphHandle handle, const char** ports, const char** buffers,
+                         const size_t* sizes, size_t count)
+  {
+    for (size_t idx = 0; idx < count; ++idx)
+      update_graph_rtp(handle, ports[idx], buffers[idx], sizes[idx]);
+  }
+
+  virtual void
+  read_graph_rtp_batch(xclGraphHandle handle, const char** ports, char** buffers,
+                       const size_t* sizes, size_t count)
+  {
+    for (size_t idx = 0; idx < count; ++idx)
+      read_graph_rtp(handle, ports[idx], buffers[idx], sizes[idx]);
+  }
+
   virtual void
   open_aie_context(xrt::aie::access_mode) = 0;
 
@@ -219,6 +386,22 @@ struct ishim
   virtual void
   wait_gmio(const char *gmioName) = 0;
 
+  // Enqueue a non-blocking GMIO transfer and return an id that can
+  // be waited on with wait_gmio_transfer().  Shims without per
+  // transfer tracking return 0 and wait for the whole channel.
+  virtual uint64_t
+  submit_aie_bo(xrt::bo& bo, const char *gmioName, xclBOSyncDirection dir, size_t size, size_t offset)
+  {
+    sync_aie_bo_nb(bo, gmioName, dir, size, offset);
+    return 0;
+  }
+
+  virtual void
+  wait_gmio_transfer(const char *gmioName, uint64_t /*id*/)
+  {
+    wait_gmio(gmioName);
+  }
+
   virtual int
   start_profiling(int option, const char* port1Name, const char* port2Name, uint32_t value) = 0;
 
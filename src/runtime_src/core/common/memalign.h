@@ -18,6 +18,14 @@
 #define xrtcore_memalign_h_
 #include <memory>
 #include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
 
 namespace xrt_core {
 
@@ -67,6 +75,65 @@ aligned_alloc(size_t align, size_t size)
 #endif
 }
 
+#if defined(__linux__)
+// mbind_preferred() - Prefer NUMA node for pages of a mapping
+//
+// The policy applies to pages faulted in after the call and falls
+// back to other nodes if the node is exhausted.  Throws on failure.
+inline void
+mbind_preferred(void* ptr, size_t size, int numa_node)
+{
+  constexpr int mpol_preferred = 1;
+  constexpr unsigned long bits = 8 * sizeof(unsigned long);
+  unsigned long nodemask[4] = {0};
+  if (numa_node < 0 || static_cast<unsigned long>(numa_node) >= bits * 4)
+    throw std::runtime_error("xrt_core::mbind_preferred bad NUMA node " + std::to_string(numa_node));
+  nodemask[numa_node / bits] = 1UL << (numa_node % bits);
+  if (::syscall(SYS_mbind, ptr, size, mpol_preferred, nodemask, bits * 4, 0))
+    throw std::runtime_error("xrt_core::mbind_preferred failed to bind NUMA node " + std::to_string(numa_node));
+}
+
+struct mmap_ptr_deleter
+{
+  size_t size = 0;
+  void operator() (void* ptr)  { ::munmap(ptr, size); }
+};
+using mmap_ptr_type = std::unique_ptr<void, mmap_ptr_deleter>;
+
+// mmap_alloc() - Allocate anonymous memory mapping
+//
+// @size:      size of mapping, rounded up to multiple of page_size
+// @page_size: 0 for system pages, or huge page size (2M, 1G)
+// @numa_node: preferred NUMA node of the pages, -1 for no preference
+//
+// Huge pages are allocated from the hugetlbfs pool, which must be
+// reserved by the system administrator.  The NUMA policy is applied
+// before the pages are faulted in.  Throws on failure.
+inline mmap_ptr_type
+mmap_alloc(size_t size, size_t page_size, int numa_node)
+{
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (page_size) {
+    if (page_size & (page_size - 1))
+      throw std::runtime_error("xrt_core::mmap_alloc requires power of 2 for page size");
+    size = ((size + page_size - 1) / page_size) * page_size;
+    int shift = __builtin_ctzll(page_size);
+    flags |= MAP_HUGETLB | (shift << MAP_HUGE_SHIFT);
+  }
+
+  auto ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (ptr == MAP_FAILED)
+    throw std::runtime_error("xrt_core::mmap_alloc failed to map " + std::to_string(size) + " bytes");
+
+  mmap_ptr_type mptr(ptr, mmap_ptr_deleter{size});
+
+  if (numa_node >= 0)
+    mbind_preferred(ptr, size, numa_node);
+
+  return mptr;
+}
+#endif
+
 } // xrt_core
 
 #endif
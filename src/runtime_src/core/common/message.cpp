@@ -26,8 +26,13 @@
 #include <thread>
 #include <mutex>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>
 #include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #ifdef __GNUC__
 # include <unistd.h>
 # include <syslog.h>
@@ -97,7 +102,7 @@ public:
   virtual ~message_dispatch() {}
   static message_dispatch* make_dispatcher(const std::string& choice);
 public:
-  virtual void send(severity_level l, const char* tag, const char* msg) = 0;
+  virtual void send(severity_level l, const char* tag, const char* msg, std::thread::id tid) = 0;
 };
 
 //--
@@ -106,7 +111,7 @@ class null_dispatch : public message_dispatch
 public:
   null_dispatch() {}
   virtual ~null_dispatch() {}
-  virtual void send(severity_level, const char*, const char*) {};
+  virtual void send(severity_level, const char*, const char*, std::thread::id) {};
 };
 
 //--
@@ -115,7 +120,7 @@ class console_dispatch : public message_dispatch
 public:
   console_dispatch();
   virtual ~console_dispatch() {}
-  virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void send(severity_level l, const char* tag, const char* msg, std::thread::id tid) override;
 private:
   std::map<severity_level, const char*> severityMap = {
     { severity_level::emergency, "EMERGENCY: "},
@@ -140,7 +145,7 @@ public:
   virtual ~syslog_dispatch()
   { closelog(); }
 
-  virtual void send(severity_level l, const char* tag, const char* msg) override
+  virtual void send(severity_level l, const char*, const char* msg, std::thread::id) override
   { syslog(severityMap[l], "%s", msg); }
 
 private:
@@ -164,7 +169,7 @@ public:
   explicit
   file_dispatch(const std::string& file);
   virtual ~file_dispatch();
-  virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void send(severity_level l, const char* tag, const char* msg, std::thread::id tid) override;
 private:
   std::ofstream handle;
   std::map<severity_level, const char*> severityMap = {
@@ -179,6 +184,174 @@ private:
   };
 };
 
+//--
+#ifndef _WIN32
+// Messages are copied by the sending thread into a bounded ring of
+// fixed size records, which a background thread writes to the
+// underlying dispatcher.  The ring is a lock free multiple producer
+// queue where each record carries a sequence number that tells if
+// the record is free or written.  A message is dropped and counted
+// when the ring is full, and messages longer than a record are
+// truncated.
+//
+// The writer is stopped at exit after draining the ring.  Messages
+// sent after the writer is stopped are dispatched synchronously.
+class async_dispatch : public message_dispatch
+{
+  static constexpr size_t tag_size = 64;
+  static constexpr size_t msg_size = 1024;
+
+  struct record
+  {
+    std::atomic<uint64_t> seq {0};
+    severity_level level = severity_level::info;
+    std::thread::id tid;
+    char tag[tag_size];
+    char msg[msg_size];
+  };
+
+  std::unique_ptr<message_dispatch> m_dispatch;
+  std::unique_ptr<record[]> m_ring;
+  uint64_t m_mask;
+  std::atomic<uint64_t> m_tail {0};     // next record to write
+  uint64_t m_head = 0;                  // next record to dispatch
+  std::atomic<uint64_t> m_dropped {0};
+  uint64_t m_reported = 0;
+  std::atomic<bool> m_sleeping {false};
+  std::atomic<bool> m_stop {false};
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::thread m_writer;
+
+  static size_t
+  ring_size(size_t records)
+  {
+    size_t size = 16;
+    while (size < records)
+      size <<= 1;
+    return size;
+  }
+
+  static void
+  copy(char* dst, const char* src, size_t size)
+  {
+    std::strncpy(dst, src ? src : "", size - 1);
+    dst[size - 1] = 0;
+  }
+
+  bool
+  ready() const
+  {
+    return m_ring[m_head & m_mask].seq.load(std::memory_order_acquire) == m_head + 1;
+  }
+
+  void
+  report_dropped()
+  {
+    auto dropped = m_dropped.load();
+    if (dropped == m_reported)
+      return;
+    auto msg = std::to_string(dropped - m_reported) + " messages dropped, log queue full";
+    m_dispatch->send(severity_level::warning, "XRT", msg.c_str(), std::this_thread::get_id());
+    m_reported = dropped;
+  }
+
+  void
+  run()
+  {
+    while (true) {
+      if (ready()) {
+        auto& rec = m_ring[m_head & m_mask];
+        m_dispatch->send(rec.level, rec.tag, rec.msg, rec.tid);
+        rec.seq.store(m_head + m_mask + 1, std::memory_order_release);
+        ++m_head;
+        continue;
+      }
+
+      report_dropped();
+      if (m_stop)
+        break;
+
+      // Senders notify only when the writer sleeps, a missed
+      // notification is bounded by the wait timeout
+      std::unique_lock<std::mutex> lk(m_mutex);
+      m_sleeping = true;
+      if (!ready() && !m_stop)
+        m_work.wait_for(lk, std::chrono::milliseconds(10));
+      m_sleeping = false;
+    }
+  }
+
+public:
+  async_dispatch(message_dispatch* dispatch, size_t records)
+    : m_dispatch(dispatch)
+    , m_ring(new record[ring_size(records)])
+    , m_mask(ring_size(records) - 1)
+  {
+    for (uint64_t idx = 0; idx <= m_mask; ++idx)
+      m_ring[idx].seq = idx;
+    m_writer = std::thread(&async_dispatch::run, this);
+  }
+
+  virtual ~async_dispatch()
+  {
+    stop();
+  }
+
+  void
+  stop()
+  {
+    if (m_stop.exchange(true))
+      return;
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_work.notify_one();
+    }
+    m_writer.join();
+  }
+
+  uint64_t
+  get_dropped() const
+  {
+    return m_dropped;
+  }
+
+  virtual void send(severity_level l, const char* tag, const char* msg, std::thread::id tid) override
+  {
+    if (m_stop) {
+      m_dispatch->send(l, tag, msg, tid);
+      return;
+    }
+
+    auto pos = m_tail.load(std::memory_order_relaxed);
+    while (true) {
+      auto& rec = m_ring[pos & m_mask];
+      auto seq = rec.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<int64_t>(seq - pos);
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          rec.level = l;
+          rec.tid = tid;
+          copy(rec.tag, tag, tag_size);
+          copy(rec.msg, msg, msg_size);
+          rec.seq.store(pos + 1, std::memory_order_release);
+          if (m_sleeping)
+            m_work.notify_one();
+          return;
+        }
+      }
+      else if (diff < 0) {
+        ++m_dropped;
+        return;
+      }
+      else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+};
+#endif
+
 //-------
 message_dispatch*
 message_dispatch::
@@ -229,12 +402,12 @@ file_dispatch::~file_dispatch() {
 
 void
 file_dispatch::
-send(severity_level l, const char* tag, const char* msg)
+send(severity_level l, const char* tag, const char* msg, std::thread::id tid)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lk(mutex);
   handle << "[" << xrt_core::timestamp() <<"] [" << tag << "] Tid: "
-         << std::this_thread::get_id() << ", " << " " << severityMap[l]
+         << tid << ", " << " " << severityMap[l]
          << msg << std::endl;
 }
 
@@ -255,7 +428,7 @@ console_dispatch()
 
 void
 console_dispatch::
-send(severity_level l, const char* tag, const char* msg)
+send(severity_level l, const char* tag, const char* msg, std::thread::id)
 {
   static std::mutex mutex;
   std::lock_guard<std::mutex> lk(mutex);
@@ -263,6 +436,35 @@ send(severity_level l, const char* tag, const char* msg)
             << msg << std::endl;
 }
 
+#ifndef _WIN32
+static async_dispatch* async_dispatcher = nullptr;
+
+static void
+stop_async_dispatch()
+{
+  async_dispatcher->stop();
+}
+#endif
+
+// Dispatcher is created on first use and intentionally never deleted
+// since messages can be sent during static destruction
+static message_dispatch*
+get_dispatcher()
+{
+  static message_dispatch* dispatcher = [] {
+    auto dispatch = message_dispatch::make_dispatcher(xrt_core::config::get_logging());
+#ifndef _WIN32
+    if (xrt_core::config::get_logging_async()) {
+      async_dispatcher = new async_dispatch(dispatch, xrt_core::config::get_logging_queue_size());
+      std::atexit(stop_async_dispatch);
+      return static_cast<message_dispatch*>(async_dispatcher);
+    }
+#endif
+    return dispatch;
+  }();
+  return dispatcher;
+}
+
 } //end unnamed namespace
 
 namespace xrt_core { namespace message {
@@ -270,21 +472,28 @@ namespace xrt_core { namespace message {
 void
 send(severity_level l, const char* tag, const char* msg)
 {
-  static const std::string logger =  xrt_core::config::get_logging();
-  int ver = xrt_core::config::get_verbosity();
+  int ver = xrt_core::config::get_snapshot().verbosity;
   int lev = static_cast<int>(l);
 
-  if(ver >= lev) {
-    static message_dispatch* dispatcher = message_dispatch::make_dispatcher(logger);
-    dispatcher->send(l, tag, msg);
-  }
+  if(ver >= lev)
+    get_dispatcher()->send(l, tag, msg, std::this_thread::get_id());
+}
+
+uint64_t
+get_dropped()
+{
+#ifndef _WIN32
+  get_dispatcher();
+  return async_dispatcher ? async_dispatcher->get_dropped() : 0;
+#else
+  return 0;
+#endif
 }
 
 void
 sendv(severity_level l, const char* tag, const char* format, va_list args)
 {
-  static auto verbosity = xrt_core::config::get_verbosity();
-  if (l > (xrt_core::message::severity_level)verbosity) 
+  if (l > static_cast<severity_level>(xrt_core::config::get_snapshot().verbosity))
     return;
   
   va_list args_bak;
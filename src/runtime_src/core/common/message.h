@@ -35,6 +35,16 @@ send(severity_level l, const char* tag, const char* msg);
 void
 sendv(severity_level l, const char* tag, const char* format, va_list args);
 
+/**
+ * get_dropped() - Number of messages dropped by asynchronous logging
+ *
+ * With Runtime.runtime_log_async, messages are dropped when the
+ * queue of the background writer is full.
+ */
+XRT_CORE_COMMON_EXPORT
+uint64_t
+get_dropped();
+
 inline void
 send(severity_level l, const std::string& tag, const std::string& msg)
 {
@@ -45,7 +55,7 @@ template <typename ...Args>
 void
 send(severity_level l, const char* tag, const char* format, Args ... args)
 {
-  int ver = xrt_core::config::get_verbosity();
+  int ver = xrt_core::config::get_snapshot().verbosity;
   int lev = static_cast<int>(l);
 
   if (ver >= lev) {
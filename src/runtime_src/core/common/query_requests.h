@@ -75,6 +75,7 @@ enum class key_type
   group_topology,
   memstat,
   memstat_raw,
+  memfrag_raw,
   temp_by_mem_topology,
   mem_topology_raw,
   ip_layout_raw,
@@ -85,6 +86,7 @@ enum class key_type
   kds_scu_info,
   ps_kernel,
   xocl_errors,
+  xocl_errors_wait,
   xclbin_full,
   ic_enable,
   ic_load_flash_address,
@@ -231,6 +233,7 @@ enum class key_type
   cpu_affinity,
   shared_host_mem,
   enabled_host_mem,
+  numa_node,
 
   aie_metadata,
   aie_reg_read,
@@ -717,6 +720,17 @@ struct memstat_raw : request
   get(const device*) const = 0;
 };
 
+// Free extents of each memory bank, one line per bank
+// <free> <largest> <extents> <bo_count> <histogram <1M <16M <256M <4G >=4G>
+struct memfrag_raw : request
+{
+  using result_type = std::vector<std::string>;
+  static const key_type key = key_type::memfrag_raw;
+
+  virtual boost::any
+  get(const device*) const = 0;
+};
+
 struct dma_stream : request
 {
   using result_type = std::vector<std::string>;
@@ -1232,6 +1246,20 @@ struct xocl_errors : request
   to_errors(const std::vector<char>& buf);
 };
 
+// Block until the driver records a new asynchronous error or until
+// timeout.  The argument is the timeout in milliseconds.  Returns
+// true if the xocl errors changed, false on timeout.  A driver that
+// does not notify the errors node always times out.
+struct xocl_errors_wait : request
+{
+  using result_type = bool;
+  using timeout_type = int;
+  static const key_type key = key_type::xocl_errors_wait;
+
+  virtual boost::any
+  get(const device*, const boost::any& timeout_ms) const = 0;
+};
+
 struct dna_serial_num : request
 {
   using result_type = std::string;
@@ -2502,6 +2530,16 @@ struct enabled_host_mem : request
   get(const device*) const = 0;
 };
 
+// NUMA node of device PCIe root, -1 if not known
+struct numa_node : request
+{
+  using result_type = std::string;
+  static const key_type key = key_type::numa_node;
+
+  virtual boost::any
+  get(const device*) const = 0;
+};
+
 struct clock_timestamp : request
 {
   using result_type = uint64_t;
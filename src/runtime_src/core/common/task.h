@@ -21,13 +21,18 @@
 #include "debug.h"
 #include "config_reader.h"
 
+#include <array>
+#include <atomic>
 #include <future>
 #include <functional>
 #include <chrono>
+#include <memory>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning( push )
@@ -235,6 +240,369 @@ public:
 
 using queue = mpmcqueue<task>;
 
+/**
+ * Work stealing queue of task objects
+ *
+ * Same interface as mpmcqueue, but each worker thread that gets work
+ * from the queue owns a Chase-Lev deque.  Work added by a worker is
+ * pushed to the worker's own deque and popped LIFO by the worker,
+ * while idle workers steal FIFO from the deques of other workers.
+ * Work added by threads that are not workers of the queue goes to a
+ * shared injection queue.  Workers only take a lock when the
+ * injection queue has work or when there is no work and they go to
+ * sleep.
+ *
+ * Unlike mpmcqueue, work is not executed in order of addWork.
+ */
+template <typename Task>
+class wsqueue
+{
+  // Heap node for tasks held by value, the deques hold pointers
+  template <typename T>
+  struct node
+  {
+    static T* wrap(T&& t) { return new T(std::move(t)); }
+    static T unwrap(T* p) { T t(std::move(*p)); delete p; return t; }
+    static void discard(T* p) { delete p; }
+  };
+
+  template <typename T>
+  struct node<T*>
+  {
+    static T* wrap(T* t) { return t; }
+    static T* unwrap(T* p) { return p; }
+    static void discard(T*) {}
+  };
+
+  using node_type = node<Task>;
+  using element_type = decltype(node_type::wrap(std::declval<Task>()));
+
+  // Chase-Lev deque.  push() and take() are called by the owning
+  // worker only, steal() is called by any thread.  The ring buffer
+  // grows as needed, retired rings are kept until the deque is
+  // destructed since a thief may still be reading from them.
+  class deque
+  {
+    struct ring
+    {
+      int64_t mask;
+      std::unique_ptr<std::atomic<element_type>[]> buf;
+
+      explicit
+      ring(int64_t capacity)
+        : mask(capacity - 1), buf(new std::atomic<element_type>[capacity])
+      {}
+
+      int64_t capacity() const { return mask + 1; }
+      element_type get(int64_t i) const { return buf[i & mask].load(std::memory_order_relaxed); }
+      void put(int64_t i, element_type e) { buf[i & mask].store(e, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64_t> m_top {0};
+    std::atomic<int64_t> m_bottom {0};
+    std::atomic<ring*> m_ring;
+    std::vector<std::unique_ptr<ring>> m_rings;
+
+    ring*
+    grow(ring* r, int64_t top, int64_t bottom)
+    {
+      m_rings.push_back(std::make_unique<ring>(r->capacity() * 2));
+      auto nr = m_rings.back().get();
+      for (auto i = top; i < bottom; ++i)
+        nr->put(i, r->get(i));
+      m_ring.store(nr, std::memory_order_release);
+      return nr;
+    }
+
+  public:
+    std::atomic<bool> owned {false};
+
+    deque()
+    {
+      m_rings.push_back(std::make_unique<ring>(256));
+      m_ring = m_rings.back().get();
+    }
+
+    void
+    push(element_type e)
+    {
+      auto b = m_bottom.load(std::memory_order_relaxed);
+      auto t = m_top.load(std::memory_order_acquire);
+      auto r = m_ring.load(std::memory_order_relaxed);
+      if (b - t > r->capacity() - 1)
+        r = grow(r, t, b);
+      r->put(b, e);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    element_type
+    take()
+    {
+      auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+      auto r = m_ring.load(std::memory_order_relaxed);
+      m_bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto t = m_top.load(std::memory_order_relaxed);
+      if (t > b) {
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+
+      auto e = r->get(b);
+      if (t == b) {
+        // last element, race against thieves
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          e = nullptr;
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return e;
+    }
+
+    element_type
+    steal()
+    {
+      auto t = m_top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      auto b = m_bottom.load(std::memory_order_acquire);
+      if (t >= b)
+        return nullptr;
+
+      auto e = m_ring.load(std::memory_order_acquire)->get(t);
+      if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+      return e;
+    }
+  };
+
+  // Deque of calling thread if it is a worker of this queue
+  struct worker_slot
+  {
+    uint64_t queue_id = 0;
+    deque* dq = nullptr;
+  };
+
+  static worker_slot&
+  get_slot()
+  {
+    static thread_local worker_slot slot;
+    return slot;
+  }
+
+  static uint64_t
+  create_id()
+  {
+    static std::atomic<uint64_t> count {0};
+    return ++count;
+  }
+
+  static constexpr size_t max_workers = 64;
+
+  uint64_t m_id = create_id();
+  std::array<std::unique_ptr<deque>, max_workers> m_deques;
+  std::atomic<size_t> m_ndeques {0};
+
+  std::queue<element_type> m_inject;   // work from non-worker threads
+  std::atomic<size_t> m_ninject {0};
+  mutable std::mutex m_mutex;
+  std::condition_variable m_work;
+
+  std::atomic<int64_t> m_pending {0};  // work in deques and injection queue
+  std::atomic<unsigned int> m_sleepers {0};
+  std::atomic<bool> m_stop {false};
+
+  // Make calling thread a worker by giving it a deque
+  deque*
+  attach()
+  {
+    auto& slot = get_slot();
+    if (slot.queue_id == m_id)
+      return slot.dq;
+
+    // Reuse a deque released by a former worker
+    auto n = m_ndeques.load(std::memory_order_acquire);
+    for (size_t idx = 0; idx < n; ++idx) {
+      auto dq = m_deques[idx].get();
+      if (!dq->owned.exchange(true, std::memory_order_acq_rel)) {
+        slot = {m_id, dq};
+        return dq;
+      }
+    }
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    n = m_ndeques.load(std::memory_order_relaxed);
+    if (n == max_workers)
+      return nullptr;
+
+    m_deques[n] = std::make_unique<deque>();
+    auto dq = m_deques[n].get();
+    dq->owned = true;
+    m_ndeques.store(n + 1, std::memory_order_release);
+    slot = {m_id, dq};
+    return dq;
+  }
+
+  // Release the deque of calling thread, work left in the deque can
+  // still be stolen and is taken by the next owner
+  void
+  detach()
+  {
+    auto& slot = get_slot();
+    if (slot.queue_id != m_id)
+      return;
+    slot.dq->owned.store(false, std::memory_order_release);
+    slot = {};
+  }
+
+  element_type
+  find_work(deque* own)
+  {
+    if (own)
+      if (auto e = own->take())
+        return e;
+
+    if (m_ninject.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      if (!m_inject.empty()) {
+        auto e = m_inject.front();
+        m_inject.pop();
+        --m_ninject;
+        return e;
+      }
+    }
+
+    // Steal starting from the deque after own
+    auto n = m_ndeques.load(std::memory_order_acquire);
+    size_t start = 0;
+    for (size_t idx = 0; idx < n; ++idx)
+      if (m_deques[idx].get() == own)
+        start = idx + 1;
+    for (size_t i = 0; i < n; ++i) {
+      auto dq = m_deques[(start + i) % n].get();
+      if (dq == own)
+        continue;
+      if (auto e = dq->steal())
+        return e;
+    }
+
+    return nullptr;
+  }
+
+  element_type
+  wait_work(const std::atomic<bool>* cancel)
+  {
+    auto own = attach();
+    while (true) {
+      if (m_stop || (cancel && *cancel))
+        return nullptr;
+
+      if (auto e = find_work(own)) {
+        --m_pending;
+        return e;
+      }
+
+      // Work is pending but was not found, e.g. a lost steal race
+      // or a worker adding work, retry without sleeping
+      if (m_pending > 0) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lk(m_mutex);
+      ++m_sleepers;
+      if (!m_stop && !(cancel && *cancel) && m_pending <= 0)
+        m_work.wait(lk);
+      --m_sleepers;
+    }
+  }
+
+public:
+  wsqueue()
+  {}
+
+  ~wsqueue()
+  {
+    auto n = m_ndeques.load();
+    for (size_t idx = 0; idx < n; ++idx)
+      while (auto e = m_deques[idx]->steal())
+        node_type::discard(e);
+    while (!m_inject.empty()) {
+      node_type::discard(m_inject.front());
+      m_inject.pop();
+    }
+  }
+
+  wsqueue(const wsqueue&) = delete;
+  wsqueue& operator=(const wsqueue&) = delete;
+
+  void
+  addWork(Task&& t)
+  {
+    auto e = node_type::wrap(std::move(t));
+    auto& slot = get_slot();
+    if (slot.queue_id == m_id) {
+      slot.dq->push(e);
+    }
+    else {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_inject.push(e);
+      ++m_ninject;
+    }
+
+    ++m_pending;
+    if (m_sleepers) {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_work.notify_one();
+    }
+  }
+
+  // Get work, blocks until work is available or queue is stopped
+  Task
+  getWork()
+  {
+    if (auto e = wait_work(nullptr))
+      return node_type::unwrap(e);
+    detach();
+    return Task{};
+  }
+
+  // Get work, blocks until work is available, queue is stopped, or
+  // cancel is set followed by notify()
+  Task
+  getWork(const std::atomic<bool>& cancel)
+  {
+    if (auto e = wait_work(&cancel))
+      return node_type::unwrap(e);
+    detach();
+    return Task{};
+  }
+
+  // Wake up all sleeping workers
+  void
+  notify()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_work.notify_all();
+  }
+
+  size_t
+  size() const
+  {
+    auto pending = m_pending.load();
+    return pending > 0 ? static_cast<size_t>(pending) : 0;
+  }
+
+  void
+  stop()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+    m_work.notify_all();
+  }
+};
+
+using stealing_queue = wsqueue<task>;
+
 /**
  * event class wraps std::future<RT>
  *
@@ -394,6 +762,19 @@ worker(queue& q)
 {
   return worker2(q,"");
 }
+
+// A stealing worker is a thread function getting work off a work
+// stealing queue.  The worker runs until the queue is stopped.
+inline void
+stealing_worker(stealing_queue& q)
+{
+  while (true) {
+    auto t = q.getWork();
+    if (!t.valid())
+      break;
+    t();
+  }
+}
 }} // task,xrt_core
 
 #ifdef _WIN32
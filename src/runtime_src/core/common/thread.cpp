@@ -19,8 +19,12 @@
 #include "message.h"
 #include "config_reader.h"
 
-#include <thread>
+#include <array>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -55,6 +59,39 @@ debug_thread_policy(const std::string& str, int policy, int priority)
   }
 }
 
+static void
+get_thread_policy(const std::string& config_policy, int& policy, int& priority)
+{
+  sched_param sch;
+  pthread_getschedparam(pthread_self(),&policy,&sch);
+  priority = sch.sched_priority;
+
+  debug_thread_policy("default",policy,priority);
+
+  if (config_policy=="rr") {
+    policy = SCHED_RR;
+    priority = 1;
+  }
+  else if (config_policy=="fifo") {
+    policy = SCHED_FIFO;
+    priority = 1;
+  }
+  else if (config_policy=="other") {
+    policy = SCHED_OTHER;
+    priority = 0;
+  }
+
+  debug_thread_policy("config",policy,priority);
+}
+
+static void
+set_thread_policy(std::thread& thread, int policy, int priority)
+{
+  struct sched_param sch;
+  sch.sched_priority = priority;
+  pthread_setschedparam(thread.native_handle(), policy, &sch);
+}
+
 static void
 set_thread_policy(std::thread& thread)
 {
@@ -63,33 +100,76 @@ set_thread_policy(std::thread& thread)
   static bool initialized = false;
   if (!initialized) {
     initialized=true;
+    static std::string config_policy = xrt_core::config::detail::get_string_value("Runtime.thread_policy","default");
+    get_thread_policy(config_policy,policy,priority);
+  }
 
-    sched_param sch;
-    pthread_getschedparam(pthread_self(),&policy,&sch);
-    priority = sch.sched_priority;
+  set_thread_policy(thread,policy,priority);
+}
 
-    debug_thread_policy("default",policy,priority);
+// Parse cpus string into cpuset, return false if all cpus
+static bool
+get_cpu_set(std::string cpus, cpu_set_t& cpuset)
+{
+  if (cpus=="default")
+    return false;
 
-    static std::string config_policy = xrt_core::config::detail::get_string_value("Runtime.thread_policy","default");
-    if (config_policy=="rr") {
-      policy = SCHED_RR;
-      priority = 1;
+  boost::trim_if(cpus,boost::is_any_of("{}"));
+  using tokenizer=boost::tokenizer<boost::char_separator<char> >;
+  boost::char_separator<char> sep(", ");
+  auto max_cpus = std::thread::hardware_concurrency();
+  CPU_ZERO(&cpuset);
+  for (auto& tok : tokenizer(cpus,sep)) {
+    auto cpu = std::stoul(tok);
+    if (cpu < max_cpus) {
+      XRT_DEBUG(std::cout,"adding cpu #",cpu," to affinity mask\n");
+      CPU_SET(cpu,&cpuset);
     }
-    else if (config_policy=="fifo") {
-      policy = SCHED_FIFO;
-      priority = 1;
-    }
-    else if (config_policy=="other") {
-      policy = SCHED_OTHER;
-      priority = 0;
+    else {
+      xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring cpu affinity since cpu #" + tok + " is out of range\n");
+      return false;
     }
+  }
+  return true;
+}
 
-    debug_thread_policy("config",policy,priority);
+// Parse cpus of a numa node into cpuset, return false if no such node
+// The node cpulist is a range list, e.g. "0-3,8-11"
+static bool
+get_numa_cpu_set(const std::string& node, cpu_set_t& cpuset)
+{
+  if (node=="default")
+    return false;
+
+  std::ifstream istr("/sys/devices/system/node/node" + node + "/cpulist");
+  std::string cpulist;
+  if (!istr || !std::getline(istr,cpulist)) {
+    xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring numa node " + node + " since it does not exist\n");
+    return false;
   }
 
-  struct sched_param sch;
-  sch.sched_priority = priority;
-  pthread_setschedparam(thread.native_handle(), policy, &sch);
+  using tokenizer=boost::tokenizer<boost::char_separator<char> >;
+  boost::char_separator<char> sep(",\n ");
+  auto max_cpus = std::thread::hardware_concurrency();
+  CPU_ZERO(&cpuset);
+  for (auto& tok : tokenizer(cpulist,sep)) {
+    auto dash = tok.find('-');
+    auto first = std::stoul(tok.substr(0,dash));
+    auto last = (dash == std::string::npos) ? first : std::stoul(tok.substr(dash+1));
+    for (auto cpu = first; cpu <= last && cpu < max_cpus; ++cpu) {
+      XRT_DEBUG(std::cout,"adding numa node ",node," cpu #",cpu," to affinity mask\n");
+      CPU_SET(cpu,&cpuset);
+    }
+  }
+  return CPU_COUNT(&cpuset) > 0;
+}
+
+static void
+set_cpu_affinity(std::thread& thread, const cpu_set_t& cpuset)
+{
+  if (pthread_setaffinity_np(thread.native_handle(),sizeof(cpu_set_t),&cpuset)) {
+    throw std::runtime_error("error calling pthread_setaffinity_np");
+  }
 }
 
 static void
@@ -100,36 +180,87 @@ set_cpu_affinity(std::thread& thread)
   static bool all=false;
   if (!initialized) {
     initialized = true;
-
-    std::string cpus = xrt_core::config::detail::get_string_value("Runtime.cpu_affinity","default");
-    if (cpus=="default")
-      all=true;
-    else {
-      boost::trim_if(cpus,boost::is_any_of("{}"));
-      using tokenizer=boost::tokenizer<boost::char_separator<char> >;
-      boost::char_separator<char> sep(", ");
-      auto max_cpus = std::thread::hardware_concurrency();
-      CPU_ZERO(&cpuset);
-      for (auto& tok : tokenizer(cpus,sep)) {
-        auto cpu = std::stoul(tok);
-        if (cpu < max_cpus) {
-          XRT_DEBUG(std::cout,"adding cpu #",cpu," to affinity mask\n");
-          CPU_SET(cpu,&cpuset);
-        }
-        else {
-          xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring cpu affinity since cpu #" + tok + " is out of range\n");
-          all=true;
-        }
-      }
-    }
+    all = !get_cpu_set(xrt_core::config::detail::get_string_value("Runtime.cpu_affinity","default"), cpuset);
   }
 
   if (all)
     return;
 
-  if (pthread_setaffinity_np(thread.native_handle(),sizeof(cpu_set_t),&cpuset)) {
-    throw std::runtime_error("error calling pthread_setaffinity_np");
+  set_cpu_affinity(thread, cpuset);
+}
+
+static void
+set_cpu_affinity(std::thread& thread, const std::string& cpus)
+{
+  cpu_set_t cpuset;
+  if (get_cpu_set(cpus, cpuset))
+    set_cpu_affinity(thread, cpuset);
+}
+
+// Placement of threads in a class, read from xrt.ini when the first
+// thread of the class is created.  A class setting overrides the
+// setting of all threads.
+struct placement
+{
+  int policy = 0;
+  int priority = 0;
+  bool all = true;
+  cpu_set_t cpuset;
+
+  explicit
+  placement(xrt_core::thread_class cls)
+  {
+    static const char* names[] = { "general", "scheduler", "dma", "profile", "xma" };
+    auto idx = static_cast<size_t>(cls);
+    auto prefix = std::string("Runtime.") + (idx ? std::string(names[idx]) + "_" : std::string());
+    auto value = [&prefix](const std::string& key) {
+      auto global = xrt_core::config::detail::get_string_value(("Runtime." + key).c_str(),"default");
+      return xrt_core::config::detail::get_string_value((prefix + key).c_str(),global);
+    };
+
+    get_thread_policy(value("thread_policy"),policy,priority);
+
+    all = !get_cpu_set(value("cpu_affinity"),cpuset);
+
+    cpu_set_t numa_cpuset;
+    if (!get_numa_cpu_set(value("numa_node"),numa_cpuset))
+      return;
+
+    if (all) {
+      cpuset = numa_cpuset;
+      all = false;
+      return;
+    }
+
+    cpu_set_t both;
+    CPU_AND(&both,&cpuset,&numa_cpuset);
+    if (CPU_COUNT(&both) == 0) {
+      xrt_core::message::send(xrt_core::message::severity_level::warning,"XRT", "Ignoring " + prefix + "cpu_affinity since no cpu is in the numa node\n");
+      both = numa_cpuset;
+    }
+    cpuset = both;
   }
+};
+
+static const placement&
+get_placement(xrt_core::thread_class cls)
+{
+  static std::mutex mutex;
+  static std::array<std::unique_ptr<placement>, 5> placements;
+  std::lock_guard<std::mutex> lk(mutex);
+  auto& p = placements.at(static_cast<size_t>(cls));
+  if (!p)
+    p = std::make_unique<placement>(cls);
+  return *p;
+}
+
+static void
+set_thread_placement(std::thread& thread, xrt_core::thread_class cls)
+{
+  auto& p = get_placement(cls);
+  set_thread_policy(thread,p.policy,p.priority);
+  if (!p.all)
+    set_cpu_affinity(thread,p.cpuset);
 }
 
 #else
@@ -144,6 +275,16 @@ set_cpu_affinity(std::thread&)
 {
 }
 
+static void
+set_cpu_affinity(std::thread&, const std::string&)
+{
+}
+
+static void
+set_thread_placement(std::thread&, xrt_core::thread_class)
+{
+}
+
 #endif
 
 } // platform_specific
@@ -164,6 +305,16 @@ void set_cpu_affinity(std::thread& thread)
   ::platform_specific::set_cpu_affinity(thread);
 }
 
+void set_cpu_affinity(std::thread& thread, const std::string& cpus)
+{
+  ::platform_specific::set_cpu_affinity(thread, cpus);
+}
+
+void set_thread_placement(std::thread& thread, thread_class cls)
+{
+  ::platform_specific::set_thread_placement(thread, cls);
+}
+
 } // detail
 
 } // xrt_core
@@ -18,10 +18,36 @@
 #define xrt_core_common_thread_h_
 
 #include "config.h"
+#include <string>
 #include <thread>
 
 namespace xrt_core { 
 
+/**
+ * enum thread_class - Class of an XRT internal thread
+ *
+ * @general:   Threads not in other classes
+ * @scheduler: Command scheduling and completion monitoring
+ * @dma:       Buffer transfers and copies
+ * @profile:   Profiling and trace offload, processing and polling
+ * @xma:       XMA session management
+ *
+ * The placement of threads is configured per class in xrt.ini.  The
+ * class name is used as key prefix, for example:
+ *  [Runtime]
+ *   cpu_affinity = {0,1}
+ *   scheduler_cpu_affinity = {2}
+ *   dma_numa_node = 1
+ *   profile_thread_policy = other
+ *
+ * A class without a setting uses the Runtime.cpu_affinity and
+ * Runtime.thread_policy of all threads.  A numa node restricts the
+ * cpus of a class to the cpus of the node.  The settings can also be
+ * changed with xrt::ini::set() before the first thread of the class
+ * is created.
+ */
+enum class thread_class { general, scheduler, dma, profile, xma };
+
 namespace detail {
 
 /**
@@ -41,6 +67,22 @@ XRT_CORE_COMMON_EXPORT
 void
 set_cpu_affinity(std::thread& thread);
 
+/**
+ * Pin a thread to cpus specified as "{0,2,...}", or leave as is
+ * if cpus is "default"
+ */
+XRT_CORE_COMMON_EXPORT
+void
+set_cpu_affinity(std::thread& thread, const std::string& cpus);
+
+/**
+ * Set policy and cpu affinity of a thread per configuration of its
+ * thread class
+ */
+XRT_CORE_COMMON_EXPORT
+void
+set_thread_placement(std::thread& thread, thread_class cls);
+
 }
 
 /**
@@ -60,8 +102,19 @@ std::thread
 thread(Args&&... args)
 {
   auto t = std::thread(std::forward<Args>(args)...);
-  detail::set_thread_policy(t);
-  detail::set_cpu_affinity(t);
+  detail::set_thread_placement(t, thread_class::general);
+  return t;
+}
+
+/**
+ * Construct a thread and place it per configuration of its class
+ */
+template <typename ...Args>
+std::thread
+thread(thread_class cls, Args&&... args)
+{
+  auto t = std::thread(std::forward<Args>(args)...);
+  detail::set_thread_placement(t, cls);
   return t;
 }
 
@@ -16,11 +16,24 @@
 
 #define XRT_CORE_COMMON_SOURCE
 #include "time.h"
+#include "config_reader.h"
 
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <ctime>
 
+#if defined(__x86_64__) || defined(_M_X64)
+# define XRT_TIME_TSC
+# ifdef _WIN32
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+#  include <x86intrin.h>
+# endif
+#endif
+
 #ifdef _WIN32
 # pragma warning ( disable : 4996 )
 #endif
@@ -34,6 +47,81 @@ get_gmtime(const std::time_t& time)
   return tm;
 }
 
+#ifdef XRT_TIME_TSC
+// Invariant TSC runs at a constant rate regardless of frequency
+// scaling and sleep states, cpuid leaf 0x80000007 edx bit 8
+static bool
+has_invariant_tsc()
+{
+  unsigned int regs[4] = {0};
+#ifdef _WIN32
+  __cpuid(reinterpret_cast<int*>(regs), 0x80000000);
+  if (regs[0] < 0x80000007)
+    return false;
+  __cpuid(reinterpret_cast<int*>(regs), 0x80000007);
+#else
+  if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+    return false;
+  __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+  return (regs[3] & (1 << 8)) != 0;
+}
+
+// Conversion of TSC ticks to nanoseconds since the first call to
+// time_ns().  The TSC rate is calibrated once against steady_clock,
+// and ticks are scaled by a fixed point multiplier.
+struct tsc_clock
+{
+  bool valid = false;
+  uint64_t zero = 0;
+  uint64_t mult = 0;
+  unsigned int shift = 0;
+
+  tsc_clock()
+  {
+    if (!xrt_core::config::get_tsc_timestamps() || !has_invariant_tsc())
+      return;
+
+    // Calibration error is the steady_clock resolution over the
+    // calibration period, a few ppm for 10ms
+    auto steady_start = std::chrono::steady_clock::now();
+    uint64_t tsc_start = __rdtsc();
+    std::chrono::steady_clock::time_point steady_end;
+    do {
+      steady_end = std::chrono::steady_clock::now();
+    } while (steady_end - steady_start < std::chrono::milliseconds(10));
+    uint64_t tsc_end = __rdtsc();
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(steady_end - steady_start).count();
+    if (tsc_end <= tsc_start || ns <= 0)
+      return;
+
+    // Rates outside 100MHz - 10GHz indicate an unreliable TSC
+    double hz = static_cast<double>(tsc_end - tsc_start) * 1.0e9 / static_cast<double>(ns);
+    if (hz < 1.0e8 || hz > 1.0e10)
+      return;
+
+    // Largest shift that keeps the multiplier in 32 bits, so scaling
+    // the low 32 bits of ticks does not overflow
+    shift = 32;
+    while (shift > 0 && std::ldexp(1.0e9, shift) / hz >= 4294967296.0)
+      --shift;
+    mult = static_cast<uint64_t>(std::ldexp(1.0e9, shift) / hz);
+    zero = tsc_start;
+    valid = true;
+  }
+
+  unsigned long
+  ns(uint64_t tsc) const
+  {
+    uint64_t ticks = tsc - zero;
+    uint64_t high = (ticks >> 32) * mult;
+    uint64_t low = ((ticks & 0xffffffff) * mult) >> shift;
+    return static_cast<unsigned long>((high << (32 - shift)) + low);
+  }
+};
+#endif
+
 }
 
 namespace xrt_core {
@@ -45,6 +133,11 @@ namespace xrt_core {
 unsigned long
 time_ns()
 {
+#ifdef XRT_TIME_TSC
+  static const tsc_clock tsc;
+  if (tsc.valid)
+    return tsc.ns(__rdtsc());
+#endif
   static auto zero = std::chrono::high_resolution_clock::now();
   auto now = std::chrono::high_resolution_clock::now();
   auto integral_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now-zero).count();
@@ -0,0 +1,54 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef core_common_usdt_h_
+#define core_common_usdt_h_
+
+// XRT_USDT(name, args...) - static probe "xrt:name" in host code
+//
+// A probe is a single nop instruction until a tracer attaches to it,
+// e.g.
+//   % bpftrace -l 'usdt:/opt/xilinx/xrt/lib/libxrt_coreutil.so:xrt:*'
+// Probe arguments are evaluated also when no tracer is attached, so
+// they must be cheap, e.g. pointers and integers already at hand.
+//
+// Probes compile to nothing when <sys/sdt.h> (systemtap-sdt-dev) is
+// not available at build time.
+//
+// Probes and arguments
+//   kernel_construct   kernel_impl*, const char* name
+//   run_start          xrt_core::command*, unsigned int exec bo handle
+//   kds_launch         xrt_core::command*, unsigned int exec bo handle
+//   exec_wait_return   xrt_core::device*, int shim exec_wait return value
+//   notify_host        xrt_core::command*, int ert_cmd_state
+//   bo_sync_begin      bo_impl*, int direction, size_t size, size_t offset
+//   bo_sync_end        bo_impl*, int direction
+//
+// The exec bo handle matches exec_bo_handle of the xrt:* kernel
+// tracepoints of the driver for the same process.
+
+#if defined(__linux__) && defined(__has_include)
+# if __has_include(<sys/sdt.h>)
+#  include <sys/sdt.h>
+#  define XRT_USDT(...) STAP_PROBEV(xrt, __VA_ARGS__)
+# endif
+#endif
+
+#ifndef XRT_USDT
+# define XRT_USDT(...)
+#endif
+
+#endif
@@ -886,6 +886,7 @@ get_kernel_properties(const char* xml_data, size_t xml_size, const std::string&
     auto restart = convert(xml_kernel.second.get<std::string>("<xmlattr>.countedAutoRestart", "0"));
     if (restart == 0)
       restart = get_restart_from_ini(kname);
+    auto restart_offset = convert(xml_kernel.second.get<std::string>("<xmlattr>.countedAutoRestartOffset", "0x10"));
     auto sw_reset = to_bool(xml_kernel.second.get<std::string>("<xmlattr>.swReset", "false"));
     if (!sw_reset)
       sw_reset = get_sw_reset_from_ini(kname);
@@ -894,6 +895,7 @@ get_kernel_properties(const char* xml_data, size_t xml_size, const std::string&
       { kname
       , to_kernel_type(xml_kernel.second.get<std::string>("<xmlattr>.type", "pl"))
       , restart
+      , restart_offset
       , mailbox
       , get_address_range(xml_kernel.second)
       , sw_reset
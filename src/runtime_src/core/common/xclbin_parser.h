@@ -59,6 +59,7 @@ struct kernel_properties
   std::string name;
   kernel_type type = kernel_type::none;
   restart_type counted_auto_restart = 0;
+  size_t auto_restart_counter_offset = 0x10; // NOLINT, default counter offset
   mailbox_type mailbox = mailbox_type::none;
   size_t address_range = 0x10000;  // NOLINT, default address range
   bool sw_reset = false;
@@ -198,6 +198,35 @@ ssize_t unix_socket::sk_write(const void *wbuf, size_t count)
   return wlen;
 }
 
+ssize_t unix_socket::sk_write(const void *hbuf, size_t hcount, const void *wbuf, size_t count)
+{
+  struct iovec iov[2];
+  iov[0].iov_base = const_cast<void*>(hbuf);
+  iov[0].iov_len = hcount;
+  iov[1].iov_base = const_cast<void*>(wbuf);
+  iov[1].iov_len = count;
+
+  ssize_t r;
+  do {
+    r = writev(fd, iov, 2);
+  } while (r < 0 && (errno == EINTR || errno == EAGAIN));
+  if (r < 0)
+    return -1;
+
+  // Write whatever writev() left out
+  size_t wlen = r;
+  if (wlen < hcount) {
+    if (sk_write(static_cast<const unsigned char*>(hbuf) + wlen, hcount - wlen) < 0)
+      return -1;
+    wlen = hcount;
+  }
+  if (wlen < hcount + count) {
+    if (sk_write(static_cast<const unsigned char*>(wbuf) + wlen - hcount, hcount + count - wlen) < 0)
+      return -1;
+  }
+  return hcount + count;
+}
+
 ssize_t unix_socket::sk_read(void *rbuf, size_t count)
 {
   ssize_t r;
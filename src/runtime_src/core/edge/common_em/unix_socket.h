@@ -19,6 +19,7 @@
 #ifndef __XCLHOST_UNIXSOCKET__
 #define __XCLHOST_UNIXSOCKET__
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <sys/stat.h>
 #include <boost/algorithm/string.hpp>
@@ -52,6 +53,8 @@ public:
        close(fd);
     }
     ssize_t sk_write(const void *wbuf, size_t count);
+    // Write a message header and its payload with one system call
+    ssize_t sk_write(const void *hbuf, size_t hcount, const void *wbuf, size_t count);
     ssize_t sk_read(void *rbuf, size_t count);
 };
 
@@ -104,6 +104,7 @@
 #endif
 
 struct sched_client_ctx;
+struct zocl_cma_chunk;
 
 struct drm_zocl_exec_metadata {
 	enum drm_zocl_execbuf_state state;
@@ -126,6 +127,7 @@ struct drm_zocl_bo {
 		};
 	};
 	struct drm_mm_node            *mm_node;
+	struct zocl_cma_chunk         *cma_chunk;
 	struct drm_zocl_exec_metadata  metadata;
 	unsigned int                   mem_index;
 	uint32_t                       flags;
@@ -224,6 +226,14 @@ struct drm_zocl_bo *zocl_drm_create_bo(struct drm_device *dev,
 void zocl_update_mem_stat(struct drm_zocl_dev *zdev, u64 size,
 		int count, uint32_t bank);
 void zocl_init_mem(struct drm_zocl_dev *zdev, struct drm_zocl_slot *slot);
+void zocl_cma_pool_init(struct drm_zocl_dev *zdev);
+void zocl_cma_pool_fill(struct drm_zocl_dev *zdev);
+void zocl_cma_pool_fini(struct drm_zocl_dev *zdev);
+struct drm_zocl_bo *zocl_cma_pool_get_bo(struct drm_zocl_dev *zdev,
+		size_t size);
+bool zocl_cma_pool_put_bo(struct drm_zocl_dev *zdev, struct drm_zocl_bo *bo);
+ssize_t zocl_cma_pool_show(struct drm_zocl_dev *zdev, char *buf);
+void zocl_free_cma_bo(struct drm_gem_object *obj);
 void zocl_clear_mem(struct drm_zocl_dev *zdev);
 void zocl_clear_mem_slot(struct drm_zocl_dev *zdev, u32 slot_idx);
 int zocl_create_aie(struct drm_zocl_dev *zdev, struct axlf *axlf,
@@ -269,6 +279,8 @@ int zocl_command_ioctl(struct drm_zocl_dev *zdev, void *data,
 		       struct drm_file *filp);
 int zocl_context_ioctl(struct drm_zocl_dev *zdev, void *data,
 		       struct drm_file *filp);
+int zocl_context_vec_ioctl(struct drm_zocl_dev *zdev, void *data,
+			   struct drm_file *filp);
 struct platform_device *zocl_find_pdev(char *name);
 
 static inline struct drm_zocl_dev *
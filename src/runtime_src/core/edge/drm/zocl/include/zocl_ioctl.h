@@ -25,6 +25,8 @@ int zocl_get_hbo_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
 int zocl_sync_bo_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
+int zocl_sync_bo_vec_ioctl(struct drm_device *dev, void *data,
+		struct drm_file *filp);
 int zocl_map_bo_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
 int zocl_info_bo_ioctl(struct drm_device *dev, void *data,
@@ -47,6 +49,8 @@ int zocl_info_cu_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
 int zocl_ctx_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
+int zocl_ctx_vec_ioctl(struct drm_device *dev, void *data,
+		struct drm_file *filp);
 int zocl_error_ioctl(struct drm_device *dev, void *data,
 		struct drm_file *filp);
 int zocl_aie_fd_ioctl(struct drm_device *dev, void *data,
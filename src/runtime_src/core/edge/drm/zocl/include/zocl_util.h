@@ -86,6 +86,28 @@ struct zocl_mem {
 	struct list_head        zm_list;
 };
 
+#define ZOCL_CMA_POOL_MAX_CLASSES	8
+
+/*
+ * A size class of the CMA BO pool. The chunks on the free list are
+ * CMA buffers of the class size that no BO uses at the moment.
+ */
+struct zocl_cma_pool_class {
+	size_t			size;
+	unsigned int		count;
+	unsigned int		free;
+	struct list_head	chunks;
+	u64			hits;
+	u64			misses;
+};
+
+struct zocl_cma_pool {
+	spinlock_t			lock;
+	bool				enabled;
+	int				num_classes;
+	struct zocl_cma_pool_class	classes[ZOCL_CMA_POOL_MAX_CLASSES];
+};
+
 /*
  * zocl dev specific data info, if there are different configs across
  * different compitible device, add their specific data here.
@@ -140,6 +162,7 @@ struct drm_zocl_dev {
 	struct zocl_mem		*mem;
 	struct drm_mm           *zm_drm_mm;    /* DRM MM node for PL-DDR */
 	struct mutex		 mm_lock;
+	struct zocl_cma_pool	 cma_pool;
 	struct mutex		 aie_lock;
 
 	struct list_head	 ctx_list;
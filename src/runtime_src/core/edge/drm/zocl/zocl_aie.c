@@ -863,25 +863,23 @@ zocl_aie_getcmd_ioctl(struct drm_device *dev, void *data, struct drm_file *filp)
 	if(aie == NULL)
 		return -EAGAIN;
 
-	/* If no command, the process who calls this ioctl will block here */
+	/*
+	 * If no command, the process who calls this ioctl will block here
+	 * until a command is queued or a signal is received.
+	 */
 	mutex_lock(&aie->aie_lock);
 	while (list_empty(&aie->aie_cmd_list)) {
 		mutex_unlock(&aie->aie_lock);
-		/*
- 		 * Return greater than 0 if condition true before timeout,
- 		 * 0 when time out, else -ERESTARTSYS.
- 		 */
-		ret = wait_event_interruptible_timeout(aie->aie_wait_queue,
-		    !list_empty(&aie->aie_cmd_list), msecs_to_jiffies(500));
-		if (ret <= 0) {
+		ret = wait_event_interruptible(aie->aie_wait_queue,
+		    !list_empty(&aie->aie_cmd_list));
+		if (ret)
 			return -ERESTARTSYS;
-                }
 		mutex_lock(&aie->aie_lock);
 	}
 
 	acmd = list_first_entry(&aie->aie_cmd_list, struct aie_info_cmd,
 	    aiec_list);
-	list_del(&acmd->aiec_list);
+	list_del_init(&acmd->aiec_list);
 
 	/* Only one aied thread */
 	aie->cmd_inprogress = acmd;
@@ -896,7 +894,7 @@ zocl_aie_putcmd_ioctl(struct drm_device *dev, void *data, struct drm_file *filp)
 {
 	struct drm_zocl_dev *zdev = dev->dev_private;
 	struct aie_info *aie = zdev->aie_information;
-	struct aie_info_cmd *acmd;
+	struct aie_info_cmd *acmd, *pos, *next;
 	struct drm_zocl_aie_cmd *kdata = data;
 	struct aie_info_packet *cmd;
 
@@ -905,16 +903,32 @@ zocl_aie_putcmd_ioctl(struct drm_device *dev, void *data, struct drm_file *filp)
 
 	mutex_lock(&aie->aie_lock);
 	acmd = aie->cmd_inprogress;
-	mutex_unlock(&aie->aie_lock);
 	if (!acmd) {
+		mutex_unlock(&aie->aie_lock);
 		return -ENOMEM;
 	}
+	aie->cmd_inprogress = NULL;
 
 	cmd = acmd->aiec_packet;
 	cmd->size = (kdata->size < AIE_INFO_SIZE) ? kdata->size : AIE_INFO_SIZE;
 	snprintf(cmd->info, cmd->size, "%s", (char *)kdata->info);
 
+	/*
+	 * Requests of the same kind queued while aied was processing this
+	 * one are answered with the same reply.  The request is released
+	 * last, its packet is freed by the requester once released.
+	 */
+	list_for_each_entry_safe(pos, next, &aie->aie_cmd_list, aiec_list) {
+		if (pos->aiec_packet->opcode != cmd->opcode)
+			continue;
+
+		list_del_init(&pos->aiec_list);
+		pos->aiec_packet->size = cmd->size;
+		memcpy(pos->aiec_packet->info, cmd->info, cmd->size);
+		up(&pos->aiec_sem);
+	}
 	up(&acmd->aiec_sem);
+	mutex_unlock(&aie->aie_lock);
 
 	return 0;
 }
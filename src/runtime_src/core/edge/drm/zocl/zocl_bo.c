@@ -143,12 +143,26 @@ void zocl_free_userptr_bo(struct drm_gem_object *gem_obj)
 	kfree(&zocl_bo->cma_base);
 }
 
+void zocl_free_cma_bo(struct drm_gem_object *obj)
+{
+	struct drm_zocl_dev *zdev = obj->dev->dev_private;
+
+	if (!zocl_cma_pool_put_bo(zdev, to_zocl_bo(obj)))
+		drm_gem_cma_free_object(obj);
+}
+
 static struct drm_zocl_bo *
 zocl_create_cma_mem(struct drm_device *dev, size_t size)
 {
+	struct drm_zocl_dev *zdev = dev->dev_private;
 	struct drm_gem_cma_object *cma_obj;
 	struct drm_zocl_bo *bo;
 
+	/* Take a pre-reserved buffer of the size class if there is one */
+	bo = zocl_cma_pool_get_bo(zdev, size);
+	if (bo)
+		return bo;
+
 	/* Allocate from CMA buffer */
 	cma_obj = drm_gem_cma_create(dev, size);
 	if (IS_ERR(cma_obj))
@@ -500,7 +514,7 @@ zocl_create_bo_ioctl(struct drm_device *dev, void *data, struct drm_file *filp)
 		ret = drm_gem_handle_create(filp, &bo->cma_base.base,
 		    &args->handle);
 		if (ret) {
-			drm_gem_cma_free_object(&bo->cma_base.base);
+			zocl_free_cma_bo(&bo->cma_base.base);
 			DRM_DEBUG("handle creation failed\n");
 			return ret;
 		}
@@ -662,11 +676,9 @@ out:
 	return ret;
 }
 
-int zocl_sync_bo_ioctl(struct drm_device *dev,
-		void *data,
-		struct drm_file *filp)
+static int zocl_sync_bo(struct drm_device *dev, struct drm_file *filp,
+		const struct drm_zocl_sync_bo *args)
 {
-	const struct drm_zocl_sync_bo	*args = data;
 	struct drm_gem_object		*gem_obj;
 	struct drm_gem_cma_object	*cma_obj;
 	struct drm_zocl_bo		*bo;
@@ -720,6 +732,47 @@ out:
 	return rc;
 }
 
+int zocl_sync_bo_ioctl(struct drm_device *dev,
+		void *data,
+		struct drm_file *filp)
+{
+	return zocl_sync_bo(dev, filp, data);
+}
+
+int zocl_sync_bo_vec_ioctl(struct drm_device *dev,
+		void *data,
+		struct drm_file *filp)
+{
+	const struct drm_zocl_sync_bo_vec *args = data;
+	struct drm_zocl_sync_bo *syncs;
+	u32 i;
+	int rc = 0;
+
+	if (!args->count || args->count > DRM_ZOCL_SYNC_BO_VEC_MAX ||
+	    args->reserved)
+		return -EINVAL;
+
+	syncs = kmalloc_array(args->count, sizeof(*syncs), GFP_KERNEL);
+	if (!syncs)
+		return -ENOMEM;
+
+	if (copy_from_user(syncs, (void __user *)(uintptr_t)args->syncs,
+	    args->count * sizeof(*syncs))) {
+		rc = -EFAULT;
+		goto out;
+	}
+
+	for (i = 0; i < args->count; i++) {
+		rc = zocl_sync_bo(dev, filp, &syncs[i]);
+		if (rc)
+			break;
+	}
+
+out:
+	kfree(syncs);
+	return rc;
+}
+
 bool
 zocl_can_dma_performed(struct drm_device *dev, struct drm_file *filp,
 	struct drm_zocl_copy_bo *args, uint64_t *dst_paddr, uint64_t *src_paddr)
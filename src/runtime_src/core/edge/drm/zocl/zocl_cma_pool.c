@@ -0,0 +1,286 @@
+/* SPDX-License-Identifier: GPL-2.0 OR Apache-2.0 */
+/*
+ * A GEM style (optionally CMA backed) device manager for ZynQ based
+ * OpenCL accelerators.
+ *
+ * Copyright (C) 2022 Xilinx, Inc. All rights reserved.
+ *
+ * This file is dual-licensed; you may select either the GNU General Public
+ * License version 2 or Apache License, Version 2.0.
+ */
+
+/*
+ * Pool of pre-allocated CMA buffers for BO creation.
+ *
+ * Allocating a large buffer from CMA may have to migrate pages out of
+ * the CMA region first, which makes the latency of BO creation hard to
+ * predict.  The pool reserves cma_pool_count[i] buffers of
+ * cma_pool_size_kb[i] KB each when an xclbin is loaded.  A CMA BO whose
+ * size falls in a class (larger than half of the class size and not
+ * larger than the class size) takes a buffer from the pool, and gives
+ * it back when the BO is freed.  The buffer is cleared on return so
+ * that no data leaks from one BO to the next.  The pool is disabled
+ * unless both parameters are set.
+ */
+
+#include <linux/dma-mapping.h>
+#include "zocl_drv.h"
+
+static unsigned int cma_pool_size_kb[ZOCL_CMA_POOL_MAX_CLASSES];
+static int cma_pool_size_num;
+module_param_array(cma_pool_size_kb, uint, &cma_pool_size_num, 0444);
+MODULE_PARM_DESC(cma_pool_size_kb,
+	"Size in KB of each size class of the CMA BO pool");
+
+static unsigned int cma_pool_count[ZOCL_CMA_POOL_MAX_CLASSES];
+static int cma_pool_count_num;
+module_param_array(cma_pool_count, uint, &cma_pool_count_num, 0444);
+MODULE_PARM_DESC(cma_pool_count,
+	"Number of CMA buffers reserved for each size class of the CMA BO pool");
+
+struct zocl_cma_chunk {
+	struct list_head		link;
+	struct zocl_cma_pool_class	*class;
+	void				*vaddr;
+	dma_addr_t			paddr;
+};
+
+static void
+zocl_cma_chunk_free(struct device *dev, struct zocl_cma_chunk *chunk)
+{
+	dma_free_wc(dev, chunk->class->size, chunk->vaddr, chunk->paddr);
+	kfree(chunk);
+}
+
+static struct zocl_cma_pool_class *
+zocl_cma_pool_find_class(struct zocl_cma_pool *pool, size_t size)
+{
+	struct zocl_cma_pool_class *best = NULL;
+	int i;
+
+	for (i = 0; i < pool->num_classes; i++) {
+		struct zocl_cma_pool_class *class = &pool->classes[i];
+
+		if (size > class->size || size <= class->size / 2)
+			continue;
+		if (!best || class->size < best->size)
+			best = class;
+	}
+
+	return best;
+}
+
+void zocl_cma_pool_init(struct drm_zocl_dev *zdev)
+{
+	struct zocl_cma_pool *pool = &zdev->cma_pool;
+	int num = min(cma_pool_size_num, cma_pool_count_num);
+	int i;
+
+	spin_lock_init(&pool->lock);
+	pool->num_classes = 0;
+	for (i = 0; i < num; i++) {
+		struct zocl_cma_pool_class *class;
+
+		if (!cma_pool_size_kb[i] || !cma_pool_count[i])
+			continue;
+
+		class = &pool->classes[pool->num_classes++];
+		class->size = PAGE_ALIGN((size_t)cma_pool_size_kb[i] * 1024);
+		class->count = cma_pool_count[i];
+		class->free = 0;
+		class->hits = 0;
+		class->misses = 0;
+		INIT_LIST_HEAD(&class->chunks);
+	}
+	pool->enabled = pool->num_classes > 0;
+}
+
+/*
+ * Reserve the CMA buffers of each size class that are not yet in the
+ * pool or used by a BO. Called after an xclbin is loaded, when the
+ * application is about to allocate its buffers.
+ */
+void zocl_cma_pool_fill(struct drm_zocl_dev *zdev)
+{
+	struct zocl_cma_pool *pool = &zdev->cma_pool;
+	struct device *dev = zdev->ddev->dev;
+	int i;
+
+	for (i = 0; i < pool->num_classes; i++) {
+		struct zocl_cma_pool_class *class = &pool->classes[i];
+		unsigned int want;
+
+		spin_lock(&pool->lock);
+		want = class->count > class->free ?
+			class->count - class->free : 0;
+		spin_unlock(&pool->lock);
+
+		while (want--) {
+			struct zocl_cma_chunk *chunk;
+
+			chunk = kzalloc(sizeof(*chunk), GFP_KERNEL);
+			if (!chunk)
+				return;
+
+			chunk->class = class;
+			chunk->vaddr = dma_alloc_wc(dev, class->size,
+			    &chunk->paddr, GFP_KERNEL | __GFP_NOWARN);
+			if (!chunk->vaddr) {
+				DRM_WARN("CMA pool: failed to reserve %zu bytes\n",
+				    class->size);
+				kfree(chunk);
+				break;
+			}
+
+			spin_lock(&pool->lock);
+			list_add_tail(&chunk->link, &class->chunks);
+			class->free++;
+			spin_unlock(&pool->lock);
+		}
+	}
+}
+
+/* All BOs are freed, release the reserved CMA buffers */
+void zocl_cma_pool_fini(struct drm_zocl_dev *zdev)
+{
+	struct zocl_cma_pool *pool = &zdev->cma_pool;
+	struct device *dev = zdev->ddev->dev;
+	struct zocl_cma_chunk *chunk, *tmp;
+	LIST_HEAD(chunks);
+	int i;
+
+	spin_lock(&pool->lock);
+	pool->enabled = false;
+	for (i = 0; i < pool->num_classes; i++) {
+		list_splice_init(&pool->classes[i].chunks, &chunks);
+		pool->classes[i].free = 0;
+	}
+	spin_unlock(&pool->lock);
+
+	list_for_each_entry_safe(chunk, tmp, &chunks, link) {
+		list_del(&chunk->link);
+		zocl_cma_chunk_free(dev, chunk);
+	}
+}
+
+/*
+ * Create a CMA BO on a buffer from the pool. Returns NULL if the size
+ * is not in any size class or the pool of its class is empty, in which
+ * case the caller allocates from CMA.
+ */
+struct drm_zocl_bo *
+zocl_cma_pool_get_bo(struct drm_zocl_dev *zdev, size_t size)
+{
+	struct zocl_cma_pool *pool = &zdev->cma_pool;
+	struct zocl_cma_pool_class *class;
+	struct zocl_cma_chunk *chunk = NULL;
+	struct drm_zocl_bo *bo;
+	int err;
+
+	if (!pool->enabled)
+		return NULL;
+
+	class = zocl_cma_pool_find_class(pool, size);
+	if (!class)
+		return NULL;
+
+	spin_lock(&pool->lock);
+	if (!list_empty(&class->chunks)) {
+		chunk = list_first_entry(&class->chunks,
+		    struct zocl_cma_chunk, link);
+		list_del(&chunk->link);
+		class->free--;
+		class->hits++;
+	} else {
+		class->misses++;
+	}
+	spin_unlock(&pool->lock);
+
+	if (!chunk)
+		return NULL;
+
+	bo = kzalloc(sizeof(*bo), GFP_KERNEL);
+	if (!bo)
+		goto out;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 11, 0)
+	bo->cma_base.base.funcs = &zocl_gem_object_funcs;
+#endif
+	err = drm_gem_object_init(zdev->ddev, &bo->cma_base.base, size);
+	if (err)
+		goto free_bo;
+
+	err = drm_gem_create_mmap_offset(&bo->cma_base.base);
+	if (err) {
+		drm_gem_object_release(&bo->cma_base.base);
+		goto free_bo;
+	}
+
+	bo->cma_base.vaddr = chunk->vaddr;
+	bo->cma_base.paddr = chunk->paddr;
+	bo->cma_chunk = chunk;
+
+	return bo;
+
+free_bo:
+	kfree(bo);
+out:
+	spin_lock(&pool->lock);
+	list_add(&chunk->link, &class->chunks);
+	class->free++;
+	spin_unlock(&pool->lock);
+	return NULL;
+}
+
+/*
+ * Free a CMA BO created on a pool buffer and give the buffer back to
+ * the pool. Returns false if the BO does not use a pool buffer.
+ */
+bool zocl_cma_pool_put_bo(struct drm_zocl_dev *zdev, struct drm_zocl_bo *bo)
+{
+	struct zocl_cma_pool *pool = &zdev->cma_pool;
+	struct zocl_cma_chunk *chunk = bo->cma_chunk;
+	struct zocl_cma_pool_class *class;
+
+	if (!chunk)
+		return false;
+
+	class = chunk->class;
+	drm_gem_object_release(&bo->cma_base.base);
+	kfree(bo);
+
+	/* Clear here, so that a BO created from the pool is ready at once */
+	memset(chunk->vaddr, 0, class->size);
+
+	spin_lock(&pool->lock);
+	if (pool->enabled && class->free < class->count) {
+		list_add(&chunk->link, &class->chunks);
+		class->free++;
+		chunk = NULL;
+	}
+	spin_unlock(&pool->lock);
+
+	if (chunk)
+		zocl_cma_chunk_free(zdev->ddev->dev, chunk);
+
+	return true;
+}
+
+ssize_t zocl_cma_pool_show(struct drm_zocl_dev *zdev, char *buf)
+{
+	struct zocl_cma_pool *pool = &zdev->cma_pool;
+	ssize_t size = 0;
+	int i;
+
+	spin_lock(&pool->lock);
+	for (i = 0; i < pool->num_classes; i++) {
+		struct zocl_cma_pool_class *class = &pool->classes[i];
+
+		size += sprintf(buf + size, "%zu %u %u %llu %llu\n",
+		    class->size, class->count, class->free,
+		    class->hits, class->misses);
+	}
+	spin_unlock(&pool->lock);
+
+	return size;
+}
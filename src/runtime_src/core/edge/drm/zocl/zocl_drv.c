@@ -486,7 +486,7 @@ void zocl_free_bo(struct drm_gem_object *obj)
 			zocl_free_host_bo(obj);
 		else if (zocl_obj->flags & ZOCL_BO_FLAGS_CMA) {
 			/* free resources associated with a CMA GEM object */
-			drm_gem_cma_free_object(obj);
+			zocl_free_cma_bo(obj);
 
 			/* Update memory usage statistics */
 			zocl_update_mem_stat(zdev, obj->size, -1,
@@ -861,6 +861,10 @@ static const struct drm_ioctl_desc zocl_ioctls[] = {
 			DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
 	DRM_IOCTL_DEF_DRV(ZOCL_AIE_PUTCMD, zocl_aie_putcmd_ioctl,
 			DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
+	DRM_IOCTL_DEF_DRV(ZOCL_SYNC_BO_VEC, zocl_sync_bo_vec_ioctl,
+			DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
+	DRM_IOCTL_DEF_DRV(ZOCL_CTX_VEC, zocl_ctx_vec_ioctl,
+			DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
 };
 
 static const struct file_operations zocl_driver_fops = {
@@ -993,6 +997,7 @@ static int zocl_drm_platform_probe(struct platform_device *pdev)
 	}
 	mutex_init(&zdev->mm_lock);
 	INIT_LIST_HEAD(&zdev->zm_list_head);
+	zocl_cma_pool_init(zdev);
 
 	subdev = zocl_find_pdev("ert_hw");
 	if (subdev) {
@@ -1149,6 +1154,7 @@ static int zocl_drm_platform_remove(struct platform_device *pdev)
 		fpga_mgr_put(zdev->fpga_mgr);
 
 	zocl_clear_mem(zdev);
+	zocl_cma_pool_fini(zdev);
 	mutex_destroy(&zdev->mm_lock);
 	zocl_pr_slot_fini(zdev);
 	zocl_destroy_aie(zdev);
@@ -56,6 +56,15 @@ zocl_ctx_ioctl(struct drm_device *ddev, void *data, struct drm_file *filp)
 	return zocl_context_ioctl(zdev, data, filp);
 }
 
+/* Open/close contexts on many CUs, see zocl_ctx_ioctl() */
+int
+zocl_ctx_vec_ioctl(struct drm_device *ddev, void *data, struct drm_file *filp)
+{
+	struct drm_zocl_dev *zdev = ZOCL_GET_ZDEV(ddev);
+
+	return zocl_context_vec_ioctl(zdev, data, filp);
+}
+
 /* IOCTL to get CU index in aperture list
  * used for recognizing BO and CU in mmap
  */
@@ -494,19 +494,91 @@ int zocl_context_ioctl(struct drm_zocl_dev *zdev, void *data,
 	return ret;
 }
 
+/*
+ * Open or close contexts on many CUs in one call. An open either succeeds
+ * for all CUs or for none of them.
+ *
+ * @param	zdev:   zocl device structure
+ * @param       data:	userspace arguments
+ * @param       flip:	DRM file private data
+ *
+ * @return      0 on success, error core on failure.
+ *
+ */
+int zocl_context_vec_ioctl(struct drm_zocl_dev *zdev, void *data,
+			   struct drm_file *filp)
+{
+	struct drm_zocl_ctx_vec *args = data;
+	struct kds_client *client = filp->driver_priv;
+	struct drm_zocl_ctx ctx = { 0 };
+	u32 *cu_indices = NULL;
+	u32 i = 0;
+	int ret = 0;
+
+	args->done = 0;
+	if (!args->count || args->count > DRM_ZOCL_CTX_VEC_MAX)
+		return -EINVAL;
+
+	if (args->op != ZOCL_CTX_OP_ALLOC_CTX && args->op != ZOCL_CTX_OP_FREE_CTX)
+		return -EINVAL;
+
+	cu_indices = kmalloc_array(args->count, sizeof(*cu_indices), GFP_KERNEL);
+	if (!cu_indices)
+		return -ENOMEM;
+
+	if (copy_from_user(cu_indices, (void __user *)(uintptr_t)args->cu_indices,
+			   args->count * sizeof(*cu_indices))) {
+		ret = -EFAULT;
+		goto out;
+	}
+
+	ctx.uuid_ptr = args->uuid_ptr;
+	ctx.uuid_size = args->uuid_size;
+	ctx.flags = args->flags;
+	ctx.op = args->op;
+	for (i = 0; i < args->count; i++) {
+		ctx.cu_index = cu_indices[i];
+		if (args->op == ZOCL_CTX_OP_ALLOC_CTX)
+			ret = zocl_add_context(zdev, client, &ctx);
+		else
+			ret = zocl_del_context(zdev, client, &ctx);
+		if (ret)
+			break;
+	}
+
+	if (ret && args->op == ZOCL_CTX_OP_ALLOC_CTX) {
+		while (i--) {
+			ctx.cu_index = cu_indices[i];
+			(void) zocl_del_context(zdev, client, &ctx);
+		}
+		i = 0;
+	}
+	args->done = i;
+
+out:
+	kfree(cu_indices);
+	return ret;
+}
+
 static void notify_execbuf(struct kds_command *xcmd, int status)
 {
 	struct kds_client *client = xcmd->client;
 	struct ert_packet *ecmd = (struct ert_packet *)xcmd->execbuf;
+	u32 state = ecmd->state;
 
 	if (status == KDS_COMPLETED)
-		ecmd->state = ERT_CMD_STATE_COMPLETED;
+		state = ERT_CMD_STATE_COMPLETED;
 	else if (status == KDS_ERROR)
-		ecmd->state = ERT_CMD_STATE_ERROR;
+		state = ERT_CMD_STATE_ERROR;
 	else if (status == KDS_TIMEOUT)
-		ecmd->state = ERT_CMD_STATE_TIMEOUT;
+		state = ERT_CMD_STATE_TIMEOUT;
 	else if (status == KDS_ABORT)
-		ecmd->state = ERT_CMD_STATE_ABORT;
+		state = ERT_CMD_STATE_ABORT;
+	else if (status == KDS_EXPIRED)
+		state = ERT_CMD_STATE_EXPIRED;
+
+	if (status == KDS_EXPIRED)
+		client_stat_inc(client, expired);
 
 	if (xcmd->timestamp_enabled) {
 		/* Only start kernel command supports timestamps */
@@ -518,16 +590,19 @@ static void notify_execbuf(struct kds_command *xcmd, int status)
 		ts->skc_timestamps[ERT_CMD_STATE_NEW] = xcmd->timestamp[KDS_NEW];
 		ts->skc_timestamps[ERT_CMD_STATE_QUEUED] = xcmd->timestamp[KDS_QUEUED];
 		ts->skc_timestamps[ERT_CMD_STATE_RUNNING] = xcmd->timestamp[KDS_RUNNING];
-		ts->skc_timestamps[ecmd->state] = xcmd->timestamp[status];
+		ts->skc_timestamps[state] = xcmd->timestamp[status];
 	}
 
+	/* Timestamps must be visible before host polling sees completion */
+	wmb();
+	ecmd->state = state;
+
 	ZOCL_DRM_GEM_OBJECT_PUT_UNLOCKED(xcmd->gem_obj);
 
 	if (xcmd->cu_idx >= 0)
 		client_stat_inc(client, c_cnt[xcmd->cu_idx]);
 
-	atomic_inc(&client->event);
-	wake_up_interruptible(&client->waitq);
+	kds_client_signal(client);
 }
 
 /* This function returns the corresponding context associated to the given CU
@@ -649,6 +724,7 @@ int zocl_command_ioctl(struct drm_zocl_dev *zdev, void *data,
 	struct drm_zocl_bo *zocl_bo = NULL;
 	struct ert_packet *ecmd = NULL;
 	struct kds_command *xcmd = NULL;
+	u32 offset = args->exec_bo_offset;
 	int ret = 0;
 
 	if (zdev->kds.bad_state) {
@@ -668,7 +744,23 @@ int zocl_command_ioctl(struct drm_zocl_dev *zdev, void *data,
 		return -EINVAL;
 	}
 
-	ecmd = (struct ert_packet *)zocl_bo->cma_base.vaddr;
+	/* A slab exec buf carries many commands, each command starts at
+	 * an 8 bytes aligned offset and must fit in the BO.
+	 */
+	if (!IS_ALIGNED(offset, sizeof(u64)) ||
+	    offset > gem_obj->size - sizeof(struct ert_packet)) {
+		DRM_ERROR("Invalid exec buf offset 0x%x\n", offset);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ecmd = (struct ert_packet *)((char *)zocl_bo->cma_base.vaddr + offset);
+	if (offset + sizeof(ecmd->header) + ecmd->count * sizeof(u32) >
+	    gem_obj->size) {
+		DRM_ERROR("Command payload bigger than exec buf\n");
+		ret = -EINVAL;
+		goto out;
+	}
 
 	ecmd->state = ERT_CMD_STATE_NEW;
 	/* only the user command knows the real size of the payload.
@@ -684,6 +776,8 @@ int zocl_command_ioctl(struct drm_zocl_dev *zdev, void *data,
 	xcmd->cb.notify_host = notify_execbuf;
 	xcmd->execbuf = (u32 *)ecmd;
 	xcmd->gem_obj = gem_obj;
+	xcmd->exec_bo_handle = args->exec_bo_handle;
+	xcmd->exec_bo_offset = offset;
 
 	//print_ecmd_info(ecmd);
 
@@ -152,6 +152,102 @@ kds_interval_show(struct device *dev, struct device_attribute *attr, char *buf)
 }
 static DEVICE_ATTR(kds_interval, 0644, kds_interval_show, kds_interval_store);
 
+static ssize_t
+kds_polling_adaptive_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+	u32 adaptive;
+
+	if (kstrtou32(buf, 10, &adaptive) == -EINVAL)
+		return -EINVAL;
+
+	zdev->kds.polling_adaptive = !!adaptive;
+
+	return count;
+}
+
+static ssize_t
+kds_polling_adaptive_show(struct device *dev, struct device_attribute *attr,
+	       char *buf)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%d\n", zdev->kds.polling_adaptive);
+}
+static DEVICE_ATTR(kds_polling_adaptive, 0644, kds_polling_adaptive_show,
+		   kds_polling_adaptive_store);
+
+static ssize_t
+kds_fair_share_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+	u32 fair_share;
+
+	if (kstrtou32(buf, 10, &fair_share) == -EINVAL)
+		return -EINVAL;
+
+	WRITE_ONCE(zdev->kds.cu_mgmt.sched.fair_share, !!fair_share);
+
+	return count;
+}
+
+static ssize_t
+kds_fair_share_show(struct device *dev, struct device_attribute *attr,
+	       char *buf)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%d\n", zdev->kds.cu_mgmt.sched.fair_share);
+}
+static DEVICE_ATTR(kds_fair_share, 0644, kds_fair_share_show,
+		   kds_fair_share_store);
+
+static ssize_t
+kds_client_depth_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+	u32 depth;
+
+	if (kstrtou32(buf, 10, &depth) == -EINVAL)
+		return -EINVAL;
+
+	WRITE_ONCE(zdev->kds.cu_mgmt.sched.client_depth, depth);
+
+	return count;
+}
+
+static ssize_t
+kds_client_depth_show(struct device *dev, struct device_attribute *attr,
+	       char *buf)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%u\n", zdev->kds.cu_mgmt.sched.client_depth);
+}
+static DEVICE_ATTR(kds_client_depth, 0644, kds_client_depth_show,
+		   kds_client_depth_store);
+
+static ssize_t
+kds_cu_policy_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return store_kds_cu_policy(&zdev->kds, buf, count);
+}
+
+static ssize_t
+kds_cu_policy_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	return show_kds_cu_policy(&zdev->kds, buf);
+}
+static DEVICE_ATTR(kds_cu_policy, 0644, kds_cu_policy_show, kds_cu_policy_store);
+
 static ssize_t kds_xrt_version_show(struct device *dev,
 		struct device_attribute *attr, char *buf)
 {
@@ -250,14 +346,25 @@ static ssize_t graph_status_show(struct device *dev,
 
 	/* init semaphore */
 	sema_init(&acmd->aiec_sem, 0);
+	INIT_LIST_HEAD(&acmd->aiec_list);
 
-	/* caller release the wait aied thread and wait for result */
+	/*
+	 * Caller release the wait aied thread and wait for result.  If
+	 * aied is processing another request, this request is queued and
+	 * answered along with it.
+	 */
 	mutex_lock(&aie->aie_lock);
-	if (waitqueue_active(&aie->aie_wait_queue)) {
+	if (waitqueue_active(&aie->aie_wait_queue) || aie->cmd_inprogress) {
 		list_add_tail(&acmd->aiec_list, &aie->aie_cmd_list);
 		mutex_unlock(&aie->aie_lock);
 		wake_up_interruptible(&aie->aie_wait_queue);
 		if (down_interruptible(&acmd->aiec_sem)) {
+			/* Make sure aied no longer references the request */
+			mutex_lock(&aie->aie_lock);
+			list_del_init(&acmd->aiec_list);
+			if (aie->cmd_inprogress == acmd)
+				aie->cmd_inprogress = NULL;
+			mutex_unlock(&aie->aie_lock);
 			nread = -ERESTARTSYS;
 			goto clean;
 		}
@@ -333,6 +440,18 @@ static ssize_t memstat_raw_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(memstat_raw);
 
+static ssize_t cma_pool_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct drm_zocl_dev *zdev = dev_get_drvdata(dev);
+
+	if (!zdev)
+		return 0;
+
+	return zocl_cma_pool_show(zdev, buf);
+}
+static DEVICE_ATTR_RO(cma_pool);
+
 static ssize_t errors_show(struct device *dev,
 		struct device_attribute *attr, char *buf)
 {
@@ -374,8 +493,13 @@ static struct attribute *zocl_attrs[] = {
 	&dev_attr_kds_stat.attr,
 	&dev_attr_kds_custat_raw.attr,
 	&dev_attr_kds_interval.attr,
+	&dev_attr_kds_polling_adaptive.attr,
+	&dev_attr_kds_fair_share.attr,
+	&dev_attr_kds_client_depth.attr,
+	&dev_attr_kds_cu_policy.attr,
 	&dev_attr_memstat.attr,
 	&dev_attr_memstat_raw.attr,
+	&dev_attr_cma_pool.attr,
 	&dev_attr_errors.attr,
 	&dev_attr_graph_status.attr,
 	NULL,
@@ -1325,6 +1325,9 @@ zocl_xclbin_read_axlf(struct drm_zocl_dev *zdev, struct drm_zocl_axlf *axlf_obj,
 		goto out0;
 	}
 
+	/* Reserve CMA buffers for the BOs the application will create */
+	zocl_cma_pool_fill(zdev);
+
 	write_lock(&zdev->attr_rwlock);
 
 out0:
@@ -120,6 +120,10 @@ enum drm_zocl_ops {
 	DRM_ZOCL_AIE_GETCMD,
 	/* Put the aie info command */
 	DRM_ZOCL_AIE_PUTCMD,
+	/* Sync many buffer ranges in one call */
+	DRM_ZOCL_SYNC_BO_VEC,
+	/* Open/Close contexts on many CUs in one call */
+	DRM_ZOCL_CTX_VEC,
 	DRM_ZOCL_NUM_IOCTLS
 };
 
@@ -195,6 +199,24 @@ struct drm_zocl_sync_bo {
 	uint64_t size;
 };
 
+#define DRM_ZOCL_SYNC_BO_VEC_MAX	256
+
+/**
+ * struct drm_zocl_sync_bo_vec - Synchronize many buffer ranges
+ * used with DRM_ZOCL_SYNC_BO_VEC ioctl.
+ *
+ * @count:	Number of ranges, at most DRM_ZOCL_SYNC_BO_VEC_MAX
+ * @reserved:	Must be 0
+ * @syncs:	User pointer to an array of struct drm_zocl_sync_bo
+ *
+ * Ranges are synced in order, the ioctl stops at the first failing range.
+ */
+struct drm_zocl_sync_bo_vec {
+	uint32_t count;
+	uint32_t reserved;
+	uint64_t syncs;
+};
+
 /**
  * struct drm_zocl_info_bo - Obtain information about buffer object
  * used with DRM_IOCTL_ZOCL_INFO_BO ioctl
@@ -305,6 +327,33 @@ struct drm_zocl_ctx {
 	enum drm_zocl_ctx_code op;
 };
 
+#define DRM_ZOCL_CTX_VEC_MAX	129
+
+/**
+ * struct drm_zocl_ctx_vec - Open or close contexts on many CUs
+ * used with DRM_ZOCL_CTX_VEC ioctl.
+ *
+ * @uuid_ptr:	User pointer to the xclbin UUID
+ * @uuid_size:	Size of the UUID
+ * @cu_indices:	User pointer to an array of count uint32_t CU indices,
+ *		ZOCL_CTX_VIRT_CU_INDEX is allowed
+ * @count:	Number of CUs, at most DRM_ZOCL_CTX_VEC_MAX
+ * @flags:	Shared or exclusive context, applies to all CUs
+ * @done:	Returns the number of leading contexts that are opened or
+ *		closed.  An open that fails closes the contexts it opened,
+ *		so done is 0 when ZOCL_CTX_OP_ALLOC_CTX fails.
+ * @op:		ZOCL_CTX_OP_ALLOC_CTX or ZOCL_CTX_OP_FREE_CTX
+ */
+struct drm_zocl_ctx_vec {
+	uint64_t uuid_ptr;
+	uint64_t uuid_size;
+	uint64_t cu_indices;
+	uint32_t count;
+	uint32_t flags;
+	uint32_t done;
+	enum drm_zocl_ctx_code op;
+};
+
 struct drm_zocl_aie_fd {
 	uint32_t partition_id;
 	uint32_t uid;
@@ -343,10 +392,16 @@ enum drm_zocl_execbuf_state {
  *
  * @ctx_id:         Pass 0
  * @exec_bo_handle: BO handle of command buffer formatted as ERT command
+ * @exec_bo_offset: Byte offset of the ERT command within the exec BO. Non zero
+ *                  only when many commands are carved out of one exec BO. Must
+ *                  be 8 bytes aligned.
+ * @reserved:       Pass 0
  */
 struct drm_zocl_execbuf {
   uint32_t ctx_id;
   uint32_t exec_bo_handle;
+  uint32_t exec_bo_offset;
+  uint32_t reserved;
 };
 
 /*
@@ -548,4 +603,8 @@ struct drm_zocl_error_inject {
                                        DRM_ZOCL_AIE_GETCMD, struct drm_zocl_aie_cmd)
 #define DRM_IOCTL_ZOCL_AIE_PUTCMD      DRM_IOWR(DRM_COMMAND_BASE + \
                                        DRM_ZOCL_AIE_PUTCMD, struct drm_zocl_aie_cmd)
+#define DRM_IOCTL_ZOCL_SYNC_BO_VEC     DRM_IOWR(DRM_COMMAND_BASE + \
+                                       DRM_ZOCL_SYNC_BO_VEC, struct drm_zocl_sync_bo_vec)
+#define DRM_IOCTL_ZOCL_CTX_VEC         DRM_IOWR(DRM_COMMAND_BASE + \
+                                       DRM_ZOCL_CTX_VEC, struct drm_zocl_ctx_vec)
 #endif
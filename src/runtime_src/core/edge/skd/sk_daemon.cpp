@@ -23,6 +23,7 @@
 #include <sys/wait.h>
 #include <sys/mman.h>
 #include <sys/prctl.h>
+#include <map>
 
 #include "sk_types.h"
 #include "sk_daemon.h"
@@ -137,6 +138,88 @@ xclDeviceHandle initXRTHandle(unsigned deviceIndex)
   return xclOpen(deviceIndex, NULL, XCL_QUIET);
 }
 
+/*
+ * Cache of global argument buffer mappings keyed by physical address.
+ * Hosts usually pass the same buffers to every invocation of a soft
+ * kernel, so the host BO and its mapping are kept across commands
+ * instead of being created and released per command. The least
+ * recently used mapping is released when the cache is full.
+ */
+#define BO_MAP_CACHE_SIZE	(64)
+class boMapCache {
+public:
+  ~boMapCache()
+  {
+    clear();
+  }
+
+  /* Return process address of buffer at paddr, or NULL on error. */
+  void *get(uint64_t paddr, uint64_t size)
+  {
+    auto it = entries.find(paddr);
+    if (it != entries.end()) {
+      if (it->second.size >= size) {
+        it->second.lastUse = ++tick;
+        return it->second.addr;
+      }
+      release(it->second);
+      entries.erase(it);
+    }
+
+    if (entries.size() >= BO_MAP_CACHE_SIZE)
+      evict();
+
+    mapping m;
+    m.size = size;
+    m.boh = xclGetHostBO(devHdl, paddr, size);
+    if (m.boh == 0xFFFFFFFF)
+      return NULL;
+    m.addr = xclMapBO(devHdl, m.boh, true);
+    if (m.addr == NULL || m.addr == MAP_FAILED) {
+      xclFreeBO(devHdl, m.boh);
+      return NULL;
+    }
+    m.lastUse = ++tick;
+    entries.emplace(paddr, m);
+    return m.addr;
+  }
+
+  void clear()
+  {
+    for (auto& e : entries)
+      release(e.second);
+    entries.clear();
+  }
+
+private:
+  struct mapping {
+    unsigned int boh;
+    void *addr;
+    uint64_t size;
+    uint64_t lastUse;
+  };
+
+  void release(mapping& m)
+  {
+    munmap(m.addr, m.size);
+    xclFreeBO(devHdl, m.boh);
+  }
+
+  void evict()
+  {
+    auto lru = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->second.lastUse < lru->second.lastUse)
+        lru = it;
+    }
+    release(lru->second);
+    entries.erase(lru);
+  }
+
+  std::map<uint64_t, mapping> entries;
+  uint64_t tick = 0;
+};
+
 /*
  * This is the main loop for a soft kernel CU.
  * name   : soft kernel function name to run it.
@@ -153,7 +236,7 @@ static void softKernelLoop(char *name, char *path, uint32_t cu_idx)
   int32_t kernel_return = 0;
   unsigned int boh;
   int ret;
-  
+  static const bool debug = xrt_core::config::get_verbosity() >= XRT_DEBUG;
 
   devHdl = initXRTHandle(0);
   if (!devHdl) {
@@ -220,10 +303,8 @@ static void softKernelLoop(char *name, char *path, uint32_t cu_idx)
   void* ffi_arg_values[args.size()];
   
   // Buffer Objects
-  unsigned int boHandles[args.size()];
   void* bos[args.size()];
-  uint64_t boSize[args.size()];
-  std::vector<int> bo_list;
+  boMapCache boCache;
   
   for(int i=0;i<args.size();i++) {
     ffi_args[i] = &args[i].ffitype;
@@ -243,7 +324,8 @@ static void softKernelLoop(char *name, char *path, uint32_t cu_idx)
       break;
     }
 
-    syslog(LOG_INFO, "Got new kernel command!\n");
+    if (debug)
+      syslog(LOG_DEBUG, "Got new kernel command!\n");
     
     /* Reg file indicates the kernel should not be running. */
     if (!(args_from_host[0] & 0x1))
@@ -251,22 +333,25 @@ static void softKernelLoop(char *name, char *path, uint32_t cu_idx)
 
     // New PS Kernel implementation
     // Check for call signature of only 2 arguments and 2nd argument has name of ops
+    bool mapped = true;
     if((args.size()==2 && args[1].name.compare("ops")==0) || args.empty()) {
     } else {
       // FFI PS Kernel implementation
-      // Map buffers used by kernel
+      // Map buffers used by kernel, mappings are cached across commands
       for(int i=0;i<args.size();i++) {
 	if(args[i].type == xrt_core::pskernel::kernel_argument::argtype::global) {
 	  uint64_t *buf_addr_ptr = (uint64_t*)(&args_from_host[args[i].offset/4]);
 	  uint64_t buf_addr = reinterpret_cast<uint64_t>(*buf_addr_ptr);
 	  uint64_t *buf_size_ptr = (uint64_t*)(&args_from_host[args[i].offset/4+2]);
 	  uint64_t buf_size = reinterpret_cast<uint64_t>(*buf_size_ptr);
-	  boSize[i] = buf_size;
 	  
-	  boHandles[i] = xclGetHostBO(devHdl,buf_addr,buf_size);
-	  bos[i] = xclMapBO(devHdl,boHandles[i],true);
+	  bos[i] = boCache.get(buf_addr,buf_size);
+	  if (!bos[i]) {
+	    syslog(LOG_ERR, "Cannot map argument %s of %s_%d\n", args[i].name.c_str(), name, cu_idx);
+	    mapped = false;
+	    break;
+	  }
 	  ffi_arg_values[i] = &bos[i];
-	  bo_list.emplace_back(i);
 	} else {
 	  ffi_arg_values[i] = &args_from_host[args[i].offset/4];
 	}
@@ -276,24 +361,17 @@ static void softKernelLoop(char *name, char *path, uint32_t cu_idx)
 
     // Original PS Kernel implementation
     // Check for call signature of only 2 arguments and 2nd argument has name os ops
-    if((args.size()==2 && args[1].name.compare("ops")==0) || args.empty()) {
+    if (!mapped) {
+      kernel_return = -EFAULT;
+    } else if((args.size()==2 && args[1].name.compare("ops")==0) || args.empty()) {
       kernel_return = old_kernel(&args_from_host[1],&ops);
     } else {
       ffi_call(&cif,FFI_FN(kernel), &kernel_return, ffi_arg_values);
     }
     args_from_host[1] = (uint32_t)kernel_return;
-
-    // Unmap Buffers
-    if((args.size()==2 && args[1].name.compare("ops")==0) || args.empty()) {
-      // Nothing to be done here for original PS kernel implementation
-    } else {
-      for(auto i:bo_list) {
-	munmap(bos[i],boSize[i]);
-	xclFreeBO(devHdl,boHandles[i]);
-      }
-    }
   }
 
+  boCache.clear();
   dlclose(sk_handle);
   (void) destroySoftKernel(boh, args_from_host);
   xclClose(devHdl);
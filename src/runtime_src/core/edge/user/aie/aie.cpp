@@ -17,6 +17,7 @@
  */
 
 #include "aie.h"
+#include "core/common/config_reader.h"
 #include "core/common/error.h"
 #include "common_layer/fal_util.h"
 #ifndef __AIESIM__
@@ -27,8 +28,11 @@
 #include <sys/mman.h>
 #endif
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 namespace zynqaie {
 
@@ -86,6 +90,7 @@ Aie::Aie(const std::shared_ptr<xrt_core::device>& device)
     for (auto config_itr = gmio_configs.begin(); config_itr != gmio_configs.end(); config_itr++)
     {
         auto p_gmio_api = std::make_shared<adf::gmio_api>(&config_itr->second);
+        p_gmio_api->setQueueDepth(xrt_core::config::get_gmio_queue_depth());
         p_gmio_api->configure();
         gmio_apis[config_itr->first] = p_gmio_api;
     }
@@ -152,6 +157,7 @@ sync_bo(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t s
   if (gmio_config_itr == gmio_configs.end())
     throw xrt_core::error(-EINVAL, "Can't sync BO: GMIO name not found");
 
+  std::lock_guard<std::mutex> lk(gmio_mutex);
   submit_sync_bo(bo, gmio_itr->second, gmio_config_itr->second, dir, size, offset);
   gmio_itr->second->wait();
 }
@@ -159,6 +165,13 @@ sync_bo(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t s
 void
 Aie::
 sync_bo_nb(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset)
+{
+  submit_bo(bo, gmioName, dir, size, offset);
+}
+
+uint64_t
+Aie::
+submit_bo(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset)
 {
   if (!devInst)
     throw xrt_core::error(-EINVAL, "Can't sync BO: AIE is not initialized");
@@ -174,7 +187,9 @@ sync_bo_nb(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_
   if (gmio_config_itr == gmio_configs.end())
     throw xrt_core::error(-EINVAL, "Can't sync BO: GMIO name not found");
   
+  std::lock_guard<std::mutex> lk(gmio_mutex);
   submit_sync_bo(bo, gmio_itr->second, gmio_config_itr->second, dir, size, offset);
+  return gmio_itr->second->getSubmittedCount();
 }
 
 void
@@ -191,9 +206,40 @@ wait_gmio(const std::string& gmioName)
   if (gmio_itr == gmio_apis.end())
     throw xrt_core::error(-EINVAL, "Can't sync BO: GMIO name not found");
     
+  std::lock_guard<std::mutex> lk(gmio_mutex);
   gmio_itr->second->wait();
 }
 
+void
+Aie::
+wait_gmio(const std::string& gmioName, uint64_t id)
+{
+  if (!devInst)
+    throw xrt_core::error(-EINVAL, "Can't wait GMIO: AIE is not initialized");
+
+  if (access_mode == xrt::aie::access_mode::shared)
+    throw xrt_core::error(-EPERM, "Shared AIE context can't wait gmio");
+
+  auto gmio_itr = gmio_apis.find(gmioName);
+  if (gmio_itr == gmio_apis.end())
+    throw xrt_core::error(-EINVAL, "Can't sync BO: GMIO name not found");
+
+  // There is no completion interrupt for shim DMA BDs, poll the
+  // pending BD count and back off while the transfer is in flight.
+  // The lock is dropped between polls so other transfers can be
+  // submitted to the channel meanwhile.
+  auto backoff = std::chrono::microseconds(10);
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lk(gmio_mutex);
+      if (gmio_itr->second->isTransferDone(id))
+        return;
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, std::chrono::microseconds(1000));
+  }
+}
+
 void
 Aie::
 submit_sync_bo(xrt::bo& bo, std::shared_ptr<adf::gmio_api>& gmio_api, adf::gmio_config& gmio_config, enum xclBOSyncDirection dir, size_t size, size_t offset)
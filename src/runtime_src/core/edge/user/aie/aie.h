@@ -20,6 +20,7 @@
 #define xrt_core_edge_user_aie_h
 
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <vector>
 
@@ -104,9 +105,19 @@ public:
     void
     sync_bo_nb(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset);
 
+    // Enqueue a GMIO transfer without waiting, returns the transfer
+    // id to be passed to wait_gmio()
+    uint64_t
+    submit_bo(xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset);
+
     void
     wait_gmio(const std::string& gmioName);
 
+    // Wait for a transfer returned by submit_bo(), other transfers
+    // on the GMIO channel may remain in flight
+    void
+    wait_gmio(const std::string& gmioName, uint64_t id);
+
     void
     reset(const xrt_core::device* device);
 
@@ -142,6 +153,10 @@ private:
 
     std::vector<EventRecord> eventRecords;
 
+    // Protects gmio_apis state shared by submitting threads and
+    // threads waiting for transfer completion
+    std::mutex gmio_mutex;
+
     void
     submit_sync_bo(xrt::bo& bo, std::shared_ptr<adf::gmio_api>& gmio, adf::gmio_config& gmio_config, enum xclBOSyncDirection dir, size_t size, size_t offset);
 
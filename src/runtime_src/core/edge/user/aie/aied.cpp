@@ -21,6 +21,7 @@
 #include <sstream>
 #include <iostream>
 #include <csignal>
+#include <ctime>
 #include "aied.h"
 #include "core/edge/include/zynq_ioctl.h"
 #include "core/edge/user/shim.h"
@@ -30,21 +31,45 @@
 
 namespace zynqaie {
 
+/* Dummy signal handler for SIGUSR1 */
+static void signalHandler(int signum) {}
+
 Aied::Aied(xrt_core::device* device): mCoreDevice(device)
 {
   done = false;
+
+  // Installed before the thread is created so that SIGUSR1 never
+  // takes the default action.  No SA_RESTART, the blocking ioctl
+  // must return when interrupted.
+  struct sigaction sa {};
+  sa.sa_handler = signalHandler;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGUSR1, &sa, NULL);
+
   pthread_create(&ptid, NULL, &Aied::pollAIE, this);
 }
 
 Aied::~Aied()
 {
-  done = true;
-  pthread_kill(ptid, SIGUSR1);
-  pthread_join(ptid, NULL);
-}
+  {
+    std::lock_guard<std::mutex> lk(mDoneMutex);
+    done = true;
+  }
+  mDoneCond.notify_all();
 
-/* Dummy signal handler for SIGTERM */
-static void signalHandler(int signum) {}
+  // The signal interrupts the blocking ioctl, resend in case it was
+  // delivered before the thread entered the ioctl
+  struct timespec ts;
+  do {
+    pthread_kill(ptid, SIGUSR1);
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 100 * 1000 * 1000;
+    if (ts.tv_nsec >= 1000 * 1000 * 1000) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000 * 1000 * 1000;
+    }
+  } while (pthread_timedjoin_np(ptid, NULL, &ts) == ETIMEDOUT);
+}
 
 void* 
 Aied::pollAIE(void* arg)
@@ -53,18 +78,24 @@ Aied::pollAIE(void* arg)
   ZYNQ::shim *drv = ZYNQ::shim::handleCheck(ai->mCoreDevice->get_device_handle());
   xclAIECmd cmd;
 
-  signal(SIGUSR1, signalHandler);
-
   if (!xrt_core::config::get_enable_aied())
     return NULL;
 
   /* Ever running thread */
   while (1) {
-    /* Calling XRT interface to wait for commands */
-    if (ai->mGraphs.empty() || drv->xclAIEGetCmd(&cmd) != 0) {
+    /* Calling XRT interface to wait for commands, blocks until a command arrives */
+    auto ret = drv->xclAIEGetCmd(&cmd);
+    if (ret) {
       /* break if destructor called */
       if (ai->done)
         return NULL;
+
+      /* Driver without AIE support, idle until destructor called */
+      if (ret == -EAGAIN) {
+        std::unique_lock<std::mutex> lk(ai->mDoneMutex);
+        ai->mDoneCond.wait(lk, [ai] { return ai->done.load(); });
+        return NULL;
+      }
       continue;
     }
 
@@ -73,8 +104,11 @@ Aied::pollAIE(void* arg)
       boost::property_tree::ptree pt;
       boost::property_tree::ptree pt_status;
 
-      for (auto graph : ai->mGraphs) {
-        pt.put(graph->getname(), graph->getstatus());
+      {
+        std::lock_guard<std::mutex> lk(ai->mGraphsMutex);
+        for (auto graph : ai->mGraphs) {
+          pt.put(graph->getname(), graph->getstatus());
+        }
       }
 
       pt_status.add_child("graphs", pt);
@@ -96,12 +130,14 @@ Aied::pollAIE(void* arg)
 void
 Aied::registerGraph(const graph_type *graph)
 {
+  std::lock_guard<std::mutex> lk(mGraphsMutex);
   mGraphs.push_back(graph);
 }
 
 void
 Aied::deregisterGraph(const graph_type *graph)
 {
+  std::lock_guard<std::mutex> lk(mGraphsMutex);
   mGraphs.erase(std::remove(mGraphs.begin(), mGraphs.end(), graph), mGraphs.end());
 }
 }
@@ -21,6 +21,9 @@
 #include <stdio.h>
 #include <errno.h>
 #include <unistd.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <pthread.h> 
 #include "core/common/device.h"
@@ -41,9 +44,15 @@ public:
   void deregisterGraph(const graph_type *graph);
 
 private:
-  bool done;
+  // The command thread blocks in the driver until a command arrives.
+  // It is interrupted by SIGUSR1 when the object is destroyed, and
+  // waits on mDoneCond if the driver has no AIE command support.
+  std::atomic<bool> done;
+  std::mutex mDoneMutex;
+  std::condition_variable mDoneCond;
   static void* pollAIE(void *arg);
   xrt_core::device *mCoreDevice;
+  std::mutex mGraphsMutex;
   std::vector<const graph_type*> mGraphs;
   pthread_t ptid;
 };
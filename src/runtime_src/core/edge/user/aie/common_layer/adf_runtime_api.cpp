@@ -18,8 +18,10 @@
 #include "adf_api_message.h"
 
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <map>
+#include <thread>
 
 extern "C"
 {
@@ -179,6 +181,11 @@ err_code graph_api::run(int iterations)
 }
 
 err_code graph_api::wait()
+{
+    return waitDone(-1);
+}
+
+err_code graph_api::waitDone(int timeoutMs)
 {
     if (!isConfigured)
         return errorMsg(err_code::aie_driver_error, "ERROR: adf::graph::wait: graph is not configured.");
@@ -187,16 +194,53 @@ err_code graph_api::wait()
 
     infoMsg("Waiting for core(s) of graph " + pGraphConfig->name + " to finish execution ...");
 
+    // Multi-rate cores are not waited for
+    std::vector<int> pendingCores;
     int numCores = coreTiles.size();
     for (int i = 0; i < numCores; i++)
     {
         if (!pGraphConfig->triggered[i])
-        {
-            // Default timeout is 500us. The timeout is counted on AIE clock.
-            // So even for a simple test-case this API call returns with error code XAIE_CORE_STATUS_TIMEOUT.
-            while (XAie_CoreWaitForDone(config_manager::s_pDevInst, coreTiles[i], 0) == XAIE_CORE_STATUS_TIMEOUT) {}
+            pendingCores.push_back(i);
+    }
+
+    // Core done events are not routed to the PS, so poll the done bit of the cores that are still
+    // running. Poll back to back for a short while for short graphs, then sleep between polls with
+    // an interval that doubles up to a limit and restarts when a core finishes.
+    const std::chrono::microseconds spinTime(50);
+    const std::chrono::microseconds minSleep(10);
+    const std::chrono::microseconds maxSleep(1000);
+    auto sleepTime = minSleep;
+    auto begin = std::chrono::steady_clock::now();
+
+    while (!pendingCores.empty())
+    {
+        auto pendingBefore = pendingCores.size();
+        pendingCores.erase(std::remove_if(pendingCores.begin(), pendingCores.end(), [&](int i) {
+            u8 done = 0;
+            driverStatus |= XAie_CoreReadDoneBit(config_manager::s_pDevInst, coreTiles[i], &done);
+            return done != 0;
+        }), pendingCores.end());
+
+        if (pendingCores.empty() || driverStatus != AieRC::XAIE_OK)
+            break;
+
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        if (timeoutMs >= 0 && elapsed > std::chrono::milliseconds(timeoutMs))
+            return err_code::resource_unavailable;
+
+        if (elapsed < spinTime)
+            continue;
+
+        if (pendingCores.size() < pendingBefore)
+            sleepTime = minSleep;
+        std::this_thread::sleep_for(sleepTime);
+        sleepTime = std::min(sleepTime * 2, maxSleep);
+    }
+
+    for (int i = 0; i < numCores; i++)
+    {
+        if (!pGraphConfig->triggered[i])
             driverStatus |= XAie_CoreDisable(config_manager::s_pDevInst, coreTiles[i]);
-        }
     }
 
     if (driverStatus != AieRC::XAIE_OK)
@@ -386,24 +430,9 @@ err_code graph_api::update(const rtp_config* pRTPConfig, const void* pValue, siz
     // Do NOT lock async RTP when graph is suspended; otherwise, it may deadlock. We don't support synchronous RTP in suspended mode
     bool bAcquireLock = !(pRTPConfig->isAsync && !isRunning);
 
-    int8_t acquireVal = (pRTPConfig->isAsync ? XAIE_LOCK_WITH_NO_VALUE : ACQ_WRITE); //Versal
+    int8_t acquireVal = getUpdateAcquireValue(pRTPConfig);
     int8_t releaseVal = REL_READ; //Versal
 
-    if (config_manager::s_pDevInst->DevProp.DevGen == XAIE_DEV_GEN_AIEML) //modification to accommodate AIEML semaphore
-    {
-        if (pRTPConfig->isAsync)
-        {
-            auto it = std::find (asyncNotFirstTimePorts.begin(), asyncNotFirstTimePorts.end(), pRTPConfig->portId);
-            if (it != asyncNotFirstTimePorts.end())
-                acquireVal = AIE_ML_ASYNC_ACQ;
-            else
-            {
-                acquireVal = AIE_ML_ASYNC_ACQ_FIRST_TIME;
-                asyncNotFirstTimePorts.push_back(pRTPConfig->portId);
-            }
-        }
-    }
-
     ///////////////////////////// RTP update operation //////////////////////////////
 
     infoMsg("Updating RTP value to port " + pRTPConfig->portName);
@@ -461,6 +490,134 @@ err_code graph_api::update(const rtp_config* pRTPConfig, const void* pValue, siz
     return err_code::ok;
 }
 
+int8_t graph_api::getUpdateAcquireValue(const rtp_config* pRTPConfig)
+{
+    int8_t acquireVal = (pRTPConfig->isAsync ? XAIE_LOCK_WITH_NO_VALUE : ACQ_WRITE); //Versal
+
+    if (config_manager::s_pDevInst->DevProp.DevGen == XAIE_DEV_GEN_AIEML) //modification to accommodate AIEML semaphore
+    {
+        if (pRTPConfig->isAsync)
+        {
+            auto it = std::find (asyncNotFirstTimePorts.begin(), asyncNotFirstTimePorts.end(), pRTPConfig->portId);
+            if (it != asyncNotFirstTimePorts.end())
+                acquireVal = AIE_ML_ASYNC_ACQ;
+            else
+            {
+                acquireVal = AIE_ML_ASYNC_ACQ_FIRST_TIME;
+                asyncNotFirstTimePorts.push_back(pRTPConfig->portId);
+            }
+        }
+    }
+
+    return acquireVal;
+}
+
+err_code graph_api::update(const std::vector<rtp_update_request>& requests)
+{
+    ///////////////////////////// Error Checking //////////////////////////////
+
+    // Check all ports before touching the AIE array so a bad port does not leave a partial update
+    for (auto& request : requests)
+    {
+        err_code ret = checkRTPConfigForUpdate(request.pRTPConfig, pGraphConfig, request.numBytes, isRunning);
+        if (ret != err_code::ok)
+            return ret;
+    }
+
+    ///////////////////////////// Configuration //////////////////////////////
+
+    // Synchronous ports block in lock acquire until the AIE side has consumed the previous value,
+    // holding one while waiting for another can deadlock with the AIE kernel, so they are updated
+    // one at a time. Asynchronous ports and ports without locks are updated together: all locks
+    // are acquired, all values written, then all locks released.
+    struct port_state
+    {
+        const rtp_update_request* request;
+        XAie_LocType selectorTile;
+        XAie_LocType bufferTile;
+        unsigned short bufferLockId;
+        size_t bufferAddr;
+        u32 selector;
+    };
+    std::vector<port_state> ports;
+    ports.reserve(requests.size());
+
+    for (auto& request : requests)
+    {
+        if (request.pRTPConfig->hasLock && !request.pRTPConfig->isAsync)
+        {
+            err_code ret = update(request.pRTPConfig, request.pValue, request.numBytes);
+            if (ret != err_code::ok)
+                return ret;
+            continue;
+        }
+        ports.push_back({&request, {}, {}, 0, 0, 0});
+    }
+
+    if (ports.empty())
+        return err_code::ok;
+
+    ///////////////////////////// RTP update operation //////////////////////////////
+
+    size_t numReservedRows = config_manager::s_num_reserved_rows;
+    int8_t releaseVal = REL_READ; //Versal
+    int driverStatus = AieRC::XAIE_OK; //0
+
+    // Acquire the selector and buffer lock of every port
+    for (auto& port : ports)
+    {
+        const rtp_config* pRTPConfig = port.request->pRTPConfig;
+        infoMsg("Updating RTP value to port " + pRTPConfig->portName);
+
+        bool bAcquireLock = pRTPConfig->hasLock && isRunning;
+        int8_t acquireVal = getUpdateAcquireValue(pRTPConfig);
+
+        port.selectorTile = XAie_TileLoc(pRTPConfig->selectorColumn, pRTPConfig->selectorRow + numReservedRows + 1);
+        if (bAcquireLock)
+            driverStatus |= XAie_LockAcquire(config_manager::s_pDevInst, port.selectorTile, XAie_LockInit(pRTPConfig->selectorLockId, acquireVal), LOCK_TIMEOUT);
+
+        driverStatus |= XAie_DataMemRdWord(config_manager::s_pDevInst, port.selectorTile, pRTPConfig->selectorAddr, &port.selector);
+        port.selector = 1 - port.selector;
+
+        if (port.selector == 1) //pong
+        {
+            port.bufferTile = XAie_TileLoc(pRTPConfig->pongColumn, pRTPConfig->pongRow + numReservedRows + 1);
+            port.bufferLockId = pRTPConfig->pongLockId;
+            port.bufferAddr = pRTPConfig->pongAddr;
+        }
+        else //ping
+        {
+            port.bufferTile = XAie_TileLoc(pRTPConfig->pingColumn, pRTPConfig->pingRow + numReservedRows + 1);
+            port.bufferLockId = pRTPConfig->pingLockId;
+            port.bufferAddr = pRTPConfig->pingAddr;
+        }
+
+        if (bAcquireLock)
+            driverStatus |= XAie_LockAcquire(config_manager::s_pDevInst, port.bufferTile, XAie_LockInit(port.bufferLockId, acquireVal), LOCK_TIMEOUT);
+    }
+
+    // Write the values and the new selectors
+    for (auto& port : ports)
+    {
+        driverStatus |= XAie_DataMemBlockWrite(config_manager::s_pDevInst, port.bufferTile, port.bufferAddr, port.request->pValue, port.request->numBytes);
+        driverStatus |= XAie_DataMemWrWord(config_manager::s_pDevInst, port.selectorTile, port.request->pRTPConfig->selectorAddr, port.selector);
+    }
+
+    // Release the locks in reverse order, also when the graph is suspended; otherwise, the AIE side may deadlock
+    for (auto it = ports.rbegin(); it != ports.rend(); ++it)
+    {
+        if (!it->request->pRTPConfig->hasLock)
+            continue;
+        driverStatus |= XAie_LockRelease(config_manager::s_pDevInst, it->selectorTile, XAie_LockInit(it->request->pRTPConfig->selectorLockId, releaseVal), LOCK_TIMEOUT);
+        driverStatus |= XAie_LockRelease(config_manager::s_pDevInst, it->bufferTile, XAie_LockInit(it->bufferLockId, releaseVal), LOCK_TIMEOUT);
+    }
+
+    if (driverStatus != AieRC::XAIE_OK)
+        return errorMsg(err_code::aie_driver_error, "ERROR: adf::graph::update: XAieTile_LockAcquire timeout or AIE driver error.");
+
+    return err_code::ok;
+}
+
 err_code checkRTPConfigForRead(const rtp_config* pRTPConfig, const graph_config* pGraphConfig, size_t numBytes)
 {
     if (!pRTPConfig)
@@ -584,9 +741,41 @@ size_t frontAndPop(std::queue<size_t>& bdQueue)
     return bd;
 }
 
-gmio_api::gmio_api(const gmio_config* pConfig) : pGMIOConfig(pConfig), isConfigured(false), dmaStartQMaxSize(4)
+gmio_api::gmio_api(const gmio_config* pConfig) : pGMIOConfig(pConfig), isConfigured(false), dmaStartQMaxSize(4), queueDepth(4), submittedBDs(0), completedBDs(0)
 {}
 
+void gmio_api::setQueueDepth(unsigned int depth)
+{
+    queueDepth = (depth == 0 || depth > dmaStartQMaxSize) ? dmaStartQMaxSize : depth;
+}
+
+int gmio_api::reclaimBDs()
+{
+    u8 numPendingBDs = 0;
+    int driverStatus = XAie_DmaGetPendingBdCount(config_manager::s_pDevInst, gmioTileLoc, convertLogicalToPhysicalDMAChNum(pGMIOConfig->channelNum), (pGMIOConfig->type == gmio_config::gm2aie ? DMA_MM2S : DMA_S2MM), &numPendingBDs);
+    if (driverStatus != AieRC::XAIE_OK)
+        return driverStatus;
+
+    //BDs complete in order, so the oldest enqueued BDs beyond the pending count are done
+    size_t numBDCompleted = enqueuedBDs.size() > numPendingBDs ? enqueuedBDs.size() - numPendingBDs : 0;
+    for (size_t i = 0; i < numBDCompleted; i++)
+    {
+        size_t bdNumber = frontAndPop(enqueuedBDs);
+        availableBDs.push(bdNumber);
+    }
+    completedBDs += numBDCompleted;
+    return driverStatus;
+}
+
+bool gmio_api::isTransferDone(uint64_t id)
+{
+    if (id <= completedBDs)
+        return true;
+    if (reclaimBDs() != AieRC::XAIE_OK)
+        errorMsg(err_code::aie_driver_error, "ERROR: adf::gmio_api::isTransferDone: AIE driver error.");
+    return id <= completedBDs;
+}
+
 err_code gmio_api::configure()
 {
     if (!pGMIOConfig)
@@ -600,6 +789,8 @@ err_code gmio_api::configure()
         //enable shim DMA channel, need to start first so the status is correct
         driverStatus |= XAie_DmaChannelEnable(config_manager::s_pDevInst, gmioTileLoc, convertLogicalToPhysicalDMAChNum(pGMIOConfig->channelNum), (pGMIOConfig->type == gmio_config::gm2aie ? DMA_MM2S : DMA_S2MM));
         driverStatus |= XAie_DmaGetMaxQueueSize(config_manager::s_pDevInst, gmioTileLoc, &dmaStartQMaxSize);
+        if (queueDepth == 0 || queueDepth > dmaStartQMaxSize)
+            queueDepth = dmaStartQMaxSize;
 
         //decide 4 BD numbers to use for this GMIO based on channel number (0-S2MM0,1-S2MM1,2-MM2S0,3-MM2S1)
         for (int j = 0; j < dmaStartQMaxSize; j++)
@@ -633,19 +824,12 @@ err_code gmio_api::enqueueBD(uint64_t address, size_t size)
 
     int driverStatus = XAIE_OK; //0
 
-    //wait for available BD
-    while (availableBDs.empty())
+    //wait for available BD within the queue depth
+    while (availableBDs.empty() || enqueuedBDs.size() >= queueDepth)
     {
-        u8 numPendingBDs = 0;
-        driverStatus |= XAie_DmaGetPendingBdCount(config_manager::s_pDevInst, gmioTileLoc, convertLogicalToPhysicalDMAChNum(pGMIOConfig->channelNum), (pGMIOConfig->type == gmio_config::gm2aie ? DMA_MM2S : DMA_S2MM), &numPendingBDs);
-
-        int numBDCompleted = dmaStartQMaxSize - numPendingBDs;
-        //move completed BDs from enqueuedBDs to availableBDs
-        for (int i = 0; i < numBDCompleted; i++)
-        {
-            size_t bdNumber = frontAndPop(enqueuedBDs);
-            availableBDs.push(bdNumber);
-        }
+        driverStatus |= reclaimBDs();
+        if (driverStatus != AieRC::XAIE_OK)
+            return errorMsg(err_code::aie_driver_error, "ERROR: adf::gmio_api::enqueueBD: AIE driver error.");
     }
 
     //get an available BD
@@ -671,6 +855,7 @@ err_code gmio_api::enqueueBD(uint64_t address, size_t size)
     //enqueue BD
     driverStatus |= XAie_DmaChannelPushBdToQueue(config_manager::s_pDevInst, gmioTileLoc, convertLogicalToPhysicalDMAChNum(pGMIOConfig->channelNum), (pGMIOConfig->type == gmio_config::gm2aie ? DMA_MM2S : DMA_S2MM), bdNumber);
     enqueuedBDs.push(bdNumber);
+    ++submittedBDs;
 
 #ifndef __AIESIM__
     debugMsg(static_cast<std::stringstream &&>(std::stringstream() << "gmio_api::enqueueBD: (id "
@@ -701,6 +886,7 @@ err_code gmio_api::wait()
 
     while (XAie_DmaWaitForDone(config_manager::s_pDevInst, gmioTileLoc, convertLogicalToPhysicalDMAChNum(pGMIOConfig->channelNum), (pGMIOConfig->type == gmio_config::gm2aie ? DMA_MM2S : DMA_S2MM), 0) != XAIE_OK) {}
 
+    completedBDs += enqueuedBDs.size();
     while (!enqueuedBDs.empty())
     {
         size_t bdNumber = frontAndPop(enqueuedBDs);
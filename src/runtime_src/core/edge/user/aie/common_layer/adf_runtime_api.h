@@ -43,6 +43,14 @@ public:
     static bool s_broadcast_enable_core;
 };
 
+/// One RTP port update of a batched graph_api::update
+struct rtp_update_request
+{
+    const rtp_config* pRTPConfig;
+    const void* pValue;
+    size_t numBytes;
+};
+
 class graph_api
 {
 public:
@@ -54,10 +62,13 @@ public:
     err_code run(int testIter);
     err_code wait();
     err_code wait(unsigned long long cycleTimeout);
+    /// Wait for cores to be done, returns resource_unavailable after timeoutMs, wait forever if negative
+    err_code waitDone(int timeoutMs);
     err_code resume();
     err_code end();
     err_code end(unsigned long long cycleTimeout);
     err_code update(const rtp_config* pRTPConfig, const void* pValue, size_t numBytes);
+    err_code update(const std::vector<rtp_update_request>& requests);
     err_code read(const rtp_config* pRTPConfig, void* pValue, size_t numBytes);
 
 private:
@@ -69,6 +80,8 @@ private:
     std::vector<XAie_LocType> coreTiles;
     std::vector<XAie_LocType> iterMemTiles;
     std::vector<int> asyncNotFirstTimePorts; // For AIE2, maintain a list of portIds already configured for asyn RTP
+
+    int8_t getUpdateAcquireValue(const rtp_config* pRTPConfig);
 };
 
 class gmio_api
@@ -85,7 +98,18 @@ public:
 #endif
     err_code wait();
     err_code enqueueTask(std::vector<dma_api::buffer_descriptor> bdParams, uint32_t repeatCount, bool enableTaskCompleteToken);
+
+    /// Limit the number of BDs in flight on the channel, 0 for the DMA maximum
+    void setQueueDepth(unsigned int depth);
+    /// Id of the most recently enqueued transfer, ids start at 1
+    uint64_t getSubmittedCount() const { return submittedBDs; }
+    /// Non-blocking check whether transfer with id has completed
+    bool isTransferDone(uint64_t id);
 private:
+    /// Move BDs the DMA has finished with back to availableBDs
+    int reclaimBDs();
+
+
     /// GMIO shim DMA physical configuration compiled by the AIE compiler
     const gmio_config* pGMIOConfig;
 
@@ -97,6 +121,9 @@ private:
     uint8_t dmaStartQMaxSize;
     std::queue<size_t> enqueuedBDs;
     std::queue<size_t> availableBDs;
+    size_t queueDepth;
+    uint64_t submittedBDs;
+    uint64_t completedBDs;
 };
 
 err_code checkRTPConfigForUpdate(const rtp_config* pRTPConfig, const graph_config* pGraphConfig, size_t numBytes, bool isRunning = false);
@@ -191,45 +191,10 @@ wait_done(int timeout_ms)
     if (state != graph_state::running)
       throw xrt_core::error(-EINVAL, "Graph '" + name + "' is not running, cannot wait");
 
-    auto begin = std::chrono::high_resolution_clock::now();
-
-    /*
-     * We are using busy waiting here. Until every tile in the graph
-     * is done, we keep polling each tile.
-     */
-    while (1) {
-        uint8_t done;
-        for (int i = 0; i < graph_config.coreColumns.size(); i++){
-            /* Skip multi-rate core */
-            if (graph_config.triggered[i]) {
-                done = 1;
-                continue;
-            }
-
-            XAie_LocType coreTile = XAie_TileLoc(graph_config.coreColumns[i], graph_config.coreRows[i] + adf::config_manager::s_num_reserved_rows + 1);
-            XAie_CoreReadDoneBit(aieArray->getDevInst(), coreTile, &done);
-            if (!done)
-                break;
-        }
-
-        if (done) {
-            state = graph_state::stop;
-            for (int i = 0; i < graph_config.coreColumns.size(); i++){
-                if (graph_config.triggered[i])
-                    continue;
-
-                XAie_LocType coreTile = XAie_TileLoc(graph_config.coreColumns[i], graph_config.coreRows[i] + adf::config_manager::s_num_reserved_rows + 1);
-                XAie_CoreDisable(aieArray->getDevInst(), coreTile);
-            }
-            return;
-        }
-
-        auto current = std::chrono::high_resolution_clock::now();
-        auto dur = current - begin;
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
-        if (timeout_ms >= 0 && timeout_ms < ms)
-          throw xrt_core::error(-ETIME, "Wait graph '" + name + "' timeout.");
-    }
+    if (pAIEConfigAPI->waitDone(timeout_ms) == adf::err_code::resource_unavailable)
+      throw xrt_core::error(-ETIME, "Wait graph '" + name + "' timeout.");
+
+    state = graph_state::stop;
 }
 
 void
@@ -365,6 +330,51 @@ read_rtp(const std::string& port, char* buffer, size_t size)
     pAIEConfigAPI->read(&rtp, (void*)buffer, size);
 }
 
+void
+graph_type::
+update_rtps(const char** ports, const char** buffers, const size_t* sizes, size_t count)
+{
+    std::vector<adf::rtp_update_request> requests;
+    requests.reserve(count);
+    for (size_t idx = 0; idx < count; ++idx) {
+      auto it = rtps.find(ports[idx]);
+      if (it == rtps.end())
+        throw xrt_core::error(-EINVAL, "Can't update graph '" + name + "': RTP port '" + ports[idx] + "' not found");
+      auto& rtp = it->second;
+
+      if (access_mode == xrt::graph::access_mode::shared && !rtp.isAsync)
+        throw xrt_core::error(-EPERM, "Shared context can not update sync RTP");
+
+      if (rtp.isPL)
+        throw xrt_core::error(-EINVAL, "Can't update graph '" + name + "': RTP port '" + ports[idx] + "' is not AIE RTP");
+
+      requests.push_back({&rtp, buffers[idx], sizes[idx]});
+    }
+
+    pAIEConfigAPI->update(requests);
+}
+
+void
+graph_type::
+read_rtps(const char** ports, char** buffers, const size_t* sizes, size_t count)
+{
+    std::vector<const adf::rtp_config*> configs;
+    configs.reserve(count);
+    for (size_t idx = 0; idx < count; ++idx) {
+      auto it = rtps.find(ports[idx]);
+      if (it == rtps.end())
+        throw xrt_core::error(-EINVAL, "Can't read graph '" + name + "': RTP port '" + ports[idx] + "' not found");
+
+      if (it->second.isPL)
+        throw xrt_core::error(-EINVAL, "Can't read graph '" + name + "': RTP port '" + ports[idx] + "' is not AIE RTP");
+
+      configs.push_back(&it->second);
+    }
+
+    for (size_t idx = 0; idx < count; ++idx)
+      pAIEConfigAPI->read(configs[idx], (void*)buffers[idx], sizes[idx]);
+}
+
 } // zynqaie
 
 namespace {
@@ -497,6 +507,20 @@ xclGraphReadRTP(xclGraphHandle ghdl, const char* port, char* buffer, size_t size
   graph->read_rtp(port, buffer, size);
 }
 
+void
+xclGraphUpdateRTPBatch(xclGraphHandle ghdl, const char** ports, const char** buffers, const size_t* sizes, size_t count)
+{
+  auto graph = get_graph(ghdl);
+  graph->update_rtps(ports, buffers, sizes, count);
+}
+
+void
+xclGraphReadRTPBatch(xclGraphHandle ghdl, const char** ports, char** buffers, const size_t* sizes, size_t count)
+{
+  auto graph = get_graph(ghdl);
+  graph->read_rtps(ports, buffers, sizes, count);
+}
+
 void
 xclAIEOpenContext(xclDeviceHandle handle, xrt::aie::access_mode am)
 {
@@ -564,6 +588,32 @@ xclSyncBOAIENB(xclDeviceHandle handle, xrt::bo& bo, const char *gmioName, enum x
   aieArray->sync_bo_nb(bo, gmioName, dir, size, offset);
 }
 
+uint64_t
+xclSyncBOAIESubmit(xclDeviceHandle handle, xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset)
+{
+#ifndef __AIESIM__
+  auto device = xrt_core::get_userpf_device(handle);
+  auto drv = ZYNQ::shim::handleCheck(device->get_device_handle());
+
+  if (!drv->isAieRegistered())
+    throw xrt_core::error(-EINVAL, "No AIE presented");
+  auto aieArray = drv->getAieArray();
+#else
+  auto aieArray = getAieArray();
+#endif
+
+  if (!aieArray->is_context_set()) {
+    aieArray->open_context(device.get(), xrt::aie::access_mode::primary);
+  }
+
+  auto bosize = bo.size();
+
+  if (offset + size > bosize)
+    throw xrt_core::error(-EINVAL, "Sync AIE Bo fails: exceed BO boundary.");
+
+  return aieArray->submit_bo(bo, gmioName, dir, size, offset);
+}
+
 void
 xclGMIOWait(xclDeviceHandle handle, const char *gmioName)
 {
@@ -585,6 +635,27 @@ xclGMIOWait(xclDeviceHandle handle, const char *gmioName)
   aieArray->wait_gmio(gmioName);
 }
 
+void
+xclGMIOWaitTransfer(xclDeviceHandle handle, const char *gmioName, uint64_t id)
+{
+#ifndef __AIESIM__
+  auto device = xrt_core::get_userpf_device(handle);
+  auto drv = ZYNQ::shim::handleCheck(device->get_device_handle());
+
+  if (!drv->isAieRegistered())
+    throw xrt_core::error(-EINVAL, "No AIE presented");
+  auto aieArray = drv->getAieArray();
+#else
+  auto aieArray = getAieArray();
+#endif
+
+  if (!aieArray->is_context_set()) {
+    aieArray->open_context(device.get(), xrt::aie::access_mode::primary);
+  }
+
+  aieArray->wait_gmio(gmioName, id);
+}
+
 void
 xclResetAieArray(xclDeviceHandle handle)
 {
@@ -878,6 +949,40 @@ xclGraphReadRTP(xclGraphHandle ghdl, const char *port, char *buffer, size_t size
   return -1;
 }
 
+int
+xclGraphUpdateRTPBatch(xclGraphHandle ghdl, const char** ports, const char** buffers, const size_t* sizes, size_t count)
+{
+  try {
+    api::xclGraphUpdateRTPBatch(ghdl, ports, buffers, sizes, count);
+    return 0;
+  }
+  catch (const xrt_core::error& ex) {
+    xrt_core::send_exception_message(ex.what());
+    errno = ex.get();
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return -1;
+}
+
+int
+xclGraphReadRTPBatch(xclGraphHandle ghdl, const char** ports, char** buffers, const size_t* sizes, size_t count)
+{
+  try {
+    api::xclGraphReadRTPBatch(ghdl, ports, buffers, sizes, count);
+    return 0;
+  }
+  catch (const xrt_core::error& ex) {
+    xrt_core::send_exception_message(ex.what());
+    errno = ex.get();
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return -1;
+}
+
 int
 xclAIEOpenContext(xclDeviceHandle handle, xrt::aie::access_mode am)
 {
@@ -989,6 +1094,40 @@ xclGMIOWait(xclDeviceHandle handle, const char *gmioName)
   return -1;
 }
 
+int
+xclSyncBOAIESubmit(xclDeviceHandle handle, xrt::bo& bo, const char *gmioName, enum xclBOSyncDirection dir, size_t size, size_t offset, uint64_t* id)
+{
+  try {
+    *id = api::xclSyncBOAIESubmit(handle, bo, gmioName, dir, size, offset);
+    return 0;
+  }
+  catch (const xrt_core::error& ex) {
+    xrt_core::send_exception_message(ex.what());
+    errno = ex.get();
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return -1;
+}
+
+int
+xclGMIOWaitTransfer(xclDeviceHandle handle, const char *gmioName, uint64_t id)
+{
+  try {
+    api::xclGMIOWaitTransfer(handle, gmioName, id);
+    return 0;
+  }
+  catch (const xrt_core::error& ex) {
+    xrt_core::send_exception_message(ex.what());
+    errno = ex.get();
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return -1;
+}
+
 int
 xclStartProfiling(xclDeviceHandle handle, int option, const char* port1Name, const char* port2Name, uint32_t value)
 {
@@ -85,6 +85,12 @@ public:
     void
     read_rtp(const std::string& path, char* buffer, size_t size);
 
+    void
+    update_rtps(const char** ports, const char** buffers, const size_t* sizes, size_t count);
+
+    void
+    read_rtps(const char** ports, char** buffers, const size_t* sizes, size_t count);
+
     static void
     event_cb(struct XAieGbl *aie_inst, XAie_LocType loc, u8 module, u8 event, void *arg);
 
@@ -61,6 +61,69 @@ public:
 
   virtual void
   wait_ip_interrupt(xclInterruptNotifyHandle);
+
+  virtual void
+  exec_buf_at(xclBufferHandle boh, size_t offset)
+  {
+    if (auto ret = xclExecBufAt(get_device_handle(), boh, offset))
+      throw system_error(ret, "failed to launch execution buffer");
+  }
+
+  virtual void
+  sync_bo_batch(const xclBufferHandle* bos, const xclBOSyncDirection* dirs,
+                const size_t* sizes, const size_t* offsets, size_t count)
+  {
+    if (auto ret = xclSyncBOBatch(get_device_handle(), bos, dirs, sizes, offsets, count))
+      throw system_error(ret, "unable to sync BO");
+  }
+
+  virtual void
+  open_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count, bool shared)
+  {
+    if (auto ret = xclOpenContextBatch(get_device_handle(), xclbin_uuid, ip_indices, count, shared))
+      throw system_error(ret, "failed to open ip contexts");
+  }
+
+  virtual void
+  close_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count)
+  {
+    if (auto ret = xclCloseContextBatch(get_device_handle(), xclbin_uuid, ip_indices, count))
+      throw system_error(ret, "failed to close ip contexts");
+  }
+
+#ifdef XRT_ENABLE_AIE
+  virtual void
+  update_graph_rtp_batch(xclGraphHandle handle, const char** ports, const char** buffers,
+                         const size_t* sizes, size_t count)
+  {
+    if (auto ret = xclGraphUpdateRTPBatch(handle, ports, buffers, sizes, count))
+      throw system_error(ret, "fail to update graph rtp");
+  }
+
+  virtual void
+  read_graph_rtp_batch(xclGraphHandle handle, const char** ports, char** buffers,
+                       const size_t* sizes, size_t count)
+  {
+    if (auto ret = xclGraphReadRTPBatch(handle, ports, buffers, sizes, count))
+      throw system_error(ret, "fail to read graph rtp");
+  }
+
+  virtual uint64_t
+  submit_aie_bo(xrt::bo& bo, const char *gmioName, xclBOSyncDirection dir, size_t size, size_t offset)
+  {
+    uint64_t id = 0;
+    if (auto ret = xclSyncBOAIESubmit(get_device_handle(), bo, gmioName, dir, size, offset, &id))
+      throw system_error(ret, "fail to sync aie non-blocking bo");
+    return id;
+  }
+
+  virtual void
+  wait_gmio_transfer(const char *gmioName, uint64_t id)
+  {
+    if (auto ret = xclGMIOWaitTransfer(get_device_handle(), gmioName, id))
+      throw system_error(ret, "fail to wait gmio");
+  }
+#endif
   ////////////////////////////////////////////////////////////////
 
 private:
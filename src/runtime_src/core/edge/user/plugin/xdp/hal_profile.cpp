@@ -19,6 +19,7 @@
 #include "core/common/config_reader.h"
 #include "core/common/dlfcn.h"
 #include "core/common/message.h"
+#include "core/common/time.h"
 #include "core/common/module_loader.h"
 #include "core/common/utils.h"
 
@@ -32,6 +33,9 @@ std::function<void (bool, const char*, unsigned long long int)> generic_cb ;
 std::function<void (bool, bool, const char*, unsigned long long int,
                     unsigned long long int,
                     unsigned long long int)> buffer_transfer_cb ;
+std::function<void (void*, unsigned int, const char*,
+                    unsigned long long int,
+                    unsigned long long int)> transfer_stats_cb ;
 
   // The registration function
   void register_callbacks(void* handle)
@@ -50,6 +54,13 @@ std::function<void (bool, bool, const char*, unsigned long long int,
     buffer_transfer_cb =
       reinterpret_cast<buffer_transfer_type>(xrt_core::dlsym(handle, "buffer_transfer_cb")) ;
     if (xrt_core::dlerror() != nullptr) buffer_transfer_cb = nullptr ;
+
+    using transfer_stats_type  = void (*)(void*, unsigned int, const char*,
+                                          unsigned long long int,
+                                          unsigned long long int) ;
+    transfer_stats_cb =
+      reinterpret_cast<transfer_stats_type>(xrt_core::dlsym(handle, "hal_transfer_stats_cb")) ;
+    if (xrt_core::dlerror() != nullptr) transfer_stats_cb = nullptr ;
   }
 
   // The warning function
@@ -128,5 +139,20 @@ std::function<void (bool, bool, const char*, unsigned long long int,
     }
   }
 
+  void transfer_stats_logger::start()
+  {
+    if (transfer_stats_cb) {
+      m_start = xrt_core::time_ns() ;
+      m_timed = true ;
+    }
+  }
+
+  void transfer_stats_logger::end()
+  {
+    if (transfer_stats_cb)
+      transfer_stats_cb(m_handle, m_direction, m_fullname, m_size,
+                        xrt_core::time_ns() - m_start) ;
+  }
+
 } // end namespace hal
 } // end namespace xdp
@@ -17,6 +17,8 @@
 #ifndef XDP_PROFILE_HAL_PLUGIN_H_
 #define XDP_PROFILE_HAL_PLUGIN_H_
 
+#include "core/include/xclhal2.h"
+
 #include "core/common/config_reader.h"
 
 namespace xdp {
@@ -88,17 +90,87 @@ class buffer_transfer_logger : public api_call_logger
   ~buffer_transfer_logger() override ;
 } ;
 
+// Transfer histograms are collected if specified in xrt.ini, with or
+// without trace, evaluated once
+inline bool
+transfer_stats_enabled()
+{
+  static const bool value = xrt_core::config::get_hal_transfer_stats() ;
+  return value ;
+}
+
+// Times a buffer transfer of a device for the transfer histograms.
+// Only the enabled check is inline.
+class transfer_stats_logger
+{
+ public:
+  enum direction : unsigned int { read = 0, write = 1, copy = 2 } ;
+
+ private:
+  xclDeviceHandle m_handle ;
+  const char* m_fullname ;
+  uint64_t m_size ;
+  uint64_t m_start ;
+  direction m_direction ;
+  bool m_timed ;
+
+  void start() ;
+  void end() ;
+
+  transfer_stats_logger()                               = delete ;
+  transfer_stats_logger(const transfer_stats_logger& x) = delete ;
+  transfer_stats_logger(transfer_stats_logger&& x)      = delete ;
+  void operator=(const transfer_stats_logger& x)        = delete ;
+  void operator=(transfer_stats_logger&& x)             = delete ;
+ public:
+  transfer_stats_logger(xclDeviceHandle handle, const char* function,
+                        size_t size, direction dir)
+    : m_handle(handle), m_fullname(function), m_size(size), m_start(0),
+      m_direction(dir), m_timed(false)
+  {
+    if (transfer_stats_enabled())
+      start() ;
+  }
+
+  ~transfer_stats_logger()
+  {
+    if (m_timed)
+      end() ;
+  }
+} ;
+
 template <typename Callable, typename ...Args>
 auto
-buffer_transfer_profiling_wrapper(const char* function, size_t size,
-                                  bool isWrite, Callable&& f, Args&&...args)
+buffer_transfer_profiling_wrapper(const char* function, xclDeviceHandle handle,
+                                  size_t size, bool isWrite,
+                                  Callable&& f, Args&&...args)
 {
   loader load_object ;
+  auto dir = isWrite ? transfer_stats_logger::write : transfer_stats_logger::read ;
   if (xrt_core::config::get_xrt_trace() ||
       xrt_core::config::get_host_trace()) {
     buffer_transfer_logger log_object(function, size, isWrite) ;
+    transfer_stats_logger stats_object(handle, function, size, dir) ;
+    return f(std::forward<Args>(args)...) ;
+  }
+  transfer_stats_logger stats_object(handle, function, size, dir) ;
+  return f(std::forward<Args>(args)...) ;
+}
+
+// Device to device copies are traced as generic API calls
+template <typename Callable, typename ...Args>
+auto
+buffer_copy_profiling_wrapper(const char* function, xclDeviceHandle handle,
+                              size_t size, Callable&& f, Args&&...args)
+{
+  loader load_object ;
+  if (xrt_core::config::get_xrt_trace() ||
+      xrt_core::config::get_host_trace()) {
+    generic_api_call_logger log_object(function) ;
+    transfer_stats_logger stats_object(handle, function, size, transfer_stats_logger::copy) ;
     return f(std::forward<Args>(args)...) ;
   }
+  transfer_stats_logger stats_object(handle, function, size, transfer_stats_logger::copy) ;
   return f(std::forward<Args>(args)...) ;
 }
 
@@ -43,7 +43,8 @@ bool load()
 {
 #ifndef __HWEM__
   if (xrt_core::config::get_xrt_trace() ||
-      xrt_core::utils::load_host_trace())
+      xrt_core::utils::load_host_trace() ||
+      xrt_core::config::get_hal_transfer_stats())
     xdp::hal::load();
 
   if (xrt_core::config::get_data_transfer_trace() != "off" ||
@@ -99,7 +100,8 @@ bool load()
 #ifdef __HWEM__
   // Hardware emulation uses the same plugin as hardware for API trace
   if (xrt_core::config::get_xrt_trace() ||
-      xrt_core::utils::load_host_trace())
+      xrt_core::utils::load_host_trace() ||
+      xrt_core::config::get_hal_transfer_stats())
     xdp::hal::load();
 
   if (xrt_core::config::get_data_transfer_trace() != "off" ||
@@ -36,8 +36,10 @@
 #include <thread>
 #include <chrono>
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include <cstdarg>
+#include <limits>
 
 #include <fcntl.h>
 #include <poll.h>
@@ -74,6 +76,40 @@ operator"" _gb(unsigned long long value)
   return value << 30;
 }
 
+#if defined(__aarch64__)
+// Smallest data cache line size from CTR_EL0.DminLine
+size_t
+dcache_line_size()
+{
+  uint64_t ctr = 0;
+  asm volatile("mrs %0, ctr_el0" : "=r"(ctr));
+  return size_t(4) << ((ctr >> 16) & 0xf);
+}
+
+// Data cache maintenance by virtual address to the point of coherency.
+// To device cleans the range.  From device cleans and invalidates the
+// range, EL0 cannot issue DC IVAC, so a line the CPU modified while
+// the device owned the buffer is written back, same as a misuse of
+// the sync ioctl would corrupt it.
+void
+dcache_sync(char* addr, size_t size, bool to_device)
+{
+  static const size_t line = dcache_line_size();
+  auto start = reinterpret_cast<uintptr_t>(addr) & ~(line - 1);
+  auto end = reinterpret_cast<uintptr_t>(addr) + size;
+
+  if (to_device) {
+    for (auto va = start; va < end; va += line)
+      asm volatile("dc cvac, %0" : : "r"(va) : "memory");
+  }
+  else {
+    for (auto va = start; va < end; va += line)
+      asm volatile("dc civac, %0" : : "r"(va) : "memory");
+  }
+  asm volatile("dsb sy" : : : "memory");
+}
+#endif
+
 }
 
 // TODO: This code is copy from core/pcie/linux/shim.cpp. Considering to create a util library for X86 and ARM.
@@ -118,6 +154,9 @@ shim(unsigned index)
   }
   mCmdBOCache = std::make_unique<xrt_core::bo_cache>(this, xrt_core::config::get_cmdbo_cache());
   mDev = zynq_device::get_dev();
+#if defined(__aarch64__)
+  mUserCacheSync = xrt_core::config::get_edge_user_cache_sync();
+#endif
 }
 
 shim::
@@ -321,6 +360,11 @@ void
 shim::
 xclFreeBO(unsigned int boHandle)
 {
+  if (mUserCacheSync) {
+    std::lock_guard<std::mutex> lk(mCacheableMapLock);
+    mCacheableMaps.erase(boHandle);
+  }
+
   drm_gem_close closeInfo = {boHandle, 0};
   int result = ioctl(mKernelFD, DRM_IOCTL_GEM_CLOSE, &closeInfo);
 
@@ -372,6 +416,11 @@ xclMapBO(unsigned int boHandle, bool write)
 
   xclLog(XRT_INFO, "%s: mmap return %p", __func__, ptr);
 
+  if (mUserCacheSync && ptr != MAP_FAILED && (info.flags & XCL_BO_FLAGS_CACHEABLE)) {
+    std::lock_guard<std::mutex> lk(mCacheableMapLock);
+    mCacheableMaps.emplace(boHandle, std::make_pair(static_cast<char*>(ptr), info.size));
+  }
+
   return ptr;
 }
 
@@ -384,6 +433,13 @@ xclUnmapBO(unsigned int boHandle, void* addr)
   if (ret)
     return -errno;
 
+  if (mUserCacheSync) {
+    std::lock_guard<std::mutex> lk(mCacheableMapLock);
+    auto itr = mCacheableMaps.find(boHandle);
+    if (itr != mCacheableMaps.end() && itr->second.first == addr)
+      mCacheableMaps.erase(itr);
+  }
+
   return munmap(addr, info.size);
 }
 
@@ -427,10 +483,42 @@ xclGetDeviceInfo2(xclDeviceInfo2 *info)
   return 0;
 }
 
+// Sync a mapped cacheable BO by cache maintenance from user space,
+// returns false if the BO must be synced by the driver
+bool
+shim::
+userCacheSync(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset)
+{
+#if defined(__aarch64__)
+  char* addr = nullptr;
+  {
+    std::lock_guard<std::mutex> lk(mCacheableMapLock);
+    auto itr = mCacheableMaps.find(boHandle);
+    if (itr == mCacheableMaps.end() || offset + size > itr->second.second)
+      return false;
+    addr = itr->second.first;
+  }
+
+  if (dir == XCL_BO_SYNC_BO_TO_DEVICE)
+    dcache_sync(addr + offset, size, true);
+  else if (dir == XCL_BO_SYNC_BO_FROM_DEVICE)
+    dcache_sync(addr + offset, size, false);
+  else
+    return false;
+
+  return true;
+#else
+  return false;
+#endif
+}
+
 int
 shim::
 xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset)
 {
+  if (mUserCacheSync && userCacheSync(boHandle, dir, size, offset))
+    return 0;
+
   drm_zocl_sync_bo_dir zocl_dir;
   if (dir == XCL_BO_SYNC_BO_TO_DEVICE)
     zocl_dir = DRM_ZOCL_SYNC_BO_TO_DEVICE;
@@ -447,6 +535,46 @@ xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t off
   return result ? -errno : result;
 }
 
+int
+shim::
+xclSyncBOBatch(const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+               const size_t* sizes, const size_t* offsets, size_t count)
+{
+  std::vector<drm_zocl_sync_bo> syncs;
+  for (size_t idx = 0; idx < count; ++idx) {
+    if (mUserCacheSync && userCacheSync(boHandles[idx], dirs[idx], sizes[idx], offsets[idx]))
+      continue;
+
+    drm_zocl_sync_bo_dir zocl_dir;
+    if (dirs[idx] == XCL_BO_SYNC_BO_TO_DEVICE)
+      zocl_dir = DRM_ZOCL_SYNC_BO_TO_DEVICE;
+    else if (dirs[idx] == XCL_BO_SYNC_BO_FROM_DEVICE)
+      zocl_dir = DRM_ZOCL_SYNC_BO_FROM_DEVICE;
+    else
+      return -EINVAL;
+    syncs.push_back({ boHandles[idx], zocl_dir, offsets[idx], sizes[idx] });
+  }
+
+  for (size_t idx = 0; idx < syncs.size(); idx += DRM_ZOCL_SYNC_BO_VEC_MAX) {
+    auto num = std::min<size_t>(syncs.size() - idx, DRM_ZOCL_SYNC_BO_VEC_MAX);
+    drm_zocl_sync_bo_vec vec = { static_cast<uint32_t>(num), 0, reinterpret_cast<uint64_t>(&syncs[idx]) };
+    int result = ioctl(mKernelFD, DRM_IOCTL_ZOCL_SYNC_BO_VEC, &vec);
+    if (result && (errno == ENOTTY || errno == EINVAL)) {
+      // Driver without batched sync, one ioctl per range
+      for (size_t i = idx; i < idx + num; ++i) {
+        if (ioctl(mKernelFD, DRM_IOCTL_ZOCL_SYNC_BO, &syncs[i]))
+          return -errno;
+      }
+      continue;
+    }
+    xclLog(XRT_DEBUG, "%s: %zu ranges, ioctl return %d", __func__, num, result);
+    if (result)
+      return -errno;
+  }
+
+  return 0;
+}
+
 int
 shim::
 xclCopyBO(unsigned int dst_boHandle, unsigned int src_boHandle, size_t size,
@@ -679,6 +807,20 @@ xclExecBuf(unsigned int cmdBO)
   return result ? -errno : result;
 }
 
+int
+shim::
+xclExecBufAt(unsigned int cmdBO, size_t offset)
+{
+  if (offset > std::numeric_limits<uint32_t>::max())
+    return -EINVAL;
+  drm_zocl_execbuf exec = {0, cmdBO, static_cast<uint32_t>(offset), 0};
+  int result = ioctl(mKernelFD, DRM_IOCTL_ZOCL_EXECBUF, &exec);
+  xclLog(XRT_DEBUG, "%s: cmdBO handle %d, offset %zu, ioctl return %d", __func__, cmdBO, offset, result);
+  if (result == -EDEADLK)
+      xclLog(XRT_ERROR, "CU might hang, please reset device");
+  return result ? -errno : result;
+}
+
 int
 shim::
 xclExecWait(int timeoutMilliSec)
@@ -858,6 +1000,22 @@ xclOpenContext(const uuid_t xclbinId, unsigned int ipIndex, bool shared)
   return ret ? -errno : ret;
 }
 
+// Make sure no MMIO register space access when CU is released.
+// Called with mCuMapLock held.
+void
+shim::
+unmapCu(unsigned int ipIndex)
+{
+  if (ipIndex >= mCuMaps.size())
+    return;
+
+  uint32_t *p = mCuMaps[ipIndex];
+  if (p) {
+    (void) munmap(p, mCuMapSize);
+    mCuMaps[ipIndex] = nullptr;
+  }
+}
+
 int
 shim::
 xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex)
@@ -865,14 +1023,7 @@ xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex)
   std::lock_guard<std::mutex> l(mCuMapLock);
   int ret;
 
-  if (ipIndex < mCuMaps.size()) {
-    // Make sure no MMIO register space access when CU is released.
-    uint32_t *p = mCuMaps[ipIndex];
-    if (p) {
-      (void) munmap(p, mCuMapSize);
-      mCuMaps[ipIndex] = nullptr;
-    }
-  }
+  unmapCu(ipIndex);
 
   drm_zocl_ctx ctx = {0};
   ctx.uuid_ptr = reinterpret_cast<uint64_t>(xclbinId);
@@ -884,6 +1035,93 @@ xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex)
   return ret ? -errno : ret;
 }
 
+// Open up to DRM_ZOCL_CTX_VEC_MAX contexts per ioctl.  Either all
+// contexts are opened or none.  Falls back to one ioctl per context
+// with a driver that does not support the vectored ioctl.
+int
+shim::
+xclOpenContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count, bool shared)
+{
+  unsigned int flags = shared ? ZOCL_CTX_SHARED : ZOCL_CTX_EXCLUSIVE;
+  size_t idx = 0;
+  bool fallback = false;
+  while (idx < count && mCtxVec) {
+    auto num = std::min<size_t>(count - idx, DRM_ZOCL_CTX_VEC_MAX);
+    drm_zocl_ctx_vec vec = {0};
+    vec.uuid_ptr = reinterpret_cast<uint64_t>(xclbinId);
+    vec.uuid_size = sizeof (uuid_t) * sizeof (char);
+    vec.cu_indices = reinterpret_cast<uint64_t>(ipIndices + idx);
+    vec.count = static_cast<uint32_t>(num);
+    vec.flags = flags;
+    vec.op = ZOCL_CTX_OP_ALLOC_CTX;
+    if (!ioctl(mKernelFD, DRM_IOCTL_ZOCL_CTX_VEC, &vec)) {
+      idx += num;
+      continue;
+    }
+    auto err = errno;
+    if (err != ENOTTY && err != EINVAL) {
+      (void) xclCloseContextBatch(xclbinId, ipIndices, idx);
+      return -err;
+    }
+
+    // Either an index is invalid or the driver is old, the single
+    // context ioctl tells which
+    fallback = true;
+    break;
+  }
+
+  for (size_t i = idx; i < count; ++i) {
+    if (auto ret = xclOpenContext(xclbinId, ipIndices[i], shared)) {
+      (void) xclCloseContextBatch(xclbinId, ipIndices, i);
+      return ret;
+    }
+  }
+
+  if (fallback)
+    mCtxVec = false;
+  return 0;
+}
+
+int
+shim::
+xclCloseContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count)
+{
+  std::lock_guard<std::mutex> l(mCuMapLock);
+  for (size_t i = 0; i < count; ++i)
+    unmapCu(ipIndices[i]);
+
+  size_t idx = 0;
+  while (idx < count && mCtxVec) {
+    auto num = std::min<size_t>(count - idx, DRM_ZOCL_CTX_VEC_MAX);
+    drm_zocl_ctx_vec vec = {0};
+    vec.uuid_ptr = reinterpret_cast<uint64_t>(xclbinId);
+    vec.uuid_size = sizeof (uuid_t) * sizeof (char);
+    vec.cu_indices = reinterpret_cast<uint64_t>(ipIndices + idx);
+    vec.count = static_cast<uint32_t>(num);
+    vec.op = ZOCL_CTX_OP_FREE_CTX;
+    if (ioctl(mKernelFD, DRM_IOCTL_ZOCL_CTX_VEC, &vec)) {
+      if (errno != ENOTTY && errno != EINVAL)
+        return -errno;
+      // Continue with the contexts that are not closed
+      idx += vec.done;
+      break;
+    }
+    idx += num;
+  }
+
+  int ret = 0;
+  for (; idx < count; ++idx) {
+    drm_zocl_ctx ctx = {0};
+    ctx.uuid_ptr = reinterpret_cast<uint64_t>(xclbinId);
+    ctx.uuid_size = sizeof (uuid_t) * sizeof (char);
+    ctx.cu_index = ipIndices[idx];
+    ctx.op = ZOCL_CTX_OP_FREE_CTX;
+    if (ioctl(mKernelFD, DRM_IOCTL_ZOCL_CTX, &ctx) && !ret)
+      ret = -errno;
+  }
+  return ret;
+}
+
 int
 shim::
 xclRegRW(bool rd, uint32_t ipIndex, uint32_t offset, uint32_t *datap)
@@ -1669,7 +1907,7 @@ size_t
 xclWriteBO(xclDeviceHandle handle, unsigned int boHandle, const void *src,
            size_t size, size_t seek)
 {
-  return xdp::hal::buffer_transfer_profiling_wrapper("xclWriteBO", size, true,
+  return xdp::hal::buffer_transfer_profiling_wrapper("xclWriteBO", handle, size, true,
   [handle, boHandle, src, size, seek] {
 
   //std::cout << "xclWriteBO called" << std::endl;
@@ -1684,7 +1922,7 @@ size_t
 xclReadBO(xclDeviceHandle handle, unsigned int boHandle, void *dst,
           size_t size, size_t skip)
 {
-  return xdp::hal::buffer_transfer_profiling_wrapper("xclReadBO", size, false,
+  return xdp::hal::buffer_transfer_profiling_wrapper("xclReadBO", handle, size, false,
   [handle, boHandle, dst, size, skip] {
 
   //std::cout << "xclReadBO called" << std::endl;
@@ -1721,7 +1959,7 @@ int
 xclSyncBO(xclDeviceHandle handle, unsigned int boHandle, xclBOSyncDirection dir,
           size_t size, size_t offset)
 {
-  return xdp::hal::buffer_transfer_profiling_wrapper("xclSyncBO", size,
+  return xdp::hal::buffer_transfer_profiling_wrapper("xclSyncBO", handle, size,
 						     (dir == XCL_BO_SYNC_BO_TO_DEVICE),
   [handle, boHandle, dir, size, offset] {
 
@@ -1732,11 +1970,24 @@ xclSyncBO(xclDeviceHandle handle, unsigned int boHandle, xclBOSyncDirection dir,
   }) ;
 }
 
+int
+xclSyncBOBatch(xclDeviceHandle handle, const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+               const size_t* sizes, const size_t* offsets, size_t count)
+{
+  return xdp::hal::profiling_wrapper("xclSyncBOBatch",
+  [handle, boHandles, dirs, sizes, offsets, count] {
+  ZYNQ::shim *drv = ZYNQ::shim::handleCheck(handle);
+  if (!drv)
+    return -EINVAL;
+  return drv->xclSyncBOBatch(boHandles, dirs, sizes, offsets, count);
+  }) ;
+}
+
 int
 xclCopyBO(xclDeviceHandle handle, unsigned int dst_boHandle,
           unsigned int src_boHandle, size_t size, size_t dst_offset, size_t src_offset)
 {
-  return xdp::hal::profiling_wrapper("xclCopyBO",
+  return xdp::hal::buffer_copy_profiling_wrapper("xclCopyBO", handle, size,
   [handle, dst_boHandle, src_boHandle, size, dst_offset, src_offset] {
 
   ZYNQ::shim *drv = ZYNQ::shim::handleCheck(handle);
@@ -1926,6 +2177,17 @@ xclExecBuf(xclDeviceHandle handle, unsigned int cmdBO)
   }) ;
 }
 
+int
+xclExecBufAt(xclDeviceHandle handle, unsigned int cmdBO, size_t offset)
+{
+  return xdp::hal::profiling_wrapper("xclExecBuf", [handle, cmdBO, offset] {
+  ZYNQ::shim *drv = ZYNQ::shim::handleCheck(handle);
+  if (!drv)
+    return -EINVAL;
+  return drv->xclExecBufAt(cmdBO, offset) ;
+  }) ;
+}
+
 int
 xclExecWait(xclDeviceHandle handle, int timeoutMilliSec)
 {
@@ -2081,6 +2343,28 @@ xclCloseContext(xclDeviceHandle handle, const uuid_t xclbinId, unsigned ipIndex)
   }) ;
 }
 
+int
+xclOpenContextBatch(xclDeviceHandle handle, const uuid_t xclbinId, const unsigned int* ipIndices,
+                    size_t count, bool shared)
+{
+  return xdp::hal::profiling_wrapper("xclOpenContext",
+  [handle, xclbinId, ipIndices, count, shared] {
+  ZYNQ::shim *drv = ZYNQ::shim::handleCheck(handle);
+  return drv ? drv->xclOpenContextBatch(xclbinId, ipIndices, count, shared) : -EINVAL;
+  }) ;
+}
+
+int
+xclCloseContextBatch(xclDeviceHandle handle, const uuid_t xclbinId, const unsigned int* ipIndices,
+                     size_t count)
+{
+  return xdp::hal::profiling_wrapper("xclCloseContext",
+  [handle, xclbinId, ipIndices, count] {
+  ZYNQ::shim *drv = ZYNQ::shim::handleCheck(handle);
+  return drv ? drv->xclCloseContextBatch(xclbinId, ipIndices, count) : -EINVAL;
+  }) ;
+}
+
 size_t
 xclGetDeviceTimestamp(xclDeviceHandle handle)
 {
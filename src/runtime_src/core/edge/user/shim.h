@@ -75,10 +75,13 @@ public:
   unsigned int xclGetBOProperties(unsigned int boHandle,
                                   xclBOProperties *properties);
   int xclExecBuf(unsigned int cmdBO);
+  int xclExecBufAt(unsigned int cmdBO, size_t offset);
   int xclExecWait(int timeoutMilliSec);
 
   int xclOpenContext(const uuid_t xclbinId, unsigned int ipIndex, bool shared);
   int xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex);
+  int xclOpenContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count, bool shared);
+  int xclCloseContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count);
 
   int xclSKGetCmd(xclSKCmd *cmd);
   int xclSKCreate(unsigned int boHandle, uint32_t cu_idx);
@@ -106,6 +109,8 @@ public:
 
   int xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size,
                 size_t offset);
+  int xclSyncBOBatch(const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+                     const size_t* sizes, const size_t* offsets, size_t count);
   int xclCopyBO(unsigned int dst_boHandle, unsigned int src_boHandle, size_t size,
                 size_t dst_offset, size_t src_offset);
 
@@ -167,8 +172,23 @@ private:
   std::vector<uint32_t*> mCuMaps;
   const size_t mCuMapSize = 64 * 1024;
   std::mutex mCuMapLock;
+  void unmapCu(unsigned int ipIndex);
+
+  // Cleared when the driver does not support DRM_IOCTL_ZOCL_CTX_VEC
+  bool mCtxVec = true;
   int xclRegRW(bool rd, uint32_t cu_index, uint32_t offset, uint32_t *datap);
 
+  /*
+   * Mapped cacheable BOs, synced with user space cache maintenance
+   * when Runtime.edge_user_cache_sync is set. Maps BO handle to the
+   * address and size of its first mapping.
+   */
+  bool mUserCacheSync = false;
+  std::map<unsigned int, std::pair<char*, size_t>> mCacheableMaps;
+  std::mutex mCacheableMapLock;
+  bool userCacheSync(unsigned int boHandle, xclBOSyncDirection dir,
+                     size_t size, size_t offset);
+
 #ifdef XRT_ENABLE_AIE
   std::unique_ptr<zynqaie::Aie> aieArray;
   std::unique_ptr<zynqaie::Aied> aied;
@@ -73,6 +73,8 @@
     ((struct ert_validate_cmd *)(pkg))
 #define to_abort_pkg(pkg) \
     ((struct ert_abort_cmd *)(pkg))
+#define to_start_chain_pkg(pkg) \
+    ((struct ert_start_chain_cmd *)(pkg))
 
 
 #define HOST_RW_PATTERN     0xF0F0F0F0
@@ -109,6 +111,9 @@ struct ert_packet {
  * @stat_enabled:    [4]     enabled driver to record timestamp for various
  *                           states cmd has gone through. The stat data
  *                           is appended after cmd data.
+ * @priority:        [6-5]   scheduling priority, see enum ert_cmd_priority
+ * @deadline:        [7]     command carries a deadline, see
+ *                           ert_start_kernel_deadline()
  * @extra_cu_masks:  [11-10] extra CU masks in addition to mandatory mask
  * @count:           [22-12] number of words following header for cmd data. Not
  *                           include stat data.
@@ -127,7 +132,9 @@ struct ert_start_kernel_cmd {
     struct {
       uint32_t state:4;          /* [3-0]   */
       uint32_t stat_enabled:1;   /* [4]     */
-      uint32_t unused:5;         /* [9-5]   */
+      uint32_t priority:2;       /* [6-5]   */
+      uint32_t deadline:1;       /* [7]     */
+      uint32_t unused:2;         /* [9-8]   */
       uint32_t extra_cu_masks:2; /* [11-10] */
       uint32_t count:11;         /* [22-12] */
       uint32_t opcode:5;         /* [27-23] */
@@ -144,6 +151,76 @@ struct ert_start_kernel_cmd {
   uint32_t data[1];            /* count-1 number of words */
 };
 
+/**
+ * struct ert_chain_stage: one stage of an ERT_START_CHAIN command
+ *
+ * @cu_idx:          index of the CU running this stage. Ignored for the
+ *                   first stage, which runs on the CU selected by the
+ *                   command CU masks
+ * @num_args:        number of argument words written to the CU register
+ *                   map starting at offset 0x10
+ * @num_patches:     number of argument patches applied after num_args,
+ *                   at most ERT_CHAIN_MAX_PATCHES
+ * @data:            num_args argument words followed by num_patches patches
+ *
+ * A patch copies a register of the CU of the previous stage, read after
+ * that CU is done, into a register of this CU before it is started. The
+ * register offsets in bytes are packed as ERT_CHAIN_PATCH(dst, src).
+ * Patches of the first stage are ignored.
+ */
+struct ert_chain_stage {
+  uint32_t cu_idx;
+  uint32_t num_args:16;
+  uint32_t num_patches:16;
+  uint32_t data[1];
+};
+
+#define ERT_CHAIN_MAX_PATCHES 16
+#define ERT_CHAIN_PATCH(dst, src) ((((src) & 0xffff) << 16) | ((dst) & 0xffff))
+#define ERT_CHAIN_PATCH_DST(patch) ((patch) & 0xffff)
+#define ERT_CHAIN_PATCH_SRC(patch) ((patch) >> 16)
+
+/* Size in words of a chain stage */
+#define ert_chain_stage_size(stage) (2 + (stage)->num_args + (stage)->num_patches)
+#define ert_chain_next_stage(stage) \
+    ((struct ert_chain_stage *)((uint32_t *)(stage) + ert_chain_stage_size(stage)))
+
+/**
+ * struct ert_start_chain_cmd: ERT start chained kernels command format
+ *
+ * @state:           [3-0]   current state of a command
+ * @extra_cu_masks:  [11-10] extra CU masks in addition to mandatory mask
+ * @count:           [22-12] number of words following header
+ * @opcode:          [27-23] ERT_START_CHAIN
+ * @type:            [31-27] 0, type of start_kernel
+ *
+ * @cu_mask:         first mandatory CU mask, CUs for the first stage
+ * @data:            extra_cu_masks words, then the number of stages
+ *                   followed by the stages in struct ert_chain_stage format
+ *
+ * The scheduler starts the CU of each stage as soon as the CU of the
+ * previous stage is done, without a round trip to the host, and completes
+ * the command when the CU of the last stage is done. The whole command
+ * must fit in the command queue slot of the first stage CU.
+ */
+struct ert_start_chain_cmd {
+  union {
+    struct {
+      uint32_t state:4;          /* [3-0]   */
+      uint32_t unused:6;         /* [9-4]   */
+      uint32_t extra_cu_masks:2; /* [11-10] */
+      uint32_t count:11;         /* [22-12] */
+      uint32_t opcode:5;         /* [27-23] */
+      uint32_t type:4;           /* [31-27] */
+    };
+    uint32_t header;
+  };
+
+  /* payload */
+  uint32_t cu_mask;          /* mandatory cu mask */
+  uint32_t data[1];          /* count-1 number of words */
+};
+
 /**
  * struct ert_init_kernel_cmd: ERT initialize kernel command format
  * this command initializes CUs by writing CU registers. CUs are
@@ -351,6 +428,13 @@ struct ert_unconfigure_sk_cmd {
  * struct ert_abort_cmd: ERT abort command format.
  *
  * @exec_bo_handle: The bo handle of execbuf command to abort
+ * @exec_bo_handles: List of bo handles of execbuf commands to abort with
+ *                   one command
+ *
+ * Each handle holds the execbuf bo handle in the lower 32 bits and the
+ * offset of the command within the bo in the upper 32 bits.  The handles
+ * are 64-bit aligned and preceded by one word of padding, so count is
+ * 1 + 2 * number of handles.  A count of 2 aborts exec_bo_handle only.
  */
 struct ert_abort_cmd {
   union {
@@ -365,7 +449,10 @@ struct ert_abort_cmd {
   };
 
   /* payload */
-  uint64_t exec_bo_handle;
+  union {
+    uint64_t exec_bo_handle;
+    uint64_t exec_bo_handles[1];
+  };
 };
 
 /**
@@ -428,6 +515,8 @@ struct ert_access_valid_cmd {
  * @ERT_CMD_STATE_TIMEOUT:     Set by scheduler if command timeout and reset
  * @ERT_CMD_STATE_NORESPONSE:  Set by scheduler if command timeout and fail to
  *                             reset
+ * @ERT_CMD_STATE_EXPIRED:     Set by scheduler if command deadline passed
+ *                             before the command was started on a CU
  */
 enum ert_cmd_state {
   ERT_CMD_STATE_NEW = 1,
@@ -441,9 +530,25 @@ enum ert_cmd_state {
   ERT_CMD_STATE_NORESPONSE = 9,
   ERT_CMD_STATE_SKERROR = 10, //Check for error return code from Soft Kernel
   ERT_CMD_STATE_SKCRASHED = 11, //Soft kernel has crashed
+  ERT_CMD_STATE_EXPIRED = 12,
   ERT_CMD_STATE_MAX, // Always the last one
 };
 
+/**
+ * Scheduling priority of start kernel commands
+ *
+ * @ERT_CMD_PRIORITY_NORMAL: Default, commands run in submission order
+ * @ERT_CMD_PRIORITY_HIGH:   Run ahead of normal and bulk commands waiting
+ *                           for the same CU
+ * @ERT_CMD_PRIORITY_BULK:   Run after normal and high commands waiting
+ *                           for the same CU
+ */
+enum ert_cmd_priority {
+  ERT_CMD_PRIORITY_NORMAL = 0,
+  ERT_CMD_PRIORITY_HIGH = 1,
+  ERT_CMD_PRIORITY_BULK = 2,
+};
+
 struct cu_cmd_state_timestamps {
   uint64_t skc_timestamps[ERT_CMD_STATE_MAX]; // In nano-second
 };
@@ -462,6 +567,7 @@ struct cu_cmd_state_timestamps {
  * @ERT_SK_START:       start a soft kernel
  * @ERT_SK_UNCONFIG:    unconfigure a soft kernel
  * @ERT_START_KEY_VAL:  same as ERT_START_CU but with key-value pair flavor
+ * @ERT_START_CHAIN:    start a chain of CUs, each started when the previous is done
  */
 enum ert_cmd_opcode {
   ERT_START_CU      = 0,
@@ -482,6 +588,7 @@ enum ert_cmd_opcode {
   ERT_START_KEY_VAL = 15,
   ERT_ACCESS_TEST_C = 16,
   ERT_ACCESS_TEST   = 17,
+  ERT_START_CHAIN   = 18,
 };
 
 /**
@@ -782,6 +889,38 @@ ert_copybo_size(struct ert_start_copybo_cmd *pkt)
   return pkt->size;
 }
 
+/* Number of stages, then every stage must be within the command */
+static inline bool
+ert_valid_chain(struct ert_start_chain_cmd *pkt)
+{
+  struct ert_chain_stage *stage;
+  uint32_t num_words = pkt->count - 1;
+  uint32_t num_stages;
+  uint32_t off, i;
+
+  /* 1 cu mask + number of stages */
+  if (pkt->count < pkt->extra_cu_masks + 1 + 1)
+    return false;
+
+  off = pkt->extra_cu_masks;
+  num_stages = pkt->data[off++];
+  if (!num_stages)
+    return false;
+
+  for (i = 0; i < num_stages; i++) {
+    if (off + 2 > num_words)
+      return false;
+    stage = (struct ert_chain_stage *)&pkt->data[off];
+    if (stage->num_patches > ERT_CHAIN_MAX_PATCHES)
+      return false;
+    off += ert_chain_stage_size(stage);
+    if (off > num_words)
+      return false;
+  }
+
+  return true;
+}
+
 static inline bool
 ert_valid_opcode(struct ert_packet *pkt)
 {
@@ -808,6 +947,9 @@ ert_valid_opcode(struct ert_packet *pkt)
     /* 1 cu mask + 6 registers */
     valid = (skcmd->count >= skcmd->extra_cu_masks + 1 + 6);
     break;
+  case ERT_START_CHAIN:
+    valid = ert_valid_chain(to_start_chain_pkg(pkt));
+    break;
   case ERT_START_FA:
     skcmd = to_start_krnl_pkg(pkt);
     /* 1 cu mask */
@@ -863,7 +1005,21 @@ ert_start_kernel_timestamps(struct ert_start_kernel_cmd *pkt)
     ((char *)pkt + P2ROUNDUP(offset, sizeof(uint64_t)));
 }
 
-/* Return 0 if this pkt doesn't support timestamp or disabled */
+/*
+ * Deadline of a start kernel command with deadline bit set. The deadline
+ * is a CLOCK_MONOTONIC time in ns following the timestamps when
+ * stat_enabled is set, otherwise following the payload.
+ */
+static inline uint64_t *
+ert_start_kernel_deadline(struct ert_start_kernel_cmd *pkt)
+{
+  char *deadline = (char *)ert_start_kernel_timestamps(pkt);
+  if (pkt->stat_enabled)
+    deadline += sizeof(struct cu_cmd_state_timestamps);
+  return (uint64_t *)deadline;
+}
+
+/* Return 0 if this pkt doesn't support timestamp and deadline or disabled */
 static inline int
 get_size_with_timestamps_or_zero(struct ert_packet *pkt)
 {
@@ -880,6 +1036,10 @@ get_size_with_timestamps_or_zero(struct ert_packet *pkt)
       size = (char *)ert_start_kernel_timestamps(skcmd) - (char *)pkt;
       size += sizeof(struct cu_cmd_state_timestamps);
     }
+    if (skcmd->deadline) {
+      size = (char *)ert_start_kernel_deadline(skcmd) - (char *)pkt;
+      size += sizeof(uint64_t);
+    }
   }
 
   return size;
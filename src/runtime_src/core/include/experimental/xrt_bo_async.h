@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_ASYNC_H_
+#define _XRT_BO_ASYNC_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "experimental/xrt_enqueue.h"
+
+#ifdef __cplusplus
+# include <future>
+# include <string>
+# include <vector>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+namespace aie { class bo; }
+
+/**
+ * struct sync_range - Buffer object range to sync
+ *
+ * @bo:     Buffer object to sync
+ * @dir:    Direction of sync
+ * @size:   Size in bytes to sync
+ * @offset: Offset in bytes into buffer object
+ */
+struct sync_range
+{
+  xrt::bo bo;
+  xclBOSyncDirection dir;
+  size_t size;
+  size_t offset;
+
+  sync_range(xrt::bo b, xclBOSyncDirection d, size_t sz, size_t off)
+    : bo(std::move(b)), dir(d), size(sz), offset(off)
+  {}
+
+  sync_range(xrt::bo b, xclBOSyncDirection d)
+    : bo(std::move(b)), dir(d), size(bo.size()), offset(0)
+  {}
+};
+
+/**
+ * class sync_event - Event for an asynchronous buffer sync
+ *
+ * A sync_event is an ``xrt::event`` and can be used as a dependency
+ * of operations enqueued on an ``xrt::event_queue``.  In addition to
+ * waiting on the event, ``get()`` rethrows an error from the sync.
+ */
+class sync_event : public event
+{
+  std::shared_future<void> m_result;
+
+public:
+  sync_event() = default;
+
+  sync_event(event ev, std::shared_future<void> result)
+    : event(std::move(ev)), m_result(std::move(result))
+  {}
+
+  /**
+   * get() - Wait for sync to complete and rethrow any error
+   */
+  void
+  get() const
+  {
+    m_result.get();
+  }
+};
+
+/**
+ * async_sync() - Sync a buffer object asynchronously
+ *
+ * @param bo
+ *  Buffer object to sync
+ * @param dir
+ *  Direction of sync
+ * @param size
+ *  Size in bytes to sync
+ * @param offset
+ *  Offset in bytes into buffer object
+ * @return
+ *  Event that is complete when the sync is done
+ *
+ * The sync is submitted to the shim's DMA queue if the shim supports
+ * asynchronous syncs, otherwise it is executed by an XRT sync worker
+ * thread, see xrt.ini Runtime.bo_sync_threads.  Setting
+ * Runtime.bo_sync_threads to 0 executes the sync inline.
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    auto ev = xrt::async_sync(in, XCL_BO_SYNC_BO_TO_DEVICE, in.size(), 0);
+ *    auto run = queue.enqueue_with_waitlist(kernel, {ev}, in, out);
+ */
+XCL_DRIVER_DLLESPEC
+sync_event
+async_sync(const xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t offset);
+
+/**
+ * async_sync() - Sync entire buffer object asynchronously
+ */
+inline sync_event
+async_sync(const xrt::bo& bo, xclBOSyncDirection dir)
+{
+  return async_sync(bo, dir, bo.size(), 0);
+}
+
+/**
+ * sync_batch() - Sync many buffer object ranges asynchronously
+ *
+ * @param ranges
+ *  Buffer object ranges to sync
+ * @return
+ *  Event that is complete when all ranges are synced
+ *
+ * The ranges are synced in order by one sync worker, and the sync
+ * stops at the first failing range.
+ */
+XCL_DRIVER_DLLESPEC
+sync_event
+sync_batch(std::vector<sync_range> ranges);
+
+/**
+ * async_copy() - Copy between buffer objects asynchronously
+ *
+ * @param dst
+ *  Destination buffer object
+ * @param src
+ *  Source buffer object
+ * @param size
+ *  Size in bytes to copy
+ * @param dst_offset
+ *  Offset in bytes into destination buffer object
+ * @param src_offset
+ *  Offset in bytes into source buffer object
+ * @return
+ *  Event that is complete when the copy is done
+ *
+ * The copy is executed by an XRT sync worker thread the same way as
+ * ``xrt::bo::copy()``, using the M2M engine, KDMA or a copy through
+ * host, whichever is available.  Copies and syncs submitted before
+ * the copy are not waited for; use the event of a prior operation to
+ * order the copy, e.g. by waiting on it or by enqueueing the copy on
+ * an ``xrt::event_queue``.  Setting Runtime.bo_sync_threads to 0
+ * executes the copy inline.
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    auto ev = xrt::async_copy(staging, in, in.size(), 0, 0);
+ *    auto run = queue.enqueue_with_waitlist(kernel, {ev}, staging, out);
+ */
+XCL_DRIVER_DLLESPEC
+sync_event
+async_copy(const xrt::bo& dst, const xrt::bo& src, size_t size,
+           size_t dst_offset, size_t src_offset);
+
+/**
+ * async_copy() - Copy entire buffer object asynchronously
+ */
+inline sync_event
+async_copy(const xrt::bo& dst, const xrt::bo& src)
+{
+  return async_copy(dst, src, src.size(), 0, 0);
+}
+
+namespace aie {
+
+/**
+ * async_sync() - Transfer data between BO and GMIO port asynchronously
+ *
+ * @param bo
+ *  Buffer object to transfer
+ * @param port
+ *  GMIO port name
+ * @param dir
+ *  GM to AIE or AIE to GM
+ * @param size
+ *  Size in bytes to transfer
+ * @param offset
+ *  Offset in bytes into buffer object
+ * @return
+ *  Event that is complete when the transfer is done
+ *
+ * The transfer is enqueued to the shim DMA channel of the GMIO port
+ * before the function returns, so transfers on one port execute in
+ * the order they are submitted.  Several transfers can be in flight
+ * on a channel, up to the number of buffer descriptors of the DMA or
+ * Runtime.gmio_queue_depth if set; submitting beyond that blocks
+ * until a descriptor is free.  Completion is detected by an XRT sync
+ * worker.
+ *
+ * Only supported on platforms with AIE.
+ */
+XCL_DRIVER_DLLESPEC
+sync_event
+async_sync(const xrt::aie::bo& bo, const std::string& port, xclBOSyncDirection dir,
+           size_t size, size_t offset);
+
+/**
+ * async_sync() - Transfer entire buffer object to or from GMIO port asynchronously
+ */
+XCL_DRIVER_DLLESPEC
+sync_event
+async_sync(const xrt::aie::bo& bo, const std::string& port, xclBOSyncDirection dir);
+
+} // aie
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_CACHE_H_
+#define _XRT_BO_CACHE_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_uuid.h"
+#include "xrt/detail/pimpl.h"
+
+#ifdef __cplusplus
+# include <cstdint>
+# include <string>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/*!
+ * @class bo_content_cache
+ *
+ * @brief
+ * xrt::bo_content_cache keeps read-only input buffers resident on a
+ * device, keyed by their content.
+ *
+ * @details
+ * ``get()`` returns a buffer object in the requested memory bank
+ * with the specified content already synced to the device.  The
+ * first lookup of a key allocates the buffer and uploads the
+ * content, subsequent lookups return the same buffer without any
+ * transfer.  The key is either supplied by the caller, e.g. a model
+ * name and version, or computed as a 128-bit hash of the content.
+ *
+ * Buffers returned by the cache are shared by all users of the key
+ * and must be treated as read-only by both host and kernels.
+ *
+ * The cache retains buffers up to its capacity.  When the capacity
+ * is exceeded, or when allocation of a new buffer fails, least
+ * recently used buffers that are not referenced outside the cache
+ * are evicted.  Buffers still in use by the application are never
+ * evicted.
+ *
+ * A shared cache publishes its buffers in a registry under
+ * ``/dev/shm/xrt_bo_cache``, per device and xclbin.  A lookup that
+ * misses in the process imports the buffer exported by another
+ * process with the same key rather than uploading it again.
+ * Importing requires pidfd support and permission to access the
+ * exporting process (same user).  If the import fails, for example
+ * because the exporting process has exited, the content is uploaded
+ * and published by the calling process.  Shared caching is
+ * supported on Linux only.
+ *
+ * The cache is bound to the xclbin that is loaded when it is
+ * constructed and must be destroyed before a different xclbin is
+ * loaded on the device.
+ */
+class bo_content_cache_impl;
+class bo_content_cache : public detail::pimpl<bo_content_cache_impl>
+{
+public:
+  /**
+   * @struct stats
+   *
+   * @brief
+   * Cache counters
+   *
+   * @var lookups
+   *  Number of calls to ``get()``
+   * @var hits
+   *  Lookups served by a buffer in this process
+   * @var imports
+   *  Lookups served by importing a buffer from another process
+   * @var misses
+   *  Lookups that allocated a buffer and uploaded the content
+   * @var evictions
+   *  Buffers evicted because of capacity or allocation failure
+   * @var buffers
+   *  Number of buffers currently in the cache
+   * @var bytes
+   *  Bytes of buffers currently in the cache
+   */
+  struct stats
+  {
+    uint64_t lookups;
+    uint64_t hits;
+    uint64_t imports;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t buffers;
+    uint64_t bytes;
+  };
+
+  /**
+   * bo_content_cache() - Construct empty cache object
+   */
+  bo_content_cache() = default;
+
+  /**
+   * bo_content_cache() - Construct cache for a device
+   *
+   * @param device
+   *  Device on which buffers are cached
+   * @param xclbin_id
+   *  UUID of the xclbin loaded on the device
+   * @param capacity
+   *  Maximum bytes of buffers retained by the cache, 0 for no limit
+   * @param shared
+   *  Share buffers with other processes using a shared cache for the
+   *  same device and xclbin
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_content_cache(const xrt::device& device, const xrt::uuid& xclbin_id,
+                   size_t capacity = 0, bool shared = false);
+
+  /**
+   * get() - Get buffer with content, keyed by hash of content
+   *
+   * @param data
+   *  Content of buffer
+   * @param size
+   *  Size of content in bytes
+   * @param grp
+   *  Memory group (bank) of buffer, e.g. ``kernel.group_id(arg)``
+   * @return
+   *  Buffer object with content synced to device
+   *
+   * The content is hashed on every call, use the keyed variant to
+   * avoid hashing large inputs.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  get(const void* data, size_t size, xrt::memory_group grp);
+
+  /**
+   * get() - Get buffer with content, keyed by caller
+   *
+   * @param key
+   *  Key uniquely identifying the content
+   * @param data
+   *  Content of buffer, only read if the key is not cached
+   * @param size
+   *  Size of content in bytes
+   * @param grp
+   *  Memory group (bank) of buffer
+   * @return
+   *  Buffer object with content synced to device
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  get(const std::string& key, const void* data, size_t size, xrt::memory_group grp);
+
+  /**
+   * set_capacity() - Set maximum bytes of buffers retained by cache
+   *
+   * @param bytes
+   *  Capacity in bytes, 0 for no limit
+   *
+   * Unreferenced buffers are evicted until the cache is within its
+   * new capacity.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  set_capacity(size_t bytes);
+
+  /**
+   * clear() - Evict all buffers not referenced outside the cache
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  clear();
+
+  /**
+   * get_stats() - Get cache counters
+   */
+  XCL_DRIVER_DLLESPEC
+  stats
+  get_stats() const;
+};
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_DIRTY_H_
+#define _XRT_BO_DIRTY_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/**
+ * mark_dirty() - Record a modified range of a mapped buffer object
+ *
+ * @param bo
+ *  Buffer object whose host mapping was modified
+ * @param size
+ *  Size in bytes of modified range
+ * @param offset
+ *  Offset in bytes into buffer object of modified range
+ *
+ * Buffer objects track dirty ranges only when ranges are marked
+ * explicitly.  Marked ranges are rounded out to page boundaries and
+ * overlapping or adjacent ranges are merged, so the number of
+ * recorded ranges stays bounded by the number of disjoint modified
+ * regions.
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    auto table = bo.map<float*>();
+ *    for (auto row : updated_rows) {
+ *      update(table + row * row_size);
+ *      xrt::mark_dirty(bo, row_size * sizeof(float), row * row_size * sizeof(float));
+ *    }
+ *    xrt::sync_dirty(bo);
+ */
+XCL_DRIVER_DLLESPEC
+void
+mark_dirty(const xrt::bo& bo, size_t size, size_t offset);
+
+/**
+ * sync_dirty() - Sync dirty ranges of buffer object to device
+ *
+ * @param bo
+ *  Buffer object to sync
+ * @return
+ *  Number of bytes synced
+ *
+ * Each recorded dirty range is synced to device with one transfer,
+ * and the recorded ranges are cleared.  If a sync fails, the ranges
+ * that were not synced remain recorded.
+ */
+XCL_DRIVER_DLLESPEC
+size_t
+sync_dirty(const xrt::bo& bo);
+
+/**
+ * clear_dirty() - Discard dirty ranges of buffer object
+ *
+ * @param bo
+ *  Buffer object whose recorded ranges are discarded, for example
+ *  after the buffer was synced in full.
+ */
+XCL_DRIVER_DLLESPEC
+void
+clear_dirty(const xrt::bo& bo);
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
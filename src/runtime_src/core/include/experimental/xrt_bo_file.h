@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_FILE_H_
+#define _XRT_BO_FILE_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+
+#ifdef __cplusplus
+# include <chrono>
+# include <cstdint>
+# include <string>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/**
+ * struct file_io_options - Options for file transfers to and from buffers
+ *
+ * @request_size:  Maximum bytes per I/O request
+ * @queue_depth:   Maximum number of I/O requests in flight
+ * @direct:        Open file with O_DIRECT, bypassing the page cache
+ *
+ * Requests never cross a P2P BAR window of the buffer.  If the file
+ * cannot be opened for direct I/O, or if the file offset or buffer
+ * offset is not aligned to 4KB, the transfer falls back to buffered
+ * I/O.
+ */
+struct file_io_options
+{
+  size_t request_size = 4 * 1024 * 1024;
+  unsigned int queue_depth = 32;
+  bool direct = true;
+};
+
+/**
+ * struct file_io_stats - Counters of a file transfer
+ *
+ * @bytes:     Bytes transferred, less than requested if a read hits EOF
+ * @requests:  Number of I/O requests issued
+ * @direct:    True if data was transferred with direct I/O
+ * @duration:  Wall time of the transfer
+ */
+struct file_io_stats
+{
+  uint64_t bytes = 0;
+  uint64_t requests = 0;
+  bool direct = false;
+  std::chrono::nanoseconds duration {0};
+
+  /**
+   * bandwidth() - Throughput of the transfer in GB/s
+   */
+  double
+  bandwidth() const
+  {
+    return duration.count() ? static_cast<double>(bytes) / duration.count() : 0.0;
+  }
+};
+
+/**
+ * read_file() - Read file content into a buffer object
+ *
+ * @param bo
+ *  Destination buffer object
+ * @param path
+ *  File to read
+ * @param size
+ *  Bytes to read
+ * @param file_offset
+ *  Offset in bytes into file
+ * @param bo_offset
+ *  Offset in bytes into buffer object
+ * @param options
+ *  Transfer options
+ * @return
+ *  Transfer counters
+ *
+ * For a P2P buffer (``xrt::bo::flags::p2p``), the file is read
+ * directly into device memory through the P2P BAR mapping of the
+ * buffer; with direct I/O from an NVMe device the data does not pass
+ * through host memory.  Other buffers are read into their host
+ * backing and synced to the device.
+ *
+ * Many requests are kept in flight using Linux native asynchronous
+ * I/O.  Supported on Linux only.
+ */
+XCL_DRIVER_DLLESPEC
+file_io_stats
+read_file(const xrt::bo& bo, const std::string& path, size_t size,
+          uint64_t file_offset = 0, size_t bo_offset = 0,
+          const file_io_options& options = {});
+
+/**
+ * write_file() - Write buffer object content to a file
+ *
+ * @param bo
+ *  Source buffer object
+ * @param path
+ *  File to write, created if it does not exist
+ * @param size
+ *  Bytes to write
+ * @param file_offset
+ *  Offset in bytes into file
+ * @param bo_offset
+ *  Offset in bytes into buffer object
+ * @param options
+ *  Transfer options
+ * @return
+ *  Transfer counters
+ *
+ * A buffer other than a P2P buffer is synced from the device before
+ * its host backing is written to the file.  Supported on Linux only.
+ */
+XCL_DRIVER_DLLESPEC
+file_io_stats
+write_file(const xrt::bo& bo, const std::string& path, size_t size,
+           uint64_t file_offset = 0, size_t bo_offset = 0,
+           const file_io_options& options = {});
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_FILL_H_
+#define _XRT_BO_FILL_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "experimental/xrt_bo_async.h"
+
+#ifdef __cplusplus
+# include <type_traits>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/**
+ * fill() - Fill a range of a buffer object with a repeated pattern
+ *
+ * @param bo
+ *  Buffer object to fill
+ * @param pattern
+ *  Pointer to pattern
+ * @param pattern_size
+ *  Size in bytes of pattern
+ * @param size
+ *  Size in bytes of range to fill, must be a multiple of pattern size
+ * @param offset
+ *  Offset in bytes into buffer object of range to fill
+ *
+ * If the device supports device side buffer copies (M2M or KDMA),
+ * only the first 64KB of the range is transferred from host, and the
+ * remainder is filled by device side copies that double the filled
+ * range with each copy.  In that case the host side buffer of the
+ * buffer object is not updated, use ``sync(XCL_BO_SYNC_BO_FROM_DEVICE)``
+ * to access the filled content from host.
+ *
+ * Without device side copies, the range is filled in host memory and
+ * synced to device.
+ */
+XCL_DRIVER_DLLESPEC
+void
+fill(const xrt::bo& bo, const void* pattern, size_t pattern_size, size_t size, size_t offset);
+
+/**
+ * fill() - Fill a range of a buffer object with a repeated value
+ */
+template <typename ValueType>
+inline void
+fill(const xrt::bo& bo, const ValueType& value, size_t size, size_t offset)
+{
+  static_assert(std::is_trivially_copyable<ValueType>::value, "fill value must be trivially copyable");
+  fill(bo, &value, sizeof(ValueType), size, offset);
+}
+
+/**
+ * fill() - Fill entire buffer object with a repeated value
+ */
+template <typename ValueType>
+inline void
+fill(const xrt::bo& bo, const ValueType& value)
+{
+  fill(bo, value, bo.size(), 0);
+}
+
+/**
+ * async_fill() - Fill a range of a buffer object asynchronously
+ *
+ * @return
+ *  Event that is complete when the fill is done
+ *
+ * Same as ``fill()``, but executed by an XRT sync worker thread, see
+ * xrt.ini Runtime.bo_sync_threads.  The pattern is copied and can be
+ * released when this function returns.
+ */
+XCL_DRIVER_DLLESPEC
+sync_event
+async_fill(const xrt::bo& bo, const void* pattern, size_t pattern_size, size_t size, size_t offset);
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
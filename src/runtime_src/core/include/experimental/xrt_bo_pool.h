@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_POOL_H_
+#define _XRT_BO_POOL_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/detail/pimpl.h"
+
+#ifdef __cplusplus
+# include <cstdint>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/*!
+ * @class bo_pool
+ *
+ * @brief
+ * xrt::bo_pool recycles buffer objects of one memory bank and type.
+ *
+ * @details
+ * Buffer objects allocated from a pool are backed by a buffer of the
+ * requested size rounded up to a size class.  When the last reference
+ * to a pooled buffer object is released, the backing buffer is
+ * returned to the pool rather than freed, and subsequent allocations
+ * of the same size class reuse it without calling the driver.
+ *
+ * Size classes are powers of two from 4KB to 1MB, and multiples of 1MB
+ * for larger buffers.
+ *
+ * Idle buffers retained by the pool are bounded by a high water mark.
+ * A buffer returned to a pool that is above its high water mark is
+ * freed.  ``trim()`` frees idle buffers until the pool is at or below
+ * its low water mark.
+ *
+ * A pooled buffer object behaves as a regular buffer object, except
+ * that its content is not cleared when it is reused.
+ */
+class bo_pool_impl;
+class bo_pool : public detail::pimpl<bo_pool_impl>
+{
+public:
+  /**
+   * @struct stats
+   *
+   * @brief
+   * Pool counters
+   *
+   * @var allocs
+   *  Number of calls to ``alloc()``
+   * @var hits
+   *  Allocations served by an idle buffer in the pool
+   * @var misses
+   *  Allocations that allocated a new buffer from the driver
+   * @var freed
+   *  Idle buffers freed to the driver, because of high water mark or trim
+   * @var idle_buffers
+   *  Number of idle buffers currently in the pool
+   * @var idle_bytes
+   *  Bytes of idle buffers currently in the pool
+   */
+  struct stats
+  {
+    uint64_t allocs;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t freed;
+    uint64_t idle_buffers;
+    uint64_t idle_bytes;
+  };
+
+  /**
+   * bo_pool() - Construct empty pool object
+   */
+  bo_pool() = default;
+
+  /**
+   * bo_pool() - Construct pool for a memory bank
+   *
+   * @param device
+   *  Device on which buffers are allocated
+   * @param grp
+   *  Memory group (bank) of buffers, e.g. ``kernel.group_id(arg)``
+   * @param flags
+   *  Type of buffers
+   *
+   * The pool is constructed without high water mark, it retains all
+   * returned buffers until trimmed.
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_pool(const xrt::device& device, xrt::memory_group grp, xrt::bo::flags flags = xrt::bo::flags::normal);
+
+  /**
+   * alloc() - Allocate a buffer object from the pool
+   *
+   * @param size
+   *  Size of buffer object in bytes
+   * @return
+   *  Buffer object of requested size
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  alloc(size_t size);
+
+  /**
+   * set_watermarks() - Set bounds of idle buffer bytes
+   *
+   * @param low
+   *  Idle bytes to retain when trimming the pool
+   * @param high
+   *  Maximum idle bytes retained by the pool, 0 for no limit
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  set_watermarks(size_t low, size_t high);
+
+  /**
+   * trim() - Free idle buffers down to low water mark
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  trim();
+
+  /**
+   * get_stats() - Get pool counters
+   */
+  XCL_DRIVER_DLLESPEC
+  stats
+  get_stats() const;
+};
+
+/*!
+ * @class bo_arena
+ *
+ * @brief
+ * xrt::bo_arena is a bump allocator in a buffer reserved up front.
+ *
+ * @details
+ * The arena reserves one buffer of its full capacity when it is
+ * constructed, typically at service startup before the memory bank
+ * becomes fragmented by other allocations.  Buffer objects allocated
+ * from the arena are sub-buffers of the reserved buffer, carved out
+ * at increasing offsets, so allocation never fails because of
+ * fragmentation and never calls the driver.
+ *
+ * Individual buffers are not freed back to the arena; ``reset()``
+ * makes the entire capacity available again.  It is the caller's
+ * responsibility to not use buffers allocated before ``reset()``
+ * once new buffers are allocated.
+ */
+class bo_arena_impl;
+class bo_arena : public detail::pimpl<bo_arena_impl>
+{
+public:
+  /**
+   * bo_arena() - Construct empty arena object
+   */
+  bo_arena() = default;
+
+  /**
+   * bo_arena() - Construct arena and reserve its buffer
+   *
+   * @param device
+   *  Device on which the arena buffer is allocated
+   * @param capacity
+   *  Size in bytes of the arena buffer
+   * @param grp
+   *  Memory group (bank) of the arena buffer
+   * @param flags
+   *  Type of the arena buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_arena(const xrt::device& device, size_t capacity, xrt::memory_group grp,
+           xrt::bo::flags flags = xrt::bo::flags::normal);
+
+  /**
+   * alloc() - Allocate a buffer object from the arena
+   *
+   * @param size
+   *  Size of buffer object in bytes
+   * @param align
+   *  Alignment in bytes of the buffer offset within the arena
+   * @return
+   *  Sub-buffer of the arena buffer
+   *
+   * Throws if the arena does not have capacity for the buffer.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  alloc(size_t size, size_t align = 4096);
+
+  /**
+   * reset() - Make entire capacity available for allocation
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  reset();
+
+  /**
+   * used() - Bytes allocated from the arena since construction or reset
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  used() const;
+
+  /**
+   * capacity() - Size in bytes of the arena buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  capacity() const;
+};
+
+/*!
+ * @class bo_heap
+ *
+ * @brief
+ * xrt::bo_heap sub-allocates buffer objects from a buffer reserved up
+ * front, and takes them back when they are released.
+ *
+ * @details
+ * Like the arena, the heap reserves one buffer of its full capacity
+ * when it is constructed and allocates sub-buffers of it without
+ * calling the driver.  Unlike the arena, the range of a buffer object
+ * is returned to the heap when the last reference to the buffer
+ * object is released, and adjacent free ranges are merged.
+ * Allocation takes the smallest free range that fits.
+ *
+ * A heap in the host memory bank, with ``xrt::bo::flags::host_only``,
+ * lets slave bridge kernels use large host memory buffers for the
+ * life of an application.  The bank is reserved once, when the heap
+ * is constructed, and buffers then never fail to allocate because of
+ * the state of the driver's allocator.  See xrt.ini
+ * Runtime.host_mem_hugetlbfs for backing the host memory bank with
+ * pre-reserved huge pages.
+ */
+class bo_heap_impl;
+class bo_heap : public detail::pimpl<bo_heap_impl>
+{
+public:
+  /**
+   * bo_heap() - Construct empty heap object
+   */
+  bo_heap() = default;
+
+  /**
+   * bo_heap() - Construct heap and reserve its buffer
+   *
+   * @param device
+   *  Device on which the heap buffer is allocated
+   * @param capacity
+   *  Size in bytes of the heap buffer
+   * @param grp
+   *  Memory group (bank) of the heap buffer
+   * @param flags
+   *  Type of the heap buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  bo_heap(const xrt::device& device, size_t capacity, xrt::memory_group grp,
+          xrt::bo::flags flags = xrt::bo::flags::normal);
+
+  /**
+   * alloc() - Allocate a buffer object from the heap
+   *
+   * @param size
+   *  Size of buffer object in bytes
+   * @param align
+   *  Alignment in bytes of the buffer offset within the heap
+   * @return
+   *  Sub-buffer of the heap buffer
+   *
+   * Throws if the heap has no free range for the buffer.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  alloc(size_t size, size_t align = 4096);
+
+  /**
+   * used() - Bytes of buffer objects currently allocated from the heap
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  used() const;
+
+  /**
+   * largest_free() - Size in bytes of the largest free range
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  largest_free() const;
+
+  /**
+   * capacity() - Size in bytes of the heap buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  capacity() const;
+};
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_BO_STRIPED_H_
+#define _XRT_BO_STRIPED_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/detail/pimpl.h"
+
+#ifdef __cplusplus
+# include <vector>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/*!
+ * @class striped_bo
+ *
+ * @brief
+ * xrt::striped_bo is a logical buffer interleaved across memory banks.
+ *
+ * @details
+ * The logical buffer is divided into stripes of a fixed size, and
+ * stripe ``i`` is placed in bank ``i % num_banks()`` at offset
+ * ``(i / num_banks()) * stripe_size()`` of that bank's buffer object.
+ * A kernel reads the banks in parallel through one argument per
+ * bank, using ``get_bank_bo()`` of each bank as the argument value.
+ *
+ * Host access to the logical buffer is through ``write()`` and
+ * ``read()``, which scatter and gather stripes.  ``sync()`` syncs all
+ * banks with transfers that are issued in parallel.
+ */
+class striped_bo_impl;
+class striped_bo : public detail::pimpl<striped_bo_impl>
+{
+public:
+  /**
+   * striped_bo() - Construct empty striped buffer object
+   */
+  striped_bo() = default;
+
+  /**
+   * striped_bo() - Construct striped buffer object
+   *
+   * @param device
+   *  Device on which buffers are allocated
+   * @param size
+   *  Size in bytes of the logical buffer
+   * @param banks
+   *  Memory groups (banks) to interleave, e.g. kernel.group_id() of
+   *  each kernel argument reading the buffer
+   * @param stripe_size
+   *  Size in bytes of a stripe
+   */
+  XCL_DRIVER_DLLESPEC
+  striped_bo(const xrt::device& device, size_t size, const std::vector<xrt::memory_group>& banks,
+             size_t stripe_size);
+
+  /**
+   * size() - Size in bytes of the logical buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  size() const;
+
+  /**
+   * stripe_size() - Size in bytes of a stripe
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  stripe_size() const;
+
+  /**
+   * num_banks() - Number of banks the buffer is interleaved across
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  num_banks() const;
+
+  /**
+   * get_bank_bo() - Buffer object holding the stripes of a bank
+   *
+   * @param idx
+   *  Index of bank in the banks the buffer was constructed with
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  get_bank_bo(size_t idx) const;
+
+  /**
+   * write() - Copy host data into the logical buffer
+   *
+   * @param src
+   *  Source data pointer
+   * @param size
+   *  Size in bytes of data to copy
+   * @param seek
+   *  Offset in bytes into the logical buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  write(const void* src, size_t size, size_t seek);
+
+  /**
+   * read() - Copy data from the logical buffer to host
+   *
+   * @param dst
+   *  Destination data pointer
+   * @param size
+   *  Size in bytes of data to copy
+   * @param skip
+   *  Offset in bytes into the logical buffer
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  read(void* dst, size_t size, size_t skip);
+
+  /**
+   * sync() - Sync all banks of the buffer
+   *
+   * @param dir
+   *  Direction of sync
+   *
+   * The bank syncs are executed in parallel by XRT sync worker
+   * threads, see xrt.ini Runtime.bo_sync_threads.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync(xclBOSyncDirection dir);
+};
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
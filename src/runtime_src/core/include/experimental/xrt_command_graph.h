@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_COMMAND_GRAPH_H_
+#define _XRT_COMMAND_GRAPH_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "xrt/detail/pimpl.h"
+
+#ifdef __cplusplus
+# include <chrono>
+# include <condition_variable>
+# include <cstdint>
+# include <vector>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/*!
+ * @class command_graph
+ *
+ * @brief
+ * xrt::command_graph is a recorded DAG of kernel runs, buffer syncs
+ * and buffer copies that can be replayed many times.
+ *
+ * @details
+ * Nodes are recorded once along with their dependencies on other
+ * nodes.  A node can depend only on nodes recorded before it, so the
+ * graph is acyclic by construction.  Once recorded, a graph is
+ * replayed with a single call.  A run node is started when all its
+ * dependencies have completed, and completion of a run node is
+ * observed by XRT's command completion path, so no host thread is
+ * involved in sequencing the graph while it replays.
+ *
+ * Run objects are captured by reference.  The command packet of a
+ * run node is the packet of the run object, so arguments set on the
+ * run object before replay take effect in the next replay.  A run
+ * object can be recorded only once per graph.
+ *
+ * Sync and copy nodes are executed by XRT's completion thread when
+ * their dependencies are satisfied.
+ *
+ * If a node fails, nodes that depend on it are skipped.  The error
+ * is reported by ``wait()``.
+ */
+class command_graph_impl;
+class command_graph : public detail::pimpl<command_graph_impl>
+{
+public:
+  /**
+   * @typedef node
+   *
+   * @brief
+   * Handle to a node in the graph, used to express dependencies
+   */
+  using node = uint32_t;
+
+  /**
+   * command_graph() - Construct empty graph object
+   */
+  command_graph() = default;
+
+  /**
+   * command_graph() - Construct graph for a device
+   *
+   * @param device
+   *  Device on which run objects in the graph execute
+   */
+  XCL_DRIVER_DLLESPEC
+  explicit
+  command_graph(const xrt::device& device);
+
+  /**
+   * add_run() - Record a kernel run
+   *
+   * @param run
+   *  Run object to start when dependencies are satisfied
+   * @param deps
+   *  Nodes that must complete before the run is started
+   * @return
+   *  Node handle
+   */
+  XCL_DRIVER_DLLESPEC
+  node
+  add_run(const xrt::run& run, const std::vector<node>& deps = {});
+
+  /**
+   * add_sync() - Record a buffer object sync
+   *
+   * @param bo
+   *  Buffer object to sync
+   * @param dir
+   *  Direction of sync
+   * @param size
+   *  Size in bytes to sync
+   * @param offset
+   *  Offset in bytes into buffer object
+   * @param deps
+   *  Nodes that must complete before the sync
+   * @return
+   *  Node handle
+   */
+  XCL_DRIVER_DLLESPEC
+  node
+  add_sync(const xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t offset,
+           const std::vector<node>& deps = {});
+
+  /**
+   * add_sync() - Record a sync of the entire buffer object
+   */
+  node
+  add_sync(const xrt::bo& bo, xclBOSyncDirection dir, const std::vector<node>& deps = {})
+  {
+    return add_sync(bo, dir, bo.size(), 0, deps);
+  }
+
+  /**
+   * add_copy() - Record a buffer object copy
+   *
+   * @param dst
+   *  Destination buffer object
+   * @param src
+   *  Source buffer object
+   * @param size
+   *  Bytes to copy
+   * @param dst_offset
+   *  Offset in bytes into destination buffer
+   * @param src_offset
+   *  Offset in bytes into source buffer
+   * @param deps
+   *  Nodes that must complete before the copy
+   * @return
+   *  Node handle
+   */
+  XCL_DRIVER_DLLESPEC
+  node
+  add_copy(const xrt::bo& dst, const xrt::bo& src, size_t size,
+           size_t dst_offset, size_t src_offset, const std::vector<node>& deps = {});
+
+  /**
+   * replay() - Execute the graph
+   *
+   * This function is asynchronous, use ``wait()`` to wait for
+   * the graph to complete.  A graph cannot be replayed while it is
+   * executing.  Nodes cannot be recorded after the first replay.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  replay();
+
+  /**
+   * wait() - Wait for graph to complete
+   *
+   * @param timeout
+   *  Timeout for wait (default block till graph completes)
+   * @return
+   *  std::cv_status::timeout if the timeout expired before the graph
+   *  completed, std::cv_status::no_timeout otherwise.
+   *
+   * Throws the first error encountered while executing the graph.
+   */
+  XCL_DRIVER_DLLESPEC
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout = std::chrono::milliseconds{0}) const;
+
+  /**
+   * size() - Number of nodes in the graph
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  size() const;
+};
+
+} // xrt
+#endif
+
+#endif
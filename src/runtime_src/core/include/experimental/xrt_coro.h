@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_CORO_H_
+#define _XRT_CORO_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#ifdef __cplusplus
+# include <exception>
+# include <functional>
+# if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#  include <coroutine>
+#  define XRT_CORO_HAS_COROUTINE
+# endif
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt { namespace coro {
+
+namespace detail {
+
+/**
+ * start() - Start a run with one-shot completion notification
+ *
+ * The notification is called from XRT's command completion path,
+ * i.e. the device command monitor or a completion callback worker.
+ * It is not registered as a callback with the run object.
+ */
+XCL_DRIVER_DLLESPEC
+void
+start(const xrt::run& run, std::function<void(ert_cmd_state)> notify);
+
+/**
+ * dispatch() - Execute a function on XRT's completion callback workers
+ *
+ * The function is executed inline if completion callback workers
+ * are disabled.
+ */
+XCL_DRIVER_DLLESPEC
+void
+dispatch(std::function<void()> fcn);
+
+} // detail
+
+#ifdef XRT_CORO_HAS_COROUTINE
+
+/**
+ * class run_awaitable - Awaitable execution of a run object
+ *
+ * Starts the run when awaited and resumes the awaiting coroutine
+ * from XRT's command completion path when the run completes.  No
+ * thread is blocked while the run executes.  The value of the
+ * co_await expression is the completion state of the run.
+ *
+ * The coroutine is resumed on an XRT thread, it should not block
+ * for long before suspending again or completing.
+ */
+class run_awaitable
+{
+  xrt::run m_run;
+  ert_cmd_state m_state = ERT_CMD_STATE_NEW;
+
+public:
+  explicit
+  run_awaitable(xrt::run run)
+    : m_run(std::move(run))
+  {}
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void
+  await_suspend(std::coroutine_handle<> handle)
+  {
+    detail::start(m_run, [this, handle](ert_cmd_state state) {
+      m_state = state;
+      handle.resume();
+    });
+  }
+
+  ert_cmd_state
+  await_resume() const noexcept
+  {
+    return m_state;
+  }
+};
+
+/**
+ * class sync_awaitable - Awaitable sync of a buffer object
+ *
+ * Syncs the buffer on an XRT completion worker and resumes the
+ * awaiting coroutine on that worker when the sync is done.  An
+ * exception from the sync operation is rethrown from co_await.
+ */
+class sync_awaitable
+{
+  xrt::bo m_bo;
+  xclBOSyncDirection m_dir;
+  size_t m_size;
+  size_t m_offset;
+  std::exception_ptr m_error;
+
+public:
+  sync_awaitable(xrt::bo bo, xclBOSyncDirection dir, size_t size, size_t offset)
+    : m_bo(std::move(bo)), m_dir(dir), m_size(size), m_offset(offset)
+  {}
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void
+  await_suspend(std::coroutine_handle<> handle)
+  {
+    detail::dispatch([this, handle] {
+      try {
+        m_bo.sync(m_dir, m_size, m_offset);
+      }
+      catch (...) {
+        m_error = std::current_exception();
+      }
+      handle.resume();
+    });
+  }
+
+  void
+  await_resume() const
+  {
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+};
+
+/**
+ * async_start() - Start a run and await its completion
+ *
+ * @param run
+ *  Run object with arguments set
+ * @return
+ *  Awaitable, ``co_await`` yields the completion state of the run
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    auto state = co_await xrt::coro::async_start(run);
+ */
+inline run_awaitable
+async_start(const xrt::run& run)
+{
+  return run_awaitable{run};
+}
+
+/**
+ * async_sync() - Sync a buffer object and await completion
+ *
+ * @param bo
+ *  Buffer object to sync
+ * @param dir
+ *  Direction of sync operation
+ * @param size
+ *  Size in bytes to sync
+ * @param offset
+ *  Offset in bytes into buffer object
+ * @return
+ *  Awaitable, ``co_await`` rethrows any exception from the sync
+ */
+inline sync_awaitable
+async_sync(const xrt::bo& bo, xclBOSyncDirection dir, size_t size, size_t offset)
+{
+  return sync_awaitable{bo, dir, size, offset};
+}
+
+/**
+ * async_sync() - Sync entire buffer object and await completion
+ */
+inline sync_awaitable
+async_sync(const xrt::bo& bo, xclBOSyncDirection dir)
+{
+  return sync_awaitable{bo, dir, bo.size(), 0};
+}
+
+#endif // XRT_CORO_HAS_COROUTINE
+
+}} // coro, xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_DEVICE_ASYNC_H_
+#define _XRT_DEVICE_ASYNC_H_
+
+#include "xrt.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_uuid.h"
+#include "experimental/xrt_enqueue.h"
+#include "experimental/xrt_xclbin.h"
+
+#ifdef __cplusplus
+# include <functional>
+# include <future>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/**
+ * enum class load_stage - Progress of an asynchronous xclbin load
+ *
+ * @started:     Load has been picked up by the loader thread
+ * @downloading: Xclbin is being downloaded to the device
+ * @registered:  Xclbin is loaded and registered with the device
+ * @completed:   Load is complete, kernels can be constructed
+ * @failed:      Load failed, error is rethrown by ``load_event::get()``
+ */
+enum class load_stage { started, downloading, registered, completed, failed };
+
+/**
+ * typedef load_progress_callback - Called as a load progresses
+ *
+ * The callback is called from the loader thread and must not block.
+ */
+using load_progress_callback = std::function<void(load_stage)>;
+
+/**
+ * class load_event - Event for an asynchronous xclbin load
+ *
+ * A load_event is an ``xrt::event`` and can be used as a dependency
+ * of operations enqueued on an ``xrt::event_queue``.  In addition to
+ * waiting on the event, ``get()`` returns the uuid of the loaded
+ * xclbin or rethrows an error from the load.
+ */
+class load_event : public event
+{
+  std::shared_future<xrt::uuid> m_result;
+
+public:
+  load_event() = default;
+
+  load_event(event ev, std::shared_future<xrt::uuid> result)
+    : event(std::move(ev)), m_result(std::move(result))
+  {}
+
+  /**
+   * get() - Wait for load to complete and get xclbin uuid
+   */
+  xrt::uuid
+  get() const
+  {
+    return m_result.get();
+  }
+};
+
+/**
+ * load_xclbin_async() - Load an xclbin on a device asynchronously
+ *
+ * @param device
+ *  Device to load xclbin on
+ * @param xclbin
+ *  Xclbin to load
+ * @param progress
+ *  Optional callback called as the load progresses
+ * @return
+ *  Event that is complete when the xclbin is loaded
+ *
+ * The xclbin is downloaded by a separate thread while the calling
+ * thread continues with host side setup.  Meta data of the xclbin,
+ * e.g. memory topology and kernel arguments, is available from the
+ * xclbin object while the load is in progress.
+ *
+ * Construction of a kernel, and allocation of a buffer object, on
+ * the device waits for a pending load to complete, since both require
+ * the xclbin to be registered with the driver.  Only one load can be
+ * pending per device.
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    auto ev = xrt::load_xclbin_async(device, xclbin);
+ *    auto input = read_input_file();     // overlaps with load
+ *    auto uuid = ev.get();
+ *    xrt::kernel kernel{device, uuid, "vadd"};
+ */
+XCL_DRIVER_DLLESPEC
+load_event
+load_xclbin_async(const xrt::device& device, const xrt::xclbin& xclbin,
+                  load_progress_callback progress = nullptr);
+
+/**
+ * stage_xclbin() - Stage an xclbin for fast switching
+ *
+ * @param device
+ *  Device to stage xclbin on
+ * @param xclbin
+ *  Xclbin to stage
+ *
+ * The xclbin is validated and copied to the driver without
+ * programming the device, and its metadata is parsed once.  Use
+ * ``switch_xclbin()`` to load a staged xclbin by uuid, which
+ * programs the device from the staged copy.  Loading the same xclbin
+ * with ``xrt::device::load_xclbin()`` also uses the staged copy.
+ *
+ * The driver keeps a small number of staged xclbins and replaces the
+ * least recently used one when more are staged.  A replaced xclbin
+ * remains staged in the process and is copied to the driver in full
+ * when switched to.  Shims without staging support only keep the
+ * xclbin in the process.
+ */
+XCL_DRIVER_DLLESPEC
+void
+stage_xclbin(const xrt::device& device, const xrt::xclbin& xclbin);
+
+/**
+ * unstage_xclbin() - Release a staged xclbin
+ */
+XCL_DRIVER_DLLESPEC
+void
+unstage_xclbin(const xrt::device& device, const xrt::uuid& xclbin_id);
+
+/**
+ * switch_xclbin() - Load a staged xclbin
+ *
+ * @param device
+ *  Device to load xclbin on
+ * @param xclbin_id
+ *  Uuid of staged xclbin
+ *
+ * Throws if the xclbin is not staged.  As with any xclbin load, all
+ * kernels and buffers of the currently loaded xclbin must have been
+ * released.
+ */
+XCL_DRIVER_DLLESPEC
+void
+switch_xclbin(const xrt::device& device, const xrt::uuid& xclbin_id);
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_DEVICE_CLOCK_H_
+#define _XRT_DEVICE_CLOCK_H_
+
+#include "xrt.h"
+#include "xrt/xrt_device.h"
+
+#ifdef __cplusplus
+# include <chrono>
+# include <cstdint>
+#endif
+
+#ifdef __cplusplus
+
+/**
+ * Correlation of a device clock with host time
+ *
+ * XRT maintains one model per device that converts device clock
+ * ticks, e.g. timestamps of device trace, to host time.  The model
+ * is linear with drift correction and is trained from samples of the
+ * device clock taken at known host times.
+ *
+ * Device trace (xrt.ini Debug.device_trace) trains the model of the
+ * traced device continuously.  Applications that can observe a
+ * device clock by other means, e.g. a free running counter read from
+ * a kernel, can add their own samples.
+ *
+ * Host times are nanoseconds of std::chrono::steady_clock, the same
+ * clock used by ``xrt::run::get_timestamps()``.
+ */
+namespace xrt { namespace device_clock {
+
+/**
+ * device_to_host() - Convert device clock ticks to host time
+ *
+ * @param device
+ *  Device of the clock
+ * @param ticks
+ *  Device clock ticks
+ * @return
+ *  Host time corresponding to ticks
+ *
+ * The conversion is meaningful only when ``is_trained()`` is true.
+ */
+XCL_DRIVER_DLLESPEC
+std::chrono::steady_clock::time_point
+device_to_host(const xrt::device& device, uint64_t ticks);
+
+/**
+ * add_sample() - Train device clock model with a sample
+ *
+ * @param device
+ *  Device of the clock
+ * @param ticks
+ *  Device clock ticks
+ * @param host
+ *  Host time at which the device clock was ticks
+ */
+XCL_DRIVER_DLLESPEC
+void
+add_sample(const xrt::device& device, uint64_t ticks, std::chrono::steady_clock::time_point host);
+
+/**
+ * set_nominal_rate() - Set nominal rate of device clock
+ *
+ * @param device
+ *  Device of the clock
+ * @param mhz
+ *  Nominal clock rate in MHz
+ *
+ * The nominal rate is used until samples span long enough to fit
+ * the actual rate.  Device trace sets the rate of the trace clock.
+ */
+XCL_DRIVER_DLLESPEC
+void
+set_nominal_rate(const xrt::device& device, double mhz);
+
+/**
+ * is_trained() - Check if device clock model has been trained
+ *
+ * @param device
+ *  Device of the clock
+ * @return
+ *  True if at least one sample has been added
+ */
+XCL_DRIVER_DLLESPEC
+bool
+is_trained(const xrt::device& device);
+
+}} // device_clock, xrt
+
+#endif // __cplusplus
+
+#endif
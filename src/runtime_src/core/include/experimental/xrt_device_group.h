@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_DEVICE_GROUP_H_
+#define _XRT_DEVICE_GROUP_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "xrt/xrt_uuid.h"
+#include "experimental/xrt_xclbin.h"
+
+#ifdef __cplusplus
+# include <memory>
+# include <string>
+# include <utility>
+# include <vector>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/**
+ * class device_group - Group of identical devices sharing work
+ *
+ * A device group loads the same xclbin on all its devices and is
+ * used to construct replicated kernels (``xrt::group_kernel``) and
+ * buffer objects (``xrt::group_bo``).  Work submitted through a
+ * group kernel is sent to the device with fewest commands in flight.
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    xrt::device_group group{{0, 1, 2, 3}};
+ *    auto uuid = group.load_xclbin(xrt::xclbin{"vadd.xclbin"});
+ *    xrt::group_kernel vadd{group, uuid, "vadd"};
+ *    xrt::group_bo in{vadd, 0, size};
+ *    in.write(data);
+ *    in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+ *    auto gr = vadd(in, out, count);   // least loaded device
+ *    gr.run.wait();
+ *    out.get_bo(gr.device_index).sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+ */
+class device_group_impl;
+class device_group
+{
+public:
+  /**
+   * device_group() - Construct empty group
+   */
+  device_group() = default;
+
+  /**
+   * device_group() - Construct group from device indices
+   *
+   * @param indices
+   *  Indices of devices to include in the group
+   */
+  XCL_DRIVER_DLLESPEC
+  explicit
+  device_group(const std::vector<unsigned int>& indices);
+
+  /**
+   * device_group() - Construct group from opened devices
+   *
+   * @param devices
+   *  Devices to include in the group
+   */
+  XCL_DRIVER_DLLESPEC
+  explicit
+  device_group(std::vector<xrt::device> devices);
+
+  /**
+   * load_xclbin() - Load an xclbin on all devices of the group
+   *
+   * @param xclbin
+   *  Xclbin to load
+   * @return
+   *  UUID of the loaded xclbin
+   *
+   * The xclbin is loaded on all devices in parallel.  The function
+   * returns when all loads are complete and throws the first error
+   * if any load failed.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::uuid
+  load_xclbin(const xrt::xclbin& xclbin);
+
+  /**
+   * load_xclbin() - Load an xclbin file on all devices of the group
+   */
+  xrt::uuid
+  load_xclbin(const std::string& fnm)
+  {
+    return load_xclbin(xrt::xclbin{fnm});
+  }
+
+  /**
+   * size() - Number of devices in the group
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  size() const;
+
+  /**
+   * get_device() - Get device of the group
+   *
+   * @param index
+   *  Index of device within the group
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::device
+  get_device(size_t index) const;
+
+  /// @cond
+  const std::shared_ptr<device_group_impl>&
+  get_handle() const
+  {
+    return handle;
+  }
+  /// @endcond
+
+private:
+  std::shared_ptr<device_group_impl> handle;
+};
+
+class group_bo;
+
+/**
+ * struct group_run - Run started by a group kernel
+ *
+ * @device_index: Index of device in group that executes the run
+ * @run:          The run object
+ */
+struct group_run
+{
+  size_t device_index;
+  xrt::run run;
+};
+
+/**
+ * class group_kernel - Kernel replicated on all devices of a group
+ */
+class group_kernel_impl;
+class group_kernel
+{
+  template <typename ArgType>
+  static decltype(auto)
+  replica(ArgType&& arg, size_t)
+  {
+    return std::forward<ArgType>(arg);
+  }
+
+  XCL_DRIVER_DLLESPEC
+  static xrt::bo
+  replica(const group_bo& arg, size_t device_index);
+
+  static xrt::bo
+  replica(group_bo& arg, size_t device_index)
+  {
+    return replica(static_cast<const group_bo&>(arg), device_index);
+  }
+
+  static xrt::bo
+  replica(group_bo&& arg, size_t device_index)
+  {
+    return replica(static_cast<const group_bo&>(arg), device_index);
+  }
+
+public:
+  /**
+   * group_kernel() - Construct empty group kernel
+   */
+  group_kernel() = default;
+
+  /**
+   * group_kernel() - Construct kernel on all devices of group
+   *
+   * @param group
+   *  Device group with xclbin loaded
+   * @param xclbin_id
+   *  UUID of the xclbin with the kernel
+   * @param name
+   *  Name of kernel
+   * @param mode
+   *  Compute unit access mode
+   */
+  XCL_DRIVER_DLLESPEC
+  group_kernel(const device_group& group, const xrt::uuid& xclbin_id, const std::string& name,
+               xrt::kernel::cu_access_mode mode = xrt::kernel::cu_access_mode::shared);
+
+  /**
+   * get_kernel() - Get kernel replica of a device in the group
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::kernel
+  get_kernel(size_t device_index) const;
+
+  /**
+   * group_id() - Memory group of a kernel argument
+   *
+   * The devices of a group load the same xclbin so the group id is
+   * the same for all replicas.
+   */
+  XCL_DRIVER_DLLESPEC
+  int
+  group_id(int argno) const;
+
+  /**
+   * select_device() - Index of device with fewest runs in flight
+   *
+   * Only runs started through this group kernel are counted.
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  select_device() const;
+
+  /**
+   * operator() - Start a run on the least loaded device
+   *
+   * @param args
+   *  Kernel arguments, group buffer objects are replaced by the
+   *  replica of the selected device
+   * @return
+   *  The started run and the index of the device executing it
+   */
+  template <typename ...Args>
+  group_run
+  operator() (Args&&... args)
+  {
+    auto idx = select_device();
+    xrt::run run{get_kernel(idx)};
+    run(replica(std::forward<Args>(args), idx)...);
+    add_run(idx, run);
+    return {idx, std::move(run)};
+  }
+
+  /// @cond
+  const std::shared_ptr<group_kernel_impl>&
+  get_handle() const
+  {
+    return handle;
+  }
+  /// @endcond
+
+private:
+  XCL_DRIVER_DLLESPEC
+  void
+  add_run(size_t device_index, const xrt::run& run);
+
+  std::shared_ptr<group_kernel_impl> handle;
+};
+
+/**
+ * class group_bo - Buffer object replicated on all devices of a group
+ *
+ * Writes and syncs apply to all replicas.  Use ``get_bo()`` to
+ * access the replica of a device, e.g. to read the result of a run.
+ */
+class group_bo_impl;
+class group_bo
+{
+public:
+  /**
+   * group_bo() - Construct empty group buffer object
+   */
+  group_bo() = default;
+
+  /**
+   * group_bo() - Allocate buffer object on all devices of group
+   *
+   * @param group
+   *  Device group
+   * @param size
+   *  Size of buffer in bytes
+   * @param flags
+   *  Buffer object flags
+   * @param grp
+   *  Memory group, must be valid for all devices of the group
+   */
+  XCL_DRIVER_DLLESPEC
+  group_bo(const device_group& group, size_t size, xrt::bo::flags flags, xrt::memory_group grp);
+
+  /**
+   * group_bo() - Allocate buffer object for a kernel argument
+   *
+   * @param kernel
+   *  Group kernel
+   * @param argno
+   *  Kernel argument the buffer is used with
+   * @param size
+   *  Size of buffer in bytes
+   * @param flags
+   *  Buffer object flags
+   */
+  XCL_DRIVER_DLLESPEC
+  group_bo(const group_kernel& kernel, int argno, size_t size,
+           xrt::bo::flags flags = xrt::bo::flags::normal);
+
+  /**
+   * size() - Size of buffer object
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  size() const;
+
+  /**
+   * get_bo() - Get buffer object replica of a device in the group
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::bo
+  get_bo(size_t device_index) const;
+
+  /**
+   * write() - Write to the host buffer of all replicas
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  write(const void* src, size_t size, size_t seek);
+
+  /**
+   * write() - Write entire buffer of all replicas
+   */
+  void
+  write(const void* src)
+  {
+    write(src, size(), 0);
+  }
+
+  /**
+   * sync() - Sync all replicas
+   *
+   * The replicas are synced in parallel.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync(xclBOSyncDirection dir, size_t size, size_t offset);
+
+  /**
+   * sync() - Sync entire buffer of all replicas
+   */
+  void
+  sync(xclBOSyncDirection dir)
+  {
+    sync(dir, size(), 0);
+  }
+
+  /// @cond
+  const std::shared_ptr<group_bo_impl>&
+  get_handle() const
+  {
+    return handle;
+  }
+  /// @endcond
+
+private:
+  std::shared_ptr<group_bo_impl> handle;
+};
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
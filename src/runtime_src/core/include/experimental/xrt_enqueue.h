@@ -20,9 +20,11 @@
 
 #ifdef __cplusplus
 # include <algorithm>
+# include <cstddef>
 # include <functional>
 # include <future>
 # include <memory>
+# include <new>
 # include <type_traits>
 # include <vector>
 #endif
@@ -56,6 +58,9 @@ class event_queue
   friend class event_queue_impl;
   friend class event_impl;
   // class task - wraps a typed callable operation
+  //
+  // Callables that fit in the task object, e.g. a std::packaged_task,
+  // are stored inline without separate allocation.
   class task
   {
     using event_ptr = std::shared_ptr<event_impl>;
@@ -64,6 +69,7 @@ class event_queue
     {
       virtual ~task_iholder() {};
       virtual void execute(const event_ptr&) = 0;
+      virtual task_iholder* move_to(void* storage) = 0;
     };
 
     // Wrap synchronous operation
@@ -80,29 +86,101 @@ class event_queue
       {
         m_held(evp);               // synchronous function
       }
+
+      task_iholder* move_to(void* storage)
+      {
+        return new (storage) task_holder(std::move(m_held));
+      }
     };
 
-    std::unique_ptr<task_iholder> m_content;
+    static constexpr size_t inline_size = 6 * sizeof(void*);
+    alignas(std::max_align_t) unsigned char m_storage[inline_size];
+    task_iholder* m_content = nullptr;
+
+    template <typename Holder>
+    static constexpr bool
+    fits_inline()
+    {
+      return sizeof(Holder) <= inline_size
+        && alignof(Holder) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible<Holder>::value;
+    }
+
+    bool
+    is_inline() const
+    {
+      return static_cast<const void*>(m_content) == static_cast<const void*>(m_storage);
+    }
+
+    void
+    reset()
+    {
+      if (is_inline())
+        m_content->~task_iholder();
+      else
+        delete m_content;
+      m_content = nullptr;
+    }
+
+    void
+    take(task& rhs)
+    {
+      if (rhs.is_inline()) {
+        m_content = rhs.m_content->move_to(m_storage);
+        rhs.reset();
+      }
+      else {
+        m_content = rhs.m_content;
+        rhs.m_content = nullptr;
+      }
+    }
+
+    template <typename Holder, typename Callable>
+    task_iholder*
+    make_holder(Callable&& c, std::true_type)
+    {
+      return new (m_storage) Holder(std::forward<Callable>(c));
+    }
+
+    template <typename Holder, typename Callable>
+    task_iholder*
+    make_holder(Callable&& c, std::false_type)
+    {
+      return new Holder(std::forward<Callable>(c));
+    }
 
   public:
-    task() : m_content(nullptr)
+    task()
     {}
 
-    task(task&& rhs) : m_content(std::move(rhs.m_content))
-    {}
+    task(task&& rhs)
+    {
+      take(rhs);
+    }
+
+    ~task()
+    {
+      reset();
+    }
 
     // task() - task constructor for synchronous operation
     //
     // @c : callable object, a std::packaged_task
     template <typename Callable>
     task(Callable&& c)
-      : m_content(new task_holder<Callable>(std::forward<Callable>(c)))
-    {}
+    {
+      using holder = task_holder<std::decay_t<Callable>>;
+      m_content = make_holder<holder>
+        (std::forward<Callable>(c), std::integral_constant<bool, fits_inline<holder>()>{});
+    }
 
     task&
     operator=(task&& rhs)
     {
-      m_content = std::move(rhs.m_content);
+      if (this != &rhs) {
+        reset();
+        take(rhs);
+      }
       return *this;
     }
 
@@ -148,6 +226,15 @@ public:
     notify(event_impl*);
 
   public:
+    /// @cond
+    // Construct from implementation, used for events that are
+    // completed by an asynchronous operation outside any event queue
+    explicit
+    event(std::shared_ptr<event_impl> impl)
+      : m_impl(std::move(impl))
+    {}
+    /// @endcond
+
     const std::shared_ptr<event_impl>&
     get_impl() const
     {
@@ -22,9 +22,11 @@
 #include "xrt_device.h"
 
 #ifdef __cplusplus
+# include <chrono>
 # include <string>
 # include <memory>
 # include <cstdint>
+# include <vector>
 #endif
 
 #ifdef __cplusplus
@@ -86,6 +88,79 @@ private:
   std::shared_ptr<error_impl> handle;
 };
 
+/**
+ * class error_subscription - Subscription to asynchronous errors of a device
+ *
+ * An error subscription delivers asynchronous errors as they are
+ * recorded by the driver, so that health monitors can block rather
+ * than repeatedly query ``xrt::error`` for every error class.
+ *
+ * Errors recorded after the subscription is constructed are queued
+ * in a ring of fixed capacity.  If the application does not consume
+ * errors fast enough, the oldest queued errors are dropped and
+ * counted.
+ *
+ * On Linux, the subscription exposes an eventfd that is readable
+ * while errors are queued.  The fd can be added to an epoll set
+ * along with the fds of other devices.  The fd is owned by the
+ * subscription and must not be read or closed by the application.
+ */
+class error_subscription_impl;
+class error_subscription
+{
+public:
+  /**
+   * error_subscription() - Subscribe to asynchronous errors of a device
+   *
+   * @device:   Device to get asynchronous errors from
+   * @capacity: Maximum number of queued errors
+   */
+  XCL_DRIVER_DLLESPEC
+  explicit
+  error_subscription(const xrt::device& device, size_t capacity = 64);
+
+  /**
+   * get_fd() - Get fd to poll for queued errors
+   *
+   * Return:  eventfd that is readable while errors are queued,
+   *          or -1 if not supported on this platform
+   */
+  XCL_DRIVER_DLLESPEC
+  int
+  get_fd() const;
+
+  /**
+   * read() - Retrieve and remove all queued errors
+   *
+   * Return:  Queued errors, oldest first, possibly empty
+   *
+   * Does not block.
+   */
+  XCL_DRIVER_DLLESPEC
+  std::vector<error>
+  read();
+
+  /**
+   * wait() - Wait for errors and retrieve them
+   *
+   * @timeout:  Maximum time to wait, 0 to wait indefinitely
+   * Return:    Queued errors, oldest first, empty on timeout
+   */
+  XCL_DRIVER_DLLESPEC
+  std::vector<error>
+  wait(std::chrono::milliseconds timeout = std::chrono::milliseconds{0});
+
+  /**
+   * get_dropped() - Number of errors dropped because the ring was full
+   */
+  XCL_DRIVER_DLLESPEC
+  uint64_t
+  get_dropped() const;
+
+private:
+  std::shared_ptr<error_subscription_impl> handle;
+};
+
 } // xrt
 
 #endif
@@ -23,9 +23,11 @@
 #include "xrt/detail/pimpl.h"
 
 #ifdef __cplusplus
+# include <chrono>
 # include <condition_variable>
 # include <cstdint>
 # include <string>
+# include <vector>
 #endif
 
 #ifdef __cplusplus
@@ -126,6 +128,68 @@ public:
     std::cv_status
     wait(const std::chrono::milliseconds& timeout) const; 
   };
+
+  /*!
+   * @class register_window
+   *
+   * @brief
+   * Register space of an IP mapped for direct access
+   *
+   * @details
+   * A register window is a view of the IP register space as mapped
+   * into the process.  Reads and writes are volatile 32-bit loads
+   * and stores with no library call, no locking, and no bounds
+   * checking, which makes it suitable for tight polling loops.  The
+   * window is valid while the ip object it was obtained from exists.
+   */
+  class register_window
+  {
+    volatile uint32_t* m_base = nullptr;
+    size_t m_size = 0;
+
+  public:
+    register_window() = default;
+
+    register_window(volatile uint32_t* base, size_t size)
+      : m_base(base), m_size(size)
+    {}
+
+    /**
+     * data() - Base address of the register space
+     */
+    volatile uint32_t*
+    data() const
+    {
+      return m_base;
+    }
+
+    /**
+     * size() - Size in bytes of the register space
+     */
+    size_t
+    size() const
+    {
+      return m_size;
+    }
+
+    /**
+     * read() - Read register at byte offset
+     */
+    uint32_t
+    read(uint32_t offset) const
+    {
+      return m_base[offset / sizeof(uint32_t)];
+    }
+
+    /**
+     * write() - Write register at byte offset
+     */
+    void
+    write(uint32_t offset, uint32_t data) const
+    {
+      m_base[offset / sizeof(uint32_t)] = data;
+    }
+  };
  
 public:
   /**
@@ -182,6 +246,20 @@ public:
   XCL_DRIVER_DLLESPEC
   uint32_t
   read_register(uint32_t offset) const;
+
+  /**
+   * get_register_window() - Get register space for direct access
+   *
+   * @return
+   *  Register window limited to the address range of the ip
+   *
+   * Throws if the platform does not map IP register space into the
+   * process, e.g. in emulation or on Windows, in which case use
+   * read_register() and write_register().
+   */
+  XCL_DRIVER_DLLESPEC
+  register_window
+  get_register_window() const;
  
   /**
    * create_interrupt_notify() - Create xrt::ip::interrupt object
@@ -200,6 +278,64 @@ public:
   create_interrupt_notify();  
 };
 
+/*!
+ * @class ip_wait_set
+ *
+ * @brief
+ * xrt::ip_wait_set waits for interrupts of many IPs in one thread.
+ *
+ * @details
+ * Interrupt objects added to the set are waited on together, and
+ * ``wait()`` returns the interrupts that fired.  A fired interrupt
+ * is acknowledged and re-enabled before ``wait()`` returns, same as
+ * ``xrt::ip::interrupt::wait()``.
+ *
+ * An optional coalescing window lets a service thread drain many
+ * interrupts per wakeup.  After the first interrupt is received,
+ * ``wait()`` waits for the coalescing window and collects all
+ * interrupts that fired meanwhile.
+ *
+ * The set keeps a reference to added interrupt objects.  Supported
+ * on Linux only.
+ */
+class ip_wait_set_impl;
+class ip_wait_set : public detail::pimpl<ip_wait_set_impl>
+{
+public:
+  /**
+   * ip_wait_set() - Construct empty wait set
+   */
+  XCL_DRIVER_DLLESPEC
+  ip_wait_set();
+
+  /**
+   * add() - Add an interrupt to the set
+   *
+   * @param intr
+   *  Interrupt object from ``xrt::ip::create_interrupt_notify()``
+   * @return
+   *  Index of interrupt in the set, as returned by ``wait()``
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  add(const xrt::ip::interrupt& intr);
+
+  /**
+   * wait() - Wait for interrupts
+   *
+   * @param timeout
+   *  Timeout for wait (default block until an interrupt fires)
+   * @param coalesce
+   *  Time to collect more interrupts after the first one fired
+   * @return
+   *  Indices of interrupts that fired, empty on timeout
+   */
+  XCL_DRIVER_DLLESPEC
+  std::vector<size_t>
+  wait(const std::chrono::milliseconds& timeout = std::chrono::milliseconds{0},
+       const std::chrono::microseconds& coalesce = std::chrono::microseconds{0}) const;
+};
+
 } // xrt
 #endif
 
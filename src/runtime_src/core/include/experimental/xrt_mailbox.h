@@ -21,6 +21,7 @@
 #include "xrt/xrt_kernel.h"
 #include "xrt/xrt_bo.h"
 #include "xrt/detail/pimpl.h"
+#include "experimental/xrt_bo_async.h"
 
 #ifdef __cplusplus
 # include <cstdint>
@@ -195,7 +196,108 @@ public:
     auto index = get_arg_index(argnm);
     set_arg(index, std::forward<ArgType>(argvalue));
   }
-  
+
+  /**
+   * stage_arg() - Stage a global argument for the next ``async_write()``
+   *
+   * @param index
+   *  Index of kernel argument to stage
+   * @param boh
+   *  The global buffer argument value to stage
+   *
+   * Staged arguments are kept in a host copy of the mailbox and are
+   * written to the kernel by the next ``async_write()``.  The
+   * function never blocks on the mailbox, arguments for the next
+   * iteration can be staged while a previous ``async_write()`` is
+   * pending.
+   */
+  void
+  stage_arg(int index, xrt::bo& boh)
+  {
+    stage_arg_at_index(index, boh);
+  }
+
+  /**
+   * stage_arg() - xrt::bo variant for const lvalue
+   */
+  void
+  stage_arg(int index, const xrt::bo& boh)
+  {
+    stage_arg_at_index(index, boh);
+  }
+
+  /**
+   * stage_arg() - xrt::bo variant for rvalue
+   */
+  void
+  stage_arg(int index, xrt::bo&& boh)
+  {
+    stage_arg_at_index(index, boh);
+  }
+
+  /**
+   * stage_arg() - Stage a scalar argument for the next ``async_write()``
+   *
+   * @param index
+   *  Index of kernel argument to stage
+   * @param arg
+   *  The scalar argument value to stage
+   */
+  template <typename ArgType>
+  void
+  stage_arg(int index, ArgType&& arg)
+  {
+    stage_arg_at_index(index, &arg, sizeof(arg));
+  }
+
+  /**
+   * stage_arg() - Stage named argument for the next ``async_write()``
+   */
+  template <typename ArgType>
+  void
+  stage_arg(const std::string& argnm, ArgType&& argvalue)
+  {
+    auto index = get_arg_index(argnm);
+    stage_arg(index, std::forward<ArgType>(argvalue));
+  }
+
+  /**
+   * async_write() - Write staged arguments to kernel asynchronously
+   *
+   * @return
+   *  Event that is complete when the kernel has copied the mailbox
+   *
+   * The staged arguments are written to the mailbox in one batched
+   * register write once the mailbox is idle, followed by the request
+   * for the kernel to copy the mailbox.  The host copy is double
+   * buffered: the staged arguments are snapshotted, and staging for
+   * the next write continues from the snapshot.  A call blocks only
+   * if the snapshot of the previous ``async_write()`` has not yet
+   * been written to the mailbox.
+   *
+   * Asynchronous operations of a mailbox execute in order.  The
+   * synchronous ``read()``, ``write()``, ``set_arg()`` and
+   * ``get_arg()`` must not be called while an asynchronous operation
+   * is pending.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::sync_event
+  async_write();
+
+  /**
+   * async_read() - Read kernel arguments into mailbox copy asynchronously
+   *
+   * @return
+   *  Event that is complete when the mailbox copy of the arguments
+   *  is updated, after which ``get_arg()`` does not block
+   *
+   * The arguments are read from the mailbox in one batched register
+   * read once the kernel has updated the mailbox.
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::sync_event
+  async_read();
+
 
 private:
   XCL_DRIVER_DLLESPEC
@@ -209,6 +311,14 @@ private:
   XCL_DRIVER_DLLESPEC
   void
   set_arg_at_index(int index, const xrt::bo&);
+
+  XCL_DRIVER_DLLESPEC
+  void
+  stage_arg_at_index(int index, const void* value, size_t bytes);
+
+  XCL_DRIVER_DLLESPEC
+  void
+  stage_arg_at_index(int index, const xrt::bo&);
 };
 
 } // xrt
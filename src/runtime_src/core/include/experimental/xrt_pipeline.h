@@ -23,6 +23,7 @@
 #include "experimental/xrt_enqueue.h"
 
 #ifdef __cplusplus
+# include <cstdint>
 # include <memory>
 # include <vector>
 # include <tuple>
@@ -54,6 +55,14 @@ namespace xrt {
  * stages.
  * 
  * A pipeline itself can be stage of another pipeline.
+ *
+ * By default each execution of the pipeline is enqueued in full
+ * when execute() is called, so a producer that executes the pipeline
+ * faster than it drains can queue any number of executions.  Stage
+ * options bound the number of concurrent executions of a stage, and
+ * the number of executions queued in front of a stage.  When the
+ * queue in front of the first stage is full, execute() blocks and
+ * try_execute() fails, which applies backpressure to the producer.
  */
 class pipeline_impl;
 class pipeline
@@ -71,7 +80,10 @@ class pipeline
       {}
 
       virtual xrt::event
-      enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps) = 0;
+      enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps, size_t instance) = 0;
+
+      virtual size_t
+      instances() const = 0;
     };
 
     template <typename Callable>
@@ -83,10 +95,40 @@ class pipeline
       {}
 
       xrt::event
-      enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps)
+      enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps, size_t)
       {
         return q.enqueue_with_waitlist(m_held, deps);
       }
+
+      size_t
+      instances() const
+      {
+        return 1;
+      }
+    };
+
+    // Stage with multiple instances of the callable, for example
+    // run objects of different compute units, that may execute
+    // concurrently
+    template <typename Callable>
+    struct stage_instances_type : stage_holder
+    {
+      std::vector<Callable> m_held;
+      stage_instances_type(std::vector<Callable>&& cs)
+        : m_held(std::move(cs))
+      {}
+
+      xrt::event
+      enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps, size_t instance)
+      {
+        return q.enqueue_with_waitlist(m_held[instance], deps);
+      }
+
+      size_t
+      instances() const
+      {
+        return m_held.size();
+      }
     };
 
     std::unique_ptr<stage_holder> m_content;
@@ -103,15 +145,70 @@ class pipeline
       : m_content(new stage_type<Callable>(std::forward<Callable>(c)))
     {}
 
+    template <typename Callable>
+    stage(std::vector<Callable>&& cs)
+      : m_content(new stage_instances_type<Callable>(std::move(cs)))
+    {}
+
     xrt::event
-    enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps)
+    enqueue(xrt::event_queue& q, const std::vector<xrt::event>& deps, size_t instance = 0)
+    {
+      return m_content->enqueue(q, deps, instance);
+    }
+
+    size_t
+    instances() const
     {
-      return m_content->enqueue(q, deps);
+      return m_content->instances();
     }
   };
 
 
 public:
+  /**
+   * struct stage_options - Flow control of a stage
+   *
+   * @concurrency: Maximum number of concurrent executions of the stage,
+   *   0 for no limit.  A stage with multiple instances has at most one
+   *   execution per instance at a time.
+   * @capacity: Maximum number of pipeline executions queued in front
+   *   of the stage, 0 for no limit.  For the first stage these are
+   *   executions not yet dispatched to the stage, for other stages
+   *   these are executions dispatched to the previous stage but not
+   *   yet to this stage.  The previous stage does not start another
+   *   execution while the queue is full.
+   *
+   * Pipeline executions are dispatched to each stage in the order in
+   * which they were started.
+   */
+  struct stage_options
+  {
+    unsigned int concurrency = 0;
+    unsigned int capacity = 0;
+  };
+
+  /**
+   * struct stage_stats - Counters of a stage
+   *
+   * @dispatched: Executions of the stage with satisfied dependencies
+   * @completed:  Executions of the stage that completed
+   * @latency_ns: Accumulated latency of completed executions, from
+   *   dispatch to completion
+   * @max_latency_ns: Maximum latency of a completed execution
+   * @elapsed_ns: Time from first dispatch to last completion
+   *
+   * Throughput of a stage is completed / elapsed_ns, and average
+   * latency is latency_ns / completed.
+   */
+  struct stage_stats
+  {
+    uint64_t dispatched = 0;
+    uint64_t completed = 0;
+    uint64_t latency_ns = 0;
+    uint64_t max_latency_ns = 0;
+    uint64_t elapsed_ns = 0;
+  };
+
   /**
    * Constructor - 
    *
@@ -146,6 +243,26 @@ public:
     return execute(event);
   }
 
+  /**
+   * try_execute() - Run the pipeline once if not full
+   *
+   * @event:  Event that controls the start of the first stage
+   * Return:  Event of the last stage, or an empty event if the queue
+   *          in front of the first stage is full
+   */
+  xrt::event
+  try_execute(xrt::event event);
+
+  /**
+   * try_execute() - Run the pipeline once if not full
+   */
+  xrt::event
+  try_execute()
+  {
+    xrt::event event;
+    return try_execute(event);
+  }
+
   /**
    * operator() - The pipeline is callable
    *
@@ -178,6 +295,42 @@ public:
   {
   }
 
+  /**
+   * set_stage_options() - Set flow control of a stage
+   *
+   * @idx:   Index of stage in order of emplace()
+   * @opts:  Stage options
+   *
+   * Options must be set before the pipeline is executed first time.
+   */
+  void
+  set_stage_options(size_t idx, const stage_options& opts);
+
+  /**
+   * get_stage_stats() - Get counters of a stage
+   *
+   * @idx:   Index of stage in order of emplace()
+   */
+  stage_stats
+  get_stage_stats(size_t idx) const;
+
+  /**
+   * emplace_instances() - Add a stage with multiple instances
+   *
+   * @cs:  Instances of the stage callable, e.g. run objects of
+   *       different compute units
+   *
+   * Successive pipeline executions use the instances round robin.
+   * An instance is used by at most one execution at a time, so the
+   * concurrency of the stage is at most the number of instances.
+   */
+  template <typename Callable>
+  auto emplace_instances(std::vector<Callable> cs)
+  {
+    stage s(std::move(cs));
+    return std::make_tuple(std::ref(add_stage(std::move(s))));
+  }
+
   /**
    * emplace() - Add a callable to the pipeline
    */
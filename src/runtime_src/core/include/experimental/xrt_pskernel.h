@@ -266,6 +266,11 @@ class psrun
    * to starting kernel execution.  After setting arguments, the
    * kernel can be started using ``start()`` on the run object.
    *
+   * The run object holds the buffer until the argument is changed.
+   * The PS kernel maps the buffer on first use and reuses the
+   * mapping for later starts, so reusing a run with the same
+   * buffers avoids mapping the buffers per execution.
+   *
    * See also ``operator()`` to set all arguments and start kernel.
    */
   void
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_RUN_TEMPLATE_H_
+#define _XRT_RUN_TEMPLATE_H_
+
+#include "xrt.h"
+#include "xrt/xrt_kernel.h"
+#include "xrt/detail/pimpl.h"
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/*!
+ * @class run_template
+ *
+ * @brief
+ * xrt::run_template creates many run objects that share the
+ * arguments of a prototype run object.
+ *
+ * @details
+ * A run template snapshots the command packet and argument state of
+ * a run object whose arguments have been set.  ``create()`` returns
+ * a new run object initialized from the snapshot, which typically
+ * only overrides one or two arguments before it is started.
+ *
+ * Unlike a run object constructed from a kernel, a run object
+ * created from a template does not allocate its command buffer until
+ * it is first started, and it does not re-encode arguments that were
+ * set in the template.  The command buffer is allocated from the
+ * exec buffer slab when Runtime.exec_buffer_slab is enabled.
+ *
+ * Changes to the prototype run after the template is constructed do
+ * not affect the template.
+ */
+class run_template_impl;
+class run_template : public detail::pimpl<run_template_impl>
+{
+public:
+  /**
+   * run_template() - Construct empty run template
+   */
+  run_template() = default;
+
+  /**
+   * run_template() - Construct template from a run object
+   *
+   * @param run
+   *  Prototype run object with arguments set
+   */
+  XCL_DRIVER_DLLESPEC
+  explicit
+  run_template(const xrt::run& run);
+
+  /**
+   * create() - Create run object from template
+   *
+   * @return
+   *  Run object with the arguments of the template
+   */
+  XCL_DRIVER_DLLESPEC
+  xrt::run
+  create() const;
+};
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_RUNLIST_H_
+#define _XRT_RUNLIST_H_
+
+#include "xrt.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "xrt/detail/pimpl.h"
+
+#ifdef __cplusplus
+# include <chrono>
+# include <condition_variable>
+# include <cstdint>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+/*!
+ * @class runlist
+ *
+ * @brief
+ * xrt::runlist is a list of run objects that are submitted for
+ * execution together.
+ *
+ * @details
+ * A runlist amortizes the cost of submitting many small kernel
+ * executions.  The run objects in the list are submitted to the
+ * scheduler in a single call, which on platforms that support it
+ * results in one execbuf system call and one wakeup of the command
+ * monitor per list rather than per run object.
+ *
+ * All run objects added to a list must be associated with kernels
+ * on the same device as the runlist.  The arguments of the run
+ * objects must be set prior to calling ``execute()``.  A run object
+ * in a runlist can be waited on individually, or the entire list
+ * can be waited on using ``wait()``.
+ *
+ * A runlist can be executed again once all its run objects have
+ * completed.
+ */
+class runlist_impl;
+class runlist : public detail::pimpl<runlist_impl>
+{
+public:
+  /**
+   * runlist() - Construct empty runlist object
+   */
+  runlist() = default;
+
+  /**
+   * runlist() - Construct runlist for a device
+   *
+   * @param device
+   *  Device on which run objects in the list execute
+   */
+  XCL_DRIVER_DLLESPEC
+  explicit
+  runlist(const xrt::device& device);
+
+  /**
+   * add() - Add a run object to the list
+   *
+   * @param run
+   *  Run object to add.  The runlist shares ownership of the run.
+   *
+   * Throws if the run object is for a different device than the
+   * runlist, or if the runlist is currently executing.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  add(const xrt::run& run);
+
+  /**
+   * execute() - Submit all run objects in the list for execution
+   *
+   * This function is asynchronous, use ``wait()`` to wait for all
+   * run objects to complete.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  execute();
+
+  /**
+   * wait() - Wait for all run objects in the list to complete
+   *
+   * @param timeout
+   *  Timeout for wait (default block till all runs complete)
+   * @return
+   *  std::cv_status::timeout if the timeout expired before all
+   *  runs completed, std::cv_status::no_timeout otherwise.
+   *
+   * Completion does not guarantee success, the state of each
+   * individual run object should be checked using ``xrt::run::state()``.
+   */
+  XCL_DRIVER_DLLESPEC
+  std::cv_status
+  wait(const std::chrono::milliseconds& timeout = std::chrono::milliseconds{0}) const;
+
+  /**
+   * reset() - Remove all run objects from the list
+   *
+   * Throws if the runlist is currently executing.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  reset();
+
+  /**
+   * size() - Number of run objects in the list
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  size() const;
+};
+
+} // xrt
+#endif
+
+#endif
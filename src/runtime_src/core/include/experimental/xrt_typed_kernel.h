@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2022, Xilinx Inc - All rights reserved
+ * Xilinx Runtime (XRT) Experimental APIs
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _XRT_TYPED_KERNEL_H_
+#define _XRT_TYPED_KERNEL_H_
+
+#include "xrt.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+#ifdef __cplusplus
+# include <array>
+# include <cstdint>
+# include <cstring>
+# include <type_traits>
+#endif
+
+#ifdef __cplusplus
+
+namespace xrt {
+
+namespace detail { namespace typed_args {
+
+// Kind of argument in a typed kernel signature
+enum class arg_kind { scalar, global };
+
+/**
+ * get_offsets() - Validate signature and get argument payload offsets
+ *
+ * @param kernel
+ *  Kernel to validate against
+ * @param kinds
+ *  Kind of each argument in the signature
+ * @param sizes
+ *  Size in bytes of each argument in the signature
+ * @param count
+ *  Number of arguments in the signature
+ * @param offsets
+ *  Output, byte offset of each argument into the run payload
+ *
+ * Throws if the signature does not match the kernel arguments, or if
+ * the kernel is of a type that does not support direct payload writes.
+ */
+XCL_DRIVER_DLLESPEC
+void
+get_offsets(const xrt::kernel& kernel, const arg_kind* kinds, const size_t* sizes,
+            size_t count, size_t* offsets);
+
+/**
+ * get_payload() - Get the argument payload of a run object
+ */
+XCL_DRIVER_DLLESPEC
+uint32_t*
+get_payload(const xrt::run& run);
+
+template <typename ArgType>
+struct arg_traits
+{
+  static_assert(std::is_trivially_copyable<ArgType>::value,
+                "typed_kernel scalar argument must be trivially copyable");
+  static constexpr arg_kind kind = arg_kind::scalar;
+  static constexpr size_t size = sizeof(ArgType);
+
+  static void
+  write(uint8_t* dst, const ArgType& value)
+  {
+    std::memcpy(dst, &value, sizeof(ArgType));
+  }
+};
+
+template <>
+struct arg_traits<xrt::bo>
+{
+  static constexpr arg_kind kind = arg_kind::global;
+  static constexpr size_t size = sizeof(uint64_t);
+
+  static void
+  write(uint8_t* dst, const xrt::bo& bo)
+  {
+    auto addr = bo.address();
+    std::memcpy(dst, &addr, sizeof(addr));
+  }
+};
+
+}} // typed_args, detail
+
+/*!
+ * @class typed_kernel
+ *
+ * @brief
+ * xrt::typed_kernel is a kernel with a compile time argument signature.
+ *
+ * @details
+ * The argument signature is validated once against the kernel
+ * arguments in the xclbin when the typed kernel is constructed.  The
+ * register map offset of each argument is computed at the same time,
+ * so starting a run writes the arguments directly into the command
+ * payload without per argument lookup and validation.
+ *
+ * Scalar arguments are specified by their host type, which must
+ * match the size of the kernel argument.  Global memory arguments
+ * are specified as ``xrt::bo``.
+ *
+ * Unlike ``xrt::run::set_arg()``, the memory bank connectivity of a
+ * buffer argument is not checked and no local copy of the buffer is
+ * made if the compute unit is not connected to the bank of the
+ * buffer.  It is the caller's responsibility to allocate buffers in
+ * the bank connected to the kernel argument.
+ *
+ * Only kernels with AP_CTRL_HS or AP_CTRL_CHAIN control protocol are
+ * supported, and all kernel arguments must be scalar or global
+ * memory arguments.
+ *
+ * Example
+ *
+ * .. code-block:: c++
+ *
+ *    xrt::typed_kernel<xrt::bo, xrt::bo, int> vadd{device, uuid, "vadd"};
+ *    auto run = vadd(in, out, 1024);
+ *    run.wait();
+ */
+template <typename ...Args>
+class typed_kernel
+{
+  using offsets_type = std::array<size_t, sizeof...(Args)>;
+
+  xrt::kernel m_kernel;
+  offsets_type m_offsets;
+
+  static offsets_type
+  get_offsets(const xrt::kernel& kernel)
+  {
+    using namespace detail::typed_args;
+    const std::array<arg_kind, sizeof...(Args)> kinds = {{ arg_traits<Args>::kind... }};
+    const std::array<size_t, sizeof...(Args)> sizes = {{ arg_traits<Args>::size... }};
+    offsets_type offsets = {};
+    detail::typed_args::get_offsets(kernel, kinds.data(), sizes.data(), sizeof...(Args), offsets.data());
+    return offsets;
+  }
+
+  void
+  set_args(uint8_t*, size_t) const
+  {}
+
+  template <typename ArgType, typename ...Rest>
+  void
+  set_args(uint8_t* payload, size_t argno, const ArgType& arg, const Rest&... rest) const
+  {
+    detail::typed_args::arg_traits<ArgType>::write(payload + m_offsets[argno], arg);
+    set_args(payload, argno + 1, rest...);
+  }
+
+public:
+  /**
+   * typed_kernel() - Construct from kernel object
+   *
+   * @param kernel
+   *  Kernel object whose arguments must match the signature
+   *
+   * Throws if the signature does not match the kernel arguments.
+   */
+  explicit
+  typed_kernel(xrt::kernel kernel)
+    : m_kernel(std::move(kernel))
+    , m_offsets(get_offsets(m_kernel))
+  {}
+
+  /**
+   * typed_kernel() - Construct kernel from xclbin uuid and name
+   *
+   * @param device
+   *  Device on which the kernel should execute
+   * @param xclbin_id
+   *  UUID of the xclbin with the kernel
+   * @param name
+   *  Name of kernel to construct
+   * @param mode
+   *  Open the kernel instances with specified access (default shared)
+   */
+  typed_kernel(const xrt::device& device, const xrt::uuid& xclbin_id, const std::string& name,
+               xrt::kernel::cu_access_mode mode = xrt::kernel::cu_access_mode::shared)
+    : typed_kernel(xrt::kernel{device, xclbin_id, name, mode})
+  {}
+
+  /**
+   * start() - Set arguments of a run object and start it
+   *
+   * @param run
+   *  Run object constructed from the kernel of this typed kernel
+   * @param args
+   *  Kernel arguments
+   *
+   * Reusing a run object avoids allocation of a command packet per
+   * execution.  The run object must not be executing.
+   */
+  void
+  start(xrt::run& run, const Args&... args) const
+  {
+    auto payload = reinterpret_cast<uint8_t*>(detail::typed_args::get_payload(run));
+    set_args(payload, 0, args...);
+    run.start();
+  }
+
+  /**
+   * operator() - Start a new run with arguments
+   *
+   * @param args
+   *  Kernel arguments
+   * @return
+   *  Run object that was started
+   */
+  xrt::run
+  operator() (const Args&... args) const
+  {
+    xrt::run run(m_kernel);
+    start(run, args...);
+    return run;
+  }
+
+  /**
+   * get_kernel() - Get the underlying kernel object
+   */
+  const xrt::kernel&
+  get_kernel() const
+  {
+    return m_kernel;
+  }
+};
+
+} // xrt
+
+#endif // __cplusplus
+
+#endif
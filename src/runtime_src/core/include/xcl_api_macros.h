@@ -45,8 +45,7 @@ mtx.unlock();
     rv = ci_msg.SerializeToArray(ci_buf,ci_len);                        \
     if(rv == false){std::cerr<<"FATAL ERROR:protobuf SerializeToArray failed"<<std::endl;exit(1);} \
                                                                         \
-    _s_inst->sk_write(ci_buf,ci_len);                                   \
-    _s_inst->sk_write(buf,c_len);                                       \
+    _s_inst->sk_write(ci_buf,ci_len,buf,c_len);                         \
                                                                         \
     _s_inst->sk_read(ri_buf,ri_msg.ByteSize());                         \
     rv = ri_msg.ParseFromArray(ri_buf,ri_msg.ByteSize());               \
@@ -69,8 +68,7 @@ mtx.unlock();
     rv = ci_msg.SerializeToArray(ci_buf,ci_len);                        \
     if(rv == false){std::cerr<<"FATAL ERROR:protobuf SerializeToArray failed"<<std::endl;exit(1);} \
                                                                         \
-    _s_inst->sk_write(ci_buf,ci_len);                                   \
-    _s_inst->sk_write(buf,c_len);                                       \
+    _s_inst->sk_write(ci_buf,ci_len,buf,c_len);                         \
                                                                         \
     _s_inst->sk_read(ri_buf,ri_msg.ByteSizeLong());                     \
     rv = ri_msg.ParseFromArray(ri_buf,ri_msg.ByteSizeLong());           \
@@ -108,6 +108,7 @@ enum xgq_cmd_opcode {
 	XGQ_CMD_OP_ACCESS_VALID     	= 0x10d,
 	XGQ_CMD_OP_DATA_INTEGRITY   	= 0x10e,
 	XGQ_CMD_OP_EXIT             	= 0x10f,
+	XGQ_CMD_OP_START_CUIDX_CHAIN	= 0x110,
 
 	/* Common command type */
 	XGQ_CMD_OP_BARRIER		= 0x200,
@@ -75,6 +75,24 @@ struct xgq_cmd_start_cuidx_kv {
 	uint32_t data[1]; // NOLINT
 };
 
+/**
+ * struct xgq_cmd_start_cuidx_chain: start a chain of CUs command
+ *
+ * @hdr:	CU command header, CU index of the first stage
+ * @num_stages:	number of stages
+ * @data:	stages in the format of struct ert_chain_stage in ert.h
+ *
+ * This command is used to start the CU of each stage as soon as the CU of
+ * the previous stage is done, the arguments of a stage may be patched
+ * with registers of the previous CU. The command is completed when the CU
+ * of the last stage is done.
+ */
+struct xgq_cmd_start_cuidx_chain {
+	struct xgq_cmd_sq_hdr hdr;
+	uint32_t num_stages;
+	uint32_t data[1]; // NOLINT
+};
+
 /**
  * struct xgq_cmd_init_cuidx: init CU by index command
  *
@@ -396,6 +396,54 @@ public:
     sync(dir, size(), 0);
   }
 
+  /**
+   * sync_2d() - Synchronize a rectangular region of the buffer
+   *
+   * @param dir
+   *  To device or from device
+   * @param width
+   *  Bytes per row of the region
+   * @param height
+   *  Number of rows of the region
+   * @param pitch
+   *  Bytes between the start of consecutive rows, at least width
+   * @param offset
+   *  Offset within the BO of the first byte of the region
+   *
+   * Sync the same bytes as height calls of sync(dir, width, offset +
+   * row * pitch), but with all rows submitted to the driver together.
+   * Adjacent rows are synced as one range.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync_2d(xclBOSyncDirection dir, size_t width, size_t height, size_t pitch, size_t offset);
+
+  /**
+   * sync_3d() - Synchronize a box shaped region of the buffer
+   *
+   * @param dir
+   *  To device or from device
+   * @param width
+   *  Bytes per row of the region
+   * @param height
+   *  Number of rows per slice of the region
+   * @param depth
+   *  Number of slices of the region
+   * @param pitch
+   *  Bytes between the start of consecutive rows, at least width
+   * @param slice_pitch
+   *  Bytes between the start of consecutive slices, at least
+   *  height * pitch
+   * @param offset
+   *  Offset within the BO of the first byte of the region
+   *
+   * Sync depth 2D regions as with sync_2d(), all submitted together.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  sync_3d(xclBOSyncDirection dir, size_t width, size_t height, size_t depth,
+          size_t pitch, size_t slice_pitch, size_t offset);
+
   /**
    * map() - Map the host side buffer into application
    *
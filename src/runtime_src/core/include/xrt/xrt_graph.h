@@ -28,6 +28,7 @@
 # include <chrono>
 # include <string>
 # include <cstdint>
+# include <vector>
 #endif
 
 typedef void *xrtGraphHandle;
@@ -213,6 +214,59 @@ public:
     read_port(port_name, &arg, sizeof(arg));
   }
 
+  /**
+   * struct port_update - Value of one RTP port for update_ports()
+   *
+   * @port_name:  Hierarchical name of RTP port
+   * @value:      Pointer to the value to set
+   * @bytes:      Size of the value in bytes
+   */
+  struct port_update
+  {
+    std::string port_name;
+    const void* value;
+    size_t bytes;
+  };
+
+  /**
+   * struct port_read - Destination of one RTP port for read_ports()
+   *
+   * @port_name:  Hierarchical name of RTP port
+   * @value:      Pointer to memory the RTP value is written to
+   * @bytes:      Size of the value in bytes
+   */
+  struct port_read
+  {
+    std::string port_name;
+    void* value;
+    size_t bytes;
+  };
+
+  /**
+   * update_ports() - Update multiple graph Run Time Parameters
+   *
+   * @param updates
+   *  Ports and values to update, e.g. ``{{"g.in1", &v1, sizeof(v1)}, ...}``
+   *
+   * All ports are checked before any port is updated.  Where
+   * supported, asynchronous ports are updated together under one
+   * lock acquire and release sequence, so the AIE array observes all
+   * new values at once.  Synchronous ports are updated in order.
+   */
+  void
+  update_ports(const std::vector<port_update>& updates);
+
+  /**
+   * read_ports() - Read multiple graph Run Time Parameters
+   *
+   * @param reads
+   *  Ports to read and where to write their values
+   *
+   * All ports are checked before any port is read.
+   */
+  void
+  read_ports(const std::vector<port_read>& reads);
+
 private:
   std::shared_ptr<graph_impl> handle;
 
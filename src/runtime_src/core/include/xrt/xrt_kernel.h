@@ -156,6 +156,21 @@ class run
   void
   start(const autostart& iterations);
 
+  /**
+   * start() - Start one execution of a run with a deadline
+   *
+   * @param deadline
+   *   Time by which the run must be started on a compute unit
+   *
+   * A run that cannot be started on a compute unit by the deadline
+   * is dropped by the scheduler without executing and completes with
+   * state ERT_CMD_STATE_EXPIRED.  The deadline applies to this
+   * execution of the run only.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  start(const std::chrono::steady_clock::time_point& deadline);
+
   /**
    * stop() - Stop kernel run object at next safe iteration
    *
@@ -189,6 +204,28 @@ class run
   ert_cmd_state
   abort();
 
+  /**
+   * abort() - Abort a list of run objects that have been started
+   *
+   * @param runs
+   *  Run objects to abort
+   * @return
+   *  State of each run object, in the order of @runs
+   *
+   * Aborts all run objects with a single scheduler request per
+   * batch of several hundred runs rather than one request per run.
+   * Runs that are done when the function is called are not aborted,
+   * runs that are already executing on a compute unit are aborted
+   * only if the compute unit can be reset, otherwise they run to
+   * completion.
+   *
+   * The function is synchronous and will wait for all runs to be
+   * aborted or completed.
+   */
+  XCL_DRIVER_DLLESPEC
+  static std::vector<ert_cmd_state>
+  abort(const std::vector<run>& runs);
+
   /**
    * wait() - Wait for a run to complete execution
    *
@@ -265,6 +302,84 @@ class run
   ert_cmd_state
   state() const;
 
+  /**
+   * struct timestamps - Timestamps of last execution of a run object
+   *
+   * @host_start:     host started the run
+   * @driver_receive: driver received the command
+   * @cu_dispatch:    command was dispatched to a compute unit
+   * @cu_done:        compute unit completed the command
+   * @host_notify:    host was notified of completion
+   *
+   * All values are in ns of the host monotonic clock
+   * (std::chrono::steady_clock, CLOCK_MONOTONIC on Linux).  A value
+   * is 0 if it was not recorded, e.g. when the driver or platform
+   * does not support command timestamps.
+   */
+  struct timestamps
+  {
+    uint64_t host_start = 0;
+    uint64_t driver_receive = 0;
+    uint64_t cu_dispatch = 0;
+    uint64_t cu_done = 0;
+    uint64_t host_notify = 0;
+  };
+
+  /**
+   * enable_timestamps() - Record timestamps of run executions
+   *
+   * @param enable  Enable or disable recording of timestamps
+   *
+   * Recording is off by default.  When enabled, the driver records
+   * when the command moves through its states and the host records
+   * start and completion of the run.  The setting takes effect at
+   * next start of the run object, it is an error to change it while
+   * the run is executing.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  enable_timestamps(bool enable = true);
+
+  /**
+   * get_timestamps() - Get timestamps of last execution of the run
+   *
+   * @return
+   *  Timestamps of last execution, all zero if timestamps are not enabled
+   *
+   * The timestamps are complete once the run has completed.
+   */
+  XCL_DRIVER_DLLESPEC
+  timestamps
+  get_timestamps() const;
+
+  /**
+   * enum priority_type - Scheduling priority of a run
+   *
+   * @var normal
+   *   Default, runs execute in the order they are started
+   * @var high
+   *   Execute ahead of normal and bulk runs waiting for the same
+   *   compute unit
+   * @var bulk
+   *   Execute after normal and high priority runs waiting for the
+   *   same compute unit
+   */
+  enum class priority_type : uint8_t { normal = 0, high = 1, bulk = 2 };
+
+  /**
+   * set_priority() - Set scheduling priority of the run
+   *
+   * @param priority  Priority of subsequent executions of the run
+   *
+   * The priority orders runs that wait for a compute unit, it does
+   * not preempt a run that is already executing.  The setting takes
+   * effect at next start of the run object, it is an error to change
+   * it while the run is executing.
+   */
+  XCL_DRIVER_DLLESPEC
+  void
+  set_priority(priority_type priority);
+
   /**
    * add_callback() - Add a callback function for run state
    *
@@ -698,6 +813,22 @@ public:
   uint32_t
   read_register(uint32_t offset) const;
 
+  /**
+   * abort_all() - Abort all outstanding runs of this kernel
+   *
+   * @return
+   *  Number of runs that were aborted
+   *
+   * Aborts all started run objects of this kernel in the calling
+   * process as if by ``xrt::run::abort(runs)``.  Runs that complete
+   * before they are aborted are not counted.  The state of each run
+   * object is available from ``xrt::run::state()`` when the function
+   * returns.
+   */
+  XCL_DRIVER_DLLESPEC
+  size_t
+  abort_all();
+
 public:
   /// @cond
   const std::shared_ptr<kernel_impl>&
@@ -1,5 +1,5 @@
 /**
- * Copyright (C) 2015-2020 Xilinx, Inc
+ * Copyright (C) 2015-2022 Xilinx, Inc
  *
  * PCIe DMA Test implementation
  *
@@ -103,14 +103,16 @@ namespace xcldev {
             std::for_each(mBOList.begin(), mBOList.end(), [&](auto &v) {std::memset(v.second.get(), 0, mSize);});
         }
 
-        int validate() const {
-            std::vector<char> bufCmp(mSize, mPattern);
-            for (const buffer_and_deleter &bo : mBOList) {
-                if (!std::memcmp(bo.second.get(), bufCmp.data(), mSize))
-                    continue;
-                throw xrt_core::error(-EIO, "DMA test data integrity check failed.");
-            }
-            return 0;
+        unsigned int dmaThreads() const {
+            xclDeviceInfo2 info;
+            int rc = xclGetDeviceInfo2(mHandle, &info);
+            if (rc)
+                throw xrt_core::error(rc, "Unable to get device information.");
+
+            if (info.mDMAThreads == 0)
+                throw xrt_core::error(-EINVAL, "Unable to determine number of DMA channels.");
+
+            return info.mDMAThreads;
         }
 
     public:
@@ -146,18 +148,49 @@ namespace xcldev {
             std::for_each(mBOList.begin(), mBOList.end(), [&](auto &bo) {xclFreeBO(mHandle, bo.first); });
         }
 
-        int run(std::ostream& ostr = std::cout) const {
-            xclDeviceInfo2 info;
-            int rc = xclGetDeviceInfo2(mHandle, &info);
-            if (rc)
-                throw xrt_core::error(rc, "Unable to get device information.");
+        // Number of bytes moved by one pass over all buffers
+        size_t bytes() const {
+            return mBOList.size() * mSize;
+        }
 
-            if (info.mDMAThreads == 0)
-                throw xrt_core::error(-EINVAL, "Unable to determine number of DMA channels.");
+        // Sync all buffers once in direction dir, returns elapsed time in us
+        long long runTimed(xclBOSyncDirection dir) const {
+            auto threads = dmaThreads();
+            Timer timer;
+            if (runSync(dir, threads))
+                throw xrt_core::error(-EIO, dir == XCL_BO_SYNC_BO_TO_DEVICE
+                                      ? "DMA from host to device failed." : "DMA from device to host failed.");
+            return timer.stop();
+        }
+
+        // Average time in us of syncing a single buffer, one at a time
+        double latency(xclBOSyncDirection dir, unsigned int iterations) const {
+            Timer timer;
+            for (unsigned int i = 0; i < iterations; i++) {
+                const auto& bo = mBOList[i % mBOList.size()];
+                int result = xclSyncBO(mHandle, bo.first, dir, mSize, 0);
+                if (result != 0)
+                    throw xrt_core::error(result, "DMA failed");
+            }
+            return static_cast<double>(timer.stop()) / iterations;
+        }
+
+        int validate() const {
+            std::vector<char> bufCmp(mSize, mPattern);
+            for (const buffer_and_deleter &bo : mBOList) {
+                if (!std::memcmp(bo.second.get(), bufCmp.data(), mSize))
+                    continue;
+                throw xrt_core::error(-EIO, "DMA test data integrity check failed.");
+            }
+            return 0;
+        }
+
+        int run(std::ostream& ostr = std::cout) const {
+            auto threads = dmaThreads();
 
             size_t result = 0;
             Timer timer;
-            result = runSync(XCL_BO_SYNC_BO_TO_DEVICE, info.mDMAThreads);
+            result = runSync(XCL_BO_SYNC_BO_TO_DEVICE, threads);
             if (result)
                 throw xrt_core::error(static_cast<int>(result), "DMA from host to device failed.");
 
@@ -169,7 +202,7 @@ namespace xcldev {
             ostr << boost::str(boost::format("Host -> PCIe -> FPGA write bandwidth = %.1f MB/s\n") % rate);
 
             timer.reset();
-            result = runSync(XCL_BO_SYNC_BO_FROM_DEVICE, info.mDMAThreads);
+            result = runSync(XCL_BO_SYNC_BO_FROM_DEVICE, threads);
             if (result)
                 throw xrt_core::error(static_cast<int>(result), "DMA from device to host failed.");
 
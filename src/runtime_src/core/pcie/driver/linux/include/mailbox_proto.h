@@ -28,7 +28,7 @@
  *   be bumped up.
  * - Support for old OP code should never be removed.
  */
-#define XCL_MB_PROTOCOL_VER	0U
+#define XCL_MB_PROTOCOL_VER	1U
 
 /*
  * UUID_SZ should ALWAYS have the same number
@@ -292,10 +292,13 @@ struct xcl_mailbox_conn {
 #define	XCL_COMM_ID_SIZE		2048
 #define XCL_MB_PEER_READY		(1UL << 0)
 #define XCL_MB_PEER_SAME_DOMAIN		(1UL << 1)
+#define XCL_MB_PEER_BULK_CHAN		(1UL << 2)
 /**
  * struct mailbox_conn_resp - MAILBOX_REQ_USER_PROBE response payload type
  * @version: protocol version should be used
- * @conn_flags: connection status
+ * @conn_flags: connection status, XCL_MB_PEER_BULK_CHAN is only set for peers
+ *              in the same domain speaking version 1 or later, which pass
+ *              large messages by reference instead of through the FIFO
  * @chan_switch: bitmap to indicate SW / HW channel for each OP code msg
  * @comm_id: user defined cookie
  */
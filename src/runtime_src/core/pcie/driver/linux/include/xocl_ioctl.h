@@ -86,6 +86,12 @@
  * 18   Allocate buffer on host memory         DRM_IOCTL_XOCL_ALLOC_CMA       drm_xocl_alloc_cma_info
  * 19   Free host memory buffer                DRM_IOCTL_XOCL_FREE_CMA        N/A
  * 20   Copy bo buffers                        DRM_IOCTL_XOCL_COPY_BO         drm_xocl_copy_bo
+ * 21   Send many execute jobs to compute      DRM_IOCTL_XOCL_EXECBUF_VEC     drm_xocl_execbuf_vec
+ *      units
+ * 22   Obtain CU and client statistics        DRM_IOCTL_XOCL_KDS_STAT        drm_xocl_kds_stat
+ * 23   Open/close contexts on many compute    DRM_IOCTL_XOCL_CTX_VEC         drm_xocl_ctx_vec
+ *      units
+ * 24   Synchronize many buffer ranges         DRM_IOCTL_XOCL_SYNC_BO_VEC     drm_xocl_sync_bo_vec
  * ==== ====================================== ============================== ==================================
  */
 
@@ -164,6 +170,14 @@ enum drm_xocl_ops {
 	DRM_XOCL_FREE_CMA,
 	/* Memory to Memory BO copy */
 	DRM_XOCL_COPY_BO,
+	/* Commands to run on CUs, many in one call */
+	DRM_XOCL_EXECBUF_VEC,
+	/* CU and client statistics */
+	DRM_XOCL_KDS_STAT,
+	/* Open/close contexts on many CUs in one call */
+	DRM_XOCL_CTX_VEC,
+	/* Sync many buffer ranges in one call */
+	DRM_XOCL_SYNC_BO_VEC,
 
 	/* The following IOCTLs can only be called from linux kernel space
 	 * WARNING: INTERNAL USE ONLY. NOT FOR PUBLIC CONSUMPTION.
@@ -281,6 +295,24 @@ struct drm_xocl_sync_bo {
 	enum drm_xocl_sync_bo_dir dir;
 };
 
+#define DRM_XOCL_SYNC_BO_VEC_MAX	256
+
+/**
+ * struct drm_xocl_sync_bo_vec - Synchronize many buffer ranges
+ * used with DRM_IOCTL_XOCL_SYNC_BO_VEC ioctl
+ *
+ * @count:	Number of ranges, at most DRM_XOCL_SYNC_BO_VEC_MAX
+ * @reserved:	Pass 0
+ * @syncs:	User pointer to an array of struct drm_xocl_sync_bo
+ *
+ * Ranges are synced in order, the ioctl stops at the first failing range.
+ */
+struct drm_xocl_sync_bo_vec {
+	uint32_t count;
+	uint32_t reserved;
+	uint64_t syncs;
+};
+
 /**
  * struct drm_xocl_sync_bo_cb - Synchronize the buffer in the requested direction
  * between device and host
@@ -405,6 +437,10 @@ struct drm_xocl_kinfo_bo {
  * @cq_int:	enable interrupt from host to HW scheduler
  * @dataflow:	enable dataflow mode
  * @rw_shared:	allow xclRegWrite/xclRegRead access shared CU
+ * @moderate_cnt: wake waiters after this many completions, 0 or 1 to
+ *		  wake on every completion
+ * @moderate_us: maximum microseconds a completion is held back from
+ *		 waiters, 0 disables completion moderation
  */
 struct drm_xocl_kds {
 	uint32_t slot_size;
@@ -415,15 +451,27 @@ struct drm_xocl_kds {
 	uint32_t cq_int:1;
 	uint32_t dataflow:1;
 	uint32_t rw_shared:1;
-	uint32_t unused:25;
+	uint32_t moderate_cnt:8;
+	uint32_t moderate_us:16;
+	uint32_t unused:1;
 };
 
 /*
  * enum drm_xocl_axlf_flags - used for axlf programming
+ *
+ * XOCL_AXLF_STAGE:   validate and keep a copy of the xclbin in the
+ *                    driver without programming it
+ * XOCL_AXLF_STAGED:  program the staged xclbin with the uuid of the
+ *                    xclbin header, the xclbin is not copied again
+ * XOCL_AXLF_UNSTAGE: release the staged xclbin with the uuid of the
+ *                    xclbin header, only the header is read
  */
 enum drm_xocl_axlf_flags {
 	XOCL_AXLF_BASE		        = 0,
-	XOCL_AXLF_FORCE_PROGRAM		= (1 << 0)
+	XOCL_AXLF_FORCE_PROGRAM		= (1 << 0),
+	XOCL_AXLF_STAGE			= (1 << 1),
+	XOCL_AXLF_STAGED		= (1 << 2),
+	XOCL_AXLF_UNSTAGE		= (1 << 3)
 };
 
 /**
@@ -510,6 +558,33 @@ struct drm_xocl_ctx {
 	uint32_t handle;
 };
 
+#define DRM_XOCL_CTX_VEC_MAX	129
+
+/**
+ * struct drm_xocl_ctx_vec - Open or close contexts on many compute units
+ * used with DRM_IOCTL_XOCL_CTX_VEC ioctl
+ *
+ * @op:		XOCL_CTX_OP_ALLOC_CTX or XOCL_CTX_OP_FREE_CTX
+ * @xclbin_id:	UUID of the device image (xclbin)
+ * @flags:	Shared or exclusive context, applies to all compute units
+ * @count:	Number of compute units, at most DRM_XOCL_CTX_VEC_MAX
+ * @cu_indices:	User pointer to an array of count uint32_t compute unit
+ *		indices, XOCL_CTX_VIRT_CU_INDEX is allowed
+ * @done:	Returns the number of leading contexts that are opened or
+ *		closed.  An open that fails closes the contexts it opened,
+ *		so done is 0 when XOCL_CTX_OP_ALLOC_CTX fails.
+ * @reserved:	Pass 0
+ */
+struct drm_xocl_ctx_vec {
+	enum drm_xocl_ctx_code op;
+	xuid_t   xclbin_id;
+	uint32_t flags;
+	uint32_t count;
+	uint64_t cu_indices;
+	uint32_t done;
+	uint32_t reserved;
+};
+
 struct drm_xocl_info {
 	unsigned short vendor;
 	unsigned short device;
@@ -599,11 +674,77 @@ enum drm_xocl_execbuf_state {
  * @exec_bo_handle: BO handle of command buffer formatted as ERT command
  * @deps:	    Upto 8 dependency command BO handles this command is dependent on
  *                  for automatic event dependency handling by ERT
+ * @exec_bo_offset: Byte offset of the ERT command within the exec BO. Non zero
+ *                  only when many commands are carved out of one exec BO. Must
+ *                  be 8 bytes aligned.
+ * @reserved:	    Pass 0
  */
 struct drm_xocl_execbuf {
 	uint32_t ctx_id;
 	uint32_t exec_bo_handle;
 	uint32_t deps[8];
+	uint32_t exec_bo_offset;
+	uint32_t reserved;
+};
+
+#define DRM_XOCL_EXECBUF_VEC_MAX	256
+
+/**
+ * struct drm_xocl_execbuf_vec - Submit many command buffers for execution
+ * used with DRM_IOCTL_XOCL_EXECBUF_VEC ioctl
+ *
+ * @ctx_id:	Pass 0
+ * @count:	Number of commands, at most DRM_XOCL_EXECBUF_VEC_MAX
+ * @execbufs:	User pointer to an array of count struct drm_xocl_execbuf
+ * @submitted:	Returns the number of leading commands that are submitted.
+ *		On error, the commands from this index on are not submitted.
+ * @reserved:	Pass 0
+ */
+struct drm_xocl_execbuf_vec {
+	uint32_t ctx_id;
+	uint32_t count;
+	uint64_t execbufs;
+	uint32_t submitted;
+	uint32_t reserved;
+};
+
+/**
+ * struct drm_xocl_kds_cu_stat - Statistics of a compute unit
+ *
+ * @usage:	Commands completed by the CU, all clients
+ * @submitted:	Commands of the calling client submitted to the CU
+ * @completed:	Commands of the calling client completed by the CU
+ * @inflight:	Commands submitted to the CU and not completed, all clients
+ * @cu_idx:	CU index
+ */
+struct drm_xocl_kds_cu_stat {
+	uint64_t usage;
+	uint64_t submitted;
+	uint64_t completed;
+	uint32_t inflight;
+	uint32_t cu_idx;
+};
+
+/**
+ * struct drm_xocl_kds_stat - Obtain CU and client statistics
+ * used with DRM_IOCTL_XOCL_KDS_STAT ioctl
+ *
+ * @num_cus:	Number of entries at @cus_ptr, returns the number filled
+ * @reserved:	Pass 0
+ * @cus_ptr:	User pointer to an array of struct drm_xocl_kds_cu_stat
+ * @lat_ns:	Sum of submit to completion time of the calling client's
+ *		commands with timestamps enabled
+ * @lat_cnt:	Number of commands in @lat_ns
+ * @expired:	Number of the calling client's commands dropped because
+ *		their deadline passed before they started
+ */
+struct drm_xocl_kds_stat {
+	uint32_t num_cus;
+	uint32_t reserved;
+	uint64_t cus_ptr;
+	uint64_t lat_ns;
+	uint64_t lat_cnt;
+	uint64_t expired;
 };
 
 /**
@@ -616,13 +757,19 @@ struct drm_xocl_execbuf {
  * @exec_bo_handle: BO handle of command buffer formatted as ERT command
  * @deps:	    Upto 8 dependency command BO handles this command is dependent on
  *                  for automatic event dependency handling by ERT
+ * @exec_bo_offset: Byte offset of the ERT command within the exec BO
+ * @reserved:	    Pass 0
  * @cb_func:	    Pointer to callback function(void (\*fn)(long,int)) upon exec completion
  * @cb_data:	    Pointer to context that callback needs to be invoked with
+ *
+ * The leading members must match struct drm_xocl_execbuf.
  */
 struct drm_xocl_execbuf_cb {
 	uint32_t ctx_id;
 	uint32_t exec_bo_handle;
 	uint32_t deps[8];
+	uint32_t exec_bo_offset;
+	uint32_t reserved;
 	uint64_t cb_func;
 	uint64_t cb_data;
 };
@@ -693,6 +840,10 @@ struct drm_xocl_alloc_cma_info {
 #define	DRM_IOCTL_XOCL_ALLOC_CMA	XOCL_IOC_ARG(ALLOC_CMA, alloc_cma_info)
 #define	DRM_IOCTL_XOCL_FREE_CMA		XOCL_IOC(FREE_CMA)
 #define	DRM_IOCTL_XOCL_COPY_BO		XOCL_IOC_ARG(COPY_BO, copy_bo)
+#define	DRM_IOCTL_XOCL_EXECBUF_VEC	XOCL_IOC_ARG(EXECBUF_VEC, execbuf_vec)
+#define	DRM_IOCTL_XOCL_KDS_STAT		XOCL_IOC_ARG(KDS_STAT, kds_stat)
+#define	DRM_IOCTL_XOCL_CTX_VEC		XOCL_IOC_ARG(CTX_VEC, ctx_vec)
+#define	DRM_IOCTL_XOCL_SYNC_BO_VEC	XOCL_IOC_ARG(SYNC_BO_VEC, sync_bo_vec)
 
 #define	DRM_IOCTL_XOCL_KINFO_BO		XOCL_IOC_ARG(KINFO_BO, kinfo_bo)
 #define	DRM_IOCTL_XOCL_MAP_KERN_MEM	XOCL_IOC_ARG(MAP_KERN_MEM, map_kern_mem)
@@ -38,6 +38,11 @@ static unsigned int poll_mode;
 module_param(poll_mode, uint, 0644);
 MODULE_PARM_DESC(poll_mode, "Set 1 for hw polling, default is 0 (interrupts)");
 
+static unsigned int poll_threshold;
+module_param(poll_threshold, uint, 0644);
+MODULE_PARM_DESC(poll_threshold,
+		 "Fast path transfers of at most this many bytes are completed by polling, default is 0 (interrupts)");
+
 static unsigned int interrupt_mode;
 module_param(interrupt_mode, uint, 0644);
 MODULE_PARM_DESC(interrupt_mode, "0 - MSI-x , 1 - MSI, 2 - Legacy");
@@ -739,6 +744,19 @@ static inline void enable_interrupts(struct xdma_engine *engine)
 		channel_interrupts_enable(engine->xdev, engine->irq_bitmask);
 }
 
+static inline void disable_interrupts(struct xdma_engine *engine)
+{
+	if (engine->xdev->msix_enabled) {
+		write_register(
+				engine->interrupt_enable_mask_value,
+				&engine->regs->interrupt_enable_mask_w1c,
+				(unsigned long)(&engine->regs
+					->interrupt_enable_mask_w1c) -
+				(unsigned long)(&engine->regs));
+	} else
+		channel_interrupts_disable(engine->xdev, engine->irq_bitmask);
+}
+
 /**
  * engine_start() - start an idle engine with its first transfer on queue
  *
@@ -3001,6 +3019,7 @@ static int engine_fastpath_init(struct xdma_engine *engine)
 	}
 
 	init_completion(&engine->f_req_compl);
+	engine->f_poll_threshold = poll_threshold;
 
 	return 0;
 }
@@ -3229,7 +3248,8 @@ static inline void fastpath_desc_clear_last(struct xdma_engine *engine, u32 desc
 }
 
 static ssize_t fastpath_start(struct xdma_engine *engine, u64 endpoint_addr,
-			      struct scatterlist **sg, u32 *sg_off, u32 *last_adj)
+			      struct scatterlist **sg, u32 *sg_off, u32 *last_adj,
+			      bool polled)
 {
 	dma_addr_t addr;
 	int i, ret = 0;
@@ -3255,7 +3275,10 @@ static ssize_t fastpath_start(struct xdma_engine *engine, u64 endpoint_addr,
 	fastpath_desc_set_last(engine, i);
 	engine->f_submitted_desc_cnt = i;
 
-	enable_interrupts(engine);
+	if (polled)
+		disable_interrupts(engine);
+	else
+		enable_interrupts(engine);
 	if (i >= F_DESC_ADJACENT)
 		adj = F_DESC_ADJACENT;
 	else
@@ -3272,6 +3295,28 @@ static ssize_t fastpath_start(struct xdma_engine *engine, u64 endpoint_addr,
 	return ret ? -EIO : total;
 }
 
+/*
+ * Busy wait for the engine to stop after a fast path submission. Used
+ * for small transfers where the interrupt and wakeup latency is larger
+ * than the transfer time.
+ */
+static int fastpath_poll(struct xdma_engine *engine)
+{
+	unsigned long timeout = jiffies + msecs_to_jiffies(10000);
+	u32 polls = 0;
+
+	while (read_register(&engine->regs->status) & XDMA_STAT_BUSY) {
+		if (time_after(jiffies, timeout))
+			return -ETIMEDOUT;
+		if (++polls % NUM_POLLS_PER_SCHED == 0)
+			cond_resched();
+		else
+			cpu_relax();
+	}
+
+	return 0;
+}
+
 ssize_t xdma_xfer_fastpath(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			   struct sg_table *sgt, bool dma_mapped, int timeout_ms)
 {
@@ -3279,9 +3324,10 @@ ssize_t xdma_xfer_fastpath(void *dev_hndl, int channel, bool write, u64 ep_addr,
 	struct scatterlist *sg = sgt->sgl;
 	struct xdma_engine *engine;
 	u32 val, sg_off = 0, last_adj = ~0;
-	u64 done_bytes = 0;
+	u64 done_bytes = 0, total_bytes = 0;
 	ssize_t ret = 0;
-	int nents;
+	bool polled;
+	int nents, i;
 
 	if (poll_mode) {
 		return xdma_xfer_submit(dev_hndl, channel, write, ep_addr, sgt, dma_mapped,
@@ -3307,6 +3353,10 @@ ssize_t xdma_xfer_fastpath(void *dev_hndl, int channel, bool write, u64 ep_addr,
 		return -EINVAL;
 	}
 
+	for_each_sg(sgt->sgl, sg, sgt->nents, i)
+		total_bytes += sg_dma_len(sg);
+	polled = total_bytes <= engine->f_poll_threshold;
+
 	write_register(PCI_DMA_H(engine->f_desc_dma_addr), &engine->sgdma_regs->first_desc_hi,
 		       (unsigned long)(&engine->sgdma_regs->first_desc_hi) -
 		       (unsigned long)(&engine->sgdma_regs));
@@ -3315,14 +3365,16 @@ ssize_t xdma_xfer_fastpath(void *dev_hndl, int channel, bool write, u64 ep_addr,
 		       (unsigned long)(&engine->sgdma_regs));
 	sg = sgt->sgl;
 	while (sg && ret >= 0) {
-		engine->f_fastpath = true;
-		ret = fastpath_start(engine, ep_addr + done_bytes,&sg, &sg_off, &last_adj);
+		engine->f_fastpath = !polled;
+		ret = fastpath_start(engine, ep_addr + done_bytes, &sg, &sg_off, &last_adj,
+				     polled);
 		if (ret < 0) {
 			engine->f_fastpath = false;
 			break;
 		}
 		done_bytes += ret;
-		if (!wait_for_completion_timeout(&engine->f_req_compl,
+		if (polled ? fastpath_poll(engine) :
+		    !wait_for_completion_timeout(&engine->f_req_compl,
 						 msecs_to_jiffies(10000))) {
 			pr_err("Wait for request timed out");
 			engine_reg_dump(engine);
@@ -3363,6 +3415,46 @@ ssize_t xdma_xfer_fastpath(void *dev_hndl, int channel, bool write, u64 ep_addr,
 	return (ssize_t)done_bytes;
 }
 
+int xdma_set_poll_threshold(void *dev_hndl, int channel, bool write, u32 bytes)
+{
+	struct xdma_dev *xdev = (struct xdma_dev *)dev_hndl;
+
+	if (!dev_hndl)
+		return -EINVAL;
+
+	if (write) {
+		if (channel < 0 || channel >= xdev->h2c_channel_max)
+			return -EINVAL;
+		xdev->engine_h2c[channel].f_poll_threshold = bytes;
+	} else {
+		if (channel < 0 || channel >= xdev->c2h_channel_max)
+			return -EINVAL;
+		xdev->engine_c2h[channel].f_poll_threshold = bytes;
+	}
+
+	return 0;
+}
+
+int xdma_get_poll_threshold(void *dev_hndl, int channel, bool write, u32 *bytes)
+{
+	struct xdma_dev *xdev = (struct xdma_dev *)dev_hndl;
+
+	if (!dev_hndl)
+		return -EINVAL;
+
+	if (write) {
+		if (channel < 0 || channel >= xdev->h2c_channel_max)
+			return -EINVAL;
+		*bytes = xdev->engine_h2c[channel].f_poll_threshold;
+	} else {
+		if (channel < 0 || channel >= xdev->c2h_channel_max)
+			return -EINVAL;
+		*bytes = xdev->engine_c2h[channel].f_poll_threshold;
+	}
+
+	return 0;
+}
+
 ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			 struct sg_table *sgt, bool dma_mapped, int timeout_ms,
 			 struct xdma_io_cb *cb)
@@ -550,6 +550,8 @@ struct xdma_engine {
 	u32 f_submitted_desc_cnt;
 	struct completion f_req_compl;
 	bool f_fastpath;
+	/* fast path transfers up to this size are completed by polling */
+	u32 f_poll_threshold;
 };
 
 struct xdma_user_irq {
@@ -174,6 +174,14 @@ ssize_t xdma_xfer_submit(void *dev_hndl, int channel, bool write, u64 ep_addr,
 		       	struct xdma_io_cb *cb);
 ssize_t xdma_xfer_fastpath(void *dev_hndl, int channel, bool write, u64 ep_addr,
 			struct sg_table *sgt, bool dma_mapped, int timeout_ms);
+
+/*
+ * xdma_set_poll_threshold - complete fast path transfers of at most
+ *	bytes on a channel by polling rather than by interrupt, 0 disables
+ * xdma_get_poll_threshold - get the polled completion threshold
+ */
+int xdma_set_poll_threshold(void *dev_hndl, int channel, bool write, u32 bytes);
+int xdma_get_poll_threshold(void *dev_hndl, int channel, bool write, u32 *bytes);
 			
 /*
  * xdma_device_online - bring device offline
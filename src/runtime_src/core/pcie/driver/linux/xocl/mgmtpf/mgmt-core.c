@@ -1005,8 +1005,11 @@ void xclmgmt_mailbox_srv(void *arg, void *data, size_t len,
 		resp->version = min(XCL_MB_PROTOCOL_VER, conn->version);
 		resp->conn_flags |= XCL_MB_PEER_READY;
 		/* Same domain check only applies when everything is thru HW. */
-		if (!ch_switch && xclmgmt_is_same_domain(lro, conn))
+		if (!ch_switch && xclmgmt_is_same_domain(lro, conn)) {
 			resp->conn_flags |= XCL_MB_PEER_SAME_DOMAIN;
+			if (resp->version >= 1)
+				resp->conn_flags |= XCL_MB_PEER_BULK_CHAN;
+		}
 		resp->chan_switch = ch_switch;
 		resp->chan_disable = ch_disable;
 		(void) xocl_mailbox_get(lro, COMM_ID, (u64 *)resp->comm_id);
@@ -521,6 +521,15 @@ static DEVICE_ATTR(config_xclbin_change, 0644,
 	config_xclbin_change_show,
 	config_xclbin_change_store);
 
+static ssize_t subdev_probe_us_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	struct xclmgmt_dev *lro = dev_get_drvdata(dev);
+
+	return xocl_subdev_show_probe_times(lro, buf);
+}
+static DEVICE_ATTR_RO(subdev_probe_us);
+
 static struct attribute *mgmt_attrs[] = {
 	&dev_attr_instance.attr,
 	&dev_attr_error.attr,
@@ -551,6 +560,7 @@ static struct attribute *mgmt_attrs[] = {
 	&dev_attr_sbr_toggle.attr,
 	&dev_attr_cache_xclbin.attr,
 	&dev_attr_config_xclbin_change.attr,
+	&dev_attr_subdev_probe_us.attr,
 	NULL,
 };
 
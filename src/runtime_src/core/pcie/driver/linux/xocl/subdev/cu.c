@@ -183,6 +183,19 @@ is_ucu_show(struct device *dev, struct device_attribute *attr, char *buf)
 }
 static DEVICE_ATTR_RO(is_ucu);
 
+static ssize_t
+fa_desc_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct platform_device *pdev = to_platform_device(dev);
+	struct xocl_cu *cu = platform_get_drvdata(pdev);
+	u64 bar = 0, desc_addr = 0;
+	u32 slot_sz = 0, num_slots = 0;
+
+	(void) xrt_fa_get_desc(&cu->base, &bar, &desc_addr, &slot_sz, &num_slots);
+	return sprintf(buf, "0x%llx %u %u\n", desc_addr, slot_sz, num_slots);
+}
+static DEVICE_ATTR_RO(fa_desc);
+
 static ssize_t
 crc_buf_show(struct file *filp, struct kobject *kobj,
 	     struct bin_attribute *attr, char *buf,
@@ -210,6 +223,7 @@ static struct attribute *cu_attrs[] = {
 	&dev_attr_size.attr,
 	&dev_attr_stat.attr,
 	&dev_attr_is_ucu.attr,
+	&dev_attr_fa_desc.attr,
 	NULL,
 };
 
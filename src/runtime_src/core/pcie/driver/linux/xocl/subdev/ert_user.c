@@ -65,6 +65,8 @@ struct ert_user_event {
 struct ert_user_queue {
 	struct list_head	head;
 	uint32_t		num;
+	/* commands with other than normal priority */
+	uint32_t		num_prio;
 };
 
 
@@ -1030,6 +1032,16 @@ int process_ert_rq(struct xocl_ert_user *ert_user, struct ert_user_queue *rq, st
 			bad_cmd = true;
 		}
 
+		/* Drop command that can no longer start in time */
+		if (unlikely(xcmd && xcmd->deadline) &&
+		    ktime_get_ns() > xcmd->deadline) {
+			ecmd->complete_entry.hdr.cstate = KDS_EXPIRED;
+			list_move_tail(&ecmd->list, &ert_user->cq.head);
+			--rq->num;
+			++ert_user->cq.num;
+			continue;
+		}
+
 		if (unlikely(bad_cmd)) {
 			list_move_tail(&ecmd->list, &ert_user->cq.head);
 			--rq->num;
@@ -1085,17 +1097,57 @@ int process_ert_rq(struct xocl_ert_user *ert_user, struct ert_user_queue *rq, st
 	return 1;
 }
 
+static inline u32 ert_priority_rank(struct xrt_ert_command *ecmd)
+{
+	if (!ecmd->xcmd)
+		return 1;
+
+	switch (ecmd->xcmd->priority) {
+	case ERT_CMD_PRIORITY_HIGH:
+		return 0;
+	case ERT_CMD_PRIORITY_BULK:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+/**
+ * ert_queue_by_priority() - Move commands to run queue by priority
+ * @pq: Pending queue
+ * @rq: Run queue ordered high, normal, bulk
+ *
+ * Each command is placed after the commands of the same or higher
+ * priority, so the order of commands with the same priority is kept.
+ */
+static inline void ert_queue_by_priority(struct ert_user_queue *pq, struct ert_user_queue *rq)
+{
+	struct xrt_ert_command *ecmd, *next, *pos;
+	u32 rank;
+
+	list_for_each_entry_safe(ecmd, next, &pq->head, list) {
+		rank = ert_priority_rank(ecmd);
+		list_for_each_entry_reverse(pos, &rq->head, list) {
+			if (ert_priority_rank(pos) <= rank)
+				break;
+		}
+		list_move(&ecmd->list, &pos->list);
+	}
+}
+
 /**
  * process_ert_pq() - Process pending queue
  * @ert_user: Target XRT ERT
  * @pq: Target pending queue
  * @rq: Target running queue
  *
- * Move all of the pending queue commands to the tail of run queue
- * and re-initialized pending queue
+ * Move all of the pending queue commands to the run queue and
+ * re-initialized pending queue. Commands are appended to the tail of
+ * run queue unless priorities are in use.
  */
 static inline void process_ert_pq(struct xocl_ert_user *ert_user, struct ert_user_queue *pq, struct ert_user_queue *rq)
 {
+	struct xrt_ert_command *last;
 	unsigned long flags;
 
 	/* Get pending queue command number without lock.
@@ -1107,9 +1159,17 @@ static inline void process_ert_pq(struct xocl_ert_user *ert_user, struct ert_use
 
 	spin_lock_irqsave(&ert_user->pq_lock, flags);
 	if (pq->num) {
-		list_splice_tail_init(&pq->head, &rq->head);
+		last = rq->num ?
+			list_last_entry(&rq->head, struct xrt_ert_command, list) : NULL;
+		if (pq->num_prio ||
+		    (last && last->xcmd &&
+		     last->xcmd->priority == ERT_CMD_PRIORITY_BULK))
+			ert_queue_by_priority(pq, rq);
+		else
+			list_splice_tail_init(&pq->head, &rq->head);
 		rq->num += pq->num;
 		pq->num = 0;
+		pq->num_prio = 0;
 	}
 	spin_unlock_irqrestore(&ert_user->pq_lock, flags);
 }
@@ -1130,6 +1190,9 @@ ert_user_cmd_submit(struct xocl_ert_user *ert_user, struct xrt_ert_command *ecmd
 	case ERT_SK_START:
 		list_add_tail(&ecmd->list, &ert_user->pq.head);
 		++ert_user->pq.num;
+		if (ecmd->xcmd &&
+		    ecmd->xcmd->priority != ERT_CMD_PRIORITY_NORMAL)
+			++ert_user->pq.num_prio;
 		break;
 	case ERT_CLK_CALIB:
 	case ERT_SK_CONFIG:
@@ -531,15 +531,15 @@ failed:
 	return err;
 }
 
-static int hwmon_sdm_update_sensors_by_type(struct platform_device *pdev,
-                                            enum xgq_sdr_repo_type repo_type,
-                                            bool create_sysfs)
+//TODO: request vmc/vmr for bdinfo resp size
+#define HWMON_SDM_RESP_SIZE             (4 * 1024)
+
+/* Allocate the response buffer of a sensor repo, returns the repo id */
+static int hwmon_sdm_alloc_sensor_data(struct platform_device *pdev,
+                                       enum xgq_sdr_repo_type repo_type)
 {
 	struct xocl_hwmon_sdm *sdm = platform_get_drvdata(pdev);
-	xdev_handle_t xdev = xocl_get_xdev(pdev);
-	int repo_id, ret;
-	//TODO: request vmc/vmr for bdinfo resp size
-	uint32_t resp_size = 4 * 1024;
+	int repo_id;
 
 	repo_id = sdr_get_id(repo_type);
 	if (repo_id < 0) {
@@ -547,10 +547,19 @@ static int hwmon_sdm_update_sensors_by_type(struct platform_device *pdev,
 		return -EINVAL;
 	}
 
-	sdm->sensor_data[repo_id] = (char*)kzalloc(sizeof(char) * resp_size,
+	sdm->sensor_data[repo_id] = (char*)kzalloc(sizeof(char) * HWMON_SDM_RESP_SIZE,
                                                GFP_KERNEL);
-	ret = xocl_xgq_collect_sensors_by_id(xdev, sdm->sensor_data[repo_id],
-                                         repo_id, resp_size);
+	if (!sdm->sensor_data[repo_id])
+		return -ENOMEM;
+
+	return repo_id;
+}
+
+static int hwmon_sdm_parse_sensor_data(struct platform_device *pdev,
+                                       int repo_id, int ret, bool create_sysfs)
+{
+	struct xocl_hwmon_sdm *sdm = platform_get_drvdata(pdev);
+
 	if (!ret) {
 		ret = parse_sdr_info(sdm->sensor_data[repo_id], sdm, create_sysfs);
 		if (!ret)
@@ -563,10 +572,53 @@ static int hwmon_sdm_update_sensors_by_type(struct platform_device *pdev,
 	return ret;
 }
 
+static int hwmon_sdm_update_sensors_by_type(struct platform_device *pdev,
+                                            enum xgq_sdr_repo_type repo_type,
+                                            bool create_sysfs)
+{
+	struct xocl_hwmon_sdm *sdm = platform_get_drvdata(pdev);
+	xdev_handle_t xdev = xocl_get_xdev(pdev);
+	int repo_id, ret;
+
+	repo_id = hwmon_sdm_alloc_sensor_data(pdev, repo_type);
+	if (repo_id < 0)
+		return repo_id;
+
+	ret = xocl_xgq_collect_sensors_by_id(xdev, sdm->sensor_data[repo_id],
+                                         repo_id, HWMON_SDM_RESP_SIZE);
+
+	return hwmon_sdm_parse_sensor_data(pdev, repo_id, ret, create_sysfs);
+}
+
+/*
+ * Board info and temperature repos are requested in one batch, so both
+ * requests are outstanding on the device at the same time.
+ */
 static void hwmon_sdm_get_sensors_list(struct platform_device *pdev, bool create_sysfs)
 {
-	(void) hwmon_sdm_update_sensors_by_type(pdev, SDR_TYPE_BDINFO, false);
-	(void) hwmon_sdm_update_sensors_by_type(pdev, SDR_TYPE_TEMP, create_sysfs);
+	struct xocl_hwmon_sdm *sdm = platform_get_drvdata(pdev);
+	xdev_handle_t xdev = xocl_get_xdev(pdev);
+	enum xgq_sdr_repo_type types[] = { SDR_TYPE_BDINFO, SDR_TYPE_TEMP };
+	char *bufs[ARRAY_SIZE(types)];
+	uint8_t ids[ARRAY_SIZE(types)];
+	int rets[ARRAY_SIZE(types)];
+	int i, repo_id, ret;
+
+	for (i = 0; i < ARRAY_SIZE(types); i++) {
+		repo_id = hwmon_sdm_alloc_sensor_data(pdev, types[i]);
+		if (repo_id < 0)
+			return;
+		ids[i] = repo_id;
+		bufs[i] = sdm->sensor_data[repo_id];
+	}
+
+	ret = xocl_xgq_collect_sensors_batch(xdev, bufs, ids,
+                                         HWMON_SDM_RESP_SIZE, ARRAY_SIZE(types), rets);
+	for (i = 0; i < ARRAY_SIZE(types); i++) {
+		/* sysfs nodes are created for the temperature repo only */
+		(void) hwmon_sdm_parse_sensor_data(pdev, ids[i], ret ? ret : rets[i],
+                                           create_sysfs && types[i] == SDR_TYPE_TEMP);
+	}
 }
 
 static int hwmon_sdm_update_sensors(struct platform_device *pdev, uint8_t repo_id)
@@ -88,6 +88,28 @@ static struct key *icap_keys = NULL;
 
 static struct attribute_group icap_attr_group;
 
+/* Phases of the last xclbin download, timed for the download_time sysfs */
+enum icap_dl_phase {
+	ICAP_DL_VERIFY = 0,
+	ICAP_DL_FREEZE,
+	ICAP_DL_DOWNLOAD,
+	ICAP_DL_CLOCK,
+	ICAP_DL_UNFREEZE,
+	ICAP_DL_CALIB,
+	ICAP_DL_TOTAL,
+	ICAP_DL_MAX,
+};
+
+static const char *icap_dl_phase_names[ICAP_DL_MAX] = {
+	"verify",
+	"freeze",
+	"download",
+	"clock",
+	"unfreeze",
+	"calib",
+	"total",
+};
+
 enum icap_sec_level {
 	ICAP_SEC_NONE = 0,
 	ICAP_SEC_DEDICATE,
@@ -182,6 +204,9 @@ struct icap {
 	wait_queue_head_t	reader_wq;
 
 	uint32_t		data_retention;
+
+	/* time in us spent in each phase of the last xclbin download */
+	u64			dl_time_us[ICAP_DL_MAX];
 };
 
 static inline u32 reg_rd(void __iomem *reg)
@@ -371,6 +396,12 @@ static unsigned short icap_cached_ocl_frequency(const struct icap *icap, int idx
 	return freq;
 }
 
+static inline void icap_dl_time(struct icap *icap, enum icap_dl_phase phase,
+	ktime_t start)
+{
+	icap->dl_time_us[phase] = ktime_us_delta(ktime_get(), start);
+}
+
 static bool icap_bitstream_in_use(struct icap *icap)
 {
 	BUG_ON(icap->icap_bitstream_ref < 0);
@@ -1189,10 +1220,14 @@ static long axlf_set_freqscaling(struct icap *icap)
 static int icap_download_bitstream(struct icap *icap, const struct axlf *axlf)
 {
 	long err = 0;
+	ktime_t start = ktime_get();
 
 	icap_freeze_axi_gate(icap);
+	icap_dl_time(icap, ICAP_DL_FREEZE, start);
 
+	start = ktime_get();
 	err = icap_download_hw(icap, axlf);
+	icap_dl_time(icap, ICAP_DL_DOWNLOAD, start);
 	/*
 	 * Perform frequency scaling since PR download can silenty overwrite
 	 * MMCM settings in static region changing the clock frequencies
@@ -1201,11 +1236,15 @@ static int icap_download_bitstream(struct icap *icap, const struct axlf *axlf)
 	 * changed.
 	 */
 	if (!err) {
+		start = ktime_get();
 		err = xocl_clock_freq_rescaling(xocl_get_xdev(icap->icap_pdev), true);
 		err = (err == -ENODEV) ? 0 : err;
+		icap_dl_time(icap, ICAP_DL_CLOCK, start);
 	}
 
+	start = ktime_get();
 	icap_free_axi_gate(icap);
+	icap_dl_time(icap, ICAP_DL_UNFREEZE, start);
 	return err;
 }
 
@@ -2142,10 +2181,12 @@ static int __icap_xclbin_download(struct icap *icap, struct axlf *xclbin, bool s
 	xdev_handle_t xdev = xocl_get_xdev(icap->icap_pdev);
 	int err = 0;
 	bool retention = ((icap->data_retention & 0x1) == 0x1) && sref;
+	ktime_t start = ktime_get();
 
 	BUG_ON(!mutex_is_locked(&icap->icap_lock));
 
 	err = icap_verify_signed_signature(icap, xclbin);
+	icap_dl_time(icap, ICAP_DL_VERIFY, start);
 	if (err)
 		goto out;
 
@@ -2205,6 +2246,7 @@ static int __icap_xclbin_download(struct icap *icap, struct axlf *xclbin, bool s
 			ICAP_ERR(icap, "not able to refresh clock freq");
 	}
 
+	start = ktime_get();
 	icap_calib(icap, retention);
 
 	if (retention) {
@@ -2216,6 +2258,7 @@ static int __icap_xclbin_download(struct icap *icap, struct axlf *xclbin, bool s
 	}
 
 	err = icap_calibrate_mig(icap->icap_pdev);
+	icap_dl_time(icap, ICAP_DL_CALIB, start);
 
 out:
 	if (err && retention)
@@ -2487,12 +2530,15 @@ static int icap_download_bitstream_axlf(struct platform_device *pdev,
 	int err = 0;
 	xdev_handle_t xdev = xocl_get_xdev(pdev);
 	const struct axlf_section_header *header = NULL;
+	ktime_t start;
 
 	err = icap_xclbin_wr_lock(icap);
 	if (err)
 		return err;
 
 	mutex_lock(&icap->icap_lock);
+	memset(icap->dl_time_us, 0, sizeof(icap->dl_time_us));
+	start = ktime_get();
 
 	/* Sanity check xclbin. */
 	if (memcmp(xclbin->m_magic, ICAP_XCLBIN_V2, sizeof(ICAP_XCLBIN_V2))) {
@@ -2556,6 +2602,7 @@ static int icap_download_bitstream_axlf(struct platform_device *pdev,
 	err = __icap_download_bitstream_axlf(pdev, xclbin, force_download);
 
 done:
+	icap_dl_time(icap, ICAP_DL_TOTAL, start);
 	mutex_unlock(&icap->icap_lock);
 	icap_xclbin_wr_unlock(icap);
 	ICAP_INFO(icap, "err: %d", err);
@@ -3402,6 +3449,24 @@ static ssize_t max_host_mem_aperture_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(max_host_mem_aperture);
 
+static ssize_t download_time_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	struct icap *icap = platform_get_drvdata(to_platform_device(dev));
+	ssize_t cnt = 0;
+	int i;
+
+	mutex_lock(&icap->icap_lock);
+	for (i = 0; i < ICAP_DL_MAX; i++) {
+		cnt += sprintf(buf + cnt, "%s: %llu us\n",
+			icap_dl_phase_names[i], icap->dl_time_us[i]);
+	}
+	mutex_unlock(&icap->icap_lock);
+
+	return cnt;
+}
+static DEVICE_ATTR_RO(download_time);
+
 static struct attribute *icap_attrs[] = {
 	&dev_attr_clock_freqs.attr,
 	&dev_attr_idcode.attr,
@@ -3412,6 +3477,7 @@ static struct attribute *icap_attrs[] = {
 	&dev_attr_reader_cnt.attr,
 	&dev_attr_data_retention.attr,
 	&dev_attr_max_host_mem_aperture.attr,
+	&dev_attr_download_time.attr,
 	NULL,
 };
 
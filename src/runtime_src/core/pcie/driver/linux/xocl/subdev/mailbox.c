@@ -162,6 +162,21 @@
  * The interface between daemons and mailbox is defined as struct sw_chan. Refer
  * to mailbox_proto.h for details.
  *
+ *
+ * Bulk data channel
+ *
+ * When mgmt pf finds the user pf in the same domain and both speak protocol
+ * version 1, it sets XCL_MB_PEER_BULK_CHAN in the connection state. From then
+ * on, a msg sent through HW channel larger than mailbox_bulk_threshold is not
+ * broken into packets. Instead, the sender copies it into a buffer from the
+ * kernel linear mapping and sends a single PKT_MSG_BULK packet carrying the
+ * KVA, size and CRC of that buffer. The receiver copies the msg out of the
+ * buffer and verifies the CRC. The FIFO only carries control traffic then.
+ * The sender keeps the buffer for MSG_RX_DEFAULT_TTL seconds, long enough for
+ * the receiver to pick up the packet. The buffer is never vmalloc'ed, so a
+ * late reader sees stale data, which fails the CRC check, rather than an
+ * unmapped address.
+ *
  * Communication protocols
  *
  * As indicated above, the packet layer and msg layer communication protocol is
@@ -198,6 +213,7 @@
 #include <linux/fs.h>
 #include <linux/io.h>
 #include <linux/ioctl.h>
+#include <linux/crc32c.h>
 #include "../xocl_drv.h"
 #include "mailbox_proto.h"
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0)
@@ -214,6 +230,11 @@ module_param(mailbox_test_mode, int, (S_IRUGO|S_IWUSR));
 MODULE_PARM_DESC(mailbox_test_mode,
 	"Turn on mailbox mode to run positive/negative test");
 
+static uint mailbox_bulk_threshold = 256;
+module_param(mailbox_bulk_threshold, uint, (S_IRUGO|S_IWUSR));
+MODULE_PARM_DESC(mailbox_bulk_threshold,
+	"Msgs larger than this (in bytes) bypass the HW FIFO when peer is in the same domain (0 = disable)");
+
 #define	PACKET_SIZE	16 /* Number of DWORD. */
 
 /*
@@ -262,6 +283,9 @@ MODULE_PARM_DESC(mailbox_test_mode,
 
 #define	BYTE_TO_MB(x)		((x)>>20)
 
+/* Larger msgs always go through packets. */
+#define	MAX_BULK_SZ		(PAGE_SIZE << 8)
+
 #define MB_SW_ONLY(mbx) ((mbx)->mbx_regs == NULL)
 /*
  * Mailbox IP register layout
@@ -309,7 +333,8 @@ enum packet_type {
 	PKT_INVALID = 0,
 	PKT_TEST,
 	PKT_MSG_START,
-	PKT_MSG_BODY
+	PKT_MSG_BODY,
+	PKT_MSG_BULK
 };
 
 /* Lower 8 bits for type, the rest for flags. */
@@ -334,6 +359,32 @@ struct mailbox_pkt {
 	} body;
 } __attribute__((packed));
 
+/*
+ * Payload of a PKT_MSG_BULK packet, which otherwise looks like a start-of-msg
+ * packet with end-of-msg flag. Payload size of the packet is the msg size.
+ */
+struct mailbox_bulk_desc {
+	u64			kaddr;
+	u32			crc32;
+	u32			reserved;
+} __attribute__((packed));
+
+/* Buffer holding a msg sent through bulk channel. */
+struct mailbox_bulk {
+	struct list_head	mbb_list;
+	unsigned long		mbb_expires; /* in jiffies */
+	size_t			mbb_size;
+	char			mbb_data[0];
+};
+
+/* Latency of requests sent to or served for peer, per OP code. */
+struct mailbox_req_stat {
+	u64			mrs_count;
+	u64			mrs_errors;
+	u64			mrs_total_us;
+	u64			mrs_max_us;
+};
+
 /* Mailbox communication channel state. */
 #define MBXCS_BIT_READY		0
 #define MBXCS_BIT_STOP		1
@@ -463,6 +514,18 @@ struct mailbox {
 	size_t			mbx_recv_raw_bytes;
 	size_t			mbx_recv_req[XCL_MAILBOX_REQ_MAX];
 
+	/*
+	 * Bulk channel buffers waiting for peer to pick up, oldest first.
+	 * Only touched by TX worker and after it is stopped.
+	 */
+	struct list_head	mbx_bulk_list;
+	size_t			mbx_sent_bulk_bytes;
+	size_t			mbx_recv_bulk_bytes;
+
+	spinlock_t		mbx_stat_lock;
+	struct mailbox_req_stat	mbx_sent_stat[XCL_MAILBOX_REQ_MAX];
+	struct mailbox_req_stat	mbx_served_stat[XCL_MAILBOX_REQ_MAX];
+
 	uint32_t		mbx_prot_ver;
 	uint64_t		mbx_ch_state;
 	uint64_t		mbx_ch_disable;
@@ -1297,6 +1360,40 @@ static int chan_pkt2msg(struct mailbox_channel *ch)
 	return 0;
 }
 
+/* Copy msg sent through bulk channel into current msg. */
+static int chan_bulk2msg(struct mailbox_channel *ch)
+{
+	struct mailbox *mbx = ch->mbc_parent;
+	struct mailbox_msg *msg = ch->mbc_cur_msg;
+	struct mailbox_pkt *pkt = &ch->mbc_packet;
+	struct mailbox_bulk_desc *desc =
+		(struct mailbox_bulk_desc *)pkt->body.msg_start.payload;
+	size_t cnt = pkt->body.msg_start.msg_size;
+	void *src = (void *)(uintptr_t)desc->kaddr;
+
+	if (cnt == 0 || cnt > MAX_BULK_SZ || cnt > msg->mbm_len ||
+		cnt != pkt->hdr.payload_size) {
+		MBX_ERR(mbx, "invalid mailbox bulk size %ld\n", cnt);
+		return -EBADMSG;
+	}
+	if (!virt_addr_valid(src) || !virt_addr_valid(src + cnt - 1)) {
+		MBX_ERR(mbx, "invalid mailbox bulk address\n");
+		return -EFAULT;
+	}
+
+	(void) memcpy(msg->mbm_data, src, cnt);
+	if (crc32c_le(~0, msg->mbm_data, cnt) != desc->crc32) {
+		MBX_ERR(mbx, "mailbox bulk crc mismatch (id 0x%llx)\n",
+			msg->mbm_req_id);
+		return -EBADMSG;
+	}
+
+	msg->mbm_req_id = pkt->body.msg_start.msg_req_id;
+	msg->mbm_len = cnt;
+	mbx->mbx_recv_bulk_bytes += cnt;
+	return 0;
+}
+
 /* Prepare outstanding msg for receiving incoming msg. */
 static void dequeue_rx_msg(struct mailbox_channel *ch,
 	u32 flags, u64 id, size_t sz)
@@ -1467,6 +1564,30 @@ static bool do_hw_rx(struct mailbox_channel *ch)
 			reset_pkt(pkt);
 		}
 		break;
+	case PKT_MSG_BULK:
+		if (!(mbx->mbx_ch_state & XCL_MB_PEER_BULK_CHAN)) {
+			MBX_WARN(mbx, "got bulk pkt, bulk channel is off\n");
+			reset_pkt(pkt);
+			break;
+		}
+		if (ch->mbc_cur_msg) {
+			MBX_WARN(mbx, "Received partial msg (id 0x%llx)\n",
+				ch->mbc_cur_msg->mbm_req_id);
+			chan_msg_done(ch, -EBADMSG);
+		}
+
+		dequeue_rx_msg(ch, pkt->body.msg_start.msg_flags,
+			pkt->body.msg_start.msg_req_id,
+			pkt->body.msg_start.msg_size);
+
+		if (ch->mbc_cur_msg) {
+			chan_msg_done(ch, chan_bulk2msg(ch));
+			recvd = true;
+		} else {
+			MBX_WARN(mbx, "got unexpected msg bulk pkt\n");
+		}
+		reset_pkt(pkt);
+		break;
 	default:
 		MBX_WARN(mbx, "invalid mailbox pkt type: %d\n", type);
 		reset_pkt(pkt);
@@ -1538,6 +1659,62 @@ static void chan_msg2pkt(struct mailbox_channel *ch)
 	(void) memcpy(pkt_data, msg_data, cnt);
 }
 
+/* Free bulk buffers peer had enough time to pick up, or all of them. */
+static void mailbox_bulk_reclaim(struct mailbox *mbx, bool all)
+{
+	struct mailbox_bulk *bulk, *next;
+
+	list_for_each_entry_safe(bulk, next, &mbx->mbx_bulk_list, mbb_list) {
+		if (!all && time_before(jiffies, bulk->mbb_expires))
+			break;
+		list_del(&bulk->mbb_list);
+		free_pages_exact(bulk, sizeof(*bulk) + bulk->mbb_size);
+	}
+}
+
+/*
+ * Turn current msg into a bulk packet if peer can take it. Returns false if
+ * the msg has to be sent through packets.
+ */
+static bool chan_msg2bulk(struct mailbox_channel *ch)
+{
+	struct mailbox *mbx = ch->mbc_parent;
+	struct mailbox_msg *msg = ch->mbc_cur_msg;
+	struct mailbox_pkt *pkt = &ch->mbc_packet;
+	struct mailbox_bulk_desc *desc;
+	struct mailbox_bulk *bulk;
+
+	if (!(mbx->mbx_ch_state & XCL_MB_PEER_BULK_CHAN) ||
+		!mailbox_bulk_threshold || ch->mbc_bytes_done != 0 ||
+		msg->mbm_len <= mailbox_bulk_threshold ||
+		msg->mbm_len > MAX_BULK_SZ)
+		return false;
+
+	mailbox_bulk_reclaim(mbx, false);
+
+	bulk = alloc_pages_exact(sizeof(*bulk) + msg->mbm_len,
+		GFP_KERNEL | __GFP_NOWARN);
+	if (!bulk)
+		return false;
+	bulk->mbb_size = msg->mbm_len;
+	bulk->mbb_expires = jiffies + MSG_RX_DEFAULT_TTL * HZ;
+	(void) memcpy(bulk->mbb_data, msg->mbm_data, msg->mbm_len);
+	list_add_tail(&bulk->mbb_list, &mbx->mbx_bulk_list);
+
+	pkt->hdr.type = PKT_MSG_BULK | PKT_TYPE_MSG_END;
+	pkt->hdr.payload_size = msg->mbm_len;
+	pkt->body.msg_start.msg_req_id = msg->mbm_req_id;
+	pkt->body.msg_start.msg_size = msg->mbm_len;
+	pkt->body.msg_start.msg_flags = msg->mbm_flags;
+	desc = (struct mailbox_bulk_desc *)pkt->body.msg_start.payload;
+	desc->kaddr = (u64)(uintptr_t)bulk->mbb_data;
+	desc->crc32 = crc32c_le(~0, bulk->mbb_data, msg->mbm_len);
+	desc->reserved = 0;
+
+	mbx->mbx_sent_bulk_bytes += msg->mbm_len;
+	return true;
+}
+
 static void do_sw_tx(struct mailbox_channel *ch)
 {
 	mutex_lock(&ch->sw_chan_mutex);
@@ -1569,7 +1746,9 @@ static void do_sw_tx(struct mailbox_channel *ch)
 static void do_hw_tx(struct mailbox_channel *ch)
 {
 	BUG_ON(ch->mbc_cur_msg == NULL || ch->mbc_cur_msg->mbm_chan_sw);
-	chan_msg2pkt(ch);
+	/* Whole msg is done after sending bulk pkt, see chan_send_pkt() */
+	if (!chan_msg2bulk(ch))
+		chan_msg2pkt(ch);
 	chan_send_pkt(ch);
 }
 
@@ -1860,6 +2039,42 @@ static ssize_t recv_metrics_show(struct device *dev,
 
 static DEVICE_ATTR_RO(recv_metrics);
 
+static ssize_t req_latency_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	struct platform_device *pdev = to_platform_device(dev);
+	struct mailbox *mbx = platform_get_drvdata(pdev);
+	struct mailbox_req_stat *stat;
+	ssize_t count = 0;
+	int i, j;
+
+	count += sprintf(buf + count, "bulk bytes sent: %ld\n",
+		mbx->mbx_sent_bulk_bytes);
+	count += sprintf(buf + count, "bulk bytes received: %ld\n",
+		mbx->mbx_recv_bulk_bytes);
+
+	spin_lock(&mbx->mbx_stat_lock);
+	for (j = 0; j < 2; j++) {
+		stat = j ? mbx->mbx_served_stat : mbx->mbx_sent_stat;
+		for (i = 0; i < XCL_MAILBOX_REQ_MAX; i++) {
+			if (!stat[i].mrs_count)
+				continue;
+			count += sprintf(buf + count,
+				"req[%d] %s: %llu, errors: %llu, "
+				"avg: %llu us, max: %llu us\n", i,
+				j ? "served" : "sent", stat[i].mrs_count,
+				stat[i].mrs_errors,
+				div64_u64(stat[i].mrs_total_us,
+				stat[i].mrs_count), stat[i].mrs_max_us);
+		}
+	}
+	spin_unlock(&mbx->mbx_stat_lock);
+
+	return count;
+}
+
+static DEVICE_ATTR_RO(req_latency);
+
 static void mailbox_send_test_load_xclbin_kaddr(struct mailbox *mbx)
 {
 	struct xcl_mailbox_req *req = NULL;
@@ -2055,6 +2270,7 @@ static struct attribute *mailbox_attrs[] = {
 	&dev_attr_connection.attr,
 	&dev_attr_intr_mode.attr,
 	&dev_attr_recv_metrics.attr,
+	&dev_attr_req_latency.attr,
 	&dev_attr_msg_send.attr,
 	NULL,
 };
@@ -2276,6 +2492,24 @@ static bool req_is_sw(struct platform_device *pdev, enum xcl_mailbox_request req
 	return (ch_switch & (1 << req));
 }
 
+static void req_stat_update(struct mailbox *mbx, struct mailbox_req_stat *stat,
+	enum xcl_mailbox_request req, ktime_t start, int err)
+{
+	u64 us = ktime_us_delta(ktime_get(), start);
+
+	if (req >= XCL_MAILBOX_REQ_MAX)
+		return;
+
+	spin_lock(&mbx->mbx_stat_lock);
+	stat[req].mrs_count++;
+	if (err)
+		stat[req].mrs_errors++;
+	stat[req].mrs_total_us += us;
+	if (us > stat[req].mrs_max_us)
+		stat[req].mrs_max_us = us;
+	spin_unlock(&mbx->mbx_stat_lock);
+}
+
 /*
  * Msg will be sent to peer and reply will be received.
  */
@@ -2286,7 +2520,9 @@ static int _mailbox_request(struct platform_device *pdev, void *req, size_t reql
 	int rv = -ENOMEM;
 	struct mailbox *mbx = platform_get_drvdata(pdev);
 	struct mailbox_msg *reqmsg = NULL, *respmsg = NULL;
-	bool sw_ch = req_is_sw(pdev, ((struct xcl_mailbox_req *)req)->req);
+	enum xcl_mailbox_request op = ((struct xcl_mailbox_req *)req)->req;
+	bool sw_ch = req_is_sw(pdev, op);
+	ktime_t start = ktime_get();
 
 	if (req_is_disabled(pdev, ((struct xcl_mailbox_req *)req)->req)) {
 		MBX_WARN(mbx, "req %d is received on disabled channel, err: %d",
@@ -2355,6 +2591,7 @@ static int _mailbox_request(struct platform_device *pdev, void *req, size_t reql
 		*resplen = respmsg->mbm_len;
 
 	free_msg(respmsg);
+	req_stat_update(mbx, mbx->mbx_sent_stat, op, start, rv);
 
 	return rv;
 
@@ -2363,6 +2600,7 @@ fail:
 		free_msg(reqmsg);
 	if (respmsg)
 		free_msg(respmsg);
+	req_stat_update(mbx, mbx->mbx_sent_stat, op, start, rv);
 	return rv;
 }
 
@@ -2504,11 +2742,15 @@ static void process_request(struct mailbox *mbx, struct mailbox_msg *msg)
 	} else if (req->req == XCL_MAILBOX_REQ_TEST_READY) {
 		MBX_INFO(mbx, "%s: %d", recvstr, req->req);
 	} else if (mbx->mbx_listen_cb) {
+		ktime_t start = ktime_get();
+
 		/* Call client's registered callback to process request. */
 		MBX_INFO(mbx, "%s: %d, passed on", recvstr, req->req);
 		mbx->mbx_listen_cb(mbx->mbx_listen_cb_arg, msg->mbm_data,
 			msg->mbm_len, msg->mbm_req_id, msg->mbm_error,
 			msg->mbm_chan_sw);
+		req_stat_update(mbx, mbx->mbx_served_stat, req->req, start,
+			msg->mbm_error);
 	} else {
 		MBX_INFO(mbx, "%s: %d, dropped", recvstr, req->req);
 	}
@@ -2765,6 +3007,7 @@ static void mailbox_stop(struct mailbox *mbx)
 	chan_fini(&mbx->mbx_rx);
 	listen_wq_fini(mbx);
 	BUG_ON(!(list_empty(&mbx->mbx_req_list)));
+	mailbox_bulk_reclaim(mbx, true);
 
 	if (mbx->mbx_send_body)
 		vfree(mbx->mbx_send_body);
@@ -3137,7 +3380,9 @@ static int mailbox_probe(struct platform_device *pdev)
 	init_completion(&mbx->mbx_comp);
 	mutex_init(&mbx->mbx_lock);
 	spin_lock_init(&mbx->mbx_intr_lock);
+	spin_lock_init(&mbx->mbx_stat_lock);
 	INIT_LIST_HEAD(&mbx->mbx_req_list);
+	INIT_LIST_HEAD(&mbx->mbx_bulk_list);
 
 	res = platform_get_resource(pdev, IORESOURCE_MEM, 0);
 	if (res != NULL) {
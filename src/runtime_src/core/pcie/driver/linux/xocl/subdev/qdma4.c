@@ -502,6 +502,31 @@ static void fill_qdma_request_sgl(struct qdma_request *req, struct sg_table *sgt
 	req->sgl[sgcnt - 1].next = NULL;
 }
 
+/*
+ * Streaming C2H data lands in the pre-mapped pages of the queue free list
+ * and is copied from there into the request pages by the CPU, so the
+ * destination only needs to be pinned, not DMA mapped.
+ */
+static void fill_qdma_request_pages(struct qdma_request *req,
+	struct sg_table *sgt)
+{
+	int i;
+	struct scatterlist *sg;
+	struct qdma_sw_sg *sgl = req->sgl;
+	unsigned int sgcnt = sgt->orig_nents;
+
+	req->sgcnt = sgcnt;
+	for_each_sg(sgt->sgl, sg, sgcnt, i) {
+		sgl->next = sgl + 1;
+		sgl->pg = sg_page(sg);
+		sgl->offset = sg->offset;
+		sgl->len = sg->length;
+		sgl->dma_addr = 0UL;
+		sgl++;
+	}
+	req->sgl[sgcnt - 1].next = NULL;
+}
+
 static ssize_t qdma_migrate_bo(struct platform_device *pdev,
 	struct sg_table *sgt, u32 write, u64 paddr, u32 channel, u64 len)
 {
@@ -944,9 +969,10 @@ static void queue_req_release_resource(struct qdma_stream_queue *queue,
 	if (reqcb->is_unmgd) {
 		xdev_handle_t xdev = xocl_get_xdev(queue->qdma->pdev);
 
-		pci_unmap_sg(XDEV(xdev)->pdev, reqcb->unmgd.sgt->sgl,
-			     reqcb->nsg, queue->qconf.q_type == Q_C2H ?  DMA_FROM_DEVICE :
-			    				     DMA_TO_DEVICE);
+		/* C2H buffers are pinned only, see fill_qdma_request_pages */
+		if (reqcb->nsg)
+			pci_unmap_sg(XDEV(xdev)->pdev, reqcb->unmgd.sgt->sgl,
+				     reqcb->nsg, DMA_TO_DEVICE);
 		xocl_finish_unmgd(&reqcb->unmgd);
 	} else {
 		BUG_ON(!reqcb->xobj);
@@ -1142,6 +1168,25 @@ static ssize_t queue_rw(struct xocl_qdma *qdma, struct qdma_stream_queue *queue,
 			goto error_out;
 		}
 
+		if (!write) {
+			if (unmgd.sgt->orig_nents != 1) {
+				xocl_err(&qdma->pdev->dev, "sgcnt %d > 1",
+					unmgd.sgt->orig_nents);
+				xocl_finish_unmgd(&unmgd);
+				ret = -EFAULT;
+				goto error_out;
+			}
+
+			req->sgl = iocb->sgl + i;
+			req->dma_mapped = 1;
+			fill_qdma_request_pages(req, unmgd.sgt);
+
+			memcpy(&reqcb->unmgd, &unmgd, sizeof (unmgd));
+			reqcb->is_unmgd = true;
+			reqcb->nsg = 0;
+			continue;
+		}
+
 		nents = pci_map_sg(XDEV(xdev)->pdev, unmgd.sgt->sgl,
 			unmgd.sgt->orig_nents, dir);
 		if (!nents) {
@@ -1152,6 +1197,8 @@ static ssize_t queue_rw(struct xocl_qdma *qdma, struct qdma_stream_queue *queue,
 		}
 if (nents != 1) {
 	xocl_err(&qdma->pdev->dev, "sgcnt %d > 1", nents);
+	pci_unmap_sg(XDEV(xdev)->pdev, unmgd.sgt->sgl,
+		unmgd.sgt->orig_nents, dir);
 	xocl_finish_unmgd(&unmgd);
 	ret = -EFAULT;
 	goto error_out;
@@ -93,6 +93,26 @@ static ssize_t xdma_migrate_bo(struct platform_device *pdev,
 	return ret;
 }
 
+static ssize_t xdma_migrate_mapped_bo(struct platform_device *pdev,
+	struct sg_table *sgt, u32 dir, u64 paddr, u32 channel, u64 len)
+{
+	struct xocl_xdma *xdma;
+	ssize_t ret;
+
+	xdma = platform_get_drvdata(pdev);
+	xocl_dbg(&pdev->dev, "TID %d, Channel:%d, Offset: 0x%llx, Dir: %d",
+		current->pid, channel, paddr, dir);
+	ret = xdma_xfer_fastpath(xdma->dma_handle, channel, dir,
+		paddr, sgt, true, 10000);
+	if (ret >= 0) {
+		xdma->channel_usage[dir][channel] += ret;
+		return ret;
+	}
+
+	xocl_err(&pdev->dev, "DMA of mapped sgt failed, ep addr %llx", paddr);
+	return ret;
+}
+
 struct xdma_async_context {
 	void (*callback_fn)(unsigned long data, int err);
 	unsigned long callback_data;
@@ -399,6 +419,7 @@ failed:
 static struct xocl_dma_funcs xdma_ops = {
 	.migrate_bo = xdma_migrate_bo,
 	.async_migrate_bo = xdma_async_migrate_bo,
+	.migrate_mapped_bo = xdma_migrate_mapped_bo,
 	.ac_chan = acquire_channel,
 	.rel_chan = release_channel,
 	.get_chan_count = get_channel_count,
@@ -425,8 +446,47 @@ static ssize_t channel_stat_raw_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(channel_stat_raw);
 
+/*
+ * Polled completion threshold in bytes of each channel, one line per
+ * channel with the same column order as channel_stat_raw.  Write
+ * "<channel> <dir> <bytes>" to set the threshold of one channel.
+ */
+static ssize_t poll_threshold_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	u32 i, rd = 0, wr = 0;
+	ssize_t nbytes = 0;
+	struct platform_device *pdev = to_platform_device(dev);
+	struct xocl_xdma *xdma = platform_get_drvdata(pdev);
+
+	for (i = 0; i < xdma->channel; i++) {
+		if (xdma_get_poll_threshold(xdma->dma_handle, i, false, &rd) ||
+		    xdma_get_poll_threshold(xdma->dma_handle, i, true, &wr))
+			break;
+		nbytes += sprintf(buf + nbytes, "%u %u\n", rd, wr);
+	}
+	return nbytes;
+}
+
+static ssize_t poll_threshold_store(struct device *dev,
+	struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct platform_device *pdev = to_platform_device(dev);
+	struct xocl_xdma *xdma = platform_get_drvdata(pdev);
+	u32 channel, dir, bytes;
+	int ret;
+
+	if (sscanf(buf, "%u %u %u", &channel, &dir, &bytes) != 3 || dir > 1)
+		return -EINVAL;
+
+	ret = xdma_set_poll_threshold(xdma->dma_handle, channel, dir, bytes);
+	return ret ? ret : count;
+}
+static DEVICE_ATTR_RW(poll_threshold);
+
 static struct attribute *xdma_attrs[] = {
 	&dev_attr_channel_stat_raw.attr,
+	&dev_attr_poll_threshold.attr,
 	NULL,
 };
 
@@ -12,6 +12,7 @@
 #include "xgq_cmd_vmr.h"
 #include "../xgq_xocl_plat.h"
 #include <linux/time.h>
+#include <linux/bitmap.h>
 
 /*
  * XGQ Host management driver design.
@@ -85,10 +86,15 @@ static DEFINE_IDR(xocl_xgq_vmr_cid_idr);
 
 /*
  * reserved shared memory size and number for log page.
- * currently, only 1 resource controlled by sema. Can be extended to n.
+ * The log page is partitioned into slots, a command with a small response,
+ * e.g. a sensor request, takes only the slots it needs so that several
+ * such commands can be outstanding at a time. A full log page request
+ * takes all slots.
  */
 #define LOG_PAGE_SIZE	(1024 * 64)
 #define LOG_PAGE_NUM	1
+#define LOG_SLOT_SIZE	(1024 * 4)
+#define LOG_SLOT_NUM	(LOG_PAGE_SIZE * LOG_PAGE_NUM / LOG_SLOT_SIZE)
 
 /*
  * Shared memory layout:
@@ -146,7 +152,9 @@ struct xocl_xgq_vmr {
 	bool			xgq_halted;
 	int 			xgq_cmd_id;
 	struct semaphore 	xgq_data_sema;
-	struct semaphore 	xgq_log_page_sema;
+	spinlock_t		xgq_log_slot_lock;
+	unsigned long		xgq_log_slots;
+	wait_queue_head_t	xgq_log_slot_wq;
 	struct xgq_cmd_cq_default_payload xgq_cq_payload;
 	int 			xgq_vmr_debug_level;
 };
@@ -554,22 +562,66 @@ static u32 inline shm_addr_data(struct xocl_xgq_vmr *xgq)
 		XOCL_VMR_DATA_ADDR_OFF;
 }
 
-/*TODO: enhance to n resources by atomic test_and_clear_bit/set_bit */
-static int shm_acquire_log_page(struct xocl_xgq_vmr *xgq, u32 *addr)
+static bool shm_try_acquire_log_slots(struct xocl_xgq_vmr *xgq, u32 num,
+	u32 *slot)
 {
-	if (down_interruptible(&xgq->xgq_log_page_sema)) {
+	unsigned long start;
+	bool found = false;
+
+	spin_lock(&xgq->xgq_log_slot_lock);
+	start = bitmap_find_next_zero_area(&xgq->xgq_log_slots, LOG_SLOT_NUM,
+		0, num, 0);
+	if (start + num <= LOG_SLOT_NUM) {
+		bitmap_set(&xgq->xgq_log_slots, start, num);
+		*slot = start;
+		found = true;
+	}
+	spin_unlock(&xgq->xgq_log_slot_lock);
+
+	return found;
+}
+
+/*
+ * Acquire num contiguous log page slots. A caller needing several slots
+ * acquires them all at once, so that it never waits while holding some.
+ */
+static int shm_acquire_log_slots(struct xocl_xgq_vmr *xgq, u32 num, u32 *addr)
+{
+	u32 slot = 0;
+
+	if (!num || num > LOG_SLOT_NUM)
+		return -EINVAL;
+
+	if (wait_event_interruptible(xgq->xgq_log_slot_wq,
+		shm_try_acquire_log_slots(xgq, num, &slot))) {
 		XGQ_ERR(xgq, "cancelled");
 		return -EIO;
 	}
 
-	/*TODO: memset shared memory to all zero */
-	*addr = shm_addr_log_page(xgq);
+	*addr = shm_addr_log_page(xgq) + slot * LOG_SLOT_SIZE;
 	return 0;
 }
 
+static void shm_release_log_slots(struct xocl_xgq_vmr *xgq, u32 addr, u32 num)
+{
+	u32 slot = (addr - shm_addr_log_page(xgq)) / LOG_SLOT_SIZE;
+
+	spin_lock(&xgq->xgq_log_slot_lock);
+	bitmap_clear(&xgq->xgq_log_slots, slot, num);
+	spin_unlock(&xgq->xgq_log_slot_lock);
+
+	wake_up_all(&xgq->xgq_log_slot_wq);
+}
+
+static int shm_acquire_log_page(struct xocl_xgq_vmr *xgq, u32 *addr)
+{
+	/*TODO: memset shared memory to all zero */
+	return shm_acquire_log_slots(xgq, LOG_SLOT_NUM, addr);
+}
+
 static void shm_release_log_page(struct xocl_xgq_vmr *xgq)
 {
-	up(&xgq->xgq_log_page_sema);
+	shm_release_log_slots(xgq, shm_addr_log_page(xgq), LOG_SLOT_NUM);
 }
 
 static int shm_acquire_data(struct xocl_xgq_vmr *xgq, u32 *addr)
@@ -1307,31 +1359,18 @@ static int vmr_enable_multiboot(struct platform_device *pdev)
 		xgq->xgq_boot_from_backup ? XGQ_CMD_BOOT_BACKUP : XGQ_CMD_BOOT_DEFAULT);
 }
 
-static int xgq_collect_sensors(struct platform_device *pdev, int pid,
-	char *data_buf, uint32_t len)
+static int xgq_sensor_cmd_submit(struct xocl_xgq_vmr *xgq,
+	struct xocl_xgq_vmr_cmd *cmd, int pid, u32 address, uint32_t len)
 {
-	struct xocl_xgq_vmr *xgq = platform_get_drvdata(pdev);
-	struct xocl_xgq_vmr_cmd *cmd = NULL;
 	struct xgq_cmd_sensor_payload *payload = NULL;
 	struct xgq_cmd_sq_hdr *hdr = NULL;
-	u32 address = 0;
 	int ret = 0;
 	int id = 0;
 
-	cmd = kzalloc(sizeof(*cmd), GFP_KERNEL);
-	if (!cmd) {
-		XGQ_ERR(xgq, "kmalloc failed, retry");
-		return -ENOMEM;
-	}
-
 	cmd->xgq_cmd_cb = xgq_complete_cb;
 	cmd->xgq_cmd_arg = cmd;
 	cmd->xgq_vmr = xgq;
 
-	if (shm_acquire_log_page(xgq, &address)) {
-		ret = -EIO;
-		goto acquire_failed;
-	}
 	payload = &(cmd->xgq_cmd_entry.sensor_payload);
 	payload->address = address;
 	payload->size = len;
@@ -1345,8 +1384,7 @@ static int xgq_collect_sensors(struct platform_device *pdev, int pid,
 	id = get_xgq_cid(xgq);
 	if (id < 0) {
 		XGQ_ERR(xgq, "alloc cid failed: %d", id);
-		ret = id;
-		goto cid_alloc_failed;
+		return id;
 	}
 	hdr->cid = id;
 
@@ -1359,12 +1397,21 @@ static int xgq_collect_sensors(struct platform_device *pdev, int pid,
 	ret = submit_cmd(xgq, cmd);
 	if (ret) {
 		XGQ_ERR(xgq, "submit cmd failed, cid %d", id);
-		goto done;
+		remove_xgq_cid(xgq, id);
 	}
 
+	return ret;
+}
+
+static int xgq_sensor_cmd_wait(struct xocl_xgq_vmr *xgq,
+	struct xocl_xgq_vmr_cmd *cmd, char *data_buf, uint32_t len)
+{
+	int ret = 0;
+
 	/* wait for command completion */
 	if (wait_for_completion_killable(&cmd->xgq_cmd_complete)) {
 		XGQ_ERR(xgq, "submit cmd killed");
+		ret = -EINTR;
 		goto done;
 	}
 
@@ -1373,21 +1420,78 @@ static int xgq_collect_sensors(struct platform_device *pdev, int pid,
 	if (ret) {
 		XGQ_ERR(xgq, "ret %d", cmd->xgq_cmd_rcode);
 	} else {
-		memcpy_from_device(xgq, address, data_buf, len);
+		memcpy_from_device(xgq, cmd->xgq_cmd_entry.sensor_payload.address,
+			data_buf, len);
 	}
 
 done:
-	remove_xgq_cid(xgq, id);
+	remove_xgq_cid(xgq, cmd->xgq_cmd_entry.hdr.cid);
 
-cid_alloc_failed:
-	shm_release_log_page(xgq);
+	return ret;
+}
+
+/*
+ * Collect num sensor repos of len bytes each. All requests are submitted
+ * before waiting for any of them, each in its own log page slots, so the
+ * device works on them back to back. The result of each request is
+ * returned in rets.
+ */
+static int xgq_collect_sensors_batch(struct platform_device *pdev,
+	char **bufs, uint8_t *ids, uint32_t len, int num, int *rets)
+{
+	struct xocl_xgq_vmr *xgq = platform_get_drvdata(pdev);
+	struct xocl_xgq_vmr_cmd *cmds = NULL;
+	u32 slots = DIV_ROUND_UP(len, LOG_SLOT_SIZE);
+	u32 address = 0;
+	int ret = 0;
+	int i;
+
+	if (num <= 0 || !len || slots * num > LOG_SLOT_NUM) {
+		XGQ_ERR(xgq, "invalid sensor request, num %d len %d", num, len);
+		return -EINVAL;
+	}
+
+	cmds = kcalloc(num, sizeof(*cmds), GFP_KERNEL);
+	if (!cmds) {
+		XGQ_ERR(xgq, "kmalloc failed, retry");
+		return -ENOMEM;
+	}
+
+	if (shm_acquire_log_slots(xgq, slots * num, &address)) {
+		ret = -EIO;
+		goto acquire_failed;
+	}
+
+	for (i = 0; i < num; i++) {
+		rets[i] = xgq_sensor_cmd_submit(xgq, &cmds[i], ids[i],
+			address + i * slots * LOG_SLOT_SIZE, len);
+	}
+
+	for (i = 0; i < num; i++) {
+		if (!rets[i])
+			rets[i] = xgq_sensor_cmd_wait(xgq, &cmds[i], bufs[i], len);
+	}
+
+	shm_release_log_slots(xgq, address, slots * num);
 
 acquire_failed:
-	kfree(cmd);
+	kfree(cmds);
 
 	return ret;
 }
 
+static int xgq_collect_sensors(struct platform_device *pdev, int pid,
+	char *data_buf, uint32_t len)
+{
+	uint8_t id = pid;
+	int rc = 0;
+	int ret;
+
+	ret = xgq_collect_sensors_batch(pdev, &data_buf, &id, len, 1, &rc);
+
+	return ret ? ret : rc;
+}
+
 static int xgq_collect_sensors_by_id(struct platform_device *pdev, char *buf,
 									 uint8_t id, uint32_t len)
 {
@@ -1760,7 +1864,8 @@ static int xgq_vmr_probe(struct platform_device *pdev)
 
 	mutex_init(&xgq->xgq_lock);
 	sema_init(&xgq->xgq_data_sema, 1);
-	sema_init(&xgq->xgq_log_page_sema, 1); /*TODO: improve to n based on availabity */
+	spin_lock_init(&xgq->xgq_log_slot_lock);
+	init_waitqueue_head(&xgq->xgq_log_slot_wq);
 
 	for (res = platform_get_resource(pdev, IORESOURCE_MEM, i); res;
 	    res = platform_get_resource(pdev, IORESOURCE_MEM, ++i)) {
@@ -1887,6 +1992,7 @@ static struct xocl_xgq_vmr_funcs xgq_vmr_ops = {
 	.xgq_download_apu_firmware = xgq_download_apu_firmware,
 	.vmr_enable_multiboot = vmr_enable_multiboot,
 	.xgq_collect_sensors_by_id = xgq_collect_sensors_by_id,
+	.xgq_collect_sensors_batch = xgq_collect_sensors_batch,
 	.vmr_load_firmware = xgq_log_page_fw,
 };
 
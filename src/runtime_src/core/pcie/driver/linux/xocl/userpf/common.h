@@ -81,6 +81,20 @@
 #endif
 #endif
 
+#define	XOCL_MAX_STAGED_XCLBIN	4
+
+/*
+ * struct xocl_staged_xclbin: Validated xclbin kept for fast switching
+ *
+ * @axlf: Copy of the xclbin, NULL if the slot is free
+ * @stamp: Last use, the least recently used xclbin is replaced when
+ *         all slots are in use
+ */
+struct xocl_staged_xclbin {
+	struct axlf		*axlf;
+	u64			stamp;
+};
+
 enum {
 	XOCL_FLAGS_SYSFS_INITIALIZED = (1 << 0),
 	XOCL_FLAGS_PERSIST_SYSFS_INITIALIZED = (1 << 1),
@@ -106,6 +120,10 @@ struct xocl_dev	{
 
 	void			*ulp_blob;
 
+	/* Protected by dev_lock */
+	struct xocl_staged_xclbin staged[XOCL_MAX_STAGED_XCLBIN];
+	u64			stage_stamp;
+
 	unsigned int		mbx_offset;
 
 	uint64_t		mig_cache_expire_secs;
@@ -154,6 +172,12 @@ struct xocl_mm_wrapper {
 /* ioctl functions */
 int xocl_info_ioctl(struct drm_device *dev, void *data,
 	struct drm_file *filp);
+int xocl_execbuf_vec_ioctl(struct drm_device *dev, void *data,
+	struct drm_file *filp);
+int xocl_kds_stat_ioctl(struct drm_device *dev, void *data,
+	struct drm_file *filp);
+int xocl_ctx_vec_ioctl(struct drm_device *dev, void *data,
+	struct drm_file *filp);
 int xocl_execbuf_ioctl(struct drm_device *dev, void *data,
 	struct drm_file *filp);
 int xocl_ctx_ioctl(struct drm_device *dev, void *data,
@@ -162,6 +186,7 @@ int xocl_user_intr_ioctl(struct drm_device *dev, void *data,
 	struct drm_file *filp);
 int xocl_read_axlf_ioctl(struct drm_device *dev, void *data,
 	struct drm_file *filp);
+void xocl_free_staged_xclbins(struct xocl_dev *xdev);
 int xocl_hot_reset_ioctl(struct drm_device *dev, void *data,
 	struct drm_file *filp);
 int xocl_reclock_ioctl(struct drm_device *dev, void *data,
@@ -227,6 +252,8 @@ int xocl_kds_reset(struct xocl_dev *xdev, const xuid_t *xclbin_id);
 int xocl_kds_reconfig(struct xocl_dev *xdev);
 int xocl_cu_map_addr(struct xocl_dev *xdev, u32 cu_idx,
 		     struct drm_file *filp, unsigned long size, u32 *addrp);
+int xocl_fa_desc_map_addr(struct xocl_dev *xdev, u32 cu_idx,
+			  struct drm_file *filp, unsigned long size, u64 *addrp);
 u32 xocl_kds_live_clients(struct xocl_dev *xdev, pid_t **plist);
 int xocl_kds_update(struct xocl_dev *xdev, struct drm_xocl_kds kds_cfg);
 void xocl_kds_cus_enable(struct xocl_dev *xdev);
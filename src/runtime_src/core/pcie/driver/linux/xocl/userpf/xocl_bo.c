@@ -23,6 +23,8 @@
 #include <linux/dma-buf.h>
 #include <linux/pagemap.h>
 #include <linux/version.h>
+#include <linux/workqueue.h>
+#include <linux/completion.h>
 #include "common.h"
 
 #ifdef _XOCL_BO_DEBUG
@@ -180,7 +182,8 @@ static void xocl_free_bo(struct drm_gem_object *obj)
 				obj->size);
 	}
 
-	if (xobj->vmapping)
+	/* Pages and mapping of a cached pin are released with the pin */
+	if (xobj->vmapping && !xobj->pin)
 		vunmap(xobj->vmapping);
 	xobj->vmapping = NULL;
 
@@ -195,8 +198,10 @@ static void xocl_free_bo(struct drm_gem_object *obj)
 
 	if (xobj->pages) {
 		if (xocl_bo_userptr(xobj)) {
-			xocl_release_pages(xobj->pages, npages, 0);
-			drm_free_large(xobj->pages);
+			if (!xobj->pin) {
+				xocl_release_pages(xobj->pages, npages, 0);
+				drm_free_large(xobj->pages);
+			}
 		} else if (xocl_bo_p2p(xobj) || xocl_bo_import(xobj) || xocl_bo_cma(xobj)) {
 			drm_free_large(xobj->pages);
 		} else if ((xobj->flags & XOCL_KERN_BUF) || (xobj->flags & XOCL_SGL)) {
@@ -207,6 +212,10 @@ static void xocl_free_bo(struct drm_gem_object *obj)
 	}
 	xobj->pages = NULL;
 
+	if (xobj->pin)
+		xocl_pin_put(drm_p, xobj->pin);
+	xobj->pin = NULL;
+
 	if (xobj->flags & XOCL_SGL) {
 		DRM_DEBUG("Freeing kernel buffer\n");
 		kfree(xobj->sgt);
@@ -524,6 +533,55 @@ cleanup:
 	return ERR_PTR(-ENOMEM);
 }
 
+/*
+ * Sub range of a DMA mapped sg table, used for imported dma-bufs that
+ * are not backed by struct pages, e.g. device memory of a peer NIC or
+ * GPU exported for P2P DMA.  The entries carry DMA addresses only.
+ */
+static struct sg_table *alloc_onetime_dma_sg_table(struct sg_table *src,
+	uint64_t offset, uint64_t size)
+{
+	struct sg_table *sgt;
+	struct scatterlist *sg, *dst;
+	uint64_t skip, len, end = offset + size, pos = 0;
+	unsigned int nents = 0;
+	int i, ret;
+
+	for_each_sg(src->sgl, sg, src->nents, i) {
+		if (pos + sg_dma_len(sg) > offset && pos < end)
+			nents++;
+		pos += sg_dma_len(sg);
+	}
+	if (!nents || pos < end)
+		return ERR_PTR(-EINVAL);
+
+	sgt = kmalloc(sizeof(struct sg_table), GFP_KERNEL);
+	if (!sgt)
+		return ERR_PTR(-ENOMEM);
+
+	ret = sg_alloc_table(sgt, nents, GFP_KERNEL);
+	if (ret) {
+		kfree(sgt);
+		return ERR_PTR(ret);
+	}
+
+	pos = 0;
+	dst = sgt->sgl;
+	for_each_sg(src->sgl, sg, src->nents, i) {
+		if (pos + sg_dma_len(sg) > offset && pos < end) {
+			skip = (offset > pos) ? offset - pos : 0;
+			len = min_t(uint64_t, sg_dma_len(sg) - skip, end - pos - skip);
+			sg_dma_address(dst) = sg_dma_address(sg) + skip;
+			sg_dma_len(dst) = len;
+			dst->length = len;
+			dst = sg_next(dst);
+		}
+		pos += sg_dma_len(sg);
+	}
+
+	return sgt;
+}
+
 struct drm_xocl_bo *
 __xocl_create_bo_ioctl(struct drm_device *dev,
 		       struct drm_xocl_create_bo *args)
@@ -670,6 +728,7 @@ int xocl_userptr_bo_ioctl(
 	uint64_t page_count = 0;
 	uint64_t page_pinned = 0;
 	struct drm_xocl_userptr_bo *args = data;
+	struct xocl_drm *drm_p = dev->dev_private;
 	unsigned user_flags = args->flags;
 	int write = 1;
 
@@ -687,12 +746,6 @@ int xocl_userptr_bo_ioctl(
 	/* Use the page rounded size to accurately account for num of pages */
 	page_count = xobj->base.size >> PAGE_SHIFT;
 
-	xobj->pages = drm_malloc_ab(page_count, sizeof(*xobj->pages));
-	if (!xobj->pages) {
-		ret = -ENOMEM;
-		goto out1;
-	}
-
 	ret = XOCL_ACCESS_OK(VERIFY_WRITE, args->addr, args->size);
 
 
@@ -704,6 +757,31 @@ int xocl_userptr_bo_ioctl(
 			write = 0;
 	}
 
+	xobj->pin = xocl_pin_get(drm_p, args->addr, xobj->base.size, write);
+	if (IS_ERR(xobj->pin)) {
+		ret = PTR_ERR(xobj->pin);
+		xobj->pin = NULL;
+		goto out1;
+	}
+	if (xobj->pin) {
+		xobj->pages = xocl_pin_pages(xobj->pin, args->addr);
+		xobj->vmapping = xocl_pin_vmapping(xobj->pin, args->addr);
+		xobj->sgt = alloc_onetime_sg_table(xobj->pages, 0,
+			page_count << PAGE_SHIFT);
+		if (IS_ERR(xobj->sgt)) {
+			ret = PTR_ERR(xobj->sgt);
+			xobj->sgt = NULL;
+			goto out1;
+		}
+		goto handle;
+	}
+
+	xobj->pages = drm_malloc_ab(page_count, sizeof(*xobj->pages));
+	if (!xobj->pages) {
+		ret = -ENOMEM;
+		goto out1;
+	}
+
 	while (page_pinned < page_count) {
 		/*
 		 * We pin at most 1G at a time to workaround
@@ -736,6 +814,7 @@ int xocl_userptr_bo_ioctl(
 		goto out1;
 	}
 
+handle:
 	ret = drm_gem_handle_create(filp, &xobj->base, &args->handle);
 	if (ret)
 		goto out1;
@@ -786,19 +865,150 @@ out:
 	return ret;
 }
 
-int xocl_sync_bo_ioctl(struct drm_device *dev,
-		       void *data,
-		       struct drm_file *filp)
+/*
+ * Syncs of at least xrt_sync_split_size bytes are split into chunks of
+ * xrt_sync_chunk_size bytes which are migrated in parallel, one worker
+ * per DMA channel, so that one large BO uses the bandwidth of all
+ * channels.  Setting either to 0 disables splitting.
+ */
+static unsigned long xrt_sync_split_size = 64 * 1024 * 1024;
+module_param(xrt_sync_split_size, ulong, (S_IRUGO|S_IWUSR));
+MODULE_PARM_DESC(xrt_sync_split_size,
+	"Minimum BO sync size in bytes split across DMA channels (0 to disable)");
+
+static unsigned long xrt_sync_chunk_size = 8 * 1024 * 1024;
+module_param(xrt_sync_chunk_size, ulong, (S_IRUGO|S_IWUSR));
+MODULE_PARM_DESC(xrt_sync_chunk_size,
+	"Size in bytes of the chunks of a BO sync split across DMA channels");
+
+struct xocl_sync_split {
+	struct xocl_dev		*xdev;
+	struct page		**pages;
+	u32			dir;
+	u64			paddr;
+	u64			offset;
+	u64			size;
+	u64			chunk;
+	atomic64_t		next;
+	atomic_t		pending;
+	int			error;
+	struct completion	done;
+};
+
+struct xocl_sync_split_work {
+	struct work_struct	work;
+	struct xocl_sync_split	*split;
+};
+
+/* Migrate chunks until all are taken, returns 0 or the first error */
+static int xocl_sync_split_chunks(struct xocl_sync_split *split)
+{
+	struct sg_table *sgt;
+	u64 start, len;
+	ssize_t ret;
+	int channel;
+
+	while (!READ_ONCE(split->error)) {
+		start = atomic64_add_return(split->chunk, &split->next) - split->chunk;
+		if (start >= split->size)
+			break;
+
+		len = min(split->chunk, split->size - start);
+		sgt = alloc_onetime_sg_table(split->pages, split->offset + start, len);
+		if (IS_ERR(sgt))
+			return PTR_ERR(sgt);
+
+		channel = xocl_acquire_channel(split->xdev, split->dir);
+		if (channel < 0) {
+			sg_free_table(sgt);
+			kfree(sgt);
+			return -EINVAL;
+		}
+		ret = xocl_migrate_bo(split->xdev, sgt, split->dir,
+			split->paddr + start, channel, len);
+		xocl_release_channel(split->xdev, split->dir, channel);
+		sg_free_table(sgt);
+		kfree(sgt);
+
+		if (ret != len)
+			return (ret < 0) ? ret : -EIO;
+	}
+
+	return 0;
+}
+
+static void xocl_sync_split_error(struct xocl_sync_split *split, int err)
+{
+	if (err)
+		cmpxchg(&split->error, 0, err);
+}
+
+static void xocl_sync_split_work_fn(struct work_struct *work)
+{
+	struct xocl_sync_split_work *w =
+		container_of(work, struct xocl_sync_split_work, work);
+	struct xocl_sync_split *split = w->split;
+
+	xocl_sync_split_error(split, xocl_sync_split_chunks(split));
+	if (atomic_dec_and_test(&split->pending))
+		complete(&split->done);
+}
+
+/*
+ * Sync a range of a BO by migrating its chunks on up to channels DMA
+ * channels in parallel.  The calling thread migrates chunks too, the
+ * other channels are driven from the unbound workqueue.
+ */
+static int xocl_sync_bo_split(struct xocl_dev *xdev, struct page **pages,
+	u32 dir, u64 paddr, u64 offset, u64 size, u32 channels)
+{
+	struct xocl_sync_split split = {
+		.xdev = xdev,
+		.pages = pages,
+		.dir = dir,
+		.paddr = paddr,
+		.offset = offset,
+		.size = size,
+		.chunk = round_up((u64)xrt_sync_chunk_size, PAGE_SIZE),
+	};
+	struct xocl_sync_split_work *works;
+	u32 nworks, i;
+
+	nworks = min_t(u64, channels, DIV_ROUND_UP(size, split.chunk)) - 1;
+	works = nworks ? kcalloc(nworks, sizeof(*works), GFP_KERNEL) : NULL;
+	if (!works)
+		nworks = 0;
+
+	atomic64_set(&split.next, 0);
+	atomic_set(&split.pending, nworks);
+	init_completion(&split.done);
+	for (i = 0; i < nworks; i++) {
+		INIT_WORK(&works[i].work, xocl_sync_split_work_fn);
+		works[i].split = &split;
+		queue_work(system_unbound_wq, &works[i].work);
+	}
+
+	xocl_sync_split_error(&split, xocl_sync_split_chunks(&split));
+	if (nworks)
+		wait_for_completion(&split.done);
+
+	kfree(works);
+	return split.error;
+}
+
+static int xocl_sync_bo(struct drm_device *dev,
+			struct drm_file *filp,
+			const struct drm_xocl_sync_bo *args)
 {
 	const struct drm_xocl_bo *xobj;
 	struct sg_table *sgt;
 	u64 paddr = 0;
 	int channel = 0;
 	ssize_t ret = 0;
-	const struct drm_xocl_sync_bo *args = data;
 	struct xocl_drm *drm_p = dev->dev_private;
 	struct xocl_dev *xdev = drm_p->xdev;
 	struct scatterlist *sg;
+	u32 channels;
 
 	u32 dir = (args->dir == DRM_XOCL_SYNC_BO_TO_DEVICE) ? 1 : 0;
 	struct drm_gem_object *gem_obj = xocl_gem_object_lookup(dev, filp,
@@ -859,6 +1069,14 @@ int xocl_sync_bo_ioctl(struct drm_device *dev,
 	*/
 	paddr += args->offset;
 
+	channels = xocl_get_chan_count(xdev);
+	if (xrt_sync_split_size && xrt_sync_chunk_size && channels > 1 &&
+	    args->size >= xrt_sync_split_size && xobj->pages) {
+		ret = xocl_sync_bo_split(xdev, xobj->pages, dir, paddr,
+			args->offset, args->size, channels);
+		goto out;
+	}
+
 	if (args->offset || (args->size != xobj->base.size)) {
 		sgt = alloc_onetime_sg_table(xobj->pages, args->offset, args->size);
 		if (IS_ERR(sgt)) {
@@ -890,6 +1108,47 @@ out:
 	return ret;
 }
 
+int xocl_sync_bo_ioctl(struct drm_device *dev,
+		       void *data,
+		       struct drm_file *filp)
+{
+	return xocl_sync_bo(dev, filp, data);
+}
+
+int xocl_sync_bo_vec_ioctl(struct drm_device *dev,
+			   void *data,
+			   struct drm_file *filp)
+{
+	const struct drm_xocl_sync_bo_vec *args = data;
+	struct drm_xocl_sync_bo *syncs;
+	u32 i;
+	int ret = 0;
+
+	if (!args->count || args->count > DRM_XOCL_SYNC_BO_VEC_MAX ||
+	    args->reserved)
+		return -EINVAL;
+
+	syncs = kmalloc_array(args->count, sizeof(*syncs), GFP_KERNEL);
+	if (!syncs)
+		return -ENOMEM;
+
+	if (copy_from_user(syncs, (void __user *)(uintptr_t)args->syncs,
+	    args->count * sizeof(*syncs))) {
+		ret = -EFAULT;
+		goto out;
+	}
+
+	for (i = 0; i < args->count; i++) {
+		ret = xocl_sync_bo(dev, filp, &syncs[i]);
+		if (ret)
+			break;
+	}
+
+out:
+	kfree(syncs);
+	return ret;
+}
+
 int xocl_info_bo_ioctl(struct drm_device *dev,
 		       void *data,
 		       struct drm_file *filp)
@@ -1153,12 +1412,24 @@ int xocl_copy_import_bo(struct drm_device *dev, struct drm_file *filp,
 	}
 	local_pa += local_offset;
 
-	if (import_offset || (cp_size != import_xobj->base.size)) {
+	if (!import_xobj->pages) {
+		/* page-less dma-buf, sgt is DMA mapped by the exporter */
+		tmp_sgt = alloc_onetime_dma_sg_table(import_xobj->sgt,
+			import_offset, cp_size);
+		if (IS_ERR(tmp_sgt)) {
+			DRM_ERROR("failed to alloc tmp dma sgt, copy_bo aborted");
+			ret = PTR_ERR(tmp_sgt);
+			tmp_sgt = NULL;
+			goto out;
+		}
+		sgt = tmp_sgt;
+	} else if (import_offset || (cp_size != import_xobj->base.size)) {
 		tmp_sgt = alloc_onetime_sg_table(import_xobj->pages,
 			import_offset, cp_size);
 		if (IS_ERR(tmp_sgt)) {
 			DRM_ERROR("failed to alloc tmp sgt, copy_bo aborted");
 			ret = PTR_ERR(tmp_sgt);
+			tmp_sgt = NULL;
 			goto out;
 		}
 		sgt = tmp_sgt;
@@ -1177,7 +1448,10 @@ int xocl_copy_import_bo(struct drm_device *dev, struct drm_file *filp,
 	}
 
 	/* Now perform the copy via DMA engine */
-	ret = xocl_migrate_bo(xdev, sgt, dir, local_pa, channel, cp_size);
+	if (!import_xobj->pages)
+		ret = xocl_migrate_mapped_bo(xdev, sgt, dir, local_pa, channel, cp_size);
+	else
+		ret = xocl_migrate_bo(xdev, sgt, dir, local_pa, channel, cp_size);
 	if (ret >= 0)
 		ret = (ret == cp_size) ? 0 : -EIO;
 	xocl_release_channel(xdev, dir, channel);
@@ -1224,6 +1498,19 @@ struct drm_gem_object *xocl_gem_prime_import_sg_table(struct drm_device *dev,
 	}
 
 	importing_xobj->sgt = sgt;
+
+	/*
+	 * dma-bufs exported from device memory of peer devices (RDMA NICs,
+	 * GPUs) have no struct pages.  Such buffers cannot be mapped to
+	 * host, but can be copied to and from local BOs using the DMA
+	 * addresses of the attachment.
+	 */
+	if (!sg_page(sgt->sgl)) {
+		DRM_DEBUG("Importing page-less dma-buf for P2P DMA\n");
+		xocl_describe(importing_xobj);
+		return &importing_xobj->base;
+	}
+
 	importing_xobj->pages = drm_malloc_ab(attach->dmabuf->size >> PAGE_SHIFT,
 		sizeof(*importing_xobj->pages));
 	if (!importing_xobj->pages) {
@@ -117,7 +117,7 @@ static int xocl_native_mmap(struct file *filp, struct vm_area_struct *vma)
 	struct xocl_drm *drm_p = priv->minor->dev->dev_private;
 	xdev_handle_t xdev = drm_p->xdev;
 
-	if (vma->vm_pgoff > MAX_CUS) {
+	if (vma->vm_pgoff > 2 * MAX_CUS) {
 		userpf_err(xdev, "invalid native mmap offset: 0x%lx",
 			vma->vm_pgoff);
 		return -EINVAL;
@@ -132,7 +132,7 @@ static int xocl_native_mmap(struct file *filp, struct vm_area_struct *vma)
 				"bad size (0x%lx) for native BAR mmap", vsize);
 			return -EINVAL;
 		}
-	} else {
+	} else if (vma->vm_pgoff <= MAX_CUS) {
 		int ret;
 		u32 cu_addr;
 		u32 cu_idx = vma->vm_pgoff - 1;
@@ -141,6 +141,15 @@ static int xocl_native_mmap(struct file *filp, struct vm_area_struct *vma)
 		if (ret != 0)
 			return ret;
 		res_start += cu_addr;
+	} else {
+		int ret;
+		u64 desc_addr;
+		u32 cu_idx = vma->vm_pgoff - MAX_CUS - 1;
+
+		ret = xocl_fa_desc_map_addr(xdev, cu_idx, priv, vsize, &desc_addr);
+		if (ret != 0)
+			return ret;
+		res_start = desc_addr;
 	}
 
 	vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
@@ -174,6 +183,8 @@ static int xocl_mmap(struct file *filp, struct vm_area_struct *vma)
 	 * When pgoff is 0, we perform mmap of the PCIE BAR.
 	 * When pgoff is non-zero, we treat it as CU index + 1 and perform
 	 * mmap of that particular CU register space.
+	 * When pgoff is above MAX_CUS, we treat it as MAX_CUS + CU index + 1
+	 * and perform mmap of the descriptor slots of a fast adapter CU.
 	 */
 	return xocl_native_mmap(filp, vma);
 }
@@ -359,6 +370,12 @@ static int xocl_client_open(struct drm_device *dev, struct drm_file *filp)
 		return -ENXIO;
 	}
 
+	/* monitors are probed on first use */
+	ret = xocl_subdev_probe_deferred(drm_p->xdev);
+	if (ret)
+		xocl_xdev_info(drm_p->xdev, "probe deferred subdevs failed %d",
+			ret);
+
 	ret = xocl_create_client(drm_p->xdev, &filp->driver_priv);
 	if (ret) {
 		xocl_drvinst_close(drm_p);
@@ -433,6 +450,14 @@ static const struct drm_ioctl_desc xocl_ioctls[] = {
 			  DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
 	DRM_IOCTL_DEF_DRV(XOCL_FREE_CMA, xocl_free_cma_ioctl,
 			  DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
+	DRM_IOCTL_DEF_DRV(XOCL_EXECBUF_VEC, xocl_execbuf_vec_ioctl,
+			  DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
+	DRM_IOCTL_DEF_DRV(XOCL_KDS_STAT, xocl_kds_stat_ioctl,
+			  DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
+	DRM_IOCTL_DEF_DRV(XOCL_CTX_VEC, xocl_ctx_vec_ioctl,
+			  DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
+	DRM_IOCTL_DEF_DRV(XOCL_SYNC_BO_VEC, xocl_sync_bo_vec_ioctl,
+			  DRM_AUTH|DRM_UNLOCKED|DRM_RENDER_ALLOW),
 
 /* LINUX KERNEL-SPACE IOCTLS - The following entries are meant to be
  * accessible only from Linux Kernel and need be grouped to at the end
@@ -600,6 +625,7 @@ void *xocl_drm_init(xdev_handle_t xdev_hdl)
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 7, 0)
 	hash_init(drm_p->mm_range);
 #endif
+	xocl_pin_cache_init(drm_p);
 
 	xocl_drvinst_set_filedev(drm_p, ddev);
 	xocl_drvinst_set_offline(drm_p, false);
@@ -623,6 +649,7 @@ void xocl_drm_fini(struct xocl_drm *drm_p)
 	xocl_drvinst_release(drm_p, &hdl);
 
 	xocl_cleanup_mem(drm_p);
+	xocl_pin_cache_fini(drm_p);
 	drm_put_dev(drm_p->ddev);
 	mutex_destroy(&drm_p->mm_lock);
 
@@ -650,6 +677,48 @@ void xocl_mm_update_usage_stat(struct xocl_drm *drm_p, u32 ddr,
 	drm_p->mm_usage_stat[ddr]->bo_count += count;
 }
 
+static int xocl_mm_frag_bucket(u64 size)
+{
+	int bucket = 0;
+
+	for (size >>= 20; size && bucket < XOCL_MM_FRAG_BUCKETS - 1; size >>= 4)
+		bucket++;
+
+	return bucket;
+}
+
+/*
+ * Free extents of the memory manager within [start, end), which is
+ * the address range of one memory bank.
+ */
+void xocl_mm_get_frag_stat(struct xocl_drm *drm_p, u64 start, u64 end,
+	struct xocl_mm_frag_stat *pstat)
+{
+	struct drm_mm_node *entry;
+	u64 hole_start, hole_end, size;
+
+	memset(pstat, 0, sizeof(*pstat));
+
+	mutex_lock(&drm_p->mm_lock);
+	if (!drm_p->mm)
+		goto out;
+
+	drm_mm_for_each_hole(entry, drm_p->mm, hole_start, hole_end) {
+		hole_start = max(hole_start, start);
+		hole_end = min(hole_end, end);
+		if (hole_start >= hole_end)
+			continue;
+
+		size = hole_end - hole_start;
+		pstat->free += size;
+		pstat->largest = max(pstat->largest, size);
+		pstat->holes++;
+		pstat->hist[xocl_mm_frag_bucket(size)]++;
+	}
+out:
+	mutex_unlock(&drm_p->mm_lock);
+}
+
 int xocl_mm_insert_node_range(struct xocl_drm *drm_p, u32 mem_id,
 			      struct drm_mm_node *node, u64 size)
 {
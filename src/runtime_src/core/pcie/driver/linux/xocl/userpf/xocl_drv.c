@@ -1110,6 +1110,7 @@ void xocl_userpf_remove(struct pci_dev *pdev)
 	xocl_subdev_fini(xdev);
 	if (xdev->ulp_blob)
 		vfree(xdev->ulp_blob);
+	xocl_free_staged_xclbins(xdev);
 	mutex_destroy(&xdev->dev_lock);
 
 	if (xdev->core.bars)
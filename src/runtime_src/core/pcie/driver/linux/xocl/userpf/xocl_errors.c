@@ -44,6 +44,9 @@ xocl_insert_error_record(struct xocl_dev_core *core, struct xclErrorLast *err_la
 	}
 	mutex_unlock(&core->errors_lock);
 
+	/* Wake up user space waiting in poll() for new errors */
+	sysfs_notify(&core->pdev->dev.kobj, NULL, "xocl_errors");
+
 	return 0;
 }
 
@@ -62,6 +62,39 @@ int xocl_execbuf_ioctl(struct drm_device *dev,
 	return ret;
 }
 
+int xocl_execbuf_vec_ioctl(struct drm_device *dev,
+	void *data, struct drm_file *filp)
+{
+	struct xocl_drm *drm_p = dev->dev_private;
+	int ret = 0;
+
+	ret = xocl_client_ioctl(drm_p->xdev, DRM_XOCL_EXECBUF_VEC, data, filp);
+
+	return ret;
+}
+
+int xocl_kds_stat_ioctl(struct drm_device *dev,
+	void *data, struct drm_file *filp)
+{
+	struct xocl_drm *drm_p = dev->dev_private;
+	int ret = 0;
+
+	ret = xocl_client_ioctl(drm_p->xdev, DRM_XOCL_KDS_STAT, data, filp);
+
+	return ret;
+}
+
+int xocl_ctx_vec_ioctl(struct drm_device *dev,
+	void *data, struct drm_file *filp)
+{
+	struct xocl_drm *drm_p = dev->dev_private;
+	int ret = 0;
+
+	ret = xocl_client_ioctl(drm_p->xdev, DRM_XOCL_CTX_VEC, data, filp);
+
+	return ret;
+}
+
 int xocl_execbuf_callback_ioctl(struct drm_device *dev,
 			  void *data,
 			  struct drm_file *filp)
@@ -341,6 +374,136 @@ static bool xocl_xclbin_in_use(struct xocl_dev *xdev)
 	return false;
 }
 
+/*
+ * Check PARTITION_METADATA of an xclbin and that its interface uuids
+ * match the shell.  A lite xclbin without BITSTREAM is not checked
+ * against the shell.
+ */
+static int
+xocl_check_ulp(struct xocl_dev *xdev, struct axlf *axlf)
+{
+	const struct axlf_section_header *dtbHeader;
+	void *ulp_blob;
+
+	dtbHeader = xocl_axlf_section_header(xdev, axlf, PARTITION_METADATA);
+	if (!dtbHeader)
+		return 0;
+
+	ulp_blob = (char*)axlf + dtbHeader->m_sectionOffset;
+	if (fdt_check_header(ulp_blob) || fdt_totalsize(ulp_blob) >
+			dtbHeader->m_sectionSize) {
+		userpf_err(xdev, "Invalid PARTITION_METADATA");
+		return -EINVAL;
+	}
+
+	if (xocl_axlf_section_header(xdev, axlf, BITSTREAM)) {
+		xocl_xdev_info(xdev, "check interface uuid");
+		if (xocl_fdt_check_uuids(xdev,
+			(const void *)XDEV(xdev)->fdt_blob,
+			(const void *)ulp_blob)) {
+			userpf_err(xdev, "interface uuids do not match");
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static struct xocl_staged_xclbin *
+xocl_find_staged(struct xocl_dev *xdev, xuid_t *uuid)
+{
+	int i;
+
+	for (i = 0; i < XOCL_MAX_STAGED_XCLBIN; i++) {
+		struct xocl_staged_xclbin *slot = &xdev->staged[i];
+
+		if (slot->axlf && uuid_equal(&slot->axlf->m_header.uuid, uuid)) {
+			slot->stamp = ++xdev->stage_stamp;
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Validate and keep a copy of an xclbin so that a later download of
+ * the same xclbin neither copies it from user space again nor repeats
+ * the validation.  The least recently used staged xclbin is replaced
+ * when all slots are in use.
+ */
+static int
+xocl_stage_xclbin(struct xocl_dev *xdev, struct drm_xocl_axlf *axlf_ptr,
+	struct axlf *bin_obj)
+{
+	struct xocl_staged_xclbin *slot;
+	struct axlf *axlf;
+	int i, err;
+
+	if (xocl_xrt_version_check(xdev, bin_obj, true)) {
+		userpf_err(xdev, "Xclbin isn't supported by current XRT\n");
+		return -EINVAL;
+	}
+
+	if (!xocl_verify_timestamp(xdev,
+		bin_obj->m_header.m_featureRomTimeStamp)) {
+		userpf_err(xdev, "TimeStamp of ROM did not match Xclbin\n");
+		return -EOPNOTSUPP;
+	}
+
+	axlf = vmalloc(bin_obj->m_header.m_length);
+	if (!axlf)
+		return -ENOMEM;
+	if (copy_from_user(axlf, axlf_ptr->xclbin, bin_obj->m_header.m_length)) {
+		vfree(axlf);
+		return -EFAULT;
+	}
+
+	err = xocl_check_ulp(xdev, axlf);
+	if (err) {
+		vfree(axlf);
+		return err;
+	}
+
+	slot = xocl_find_staged(xdev, &bin_obj->m_header.uuid);
+	if (!slot) {
+		slot = &xdev->staged[0];
+		for (i = 1; i < XOCL_MAX_STAGED_XCLBIN && slot->axlf; i++) {
+			if (!xdev->staged[i].axlf ||
+			    xdev->staged[i].stamp < slot->stamp)
+				slot = &xdev->staged[i];
+		}
+	}
+
+	vfree(slot->axlf);
+	slot->axlf = axlf;
+	slot->stamp = ++xdev->stage_stamp;
+	userpf_info(xdev, "Staged xclbin %pUb", &bin_obj->m_header.uuid);
+	return 0;
+}
+
+static int
+xocl_unstage_xclbin(struct xocl_dev *xdev, xuid_t *uuid)
+{
+	struct xocl_staged_xclbin *slot = xocl_find_staged(xdev, uuid);
+
+	if (!slot)
+		return -ENOENT;
+
+	vfree(slot->axlf);
+	slot->axlf = NULL;
+	return 0;
+}
+
+void xocl_free_staged_xclbins(struct xocl_dev *xdev)
+{
+	int i;
+
+	for (i = 0; i < XOCL_MAX_STAGED_XCLBIN; i++) {
+		vfree(xdev->staged[i].axlf);
+		xdev->staged[i].axlf = NULL;
+	}
+}
+
 static int
 xocl_read_axlf_helper(struct xocl_drm *drm_p, struct drm_xocl_axlf *axlf_ptr)
 {
@@ -356,6 +519,7 @@ xocl_read_axlf_helper(struct xocl_drm *drm_p, struct drm_xocl_axlf *axlf_ptr)
 	void *kernels;
 	int rc;
 	bool force_download = false;
+	struct xocl_staged_xclbin *staged = NULL;
 
 	if (!xocl_is_unified(xdev)) {
 		userpf_err(xdev, "XOCL: not unified Shell\n");
@@ -373,6 +537,11 @@ xocl_read_axlf_helper(struct xocl_drm *drm_p, struct drm_xocl_axlf *axlf_ptr)
 		return -EINVAL;
 	}
 
+	if (axlf_ptr->flags & XOCL_AXLF_STAGE)
+		return xocl_stage_xclbin(xdev, axlf_ptr, &bin_obj);
+	if (axlf_ptr->flags & XOCL_AXLF_UNSTAGE)
+		return xocl_unstage_xclbin(xdev, &bin_obj.m_header.uuid);
+
 	if (is_bad_state(&XDEV(xdev)->kds)) {
 		err = -EDEADLK;
 		goto done;
@@ -402,44 +571,53 @@ xocl_read_axlf_helper(struct xocl_drm *drm_p, struct drm_xocl_axlf *axlf_ptr)
 	}
 	/* All contexts are closed. No outstanding commands */
 
-	/* Really need to download, sanity check xclbin, first. */
-	if (xocl_xrt_version_check(xdev, &bin_obj, true)) {
-		userpf_err(xdev, "Xclbin isn't supported by current XRT\n");
-		err = -EINVAL;
-		goto done;
-	}
+	/*
+	 * A staged xclbin was validated and copied when it was staged.
+	 * If the xclbin is no longer staged, it is copied from user space
+	 * as usual.
+	 */
+	if (axlf_ptr->flags & XOCL_AXLF_STAGED)
+		staged = xocl_find_staged(xdev, &bin_obj.m_header.uuid);
+
+	if (staged) {
+		axlf = staged->axlf;
+	} else {
+		/* Really need to download, sanity check xclbin, first. */
+		if (xocl_xrt_version_check(xdev, &bin_obj, true)) {
+			userpf_err(xdev, "Xclbin isn't supported by current XRT\n");
+			err = -EINVAL;
+			goto done;
+		}
 
-	if (!xocl_verify_timestamp(xdev,
-		bin_obj.m_header.m_featureRomTimeStamp)) {
-		userpf_err(xdev, "TimeStamp of ROM did not match Xclbin\n");
-		err = -EOPNOTSUPP;
-		goto done;
-	}
+		if (!xocl_verify_timestamp(xdev,
+			bin_obj.m_header.m_featureRomTimeStamp)) {
+			userpf_err(xdev, "TimeStamp of ROM did not match Xclbin\n");
+			err = -EOPNOTSUPP;
+			goto done;
+		}
 
-	/* Copy bitstream from user space and proceed. */
-	axlf = vmalloc(bin_obj.m_header.m_length);
-	if (!axlf) {
-		userpf_err(xdev, "Unable to alloc mem for xclbin, size=%llu\n",
-			bin_obj.m_header.m_length);
-		err = -ENOMEM;
-		goto done;
-	}
-	if (copy_from_user(axlf, axlf_ptr->xclbin, bin_obj.m_header.m_length)) {
-		err = -EFAULT;
-		goto done;
+		/* Copy bitstream from user space and proceed. */
+		axlf = vmalloc(bin_obj.m_header.m_length);
+		if (!axlf) {
+			userpf_err(xdev, "Unable to alloc mem for xclbin, size=%llu\n",
+				bin_obj.m_header.m_length);
+			err = -ENOMEM;
+			goto done;
+		}
+		if (copy_from_user(axlf, axlf_ptr->xclbin, bin_obj.m_header.m_length)) {
+			err = -EFAULT;
+			goto done;
+		}
+
+		err = xocl_check_ulp(xdev, axlf);
+		if (err)
+			goto done;
 	}
 
 	dtbHeader = xocl_axlf_section_header(xdev, axlf,
 		PARTITION_METADATA);
 	if (dtbHeader) {
 		ulp_blob = (char*)axlf + dtbHeader->m_sectionOffset;
-		if (fdt_check_header(ulp_blob) || fdt_totalsize(ulp_blob) >
-				dtbHeader->m_sectionSize) {
-			userpf_err(xdev, "Invalid PARTITION_METADATA");
-			err = -EINVAL;
-			goto done;
-		}
-
 		if (xdev->ulp_blob)
 			vfree(xdev->ulp_blob);
 
@@ -449,22 +627,6 @@ xocl_read_axlf_helper(struct xocl_drm *drm_p, struct drm_xocl_axlf *axlf_ptr)
 			goto done;
 		}
 		memcpy(xdev->ulp_blob, ulp_blob, fdt_totalsize(ulp_blob));
-
-		/*
-		 * don't check uuid if the xclbin is a lite one
-		 * the lite xclbin will not have BITSTREAM 
-		 */
-		if (xocl_axlf_section_header(xdev, axlf, BITSTREAM)) {
-			xocl_xdev_info(xdev, "check interface uuid");
-			err = xocl_fdt_check_uuids(xdev,
-				(const void *)XDEV(xdev)->fdt_blob,
-				(const void *)((char*)xdev->ulp_blob));
-			if (err) {
-				userpf_err(xdev, "interface uuids do not match");
-				err = -EINVAL;
-				goto done;
-			}
-		}
 	}
 
 	/* Populating MEM_TOPOLOGY sections. */
@@ -556,7 +718,8 @@ done:
 	else
 		userpf_info(xdev, "Loaded xclbin %pUb", &bin_obj.m_header.uuid);
 
-	vfree(axlf);
+	if (!staged)
+		vfree(axlf);
 	return err;
 }
 
@@ -327,6 +327,63 @@ static int xocl_context_ioctl(struct xocl_dev *xdev, void *data,
 	return ret;
 }
 
+/* Open or close contexts on many CUs under one acquisition of the
+ * device lock.  An open either succeeds for all CUs or for none.
+ */
+static int xocl_context_vec_ioctl(struct xocl_dev *xdev, void *data,
+				  struct drm_file *filp)
+{
+	struct drm_xocl_ctx_vec *args = data;
+	struct kds_client *client = filp->driver_priv;
+	struct drm_xocl_ctx ctx = { 0 };
+	u32 *cu_indices;
+	u32 i;
+	int ret = 0;
+
+	args->done = 0;
+	if (!args->count || args->count > DRM_XOCL_CTX_VEC_MAX || args->reserved)
+		return -EINVAL;
+
+	if (args->op != XOCL_CTX_OP_ALLOC_CTX && args->op != XOCL_CTX_OP_FREE_CTX)
+		return -EINVAL;
+
+	cu_indices = kmalloc_array(args->count, sizeof(*cu_indices), GFP_KERNEL);
+	if (!cu_indices)
+		return -ENOMEM;
+
+	if (copy_from_user(cu_indices, (void __user *)(uintptr_t)args->cu_indices,
+			   args->count * sizeof(*cu_indices))) {
+		ret = -EFAULT;
+		goto out;
+	}
+
+	ctx.op = args->op;
+	ctx.flags = args->flags;
+	uuid_copy(&ctx.xclbin_id, &args->xclbin_id);
+	for (i = 0; i < args->count; i++) {
+		ctx.cu_index = cu_indices[i];
+		if (args->op == XOCL_CTX_OP_ALLOC_CTX)
+			ret = xocl_add_context(xdev, client, &ctx);
+		else
+			ret = xocl_del_context(xdev, client, &ctx);
+		if (ret)
+			break;
+	}
+
+	if (ret && args->op == XOCL_CTX_OP_ALLOC_CTX) {
+		while (i--) {
+			ctx.cu_index = cu_indices[i];
+			(void) xocl_del_context(xdev, client, &ctx);
+		}
+		i = 0;
+	}
+	args->done = i;
+
+out:
+	kfree(cu_indices);
+	return ret;
+}
+
 /**
  * New ERT populates:
  * [1  ]      : header
@@ -395,6 +452,7 @@ static void notify_execbuf(struct kds_command *xcmd, int status)
 {
 	struct kds_client *client = xcmd->client;
 	struct ert_packet *ecmd = (struct ert_packet *)xcmd->u_execbuf;
+	u32 state = ecmd->state;
 
 	if (xcmd->opcode == OP_START_SK) {
 		/* For PS kernel get cmd state and return_code */
@@ -410,15 +468,20 @@ static void notify_execbuf(struct kds_command *xcmd, int status)
 			read_ert_stat(xcmd);
 
 		if (status == KDS_COMPLETED)
-			ecmd->state = ERT_CMD_STATE_COMPLETED;
+			state = ERT_CMD_STATE_COMPLETED;
 		else if (status == KDS_ERROR)
-			ecmd->state = ERT_CMD_STATE_ERROR;
+			state = ERT_CMD_STATE_ERROR;
 		else if (status == KDS_TIMEOUT)
-			ecmd->state = ERT_CMD_STATE_TIMEOUT;
+			state = ERT_CMD_STATE_TIMEOUT;
 		else if (status == KDS_ABORT)
-			ecmd->state = ERT_CMD_STATE_ABORT;
+			state = ERT_CMD_STATE_ABORT;
+		else if (status == KDS_EXPIRED)
+			state = ERT_CMD_STATE_EXPIRED;
 	}
 
+	if (status == KDS_EXPIRED)
+		client_stat_inc(client, expired);
+
 	if (xcmd->timestamp_enabled) {
 		/* Only start kernel command supports timestamps */
 		struct ert_start_kernel_cmd *scmd;
@@ -429,9 +492,17 @@ static void notify_execbuf(struct kds_command *xcmd, int status)
 		ts->skc_timestamps[ERT_CMD_STATE_NEW] = xcmd->timestamp[KDS_NEW];
 		ts->skc_timestamps[ERT_CMD_STATE_QUEUED] = xcmd->timestamp[KDS_QUEUED];
 		ts->skc_timestamps[ERT_CMD_STATE_RUNNING] = xcmd->timestamp[KDS_RUNNING];
-		ts->skc_timestamps[ecmd->state] = xcmd->timestamp[status];
+		ts->skc_timestamps[state] = xcmd->timestamp[status];
+
+		client_stat_add(client, lat_ns,
+				xcmd->timestamp[status] - xcmd->timestamp[KDS_NEW]);
+		client_stat_inc(client, lat_cnt);
 	}
 
+	/* Timestamps must be visible before host polling sees completion */
+	wmb();
+	ecmd->state = state;
+
 	XOCL_DRM_GEM_OBJECT_PUT_UNLOCKED(xcmd->gem_obj);
 	kfree(xcmd->execbuf);
 
@@ -443,28 +514,30 @@ static void notify_execbuf(struct kds_command *xcmd, int status)
 		xcmd->inkern_cb->func((unsigned long)xcmd->inkern_cb->data, error);
 		kfree(xcmd->inkern_cb);
 	} else {
-		atomic_inc(&client->event);
-		wake_up_interruptible(&client->waitq);
+		kds_client_signal(client);
 	}
 }
 
 static bool copy_and_validate_execbuf(struct xocl_dev *xdev,
 				     struct drm_xocl_bo *xobj,
+				     u32 offset,
 				     struct ert_packet *ecmd)
 {
 	struct kds_sched *kds = &XDEV(xdev)->kds;
 	struct ert_packet *orig;
+	size_t size = xobj->base.size - offset;
 	int pkg_size;
+	int ext_size;
 	struct xcl_errors *err;
 	struct xclErrorLast err_last;
 
 	err = xdev->core.errors;
-	orig = (struct ert_packet *)xobj->vmapping;
+	orig = (struct ert_packet *)((char *)xobj->vmapping + offset);
 	orig->state = ERT_CMD_STATE_NEW;
 	ecmd->header = orig->header;
 
 	pkg_size = sizeof(ecmd->header) + ecmd->count * sizeof(u32);
-	if (xobj->base.size < pkg_size) {
+	if (size < pkg_size) {
 		userpf_err(xdev, "payload size bigger than exec buf\n");
 		err_last.pid = pid_nr(task_tgid(current));
 		err_last.ts = 0; //TODO timestamp
@@ -481,11 +554,17 @@ static bool copy_and_validate_execbuf(struct xocl_dev *xdev,
 		return false;
 	}
 
-	if (get_size_with_timestamps_or_zero(ecmd) > xobj->base.size) {
+	ext_size = get_size_with_timestamps_or_zero(ecmd);
+	if (ext_size > size) {
 		userpf_err(xdev, "no space for timestamp in exec buf\n");
 		return false;
 	}
 
+	/* Deadline follows the payload and timestamps */
+	if (ext_size > pkg_size)
+		memcpy((char *)ecmd + pkg_size, (char *)orig + pkg_size,
+		       ext_size - pkg_size);
+
 	if (kds->xgq_enable)
 		return true;
 
@@ -513,6 +592,28 @@ static void convert_exec_write2key_val( struct ert_start_kernel_cmd *ecmd)
 	ecmd->count -= 6;
 }
 
+/* The CUs of the stages after the first one must be opened by the client.
+ * The CU of the first stage is checked by KDS like any CU command.
+ */
+static bool chain_cus_opened(struct kds_client *client,
+			     struct ert_start_chain_cmd *ecmd)
+{
+	struct ert_chain_stage *stage;
+	u32 num_stages;
+	u32 i;
+
+	num_stages = ecmd->data[ecmd->extra_cu_masks];
+	stage = (struct ert_chain_stage *)&ecmd->data[ecmd->extra_cu_masks + 1];
+	for (i = 1; i < num_stages; i++) {
+		stage = ert_chain_next_stage(stage);
+		if (stage->cu_idx >= MAX_CUS ||
+		    !test_bit(stage->cu_idx, client->cu_bitmap))
+			return false;
+	}
+
+	return true;
+}
+
 static int xocl_fill_payload_xgq(struct xocl_dev *xdev, struct kds_command *xcmd,
 				 struct drm_file *filp)
 {
@@ -542,6 +643,22 @@ static int xocl_fill_payload_xgq(struct xocl_dev *xdev, struct kds_command *xcmd
 		xcmd->isize = xgq_exec_convert_start_cu_cmd(xcmd->info, kecmd);
 		ret = 1; /* hack */
 		break;
+	case ERT_START_CHAIN:
+		if (!chain_cus_opened(filp->driver_priv, to_start_chain_pkg(ecmd))) {
+			userpf_err(xdev, "Chain stage CU is not opened\n");
+			ret = -EINVAL;
+			break;
+		}
+		kecmd = (struct ert_start_kernel_cmd *)xcmd->execbuf;
+		xcmd->type = KDS_CU;
+		xcmd->opcode = OP_START;
+		xcmd->cu_mask[0] = kecmd->cu_mask;
+		memcpy(&xcmd->cu_mask[1], kecmd->data, kecmd->extra_cu_masks);
+		xcmd->num_mask = 1 + kecmd->extra_cu_masks;
+		xcmd->isize = xgq_exec_convert_start_chain_cmd(xcmd->info,
+							       to_start_chain_pkg(ecmd));
+		ret = 1;
+		break;
 	case ERT_CLK_CALIB:
 		ecmd = (struct ert_packet *)xcmd->execbuf;
 		xcmd->opcode = OP_CLK_CALIB;
@@ -596,18 +713,8 @@ static int xocl_fill_payload_xgq(struct xocl_dev *xdev, struct kds_command *xcmd
 	return ret;
 }
 
-static int xocl_command_ioctl(struct xocl_dev *xdev, void *data,
-			      struct drm_file *filp, bool in_kernel)
+static int xocl_command_check(struct xocl_dev *xdev, struct kds_client *client)
 {
-	struct drm_device *ddev = filp->minor->dev;
-	struct kds_client *client = filp->driver_priv;
-	struct drm_xocl_execbuf *args = data;
-	struct drm_gem_object *obj;
-	struct drm_xocl_bo *xobj;
-	struct ert_packet *ecmd = NULL;
-	struct kds_command *xcmd;
-	int ret = 0;
-
 	if (!client->ctx->xclbin_id) {
 		userpf_err(xdev, "The client has no opening context\n");
 		return -EINVAL;
@@ -618,6 +725,29 @@ static int xocl_command_ioctl(struct xocl_dev *xdev, void *data,
 		return -EDEADLK;
 	}
 
+	return 0;
+}
+
+/* Copy and validate an exec BO command and convert it to a KDS command.
+ * On success *xcmdp is the command to add to KDS, or NULL if the command
+ * is already completed.
+ */
+static int xocl_command_prepare(struct xocl_dev *xdev, void *data,
+				struct drm_file *filp, bool in_kernel,
+				struct kds_command **xcmdp)
+{
+	struct drm_device *ddev = filp->minor->dev;
+	struct kds_client *client = filp->driver_priv;
+	struct drm_xocl_execbuf *args = data;
+	struct drm_gem_object *obj;
+	struct drm_xocl_bo *xobj;
+	struct ert_packet *ecmd = NULL;
+	struct kds_command *xcmd;
+	u32 offset = args->exec_bo_offset;
+	u32 payload;
+	int ret = 0;
+
+	*xcmdp = NULL;
 	obj = xocl_gem_object_lookup(ddev, filp, args->exec_bo_handle);
 	if (!obj) {
 		userpf_err(xdev, "Failed to look up GEM BO %d\n",
@@ -642,14 +772,24 @@ static int xocl_command_ioctl(struct xocl_dev *xdev, void *data,
 		goto out;
 	}
 
-	ecmd = kzalloc(xobj->base.size, GFP_KERNEL);
+	/* A slab exec buf carries many commands, each command starts at
+	 * an 8 bytes aligned offset and a command header must fit.
+	 */
+	if (!IS_ALIGNED(offset, sizeof(u64)) ||
+	    offset > xobj->base.size - sizeof(struct ert_packet)) {
+		userpf_err(xdev, "Invalid exec buf offset 0x%x\n", offset);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ecmd = kzalloc(xobj->base.size - offset, GFP_KERNEL);
 	if (!ecmd) {
 		ret = -ENOMEM;
 		goto out;
 	}
 
 	/* If xobj contain a valid command, ecmd would be a copy */
-	if (!copy_and_validate_execbuf(xdev, xobj, ecmd)) {
+	if (!copy_and_validate_execbuf(xdev, xobj, offset, ecmd)) {
 		userpf_err(xdev, "Invalid command\n");
 		ret = -EINVAL;
 		goto out;
@@ -657,8 +797,17 @@ static int xocl_command_ioctl(struct xocl_dev *xdev, void *data,
 
 	/* only the user command knows the real size of the payload.
 	 * count is more than enough!
+	 * CU start commands need no payload buffer, the register map is
+	 * used in place from ecmd, which lives until the command is done.
 	 */
-	xcmd = kds_alloc_command(client, ecmd->count * sizeof(u32));
+	payload = ecmd->count * sizeof(u32);
+	/* The XGQ chain command header is one word longer than the ERT one */
+	if (ecmd->opcode == ERT_START_CHAIN)
+		payload += sizeof(u32);
+	if (!XDEV(xdev)->kds.xgq_enable &&
+	    (ecmd->opcode == ERT_START_CU || ecmd->opcode == ERT_START_KEY_VAL))
+		payload = 0;
+	xcmd = kds_alloc_command(client, payload);
 	if (!xcmd) {
 		userpf_err(xdev, "Failed to alloc xcmd\n");
 		ret = -ENOMEM;
@@ -669,9 +818,10 @@ static int xocl_command_ioctl(struct xocl_dev *xdev, void *data,
 	/* xcmd->execbuf points to kernel space copy */
 	xcmd->execbuf = (u32 *)ecmd;
 	/* xcmd->u_execbuf points to user's original for write back/notice */
-	xcmd->u_execbuf = xobj->vmapping;
+	xcmd->u_execbuf = (u32 *)((char *)xobj->vmapping + offset);
 	xcmd->gem_obj = obj;
 	xcmd->exec_bo_handle = args->exec_bo_handle;
+	xcmd->exec_bo_offset = offset;
 
 	print_ecmd_info(ecmd);
 
@@ -775,11 +925,8 @@ out2:
 		}
 	}
 
-	/* If add command returns failed, KDS core would take care of
-	 * xcmd and put gem object while notify host.
-	 */
-	ret = kds_add_command(&XDEV(xdev)->kds, xcmd);
-	return ret;
+	*xcmdp = xcmd;
+	return 0;
 
 out1:
 	xcmd->cb.free(xcmd);
@@ -792,6 +939,137 @@ out:
 	return ret;
 }
 
+static int xocl_command_ioctl(struct xocl_dev *xdev, void *data,
+			      struct drm_file *filp, bool in_kernel)
+{
+	struct kds_client *client = filp->driver_priv;
+	struct kds_command *xcmd;
+	int ret;
+
+	ret = xocl_command_check(xdev, client);
+	if (ret)
+		return ret;
+
+	ret = xocl_command_prepare(xdev, data, filp, in_kernel, &xcmd);
+	if (ret || !xcmd)
+		return ret;
+
+	/* If add command returns failed, KDS core would take care of
+	 * xcmd and put gem object while notify host.
+	 */
+	return kds_add_command(&XDEV(xdev)->kds, xcmd);
+}
+
+/* Submit an array of exec BOs. The commands are validated one by one,
+ * then all valid commands are added to KDS in one call. On error, the
+ * commands before the failing one are still submitted.
+ */
+static int xocl_command_vec_ioctl(struct xocl_dev *xdev, void *data,
+				  struct drm_file *filp)
+{
+	struct kds_client *client = filp->driver_priv;
+	struct drm_xocl_execbuf_vec *args = data;
+	struct drm_xocl_execbuf *execbufs;
+	struct kds_command **xcmds;
+	struct kds_command *xcmd;
+	int num = 0;
+	int ret;
+	int err;
+	u32 i;
+
+	args->submitted = 0;
+	if (!args->count || args->count > DRM_XOCL_EXECBUF_VEC_MAX)
+		return -EINVAL;
+
+	ret = xocl_command_check(xdev, client);
+	if (ret)
+		return ret;
+
+	execbufs = kmalloc_array(args->count, sizeof(*execbufs), GFP_KERNEL);
+	xcmds = kmalloc_array(args->count, sizeof(*xcmds), GFP_KERNEL);
+	if (!execbufs || !xcmds) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	if (copy_from_user(execbufs, (void __user *)(uintptr_t)args->execbufs,
+			   args->count * sizeof(*execbufs))) {
+		ret = -EFAULT;
+		goto out;
+	}
+
+	for (i = 0; i < args->count; i++) {
+		ret = xocl_command_prepare(xdev, &execbufs[i], filp, false,
+					   &xcmd);
+		if (ret)
+			break;
+		if (xcmd)
+			xcmds[num++] = xcmd;
+	}
+	args->submitted = i;
+
+	/* If add command returns failed, KDS core would take care of
+	 * xcmd and put gem object while notify host.
+	 */
+	err = kds_add_commands(&XDEV(xdev)->kds, xcmds, num);
+	ret = ret ? ret : err;
+
+out:
+	kfree(xcmds);
+	kfree(execbufs);
+	return ret;
+}
+
+/* Binary statistics of CUs and of the calling client, for monitoring
+ * tools that would otherwise parse the kds_custat text on every read.
+ */
+static int xocl_kds_stat_query(struct xocl_dev *xdev, void *data,
+			       struct drm_file *filp)
+{
+	struct kds_client *client = filp->driver_priv;
+	struct kds_cu_mgmt *cu_mgmt = &XDEV(xdev)->kds.cu_mgmt;
+	struct drm_xocl_kds_stat *args = data;
+	struct drm_xocl_kds_cu_stat *stats;
+	struct xrt_cu *xcu;
+	u32 num = 0;
+	int ret = 0;
+	int i;
+
+	if (args->num_cus > MAX_CUS)
+		args->num_cus = MAX_CUS;
+
+	stats = kcalloc(args->num_cus, sizeof(*stats), GFP_KERNEL);
+	if (args->num_cus && !stats)
+		return -ENOMEM;
+
+	mutex_lock(&cu_mgmt->lock);
+	for (i = 0; i < MAX_CUS && num < args->num_cus; ++i) {
+		xcu = cu_mgmt->xcus[i];
+		if (!xcu)
+			continue;
+
+		stats[num].cu_idx = i;
+		stats[num].inflight = xrt_cu_inflight(xcu);
+		stats[num].usage = cu_stat_read(cu_mgmt, usage[i]);
+		stats[num].submitted = client_stat_read(client, s_cnt[i]);
+		stats[num].completed = client_stat_read(client, c_cnt[i]);
+		++num;
+	}
+	mutex_unlock(&cu_mgmt->lock);
+
+	args->num_cus = num;
+	args->lat_ns = client_stat_read(client, lat_ns);
+	args->lat_cnt = client_stat_read(client, lat_cnt);
+	args->expired = client_stat_read(client, expired);
+
+	if (num && copy_to_user((void __user *)(uintptr_t)args->cus_ptr,
+				stats, num * sizeof(*stats)))
+		ret = -EFAULT;
+
+	kfree(stats);
+	return ret;
+}
+
 int xocl_create_client(struct xocl_dev *xdev, void **priv)
 {
 	struct	kds_client	*client;
@@ -868,12 +1146,23 @@ int xocl_client_ioctl(struct xocl_dev *xdev, int op, void *data,
 		ret = xocl_context_ioctl(xdev, data, filp);
 		mutex_unlock(&xdev->dev_lock);
 		break;
+	case DRM_XOCL_CTX_VEC:
+		mutex_lock(&xdev->dev_lock);
+		ret = xocl_context_vec_ioctl(xdev, data, filp);
+		mutex_unlock(&xdev->dev_lock);
+		break;
 	case DRM_XOCL_EXECBUF:
 		ret = xocl_command_ioctl(xdev, data, filp, false);
 		break;
 	case DRM_XOCL_EXECBUF_CB:
 		ret = xocl_command_ioctl(xdev, data, filp, true);
 		break;
+	case DRM_XOCL_EXECBUF_VEC:
+		ret = xocl_command_vec_ioctl(xdev, data, filp);
+		break;
+	case DRM_XOCL_KDS_STAT:
+		ret = xocl_kds_stat_query(xdev, data, filp);
+		break;
 	default:
 		ret = -EINVAL;
 	}
@@ -940,6 +1229,19 @@ int xocl_cu_map_addr(struct xocl_dev *xdev, u32 cu_idx,
 	return ret;
 }
 
+int xocl_fa_desc_map_addr(struct xocl_dev *xdev, u32 cu_idx,
+			  struct drm_file *filp, unsigned long size, u64 *addrp)
+{
+	struct kds_sched *kds = &XDEV(xdev)->kds;
+	struct kds_client *client = filp->driver_priv;
+	int ret;
+
+	mutex_lock(&client->lock);
+	ret = kds_map_fa_desc(kds, client, cu_idx, size, addrp);
+	mutex_unlock(&client->lock);
+	return ret;
+}
+
 u32 xocl_kds_live_clients(struct xocl_dev *xdev, pid_t **plist)
 {
 	return kds_live_clients(&XDEV(xdev)->kds, plist);
@@ -1758,6 +2060,9 @@ int xocl_kds_update(struct xocl_dev *xdev, struct drm_xocl_kds cfg)
 		goto out;
 	}
 
+	XDEV(xdev)->kds.moderate_cnt = cfg.moderate_cnt;
+	XDEV(xdev)->kds.moderate_us = cfg.moderate_us;
+
 	/* By default, use ERT */
 	XDEV(xdev)->kds.cu_intr = 0;
 	ret = kds_cfg_update(&XDEV(xdev)->kds);
@@ -0,0 +1,331 @@
+/*
+ * A GEM style device manager for PCIe based OpenCL accelerators.
+ *
+ * Copyright (C) 2022 Xilinx, Inc. All rights reserved.
+ *
+ * This software is licensed under the terms of the GNU General Public
+ * License version 2, as published by the Free Software Foundation, and
+ * may be copied, distributed, and modified under those terms.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Cache of pinned user memory for userptr BOs.
+ *
+ * A pinned range outlives the userptr BOs created from it, so that a
+ * BO for the same range, or a range within it, is created without
+ * pinning the pages again.  The range is dropped from the cache as
+ * soon as an MMU notifier reports a change of its mapping, e.g. on
+ * munmap() or process exit; BOs already using the pages keep them as
+ * before.  At most xrt_pin_cache_size bytes are kept pinned for ranges
+ * that no BO uses, least recently used ranges are released first.
+ */
+
+#include <linux/mmu_notifier.h>
+#include <linux/pagemap.h>
+#include <linux/version.h>
+#include "common.h"
+
+#if defined(CONFIG_MMU_NOTIFIER) && LINUX_VERSION_CODE >= KERNEL_VERSION(5, 10, 0)
+
+static unsigned long xrt_pin_cache_size = 4UL << 30;
+module_param(xrt_pin_cache_size, ulong, (S_IRUGO|S_IWUSR));
+MODULE_PARM_DESC(xrt_pin_cache_size,
+	"Bytes of user memory kept pinned for reuse by userptr BOs (0 to disable)");
+
+struct xocl_pin {
+	struct list_head		link;
+	struct mmu_interval_notifier	notifier;
+	struct xocl_pin_cache		*cache;
+	struct mm_struct		*mm;
+	u64				addr;
+	u64				size;
+	int				write;
+	struct page			**pages;
+	void				*vmapping;
+	u32				users;
+	bool				valid;
+};
+
+static void xocl_pin_release(struct xocl_pin *pin)
+{
+	mmu_interval_notifier_remove(&pin->notifier);
+	vunmap(pin->vmapping);
+	release_pages(pin->pages, pin->size >> PAGE_SHIFT);
+	kvfree(pin->pages);
+	kfree(pin);
+}
+
+static void xocl_pin_release_list(struct list_head *list)
+{
+	struct xocl_pin *pin, *tmp;
+
+	list_for_each_entry_safe(pin, tmp, list, link) {
+		list_del(&pin->link);
+		xocl_pin_release(pin);
+	}
+}
+
+static bool xocl_pin_invalidate(struct mmu_interval_notifier *mni,
+	const struct mmu_notifier_range *range, unsigned long cur_seq)
+{
+	struct xocl_pin *pin = container_of(mni, struct xocl_pin, notifier);
+	struct xocl_pin_cache *cache = pin->cache;
+
+	spin_lock(&cache->lock);
+	mmu_interval_set_seq(mni, cur_seq);
+	if (pin->valid) {
+		pin->valid = false;
+		if (pin->users) {
+			list_del_init(&pin->link);
+		} else {
+			/* Notifier cannot be removed from its own callback */
+			cache->idle_bytes -= pin->size;
+			list_move_tail(&pin->link, &cache->dead);
+			schedule_work(&cache->release_work);
+		}
+	}
+	spin_unlock(&cache->lock);
+
+	return true;
+}
+
+static const struct mmu_interval_notifier_ops xocl_pin_ops = {
+	.invalidate = xocl_pin_invalidate,
+};
+
+static void xocl_pin_release_work(struct work_struct *work)
+{
+	struct xocl_pin_cache *cache =
+		container_of(work, struct xocl_pin_cache, release_work);
+	LIST_HEAD(dead);
+
+	spin_lock(&cache->lock);
+	list_splice_init(&cache->dead, &dead);
+	spin_unlock(&cache->lock);
+
+	xocl_pin_release_list(&dead);
+}
+
+static struct xocl_pin *xocl_pin_lookup(struct xocl_pin_cache *cache,
+	u64 addr, u64 size, int write)
+{
+	struct xocl_pin *pin;
+
+	spin_lock(&cache->lock);
+	list_for_each_entry(pin, &cache->pins, link) {
+		if (pin->mm != current->mm || pin->write < write ||
+		    addr < pin->addr || addr + size > pin->addr + pin->size)
+			continue;
+
+		if (!pin->users++)
+			cache->idle_bytes -= pin->size;
+		list_move(&pin->link, &cache->pins);
+		spin_unlock(&cache->lock);
+		return pin;
+	}
+	spin_unlock(&cache->lock);
+
+	return NULL;
+}
+
+/*
+ * Get pinned pages for a userptr BO from the cache, or pin the range
+ * and add it to the cache.  Returns NULL if the cache is disabled, in
+ * which case the caller pins the pages itself.
+ */
+struct xocl_pin *xocl_pin_get(struct xocl_drm *drm_p, u64 addr, u64 size,
+	int write)
+{
+	struct xocl_pin_cache *cache = &drm_p->pin_cache;
+	u64 page_count = size >> PAGE_SHIFT;
+	u64 page_pinned = 0;
+	struct xocl_pin *pin;
+	unsigned long seq;
+	int ret;
+
+	if (!xrt_pin_cache_size)
+		return NULL;
+
+	pin = xocl_pin_lookup(cache, addr, size, write);
+	if (pin)
+		return pin;
+
+	pin = kzalloc(sizeof(*pin), GFP_KERNEL);
+	if (!pin)
+		return ERR_PTR(-ENOMEM);
+
+	INIT_LIST_HEAD(&pin->link);
+	pin->cache = cache;
+	pin->mm = current->mm;
+	pin->addr = addr;
+	pin->size = size;
+	pin->write = write;
+	pin->users = 1;
+	pin->pages = kvmalloc_array(page_count, sizeof(*pin->pages), GFP_KERNEL);
+	if (!pin->pages) {
+		ret = -ENOMEM;
+		goto free_pin;
+	}
+
+	/* Track changes of the range from before the pages are pinned */
+	ret = mmu_interval_notifier_insert(&pin->notifier, current->mm,
+		addr, size, &xocl_pin_ops);
+	if (ret)
+		goto free_pages;
+	seq = mmu_interval_read_begin(&pin->notifier);
+
+	while (page_pinned < page_count) {
+		/*
+		 * We pin at most 1G at a time to workaround
+		 * a Linux kernel issue inside get_user_pages_fast().
+		 */
+		u64 nr = min(page_count - page_pinned,
+			(1024ULL * 1024 * 1024) / (1ULL << PAGE_SHIFT));
+		if (get_user_pages_fast(addr + (page_pinned << PAGE_SHIFT),
+			nr, write, pin->pages + page_pinned) != nr) {
+			ret = -ENOMEM;
+			goto unpin;
+		}
+		page_pinned += nr;
+	}
+
+	pin->vmapping = vmap(pin->pages, page_count, VM_MAP, PAGE_KERNEL);
+	if (!pin->vmapping) {
+		ret = -ENOMEM;
+		goto unpin;
+	}
+
+	/* A range that changed while it was pinned is used, not cached */
+	spin_lock(&cache->lock);
+	if (!mmu_interval_read_retry(&pin->notifier, seq)) {
+		pin->valid = true;
+		list_add(&pin->link, &cache->pins);
+	}
+	spin_unlock(&cache->lock);
+
+	return pin;
+
+unpin:
+	if (page_pinned)
+		release_pages(pin->pages, page_pinned);
+	mmu_interval_notifier_remove(&pin->notifier);
+free_pages:
+	kvfree(pin->pages);
+free_pin:
+	kfree(pin);
+	return ERR_PTR(ret);
+}
+
+/*
+ * Drop a BO's use of pinned pages.  The range is kept pinned for reuse
+ * unless it has changed, idle ranges above the cache size are released.
+ */
+void xocl_pin_put(struct xocl_drm *drm_p, struct xocl_pin *pin)
+{
+	struct xocl_pin_cache *cache = &drm_p->pin_cache;
+	struct xocl_pin *p, *tmp;
+	LIST_HEAD(evict);
+
+	spin_lock(&cache->lock);
+	if (--pin->users) {
+		spin_unlock(&cache->lock);
+		return;
+	}
+
+	if (!pin->valid) {
+		spin_unlock(&cache->lock);
+		xocl_pin_release(pin);
+		return;
+	}
+
+	cache->idle_bytes += pin->size;
+	list_for_each_entry_safe_reverse(p, tmp, &cache->pins, link) {
+		if (cache->idle_bytes <= xrt_pin_cache_size)
+			break;
+		if (p->users)
+			continue;
+		p->valid = false;
+		cache->idle_bytes -= p->size;
+		list_move(&p->link, &evict);
+	}
+	spin_unlock(&cache->lock);
+
+	xocl_pin_release_list(&evict);
+}
+
+struct page **xocl_pin_pages(struct xocl_pin *pin, u64 addr)
+{
+	return pin->pages + ((addr - pin->addr) >> PAGE_SHIFT);
+}
+
+void *xocl_pin_vmapping(struct xocl_pin *pin, u64 addr)
+{
+	return (char *)pin->vmapping + (addr - pin->addr);
+}
+
+void xocl_pin_cache_init(struct xocl_drm *drm_p)
+{
+	struct xocl_pin_cache *cache = &drm_p->pin_cache;
+
+	spin_lock_init(&cache->lock);
+	INIT_LIST_HEAD(&cache->pins);
+	INIT_LIST_HEAD(&cache->dead);
+	cache->idle_bytes = 0;
+	INIT_WORK(&cache->release_work, xocl_pin_release_work);
+}
+
+/* All BOs are freed, release the idle ranges */
+void xocl_pin_cache_fini(struct xocl_drm *drm_p)
+{
+	struct xocl_pin_cache *cache = &drm_p->pin_cache;
+	struct xocl_pin *pin;
+	LIST_HEAD(idle);
+
+	spin_lock(&cache->lock);
+	list_for_each_entry(pin, &cache->pins, link)
+		pin->valid = false;
+	list_splice_init(&cache->pins, &idle);
+	list_splice_init(&cache->dead, &idle);
+	cache->idle_bytes = 0;
+	spin_unlock(&cache->lock);
+
+	flush_work(&cache->release_work);
+	xocl_pin_release_list(&idle);
+}
+
+#else
+
+struct xocl_pin *xocl_pin_get(struct xocl_drm *drm_p, u64 addr, u64 size,
+	int write)
+{
+	return NULL;
+}
+
+void xocl_pin_put(struct xocl_drm *drm_p, struct xocl_pin *pin)
+{
+}
+
+struct page **xocl_pin_pages(struct xocl_pin *pin, u64 addr)
+{
+	return NULL;
+}
+
+void *xocl_pin_vmapping(struct xocl_pin *pin, u64 addr)
+{
+	return NULL;
+}
+
+void xocl_pin_cache_init(struct xocl_drm *drm_p)
+{
+}
+
+void xocl_pin_cache_fini(struct xocl_drm *drm_p)
+{
+}
+
+#endif
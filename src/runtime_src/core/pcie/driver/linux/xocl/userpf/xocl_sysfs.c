@@ -233,6 +233,58 @@ static ssize_t memstat_raw_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(memstat_raw);
 
+/*
+ * Free extents per memory bank, one line per bank:
+ * <free bytes> <largest free extent> <free extents> <bo count>
+ * <extents <1M> <extents <16M> <extents <256M> <extents <4G> <extents >=4G>
+ */
+static ssize_t memfrag_raw_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+	struct mem_topology *topo = NULL;
+	struct xocl_mm_frag_stat frag;
+	struct drm_xocl_mm_stat stat;
+	ssize_t size = 0;
+	u64 start;
+	int i, err;
+
+	mutex_lock(&xdev->dev_lock);
+
+	err = XOCL_GET_GROUP_TOPOLOGY(xdev, topo);
+	if (err) {
+		mutex_unlock(&xdev->dev_lock);
+		return err;
+	}
+
+	if (!topo) {
+		size = -EINVAL;
+		goto done;
+	}
+
+	for (i = 0; i < topo->m_count; i++) {
+		memset(&stat, 0, sizeof(stat));
+		memset(&frag, 0, sizeof(frag));
+		if (topo->m_mem_data[i].m_used) {
+			start = topo->m_mem_data[i].m_base_address;
+			xocl_mm_get_frag_stat(XOCL_DRM(xdev), start,
+				start + topo->m_mem_data[i].m_size * 1024, &frag);
+			xocl_mm_get_usage_stat(XOCL_DRM(xdev), i, &stat);
+		}
+
+		size += sprintf(buf + size, "%llu %llu %u %u %u %u %u %u %u\n",
+			frag.free, frag.largest, frag.holes, stat.bo_count,
+			frag.hist[0], frag.hist[1], frag.hist[2], frag.hist[3],
+			frag.hist[4]);
+	}
+
+done:
+	XOCL_PUT_GROUP_TOPOLOGY(xdev);
+	mutex_unlock(&xdev->dev_lock);
+	return size;
+}
+static DEVICE_ATTR_RO(memfrag_raw);
+
 /* -- KDS sysfs start -- */
 static ssize_t
 kds_echo_show(struct device *dev, struct device_attribute *attr, char *buf)
@@ -385,6 +437,102 @@ kds_interval_show(struct device *dev, struct device_attribute *attr, char *buf)
 }
 static DEVICE_ATTR(kds_interval, 0644, kds_interval_show, kds_interval_store);
 
+static ssize_t
+kds_polling_adaptive_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+	u32 adaptive;
+
+	if (kstrtou32(buf, 10, &adaptive) == -EINVAL)
+		return -EINVAL;
+
+	XDEV(xdev)->kds.polling_adaptive = !!adaptive;
+
+	return count;
+}
+
+static ssize_t
+kds_polling_adaptive_show(struct device *dev, struct device_attribute *attr,
+	       char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%d\n", XDEV(xdev)->kds.polling_adaptive);
+}
+static DEVICE_ATTR(kds_polling_adaptive, 0644, kds_polling_adaptive_show,
+		   kds_polling_adaptive_store);
+
+static ssize_t
+kds_fair_share_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+	u32 fair_share;
+
+	if (kstrtou32(buf, 10, &fair_share) == -EINVAL)
+		return -EINVAL;
+
+	WRITE_ONCE(XDEV(xdev)->kds.cu_mgmt.sched.fair_share, !!fair_share);
+
+	return count;
+}
+
+static ssize_t
+kds_fair_share_show(struct device *dev, struct device_attribute *attr,
+	       char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%d\n", XDEV(xdev)->kds.cu_mgmt.sched.fair_share);
+}
+static DEVICE_ATTR(kds_fair_share, 0644, kds_fair_share_show,
+		   kds_fair_share_store);
+
+static ssize_t
+kds_client_depth_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+	u32 depth;
+
+	if (kstrtou32(buf, 10, &depth) == -EINVAL)
+		return -EINVAL;
+
+	WRITE_ONCE(XDEV(xdev)->kds.cu_mgmt.sched.client_depth, depth);
+
+	return count;
+}
+
+static ssize_t
+kds_client_depth_show(struct device *dev, struct device_attribute *attr,
+	       char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return sprintf(buf, "%u\n", XDEV(xdev)->kds.cu_mgmt.sched.client_depth);
+}
+static DEVICE_ATTR(kds_client_depth, 0644, kds_client_depth_show,
+		   kds_client_depth_store);
+
+static ssize_t
+kds_cu_policy_store(struct device *dev, struct device_attribute *da,
+	       const char *buf, size_t count)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return store_kds_cu_policy(&XDEV(xdev)->kds, buf, count);
+}
+
+static ssize_t
+kds_cu_policy_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return show_kds_cu_policy(&XDEV(xdev)->kds, buf);
+}
+static DEVICE_ATTR(kds_cu_policy, 0644, kds_cu_policy_show, kds_cu_policy_store);
+
 static ssize_t
 ert_disable_show(struct device *dev, struct device_attribute *attr, char *buf)
 {
@@ -756,6 +904,15 @@ static ssize_t host_mem_size_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(host_mem_size);
 
+static ssize_t subdev_probe_us_show(struct device *dev,
+	struct device_attribute *attr, char *buf)
+{
+	struct xocl_dev *xdev = dev_get_drvdata(dev);
+
+	return xocl_subdev_show_probe_times(xdev, buf);
+}
+static DEVICE_ATTR_RO(subdev_probe_us);
+
 /* - End attributes-- */
 static struct attribute *xocl_attrs[] = {
 	&dev_attr_xclbinuuid.attr,
@@ -765,6 +922,7 @@ static struct attribute *xocl_attrs[] = {
 	&dev_attr_kdsstat.attr,
 	&dev_attr_memstat.attr,
 	&dev_attr_memstat_raw.attr,
+	&dev_attr_memfrag_raw.attr,
 	&dev_attr_kds_echo.attr,
 	&dev_attr_kds_numcdmas.attr,
 	&dev_attr_kds_stat.attr,
@@ -772,6 +930,10 @@ static struct attribute *xocl_attrs[] = {
 	&dev_attr_kds_scustat_raw.attr,
 	&dev_attr_kds_interrupt.attr,
 	&dev_attr_kds_interval.attr,
+	&dev_attr_kds_polling_adaptive.attr,
+	&dev_attr_kds_fair_share.attr,
+	&dev_attr_kds_client_depth.attr,
+	&dev_attr_kds_cu_policy.attr,
 	&dev_attr_ert_disable.attr,
 	&dev_attr_dev_offline.attr,
 	&dev_attr_mig_calibration.attr,
@@ -790,6 +952,7 @@ static struct attribute *xocl_attrs[] = {
 	&dev_attr_mig_cache_update.attr,
 	&dev_attr_nodma.attr,
 	&dev_attr_host_mem_size.attr,
+	&dev_attr_subdev_probe_us.attr,
 	NULL,
 };
 
@@ -21,6 +21,8 @@
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 7, 0)
 #include <linux/hashtable.h>
 #endif
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
 
 typedef void (*xocl_execbuf_callback)(unsigned long data, int error);
 
@@ -56,6 +58,26 @@ struct xocl_cma_bank {
 	struct xocl_cma_memory	cma_mem[1];
 };
 
+/* Free extent histogram buckets: <1M, <16M, <256M, <4G, >=4G */
+#define XOCL_MM_FRAG_BUCKETS	5
+
+struct xocl_mm_frag_stat {
+	u64	free;
+	u64	largest;
+	u32	holes;
+	u32	hist[XOCL_MM_FRAG_BUCKETS];
+};
+
+/* Pinned user memory kept for reuse by userptr BOs, see xocl_pin_cache.c */
+struct xocl_pin;
+struct xocl_pin_cache {
+	spinlock_t		lock;
+	struct list_head	pins;
+	struct list_head	dead;
+	u64			idle_bytes;
+	struct work_struct	release_work;
+};
+
 struct xocl_drm {
 	xdev_handle_t		xdev;
 	/* memory management */
@@ -72,6 +94,7 @@ struct xocl_drm {
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 7, 0)
 	DECLARE_HASHTABLE(mm_range, 6);
 #endif
+	struct xocl_pin_cache	pin_cache;
 };
 
 struct drm_xocl_bo {
@@ -89,6 +112,7 @@ struct drm_xocl_bo {
 	unsigned              flags;
 	unsigned              mem_idx;
 	unsigned	      user_flags;
+	struct xocl_pin       *pin;
 };
 
 struct drm_xocl_unmgd {
@@ -110,6 +134,9 @@ void xocl_mm_get_usage_stat(struct xocl_drm *drm_p, u32 ddr,
 void xocl_mm_update_usage_stat(struct xocl_drm *drm_p, u32 ddr,
         u64 size, int count);
 
+void xocl_mm_get_frag_stat(struct xocl_drm *drm_p, u64 start, u64 end,
+	struct xocl_mm_frag_stat *pstat);
+
 int xocl_mm_insert_node_range(struct xocl_drm *drm_p, u32 mem_id,
                     struct drm_mm_node *node, u64 size);
 int xocl_mm_insert_node(struct xocl_drm *drm_p, u32 ddr,
@@ -123,6 +150,14 @@ int xocl_cleanup_mem(struct xocl_drm *drm_p);
 
 int xocl_check_topology(struct xocl_drm *drm_p);
 
+struct xocl_pin *xocl_pin_get(struct xocl_drm *drm_p, u64 addr, u64 size,
+	int write);
+void xocl_pin_put(struct xocl_drm *drm_p, struct xocl_pin *pin);
+struct page **xocl_pin_pages(struct xocl_pin *pin, u64 addr);
+void *xocl_pin_vmapping(struct xocl_pin *pin, u64 addr);
+void xocl_pin_cache_init(struct xocl_drm *drm_p);
+void xocl_pin_cache_fini(struct xocl_drm *drm_p);
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 17, 0)
 vm_fault_t xocl_gem_fault(struct vm_fault *vmf);
 #elif LINUX_VERSION_CODE >= KERNEL_VERSION(4, 13, 0)
@@ -402,6 +402,8 @@ struct xocl_subdev {
 	int				pf;
 	struct cdev			*cdev;
 	bool				hold;
+	bool				deferred;
+	ktime_t				probe_time;
 
 	struct resource			*res;
 	char				*res_name;
@@ -561,6 +563,8 @@ struct xocl_dev_core {
 	struct xocl_subdev	**subdevs[XOCL_SUBDEV_NUM];
 	struct xocl_subdev	*dyn_subdev_store;
 	int			dyn_subdev_num;
+	int			deferred_subdev_num;
+	struct work_struct	deferred_work;
 	struct xocl_pci_funcs	*pci_ops;
 
 	struct mutex 		lock;
@@ -777,6 +781,9 @@ struct xocl_dma_funcs {
 	ssize_t (*async_migrate_bo)(struct platform_device *pdev,
 		struct sg_table *sgt, u32 dir, u64 paddr, u32 channel, u64 sz,
 		void (*callback_fn)(unsigned long cb_hndl, int err), void *tx_ctx);
+	/* sgt is already DMA mapped for the device, e.g. imported dma-buf */
+	ssize_t (*migrate_mapped_bo)(struct platform_device *pdev,
+		struct sg_table *sgt, u32 dir, u64 paddr, u32 channel, u64 sz);
 	int (*ac_chan)(struct platform_device *pdev, u32 dir);
 	void (*rel_chan)(struct platform_device *pdev, u32 dir, u32 channel);
 	u32 (*get_chan_count)(struct platform_device *pdev);
@@ -800,6 +807,9 @@ struct xocl_dma_funcs {
 #define	xocl_migrate_bo(xdev, sgt, to_dev, paddr, chan, len)	\
 	(DMA_CB(xdev, migrate_bo) ? DMA_OPS(xdev)->migrate_bo(DMA_DEV(xdev), \
 	sgt, to_dev, paddr, chan, len) : 0)
+#define	xocl_migrate_mapped_bo(xdev, sgt, to_dev, paddr, chan, len)	\
+	(DMA_CB(xdev, migrate_mapped_bo) ? DMA_OPS(xdev)->migrate_mapped_bo(DMA_DEV(xdev), \
+	sgt, to_dev, paddr, chan, len) : -EOPNOTSUPP)
 #define	xocl_async_migrate_bo(xdev, sgt, to_dev, paddr, chan, len, cb_fn, ctx_ptr)	\
 	(DMA_CB(xdev, async_migrate_bo) ? DMA_OPS(xdev)->async_migrate_bo(DMA_DEV(xdev), \
 	sgt, to_dev, paddr, chan, len, cb_fn, ctx_ptr) : 0)
@@ -2126,6 +2136,8 @@ struct xocl_xgq_vmr_funcs {
 	int (*vmr_enable_multiboot)(struct platform_device *pdev);
 	int (*xgq_collect_sensors_by_id)(struct platform_device *pdev, char *buf,
                                      uint8_t id, uint32_t len);
+	int (*xgq_collect_sensors_batch)(struct platform_device *pdev,
+		char **bufs, uint8_t *ids, uint32_t len, int num, int *rets);
 	int (*vmr_load_firmware)(struct platform_device *pdev, char **fw, size_t *fw_size);
 };
 #define	XGQ_DEV(xdev)						\
@@ -2160,6 +2172,9 @@ struct xocl_xgq_vmr_funcs {
 #define	xocl_xgq_collect_sensors_by_id(xdev, buf, id, len)		\
 	(XGQ_CB(xdev, xgq_collect_sensors_by_id) ?		\
 	XGQ_OPS(xdev)->xgq_collect_sensors_by_id(XGQ_DEV(xdev), buf, id, len) : -ENODEV)
+#define	xocl_xgq_collect_sensors_batch(xdev, bufs, ids, len, num, rets)	\
+	(XGQ_CB(xdev, xgq_collect_sensors_batch) ?		\
+	XGQ_OPS(xdev)->xgq_collect_sensors_batch(XGQ_DEV(xdev), bufs, ids, len, num, rets) : -ENODEV)
 #define	xocl_vmr_load_firmware(xdev, fw, fw_size)		\
 	(XGQ_CB(xdev, vmr_load_firmware) ?			\
 	XGQ_OPS(xdev)->vmr_load_firmware(XGQ_DEV(xdev), fw, fw_size) : -ENODEV)
@@ -2313,6 +2328,8 @@ int xocl_subdev_create(xdev_handle_t xdev_hdl,
 int xocl_subdev_create_by_id(xdev_handle_t xdev_hdl, int id);
 int xocl_subdev_create_by_level(xdev_handle_t xdev_hdl, int level);
 int xocl_subdev_create_all(xdev_handle_t xdev_hdl);
+int xocl_subdev_probe_deferred(xdev_handle_t xdev_hdl);
+ssize_t xocl_subdev_show_probe_times(xdev_handle_t xdev_hdl, char *buf);
 void xocl_subdev_destroy_all(xdev_handle_t xdev_hdl);
 int xocl_subdev_offline_all(xdev_handle_t xdev_hdl);
 int xocl_subdev_offline_by_id(xdev_handle_t xdev_hdl, u32 id);
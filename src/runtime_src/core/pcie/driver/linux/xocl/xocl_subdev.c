@@ -15,6 +15,7 @@
 
 #include <linux/pci.h>
 #include <linux/platform_device.h>
+#include <linux/workqueue.h>
 #include "xclfeatures.h"
 #include "xocl_drv.h"
 #include "version.h"
@@ -26,6 +27,37 @@ struct xocl_subdev_array {
 	int count;
 };
 
+/*
+ * Subdevices are created in the order of their id, which is also the
+ * order they depend on each other, e.g. icap is probed before the CUs.
+ * Instances of the same id do not depend on each other, so with
+ * xrt_parallel_probe set they are probed concurrently.
+ */
+static int xrt_parallel_probe = 1;
+module_param(xrt_parallel_probe, int, (S_IRUGO|S_IWUSR));
+MODULE_PARM_DESC(xrt_parallel_probe,
+	"Probe instances of the same subdevice concurrently (0 = serial)");
+
+/*
+ * Debug and profiling monitors are only used by profiling tools.  They
+ * are probed in the background after the essential subdevs, or when
+ * the device is opened, whichever comes first.
+ */
+static int xrt_defer_monitors = 1;
+module_param(xrt_defer_monitors, int, (S_IRUGO|S_IWUSR));
+MODULE_PARM_DESC(xrt_defer_monitors,
+	"Probe debug and profiling monitors off the load path (0 = disable)");
+
+typedef int (*xocl_subdev_op_t)(xdev_handle_t xdev_hdl, void *arg);
+
+struct xocl_subdev_work {
+	struct work_struct	work;
+	xdev_handle_t		xdev_hdl;
+	xocl_subdev_op_t	op;
+	void			*arg;
+	int			ret;
+};
+
 static DEFINE_IDA(xocl_dev_minor_ida);
 static DEFINE_IDA(subdev_inst_ida);
 
@@ -36,11 +68,21 @@ static struct xocl_dsa_map dsa_map[] = {
 
 int xocl_subdev_find_vsec_offset(xdev_handle_t xdev);
 
+static void xocl_subdev_deferred_work_fn(struct work_struct *work)
+{
+	struct xocl_dev_core *core =
+		container_of(work, struct xocl_dev_core, deferred_work);
+
+	(void) xocl_subdev_probe_deferred(core);
+}
+
 void xocl_subdev_fini(xdev_handle_t xdev_hdl)
 {
 	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
 	int i, j;
 
+	cancel_work_sync(&core->deferred_work);
+
 	for (i = 0; i < XOCL_SUBDEV_NUM; i++) {
 		if (core->subdevs[i]) {
 			for (j = 0; j < XOCL_SUBDEV_MAX_INST; j++) {
@@ -77,6 +119,7 @@ int xocl_subdev_init(xdev_handle_t xdev_hdl, struct pci_dev *pdev,
 	core->dev_minor = XOCL_INVALID_MINOR;
 	rwlock_init(&core->rwlock);
 	mutex_init(&core->wq_lock);
+	INIT_WORK(&core->deferred_work, xocl_subdev_deferred_work_fn);
 
 	for (i = 0; i < XOCL_SUBDEV_NUM; i++) {
 		core->subdevs[i] = kzalloc(sizeof(struct xocl_subdev *) *
@@ -175,6 +218,7 @@ static int xocl_subdev_reserve(xdev_handle_t xdev_hdl,
 	}
 
 	subdev->state = XOCL_SUBDEV_STATE_INIT;
+	subdev->probe_time = 0;
 	*rtn_subdev = subdev;
 	return 0;
 }
@@ -366,12 +410,18 @@ static void __xocl_platform_device_unreg(xdev_handle_t xdev_hdl,
 static void __xocl_subdev_destroy(xdev_handle_t xdev_hdl,
 		struct xocl_subdev *subdev)
 {
+	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
 	struct platform_device *pldev;
 	int state;
 
 	if (!subdev || subdev->state == XOCL_SUBDEV_STATE_UNINIT)
 		return;
 
+	if (subdev->deferred) {
+		subdev->deferred = false;
+		core->deferred_subdev_num--;
+	}
+
 	pldev = subdev->pldev;
 	state = subdev->state;
 	subdev->pldev = NULL;
@@ -553,9 +603,102 @@ error:
 	return retval;
 }
 
+static bool xocl_subdev_is_monitor(int id)
+{
+	switch (id) {
+	case XOCL_SUBDEV_AIM:
+	case XOCL_SUBDEV_AM:
+	case XOCL_SUBDEV_ASM:
+	case XOCL_SUBDEV_TRACE_FIFO_LITE:
+	case XOCL_SUBDEV_TRACE_FIFO_FULL:
+	case XOCL_SUBDEV_TRACE_FUNNEL:
+	case XOCL_SUBDEV_TRACE_S2MM:
+	case XOCL_SUBDEV_LAPC:
+	case XOCL_SUBDEV_SPC:
+	case XOCL_SUBDEV_ACCEL_DEADLOCK_DETECTOR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Add the constructed platform device of a reserved subdev and probe
+ * its driver.  Called with xdev lock held, the lock is dropped while
+ * the driver probes.
+ */
+static int __xocl_subdev_add(xdev_handle_t xdev_hdl,
+	struct xocl_subdev *subdev)
+{
+	ktime_t start;
+	int retval;
+
+	/* lock dev, no offline, no destroy */
+	subdev->hold = true;
+	xocl_unlock_xdev(xdev_hdl);
+
+	start = ktime_get();
+	retval = platform_device_add(subdev->pldev);
+	if (retval) {
+		xocl_lock_xdev(xdev_hdl);
+		subdev->hold = false;
+		xocl_xdev_err(xdev_hdl, "failed to add device");
+		goto error;
+	}
+
+	subdev->state = XOCL_SUBDEV_STATE_ADDED;
+
+	xocl_xdev_info(xdev_hdl, "Created subdev %s inst %d level %d",
+			subdev->info.name, subdev->inst, subdev->info.level);
+
+	if (XOCL_GET_DRV_PRI(subdev->pldev) &&
+			XOCL_GET_DRV_PRI(subdev->pldev)->ops)
+		subdev->ops = XOCL_GET_DRV_PRI(subdev->pldev)->ops;
+
+	/*
+	 * force probe to avoid dependence issue. if probing
+	 * failed, it could be the driver is not registered by
+	 * mgmt or user driver init.
+	 */
+	retval = device_attach(&subdev->pldev->dev);
+	subdev->probe_time = ktime_sub(ktime_get(), start);
+	if (retval != 1) {
+		xocl_lock_xdev(xdev_hdl);
+		subdev->hold = false;
+		/* return error without release. relies on caller to decide
+		   if this is an error or not */
+		xocl_xdev_info(xdev_hdl, "failed to probe subdev %s, ret %d",
+			dev_name(&subdev->pldev->dev), retval);
+		subdev->ops = NULL;
+		return -EAGAIN;
+	}
+	xocl_drvinst_set_offline(platform_get_drvdata(subdev->pldev), false);
+	xocl_lock_xdev(xdev_hdl);
+	subdev->hold = false;
+	subdev->state = XOCL_SUBDEV_STATE_ACTIVE;
+	retval = xocl_subdev_cdev_create(subdev->pldev, subdev);
+	if (retval) {
+		xocl_xdev_err(xdev_hdl, "failed to create cdev subdev %s, %d",
+			dev_name(&subdev->pldev->dev), retval);
+		goto error;
+	}
+
+	xocl_xdev_dbg(xdev_hdl, "subdev %s inst %d is active",
+			dev_name(&subdev->pldev->dev), subdev->inst);
+
+	return 0;
+
+error:
+	if (retval != -EEXIST)
+		__xocl_subdev_destroy(xdev_hdl, subdev);
+
+	return retval;
+}
+
 static int __xocl_subdev_create(xdev_handle_t xdev_hdl,
 	struct xocl_subdev_info *sdev_info)
 {
+	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
 	struct xocl_subdev *subdev;
 	struct resource *res = NULL;
 	int i, retval;
@@ -614,64 +757,109 @@ static int __xocl_subdev_create(xdev_handle_t xdev_hdl,
 	if (retval)
 		goto error;
 
-	/* lock dev, no offline, no destroy */
-	subdev->hold = true;
-	xocl_unlock_xdev(xdev_hdl);
-
-	retval = platform_device_add(subdev->pldev);
-	if (retval) {
-		xocl_lock_xdev(xdev_hdl);
-		subdev->hold = false;
-		xocl_xdev_err(xdev_hdl, "failed to add device");
-		goto error;
+	if (xrt_defer_monitors && xocl_subdev_is_monitor(sdev_info->id)) {
+		subdev->deferred = true;
+		core->deferred_subdev_num++;
+		xocl_xdev_info(xdev_hdl, "Deferred subdev %s inst %d level %d",
+			sdev_info->name, subdev->inst, sdev_info->level);
+		schedule_work(&core->deferred_work);
+		return 0;
 	}
 
-	subdev->state = XOCL_SUBDEV_STATE_ADDED;
+	return __xocl_subdev_add(xdev_hdl, subdev);
 
-	xocl_xdev_info(xdev_hdl, "Created subdev %s inst %d level %d",
-			sdev_info->name, subdev->inst, sdev_info->level);
+error:
+	if (retval != -EEXIST && subdev)
+		__xocl_subdev_destroy(xdev_hdl, subdev);
 
-	if (XOCL_GET_DRV_PRI(subdev->pldev) &&
-			XOCL_GET_DRV_PRI(subdev->pldev)->ops)
-		subdev->ops = XOCL_GET_DRV_PRI(subdev->pldev)->ops;
+	return retval;
+}
 
-	/*
-	 * force probe to avoid dependence issue. if probing
-	 * failed, it could be the driver is not registered by
-	 * mgmt or user driver init.
-	 */
-	retval = device_attach(&subdev->pldev->dev);
-	if (retval != 1) {
-		xocl_lock_xdev(xdev_hdl);
-		subdev->hold = false;
-		/* return error without release. relies on caller to decide
-		   if this is an error or not */
-		xocl_xdev_info(xdev_hdl, "failed to probe subdev %s, ret %d",
-			dev_name(&subdev->pldev->dev), retval);
-		subdev->ops = NULL;
-		return -EAGAIN;
+static void xocl_subdev_work_fn(struct work_struct *work)
+{
+	struct xocl_subdev_work *w =
+		container_of(work, struct xocl_subdev_work, work);
+
+	xocl_lock_xdev(w->xdev_hdl);
+	w->ret = w->op(w->xdev_hdl, w->arg);
+	xocl_unlock_xdev(w->xdev_hdl);
+}
+
+/*
+ * Run op on the args of works[0..num) which are independent of each
+ * other.  Called with xdev lock held.  The ops drop the lock while the
+ * subdev driver probes, so with xrt_parallel_probe set the probes of
+ * the group overlap.  Returns the first error other than -EEXIST and
+ * -EAGAIN, which callers do not treat as failure.
+ */
+static int __xocl_subdev_run_group(xdev_handle_t xdev_hdl,
+	xocl_subdev_op_t op, struct xocl_subdev_work *works, int num)
+{
+	int i, ret = 0;
+
+	if (!xrt_parallel_probe || num == 1) {
+		for (i = 0; i < num; i++) {
+			ret = op(xdev_hdl, works[i].arg);
+			if (ret && ret != -EEXIST && ret != -EAGAIN)
+				return ret;
+		}
+		return 0;
 	}
-	xocl_drvinst_set_offline(platform_get_drvdata(subdev->pldev), false);
+
+	for (i = 0; i < num; i++) {
+		INIT_WORK(&works[i].work, xocl_subdev_work_fn);
+		works[i].xdev_hdl = xdev_hdl;
+		works[i].op = op;
+		works[i].ret = 0;
+		queue_work(system_unbound_wq, &works[i].work);
+	}
+
+	xocl_unlock_xdev(xdev_hdl);
+	for (i = 0; i < num; i++)
+		flush_work(&works[i].work);
 	xocl_lock_xdev(xdev_hdl);
-	subdev->hold = false;
-	subdev->state = XOCL_SUBDEV_STATE_ACTIVE;
-	retval = xocl_subdev_cdev_create(subdev->pldev, subdev);
-	if (retval) {
-		xocl_xdev_err(xdev_hdl, "failed to create cdev subdev %s, %d",
-			dev_name(&subdev->pldev->dev), retval);
-		goto error;
+
+	for (i = 0; i < num; i++) {
+		if (works[i].ret && works[i].ret != -EEXIST &&
+		    works[i].ret != -EAGAIN && !ret)
+			ret = works[i].ret;
 	}
 
-	xocl_xdev_dbg(xdev_hdl, "subdev %s inst %d is active",
-			dev_name(&subdev->pldev->dev), subdev->inst);
+	return ret;
+}
 
-	return 0;
+static int xocl_subdev_op_create(xdev_handle_t xdev_hdl, void *arg)
+{
+	return __xocl_subdev_create(xdev_hdl, arg);
+}
 
-error:
-	if (retval != -EEXIST && subdev)
-		__xocl_subdev_destroy(xdev_hdl, subdev);
+/*
+ * Create subdevs from an info array sorted by id.  Consecutive entries
+ * of the same id form a group which is created concurrently, groups
+ * are created in order.
+ */
+static int __xocl_subdev_create_sorted(xdev_handle_t xdev_hdl,
+	struct xocl_subdev_info *subdev_info, int subdev_num)
+{
+	struct xocl_subdev_work *works;
+	int i, n, ret = 0;
+
+	works = vzalloc(sizeof(*works) * subdev_num);
+	if (!works)
+		return -ENOMEM;
+
+	for (i = 0; i < subdev_num; i += n) {
+		for (n = 0; i + n < subdev_num &&
+		    subdev_info[i + n].id == subdev_info[i].id; n++)
+			works[n].arg = &subdev_info[i + n];
+		ret = __xocl_subdev_run_group(xdev_hdl, xocl_subdev_op_create,
+			works, n);
+		if (ret)
+			break;
+	}
 
-	return retval;
+	vfree(works);
+	return ret;
 }
 
 int xocl_subdev_create(xdev_handle_t xdev_hdl,
@@ -769,7 +957,7 @@ int xocl_subdev_create_by_id(xdev_handle_t xdev_hdl, int id)
 int xocl_subdev_create_by_level(xdev_handle_t xdev_hdl, int level)
 {
 	struct xocl_subdev_info *subdev_info = NULL;
-	int i, ret = -ENODEV, subdev_num;
+	int i, n, ret = -ENODEV, subdev_num;
 
 	xocl_lock_xdev(xdev_hdl);
 	subdev_info = xocl_subdev_get_info(xdev_hdl, &subdev_num);
@@ -778,14 +966,17 @@ int xocl_subdev_create_by_level(xdev_handle_t xdev_hdl, int level)
 		return ret;
 	}
 
-	for (i = 0; i < subdev_num; i++) {
+	/* keep the entries of the level, still sorted by id */
+	for (i = 0, n = 0; i < subdev_num; i++) {
 		if (subdev_info[i].level != level)
 			continue;
-		ret = __xocl_subdev_create(xdev_hdl, &subdev_info[i]);
-		if (ret && ret != -EEXIST && ret != -EAGAIN)
-			break;
-		ret = 0;
+		if (n != i)
+			memcpy(&subdev_info[n], &subdev_info[i],
+				sizeof(*subdev_info));
+		n++;
 	}
+	if (n)
+		ret = __xocl_subdev_create_sorted(xdev_hdl, subdev_info, n);
 
 	xocl_unlock_xdev(xdev_hdl);
 	if (subdev_info)
@@ -931,9 +1122,10 @@ int xocl_subdev_create_all(xdev_handle_t xdev_hdl)
 	subdev_info = xocl_subdev_get_info(xdev_hdl, &subdev_num);
 
 	/* create subdevices */
-	for (i = 0; i < subdev_num; i++) {
-		ret = __xocl_subdev_create(xdev_hdl, &subdev_info[i]);
-		if (ret && ret != -EEXIST && ret != -EAGAIN)
+	if (subdev_info) {
+		ret = __xocl_subdev_create_sorted(xdev_hdl, subdev_info,
+			subdev_num);
+		if (ret)
 			goto failed;
 	}
 
@@ -1084,6 +1276,7 @@ static int __xocl_subdev_online(xdev_handle_t xdev_hdl,
 		struct xocl_subdev *subdev)
 {
 	struct xocl_subdev_funcs *subdev_funcs;
+	ktime_t start;
 	int ret = 0;
 
 	BUG_ON(!subdev);
@@ -1091,6 +1284,10 @@ static int __xocl_subdev_online(xdev_handle_t xdev_hdl,
 	if (subdev->state == XOCL_SUBDEV_STATE_UNINIT)
 		return 0;
 
+	/* probed by xocl_subdev_probe_deferred() */
+	if (subdev->deferred)
+		return 0;
+
 	if (subdev->state > XOCL_SUBDEV_STATE_OFFLINE) {
 		xocl_xdev_dbg(xdev_hdl, "%s, already online",
 			subdev->info.name);
@@ -1104,6 +1301,7 @@ static int __xocl_subdev_online(xdev_handle_t xdev_hdl,
 	subdev->hold = true;
 	xocl_unlock_xdev(xdev_hdl);
 
+	start = ktime_get();
 	if (subdev_funcs && subdev_funcs->online) {
 		ret = subdev_funcs->online(subdev->pldev);
 		if (ret)
@@ -1139,6 +1337,7 @@ static int __xocl_subdev_online(xdev_handle_t xdev_hdl,
 				goto failed;
 		}
 	}
+	subdev->probe_time = ktime_sub(ktime_get(), start);
 	xocl_lock_xdev(xdev_hdl);
 	subdev->hold = false;
 
@@ -1297,29 +1496,127 @@ failed:
 	return ret;
 }
 
+static int xocl_subdev_op_online(xdev_handle_t xdev_hdl, void *arg)
+{
+	return __xocl_subdev_online(xdev_hdl, arg);
+}
+
+static int xocl_subdev_op_add(xdev_handle_t xdev_hdl, void *arg)
+{
+	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
+	struct xocl_subdev *subdev = arg;
+
+	/* destroyed while waiting */
+	if (!subdev->deferred)
+		return 0;
+
+	subdev->deferred = false;
+	core->deferred_subdev_num--;
+	return __xocl_subdev_add(xdev_hdl, subdev);
+}
+
+/*
+ * Run op on the subdevs of each id for which match is true, id by id.
+ * The instances of an id are run concurrently.
+ */
+static int __xocl_subdev_run_by_id(xdev_handle_t xdev_hdl,
+	xocl_subdev_op_t op, bool (*match)(struct xocl_subdev *))
+{
+	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
+	struct xocl_subdev_work *works;
+	int ret = 0, i, j, n;
+
+	works = vzalloc(sizeof(*works) * XOCL_SUBDEV_MAX_INST);
+	if (!works)
+		return -ENOMEM;
+
+	for (i = 0; i < ARRAY_SIZE(core->subdevs); i++) {
+		for (j = 0, n = 0; j < XOCL_SUBDEV_MAX_INST; j++) {
+			if (core->subdevs[i][j] && match(core->subdevs[i][j]))
+				works[n++].arg = core->subdevs[i][j];
+		}
+		if (!n)
+			continue;
+		ret = __xocl_subdev_run_group(xdev_hdl, op, works, n);
+		if (ret)
+			break;
+	}
+
+	vfree(works);
+	return ret;
+}
+
+static bool xocl_subdev_match_any(struct xocl_subdev *subdev)
+{
+	return true;
+}
+
+static bool xocl_subdev_match_deferred(struct xocl_subdev *subdev)
+{
+	return subdev->deferred;
+}
+
 int xocl_subdev_online_all(xdev_handle_t xdev_hdl)
+{
+	int ret;
+
+	xocl_lock_xdev(xdev_hdl);
+	ret = __xocl_subdev_run_by_id(xdev_hdl, xocl_subdev_op_online,
+		xocl_subdev_match_any);
+	xocl_unlock_xdev(xdev_hdl);
+
+	return ret;
+}
+
+/*
+ * Probe the subdevs deferred at creation.  Called from the background
+ * work and on open of the device.  Returns immediately if there are
+ * none.
+ */
+int xocl_subdev_probe_deferred(xdev_handle_t xdev_hdl)
 {
 	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
-	int ret = 0, i, j;
+	int ret = 0;
+
+	if (!READ_ONCE(core->deferred_subdev_num))
+		return 0;
+
+	xocl_lock_xdev(xdev_hdl);
+	if (core->deferred_subdev_num)
+		ret = __xocl_subdev_run_by_id(xdev_hdl, xocl_subdev_op_add,
+			xocl_subdev_match_deferred);
+	xocl_unlock_xdev(xdev_hdl);
+
+	return ret;
+}
+
+ssize_t xocl_subdev_show_probe_times(xdev_handle_t xdev_hdl, char *buf)
+{
+	struct xocl_dev_core *core = (struct xocl_dev_core *)xdev_hdl;
+	struct xocl_subdev *subdev;
+	ssize_t count = 0;
+	int i, j;
 
 	xocl_lock_xdev(xdev_hdl);
 	for (i = 0; i < ARRAY_SIZE(core->subdevs); i++) {
 		for (j = 0; j < XOCL_SUBDEV_MAX_INST; j++) {
-			if (!core->subdevs[i][j])
+			subdev = core->subdevs[i][j];
+			if (!subdev || subdev->state == XOCL_SUBDEV_STATE_UNINIT)
 				continue;
-			ret = __xocl_subdev_online(xdev_hdl,
-				core->subdevs[i][j]);
-			if (ret && ret != -EAGAIN)
-				goto failed;
+			if (subdev->deferred)
+				count += scnprintf(buf + count, PAGE_SIZE - count,
+					"%s.%d deferred\n", subdev->info.name,
+					subdev->inst & MINORMASK);
 			else
-				ret = 0;
+				count += scnprintf(buf + count, PAGE_SIZE - count,
+					"%s.%d %lld\n", subdev->info.name,
+					subdev->inst & MINORMASK,
+					ktime_to_us(subdev->probe_time));
 		}
 	}
-
-failed:
 	xocl_unlock_xdev(xdev_hdl);
 
-	return ret;
+	return count;
 }
 
 int xocl_subdev_get_level(struct platform_device *pdev)
@@ -22,8 +22,6 @@
 #define CLIENT_ID_BITS 7
 #define MAX_CLIENTS (1 << CLIENT_ID_BITS)
 
-static uint16_t xocl_xgq_cid;
-
 struct xocl_xgq_client {
 	void			*xxc_client;
 	u32			 xxc_num_cmds;
@@ -37,6 +35,8 @@ struct xocl_xgq {
 	struct xocl_xgq_client	 xx_clients[MAX_CLIENTS];
 	u32			 xx_num_client;
 	void __iomem		*xx_sq_prod_int;
+	/* Sequence part of command ID, protected by xx_lock */
+	u16			 xx_cid;
 };
 
 ssize_t xocl_xgq_dump_info(void *xgq_handle, char *buf, int count)
@@ -84,13 +84,16 @@ int xocl_xgq_set_command(void *xgq_handle, int id, u32 *cmd, size_t sz)
 	int ret = 0;
 
 	hdr = (struct xgq_cmd_sq_hdr *)cmd;
-	/* Assign XGQ command CID */
-	hdr->cid = (xocl_xgq_cid++ << CLIENT_ID_BITS) + id;
 	spin_lock_irqsave(&xgq->xx_lock, flags);
 	ret = xgq_produce(&xgq->xx_xgq, &addr);
 	if (ret)
 		goto unlock_and_out;
 
+	/* Assign XGQ command CID. Each XGQ numbers its own commands, so
+	 * the submit paths of different CUs share no state.
+	 */
+	hdr->cid = (xgq->xx_cid++ << CLIENT_ID_BITS) + id;
+
 	xocl_xgq_write_queue((u32 __iomem *)addr, cmd, sz/sizeof(u32));
 
 unlock_and_out:
@@ -143,8 +146,10 @@ int xocl_xgq_attach(void *xgq_handle, void *client, int *client_id)
 
 	spin_lock_irqsave(&xgq->xx_lock, flags);
 
-	if (xgq->xx_num_client >= MAX_CLIENTS)
+	if (xgq->xx_num_client >= MAX_CLIENTS) {
+		spin_unlock_irqrestore(&xgq->xx_lock, flags);
 		return -ENOMEM;
+	}
 
 	*client_id = xgq->xx_num_client++;
 	xgq->xx_clients[*client_id].xxc_client = client;
@@ -62,6 +62,7 @@ namespace xclemulation{
     mNewMbscheduler = true;
     mXgqMode = false;
     mSimDir = "";
+    mSimCacheDir = "";
     mUserPreSimScript = "";
     mPacketSize = 0x800000;
     mMaxTraceCount = 1;
@@ -231,6 +232,10 @@ namespace xclemulation{
       {
         setSimDir(value);
       }
+      else if(name == "sim_cache_dir")
+      {
+        setSimCacheDir(value);
+      }
       else if(name == "verbosity")
       {
         unsigned int verbosity = strtoll(value.c_str(),NULL,0);
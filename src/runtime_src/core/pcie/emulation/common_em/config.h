@@ -169,6 +169,7 @@ namespace xclemulation{
       inline void setMaxTraceCount( unsigned int maxTraceCount) { mMaxTraceCount    = maxTraceCount; }
       inline void setPaddingFactor( unsigned int paddingFactor) { mPaddingFactor    = paddingFactor; }
       inline void setSimDir( std::string& simDir)               { mSimDir           = simDir;        }
+      inline void setSimCacheDir( std::string& simCacheDir)     { mSimCacheDir      = simCacheDir;   }
       inline void setUserPreSimScript( std::string& userPreSimScript) {mUserPreSimScript = userPreSimScript; }
 	    inline void setUserPostSimScript( std::string& userPostSimScript) {mUserPostSimScript = userPostSimScript; }
       inline void setWcfgFilePath(std::string& wcfgFilePath) { mWcfgFilePath = wcfgFilePath; }      
@@ -197,6 +198,7 @@ namespace xclemulation{
       inline unsigned int getMaxTraceCount()    const { return mMaxTraceCount;  }
       inline unsigned int getPaddingFactor()    const { if(!mOOBChecks) return 0; return mPaddingFactor;  }
       inline std::string getSimDir()            const { return mSimDir;         }
+      inline std::string getSimCacheDir()       const { return mSimCacheDir;    }
       inline std::string getUserPreSimScript()  const { return mUserPreSimScript;}
   	  inline std::string getUserPostSimScript()  const { return mUserPostSimScript;}
       inline std::string getWcfgFilePath()  const { return mWcfgFilePath; }
@@ -234,6 +236,7 @@ namespace xclemulation{
       bool mXgqMode;
       debug_mode mLaunchWaveform;
       std::string mSimDir;
+      std::string mSimCacheDir;
       std::string mUserPreSimScript;
       std::string mUserPostSimScript;
       std::string mWcfgFilePath;
@@ -19,6 +19,9 @@
 
 #include "unix_socket.h"
 
+#include <algorithm>
+#include <cstring>
+
 unix_socket::unix_socket(const std::string& env, const std::string& sock_id, double timeout_insec, bool fatal_error)
 {
   std::string socket = sock_id;
@@ -121,20 +124,73 @@ ssize_t unix_socket::sk_write(const void *wbuf, size_t count)
   return wlen;
 }
 
+ssize_t unix_socket::sk_write(const void *hbuf, size_t hcount, const void *wbuf, size_t count)
+{
+  struct iovec iov[2];
+  iov[0].iov_base = const_cast<void*>(hbuf);
+  iov[0].iov_len = hcount;
+  iov[1].iov_base = const_cast<void*>(wbuf);
+  iov[1].iov_len = count;
+
+  ssize_t r;
+  do {
+    r = writev(fd, iov, 2);
+  } while (r < 0 && (errno == EINTR || errno == EAGAIN));
+  if (r < 0)
+    return -1;
+
+  // Write whatever writev() left out
+  size_t wlen = r;
+  if (wlen < hcount) {
+    if (sk_write(static_cast<const unsigned char*>(hbuf) + wlen, hcount - wlen) < 0)
+      return -1;
+    wlen = hcount;
+  }
+  if (wlen < hcount + count) {
+    if (sk_write(static_cast<const unsigned char*>(wbuf) + wlen - hcount, hcount + count - wlen) < 0)
+      return -1;
+  }
+  return hcount + count;
+}
+
 ssize_t unix_socket::sk_read(void *rbuf, size_t count)
 {
+  static constexpr size_t rd_buf_size = 64 * 1024;
   ssize_t r;
-  ssize_t rlen = 0;
+  size_t rlen = 0;
   unsigned char *buf = (unsigned char*)(rbuf);
 
   do {
-    if ((r = read(fd, buf + rlen, count - rlen)) < 0) {
+    // Take what was received ahead first
+    if (rd_pos < rd_len) {
+      size_t n = std::min(rd_len - rd_pos, count - rlen);
+      std::memcpy(buf + rlen, rd_buf.data() + rd_pos, n);
+      rd_pos += n;
+      rlen += n;
+      continue;
+    }
+
+    // Large reads go straight to the caller's buffer, small ones read
+    // ahead what is available, e.g. the payload after a header
+    if (count - rlen >= rd_buf_size) {
+      if ((r = read(fd, buf + rlen, count - rlen)) < 0) {
+        if (errno == EINTR || errno == EAGAIN)
+          continue;
+        return -1;
+      }
+      rlen += r;
+      continue;
+    }
+
+    rd_buf.resize(rd_buf_size);
+    if ((r = read(fd, rd_buf.data(), rd_buf_size)) < 0) {
       if (errno == EINTR || errno == EAGAIN)
         continue;
       return -1;
     }
-    rlen += r;
-  } while ((rlen < static_cast<unsigned int>(count)) );
+    rd_pos = 0;
+    rd_len = r;
+  } while (rlen < count);
 
   return rlen;
 }
@@ -19,10 +19,12 @@
 #ifndef __XCLHOST_UNIXSOCKET__
 #define __XCLHOST_UNIXSOCKET__
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <sys/stat.h>
 #include <boost/algorithm/string.hpp>
 #include <iostream>
+#include <vector>
 
 #include "system_utils.h"
 #include "em_defines.h"
@@ -32,6 +34,11 @@ class unix_socket {
   private:
     int fd;
     std::string name;
+    // Bytes received ahead of sk_read(), a response header is usually
+    // received together with its payload in one read()
+    std::vector<unsigned char> rd_buf;
+    size_t rd_pos = 0;
+    size_t rd_len = 0;
 public:
     bool server_started;
     void set_name(const std::string &sock_name) { name = sock_name;}
@@ -44,6 +51,8 @@ public:
     }
     void start_server(double timeout_insec,bool fatal_error);
     ssize_t sk_write(const void *wbuf, size_t count);
+    // Write a message header and its payload with one system call
+    ssize_t sk_write(const void *hbuf, size_t hcount, const void *wbuf, size_t count);
     ssize_t sk_read(void *rbuf, size_t count);
 };
 
@@ -4,6 +4,7 @@
  */
 
 #include "shim.h"
+#include "core/common/config_reader.h"
 #include <algorithm>
 //#define EM_DEBUG_KDS
 #define PRINTSTARTFUNC
@@ -311,6 +312,8 @@ namespace xclcpuemhal2 {
     mParent = _parent;
     mScheduler = new xocl_sched(this);
     num_pending = 0;
+    max_running = xrt_core::config::get_sw_emu_cu_threads();
+    num_running = 0;
   }
 
   SWScheduler::~SWScheduler()
@@ -427,6 +430,11 @@ namespace xclcpuemhal2 {
     if (type(xcmd) != ERT_CU)
       return false;
 
+    // Commands are visited in submission order, so with a bound of 1
+    // they also run one at a time in that order
+    if (max_running && num_running >= max_running)
+      return false;
+
     // Find a ready CU
     struct exec_core *exec = xcmd->exec;
     for (unsigned int cuidx = 0; cuidx < exec->num_cus; ++cuidx)
@@ -446,6 +454,7 @@ namespace xclcpuemhal2 {
           xcmd->cu_idx = cuidx;
           ++xcmd->exec->cu_usage[xcmd->cu_idx];
           (xcu->running_queue).push(xcmd);
+          ++num_running;
           return true;
         }
       }
@@ -474,6 +483,7 @@ namespace xclcpuemhal2 {
       if (xcu && cu_first_done(xcu) == xcmd)
       {
         cu_pop_done(xcu);
+        --num_running;
         mark_cmd_complete(xcmd);
       }
     }
@@ -1102,6 +1112,7 @@ namespace xclcpuemhal2 {
     pending_cmds.clear();
     mScheduler->command_queue.clear();
     free_cmds.clear();
+    num_running = 0;
 
     return retval;
   }
@@ -209,6 +209,10 @@ namespace xclcpuemhal2 {
 
     std::mutex m_add_cmd_mutex;
     int num_pending;
+
+    // CU commands running at once, bounded by Emulation.sw_emu_cu_threads
+    unsigned int max_running;
+    unsigned int num_running;
   };
 }
 
@@ -175,12 +175,10 @@ namespace xclhwemhal2 {
   {
     unsigned int size = regmap_size(xcmd);
     uint32_t *regmap = cmd_regmap(xcmd);
-    unsigned int idx;
 
-    for (idx = 4; idx < size; ++idx)
-    {
-      mParent->xclWrite(XCL_ADDR_KERNEL_CTRL, xcu->base + xcu->addr + (idx << 2), (void*)(regmap+idx) ,4);
-    }
+    // one transfer for the whole register map
+    if (size > 4)
+      mParent->xclWrite(XCL_ADDR_KERNEL_CTRL, xcu->base + xcu->addr + (4 << 2), (void*)(regmap+4), (size-4)*4);
   }
 
   void MBScheduler::cu_configure_ooo(struct xocl_cu *xcu, struct xocl_cmd *xcmd)
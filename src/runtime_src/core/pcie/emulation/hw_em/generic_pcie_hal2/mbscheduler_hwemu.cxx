@@ -395,14 +395,25 @@ namespace hwemu {
         unsigned int size = xcmd->regmap_size();
         uint32_t *regmap =  xcmd->regmap();
         unsigned int idx;
+        std::vector<uint32_t> vals;
+        uint32_t start = 0;
 
         // past reserved 4 ctrl + 2 ctx
+        // registers at consecutive offsets are written with one transfer
         for (idx = 6; idx < size - 1; idx += 2) {
             uint32_t offset = *(regmap + idx);
             uint32_t val = *(regmap + idx + 1);
 
-            iowrite32(val, cu_base_addr() + offset);
+            if (!vals.empty() && offset != start + vals.size() * sizeof(uint32_t)) {
+                iowrite32(vals.data(), vals.size(), cu_base_addr() + start);
+                vals.clear();
+            }
+            if (vals.empty())
+                start = offset;
+            vals.push_back(val);
         }
+        if (!vals.empty())
+            iowrite32(vals.data(), vals.size(), cu_base_addr() + start);
     }
 
     /**
@@ -412,11 +423,10 @@ namespace hwemu {
     {
         unsigned int size = xcmd->regmap_size();
         uint32_t *regmap =  xcmd->regmap();
-        unsigned int idx;
 
-        for (idx = 4; idx < size; ++idx) {
-            iowrite32(*(regmap + idx), cu_base_addr() + (idx << 2));
-        }
+        // one transfer for the whole register map
+        if (size > 4)
+            iowrite32(regmap + 4, size - 4, cu_base_addr() + (4 << 2));
     }
 
     /**
@@ -466,6 +476,17 @@ namespace hwemu {
         }
     }
 
+    void xocl_cu::iowrite32(const uint32_t* data, uint32_t count, uint64_t addr)
+    {
+        if (count == 1) {
+            iowrite32(*data, addr);
+            return;
+        }
+
+        // Consecutive registers go to the simulator with one RPC
+        xdevice->xclWrite(XCL_ADDR_KERNEL_CTRL, addr, (void*)data, count * sizeof(uint32_t));
+    }
+
     uint32_t  xocl_cu::ioread32(uint64_t addr) 
     {
         uint32_t data = 0;
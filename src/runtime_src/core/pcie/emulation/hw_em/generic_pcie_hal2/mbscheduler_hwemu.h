@@ -120,6 +120,7 @@ namespace hwemu {
             xocl_cmd* cu_first_done();
 
             void      iowrite32(uint32_t data, uint64_t addr);
+            void      iowrite32(const uint32_t* data, uint32_t count, uint64_t addr);
             uint32_t  ioread32(uint64_t addr);
             void      xocl_memcpy_toio(uint64_t addr, uint32_t* data, uint32_t len);
             void      xocl_memcpy_fromio(uint32_t* data, uint64_t addr, uint32_t len);
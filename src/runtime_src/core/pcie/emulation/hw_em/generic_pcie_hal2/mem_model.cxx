@@ -37,7 +37,7 @@ mem_model::mem_model(std::string deviceName):
       while(written_bytes < size){
           uint64_t src_offset = written_bytes;
 
-          unsigned char* page_ptr  = get_page(addr);
+          unsigned char* page_ptr  = get_write_page(addr);
           uint64_t       page_addr = addr & ~(-1 << ADDRBITS);
 
           unsigned char* dest_buf_ptr = page_ptr + page_addr;
@@ -84,10 +84,10 @@ mem_model::mem_model(std::string deviceName):
 	  while(read_bytes < size){
 		  uint64_t dest_offset = read_bytes;
 
-		  unsigned char* page_ptr  = get_page(addr);
+		  const unsigned char* page_ptr  = get_read_page(addr);
 		  uint64_t       page_addr = addr & ~(-1 << ADDRBITS);
 
-		  unsigned char* src_buf_ptr = page_ptr + page_addr;
+		  const unsigned char* src_buf_ptr = page_ptr + page_addr;
 		  unsigned char* dest_buf_ptr  = (unsigned char*)(dest)      + dest_offset;
 
 		  uint64_t remaining_bytes_to_read = size - read_bytes;
@@ -118,45 +118,79 @@ mem_model::mem_model(std::string deviceName):
 
 	  return 0;
   }
-  unsigned char* mem_model::get_page(uint64_t offset) {
-	  uint64_t page_idx = offset >> ADDRBITS;
-	  std::string file_name = get_mem_file_name(page_idx);
-	  if(pageCache.size() > N_1MBARRAYS)
+  // Page returned for reads of memory that was never written
+  static const unsigned char zero_page[PAGESIZE] = {0};
+
+  std::shared_ptr<unsigned char[]> mem_model::load_page(uint64_t pageIdx) {
+	  std::string file_name = get_mem_file_name(pageIdx);
+	  FILE* pFile = fopen(file_name.c_str(),"r");
+	  if (!pFile)
+		  return nullptr;
+
+	  int fhandle = fileno(pFile);
+	  if (deserialize_msg.ParseFromFileDescriptor(fhandle) == false)
 	  {
-		  std::cerr << "Out of Memory. DDR model does not support this much of memory\n";
+		  fclose(pFile);
 		  exit(1);
-	  } else {
-      FILE* pFile = NULL;
-		  if(pageCache.find(page_idx) != pageCache.end())
-		  {
-			  return pageCache[page_idx];
-		  } else if(((pFile = fopen(file_name.c_str(),"r")) != NULL)) {
-			  int fhandle = fileno(pFile);
+	  }
+	  std::shared_ptr<unsigned char[]> page(new unsigned char[PAGESIZE]);
+	  memcpy(page.get(),deserialize_msg.data().c_str(),PAGESIZE);
+	  fclose(pFile);
+	  return page;
+  }
 
-			  if (deserialize_msg.ParseFromFileDescriptor(fhandle) == false)
-        {
-          fclose(pFile);
-          exit(1);
-        }
-			  pageCache[page_idx] = new unsigned char[PAGESIZE];
-
-			  memcpy(pageCache[page_idx],deserialize_msg.data().c_str(),PAGESIZE);
-			  fclose(pFile);
-			  return pageCache[page_idx];
-		  } else {
-			  pageCache[page_idx] = new unsigned char[PAGESIZE];
-			  return pageCache[page_idx];
-		  }
+  const unsigned char* mem_model::get_read_page(uint64_t offset) {
+	  uint64_t page_idx = offset >> ADDRBITS;
+	  auto itr = pageCache.find(page_idx);
+	  if (itr == pageCache.end())
+		  itr = pageCache.emplace(page_idx,load_page(page_idx)).first;
+	  return itr->second ? itr->second.get() : zero_page;
+  }
+
+  unsigned char* mem_model::get_write_page(uint64_t offset) {
+	  uint64_t page_idx = offset >> ADDRBITS;
+	  auto itr = pageCache.find(page_idx);
+	  if (itr == pageCache.end())
+		  itr = pageCache.emplace(page_idx,load_page(page_idx)).first;
+
+	  auto& page = itr->second;
+	  if (!page) {
+		  page.reset(new unsigned char[PAGESIZE]());
+	  } else if (page.use_count() > 1) {
+		  // Page is shared with a snapshot
+		  std::shared_ptr<unsigned char[]> copy(new unsigned char[PAGESIZE]);
+		  memcpy(copy.get(),page.get(),PAGESIZE);
+		  page = std::move(copy);
 	  }
+	  return page.get();
   }
 
 
   void mem_model::serialize() {
      FILE *pFile;
      int fhandle;
-     for (pageCacheItr=pageCache.begin(); pageCacheItr != pageCache.end(); ++pageCacheItr)
+     bool created = false;
+     for (auto& entry : pageCache)
      {
-        std::string file_name = get_mem_file_name(pageCacheItr->first);
+        if(!entry.second)
+          continue;
+
+        // Directory is only created when there are pages to write
+        if(!created)
+        {
+          std::string file_path = get_mem_file_path();
+          struct stat statBuf;
+          if ( stat(file_path.c_str(), &statBuf) == -1 )
+          {
+            std::stringstream mkdirCommand;
+            mkdirCommand<<"mkdir -p "<<file_path;
+            int rV = system(mkdirCommand.str().c_str());
+            if(rV == -1) {std::cout<<"unable to open/create mem file"<<std::endl;}
+          }
+          created = true;
+        }
+
+        std::string file_name = get_mem_file_name(entry.first);
         pFile = fopen(file_name.c_str(),"w+");
         if(!pFile)
           continue;
@@ -167,7 +201,7 @@ mem_model::mem_model(std::string deviceName):
           exit(1);
         }
 
-        serialize_msg.set_data(reinterpret_cast<const char*>(pageCacheItr->second),PAGESIZE);
+        serialize_msg.set_data(reinterpret_cast<const char*>(entry.second.get()),PAGESIZE);
         if(serialize_msg.SerializeToFileDescriptor(fhandle) == false)
         {
           fclose(pFile);
@@ -177,33 +211,24 @@ mem_model::mem_model(std::string deviceName):
      }
   }
 
- std::string mem_model::get_mem_file_name(uint64_t pageIdx)
+ std::string mem_model::get_mem_file_path()
  {
-   std::string file_name("");
    std::string user("");
    char* cUser = getenv("USER");
    if(cUser)
    {
      user = cUser;
    }
-   std::string file_path("");
    if(mDeviceName.empty() == false)
-     file_path = "/tmp/" + user + "/" + std::to_string(getpid()) + "/hw_em/" + mDeviceName + "/" + module_name + "/";
-    else
-     file_path = "/tmp/" + user + "/hw_em/" + module_name + "/";
-   std::stringstream mkdirCommand;
-   mkdirCommand<<"mkdir -p "<<file_path;;
-   struct stat statBuf;
-   if ( stat(file_path.c_str(), &statBuf) == -1 )
-   {
-     int rV = system(mkdirCommand.str().c_str());
-     if(rV == -1) {std::cout<<"unable to open/create mem file"<<std::endl;}
-   }
-    file_name = file_path + module_name + "_" + std::to_string(pageIdx);
+     return "/tmp/" + user + "/" + std::to_string(getpid()) + "/hw_em/" + mDeviceName + "/" + module_name + "/";
+   return "/tmp/" + user + "/hw_em/" + module_name + "/";
+ }
+
+ std::string mem_model::get_mem_file_name(uint64_t pageIdx)
+ {
+    std::string file_name = get_mem_file_path() + module_name + "_" + std::to_string(pageIdx);
 #ifdef DEBUGMSG
       cout<<"ddr fmodel file_name: "<< file_name<<endl;
 #endif
     return file_name;
  }
-
-
@@ -23,6 +23,7 @@
 #include <sstream> // memcpy
 #include <stdlib.h> //realloc
 #include <map> //realloc
+#include <memory>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -33,19 +34,31 @@
 #define ONE_MB (ONE_KB * ONE_KB)
 #define PAGESIZE (ONE_MB)
 #define ADDRBITS (20)
-#define N_1MBARRAYS 4096
 
+// Device memory is kept as a sparse table of pages.  A page is only
+// allocated when it is first written, reads of other pages return
+// zeros.  Pages are shared with snapshots and copied when written
+// while shared.
 class mem_model{
 public:
+typedef std::map<uint64_t,std::shared_ptr<unsigned char[]>> page_table;
+
 unsigned int writeDevMem(uint64_t offset, const void* src, unsigned int size);
 unsigned int readDevMem(uint64_t offset, void* dest, unsigned int size);
 
+// Copy-on-write snapshot of the memory contents, and restore of it
+page_table snapshot() const { return pageCache; }
+void restore(const page_table& pages) { pageCache = pages; }
+
 protected:
 private:
-  unsigned char* get_page(uint64_t offset);
+  const unsigned char* get_read_page(uint64_t offset);
+  unsigned char* get_write_page(uint64_t offset);
+  std::shared_ptr<unsigned char[]> load_page(uint64_t pageIdx);
+  std::string get_mem_file_path();
   std::string get_mem_file_name(uint64_t pageIdx);
-  std::map<uint64_t,unsigned char*> pageCache;
-  std::map<uint64_t,unsigned char*>::iterator pageCacheItr;
+  // A null page is a zero page that has no serialized file
+  page_table pageCache;
 
   ddr_mem_msg serialize_msg;
   ddr_mem_msg deserialize_msg;
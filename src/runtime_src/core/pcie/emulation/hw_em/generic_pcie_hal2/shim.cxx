@@ -40,8 +40,7 @@
         response_header->set_size(r_len);\
         response_header->SerializeToArray((void*)raw_response_header.get(),ri_len);\
         response_payload.SerializeToArray((void*)raw_response_payload.get(),r_len);\
-        Q2h_sock->sk_write((void*)raw_response_header.get(),ri_len);\
-        Q2h_sock->sk_write((void*)raw_response_payload.get(),r_len);\
+        Q2h_sock->sk_write((void*)raw_response_header.get(),ri_len,(void*)raw_response_payload.get(),r_len);\
     }
 
 
@@ -659,22 +658,37 @@ namespace xclhwemhal2 {
       }
 
       std::string userSpecifiedSimPath = xclemulation::config::getInstance()->getSimDir();
+      std::string simCacheDir = xclemulation::config::getInstance()->getSimCacheDir();
+      std::string simBinaryDirectory = binaryDirectory;
       if (userSpecifiedSimPath.empty())
       {
-        if (mLogStream.is_open())
-          mLogStream << __func__ << " UNZIP of sim bin started" << std::endl;
+        std::string cachedDirectory;
+        if (!simCacheDir.empty())
+          cachedDirectory = getCachedSimDirectory(simCacheDir, xclbin_object.get_uuid().to_string(), zip_fileName);
 
-        systemUtil::makeSystemCall(zip_fileName, systemUtil::systemOperation::UNZIP, binaryDirectory, std::to_string(__LINE__));
+        if (!cachedDirectory.empty())
+        {
+          simBinaryDirectory = cachedDirectory;
+          if (mLogStream.is_open())
+            mLogStream << __func__ << " Using cached sim bin " << simBinaryDirectory << std::endl;
+        }
+        else
+        {
+          if (mLogStream.is_open())
+            mLogStream << __func__ << " UNZIP of sim bin started" << std::endl;
 
-        if (mLogStream.is_open())
-          mLogStream << __func__ << " UNZIP of sim bin complete" << std::endl;
+          systemUtil::makeSystemCall(zip_fileName, systemUtil::systemOperation::UNZIP, binaryDirectory, std::to_string(__LINE__));
 
-        systemUtil::makeSystemCall(binaryDirectory, systemUtil::systemOperation::PERMISSIONS, "777", std::to_string(__LINE__));
+          if (mLogStream.is_open())
+            mLogStream << __func__ << " UNZIP of sim bin complete" << std::endl;
 
-        if (mLogStream.is_open())
-          mLogStream << __func__ << " Permissions operation is complete" << std::endl;
+          systemUtil::makeSystemCall(binaryDirectory, systemUtil::systemOperation::PERMISSIONS, "777", std::to_string(__LINE__));
 
-        simulatorType = getSimulatorType(binaryDirectory);
+          if (mLogStream.is_open())
+            mLogStream << __func__ << " Permissions operation is complete" << std::endl;
+        }
+
+        simulatorType = getSimulatorType(simBinaryDirectory);
         std::transform(simulatorType.begin(), simulatorType.end(), simulatorType.begin(), [](unsigned char c){return std::tolower(c);});
       }
 
@@ -684,7 +698,7 @@ namespace xclhwemhal2 {
         std::string protoFileName = "./" + bdName + "_behav.protoinst";
         std::stringstream cmdLineOption;
         std::string waveformDebugfilePath = "";
-        sim_path = binaryDirectory + "/behav_waveform/" + simulatorType;
+        sim_path = simBinaryDirectory + "/behav_waveform/" + simulatorType;
         setSimPath(sim_path);
 
         if (boost::filesystem::exists(sim_path) != false) {
@@ -722,7 +736,7 @@ namespace xclhwemhal2 {
           << " --protoinst " << protoFileName;
 
         launcherArgs = launcherArgs + cmdLineOption.str();
-        sim_path = binaryDirectory + "/behav_waveform/" + simulatorType;
+        sim_path = simBinaryDirectory + "/behav_waveform/" + simulatorType;
         setSimPath(sim_path);
         std::string waveformDebugfilePath = sim_path + "/waveform_debug_enable.txt";
 
@@ -748,13 +762,13 @@ namespace xclhwemhal2 {
           << " --protoinst " << protoFileName;
 
         launcherArgs = launcherArgs + cmdLineOption.str();
-        sim_path = binaryDirectory + "/behav_waveform/" + simulatorType;
+        sim_path = simBinaryDirectory + "/behav_waveform/" + simulatorType;
         setSimPath(sim_path);
         setenv("VITIS_LAUNCH_WAVEFORM_BATCH", "1", true);
       }
 
       /*if (lWaveform == xclemulation::debug_mode::gdb) {
-        sim_path = binaryDirectory + "/behav_gdb/" + simulatorType;
+        sim_path = simBinaryDirectory + "/behav_gdb/" + simulatorType;
         setSimPath(sim_path);
       }*/
 
@@ -768,7 +782,7 @@ namespace xclhwemhal2 {
       {
         if (sim_path.empty())
         {
-          sim_path = binaryDirectory + "/behav_waveform/" + simulatorType;
+          sim_path = simBinaryDirectory + "/behav_waveform/" + simulatorType;
           setSimPath(sim_path);
         }
 
@@ -776,7 +790,7 @@ namespace xclhwemhal2 {
         /*if (boost::filesystem::exists(sim_path) == false)
         {
           if (lWaveform == xclemulation::debug_mode::gdb) {
-            sim_path = binaryDirectory + "/behav_waveform/" + simulatorType;
+            sim_path = simBinaryDirectory + "/behav_waveform/" + simulatorType;
             setSimPath(sim_path);
             std::string waveformDebugfilePath = sim_path + "/waveform_debug_enable.txt";
 
@@ -802,7 +816,7 @@ namespace xclhwemhal2 {
           }
           else {
             std::string dMsg;
-            sim_path = binaryDirectory + "/behav_gdb/" + simulatorType;
+            sim_path = simBinaryDirectory + "/behav_gdb/" + simulatorType;
             setSimPath(sim_path);
             if (lWaveform == xclemulation::debug_mode::gui)
               dMsg = "WARNING: [HW-EMU 07] debug_mode is set to 'gui' in ini file. Cannot enable simulator gui in this mode. Using " + sim_path + " as simulation directory.";
@@ -1964,6 +1978,37 @@ uint32_t HwEmShim::getAddressSpace (uint32_t topology)
     }
   }
 
+  // Simulation binaries of an xclbin are extracted once into
+  // <sim_cache_dir>/<xclbin uuid> and reused by later processes loading
+  // the same xclbin, which skips the extraction and permissions pass
+  // on every load.  The extraction is published with a rename, so a
+  // concurrent process never sees a partially extracted directory.
+  // Returns an empty string if the cache cannot be used.
+  std::string HwEmShim::getCachedSimDirectory(const std::string& cacheDir, const std::string& uuid, const std::string& zipFileName)
+  {
+    std::string cachedDirectory = cacheDir + "/" + uuid;
+    if (boost::filesystem::exists(cachedDirectory))
+      return cachedDirectory;
+
+    std::string tempDirectory = cachedDirectory + ".tmp." + std::to_string(getpid());
+    systemUtil::makeSystemCall(tempDirectory, systemUtil::systemOperation::CREATE, "", std::to_string(__LINE__));
+    systemUtil::makeSystemCall(zipFileName, systemUtil::systemOperation::UNZIP, tempDirectory, std::to_string(__LINE__));
+    systemUtil::makeSystemCall(tempDirectory, systemUtil::systemOperation::PERMISSIONS, "777", std::to_string(__LINE__));
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tempDirectory, cachedDirectory, ec);
+    if (ec) {
+      // Another process published the same xclbin first
+      systemUtil::makeSystemCall(tempDirectory, systemUtil::systemOperation::REMOVE, "", std::to_string(__LINE__));
+      if (!boost::filesystem::exists(cachedDirectory))
+        return "";
+    }
+
+    std::string dMsg = "INFO: [HW-EMU 26] Simulation binaries cached in " + cachedDirectory;
+    logMessage(dMsg, 1);
+    return cachedDirectory;
+  }
+
   std::string HwEmShim::getSimulatorType(const std::string& binaryDirectory) {
 
     std::string simulator;
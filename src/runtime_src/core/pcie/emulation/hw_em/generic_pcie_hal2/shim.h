@@ -276,6 +276,7 @@ using addr_type = uint64_t;
       bool device2xrt_irq_trans_cb(uint32_t,unsigned long int);
 
       std::string getSimulatorType(const std::string& binaryDirectory);
+      std::string getCachedSimDirectory(const std::string& cacheDir, const std::string& uuid, const std::string& zipFileName);
       void createPreSimScript(const std::string& wcfgFilePath, std::string& preSimScriptPath);
       std::string loadFileContentsToString(const std::string& path);
       void constructQueryTable();
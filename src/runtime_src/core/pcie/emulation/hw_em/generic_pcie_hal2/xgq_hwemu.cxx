@@ -141,16 +141,18 @@ namespace hwemu {
     if (rval)
       return rval;
 
-    for (int i = xcmd->sq_buf.size() - 1; i >= 0; i--)
-      iowrite32_mem(slot_addr + i * 4, xcmd->sq_buf.at(i));
+    // Payload goes out in one transfer, the header word last since it
+    // marks the slot as a new command
+    if (xcmd->sq_buf.size() > 1)
+      device->xclWrite(XCL_ADDR_SPACE_DEVICE_RAM, slot_addr + 4, (void*)(xcmd->sq_buf.data() + 1), (xcmd->sq_buf.size() - 1) * 4);
+    iowrite32_mem(slot_addr, xcmd->sq_buf.at(0));
 
     return 0;
   }
 
   void xgq_queue::read_completion(xgq_com_queue_entry& ccmd, uint64_t addr)
   {
-    for (uint32_t i = 0; i < XGQ_COM_Q1_SLOT_SIZE / 4; i++)
-      ccmd.data[i] = ioread32_mem(addr + i * 4);
+    device->xclRead(XCL_ADDR_SPACE_DEVICE_RAM, addr, (void*)ccmd.data, XGQ_COM_Q1_SLOT_SIZE);
 
     // Write 0 to first word to make sure the cmd state is not NEW
     iowrite32_mem(addr, 0);
@@ -32,6 +32,7 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <poll.h>
 #include <sys/syscall.h>
@@ -327,6 +328,22 @@ struct mac_addr_list
 /* AIM counter values 
  * In PCIe Linux, access the sysfs file for AIM to retrieve the AIM counter values
  */ 
+struct xocl_errors_wait
+{
+  using result_type = query::xocl_errors_wait::result_type;
+
+  static result_type
+  get(const xrt_core::device* device, key_type, const boost::any& timeout)
+  {
+    auto timeout_ms = boost::any_cast<query::xocl_errors_wait::timeout_type>(timeout);
+    std::string err;
+    auto ret = get_pcidev(device)->sysfs_wait("", "xocl_errors", err, timeout_ms);
+    if (ret < 0)
+      throw xrt_core::query::sysfs_error(err);
+    return ret > 0;
+  }
+};
+
 struct aim_counter
 {
   using result_type = query::aim_counter::result_type;
@@ -707,6 +724,7 @@ initialize_query_table()
   emplace_sysfs_getput<query::ic_load_flash_address>           ("icap_controller", "load_flash_addr");
   emplace_sysfs_get<query::memstat>                            ("", "memstat");
   emplace_sysfs_get<query::memstat_raw>                        ("", "memstat_raw");
+  emplace_sysfs_get<query::memfrag_raw>                        ("", "memfrag_raw");
   emplace_sysfs_get<query::mem_topology_raw>                   ("icap", "mem_topology");
   emplace_sysfs_get<query::dma_stream>                         ("dma", "");
   emplace_sysfs_get<query::group_topology>                     ("icap", "group_topology");
@@ -840,6 +858,7 @@ initialize_query_table()
   emplace_sysfs_get<query::shared_host_mem>                    ("", "host_mem_size");
   emplace_sysfs_get<query::enabled_host_mem>                   ("address_translator", "host_mem_size");
   emplace_sysfs_get<query::cpu_affinity>                       ("", "local_cpulist");
+  emplace_sysfs_get<query::numa_node>                          ("", "numa_node");
   emplace_sysfs_get<query::mailbox_metrics>                    ("mailbox", "recv_metrics");
   emplace_sysfs_get<query::clock_timestamp>                    ("ert_ctrl", "clock_timestamp");
   emplace_sysfs_getput<query::ert_sleep>                       ("ert_ctrl", "mb_sleep");
@@ -863,6 +882,7 @@ initialize_query_table()
   emplace_func0_request<query::kds_cu_info,                    kds_cu_info>();
   emplace_func0_request<query::instance,                       instance>();
 
+  emplace_func4_request<query::xocl_errors_wait,               xocl_errors_wait>();
   emplace_func4_request<query::aim_counter,                    aim_counter>();
   emplace_func4_request<query::am_counter,                     am_counter>();
   emplace_func4_request<query::asm_counter,                    asm_counter>();
@@ -1064,13 +1084,24 @@ import_bo(pid_t pid, xclBufferExportHandle ehdl)
     throw xrt_core::system_error(errno, "pidfd_open failed");
 
   auto bofd = syscall(SYS_pidfd_getfd, pidfd, ehdl, 0);
+  auto err = errno;
+  close(pidfd);
   if (bofd < 0)
     throw xrt_core::system_error
-      (errno, "pidfd_getfd failed, check that ptrace access mode "
+      (err, "pidfd_getfd failed, check that ptrace access mode "
        "allows PTRACE_MODE_ATTACH_REALCREDS.  For more details please "
        "check /etc/sysctl.d/10-ptrace.conf");
 
-  return shim::import_bo(bofd);
+  // The imported BO holds its own reference to the dma-buf
+  try {
+    auto bo = shim::import_bo(bofd);
+    close(bofd);
+    return bo;
+  }
+  catch (...) {
+    close(bofd);
+    throw;
+  }
 #else
   throw xrt_core::system_error
     (std::errc::not_supported,
@@ -1079,4 +1110,123 @@ import_bo(pid_t pid, xclBufferExportHandle ehdl)
 #endif
 }
 
+bool
+device_linux::
+is_same_export(pid_t pid, xclBufferExportHandle ehdl, xclBufferExportHandle local) const
+{
+#if defined(SYS_kcmp)
+  // KCMP_FILE, compare file of fd ehdl in pid with file of fd local
+  // in this process.  Fails if pid has exited or is not accessible.
+  constexpr int kcmp_file = 0;
+  return syscall(SYS_kcmp, getpid(), pid, kcmp_file, local, ehdl) == 0;
+#else
+  return false;
+#endif
+}
+
+void
+device_linux::
+exec_buf_at(xclBufferHandle boh, size_t offset)
+{
+  if (auto ret = xclExecBufAt(get_device_handle(), boh, offset))
+    throw system_error(ret, "failed to launch execution buffer");
+}
+
+void
+device_linux::
+exec_buf_batch(const xclBufferHandle* bos, const size_t* offsets, size_t count)
+{
+  if (auto ret = xclExecBufBatch(get_device_handle(), bos, offsets, count))
+    throw system_error(ret, "failed to launch execution buffers");
+}
+
+void
+device_linux::
+open_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count, bool shared)
+{
+  if (auto ret = xclOpenContextBatch(get_device_handle(), xclbin_uuid, ip_indices, count, shared))
+    throw system_error(ret, "failed to open ip contexts");
+}
+
+void
+device_linux::
+close_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count)
+{
+  if (auto ret = xclCloseContextBatch(get_device_handle(), xclbin_uuid, ip_indices, count))
+    throw system_error(ret, "failed to close ip contexts");
+}
+
+std::pair<uint32_t*, size_t>
+device_linux::
+get_reg_window(uint32_t ipidx)
+{
+  uint32_t* base = nullptr;
+  uint32_t size = 0;
+  if (auto ret = xclRegWindow(get_device_handle(), ipidx, &base, &size))
+    throw system_error(ret, "failed to map ip(" + std::to_string(ipidx) + ")");
+  return {base, size};
+}
+
+fa_desc_window
+device_linux::
+map_fa_desc(uint32_t ipidx)
+{
+  fa_desc_window window {};
+  if (auto ret = xclMapFaDesc(get_device_handle(), ipidx, &window.base, &window.dev_addr,
+                              &window.slot_size, &window.num_slots))
+    throw system_error(ret, "failed to map descriptors of ip(" + std::to_string(ipidx) + ")");
+  return window;
+}
+
+void
+device_linux::
+unmap_fa_desc(const fa_desc_window& window)
+{
+  size_t size = static_cast<size_t>(window.slot_size) * window.num_slots;
+  if (auto ret = xclUnmapFaDesc(get_device_handle(), window.base, size))
+    throw system_error(ret, "failed to unmap fast adapter descriptors");
+}
+
+void
+device_linux::
+stage_axlf(const axlf* buffer)
+{
+  if (auto ret = xclStageXclBin(get_device_handle(), buffer))
+    throw system_error(ret, "failed to stage xclbin");
+}
+
+void
+device_linux::
+unstage_axlf(const xuid_t xclbin_id)
+{
+  if (auto ret = xclUnstageXclBin(get_device_handle(), xclbin_id))
+    throw system_error(ret, "failed to unstage xclbin");
+}
+
+bool
+device_linux::
+submit_sync_bo(xclBufferHandle bo, xclBOSyncDirection dir, size_t size, size_t offset,
+               std::function<void(int)> done)
+{
+  using done_fcn = std::function<void(int)>;
+  auto data = std::make_unique<done_fcn>(std::move(done));
+  auto complete = [](void* data, int err) {
+    std::unique_ptr<done_fcn> done(static_cast<done_fcn*>(data));
+    (*done)(err);
+  };
+  if (auto ret = xclSyncBOSubmit(get_device_handle(), bo, dir, size, offset, complete, data.get()))
+    throw system_error(ret, "unable to submit BO sync");
+  data.release();
+  return true;
+}
+
+void
+device_linux::
+sync_bo_batch(const xclBufferHandle* bos, const xclBOSyncDirection* dirs,
+              const size_t* sizes, const size_t* offsets, size_t count)
+{
+  if (auto ret = xclSyncBOBatch(get_device_handle(), bos, dirs, sizes, offsets, count))
+    throw system_error(ret, "unable to sync BO");
+}
+
 } // xrt_core
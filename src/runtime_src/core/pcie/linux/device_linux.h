@@ -65,6 +65,44 @@ public:
 
   xclBufferHandle
   import_bo(pid_t pid, xclBufferExportHandle ehdl) override;
+
+  bool
+  is_same_export(pid_t pid, xclBufferExportHandle ehdl, xclBufferExportHandle local) const override;
+
+  void
+  exec_buf_at(xclBufferHandle boh, size_t offset) override;
+
+  void
+  exec_buf_batch(const xclBufferHandle* bos, const size_t* offsets, size_t count) override;
+
+  void
+  open_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count, bool shared) override;
+
+  void
+  close_contexts(const xuid_t xclbin_uuid, const unsigned int* ip_indices, size_t count) override;
+
+  std::pair<uint32_t*, size_t>
+  get_reg_window(uint32_t ipidx) override;
+
+  fa_desc_window
+  map_fa_desc(uint32_t ipidx) override;
+
+  void
+  unmap_fa_desc(const fa_desc_window& window) override;
+
+  void
+  stage_axlf(const axlf* buffer) override;
+
+  void
+  unstage_axlf(const xuid_t xclbin_id) override;
+
+  bool
+  submit_sync_bo(xclBufferHandle bo, xclBOSyncDirection dir, size_t size, size_t offset,
+                 std::function<void(int)> done) override;
+
+  void
+  sync_bo_batch(const xclBufferHandle* bos, const xclBOSyncDirection* dirs,
+                const size_t* sizes, const size_t* offsets, size_t count) override;
   ////////////////////////////////////////////////////////////////
 
 private:
@@ -38,7 +38,8 @@ namespace hal_hw_plugins {
 bool load()
 {
   if (xrt_core::config::get_xrt_trace() ||
-      xrt_core::utils::load_host_trace())
+      xrt_core::utils::load_host_trace() ||
+      xrt_core::config::get_hal_transfer_stats())
     xdp::hal::load() ;
 
   if (xrt_core::config::get_data_transfer_trace() != "off" ||
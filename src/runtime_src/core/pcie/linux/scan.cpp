@@ -26,8 +26,11 @@
 #include <cstring>
 #include <unistd.h>
 #include <algorithm>
+#include <future>
 #include <mutex>
 #include <regex>
+#include <set>
+#include <map>
 #include <sys/stat.h>
 #include <sys/file.h>
 #include <poll.h>
@@ -234,11 +237,140 @@ open(const std::string& name,
   return fs;
 }
 
+// Attributes read periodically by monitoring, e.g. sensors and
+// compute unit and memory usage.  These are read through a long lived
+// fd which is re-read with pread from offset 0, sysfs regenerates the
+// attribute content when read from offset 0.
+static bool
+is_hot(const std::string& subdev, const std::string& entry)
+{
+  static const std::set<std::string> hot_entries = {
+    "kds_custat", "kds_custat_raw", "kds_scustat_raw", "kds_numcus",
+    "memstat", "memstat_raw", "mem_topology", "dma_stat", "host_mem_size"
+  };
+  return subdev == "xmc" || hot_entries.count(entry);
+}
+
+// class attr_fds - cache of open fds of hot attributes
+//
+// The fds are keyed by device, subdev, and entry which avoids the
+// path resolution in get_path() as well as the open and close per
+// read.  An fd that fails to read, e.g. because the device was removed
+// or reset, is closed and the attribute is opened again.
+class attr_fds
+{
+  std::mutex m_mutex;
+  std::map<std::string, int> m_fds;
+
+  static std::string
+  key(const std::string& name, const std::string& subdev, const std::string& entry)
+  {
+    return name + "/" + subdev + "/" + entry;
+  }
+
+  static bool
+  pread_all(int fd, std::string& content)
+  {
+    char buf[4096];
+    content.clear();
+    off_t off = 0;
+    while (true) {
+      auto len = ::pread(fd, buf, sizeof(buf), off);
+      if (len < 0)
+        return false;
+      if (len == 0)
+        return true;
+      content.append(buf, len);
+      off += len;
+    }
+  }
+
+  int
+  get_fd(const std::string& name, const std::string& subdev, const std::string& entry,
+         std::string& err)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto k = key(name, subdev, entry);
+    auto itr = m_fds.find(k);
+    if (itr != m_fds.end())
+      return (*itr).second;
+
+    auto path = get_path(name, subdev, entry);
+    if (path.empty()) {
+      err = "Failed to find subdirectory for " + subdev + " under " + dev_root + name + "\n";
+      return -1;
+    }
+
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      err = "Failed to open " + path + " for reading: " + strerror(errno) + "\n";
+      return -1;
+    }
+    m_fds.emplace(std::move(k), fd);
+    return fd;
+  }
+
+  void
+  close_fd(const std::string& name, const std::string& subdev, const std::string& entry, int fd)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto itr = m_fds.find(key(name, subdev, entry));
+    if (itr != m_fds.end() && (*itr).second == fd) {
+      ::close(fd);
+      m_fds.erase(itr);
+    }
+  }
+
+public:
+  ~attr_fds()
+  {
+    for (auto& kv : m_fds)
+      ::close(kv.second);
+  }
+
+  bool
+  read(const std::string& name, const std::string& subdev, const std::string& entry,
+       std::string& err, std::string& content)
+  {
+    for (int retry = 0; retry < 2; ++retry) {
+      err.clear();
+      auto fd = get_fd(name, subdev, entry, err);
+      if (fd < 0)
+        return false;
+      if (pread_all(fd, content))
+        return true;
+      err = "Failed to read " + key(name, subdev, entry) + ": " + strerror(errno) + "\n";
+      close_fd(name, subdev, entry, fd);
+    }
+    return false;
+  }
+};
+
+static attr_fds&
+get_attr_fds()
+{
+  static attr_fds fds;
+  return fds;
+}
+
 static void
 get(const std::string& name,
     const std::string& subdev, const std::string& entry,
     std::string& err, std::vector<std::string>& sv)
 {
+  if (is_hot(subdev, entry)) {
+    std::string content;
+    if (!get_attr_fds().read(name, subdev, entry, err, content))
+      return;
+
+    sv.clear();
+    std::istringstream is(content);
+    std::string line;
+    while (std::getline(is, line))
+      sv.push_back(line);
+    return;
+  }
+
   std::fstream fs = open(name, subdev, entry, err, false, false);
   if (!err.empty())
     return;
@@ -249,6 +381,38 @@ get(const std::string& name,
     sv.push_back(line);
 }
 
+// Block until the driver signals a change of an attribute with
+// sysfs_notify(), or until timeout.  Returns 1 if the attribute
+// changed, 0 on timeout, and -1 on error.
+static int
+wait(const std::string& name,
+     const std::string& subdev, const std::string& entry,
+     std::string& err, int timeout_ms)
+{
+  auto path = get_path(name, subdev, entry);
+  if (path.empty()) {
+    err = "Failed to find subdirectory for " + subdev + " under " + dev_root + name + "\n";
+    return -1;
+  }
+
+  auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    err = "Failed to open " + path + " for reading: " + strerror(errno) + "\n";
+    return -1;
+  }
+
+  // Poll for sysfs_notify() requires the attribute to have been read
+  char buf[4096];
+  while (::read(fd, buf, sizeof(buf)) > 0);
+
+  pollfd pfd = {fd, POLLPRI | POLLERR, 0};
+  auto ret = ::poll(&pfd, 1, timeout_ms);
+  if (ret < 0)
+    err = "Failed to poll " + path + ": " + strerror(errno) + "\n";
+  ::close(fd);
+  return ret < 0 ? -1 : (ret > 0 ? 1 : 0);
+}
+
 static void
 get(const std::string& name,
     const std::string& subdev, const std::string& entry,
@@ -416,6 +580,14 @@ sysfs_get(const std::string& subdev, const std::string& entry,
   sysfs::get(sysfs_name, subdev, entry, err, s);
 }
 
+int
+pci_device::
+sysfs_wait(const std::string& subdev, const std::string& entry,
+           std::string& err, int timeout_ms)
+{
+  return sysfs::wait(sysfs_name, subdev, entry, err, timeout_ms);
+}
+
 
 void
 pci_device::
@@ -522,9 +694,10 @@ pci_device(const std::string& drv_name, const std::string& sysfs) : sysfs_name(s
   else
     instance = get_render_value(sysfs::dev_root + sysfs + "/drm");
 
-  sysfs_get<int>("", "userbar", err, user_bar, 0);
-  user_bar_size = bar_size(sysfs::dev_root + sysfs, user_bar);
   sysfs_get<bool>("", "ready", err, is_ready, false);
+
+  // User BAR is looked up when first mapped, see map_usr_bar(), which
+  // is only needed by devices that are actually used
 }
 
 pci_device::
@@ -543,6 +716,16 @@ map_usr_bar()
   if (user_bar_map != MAP_FAILED)
     return 0;
 
+  if (!user_bar_size) {
+    // Not virtual sysfs_get(), same lookup as when this was done in
+    // the base constructor
+    std::string err;
+    std::vector<uint64_t> iv;
+    sysfs::get(sysfs_name, "", "userbar", err, iv);
+    user_bar = iv.empty() ? 0 : static_cast<int>(iv[0]);
+    user_bar_size = bar_size(sysfs::dev_root + sysfs_name, user_bar);
+  }
+
   int dev_handle = open("", O_RDWR);
   if (dev_handle < 0)
     return -errno;
@@ -980,6 +1163,29 @@ public:
   }
 
 private:
+  // Construct device of a PCIe function bound to driver, returns
+  // nullptr if the function is not a supported device.
+  static std::shared_ptr<pci_device>
+  make_device(const std::string& driver, const std::string& sysfs_name)
+  {
+    std::shared_ptr<pci_device> pf;
+    if (!is_drv_v2(driver))
+      pf = std::make_shared<pci_device>(driver, sysfs_name);
+    else
+      pf = std::make_shared<pci_device_v2>(driver, sysfs_name);
+    if(!pf || pf->domain == INVALID_ID)
+      return nullptr;
+
+    // In docker, all host sysfs nodes are available. So, we need to check
+    // devnode to make sure the device is really assigned to docker. For
+    // xoclv2 driver, we only have flash devnode when running golden image.
+    if (!bfs::exists(pf->get_subdev_path("", -1)) &&
+      !bfs::exists(pf->get_subdev_path("flash", -1)))
+      return nullptr;
+
+    return pf;
+  }
+
   void rescan_nolock(const std::string driver)
   {
     const std::string drvpath = sysfs::drv_root + driver;
@@ -990,20 +1196,17 @@ private:
     std::vector<bfs::path> vec{bfs::directory_iterator(drvpath), bfs::directory_iterator()};
     std::sort(vec.begin(), vec.end());
 
-    for (auto& path : vec) {
-      std::shared_ptr<pci_device> pf;
-      if (!is_drv_v2(driver))
-        pf = std::make_shared<pci_device>(driver, path.filename().string());
-      else
-        pf = std::make_shared<pci_device_v2>(driver, path.filename().string());
-      if(!pf || pf->domain == INVALID_ID)
-        continue;
-
-      // In docker, all host sysfs nodes are available. So, we need to check
-      // devnode to make sure the device is really assigned to docker. For
-      // xoclv2 driver, we only have flash devnode when running golden image.
-      if (!bfs::exists(pf->get_subdev_path("", -1)) &&
-        !bfs::exists(pf->get_subdev_path("flash", -1)))
+    // Construct the pci_device objects in parallel, each construction
+    // reads several sysfs nodes of its own PCIe function.  The results
+    // are collected in sorted order to keep device indices stable.
+    std::vector<std::future<std::shared_ptr<pci_device>>> pfs;
+    pfs.reserve(vec.size());
+    for (auto& path : vec)
+      pfs.push_back(std::async(std::launch::async, &make_device, driver, path.filename().string()));
+
+    for (auto& fpf : pfs) {
+      auto pf = fpf.get();
+      if (!pf)
         continue;
 
       auto& list = pf->is_mgmt() ? mgmt_list : user_list;
@@ -127,6 +127,13 @@ public:
     sysfs_get<uint32_t>(subdev, entry, err, i, 0);
   }
 
+  // Wait for change of a sysfs entry signaled by driver with
+  // sysfs_notify().  Returns 1 on change, 0 on timeout, -1 on error.
+  // An attribute not notified by the driver times out.
+  virtual int
+  sysfs_wait(const std::string& subdev, const std::string& entry,
+             std::string& err, int timeout_ms);
+
   virtual void
   sysfs_put(const std::string& subdev, const std::string& entry,
             std::string& err, const std::string& input);
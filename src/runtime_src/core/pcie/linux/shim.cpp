@@ -25,7 +25,9 @@
 #include "core/common/bo_cache.h"
 #include "core/common/config_reader.h"
 #include "core/common/query_requests.h"
+#include "core/common/thread.h"
 #include "core/common/AlignedAllocator.h"
+#include "core/common/memalign.h"
 
 #include "plugin/xdp/hal_profile.h"
 #include "plugin/xdp/hal_api_interface.h"
@@ -51,6 +53,8 @@
 #include <cstdarg>
 #include <cerrno>
 #include <condition_variable>
+#include <limits>
+#include <algorithm>
 
 #include <unistd.h>
 #include <poll.h>
@@ -60,6 +64,9 @@
 #include <sys/uio.h>
 #include <sys/syscall.h>
 #include <sys/file.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#include <fcntl.h>
 #include <linux/aio_abi.h>
 #include <asm/mman.h>
 
@@ -76,6 +83,7 @@
 #define ARRAY_SIZE(x)   (sizeof (x) / sizeof (x[0]))
 
 #define SHIM_QDMA_AIO_EVT_MAX   1024 * 64
+#define SHIM_QDMA_AIO_SUBMIT_MAX 16U  /* buffers per io_submit() */
 
 // Profiling
 #define AXI_FIFO_RDFD_AXI_FULL          0x1000
@@ -354,7 +362,7 @@ private:
         if (qAioEn && (byteThresh || pktThresh) && !qAioBatchEn) {
             std::lock_guard<std::mutex> lk(reqLock);
             qExit = false;
-            qWorker = std::thread(&queue_cb::queue_aio_worker, this);
+            qWorker = xrt_core::thread(xrt_core::thread_class::dma, &queue_cb::queue_aio_worker, this);
             qAioBatchEn = true;
         }
     }
@@ -496,20 +504,34 @@ public:
         header.flags = wr->flag;
         if (aio) {
             aio_context_t *aio_ctx = qAioEn ? &qAioCtx : mAioCtx;
-            for (unsigned int i = 0; i < wr->buf_num; i++) {
-                struct iovec iov[2];
-		struct iocb cb;
-		struct iocb *cbs[1] = {&cb};
+            unsigned int submitted = 0;
+
+            /* submit the buffers in chunks, one io_submit() per chunk */
+            while (submitted < wr->buf_num) {
+                struct iovec iov[SHIM_QDMA_AIO_SUBMIT_MAX][2];
+                struct iocb cb[SHIM_QDMA_AIO_SUBMIT_MAX];
+                struct iocb *cbs[SHIM_QDMA_AIO_SUBMIT_MAX];
+                unsigned int nr = std::min(wr->buf_num - submitted,
+                                           SHIM_QDMA_AIO_SUBMIT_MAX);
+
+                for (unsigned int i = 0; i < nr; i++) {
+                    auto& buf = wr->bufs[submitted + i];
+                    prepare_io(&cb[i], iov[i], &header, buf.va, buf.len,
+                               (uint64_t)wr->priv_data);
+                    cbs[i] = &cb[i];
+                }
 
-                prepare_io(&cb, iov, &header, wr->bufs[i].va, wr->bufs[i].len,
-			 (uint64_t)wr->priv_data);
-                error = io_submit(*aio_ctx, 1, cbs);
+                error = io_submit(*aio_ctx, nr, cbs);
                 if (error <= 0)
                     break;
-                rc += wr->bufs[i].len;
+                for (int i = 0; i < error; i++)
+                    rc += wr->bufs[submitted + i].len;
+                submitted += error;
+                if (static_cast<unsigned int>(error) < nr)
+                    break;
             }
             std::lock_guard<std::mutex> lk(reqLock);
-            cbSubmitCnt += wr->buf_num;
+            cbSubmitCnt += submitted;
         } else {
             for (unsigned int i = 0; i < wr->buf_num; i++) {
                 struct iovec iov[2];
@@ -548,7 +570,6 @@ shim(unsigned index)
   , mStallProfilingNumberSlots(0)
   , mStreamProfilingNumberSlots(0)
   , mCmdBOCache(nullptr)
-  , mCuMaps{128, {nullptr, 0}}
 {
   init(index);
 }
@@ -645,11 +666,15 @@ shim::~shim()
     // be done before the device is closed.
     mCmdBOCache.reset(nullptr);
 
+    // Submitted syncs must complete while the device is still open.
+    stopSyncWorkers();
+
     dev_fini();
 
-    for (auto p : mCuMaps) {
-        if (p.first)
-            (void) munmap(p.first, p.second);
+    unmapRetiredCus();
+    for (auto& cumap : mCuMaps) {
+        if (auto p = cumap.base.load())
+            (void) munmap(p, cumap.size);
     }
 }
 
@@ -851,6 +876,211 @@ int shim::xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size,
     return ret ? -errno : ret;
 }
 
+/*
+ * xclSyncBOBatch()
+ *
+ * Sync up to DRM_XOCL_SYNC_BO_VEC_MAX ranges per ioctl.  Falls back to
+ * one ioctl per range with a driver that does not support the vectored
+ * ioctl.
+ */
+int shim::xclSyncBOBatch(const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+                         const size_t* sizes, const size_t* offsets, size_t count)
+{
+    std::vector<drm_xocl_sync_bo> syncs;
+    syncs.reserve(count);
+    for (size_t idx = 0; idx < count; ++idx) {
+        drm_xocl_sync_bo_dir drm_dir = (dirs[idx] == XCL_BO_SYNC_BO_TO_DEVICE) ?
+            DRM_XOCL_SYNC_BO_TO_DEVICE :
+            DRM_XOCL_SYNC_BO_FROM_DEVICE;
+        if (sizes[idx])
+            syncs.push_back({boHandles[idx], 0, sizes[idx], offsets[idx], drm_dir});
+    }
+
+    size_t idx = 0;
+    while (idx < syncs.size() && mSyncBOVec) {
+        auto num = std::min<size_t>(syncs.size() - idx, DRM_XOCL_SYNC_BO_VEC_MAX);
+        drm_xocl_sync_bo_vec vec = {static_cast<uint32_t>(num), 0, reinterpret_cast<uint64_t>(&syncs[idx])};
+        if (!mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_SYNC_BO_VEC, &vec)) {
+            idx += num;
+            continue;
+        }
+        if (errno != ENOTTY && errno != EINVAL)
+            return -errno;
+
+        // Either a range is invalid or the driver is old, the single
+        // range ioctl tells which.  Ranges before the failing one may
+        // have been synced, syncing them again is harmless.
+        for (size_t i = idx; i < idx + num; ++i) {
+            if (mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_SYNC_BO, &syncs[i]))
+                return -errno;
+        }
+        mSyncBOVec = false;
+        idx += num;
+    }
+
+    for (; idx < syncs.size(); ++idx) {
+        if (mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_SYNC_BO, &syncs[idx]))
+            return -errno;
+    }
+    return 0;
+}
+
+/*
+ * mapHostMem()
+ *
+ * Map size bytes of 1GB huge pages for the host memory bank.  With
+ * Runtime.host_mem_hugetlbfs the pages belong to a file of the device
+ * in that hugetlbfs directory.  Pages of the file stay allocated after
+ * the bank is freed, so later enables reuse them instead of competing
+ * for huge pages that fragmentation may have made unavailable.
+ * Otherwise the pages come from the anonymous huge page pool.  Either
+ * way the pages are reserved when mapped, so mapping fails rather than
+ * pinning.  The mapping prefers the NUMA node from
+ * Runtime.host_mem_numa_node.  The driver faults the pages in when it
+ * pins them.
+ */
+int shim::mapHostMem(uint64_t size, void **addr)
+{
+    const uint64_t hugepage_flag = 0x1e;
+    auto dir = xrt_core::config::get_host_mem_hugetlbfs();
+
+    int fd = -1;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | hugepage_flag << MAP_HUGE_SHIFT;
+    if (!dir.empty()) {
+        auto path = dir + "/xrt_host_mem_" + mDev->sysfs_name;
+        fd = ::open(path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            int err = errno;
+            xrt_logmsg(XRT_ERROR, "%s: cannot open %s: %s", __func__, path.c_str(), strerror(err));
+            return -err;
+        }
+
+        // Each page handed to the driver must be a 1GB page
+        struct statfs fs;
+        if (fstatfs(fd, &fs) || fs.f_type != HUGETLBFS_MAGIC || fs.f_bsize != (1 << 30)) {
+            xrt_logmsg(XRT_ERROR, "%s: %s is not a hugetlbfs mount with 1GB pages", __func__, dir.c_str());
+            ::close(fd);
+            return -EINVAL;
+        }
+        flags = MAP_SHARED;
+    }
+
+    void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    int err = errno;
+    if (fd >= 0)
+        ::close(fd);
+    if (ptr == MAP_FAILED) {
+        xrt_logmsg(XRT_ERROR, "%s: cannot reserve %llu 1GB huge pages%s: %s", __func__,
+                   static_cast<unsigned long long>(size >> 30),
+                   dir.empty() ? "" : (" in " + dir).c_str(), strerror(err));
+        return -err;
+    }
+
+    int node = -1;
+    auto numa = xrt_core::config::get_host_mem_numa_node();
+    if (numa == "device") {
+        std::string errmsg;
+        mDev->sysfs_get<int>("", "numa_node", errmsg, node, -1);
+    }
+    else if (numa != "none") {
+        try {
+            node = std::stoi(numa);
+        }
+        catch (const std::exception&) {
+            xrt_logmsg(XRT_WARNING, "%s: ignoring invalid Runtime.host_mem_numa_node '%s'",
+                       __func__, numa.c_str());
+        }
+    }
+
+    if (node >= 0) {
+        try {
+            xrt_core::mbind_preferred(ptr, size, node);
+        }
+        catch (const std::exception& ex) {
+            xrt_logmsg(XRT_WARNING, "%s: %s", __func__, ex.what());
+        }
+    }
+
+    *addr = ptr;
+    return 0;
+}
+
+/*
+ * xclSyncBOSubmit()
+ *
+ * Queue a sync for the DMA workers; done(data, err) is called from a
+ * worker thread once the sync has completed.
+ */
+int shim::xclSyncBOSubmit(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset,
+                          void (*done)(void*, int), void* data)
+{
+    std::lock_guard<std::mutex> lk(mSyncLock);
+    if (mSyncStop)
+        return -ENODEV;
+
+    if (mSyncWorkers.empty()) {
+        auto channels = std::max<unsigned int>(mDeviceInfo.mDMAThreads, 1);
+        for (unsigned int i = 0; i < channels; ++i)
+            mSyncWorkers.emplace_back(&shim::syncWorker, this);
+    }
+
+    mSyncQueue.push_back({boHandle, dir, size, offset, done, data});
+    mSyncReady.notify_one();
+    return 0;
+}
+
+void shim::syncWorker()
+{
+    const size_t maxBatch = 32;
+    std::vector<sync_request> batch;
+    batch.reserve(maxBatch);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(mSyncLock);
+            mSyncReady.wait(lk, [this] { return mSyncStop || !mSyncQueue.empty(); });
+            if (mSyncQueue.empty())
+                return;
+
+            auto count = std::min(maxBatch, mSyncQueue.size());
+            batch.assign(mSyncQueue.begin(), mSyncQueue.begin() + count);
+            mSyncQueue.erase(mSyncQueue.begin(), mSyncQueue.begin() + count);
+        }
+
+        // Sync each run of adjacent ranges with one DMA
+        for (size_t first = 0; first < batch.size();) {
+            auto bo = batch[first].bo;
+            auto dir = batch[first].dir;
+            auto offset = batch[first].offset;
+            auto end = offset + batch[first].size;
+            size_t last = first + 1;
+            for (; last < batch.size(); ++last) {
+                auto& req = batch[last];
+                if (req.bo != bo || req.dir != dir || req.offset != end)
+                    break;
+                end += req.size;
+            }
+
+            int ret = xclSyncBO(bo, dir, end - offset, offset);
+            for (; first < last; ++first)
+                batch[first].done(batch[first].data, ret);
+        }
+        batch.clear();
+    }
+}
+
+void shim::stopSyncWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lk(mSyncLock);
+        mSyncStop = true;
+    }
+    mSyncReady.notify_all();
+    for (auto& worker : mSyncWorkers)
+        worker.join();
+    mSyncWorkers.clear();
+}
+
 int shim::execbufCopyBO(unsigned int dst_bo_handle,
     unsigned int src_bo_handle, size_t size, size_t dst_offset,
     size_t src_offset)
@@ -1183,14 +1413,10 @@ int shim::cmaEnable(bool enable, uint64_t size)
     int ret = 0;
 
     if (enable) {
-        /* Once set MAP_HUGETLB, we have to specify bit[26~31] as size in log
-         * e.g. We like to get 2M huge page, 2M = 2^21,
-         * 21 = 0x15
-         * Let's find how many 1GB huge page we have to allocate
+        /* The host memory bank is backed by 1GB huge pages, which the
+         * driver pins.  Let's find how many 1GB huge page we need.
          */
         std::string errmsg;
-        uint64_t hugepage_flag = 0x1e;
-        uint64_t page_sz = 1 << 30;
         uint64_t allocated_size = 0;
         uint32_t page_num = size >> 30;
         drm_xocl_alloc_cma_info cma_info = {0};
@@ -1209,16 +1435,11 @@ int shim::cmaEnable(bool enable, uint64_t size)
 
         cma_info.user_addr = (uint64_t *)alloca(sizeof(uint64_t)*page_num);
 
-        for (uint32_t i = 0; i < page_num; ++i) {
-            void *addr_local = mmap(0x0, page_sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | hugepage_flag << MAP_HUGE_SHIFT, 0, 0);
-
-            if (addr_local == MAP_FAILED) {
-                ret = -ENOMEM;
-                break;
-            } else {
-                cma_info.user_addr[i] = (uint64_t)addr_local;
-            }
-        }
+        void *addr = nullptr;
+        uint64_t mapped_size = static_cast<uint64_t>(page_num) << 30;
+        ret = mapHostMem(mapped_size, &addr);
+        for (uint32_t i = 0; i < page_num; ++i)
+            cma_info.user_addr[i] = ret ? 0 : (uint64_t)addr + ((uint64_t)i << 30);
 
         if (!ret) {
             ret = mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_ALLOC_CMA, &cma_info);
@@ -1226,12 +1447,9 @@ int shim::cmaEnable(bool enable, uint64_t size)
                     ret = -errno;
         }
 
-        for (uint32_t i = 0; i < page_num; ++i) {
-            if (!cma_info.user_addr[i])
-                continue;
-
-             munmap((void*)cma_info.user_addr[i], page_sz);
-        }
+        /* The driver holds its own references to the pages */
+        if (addr)
+            munmap(addr, mapped_size);
 
         if (ret) {
             cma_info.entry_num = 0;
@@ -1314,6 +1532,9 @@ int shim::xclLoadXclBin(const xclBin *buffer)
 {
     auto top = reinterpret_cast<const axlf*>(buffer);
     auto ret = xclLoadAxlf(top);
+    if (ret == 0)
+      // Retired CU mappings are of the previous xclbin
+      unmapRetiredCus();
     if (ret != 0) {
       if (ret == -EOPNOTSUPP) {
         xrt_logmsg(XRT_ERROR, "Xclbin does not match shell on card.");
@@ -1351,24 +1572,15 @@ int shim::xclLoadXclBin(const xclBin *buffer)
 }
 
 /*
- * xclLoadAxlf()
+ * prepareAxlf() - Extract driver arguments from xclbin metadata
  */
-int shim::xclLoadAxlf(const axlf *buffer)
+int shim::prepareAxlf(const axlf *buffer, axlf_args& args)
 {
-    xrt_logmsg(XRT_INFO, "%s, buffer: %s", __func__, buffer);
-    drm_xocl_axlf axlf_obj = {const_cast<axlf *>(buffer), 0};
-    unsigned int flags = XOCL_AXLF_BASE;
-    int off = 0;
-
-    auto force_program = xrt_core::config::get_force_program_xclbin(); //default value is false
-    if(force_program) {
-        axlf_obj.flags = flags | XOCL_AXLF_FORCE_PROGRAM;
-    }
-
     auto kernels = xrt_core::xclbin::get_kernels(buffer);
     /* Calculate size of kernels */
+    size_t ksize = 0;
     for (auto& kernel : kernels) {
-        axlf_obj.ksize += sizeof(kernel_info) + sizeof(argument_info) * kernel.args.size();
+        ksize += sizeof(kernel_info) + sizeof(argument_info) * kernel.args.size();
     }
 
     /* To enhance CU subdevice and KDS/ERT, driver needs all details about kernels
@@ -1402,10 +1614,10 @@ int shim::xclLoadAxlf(const axlf *buffer)
      * |   ...                 |
      * +-----------------------+
      */
-    std::vector<char> krnl_binary(axlf_obj.ksize);
-    axlf_obj.kernels = krnl_binary.data();
+    int off = 0;
+    args.kernels.resize(ksize);
     for (auto& kernel : kernels) {
-        auto krnl = reinterpret_cast<kernel_info *>(axlf_obj.kernels + off);
+        auto krnl = reinterpret_cast<kernel_info *>(args.kernels.data() + off);
         if (kernel.name.size() > sizeof(krnl->name))
             return -EINVAL;
         std::strncpy(krnl->name, kernel.name.c_str(), sizeof(krnl->name)-1);
@@ -1438,26 +1650,107 @@ int shim::xclLoadAxlf(const axlf *buffer)
     }
 
     /* To make download xclbin and configure KDS/ERT as an atomic operation. */
-    axlf_obj.kds_cfg.ert = xrt_core::config::get_ert();
-    axlf_obj.kds_cfg.polling = xrt_core::config::get_ert_polling();
-    axlf_obj.kds_cfg.cu_dma = xrt_core::config::get_ert_cudma();
-    axlf_obj.kds_cfg.cu_isr = xrt_core::config::get_ert_cuisr() && xrt_core::xclbin::get_cuisr(buffer);
-    axlf_obj.kds_cfg.cq_int = xrt_core::config::get_ert_cqint();
-    axlf_obj.kds_cfg.dataflow = xrt_core::config::get_feature_toggle("Runtime.dataflow") || xrt_core::xclbin::get_dataflow(buffer);
-    axlf_obj.kds_cfg.rw_shared = xrt_core::config::get_rw_shared();
+    args.kds_cfg.ert = xrt_core::config::get_ert();
+    args.kds_cfg.polling = xrt_core::config::get_ert_polling();
+    args.kds_cfg.cu_dma = xrt_core::config::get_ert_cudma();
+    args.kds_cfg.cu_isr = xrt_core::config::get_ert_cuisr() && xrt_core::xclbin::get_cuisr(buffer);
+    args.kds_cfg.cq_int = xrt_core::config::get_ert_cqint();
+    args.kds_cfg.dataflow = xrt_core::config::get_feature_toggle("Runtime.dataflow") || xrt_core::xclbin::get_dataflow(buffer);
+    args.kds_cfg.rw_shared = xrt_core::config::get_rw_shared();
+    // Out of range values are clamped to the width of the fields
+    args.kds_cfg.moderate_cnt = std::min(xrt_core::config::get_ert_moderate_count(), 0xffu);
+    args.kds_cfg.moderate_us = std::min(xrt_core::config::get_ert_moderate_us(), 0xffffu);
 
     /* TODO: In scheduler.cpp init() function, it use get_ert_slots(void) to get slot size.
      * But we cannot do this here, since the xclbin is not registered.
      * Currently, emulation flow use get_ert_slots() as well.
      * We will consider how to better determine slot size in new kds.
      */
-    //axlf_obj.kds_cfg.slot_size = mCoreDevice->get_ert_slots().second;
+    //args.kds_cfg.slot_size = mCoreDevice->get_ert_slots().second;
     auto xml_hdr = xrt_core::xclbin::get_axlf_section(buffer, EMBEDDED_METADATA);
     if (!xml_hdr)
         throw std::runtime_error("No xml metadata in xclbin");
     auto xml_size = xml_hdr->m_sectionSize;
     auto xml_data = reinterpret_cast<const char*>(reinterpret_cast<const char*>(buffer) + xml_hdr->m_sectionOffset);
-    axlf_obj.kds_cfg.slot_size = mCoreDevice->get_ert_slots(xml_data, xml_size).second;
+    args.kds_cfg.slot_size = mCoreDevice->get_ert_slots(xml_data, xml_size).second;
+
+    return 0;
+}
+
+/*
+ * xclStageXclBin()
+ */
+int shim::xclStageXclBin(const axlf *buffer)
+{
+    axlf_args args;
+    if (auto ret = prepareAxlf(buffer, args))
+        return ret;
+    args.header = *buffer;
+
+    drm_xocl_axlf axlf_obj = {const_cast<axlf *>(buffer), 0};
+    axlf_obj.flags = XOCL_AXLF_STAGE;
+    if (mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_READ_AXLF, &axlf_obj))
+        return -errno;
+
+    std::string key(reinterpret_cast<const char*>(buffer->m_header.uuid), sizeof(xuid_t));
+    std::lock_guard<std::mutex> lk(mStageLock);
+    mStagedAxlf[key] = std::move(args);
+    return 0;
+}
+
+/*
+ * xclUnstageXclBin()
+ */
+int shim::xclUnstageXclBin(const xuid_t xclbinId)
+{
+    std::string key(reinterpret_cast<const char*>(xclbinId), sizeof(xuid_t));
+    std::lock_guard<std::mutex> lk(mStageLock);
+    auto itr = mStagedAxlf.find(key);
+    if (itr == mStagedAxlf.end())
+        return -ENOENT;
+
+    drm_xocl_axlf axlf_obj = {&itr->second.header, 0};
+    axlf_obj.flags = XOCL_AXLF_UNSTAGE;
+    int ret = mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_READ_AXLF, &axlf_obj) ? -errno : 0;
+    mStagedAxlf.erase(itr);
+    return ret;
+}
+
+/*
+ * xclLoadAxlf()
+ */
+int shim::xclLoadAxlf(const axlf *buffer)
+{
+    xrt_logmsg(XRT_INFO, "%s, buffer: %s", __func__, buffer);
+    drm_xocl_axlf axlf_obj = {const_cast<axlf *>(buffer), 0};
+    unsigned int flags = XOCL_AXLF_BASE;
+
+    auto force_program = xrt_core::config::get_force_program_xclbin(); //default value is false
+    if(force_program) {
+        flags |= XOCL_AXLF_FORCE_PROGRAM;
+    }
+
+    // A staged xclbin reuses its arguments, the driver falls back to
+    // copying the xclbin if it no longer has it staged
+    axlf_args args;
+    {
+        std::string key(reinterpret_cast<const char*>(buffer->m_header.uuid), sizeof(xuid_t));
+        std::lock_guard<std::mutex> lk(mStageLock);
+        auto itr = mStagedAxlf.find(key);
+        if (itr != mStagedAxlf.end()) {
+            args = itr->second;
+            flags |= XOCL_AXLF_STAGED;
+        }
+    }
+    if (!(flags & XOCL_AXLF_STAGED)) {
+        if (auto ret = prepareAxlf(buffer, args))
+            return ret;
+    }
+
+    axlf_obj.ksize = args.kernels.size();
+    axlf_obj.kernels = args.kernels.data();
+    axlf_obj.kds_cfg = args.kds_cfg;
+    axlf_obj.flags = flags;
 
     int ret = mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_READ_AXLF, &axlf_obj);
     if (ret && errno == EAGAIN) {
@@ -1707,6 +2000,66 @@ int shim::xclExecBuf(unsigned int cmdBO)
     return ret ? -errno : ret;
 }
 
+/*
+ * xclExecBufAt()
+ */
+int shim::xclExecBufAt(unsigned int cmdBO, size_t offset)
+{
+    int ret;
+    xrt_logmsg(XRT_INFO, "%s, cmdBO: %d, offset: %zu", __func__, cmdBO, offset);
+    if (offset > std::numeric_limits<uint32_t>::max())
+        return -EINVAL;
+    drm_xocl_execbuf exec = {0, cmdBO, {0}, static_cast<uint32_t>(offset), 0};
+    ret = mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_EXECBUF, &exec);
+    return ret ? -errno : ret;
+}
+
+/*
+ * xclExecBufBatch()
+ *
+ * Submit up to DRM_XOCL_EXECBUF_VEC_MAX commands per ioctl.  Falls back
+ * to one ioctl per command with a driver that does not support the
+ * vectored ioctl, which fails with EINVAL before submitting anything.
+ */
+int shim::xclExecBufBatch(const unsigned int* cmdBOs, const size_t* offsets, size_t count)
+{
+    xrt_logmsg(XRT_INFO, "%s, count: %zu", __func__, count);
+    std::vector<drm_xocl_execbuf> execbufs;
+    size_t idx = 0;
+    while (idx < count && mExecBufVec) {
+        auto num = std::min<size_t>(count - idx, DRM_XOCL_EXECBUF_VEC_MAX);
+        execbufs.assign(num, drm_xocl_execbuf{});
+        for (size_t i = 0; i < num; ++i) {
+            auto offset = offsets ? offsets[idx + i] : 0;
+            if (offset > std::numeric_limits<uint32_t>::max())
+                return -EINVAL;
+            execbufs[i].exec_bo_handle = cmdBOs[idx + i];
+            execbufs[i].exec_bo_offset = static_cast<uint32_t>(offset);
+        }
+
+        drm_xocl_execbuf_vec vec = {0, static_cast<uint32_t>(num), reinterpret_cast<uint64_t>(execbufs.data()), 0, 0};
+        if (!mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_EXECBUF_VEC, &vec)) {
+            idx += num;
+            continue;
+        }
+        if (errno != EINVAL || vec.submitted)
+            return -errno;
+
+        // Either the first command is invalid or the driver is old,
+        // the single command ioctl tells which
+        if (auto ret = xclExecBufAt(cmdBOs[idx], offsets ? offsets[idx] : 0))
+            return ret;
+        mExecBufVec = false;
+        ++idx;
+    }
+
+    for (; idx < count; ++idx) {
+        if (auto ret = xclExecBufAt(cmdBOs[idx], offsets ? offsets[idx] : 0))
+            return ret;
+    }
+    return 0;
+}
+
 /*
  * xclExecBuf()
  */
@@ -1760,15 +2113,7 @@ int shim::xclOpenContext(const uuid_t xclbinId, unsigned int ipIndex, bool share
 int shim::xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex)
 {
     std::lock_guard<std::mutex> l(mCuMapLock);
-
-    if (ipIndex < mCuMaps.size()) {
-	    // Make sure no MMIO register space access when CU is released.
-	    uint32_t *p = mCuMaps[ipIndex].first;
-	    if (p) {
-		(void) munmap(p, mCuMaps[ipIndex].second);
-		mCuMaps[ipIndex] = std::make_pair<uint32_t*, uint32_t>(nullptr, 0);
-	    }
-    }
+    retireCuMap(ipIndex);
 
     drm_xocl_ctx ctx = {XOCL_CTX_OP_FREE_CTX};
     std::memcpy(ctx.xclbin_id, xclbinId, sizeof(uuid_t));
@@ -1777,6 +2122,90 @@ int shim::xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex)
     return ret ? -errno : ret;
 }
 
+/*
+ * xclOpenContextBatch()
+ *
+ * Open up to DRM_XOCL_CTX_VEC_MAX contexts per ioctl.  Either all
+ * contexts are opened or none.  Falls back to one ioctl per context
+ * with a driver that does not support the vectored ioctl.
+ */
+int shim::xclOpenContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count, bool shared)
+{
+    unsigned int flags = shared ? XOCL_CTX_SHARED : XOCL_CTX_EXCLUSIVE;
+    size_t idx = 0;
+    bool fallback = false;
+    while (idx < count && mCtxVec) {
+        auto num = std::min<size_t>(count - idx, DRM_XOCL_CTX_VEC_MAX);
+        drm_xocl_ctx_vec vec = {XOCL_CTX_OP_ALLOC_CTX};
+        std::memcpy(vec.xclbin_id, xclbinId, sizeof(uuid_t));
+        vec.flags = flags;
+        vec.count = static_cast<uint32_t>(num);
+        vec.cu_indices = reinterpret_cast<uint64_t>(ipIndices + idx);
+        if (!mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_CTX_VEC, &vec)) {
+            idx += num;
+            continue;
+        }
+        auto err = errno;
+        if (err != EINVAL) {
+            (void) xclCloseContextBatch(xclbinId, ipIndices, idx);
+            return -err;
+        }
+
+        // Either an index is invalid or the driver is old, the single
+        // context ioctl tells which
+        fallback = true;
+        break;
+    }
+
+    for (size_t i = idx; i < count; ++i) {
+        if (auto ret = xclOpenContext(xclbinId, ipIndices[i], shared)) {
+            (void) xclCloseContextBatch(xclbinId, ipIndices, i);
+            return ret;
+        }
+    }
+
+    if (fallback)
+        mCtxVec = false;
+    return 0;
+}
+
+/*
+ * xclCloseContextBatch()
+ */
+int shim::xclCloseContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count)
+{
+    std::lock_guard<std::mutex> l(mCuMapLock);
+    for (size_t i = 0; i < count; ++i)
+        retireCuMap(ipIndices[i]);
+
+    size_t idx = 0;
+    while (idx < count && mCtxVec) {
+        auto num = std::min<size_t>(count - idx, DRM_XOCL_CTX_VEC_MAX);
+        drm_xocl_ctx_vec vec = {XOCL_CTX_OP_FREE_CTX};
+        std::memcpy(vec.xclbin_id, xclbinId, sizeof(uuid_t));
+        vec.count = static_cast<uint32_t>(num);
+        vec.cu_indices = reinterpret_cast<uint64_t>(ipIndices + idx);
+        if (mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_CTX_VEC, &vec)) {
+            if (errno != EINVAL)
+                return -errno;
+            // Continue with the contexts that are not closed
+            idx += vec.done;
+            break;
+        }
+        idx += num;
+    }
+
+    int ret = 0;
+    for (; idx < count; ++idx) {
+        drm_xocl_ctx ctx = {XOCL_CTX_OP_FREE_CTX};
+        std::memcpy(ctx.xclbin_id, xclbinId, sizeof(uuid_t));
+        ctx.cu_index = ipIndices[idx];
+        if (mDev->ioctl(mUserHandle, DRM_IOCTL_XOCL_CTX, &ctx) && !ret)
+            ret = -errno;
+    }
+    return ret;
+}
+
 /*
  * xclBootFPGA()
  */
@@ -2199,53 +2628,154 @@ int shim::xclGetDebugProfileDeviceInfo(xclDebugProfileDeviceInfo* info)
   return 0;
 }
 
-int shim::xclRegRW(bool rd, uint32_t ipIndex, uint32_t offset, uint32_t *datap)
+// Map CU register space and publish the mapping, called when the
+// mapping is not published.
+uint32_t* shim::mapCu(uint32_t ipIndex)
 {
   std::lock_guard<std::mutex> lk(mCuMapLock);
+  auto& cumap = mCuMaps[ipIndex];
+  if (auto p = cumap.base.load())
+    return p;
+
+  if (cumap.retired) {
+    cumap.size = cumap.retired_size;
+    cumap.base = cumap.retired;
+    cumap.retired = nullptr;
+    return cumap.base;
+  }
 
-  if (ipIndex >= mCuMaps.size()) {
-    xrt_logmsg(XRT_ERROR, "%s: invalid CU index: %d", __func__, ipIndex);
-    return -EINVAL;
+  auto cu_subdev = "CU[" + std::to_string(ipIndex) + "]";
+  uint32_t size = 0;
+  std::string errmsg;
+  mDev->sysfs_get<uint32_t>(cu_subdev, "size", errmsg, size, 0);
+  if (size <= 0) {
+    xrt_logmsg(XRT_ERROR, "%s: incorrect cu size %d", __func__, size);
+    return nullptr;
   }
 
-  auto& cumap = mCuMaps[ipIndex];  // {base, size}
+  void *p = mDev->mmap(mUserHandle, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, static_cast<off_t>(ipIndex + 1) * getpagesize());
+  if (p == MAP_FAILED)
+    return nullptr;
 
-  if (cumap.first == nullptr) {
-    auto cu_subdev = "CU[" + std::to_string(ipIndex) + "]";
-    uint32_t size = 0;
-    std::string errmsg;
-    mDev->sysfs_get<uint32_t>(cu_subdev, "size", errmsg, size, 0);
-    if (size <= 0) {
-      xrt_logmsg(XRT_ERROR, "%s: incorrect cu size %d", __func__, size);
-      return -EINVAL;
-    }
+  cumap.size = size;
+  cumap.base = static_cast<uint32_t*>(p);
+  return cumap.base;
+}
 
-    void *p = mDev->mmap(mUserHandle, size, PROT_READ | PROT_WRITE,
-                         MAP_SHARED, static_cast<off_t>(ipIndex + 1) * getpagesize());
-    if (p != MAP_FAILED) {
-      cumap.first = static_cast<uint32_t*>(p);
-      cumap.second = size;
+// Make sure no new MMIO register space access when CU is released.
+// The mapping is retired rather than unmapped, an access racing with
+// the close may still be using it.  Called with mCuMapLock held.
+void shim::retireCuMap(unsigned int ipIndex)
+{
+  if (ipIndex >= mCuMaps.size())
+    return;
+
+  auto& cumap = mCuMaps[ipIndex];
+  if (auto p = cumap.base.exchange(nullptr)) {
+    cumap.retired = p;
+    cumap.retired_size = cumap.size;
+  }
+}
+
+// Unmap CU register space retired by xclCloseContext.  Called when
+// no CU context can be open, so no accessor can use the mapping.
+void shim::unmapRetiredCus()
+{
+  std::lock_guard<std::mutex> lk(mCuMapLock);
+  for (auto& cumap : mCuMaps) {
+    if (cumap.retired) {
+      (void) munmap(cumap.retired, cumap.retired_size);
+      cumap.retired = nullptr;
     }
   }
+}
+
+int shim::xclRegRW(bool rd, uint32_t ipIndex, uint32_t offset, uint32_t *datap)
+{
+  if (ipIndex >= mCuMaps.size()) {
+    xrt_logmsg(XRT_ERROR, "%s: invalid CU index: %d", __func__, ipIndex);
+    return -EINVAL;
+  }
 
-  if (cumap.first == nullptr) {
+  auto& cumap = mCuMaps[ipIndex];
+  auto base = cumap.base.load(std::memory_order_acquire);
+  if (base == nullptr)
+    base = mapCu(ipIndex);
+
+  if (base == nullptr) {
     xrt_logmsg(XRT_ERROR, "%s: can't map CU: %d", __func__, ipIndex);
     return -EINVAL;
   }
 
-  if (offset >= cumap.second || (offset & (sizeof(uint32_t) - 1)) != 0) {
+  if (offset >= cumap.size.load(std::memory_order_relaxed) || (offset & (sizeof(uint32_t) - 1)) != 0) {
     xrt_logmsg(XRT_ERROR, "%s: invalid CU offset: %d", __func__, offset);
     return -EINVAL;
   }
 
   if (rd)
-    *datap = (cumap.first)[offset / sizeof(uint32_t)];
+    *datap = base[offset / sizeof(uint32_t)];
   else
-    (cumap.first)[offset / sizeof(uint32_t)] = *datap;
+    base[offset / sizeof(uint32_t)] = *datap;
 
   return 0;
 }
 
+int shim::xclRegWindow(uint32_t ipIndex, uint32_t **base, uint32_t *size)
+{
+  if (ipIndex >= mCuMaps.size())
+    return -EINVAL;
+
+  auto p = mCuMaps[ipIndex].base.load(std::memory_order_acquire);
+  if (p == nullptr)
+    p = mapCu(ipIndex);
+  if (p == nullptr)
+    return -EINVAL;
+
+  *base = p;
+  *size = mCuMaps[ipIndex].size;
+  return 0;
+}
+
+// Map the descriptor slots of a user managed fast adapter CU.  The
+// driver maps the slots at page offset past the CU register spaces.
+int shim::xclMapFaDesc(uint32_t ipIndex, uint32_t **base, uint64_t *devAddr,
+                       uint32_t *slotSize, uint32_t *numSlots)
+{
+  if (ipIndex >= mCuMaps.size())
+    return -EINVAL;
+
+  auto cu_subdev = "CU[" + std::to_string(ipIndex) + "]";
+  std::string errmsg;
+  std::string desc;
+  mDev->sysfs_get(cu_subdev, "fa_desc", errmsg, desc);
+  if (!errmsg.empty())
+    return -ENOTSUP;
+
+  unsigned long long dev_addr = 0;
+  unsigned int slot_size = 0;
+  unsigned int num_slots = 0;
+  if (std::sscanf(desc.c_str(), "%llx %u %u", &dev_addr, &slot_size, &num_slots) != 3 || !num_slots)
+    return -ENOTSUP;
+
+  size_t size = static_cast<size_t>(slot_size) * num_slots;
+  void *p = mDev->mmap(mUserHandle, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       static_cast<off_t>(mCuMaps.size() + ipIndex + 1) * getpagesize());
+  if (p == MAP_FAILED)
+    return -errno;
+
+  *base = static_cast<uint32_t*>(p);
+  *devAddr = dev_addr;
+  *slotSize = slot_size;
+  *numSlots = num_slots;
+  return 0;
+}
+
+int shim::xclUnmapFaDesc(uint32_t *base, size_t size)
+{
+  return munmap(base, size) ? -errno : 0;
+}
+
 int shim::xclRegRead(uint32_t ipIndex, uint32_t offset, uint32_t *datap)
 {
     return xclRegRW(true, ipIndex, offset, datap);
@@ -2498,6 +3028,44 @@ int xclRegWrite(xclDeviceHandle handle, uint32_t ipIndex, uint32_t offset, uint3
   }) ;
 }
 
+int xclRegWindow(xclDeviceHandle handle, uint32_t ipIndex, uint32_t **base, uint32_t *size)
+{
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclRegWindow(ipIndex, base, size) : -ENODEV;
+}
+
+int xclMapFaDesc(xclDeviceHandle handle, uint32_t ipIndex, uint32_t **base, uint64_t *devAddr,
+                 uint32_t *slotSize, uint32_t *numSlots)
+{
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclMapFaDesc(ipIndex, base, devAddr, slotSize, numSlots) : -ENODEV;
+}
+
+int xclUnmapFaDesc(xclDeviceHandle handle, uint32_t *base, size_t size)
+{
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclUnmapFaDesc(base, size) : -ENODEV;
+}
+
+int xclStageXclBin(xclDeviceHandle handle, const struct axlf *buffer)
+{
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclStageXclBin(buffer) : -ENODEV;
+}
+
+int xclUnstageXclBin(xclDeviceHandle handle, const xuid_t xclbinId)
+{
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclUnstageXclBin(xclbinId) : -ENODEV;
+}
+
+int xclSyncBOSubmit(xclDeviceHandle handle, unsigned int boHandle, xclBOSyncDirection dir,
+                    size_t size, size_t offset, void (*done)(void*, int), void* data)
+{
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclSyncBOSubmit(boHandle, dir, size, offset, done, data) : -ENODEV;
+}
+
 int xclRegRead(xclDeviceHandle handle, uint32_t ipIndex, uint32_t offset, uint32_t *datap)
 {
   return xdp::hal::profiling_wrapper("xclRegRead",
@@ -2562,7 +3130,7 @@ void xclFreeBO(xclDeviceHandle handle, unsigned int boHandle) {
 
 size_t xclWriteBO(xclDeviceHandle handle, unsigned int boHandle, const void *src, size_t size, size_t seek)
 {
-  return xdp::hal::buffer_transfer_profiling_wrapper("xclWriteBO", size, true,
+  return xdp::hal::buffer_transfer_profiling_wrapper("xclWriteBO", handle, size, true,
   [handle, boHandle, src, size, seek] {
     xocl::shim *drv = xocl::shim::handleCheck(handle);
     return drv ? drv->xclWriteBO(boHandle, src, size, seek) : -ENODEV;
@@ -2571,7 +3139,7 @@ size_t xclWriteBO(xclDeviceHandle handle, unsigned int boHandle, const void *src
 
 size_t xclReadBO(xclDeviceHandle handle, unsigned int boHandle, void *dst, size_t size, size_t skip)
 {
-  return xdp::hal::buffer_transfer_profiling_wrapper("xclReadBO", size, false,
+  return xdp::hal::buffer_transfer_profiling_wrapper("xclReadBO", handle, size, false,
   [handle, boHandle, dst, size, skip] {
     xocl::shim *drv = xocl::shim::handleCheck(handle);
     return drv ? drv->xclReadBO(boHandle, dst, size, skip) : -ENODEV;
@@ -2595,7 +3163,7 @@ int xclUnmapBO(xclDeviceHandle handle, unsigned int boHandle, void* addr)
 
 int xclSyncBO(xclDeviceHandle handle, unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset)
 {
-  return xdp::hal::buffer_transfer_profiling_wrapper("xclSyncBO", size,
+  return xdp::hal::buffer_transfer_profiling_wrapper("xclSyncBO", handle, size,
                                               (dir == XCL_BO_SYNC_BO_TO_DEVICE),
   [handle, boHandle, dir, size, offset] {
 
@@ -2608,11 +3176,21 @@ int xclSyncBO(xclDeviceHandle handle, unsigned int boHandle, xclBOSyncDirection
    }) ;
 }
 
+int xclSyncBOBatch(xclDeviceHandle handle, const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+                   const size_t* sizes, const size_t* offsets, size_t count)
+{
+  return xdp::hal::profiling_wrapper("xclSyncBOBatch",
+  [handle, boHandles, dirs, sizes, offsets, count] {
+    xocl::shim *drv = xocl::shim::handleCheck(handle);
+    return drv ? drv->xclSyncBOBatch(boHandles, dirs, sizes, offsets, count) : -ENODEV;
+  }) ;
+}
+
 int xclCopyBO(xclDeviceHandle handle, unsigned int dst_boHandle,
             unsigned int src_boHandle, size_t size, size_t dst_offset, size_t src_offset)
 {
 
-  return xdp::hal::profiling_wrapper("xclCopyBO",
+  return xdp::hal::buffer_copy_profiling_wrapper("xclCopyBO", handle, size,
   [handle, dst_boHandle, src_boHandle, size, dst_offset, src_offset] {
     xocl::shim *drv = xocl::shim::handleCheck(handle);
     return drv ?
@@ -2753,6 +3331,24 @@ int xclExecBuf(xclDeviceHandle handle, unsigned int cmdBO)
   }) ;
 }
 
+int xclExecBufAt(xclDeviceHandle handle, unsigned int cmdBO, size_t offset)
+{
+  return xdp::hal::profiling_wrapper("xclExecBuf",
+  [handle, cmdBO, offset] {
+    xocl::shim *drv = xocl::shim::handleCheck(handle);
+    return drv ? drv->xclExecBufAt(cmdBO, offset) : -ENODEV;
+  }) ;
+}
+
+int xclExecBufBatch(xclDeviceHandle handle, const xclBufferHandle* cmdBOs, const size_t* offsets, size_t count)
+{
+  return xdp::hal::profiling_wrapper("xclExecBuf",
+  [handle, cmdBOs, offsets, count] {
+    xocl::shim *drv = xocl::shim::handleCheck(handle);
+    return drv ? drv->xclExecBufBatch(cmdBOs, offsets, count) : -ENODEV;
+  }) ;
+}
+
 int xclExecBufWithWaitList(xclDeviceHandle handle, unsigned int cmdBO, size_t num_bo_in_wait_list, unsigned int *bo_wait_list)
 {
     xocl::shim *drv = xocl::shim::handleCheck(handle);
@@ -2802,6 +3398,36 @@ int xclCloseContext(xclDeviceHandle handle, const uuid_t xclbinId, unsigned ipIn
   });
 }
 
+int xclOpenContextBatch(xclDeviceHandle handle, const uuid_t xclbinId, const unsigned int* ipIndices,
+                        size_t count, bool shared)
+{
+  return xdp::hal::profiling_wrapper("xclOpenContext",
+  [handle, xclbinId, ipIndices, count, shared] {
+
+#ifdef DISABLE_DOWNLOAD_XCLBIN
+  return 0;
+#endif
+
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclOpenContextBatch(xclbinId, ipIndices, count, shared) : -ENODEV;
+  }) ;
+}
+
+int xclCloseContextBatch(xclDeviceHandle handle, const uuid_t xclbinId, const unsigned int* ipIndices,
+                         size_t count)
+{
+  return xdp::hal::profiling_wrapper("xclCloseContext",
+  [handle, xclbinId, ipIndices, count] {
+
+#ifdef DISABLE_DOWNLOAD_XCLBIN
+  return 0;
+#endif
+
+  xocl::shim *drv = xocl::shim::handleCheck(handle);
+  return drv ? drv->xclCloseContextBatch(xclbinId, ipIndices, count) : -ENODEV;
+  });
+}
+
 const axlf_section_header* wrap_get_axlf_section(const axlf* top, axlf_section_kind kind)
 {
     return xclbin::get_axlf_section(top, kind);
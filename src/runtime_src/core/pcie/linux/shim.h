@@ -34,13 +34,18 @@
 #include <linux/aio_abi.h>
 #include <libdrm/drm.h>
 
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <fstream>
 #include <list>
 #include <map>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
 #include <vector>
 #include <memory>
+#include <thread>
 
 // Forward declaration
 namespace xrt_core {
@@ -65,6 +70,10 @@ public:
     // Restricted read/write on IP register space
     int xclRegWrite(uint32_t ipIndex, uint32_t offset, uint32_t data);
     int xclRegRead(uint32_t ipIndex, uint32_t offset, uint32_t *datap);
+    int xclRegWindow(uint32_t ipIndex, uint32_t **base, uint32_t *size);
+    int xclMapFaDesc(uint32_t ipIndex, uint32_t **base, uint64_t *devAddr,
+                     uint32_t *slotSize, uint32_t *numSlots);
+    int xclUnmapFaDesc(uint32_t *base, size_t size);
 
     unsigned int xclAllocBO(size_t size, int unused, unsigned flags);
     unsigned int xclAllocUserPtrBO(void *userptr, size_t size, unsigned flags);
@@ -74,6 +83,10 @@ public:
     void *xclMapBO(unsigned int boHandle, bool write);
     int xclUnmapBO(unsigned int boHandle, void* addr);
     int xclSyncBO(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset);
+    int xclSyncBOSubmit(unsigned int boHandle, xclBOSyncDirection dir, size_t size, size_t offset,
+                        void (*done)(void*, int), void* data);
+    int xclSyncBOBatch(const unsigned int* boHandles, const xclBOSyncDirection* dirs,
+                       const size_t* sizes, const size_t* offsets, size_t count);
     int xclCopyBO(unsigned int dst_boHandle, unsigned int src_boHandle, size_t size,
                   size_t dst_offset, size_t src_offset);
 
@@ -85,6 +98,8 @@ public:
 
     // Bitstream/bin download
     int xclLoadXclBin(const xclBin *buffer);
+    int xclStageXclBin(const axlf *buffer);
+    int xclUnstageXclBin(const xuid_t xclbinId);
     int xclGetErrorStatus(xclErrorStatus *info);
     int xclGetDeviceInfo2(xclDeviceInfo2 *info);
     bool isGood() const;
@@ -92,6 +107,7 @@ public:
     int resetDevice(xclResetKind kind);
     int p2pEnable(bool enable, bool force);
     int cmaEnable(bool enable, uint64_t size);
+    int mapHostMem(uint64_t size, void **addr);
     bool xclLockDevice();
     bool xclUnlockDevice();
     int xclReClock2(unsigned short region, const unsigned short *targetFreqMHz);
@@ -140,11 +156,15 @@ public:
 
     // Execute and interrupt abstraction
     int xclExecBuf(unsigned int cmdBO);
+    int xclExecBufAt(unsigned int cmdBO, size_t offset);
+    int xclExecBufBatch(const unsigned int* cmdBOs, const size_t* offsets, size_t count);
     int xclExecBuf(unsigned int cmdBO,size_t numdeps, unsigned int* bo_wait_list);
     int xclRegisterEventNotify(unsigned int userInterrupt, int fd);
     int xclExecWait(int timeoutMilliSec);
     int xclOpenContext(const uuid_t xclbinId, unsigned int ipIndex, bool shared) const;
     int xclCloseContext(const uuid_t xclbinId, unsigned int ipIndex);
+    int xclOpenContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count, bool shared);
+    int xclCloseContextBatch(const uuid_t xclbinId, const unsigned int* ipIndices, size_t count);
 
     int getBoardNumber( void ) { return mBoardNumber; }
 
@@ -182,10 +202,60 @@ private:
 
     /*
      * Mapped CU register space for xclRegRead/Write(). We support at most
-     * 128 CUs and each CU map is a pair <address, size>.
+     * 128 CUs.  A CU is mapped once under mCuMapLock and the mapping is
+     * published in base, so register access reads base without locking.
+     * When the CU context is closed the mapping is unpublished but kept
+     * in retired since concurrent accessors may still use it; a retired
+     * mapping is republished if the CU is opened again, and unmapped
+     * when a new xclbin is loaded or the device is closed.
      */
-    std::vector<std::pair<uint32_t*, uint32_t>> mCuMaps;
+    struct cu_map
+    {
+        std::atomic<uint32_t*> base {nullptr};
+        std::atomic<uint32_t> size {0};
+        uint32_t* retired = nullptr;
+        uint32_t retired_size = 0;
+    };
+    std::array<cu_map, 128> mCuMaps;
     std::mutex mCuMapLock;
+    uint32_t* mapCu(uint32_t ipIndex);
+    void retireCuMap(unsigned int ipIndex);
+    void unmapRetiredCus();
+
+    /*
+     * Syncs submitted with xclSyncBOSubmit() are queued and executed
+     * by one worker per DMA channel, so any number of syncs can be
+     * outstanding without a thread each.  A worker drains up to a
+     * batch of queued syncs at a time and merges consecutive syncs of
+     * adjacent ranges of a BO in the same direction into one DMA.
+     * The workers are started by the first submission and complete
+     * all queued syncs before the device is closed.
+     */
+    struct sync_request
+    {
+        unsigned int bo;
+        xclBOSyncDirection dir;
+        size_t size;
+        size_t offset;
+        void (*done)(void*, int);
+        void* data;
+    };
+    std::deque<sync_request> mSyncQueue;
+    std::vector<std::thread> mSyncWorkers;
+    std::mutex mSyncLock;
+    std::condition_variable mSyncReady;
+    bool mSyncStop = false;
+    void syncWorker();
+    void stopSyncWorkers();
+
+    // Cleared when the driver does not support DRM_IOCTL_XOCL_EXECBUF_VEC
+    bool mExecBufVec = true;
+
+    // Cleared when the driver does not support DRM_IOCTL_XOCL_CTX_VEC
+    bool mCtxVec = true;
+
+    // Cleared when the driver does not support DRM_IOCTL_XOCL_SYNC_BO_VEC
+    bool mSyncBOVec = true;
 
     bool zeroOutDDR();
     bool isXPR() const {
@@ -195,6 +265,25 @@ private:
     int dev_init();
     void dev_fini();
 
+    /*
+     * Driver arguments for loading an xclbin, kernel descriptors and
+     * KDS configuration extracted from the xclbin metadata.  The
+     * arguments of xclbins staged with xclStageXclBin() are kept by
+     * uuid, so switching to a staged xclbin does not parse its
+     * metadata again and the driver programs its staged copy of the
+     * xclbin.  The header of a staged xclbin identifies it when it is
+     * unstaged.
+     */
+    struct axlf_args
+    {
+        std::vector<char> kernels;
+        drm_xocl_kds kds_cfg {};
+        axlf header {};
+    };
+    std::map<std::string, axlf_args> mStagedAxlf;
+    std::mutex mStageLock;
+    int prepareAxlf(const axlf *buffer, axlf_args& args);
+
     int xclLoadAxlf(const axlf *buffer);
     void xclSysfsGetDeviceInfo(xclDeviceInfo2 *info);
     void xclSysfsGetUsageInfo(drm_xocl_usage_stat& stat);
@@ -19,6 +19,7 @@
 #include <type_traits>
 #include <string>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <iostream>
 
@@ -1650,4 +1651,24 @@ void
 device_windows::
 xclmgmt_load_xclbin(const char* buffer) const {}
 
+bool
+device_windows::
+submit_sync_bo(xclBufferHandle bo, xclBOSyncDirection dir, size_t size, size_t offset,
+               std::function<void(int)> done)
+{
+  using done_fcn = std::function<void(int)>;
+  auto data = std::make_unique<done_fcn>(std::move(done));
+  auto complete = [](void* data, int err) {
+    std::unique_ptr<done_fcn> done(static_cast<done_fcn*>(data));
+    (*done)(err);
+  };
+  auto ret = xclSyncBOSubmit(get_device_handle(), bo, dir, size, offset, complete, data.get());
+  if (ret == ENOSYS)
+    return false;
+  if (ret)
+    throw system_error(ret, "unable to submit BO sync");
+  data.release();
+  return true;
+}
+
 } // xrt_core
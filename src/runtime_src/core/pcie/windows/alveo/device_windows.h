@@ -42,6 +42,10 @@ public:
   virtual void reset(const char*, const char*, const char*) const;
   virtual void xclmgmt_load_xclbin(const char* buffer) const;
 
+  virtual bool
+  submit_sync_bo(xclBufferHandle bo, xclBOSyncDirection dir, size_t size, size_t offset,
+                 std::function<void(int)> done) override;
+
 private:
   // Private look up function for concrete query::request
   virtual const query::request&
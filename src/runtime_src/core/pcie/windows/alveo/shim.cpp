@@ -39,18 +39,60 @@
 
 #include "core/pcie/driver/windows/alveo/include/XoclUser_INTF.h"
 
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
 #include <cstdio>
 #include <ctime>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <regex>
+#include <thread>
 
 #pragma warning(disable : 4100 4996)
 #pragma comment (lib, "Setupapi.lib")
 
 namespace { // private implementation details
 
+// BO handles are opened for overlapped I/O so that syncs can be
+// submitted without waiting.  Synchronous requests on a BO handle
+// wait for completion on a per thread event.  The low bit of the
+// event handle keeps the completion out of the completion port.
+static BOOL
+bo_ioctl(HANDLE handle, DWORD code, void* in, DWORD in_size,
+         void* out, DWORD out_size, DWORD* bytes)
+{
+  struct event
+  {
+    HANDLE handle = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    ~event() { if (handle) CloseHandle(handle); }
+  };
+  static thread_local event ev;
+  if (!ev.handle)
+    return FALSE;
+
+  OVERLAPPED overlapped = { 0 };
+  overlapped.hEvent = reinterpret_cast<HANDLE>(reinterpret_cast<uintptr_t>(ev.handle) | 1);
+  if (DeviceIoControl(handle, code, in, in_size, out, out_size, bytes, &overlapped))
+    return TRUE;
+
+  if (GetLastError() != ERROR_IO_PENDING)
+    return FALSE;
+
+  return GetOverlappedResult(handle, &overlapped, bytes, TRUE);
+}
+
+// An asynchronous sync in flight.  The completion port returns the
+// OVERLAPPED, which must stay valid until the sync completes.
+struct sync_request
+{
+  OVERLAPPED overlapped;
+  XOCL_SYNC_BO_ARGS args;
+  void (*done)(void*, int);
+  void* data;
+};
+
 struct shim
 {
   using buffer_handle_type = xclBufferHandle; // xrt.h
@@ -60,6 +102,14 @@ struct shim
   HANDLE m_dev;
   std::shared_ptr<xrt_core::device> m_core_device;
 
+  // Completion port of all BO handles of this device, serviced by a
+  // completion thread started with the first asynchronous sync
+  HANDLE m_iocp = nullptr;
+  std::thread m_completion_thread;
+  std::mutex m_sync_mutex;
+  std::condition_variable m_sync_idle;
+  size_t m_sync_outstanding = 0;
+
   // create shim object, open the device, store the device handle
   shim(unsigned int devidx)
     : m_devidx(devidx)
@@ -80,6 +130,14 @@ struct shim
       throw std::runtime_error("CreateFile failed with error " + std::to_string(error));
     }
 
+    // Without a completion port BOs are still usable, syncs are then
+    // always synchronous
+    m_iocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!m_iocp)
+      xrt_core::message::
+        send(xrt_core::message::severity_level::warning, "XRT",
+             "CreateIoCompletionPort failed with error %d", GetLastError());
+
     DWORD bytesRead;
     XOCL_MAP_BAR_ARGS mapBar = { 0 };
     XOCL_MAP_BAR_RESULT mapBarResult = { 0 };
@@ -135,10 +193,70 @@ struct shim
   // destruct shim object, close the device
   ~shim()
   {
+    // Submitted syncs must complete while the device is still open
+    if (m_iocp) {
+      {
+        std::unique_lock<std::mutex> lk(m_sync_mutex);
+        m_sync_idle.wait(lk, [this] { return m_sync_outstanding == 0; });
+      }
+      if (m_completion_thread.joinable()) {
+        PostQueuedCompletionStatus(m_iocp, 0, 0, nullptr);
+        m_completion_thread.join();
+      }
+      CloseHandle(m_iocp);
+    }
+
     // close the device
     CloseHandle(m_dev);
   }
 
+  // Call the done function of each completed sync.  A packet without
+  // an OVERLAPPED stops the thread.
+  void
+  completion_worker()
+  {
+    while (true) {
+      DWORD bytes = 0;
+      ULONG_PTR key = 0;
+      OVERLAPPED* overlapped = nullptr;
+      BOOL ok = GetQueuedCompletionStatus(m_iocp, &bytes, &key, &overlapped, INFINITE);
+      if (!overlapped)
+        break;
+
+      auto request = CONTAINING_RECORD(overlapped, sync_request, overlapped);
+      request->done(request->data, ok ? 0 : GetLastError());
+      delete request;
+
+      std::lock_guard<std::mutex> lk(m_sync_mutex);
+      if (--m_sync_outstanding == 0)
+        m_sync_idle.notify_all();
+    }
+  }
+
+  // Open a BO handle for overlapped I/O and associate it with the
+  // completion port of the device
+  HANDLE
+  open_bo_handle()
+  {
+    HANDLE bufferHandle = CreateFileW(L"\\\\.\\XOCL_USER-0" XOCL_USER_DEVICE_BUFFER_OBJECT_NAMESPACE,
+                                      GENERIC_READ | GENERIC_WRITE,
+                                      0,
+                                      0,
+                                      OPEN_EXISTING,
+                                      FILE_FLAG_OVERLAPPED,
+                                      0);
+    if (bufferHandle == INVALID_HANDLE_VALUE || !m_iocp)
+      return bufferHandle;
+
+    if (!CreateIoCompletionPort(bufferHandle, m_iocp, 0, 0)) {
+      auto error = GetLastError();
+      CloseHandle(bufferHandle);
+      SetLastError(error);
+      return INVALID_HANDLE_VALUE;
+    }
+    return bufferHandle;
+  }
+
   buffer_handle_type
   alloc_bo(size_t size, unsigned int flags)
   {
@@ -147,13 +265,7 @@ struct shim
     XOCL_CREATE_BO_ARGS createBOArgs;
     DWORD bytesWritten;
 
-    bufferHandle = CreateFileW(L"\\\\.\\XOCL_USER-0" XOCL_USER_DEVICE_BUFFER_OBJECT_NAMESPACE,
-                              GENERIC_READ | GENERIC_WRITE,
-                              0,
-                              0,
-                              OPEN_EXISTING,
-                              0,
-                              0);
+    bufferHandle = open_bo_handle();
 
     //
     // If this call fails, check to figure out what the error is and report it.
@@ -173,14 +285,13 @@ struct shim
     createBOArgs.BankNumber = flags & 0xFFFFFFLL;
     createBOArgs.BufferType = (flags & XCL_BO_FLAGS_P2P) ? XOCL_BUFFER_TYPE_P2P : XOCL_BUFFER_TYPE_NORMAL;
 
-    if (!DeviceIoControl(bufferHandle,
-                         IOCTL_XOCL_CREATE_BO,
-                         &createBOArgs,
-                         sizeof(XOCL_CREATE_BO_ARGS),
-                         0,
-                         0,
-                         &bytesWritten,
-                         nullptr)) {
+    if (!bo_ioctl(bufferHandle,
+                  IOCTL_XOCL_CREATE_BO,
+                  &createBOArgs,
+                  sizeof(XOCL_CREATE_BO_ARGS),
+                  0,
+                  0,
+                  &bytesWritten)) {
 
         error = GetLastError();
 
@@ -216,13 +327,7 @@ done:
     XOCL_USERPTR_BO_ARGS userPtrBO;
     DWORD bytesWritten;
 
-    bufferHandle = CreateFileW(L"\\\\.\\XOCL_USER-0" XOCL_USER_DEVICE_BUFFER_OBJECT_NAMESPACE,
-                               GENERIC_READ | GENERIC_WRITE,
-                               0,
-                               0,
-                               OPEN_EXISTING,
-                               0,
-                               0);
+    bufferHandle = open_bo_handle();
 
     //
     // If this call fails, check to figure out what the error is and report it.
@@ -243,14 +348,13 @@ done:
     userPtrBO.BankNumber = flags & 0xFFFFFFLL;
     userPtrBO.BufferType = XOCL_BUFFER_TYPE_USERPTR;
 
-    if (!DeviceIoControl(bufferHandle,
-                         IOCTL_XOCL_USERPTR_BO,
-                         &userPtrBO,
-                         sizeof(XOCL_USERPTR_BO_ARGS),
-                         0,
-                         0,
-                         &bytesWritten,
-                         nullptr)) {
+    if (!bo_ioctl(bufferHandle,
+                  IOCTL_XOCL_USERPTR_BO,
+                  &userPtrBO,
+                  sizeof(XOCL_USERPTR_BO_ARGS),
+                  0,
+                  0,
+                  &bytesWritten)) {
 
       error = GetLastError();
 
@@ -295,14 +399,13 @@ done:
       return nullptr;
     }
 
-    if (!DeviceIoControl(handle,
-                         IOCTL_XOCL_MAP_BO,
-                         0,
-                         0,
-                         &mapBO,
-                         sizeof(XOCL_MAP_BO_RESULT),
-                         &bytesWritten,
-                         nullptr)) {
+    if (!bo_ioctl(handle,
+                  IOCTL_XOCL_MAP_BO,
+                  0,
+                  0,
+                  &mapBO,
+                  sizeof(XOCL_MAP_BO_RESULT),
+                  &bytesWritten)) {
 
       code = GetLastError();
 
@@ -353,14 +456,13 @@ done:
     syncBo.Offset = offset;
     syncBo.Size = size;
 
-    if (!DeviceIoControl(handle,
-                         IOCTL_XOCL_SYNC_BO,
-                         &syncBo,
-                         sizeof(XOCL_SYNC_BO_ARGS),
-                         nullptr,
-                         0,
-                         &bytesWritten,
-                         nullptr)) {
+    if (!bo_ioctl(handle,
+                  IOCTL_XOCL_SYNC_BO,
+                  &syncBo,
+                  sizeof(XOCL_SYNC_BO_ARGS),
+                  nullptr,
+                  0,
+                  &bytesWritten)) {
 
       error = GetLastError();
 
@@ -373,6 +475,54 @@ done:
     return 0;
   }
 
+  // Submit a sync without waiting for the DMA.  done(data, err) is
+  // called from the completion thread once the driver completes the
+  // request.  Returns ENOSYS if the device has no completion port.
+  int
+  submit_sync_bo(buffer_handle_type handle, xclBOSyncDirection dir, size_t size, size_t offset,
+                 void (*done)(void*, int), void* data)
+  {
+    if (!m_iocp)
+      return ENOSYS;
+
+    auto request = new sync_request();
+    request->args.Direction = (dir == XCL_BO_SYNC_BO_TO_DEVICE) ? XOCL_BUFFER_DIRECTION_TO_DEVICE : XOCL_BUFFER_DIRECTION_FROM_DEVICE;
+    request->args.Offset = offset;
+    request->args.Size = size;
+    request->done = done;
+    request->data = data;
+
+    {
+      std::lock_guard<std::mutex> lk(m_sync_mutex);
+      if (!m_completion_thread.joinable())
+        m_completion_thread = std::thread(&shim::completion_worker, this);
+      ++m_sync_outstanding;
+    }
+
+    // The completion port is notified also when the driver completes
+    // the request inline
+    if (DeviceIoControl(handle,
+                        IOCTL_XOCL_SYNC_BO,
+                        &request->args,
+                        sizeof(XOCL_SYNC_BO_ARGS),
+                        nullptr,
+                        0,
+                        nullptr,
+                        &request->overlapped)
+        || GetLastError() == ERROR_IO_PENDING)
+      return 0;
+
+    auto error = GetLastError();
+    xrt_core::message::
+      send(xrt_core::message::severity_level::error, "XRT", "Sync submit failed with error %d", error);
+    delete request;
+
+    std::lock_guard<std::mutex> lk(m_sync_mutex);
+    if (--m_sync_outstanding == 0)
+      m_sync_idle.notify_all();
+    return error;
+  }
+
   // {D8E1267B-5041-BA45-A8AC-D93D3CCA1378}
  // unsigned char GUID_VALIDATE_XCLBIN[16]	  {0xD8,0xE1,0x26,0x7B, 0x50,0x41, 0xBA,0x45, 0xA8, 0xAC, 0xD9, 0x3D, 0x3C, 0xCA, 0x13, 0x78};
 
@@ -525,14 +675,13 @@ done:
     DWORD error;
     DWORD bytesRet;
 
-    if (!DeviceIoControl(handle,
-                         IOCTL_XOCL_INFO_BO,
-                         NULL,
-                         0,
-                         &infoBo,
-                         sizeof(XOCL_INFO_BO_RESULT),
-                         &bytesRet,
-                         NULL)) {
+    if (!bo_ioctl(handle,
+                  IOCTL_XOCL_INFO_BO,
+                  NULL,
+                  0,
+                  &infoBo,
+                  sizeof(XOCL_INFO_BO_RESULT),
+                  &bytesRet)) {
 
       error = GetLastError();
       xrt_core::message::
@@ -859,14 +1008,13 @@ done:
 
       pwriteBO.Offset = seek;
 
-      if (!DeviceIoControl(boHandle,
+      if (!bo_ioctl(boHandle,
           IOCTL_XOCL_PWRITE_BO,
           &pwriteBO,
           sizeof(XOCL_PWRITE_BO_ARGS),
           (void *)src,
           (DWORD)size,
-          &bytesWritten,
-          nullptr)) {
+          &bytesWritten)) {
 
           code = GetLastError();
 
@@ -887,14 +1035,13 @@ done:
 
       preadBO.Offset = skip;
 
-      if (!DeviceIoControl(boHandle,
+      if (!bo_ioctl(boHandle,
           IOCTL_XOCL_PREAD_BO,
           &preadBO,
           sizeof(XOCL_PREAD_BO_ARGS),
           dst,
           (DWORD)size,
-          &bytesRead,
-          nullptr)) {
+          &bytesRead)) {
 
           code = GetLastError();
           xrt_core::message::
@@ -1712,6 +1859,16 @@ xclSyncBO(xclDeviceHandle handle, xclBufferHandle boHandle, xclBOSyncDirection d
   return shim->sync_bo(boHandle, dir, size, offset);
 }
 
+int
+xclSyncBOSubmit(xclDeviceHandle handle, xclBufferHandle boHandle, xclBOSyncDirection dir,
+                size_t size, size_t offset, void (*done)(void*, int), void* data)
+{
+  xrt_core::message::
+    send(xrt_core::message::severity_level::debug, "XRT", "xclSyncBOSubmit()");
+  auto shim = get_shim_object(handle);
+  return shim->submit_sync_bo(boHandle, dir, size, offset, done, data);
+}
+
 int
 xclCopyBO(xclDeviceHandle handle, xclBufferHandle dstBoHandle,
           xclBufferHandle srcBoHandle, size_t size, size_t dst_offset,
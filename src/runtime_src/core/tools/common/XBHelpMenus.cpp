@@ -20,6 +20,7 @@
 #include "XBUtilities.h"
 #include "core/common/time.h"
 #include "core/common/query_requests.h"
+#include "core/common/scope_guard.h"
 
 namespace XBU = XBUtilities;
 
@@ -32,7 +33,9 @@ namespace po = boost::program_options;
 // System - Include Files
 #include <iostream>
 #include <algorithm>
+#include <future>
 #include <numeric>
+#include <sstream>
 
 // ------ N A M E S P A C E ---------------------------------------------------
 using namespace XBUtilities;
@@ -701,10 +704,25 @@ XBUtilities::produce_reports( xrt_core::device_collection devices,
 
   if(dev_report()) {
     // -- Process reports that work on a device
-    boost::property_tree::ptree ptDevices;
-    int dev_idx = 0;
-    for (const auto & device : devices) {
+    // Each device is reported on its own thread into its own console
+    // buffer, the buffers and property trees are merged in device order.
+    // All queries of a device share the query cache while its reports
+    // are generated, so a request used by several reports is issued once.
+    struct device_report {
       boost::property_tree::ptree ptDevice;
+      std::ostringstream console;
+      bool is_valid = true;
+    };
+
+    auto report_device = [&](const std::shared_ptr<xrt_core::device>& device, int dev_idx, device_report& result) {
+      boost::property_tree::ptree& ptDevice = result.ptDevice;
+      std::ostream& deviceStream = result.console;
+      static constexpr std::chrono::milliseconds snapshot_age{60000};
+      device->set_query_cache_age(snapshot_age);
+      auto reset_age = xrt_core::scope_guard<std::function<void()>>([&device] {
+        device->set_query_cache_age(std::chrono::milliseconds(0));
+      });
+
       auto bdf = xrt_core::device_query<xrt_core::query::pcie_bdf>(device);
       ptDevice.put("interface_type", "pcie");
       ptDevice.put("device_id", xrt_core::query::pcie_bdf::to_string(bdf));
@@ -731,11 +749,11 @@ XBUtilities::produce_reports( xrt_core::device_collection devices,
         // proceed even if the platform name is not available
         platform = "<not defined>";
       }
-      std::string dev_desc = (boost::format("%d/%d [%s] : %s\n") % ++dev_idx % devices.size() % ptDevice.get<std::string>("device_id") % platform).str();
-      consoleStream << std::endl;
-      consoleStream << std::string(dev_desc.length(), '-') << std::endl;
-      consoleStream << dev_desc;
-      consoleStream << std::string(dev_desc.length(), '-') << std::endl;
+      std::string dev_desc = (boost::format("%d/%d [%s] : %s\n") % dev_idx % devices.size() % ptDevice.get<std::string>("device_id") % platform).str();
+      deviceStream << std::endl;
+      deviceStream << std::string(dev_desc.length(), '-') << std::endl;
+      deviceStream << dev_desc;
+      deviceStream << std::string(dev_desc.length(), '-') << std::endl;
 
       auto is_ready = xrt_core::device_query<xrt_core::query::is_ready>(device);
       bool is_recovery = false;
@@ -756,9 +774,9 @@ XBUtilities::produce_reports( xrt_core::device_collection devices,
           continue;
         boost::property_tree::ptree ptReport;
         try {
-          report->getFormattedReport(device.get(), schemaVersion, elementFilter, consoleStream, ptReport);
+          report->getFormattedReport(device.get(), schemaVersion, elementFilter, deviceStream, ptReport);
         } catch (const std::exception&) {
-          is_report_output_valid = false;
+          result.is_valid = false;
         }
         
 
@@ -773,8 +791,24 @@ XBUtilities::produce_reports( xrt_core::device_collection devices,
           }
         }
       }
-      if (!ptDevice.empty()) 
-        ptDevices.push_back(std::make_pair("", ptDevice));   // Used to make an array of objects
+    };
+
+    std::vector<device_report> results(devices.size());
+    std::vector<std::future<void>> futures;
+    int dev_idx = 0;
+    for (const auto & device : devices) {
+      futures.push_back(std::async(std::launch::async, report_device, device, dev_idx + 1, std::ref(results[dev_idx])));
+      ++dev_idx;
+    }
+
+    boost::property_tree::ptree ptDevices;
+    for (size_t idx = 0; idx < futures.size(); ++idx) {
+      futures[idx].get();
+      auto& result = results[idx];
+      consoleStream << result.console.str();
+      is_report_output_valid = is_report_output_valid && result.is_valid;
+      if (!result.ptDevice.empty()) 
+        ptDevices.push_back(std::make_pair("", result.ptDevice));   // Used to make an array of objects
     }
     if (!ptDevices.empty())
       ptRoot.add_child("devices", ptDevices);
@@ -50,6 +50,7 @@ namespace po = boost::program_options;
 #include "ReportPlatform.h"
 
 // System - Include Files
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -436,8 +437,10 @@ update_shell(unsigned int boardIdx, DSAInfo& candidate, Flasher::E_FlasherType f
 
 // Update shell and sc firmware on the device automatically 
 // Refactor code to support only 1 device. 
+// The user is not asked for permission when prompt is false, the caller
+// has done so for all the devices being flashed.
 static void 
-auto_flash(std::shared_ptr<xrt_core::device> & working_device, Flasher::E_FlasherType flashType, const std::string& image = "") 
+auto_flash(std::shared_ptr<xrt_core::device> & working_device, Flasher::E_FlasherType flashType, const std::string& image = "", bool prompt = true) 
 {
   // Get platform information
   boost::property_tree::ptree pt;
@@ -515,7 +518,7 @@ auto_flash(std::shared_ptr<xrt_core::device> & working_device, Flasher::E_Flashe
   std::stringstream report_stream;
 
   // Prompt user about what boards will be updated and ask for permission.
-  if (!XBU::can_proceed(XBU::getForce()))
+  if (prompt && !XBU::can_proceed(XBU::getForce()))
     return;
 
   // Perform DSA and BMC updating
@@ -565,6 +568,83 @@ auto_flash(std::shared_ptr<xrt_core::device> & working_device, Flasher::E_Flashe
   }
 }
 
+// Update the base and/or SC images of several devices, flashing at most
+// 'parallel' devices at the same time. Each device is flashed with its own
+// flash type, the failure of one device does not stop the others.
+static void
+flash_devices(xrt_core::device_collection& devices,
+              const std::string& update,
+              const std::map<std::string, std::string>& image_map,
+              const std::string& flash_type,
+              unsigned int parallel)
+{
+  std::cout << "Devices to update:\n";
+  for (const auto& dev : devices)
+    std::cout << boost::format("  [%s]\n") % getBDF(dev->get_device_id());
+
+  if (!XBU::can_proceed(XBU::getForce()))
+    throw xrt_core::error(std::errc::operation_canceled);
+
+  struct device_result {
+    std::string bdf;
+    std::string error;
+    double seconds = 0;
+  };
+  std::vector<device_result> results(devices.size());
+
+  auto flash_one = [&](size_t idx) {
+    auto& dev = devices[idx];
+    auto& result = results[idx];
+    auto start = std::chrono::steady_clock::now();
+    try {
+      result.bdf = getBDF(dev->get_device_id());
+      Flasher flasher(dev->get_device_id());
+      auto type = flasher.getFlashType(flash_type);
+      auto images = image_map;
+      if (update.compare("all") == 0)
+        auto_flash(dev, type, images["primary"], false);
+      else if (update.compare("sc") == 0)
+        update_SC(dev->get_device_id(), images["primary"]);
+      else
+        update_shell(dev->get_device_id(), images, type);
+    }
+    catch (const std::exception& e) {
+      result.error = e.what();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  // Each worker takes the next device until all devices are flashed
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t idx = next++; idx < devices.size(); idx = next++)
+      flash_one(idx);
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < std::min<size_t>(parallel, devices.size()); ++i)
+    workers.emplace_back(worker);
+  for (auto& w : workers)
+    w.join();
+
+  bool failed = false;
+  std::cout << "----------------------------------------------------\n";
+  std::cout << "Report\n";
+  for (const auto& result : results) {
+    if (result.error.empty()) {
+      std::cout << boost::format("  [%s] : Done in %.1fs\n") % result.bdf % result.seconds;
+      continue;
+    }
+    std::cout << boost::format("  [%s] : Failed after %.1fs: %s\n") % result.bdf % result.seconds % result.error;
+    failed = true;
+  }
+
+  if (failed) {
+    std::cout << "\nDevice flashing encountered errors.\n";
+    throw xrt_core::error(std::errc::operation_canceled);
+  }
+}
+
 static void
 program_plp(const xrt_core::device* dev, const std::string& partition)
 {
@@ -669,6 +749,7 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
   std::string xclbin = "";
   std::string flashType = "";
   std::vector<std::string> image;
+  unsigned int parallel = 4;
   bool revertToGolden = false;
   bool help = false;
 
@@ -686,6 +767,7 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
     ("image", boost::program_options::value<decltype(image)>(&image)->multitoken(),  "Specifies an image to use used to update the persistent device.  Value values:\n"
                                                                     "  Name (and path) to the mcs image on disk\n"
                                                                     "  Name (and path) to the xsabin image on disk")
+    ("parallel", boost::program_options::value<decltype(parallel)>(&parallel), "Maximum number of devices updated at the same time by --base (default 4)")
     ("revert-to-golden", boost::program_options::bool_switch(&revertToGolden), "Resets the FPGA PROM back to the factory image. Note: The Satellite Controller will not be reverted for a golden image does not exist.")
     ("help,h", boost::program_options::bool_switch(&help), "Help to use this sub-command")
   ;
@@ -743,14 +825,16 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
   std::set<std::string> deviceNames;
 
   xrt_core::device_collection deviceCollection;
-  for (const auto & deviceName : device) 
-    deviceNames.insert(boost::algorithm::to_lower_copy(deviceName));
+  for (const auto & deviceName : device) {
+    auto name = boost::algorithm::to_lower_copy(deviceName);
+    deviceNames.insert(name.compare("all") == 0 ? "_all_" : name);
+  }
 
   XBU::collect_devices(deviceNames, false /*inUserDomain*/, deviceCollection);
 
-  // Enforce 1 device specification
-  if (deviceCollection.size() > 1) {
-    std::cerr << "\nERROR: Multiple device programming is not supported. Please specify a single"
+  // Enforce 1 device specification, only the base images can be updated on several devices
+  if (deviceCollection.size() > 1 && update.empty()) {
+    std::cerr << "\nERROR: Multiple device programming is only supported with --base. Please specify a single"
                  " device using --device option\n\n";
     std::cout << "List of available devices:" << std::endl;
 
@@ -774,21 +858,30 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
   if (image.size() > 2)
     throw xrt_core::error("Multiple flash images provided. Please specify either 1 or 2 flash images.");
 
+  if (parallel == 0)
+    throw xrt_core::error("Please specify a non-zero number of devices for --parallel");
+
   // Populate flash type. Uses board's default when passing an empty input string.
   if (!flashType.empty()) {
       xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", 
         "Overriding flash mode is not recommended.\nYou may damage your device with this option.");
   } 
-  Flasher working_flasher(working_device->get_device_id());
-  auto flash_type = working_flasher.getFlashType(flashType);
 
   if (!update.empty()) {
+    if (update.compare("all") != 0 && update.compare("sc") != 0 && update.compare("shell") != 0)
+      throw xrt_core::error("Usage: xbmgmt program --device='0000:00:00.0' --base [all|sc|shell]"
+                            " --image=['/path/to/flash_image'|'shell name']");
+
     // User did not provide an image for all. Select image automatically.
-    if (update.compare("all") == 0) {
-      if (image.empty()) {
-        auto_flash(working_device, flash_type);
+    if (update.compare("all") == 0 && image.empty()) {
+      if (deviceCollection.size() > 1) {
+        XBUtilities::sudo_or_throw("Root privileges are required to update the devices flash image");
+        flash_devices(deviceCollection, update, {}, flashType, parallel);
         return;
       }
+      Flasher working_flasher(working_device->get_device_id());
+      auto_flash(working_device, working_flasher.getFlashType(flashType));
+      return;
     }
 
     // All other cases have a specified image
@@ -817,6 +910,13 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
 
     XBU::verbose("Sub command: --base");
     XBUtilities::sudo_or_throw("Root privileges are required to update the devices flash image");
+    if (deviceCollection.size() > 1) {
+      flash_devices(deviceCollection, update, validated_image_map, flashType, parallel);
+      return;
+    }
+
+    Flasher working_flasher(working_device->get_device_id());
+    auto flash_type = working_flasher.getFlashType(flashType);
     if (update.compare("all") == 0) {
         auto_flash(working_device, flash_type, validated_image_map["primary"]);
     }
@@ -828,12 +928,12 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
     else if (update.compare("shell") == 0) {
       update_shell(working_device.get()->get_device_id(), validated_image_map, flash_type);
     }
-    else
-      throw xrt_core::error("Usage: xbmgmt program --device='0000:00:00.0' --base [all|sc|shell]"
-                            " --image=['/path/to/flash_image'|'shell name']");
 
     return;
   }
+
+  Flasher working_flasher(working_device->get_device_id());
+  auto flash_type = working_flasher.getFlashType(flashType);
   
   // -- process "revert-to-golden" option ---------------------------------------
   if (revertToGolden) {
@@ -27,6 +27,7 @@
 #include <vector>
 #include <cstring>
 #include <cstdarg>
+#include <fcntl.h>
 #include "boost/format.hpp"
 #include <boost/algorithm/string.hpp>
 #include "boost/filesystem.hpp"
@@ -65,10 +66,22 @@ Flasher::E_FlasherType Flasher::typeStr_to_E_FlasherType(const std::string& type
     return type;
 }
 
+bool Flasher::hasXgqVmr()
+{
+#ifdef __GNUC__
+    try {
+        m_device->file_open("xgq_vmr", O_RDWR);
+        return true;
+    } catch (...) {}
+#endif
+    return false;
+}
+
 Flasher::E_FlasherType Flasher::getFlashType(std::string typeStr)
 {
     std::string err;
     E_FlasherType type = E_FlasherType::UNKNOWN;
+    bool is_override = !typeStr.empty();
 
     // check various locations for flash_type
     // the node could either be present in flash subdev or exist independently
@@ -86,6 +99,12 @@ Flasher::E_FlasherType Flasher::getFlashType(std::string typeStr)
             getProgrammingTypeFromDeviceName(mFRHeader.VBNVName, type);
     } catch (...) {}
     
+    // Shells with VMR take the whole image over XGQ and program the flash
+    // themselves, which is much faster than driving QSPI from the host.
+    // Prefer that path unless the flash type is overridden by the user
+    if (!is_override && typeStr.compare("ospi_xgq") != 0 && hasXgqVmr())
+        typeStr = "ospi_xgq";
+
     type = typeStr_to_E_FlasherType(typeStr);
     if(type == E_FlasherType::UNKNOWN)
         throw xrt_core::error(boost::str(boost::format("Unknown flash type: %s") % typeStr));
@@ -28,6 +28,8 @@
 #include <vector>
 #include <limits>
 #include <array>
+#include <chrono>
+#include <mutex>
 #include <fcntl.h>
 
 
@@ -36,6 +38,7 @@
 #include "core/tools/common/ProgressBar.h"
 namespace XBU = XBUtilities;
 #include "boost/format.hpp"
+#include "boost/crc.hpp"
 
 template <typename ...Args>
 int
@@ -62,6 +65,10 @@ static const bool FOUR_BYTE_ADDRESSING = false;
 uint32_t MAX_NUM_SECTORS = 0;
 uint32_t selected_sector = std::numeric_limits<uint32_t>::max();
 
+// Register level programming keeps its state at file scope, so only one
+// device at a time is programmed that way.  The driver path is per device.
+static std::mutex register_path_mutex;
+
 //testing sizes.
 #define WRITE_DATA_SIZE 128
 #define READ_DATA_SIZE 128
@@ -552,6 +559,8 @@ int XSPI_Flasher::xclUpgradeFirmware1(std::istream& mcsStream1) {
     if (mFlashDev)
         return upgradeFirmware1Drv(mcsStream1);
 
+    std::lock_guard<std::mutex> lk(register_path_mutex);
+
     //Parse MCS file for first flash device
     status = parseMCS(mcsStream1);
     if(status)
@@ -603,6 +612,8 @@ int XSPI_Flasher::xclUpgradeFirmware2(std::istream& mcsStream1, std::istream& mc
     if (mFlashDev)
         return upgradeFirmware2Drv(mcsStream1, mcsStream2);
 
+    std::lock_guard<std::mutex> lk(register_path_mutex);
+
     //Parse MCS file for first flash device
     status = parseMCS(mcsStream1);
     if(status)
@@ -1824,6 +1835,9 @@ const unsigned int dftBitstreamGuardAddress = 0x01002000;
 const unsigned int bitstreamGuardSize = 4096;
 // Print out "." for each pagesz bytes of data processed.
 const size_t pagesz = 1024 * 1024ul;
+// Bytes handed to the flash driver per write or read, the driver
+// programs them in pages of up to 64 KiB.
+const size_t writesz = 4 * pagesz;
 
 static inline long toAddr(const int slave, const unsigned int offset)
 {
@@ -2125,10 +2139,10 @@ static int writeBitstream(std::FILE *flashDev, int index, unsigned int addr,
     int ret = 0;
     size_t len = 0;
 
-    // Write to flash page by page and print '.' for each write
+    // Write to flash in large chunks and print '.' for each write
     // as progress indicator
     for (size_t i = 0; ret == 0 && i < buf.size(); i += len) {
-        len = pagesz - ((addr + i) % pagesz);
+        len = writesz - ((addr + i) % writesz);
         len = std::min(len, buf.size() - i);
 
         std::cout << "." << std::flush;
@@ -2138,9 +2152,40 @@ static int writeBitstream(std::FILE *flashDev, int index, unsigned int addr,
     return ret;
 }
 
+// Read back what was written and compare its CRC32 with the CRC32 of
+// the bitstream, instead of comparing byte by byte.
+static int verifyBitstream(std::FILE *flashDev, int index, unsigned int addr,
+    const std::vector<unsigned char>& buf)
+{
+    boost::crc_32_type expected;
+    expected.process_bytes(buf.data(), buf.size());
+
+    boost::crc_32_type actual;
+    std::vector<unsigned char> rbuf(writesz);
+    for (size_t i = 0; i < buf.size(); i += rbuf.size()) {
+        size_t len = std::min(rbuf.size(), buf.size() - i);
+        if (std::fseek(flashDev, toAddr(index, addr + static_cast<unsigned int>(i)), SEEK_SET))
+            return -errno;
+        if (std::fread(rbuf.data(), 1, len, flashDev) != len)
+            return ferror(flashDev) ? -errno : -EIO;
+        actual.process_bytes(rbuf.data(), len);
+    }
+
+    if (actual.checksum() != expected.checksum()) {
+        std::cout << boost::format("ERROR: Flash %d readback CRC32 0x%08x does not match bitstream CRC32 0x%08x\n")
+            % index % actual.checksum() % expected.checksum();
+        return -EIO;
+    }
+    std::cout << boost::format("Verified bitstream on flash %d, CRC32 0x%08x\n") % index % expected.checksum();
+    return 0;
+}
+
 static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, std::istream& mcsStream,
     int index, uint32_t addressShift)
 {
+    using clock = std::chrono::steady_clock;
+    std::chrono::duration<double> extract_time{0}, write_time{0}, verify_time{0};
+
     // Parse MCS data and write each contiguous chunk to flash.
     std::vector<unsigned char> buf;
     unsigned int curAddr = UINT_MAX;
@@ -2151,7 +2196,9 @@ static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, std::istr
 
     while (nextAddr != UINT_MAX) {
         std::cout << "Extracting bitstream from MCS data:" << std::endl;
+        auto start = clock::now();
         ret = mcsStreamToBin(mcsStream, curAddr, buf, nextAddr);
+        extract_time += clock::now() - start;
         if (ret)
             return ret;
         assert(nextAddr == UINT_MAX || pageOffset(nextAddr) == 0);
@@ -2164,12 +2211,23 @@ static int programXSpiDrv(xrt_core::device *dev, std::FILE *mFlashDev, std::istr
         }
 
         std::cout << "Writing bitstream to flash " << index << ":" << std::endl;
+        start = clock::now();
         ret = writeBitstream(mFlashDev, index, curAddr + addressShift, buf);
+        write_time += clock::now() - start;
+        if (ret)
+            return ret;
+
+        start = clock::now();
+        ret = verifyBitstream(mFlashDev, index, curAddr + addressShift, buf);
+        verify_time += clock::now() - start;
         if (ret)
             return ret;
         curAddr = nextAddr;
     }
 
+    std::cout << boost::format("%-8s : Flash %d time per phase: extract %.1fs, write %.1fs, verify %.1fs\n")
+        % "INFO" % index % extract_time.count() % write_time.count() % verify_time.count();
+
     // provide flash controller information to icap controller for webstar flow. Required only for U.2
     try {
         xrt_core::device_update<xrt_core::query::ic_load_flash_address>(dev, startAddr);
@@ -0,0 +1,391 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+// ------ I N C L U D E   F I L E S -------------------------------------------
+// Local - Include Files
+#include "SubCmdTop.h"
+#include "core/common/query_requests.h"
+#include "core/common/utils.h"
+#include "core/include/xclbin.h"
+#include "tools/common/XBUtilities.h"
+namespace XBU = XBUtilities;
+
+// 3rd Party Library - Include Files
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+namespace po = boost::program_options;
+
+// System - Include Files
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace xq = xrt_core::query;
+
+// ------ L O C A L   F U N C T I O N S ---------------------------------------
+
+namespace {
+
+using ptree_type = boost::property_tree::ptree;
+
+// Samples the dynamic device counters with one query per counter group.
+// Data that only changes with the xclbin, such as memory tags and sizes,
+// is queried once and refreshed when the loaded xclbin changes.
+class top_sampler
+{
+  const xrt_core::device* m_device;
+  std::string m_uuid;
+  ptree_type m_memories;  // enabled memory banks: tag, size_bytes, index
+
+  void
+  refresh_static()
+  {
+    m_memories.clear();
+    std::vector<char> raw;
+    try {
+      raw = xrt_core::device_query<xq::mem_topology_raw>(m_device);
+    }
+    catch (const xq::exception&) {
+    }
+    if (raw.empty())
+      return;
+
+    auto mem_topo = reinterpret_cast<const mem_topology*>(raw.data());
+    for (int i = 0; i < mem_topo->m_count; ++i) {
+      auto& mem = mem_topo->m_mem_data[i];
+      if (!mem.m_used || mem.m_type == MEM_STREAMING || mem.m_type == MEM_STREAMING_CONNECTION)
+        continue;
+      ptree_type pt_mem;
+      pt_mem.put("index", i);
+      pt_mem.put("tag", reinterpret_cast<const char*>(mem.m_tag));
+      pt_mem.put("size_bytes", static_cast<uint64_t>(mem.m_size) * 1024);
+      m_memories.push_back(std::make_pair("", pt_mem));
+    }
+  }
+
+public:
+  explicit
+  top_sampler(const xrt_core::device* device)
+    : m_device(device)
+  {}
+
+  ptree_type
+  sample()
+  {
+    ptree_type pt;
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    pt.put("timestamp_us", std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+
+    std::string uuid;
+    try {
+      uuid = xrt_core::device_query<xq::xclbin_uuid>(m_device);
+    }
+    catch (const xq::exception&) {
+    }
+    if (uuid != m_uuid) {
+      m_uuid = uuid;
+      refresh_static();
+    }
+    pt.put("xclbin_uuid", m_uuid);
+
+    try {
+      pt.put("power_watts", xrt_core::utils::format_base10_shiftdown6(xrt_core::device_query<xq::power_microwatts>(m_device)));
+    }
+    catch (const xq::exception&) {
+    }
+
+    // memstat_raw is indexed by mem_topology entry: "<allocated bytes> <bo count>"
+    try {
+      auto mem_stat = xrt_core::device_query<xq::memstat_raw>(m_device);
+      ptree_type pt_memories;
+      for (auto& kv : m_memories) {
+        ptree_type pt_mem = kv.second;
+        auto idx = pt_mem.get<size_t>("index");
+        uint64_t allocated = 0, bo_count = 0;
+        if (idx < mem_stat.size())
+          std::stringstream {mem_stat[idx]} >> allocated >> bo_count;
+        pt_mem.put("allocated_bytes", allocated);
+        pt_mem.put("bo_count", bo_count);
+        pt_memories.push_back(std::make_pair("", pt_mem));
+      }
+      pt.add_child("memories", pt_memories);
+    }
+    catch (const xq::exception&) {
+    }
+
+    try {
+      ptree_type pt_cus;
+      for (auto& cu : xrt_core::device_query<xq::kds_cu_info>(m_device)) {
+        ptree_type pt_cu;
+        pt_cu.put("name", cu.name);
+        pt_cu.put("usages", cu.usages);
+        pt_cus.push_back(std::make_pair("", pt_cu));
+      }
+      pt.add_child("compute_units", pt_cus);
+    }
+    catch (const xq::exception&) {
+    }
+
+    // dma_threads_raw is a list of "<c2h bytes> <h2c bytes>" per channel
+    try {
+      ptree_type pt_dmas;
+      for (auto& channel : xrt_core::device_query<xq::dma_threads_raw>(m_device)) {
+        uint64_t c2h = 0, h2c = 0;
+        std::stringstream {channel} >> c2h >> h2c;
+        ptree_type pt_dma;
+        pt_dma.put("host_to_card_bytes", h2c);
+        pt_dma.put("card_to_host_bytes", c2h);
+        pt_dmas.push_back(std::make_pair("", pt_dma));
+      }
+      pt.add_child("dma_channels", pt_dmas);
+    }
+    catch (const xq::exception&) {
+    }
+
+    return pt;
+  }
+};
+
+// Find counter 'key' of entry 'idx' of 'array' in a sample, 0 if not present
+static uint64_t
+get_counter(const ptree_type& pt, const std::string& array, size_t idx, const std::string& key)
+{
+  auto child = pt.get_child_optional(array);
+  if (!child || idx >= child->size())
+    return 0;
+  auto it = child->begin();
+  std::advance(it, idx);
+  return it->second.get<uint64_t>(key, 0);
+}
+
+// Render one sample, rates are computed against the previous sample
+static void
+render_sample(const std::string& bdf, const ptree_type& pt, const ptree_type& prev, std::ostream& output)
+{
+  static const ptree_type empty_ptree;
+  double seconds = 0;
+  if (!prev.empty())
+    seconds = (pt.get<uint64_t>("timestamp_us") - prev.get<uint64_t>("timestamp_us")) / 1000000.0;
+  auto rate = [seconds](uint64_t cur, uint64_t old) {
+    return (seconds > 0 && cur >= old) ? (cur - old) / seconds : 0.0;
+  };
+
+  output << "\033[2J\033[H";
+  output << boost::format("Device [%s]  Power: %s Watts\n\n") % bdf % pt.get<std::string>("power_watts", "N/A");
+
+  output << "Compute Units\n";
+  output << boost::format("  %-40s %14s %14s\n") % "Name" % "Usage" % "Cmds/s";
+  size_t idx = 0;
+  for (auto& kv : pt.get_child("compute_units", empty_ptree)) {
+    auto usages = kv.second.get<uint64_t>("usages");
+    output << boost::format("  %-40s %14d %14.0f\n") % kv.second.get<std::string>("name") % usages
+      % rate(usages, get_counter(prev, "compute_units", idx++, "usages"));
+  }
+
+  output << "\nDevice Memory Usage\n";
+  output << boost::format("  %-16s %12s %12s %7s %10s\n") % "Tag" % "Size" % "Allocated" % "Used" % "BO Count";
+  for (auto& kv : pt.get_child("memories", empty_ptree)) {
+    auto size = kv.second.get<uint64_t>("size_bytes");
+    auto allocated = kv.second.get<uint64_t>("allocated_bytes");
+    output << boost::format("  %-16s %12s %12s %6.1f%% %10d\n") % kv.second.get<std::string>("tag")
+      % xrt_core::utils::unit_convert(size) % xrt_core::utils::unit_convert(allocated)
+      % (size ? allocated * 100.0 / size : 0.0) % kv.second.get<uint64_t>("bo_count");
+  }
+
+  output << "\nDMA Transfer Rates\n";
+  output << boost::format("  %-8s %16s %16s\n") % "Channel" % "Host to Card/s" % "Card to Host/s";
+  idx = 0;
+  for (auto& kv : pt.get_child("dma_channels", empty_ptree)) {
+    auto h2c = kv.second.get<uint64_t>("host_to_card_bytes");
+    auto c2h = kv.second.get<uint64_t>("card_to_host_bytes");
+    output << boost::format("  %-8d %16s %16s\n") % idx
+      % xrt_core::utils::unit_convert(static_cast<size_t>(rate(h2c, get_counter(prev, "dma_channels", idx, "host_to_card_bytes"))))
+      % xrt_core::utils::unit_convert(static_cast<size_t>(rate(c2h, get_counter(prev, "dma_channels", idx, "card_to_host_bytes"))));
+    ++idx;
+  }
+  output << std::flush;
+}
+
+// Replay samples recorded with --record, paced by their timestamps
+static void
+replay(const std::string& file, unsigned int count)
+{
+  std::ifstream ifs(file);
+  if (!ifs)
+    throw xrt_core::error((boost::format("Unable to open recording: '%s'") % file).str());
+
+  ptree_type prev;
+  std::string line;
+  unsigned int samples = 0;
+  while (std::getline(ifs, line) && (count == 0 || samples < count)) {
+    if (line.empty())
+      continue;
+    ptree_type pt;
+    std::stringstream ss(line);
+    boost::property_tree::read_json(ss, pt);
+
+    if (!prev.empty()) {
+      auto delta = pt.get<uint64_t>("timestamp_us") - prev.get<uint64_t>("timestamp_us");
+      std::this_thread::sleep_for(std::chrono::microseconds(delta));
+    }
+    render_sample(pt.get<std::string>("bdf", ""), pt, prev, std::cout);
+    prev = std::move(pt);
+    ++samples;
+  }
+}
+
+} // namespace
+
+// ----- C L A S S   M E T H O D S -------------------------------------------
+
+SubCmdTop::SubCmdTop(bool _isHidden, bool _isDepricated, bool _isPreliminary)
+    : SubCmd("top",
+             "Continuously monitors CU, memory, power and DMA activity of a device")
+{
+  const std::string longDescription = "Continuously samples CU usage, device memory usage, power and DMA "
+                                      "transfer counters of the given device and displays them.  The samples "
+                                      "can also be recorded to a file without display and replayed later.";
+  setLongDescription(longDescription);
+  setExampleSyntax("");
+  setIsHidden(_isHidden);
+  setIsDeprecated(_isDepricated);
+  setIsPreliminary(_isPreliminary);
+}
+
+void
+SubCmdTop::execute(const SubCmdOptions& _options) const
+{
+  XBU::verbose("SubCommand: top");
+  // -- Retrieve and parse the subcommand options -----------------------------
+  std::vector<std::string> devices;
+  unsigned int interval = 1000;
+  unsigned int count = 0;
+  std::string record;
+  std::string replayFile;
+  bool help = false;
+
+  po::options_description commonOptions("Common Options");
+  commonOptions.add_options()
+    ("device,d", boost::program_options::value<decltype(devices)>(&devices)->multitoken(), "The Bus:Device.Function (e.g., 0000:d8:00.0) device of interest.")
+    ("interval,i", boost::program_options::value<decltype(interval)>(&interval), "Refresh interval in milliseconds (default 1000, minimum 10)")
+    ("count,n", boost::program_options::value<decltype(count)>(&count), "Number of samples to take, 0 samples until interrupted (default 0)")
+    ("record", boost::program_options::value<decltype(record)>(&record), "Record the samples to the given file without display")
+    ("replay", boost::program_options::value<decltype(replayFile)>(&replayFile), "Display the samples recorded in the given file")
+    ("help", boost::program_options::bool_switch(&help), "Help to use this sub-command")
+  ;
+
+  po::options_description hiddenOptions("Hidden Options");
+
+  po::options_description allOptions("All Options");
+  allOptions.add(commonOptions);
+  allOptions.add(hiddenOptions);
+
+  // Parse sub-command ...
+  po::variables_map vm;
+
+  try {
+    po::store(po::command_line_parser(_options).options(allOptions).run(), vm);
+    po::notify(vm); // Can throw
+  } catch (po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+    printHelp(commonOptions, hiddenOptions);
+    throw xrt_core::error(std::errc::operation_canceled);
+  }
+
+  // Check to see if help was requested or no command was found
+  if (help == true)  {
+    printHelp(commonOptions, hiddenOptions);
+    return;
+  }
+
+  // -- Now process the subcommand --------------------------------------------
+  if (!replayFile.empty()) {
+    try {
+      replay(replayFile, count);
+    } catch (const std::exception& e) {
+      std::cerr << boost::format("ERROR: %s\n") % e.what();
+      throw xrt_core::error(std::errc::operation_canceled);
+    }
+    return;
+  }
+
+  if (interval < 10) {
+    std::cerr << "ERROR: The refresh interval must be at least 10 milliseconds\n";
+    throw xrt_core::error(std::errc::operation_canceled);
+  }
+
+  if (!record.empty() && !XBU::getForce() && boost::filesystem::exists(record)) {
+    std::cerr << boost::format("ERROR: Output file already exists: '%s'\n") % record;
+    throw xrt_core::error(std::errc::operation_canceled);
+  }
+
+  // Collect the device of interest
+  std::set<std::string> deviceNames;
+  xrt_core::device_collection deviceCollection;
+  for (const auto & deviceName : devices)
+    deviceNames.insert(boost::algorithm::to_lower_copy(deviceName));
+
+  try {
+    XBU::collect_devices(deviceNames, true /*inUserDomain*/, deviceCollection);
+  } catch (const std::runtime_error& e) {
+    // Catch only the exceptions that we have generated earlier
+    std::cerr << boost::format("ERROR: %s\n") % e.what();
+    throw xrt_core::error(std::errc::operation_canceled);
+  }
+
+  if (deviceCollection.size() != 1) {
+    std::cerr << "ERROR: Please specify a single device using --device option\n";
+    throw xrt_core::error(std::errc::operation_canceled);
+  }
+
+  auto& device = deviceCollection.front();
+  auto bdf = xq::pcie_bdf::to_string(xrt_core::device_query<xq::pcie_bdf>(device));
+
+  std::ofstream ofs;
+  if (!record.empty()) {
+    ofs.open(record);
+    if (!ofs) {
+      std::cerr << boost::format("ERROR: Unable to open output file: '%s'\n") % record;
+      throw xrt_core::error(std::errc::operation_canceled);
+    }
+    std::cout << boost::format("Recording device [%s] to '%s'\n") % bdf % record;
+  }
+
+  // Sample on a fixed cadence, independent of the time spent sampling
+  top_sampler sampler(device.get());
+  ptree_type prev;
+  auto next = std::chrono::steady_clock::now();
+  for (unsigned int samples = 0; count == 0 || samples < count; ++samples) {
+    auto pt = sampler.sample();
+    if (ofs.is_open()) {
+      pt.put("bdf", bdf);
+      boost::property_tree::write_json(ofs, pt, false);
+      ofs.flush();
+    }
+    else {
+      render_sample(bdf, pt, prev, std::cout);
+    }
+    prev = std::move(pt);
+
+    next += std::chrono::milliseconds(interval);
+    std::this_thread::sleep_until(next);
+  }
+}
@@ -44,6 +44,12 @@ namespace po = boost::program_options;
 #include <sstream>
 #include <thread>
 #include <regex>
+#include <fstream>
+#include <future>
+#include <limits>
+#ifdef __linux__
+#include <sched.h>
+#endif
 #ifdef __GNUC__
 #include <sys/mman.h> //munmap
 #endif
@@ -273,7 +279,8 @@ runTestCase( const std::shared_ptr<xrt_core::device>& _dev, const std::string& p
       { "versal_23_bandwidth.py",   "kernel_bw.exe"   },
       { "host_mem_23_bandwidth.py", "hostmemory.exe"  },
       { "xcl_vcu_test.exe",         "xcl_vcu_test.exe"},
-      { "xcl_iops_test.exe",        "xcl_iops_test.exe"}
+      { "xcl_iops_test.exe",        "xcl_iops_test.exe"},
+      { "xrt_latency_test.exe",     "xrt_latency_test.exe"}
     };
 
     if (test_map.find(py) == test_map.end()) {
@@ -380,6 +387,16 @@ runTestCase( const std::shared_ptr<xrt_core::device>& _dev, const std::string& p
       logger(_ptTest, "Details", os_stdout.str().substr(st, end - st));
     }
   }
+
+  // Report min/p50/p99/p99.9/max for each wait mode of the latency testcase
+  if (py.compare("xrt_latency_test.exe") == 0) {
+    auto str = os_stdout.str().find("Latency", 0);
+    while(str != std::string::npos) {
+      auto end = os_stdout.str().find("\n", str);
+      logger(_ptTest, "Details", os_stdout.str().substr(str, end - str));
+      str = os_stdout.str().find("Latency" , end);
+    }
+  }
 }
 
 /*
@@ -1227,6 +1244,245 @@ iopsTest(const std::shared_ptr<xrt_core::device>& _dev, boost::property_tree::pt
     runTestCase(_dev, "xcl_iops_test.exe", _ptTest.get<std::string>("xclbin"), _ptTest);
 }
 
+/*
+ * TEST #13
+ */
+void
+latencyTest(const std::shared_ptr<xrt_core::device>& _dev, boost::property_tree::ptree& _ptTest)
+{
+  runTestCase(_dev, "xrt_latency_test.exe", _ptTest.get<std::string>("xclbin"), _ptTest);
+}
+
+/*
+ * helpers for the DMA sweep test
+ */
+struct dma_sweep_result {
+  std::string label;
+  size_t size;
+  double h2d;  // GB/s
+  double d2h;  // GB/s
+};
+
+static std::string
+size_to_string(size_t size)
+{
+  if (size >= 0x40000000)
+    return std::to_string(size >> 30) + " GiB";
+  if (size >= 0x100000)
+    return std::to_string(size >> 20) + " MiB";
+  return std::to_string(size >> 10) + " KiB";
+}
+
+// Restrict the calling thread, and the DMA threads it creates, to the
+// CPUs of a NUMA node so host buffers are first touched on that node.
+// Returns false if the node has no CPUs or placement is not supported.
+static bool
+bind_to_numa_node(int node)
+{
+#ifdef __linux__
+  std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string cpulist;
+  if (!std::getline(ifs, cpulist) || cpulist.empty())
+    return false;
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  std::stringstream ss(cpulist);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; cpu++)
+      CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)node;
+  return false;
+#endif
+}
+
+static std::vector<int>
+get_numa_nodes()
+{
+  std::vector<int> nodes;
+#ifdef __linux__
+  boost::filesystem::path node_dir("/sys/devices/system/node");
+  if (!boost::filesystem::exists(node_dir))
+    return nodes;
+  for (auto& entry : boost::make_iterator_range(boost::filesystem::directory_iterator(node_dir), {})) {
+    auto name = entry.path().filename().string();
+    if (name.compare(0, 4, "node") == 0 && name.size() > 4 && std::isdigit(name[4]))
+      nodes.push_back(std::stoi(name.substr(4)));
+  }
+  std::sort(nodes.begin(), nodes.end());
+#endif
+  return nodes;
+}
+
+// Run one sweep point on the given banks concurrently, both directions
+static dma_sweep_result
+run_dma_sweep_point(const std::shared_ptr<xrt_core::device>& _dev, const std::vector<unsigned int>& banks,
+                    size_t size, size_t total_size, const std::string& label,
+                    boost::property_tree::ptree& _ptTest)
+{
+  constexpr size_t latency_max_size = 0x100000; // report latency up to 1 MiB
+  constexpr unsigned int latency_iterations = 100;
+
+  std::vector<std::unique_ptr<xcldev::DMARunner>> runners;
+  for (auto bank : banks)
+    runners.push_back(std::make_unique<xcldev::DMARunner>(_dev->get_device_handle(), size, bank, total_size));
+
+  auto run_dir = [&runners](xclBOSyncDirection dir) {
+    size_t bytes = 0;
+    xcldev::Timer timer;
+    std::vector<std::future<long long>> futures;
+    for (auto& runner : runners) {
+      futures.push_back(std::async(std::launch::async, &xcldev::DMARunner::runTimed, runner.get(), dir));
+      bytes += runner->bytes();
+    }
+    for (auto& f : futures)
+      f.get();
+    return static_cast<double>(bytes) / timer.stop() / 1000; // GB/s
+  };
+
+  dma_sweep_result result { label, size, run_dir(XCL_BO_SYNC_BO_TO_DEVICE), run_dir(XCL_BO_SYNC_BO_FROM_DEVICE) };
+  for (auto& runner : runners)
+    runner->validate();
+
+  auto details = boost::format("%s, %s: H2D %.2f GB/s, D2H %.2f GB/s")
+    % label % size_to_string(size) % result.h2d % result.d2h;
+  if (size <= latency_max_size && banks.size() == 1) {
+    auto& runner = runners.front();
+    details = boost::format("%s, latency H2D %.1f us, D2H %.1f us") % details.str()
+      % runner->latency(XCL_BO_SYNC_BO_TO_DEVICE, latency_iterations)
+      % runner->latency(XCL_BO_SYNC_BO_FROM_DEVICE, latency_iterations);
+  }
+  logger(_ptTest, "Details", details.str());
+  return result;
+}
+
+// Log smallest transfer size reaching 90% of peak bandwidth per configuration
+static void
+log_dma_sweep_knee(const std::vector<dma_sweep_result>& results, boost::property_tree::ptree& _ptTest)
+{
+  std::vector<std::string> labels;
+  for (auto& r : results)
+    if (std::find(labels.begin(), labels.end(), r.label) == labels.end())
+      labels.push_back(r.label);
+
+  for (auto& label : labels) {
+    for (auto h2d : { true, false }) {
+      auto bw = [h2d](const dma_sweep_result& r) { return h2d ? r.h2d : r.d2h; };
+      double peak = 0;
+      for (auto& r : results)
+        if (r.label == label)
+          peak = std::max(peak, bw(r));
+
+      for (auto& r : results) {
+        if (r.label != label || bw(r) < 0.9 * peak)
+          continue;
+        logger(_ptTest, "Details", boost::str(boost::format("%s, %s knee: %s reaches 90%% of peak %.2f GB/s")
+                                              % label % (h2d ? "H2D" : "D2H") % size_to_string(r.size) % peak));
+        break;
+      }
+    }
+  }
+}
+
+/*
+ * TEST #14
+ */
+void
+dmaSweepTest(const std::shared_ptr<xrt_core::device>& _dev, boost::property_tree::ptree& _ptTest)
+{
+  _ptTest.put("status", test_token_skipped);
+  if(!search_and_program_xclbin(_dev, _ptTest)) {
+    return;
+  }
+
+  auto membuf = xrt_core::device_query<xrt_core::query::mem_topology_raw>(_dev);
+  auto mem_topo = reinterpret_cast<const mem_topology*>(membuf.data());
+
+  auto vendor = xrt_core::device_query<xrt_core::query::pcie_vendor>(_dev);
+  size_t max_total_size = (vendor == ARISTA_ID) ? 0x20000000 : 0x40000000;
+
+  // Usable device banks and the size in bytes of the smallest of them
+  std::vector<unsigned int> banks;
+  std::vector<std::string> bank_tags;
+  size_t min_bank_size = std::numeric_limits<size_t>::max();
+  for (auto& mem : boost::make_iterator_range(mem_topo->m_mem_data, mem_topo->m_mem_data + mem_topo->m_count)) {
+    std::string tag(reinterpret_cast<const char*>(mem.m_tag));
+    if (tag.compare(0,4,"HOST") == 0 || mem.m_type == MEM_STREAMING || !mem.m_used)
+      continue;
+    banks.push_back(static_cast<unsigned int>(std::distance(mem_topo->m_mem_data, &mem)));
+    bank_tags.push_back(tag);
+    min_bank_size = std::min<size_t>(min_bank_size, mem.m_size * 1024);
+  }
+  if (banks.empty())
+    return;
+
+  // Host buffers on the device local NUMA node and on one remote node
+  std::vector<std::pair<int, std::string>> placements;
+  int local_node = -1;
+  try {
+    local_node = std::stoi(xrt_core::device_query<xrt_core::query::numa_node>(_dev));
+  } catch (...) {}
+  auto nodes = get_numa_nodes();
+  if (local_node >= 0 && std::find(nodes.begin(), nodes.end(), local_node) != nodes.end()) {
+    placements.emplace_back(local_node, "local node " + std::to_string(local_node));
+    for (auto node : nodes) {
+      if (node != local_node) {
+        placements.emplace_back(node, "remote node " + std::to_string(node));
+        break;
+      }
+    }
+  }
+  else {
+    placements.emplace_back(-1, "any node");
+  }
+
+#ifdef __linux__
+  cpu_set_t saved_affinity;
+  sched_getaffinity(0, sizeof(saved_affinity), &saved_affinity);
+#endif
+
+  // 4 KiB to 1 GiB in steps of 4x, each point moves up to 256 MiB per bank
+  std::vector<dma_sweep_result> results;
+  try {
+    for (auto& placement : placements) {
+      if (placement.first >= 0 && !bind_to_numa_node(placement.first)) {
+        logger(_ptTest, "Warning", "Unable to place host buffers on " + placement.second);
+        continue;
+      }
+
+      for (size_t size = 0x1000; size <= max_total_size; size <<= 2) {
+        size_t total_size = std::max(size, std::min<size_t>(size * 1024, 0x10000000));
+        if (total_size > min_bank_size)
+          break;
+
+        for (size_t i = 0; i < banks.size(); i++)
+          results.push_back(run_dma_sweep_point(_dev, { banks[i] }, size, total_size,
+                                                bank_tags[i] + ", " + placement.second, _ptTest));
+        if (banks.size() > 1)
+          results.push_back(run_dma_sweep_point(_dev, banks, size, total_size,
+                                                "all banks, " + placement.second, _ptTest));
+      }
+    }
+    log_dma_sweep_knee(results, _ptTest);
+    _ptTest.put("status", test_token_passed);
+  }
+  catch (const std::exception& ex) {
+    _ptTest.put("status", test_token_failed);
+    logger(_ptTest, "Error", ex.what());
+  }
+
+#ifdef __linux__
+  sched_setaffinity(0, sizeof(saved_affinity), &saved_affinity);
+#endif
+}
+
 /*
 * helper function to initialize test info
 */
@@ -1260,6 +1516,8 @@ static std::vector<TestCollection> testSuite = {
   { create_init_test("m2m", "Run M2M test", "bandwidth.xclbin"), m2mTest },
   { create_init_test("hostmem-bw", "Run 'bandwidth kernel' when host memory is enabled", "bandwidth.xclbin"), hostMemBandwidthKernelTest },
   { create_init_test("bist", "Run BIST test", "verify.xclbin", true), bistTest },
+  { create_init_test("latency", "Run command latency percentile test", "verify.xclbin", true), latencyTest },
+  { create_init_test("dma-sweep", "Run dma bandwidth sweep over sizes, banks and NUMA nodes", "verify.xclbin", true), dmaSweepTest },
   { create_init_test("vcu", "Run decoder test", "transcode.xclbin"), vcuKernelTest }
 };
 
@@ -1458,7 +1716,7 @@ run_test_suite_device( const std::shared_ptr<xrt_core::device>& device,
     // Hack: Until we have an option in the tests to query SUPP/NOT SUPP
     // we need to print the test description before running the test
     auto is_black_box_test = [ptTest]() {
-      std::vector<std::string> black_box_tests = {"Verify kernel", "Bandwidth kernel", "iops", "vcu"};
+      std::vector<std::string> black_box_tests = {"Verify kernel", "Bandwidth kernel", "iops", "latency", "vcu"};
       auto test = ptTest.get<std::string>("name");
       return std::find(black_box_tests.begin(), black_box_tests.end(), test) != black_box_tests.end() ? true : false;
     };
@@ -20,6 +20,7 @@
 #include "SubCmdExamine.h"
 #include "SubCmdProgram.h"
 #include "SubCmdReset.h"
+#include "SubCmdTop.h"
 #include "SubCmdValidate.h"
 
 // Supporting tools
@@ -53,6 +54,7 @@ int main( int argc, char** argv )
 
 #ifdef ENABLE_NATIVE_SUBCMDS_AND_REPORTS
     subCommands.emplace_back(std::make_shared< SubCmdValidate >(false,  false, false));
+    subCommands.emplace_back(std::make_shared<     SubCmdTop  >(false,  false, false));
 #endif
 
     subCommands.emplace_back(std::make_shared< SubCmdAdvanced >(true,  false, true ));
@@ -162,8 +162,6 @@ static size_type num_cus         = 0;    // actual number of cus
 
 
 
-#define MAX_XGQ_CU    32
-
 #define MAJOR         1U
 #define MINOR         0U
 #define ERT_VER       ((MAJOR<<16) + MINOR)
@@ -337,7 +335,6 @@ setup_cu_queue()
 
          cu_xgq->offset = XGQ_OFFSET(xgq);
          cu_xgq->xgq_id = cu_idx;
-         cu_xgq->csr_reg = STATUS_REGISTER_ADDR[cu_idx>>5];
 
          xgq_cu_init(cu_xgq, xgq, cu);
       }
@@ -777,6 +774,8 @@ _scheduler_loop()
           continue;
         }
       }
+      // Report all completions of this pass together
+      xgq_cu_flush_completions(STATUS_REGISTER_ADDR);
     }
   } // while
 }
@@ -1,6 +1,7 @@
 #ifndef __SCHED_CU_H__
 #define __SCHED_CU_H__
 
+#include "ert.h"
 #include "sched_cmd.h"
 
 /* One CU. */
@@ -128,6 +129,45 @@ static inline int cu_start_kv(struct sched_cu *cu, struct sched_cmd *cu_cmd)
 	return 0;
 }
 
+/*
+ * Kick off CU using a stage of XGQ_CMD_OP_START_CUIDX_CHAIN cmd, with arguments
+ * patched from the registers of the CU of the previous stage. Expensive!
+ */
+static inline void cu_start_chain_stage(struct sched_cu *cu, struct sched_cu *prev,
+	uint64_t stage)
+{
+	uint32_t i;
+	uint32_t val[ERT_CHAIN_MAX_PATCHES];
+	uint32_t sz = reg_read(stage + sizeof(uint32_t));
+	/* num_args in [15-0], num_patches in [31-16], see struct ert_chain_stage */
+	uint32_t num_args = sz & 0xffff;
+	uint32_t num_patches = prev ? (sz >> 16) : 0;
+	uint64_t args = stage + 2 * sizeof(uint32_t);
+	uint64_t patches = args + num_args * sizeof(uint32_t);
+	uint64_t dst = cu->cu_addr + SCHED_CU_ARG_OFFSET;
+
+	if (num_patches > ERT_CHAIN_MAX_PATCHES)
+		num_patches = ERT_CHAIN_MAX_PATCHES;
+
+	/* Read all patches first, previous CU can be this CU. */
+	for (i = 0; i < num_patches; i++)
+		val[i] = reg_read(prev->cu_addr +
+			ERT_CHAIN_PATCH_SRC(reg_read(patches + i * sizeof(uint32_t))));
+
+	for (i = 0; i < num_args; i++)
+		reg_write(dst + i * sizeof(uint32_t), reg_read(args + i * sizeof(uint32_t)));
+
+	for (i = 0; i < num_patches; i++)
+		reg_write(cu->cu_addr +
+			ERT_CHAIN_PATCH_DST(reg_read(patches + i * sizeof(uint32_t))), val[i]);
+
+	/* Kick off CU. */
+	reg_write(cu->cu_addr, SCHED_AP_START);
+
+	cu_set_status(cu, SCHED_AP_START);
+	cu_clear_status(cu, SCHED_AP_WAIT_FOR_INPUT);
+}
+
 static inline void cu_done(struct sched_cu *cu)
 {
 	/* CU HW will clear AP_DONE on HW. */
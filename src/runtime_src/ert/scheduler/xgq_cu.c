@@ -6,10 +6,33 @@
  * XGQ CU handler (MODE 1 - One XGQ per CU).
  */
 extern uint32_t echo;
+extern struct xgq_cu cu_xgqs[MAX_XGQ_CU];
+
+/*
+ * Completed XGQs, one bit per XGQ in the layout of the CSR status
+ * registers. The scheduler loop writes them to the status registers
+ * once per pass over the CU queues, see xgq_cu_flush_completions(),
+ * so that CUs completing in the same pass are reported to the host
+ * with one register write and one interrupt.
+ */
+static uint32_t xgq_cu_completed[XGQ_CU_CSR_NUM];
 
 static inline void xgq_cu_interrupt_trigger(struct xgq_cu *xc, uint32_t xgq_id)
 {
-	reg_write(xc->csr_reg, (1<<xgq_id));
+	xgq_cu_completed[xgq_id >> 5] |= (1 << (xgq_id & 0x1f));
+}
+
+inline void xgq_cu_flush_completions(const uint32_t *csr_regs)
+{
+	uint32_t i;
+
+	for (i = 0; i < XGQ_CU_CSR_NUM; i++) {
+		if (!xgq_cu_completed[i])
+			continue;
+
+		reg_write(csr_regs[i], xgq_cu_completed[i]);
+		xgq_cu_completed[i] = 0;
+	}
 }
 
 inline void xgq_cu_init(struct xgq_cu *xc, struct xgq *q, struct sched_cu *cu)
@@ -19,6 +42,8 @@ inline void xgq_cu_init(struct xgq_cu *xc, struct xgq *q, struct sched_cu *cu)
 	xc->xc_q = q;
 	xc->xc_cu = cu;
 	xc->xc_cmd_running = 0;
+	xc->xc_chain_cu = NULL;
+	xc->xc_chain_owner = NULL;
 	cmd_set_addr(cmd, 0);
 	cmd_clear_header(cmd, 0);
 	cu_set_status(cu, SCHED_AP_IDLE);
@@ -37,8 +62,134 @@ static inline void xgq_cu_complete_cmd(struct xgq_cu *xc, int err)
 	xc->xc_cmd_running--;
 }
 
+/*
+ * Chain command (XGQ_CMD_OP_START_CUIDX_CHAIN).
+ *
+ * The first stage runs on the CU of this XGQ. When the chain is started,
+ * the CUs of the other stages are reserved, so their XGQs start no new
+ * commands, and a chain is only started when none of its CUs is used by
+ * another chain, so chains never wait on each other. The command slot is
+ * held until the CU of the last stage is done, this XGQ consumes no other
+ * command meanwhile.
+ */
+static inline uint64_t xgq_cu_chain_next_stage(uint64_t stage)
+{
+	uint32_t sz = reg_read(stage + sizeof(uint32_t));
+
+	/* num_args in [15-0], num_patches in [31-16], see struct ert_chain_stage */
+	return stage + (2 + (sz & 0xffff) + (sz >> 16)) * sizeof(uint32_t);
+}
+
+static inline struct xgq_cu *xgq_cu_chain_stage_xgq(uint64_t stage)
+{
+	uint32_t cu_idx = reg_read(stage);
+
+	if (cu_idx >= MAX_XGQ_CU || !cu_xgqs[cu_idx].xc_cu)
+		return NULL;
+	return &cu_xgqs[cu_idx];
+}
+
+/* Reserve, or release if owner is NULL, the CUs of the stages after the first. */
+static inline void xgq_cu_chain_reserve(struct xgq_cu *xc, uint64_t stage,
+	uint32_t num_stages, struct xgq_cu *owner)
+{
+	struct xgq_cu *sxc;
+	uint32_t i;
+
+	for (i = 1; i < num_stages; i++) {
+		stage = xgq_cu_chain_next_stage(stage);
+		sxc = xgq_cu_chain_stage_xgq(stage);
+		if (sxc != xc)
+			sxc->xc_chain_owner = owner;
+	}
+}
+
+static inline int xgq_cu_chain_start(struct xgq_cu *xc, struct sched_cmd *cmd)
+{
+	struct xgq_cmd_start_cuidx_chain *chain =
+		(struct xgq_cmd_start_cuidx_chain *)(uintptr_t)cmd->cc_addr;
+	uint64_t first = (uint64_t)(uintptr_t)chain->data;
+	uint32_t num_stages = reg_read((uint64_t)(uintptr_t)&chain->num_stages);
+	uint64_t stage = first;
+	struct xgq_cu *sxc;
+	uint32_t i;
+
+	if (!num_stages)
+		return -EINVAL;
+
+	for (i = 1; i < num_stages; i++) {
+		stage = xgq_cu_chain_next_stage(stage);
+		sxc = xgq_cu_chain_stage_xgq(stage);
+		if (!sxc)
+			return -EINVAL;
+		if (sxc != xc && (sxc->xc_chain_owner || sxc->xc_chain_cu))
+			return -EBUSY;
+	}
+	xgq_cu_chain_reserve(xc, first, num_stages, xc);
+
+	cu_start_chain_stage(xc->xc_cu, NULL, first);
+
+	xc->xc_chain_cu = xc;
+	xc->xc_chain_stage = xgq_cu_chain_next_stage(first);
+	xc->xc_chain_left = num_stages - 1;
+	return 0;
+}
+
+static inline void xgq_cu_chain_end(struct xgq_cu *xc)
+{
+	struct xgq_cmd_start_cuidx_chain *chain =
+		(struct xgq_cmd_start_cuidx_chain *)(uintptr_t)xc->xc_cmd.cc_addr;
+
+	cu_done(xc->xc_chain_cu->xc_cu);
+	xgq_cu_chain_reserve(xc, (uint64_t)(uintptr_t)chain->data,
+		reg_read((uint64_t)(uintptr_t)&chain->num_stages), NULL);
+	xc->xc_chain_cu = NULL;
+
+	/* Let peer know that we are done with the chain cmd slot. */
+	xgq_notify_peer_consumed(xc->xc_q);
+	xgq_cu_complete_cmd(xc, 0);
+}
+
+/* Start the next stage once the CU of the current stage is done. */
+static inline int xgq_cu_chain_process(struct xgq_cu *xc)
+{
+	struct sched_cu *cu = xc->xc_chain_cu->xc_cu;
+	struct xgq_cu *next;
+
+	/* AP_DONE is cached, reading it again from HW might clear it. */
+	if (!cu_has_status(cu, SCHED_AP_DONE))
+		cu_load_status(cu);
+	if (!cu_has_status(cu, SCHED_AP_DONE))
+		return -EBUSY;
+
+	if (!xc->xc_chain_left) {
+		xgq_cu_chain_end(xc);
+		return 0;
+	}
+
+	/* Wait for commands the next XGQ started before its CU was reserved. */
+	next = xgq_cu_chain_stage_xgq(xc->xc_chain_stage);
+	if (next != xc && next->xc_cmd_running)
+		return -EBUSY;
+
+	cu_done(cu);
+	cu_start_chain_stage(next->xc_cu, cu, xc->xc_chain_stage);
+
+	xc->xc_chain_cu = next;
+	xc->xc_chain_stage = xgq_cu_chain_next_stage(xc->xc_chain_stage);
+	xc->xc_chain_left--;
+	return 0;
+}
+
 inline int xgq_cu_process(struct xgq_cu *xc)
 {
+	if (unlikely(xc->xc_chain_cu))
+		return xgq_cu_chain_process(xc);
+
+	/* CU reserved by a chain, only finish commands already started. */
+	if (unlikely(xc->xc_chain_owner && !xc->xc_cmd_running))
+		return -EBUSY;
+
 	int rc = 0;
 	uint64_t addr = 0;
 	struct sched_cu *cu = xc->xc_cu;
@@ -88,7 +239,8 @@ inline int xgq_cu_process(struct xgq_cu *xc)
 
 	}
 
-	if (unlikely(!cmd_is_valid(cmd) || !cu_has_status(cu, SCHED_AP_WAIT_FOR_INPUT)))
+	if (unlikely(!cmd_is_valid(cmd) || !cu_has_status(cu, SCHED_AP_WAIT_FOR_INPUT) ||
+		xc->xc_chain_owner))
 		return -EBUSY;
 
 	switch (cmd_op_code(cmd)) {
@@ -124,6 +276,20 @@ inline int xgq_cu_process(struct xgq_cu *xc)
         rc = cu_init_kv(cu, cmd);
 #endif
         break;
+	case XGQ_CMD_OP_START_CUIDX_CHAIN:
+		/* Chain completes after the commands started before it. */
+		if (xc->xc_cmd_running)
+			return -EBUSY;
+		rc = xgq_cu_chain_start(xc, cmd);
+		if (rc == -EBUSY)
+			return rc;
+		if (likely(!rc)) {
+			/* Cmd slot is released when the chain is done. */
+			cmd_clear_header(cmd, 0);
+			xc->xc_cmd_running++;
+			return 0;
+		}
+		break;
 	default:
 		rc = -ENOTTY;
 		break;
@@ -16,10 +16,21 @@ struct xgq_cu {
 	uint32_t xc_cmd_running;
 	uint32_t offset;
 	uint32_t xgq_id;
-	uint32_t csr_reg;
+	/* Chain command running on this XGQ */
+	struct xgq_cu *xc_chain_cu;	/* XGQ of the CU running the current stage */
+	uint64_t xc_chain_stage;	/* next stage */
+	uint32_t xc_chain_left;		/* stages not started yet */
+	/* XGQ running a chain command, which reserved the CU of this XGQ */
+	struct xgq_cu *xc_chain_owner;
 };
 
+#define MAX_XGQ_CU	32
+
+/* Number of CSR status registers, 32 XGQs per register. */
+#define XGQ_CU_CSR_NUM	4
+
 extern void xgq_cu_init(struct xgq_cu *xc, struct xgq *q, struct sched_cu *cu);
 extern int xgq_cu_process(struct xgq_cu *xc);
+extern void xgq_cu_flush_completions(const uint32_t *csr_regs);
 
 #endif /* __XGQ_CU_H__ */
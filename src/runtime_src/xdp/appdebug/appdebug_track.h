@@ -25,16 +25,44 @@
 #include "xocl/core/command_queue.h"
 #include "xocl/core/execution_context.h"
 #include "core/include/experimental/xrt_kernel.h"
+#include <array>
+#include <cstdint>
 #include <utility>
 #include <string>
 #include <set>
 #include <map>
 #include <mutex>
+#include <vector>
 
 namespace appdebug {
 void cb_scheduler_cmd_start (const xocl::execution_context*, const xrt::run&);
 void cb_scheduler_cmd_done (const xocl::execution_context*, const xrt::run&);
 
+//The tracked objects are spread over shards by address, each shard with
+//its own lock, so threads creating and releasing objects rarely wait on
+//each other. Debug functions that need all the objects lock every shard.
+constexpr unsigned int track_shard_bits = 4;
+constexpr size_t num_track_shards = size_t(1) << track_shard_bits;
+
+inline size_t track_shard (const void* aObj) {
+  //Fibonacci hashing, so objects allocated next to each other spread out
+  uint64_t addr = reinterpret_cast<uintptr_t>(aObj);
+  return static_cast<size_t>((addr * 0x9E3779B97F4A7C15ull) >> (64 - track_shard_bits));
+}
+
+//Debug functions should never suspend, so throw if any shard is busy
+template <typename Shards>
+std::vector<std::unique_lock<std::mutex>> try_lock_shards (Shards& shards) {
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve(shards.size());
+  for (auto& shard : shards) {
+    locks.emplace_back(shard.m_mutex, std::try_to_lock);
+    if (!locks.back().owns_lock())
+      throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on data structure");
+  }
+  return locks;
+}
+
 template <typename T>
 class app_debug_track {
 public:
@@ -50,24 +78,27 @@ public:
   //these can suspend to get access to the data structure
   void add_object (T aObj) {
     if (m_set) {
-      std::lock_guard<std::mutex> lk (m_mutex);
-      m_objs.insert(aObj);
+      auto& shard = get_shard(aObj);
+      std::lock_guard<std::mutex> lk (shard.m_mutex);
+      shard.m_objs.insert(aObj);
     }
   }
   void remove_object (T aObj) {
     if (m_set) {
-      std::lock_guard<std::mutex> lk (m_mutex);
-      m_objs.erase(aObj);
+      auto& shard = get_shard(aObj);
+      std::lock_guard<std::mutex> lk (shard.m_mutex);
+      shard.m_objs.erase(aObj);
     }
   }
 
   //Following 2 function called during debug by user, this should never suspend
   void validate_object (T aObj) {
     if (m_set) {
-      std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
+      auto& shard = get_shard(aObj);
+      std::unique_lock<std::mutex> lk(shard.m_mutex, std::defer_lock);
       if (!lk.try_lock())
         throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on data structure");
-      if (m_objs.find(aObj) == m_objs.end() )
+      if (shard.m_objs.find(aObj) == shard.m_objs.end() )
         throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Unknown OpenCL object");
     }
     else {
@@ -77,10 +108,9 @@ public:
 
   void for_each(std::function<void(T aObj)>&& fn) {
     if (m_set) {
-      std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
-      if (!lk.try_lock())
-        throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on data structure");
-      std::for_each(m_objs.begin(), m_objs.end(), fn);
+      auto locks = try_lock_shards(m_shards);
+      for (auto& shard : m_shards)
+        std::for_each(shard.m_objs.begin(), shard.m_objs.end(), fn);
     }
     else {
       throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Invalid object tracker");
@@ -91,8 +121,14 @@ public:
   //disallow access to the data structure after the object is deleted
   static bool m_set;
 private:
-  std::set <T> m_objs;
-  std::mutex m_mutex;
+  struct shard_t {
+    std::set <T> m_objs;
+    std::mutex m_mutex;
+  };
+  shard_t& get_shard (T aObj) {
+    return m_shards[track_shard(aObj)];
+  }
+  std::array<shard_t, num_track_shards> m_shards;
 };
 
 template <>
@@ -118,14 +154,16 @@ public:
   //these can suspend to get access to the data structure
   void add_object (cl_event aObj) {
     if (m_set) {
-      std::lock_guard<std::mutex> lk (m_mutex);
-      m_objs.insert(std::pair<cl_event, event_data_t>(aObj, event_data_t()));
+      auto& shard = get_shard(aObj);
+      std::lock_guard<std::mutex> lk (shard.m_mutex);
+      shard.m_objs.insert(std::pair<cl_event, event_data_t>(aObj, event_data_t()));
     }
   }
   void remove_object (cl_event aObj) {
     if (m_set) {
-      std::lock_guard<std::mutex> lk (m_mutex);
-      m_objs.erase(aObj);
+      auto& shard = get_shard(aObj);
+      std::lock_guard<std::mutex> lk (shard.m_mutex);
+      shard.m_objs.erase(aObj);
     }
   }
 
@@ -134,19 +172,22 @@ public:
     if (!m_set)
       throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Appdebug singleton is deleted");
 
-    std::lock_guard<std::mutex> lk (m_mutex);
-    if (m_objs.find(aObj) == m_objs.end() )
+    auto& shard = get_shard(aObj);
+    std::lock_guard<std::mutex> lk (shard.m_mutex);
+    auto it = shard.m_objs.find(aObj);
+    if (it == shard.m_objs.end() )
       throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Unknown OpenCL object");
-    return m_objs[aObj];
+    return it->second;
   }
 
   //Following 2 function called during debug by user, this should never suspend
   void validate_object (cl_event aObj) {
     if (m_set) {
-      std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
+      auto& shard = get_shard(aObj);
+      std::unique_lock<std::mutex> lk(shard.m_mutex, std::defer_lock);
       if (!lk.try_lock())
         throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on data structure");
-      if (m_objs.find(aObj) == m_objs.end() )
+      if (shard.m_objs.find(aObj) == shard.m_objs.end() )
         throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Unknown OpenCL object");
     }
     else {
@@ -156,12 +197,11 @@ public:
 
   void for_each(std::function<void(cl_event aObj)>&& fn) {
     if (m_set) {
-      std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
-      if (!lk.try_lock())
-        throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on data structure");
-      //std::for_each(m_objs.begin(), m_objs.end(), fn);
-      for (auto it = m_objs.begin(); it!=m_objs.end(); ++it) {
-        fn(it->first);
+      auto locks = try_lock_shards(m_shards);
+      for (auto& shard : m_shards) {
+        for (auto it = shard.m_objs.begin(); it!=shard.m_objs.end(); ++it) {
+          fn(it->first);
+        }
       }
     }
     else {
@@ -173,12 +213,14 @@ public:
     if (!m_set)
       throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Appdebug singleton is deleted");
 
-    std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
+    auto& shard = get_shard(aObj);
+    std::unique_lock<std::mutex> lk(shard.m_mutex, std::defer_lock);
     if (!lk.try_lock())
       throw xocl::error(DBG_EXCEPT_LOCK_FAILED, "Failed to secure lock on data structure");
-    if (m_objs.find(aObj) == m_objs.end() )
+    auto it = shard.m_objs.find(aObj);
+    if (it == shard.m_objs.end() )
       throw xocl::error(DBG_EXCEPT_INVALID_OBJECT, "Unknown OpenCL object");
-    return m_objs[aObj];
+    return it->second;
   }
 
   //When the program exits, the static singleton object could get deleted
@@ -186,8 +228,14 @@ public:
   //disallow access to the data structure after the object is deleted
   static bool m_set;
 private:
-  std::map<cl_event, event_data_t> m_objs;
-  std::mutex m_mutex;
+  struct shard_t {
+    std::map<cl_event, event_data_t> m_objs;
+    std::mutex m_mutex;
+  };
+  shard_t& get_shard (const cl_event aObj) {
+    return m_shards[track_shard(aObj)];
+  }
+  std::array<shard_t, num_track_shards> m_shards;
 };
 ////////////////////////Command queue////////////////////
 inline
@@ -0,0 +1,148 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_AIE_SAMPLE_LOG_DOT_H
+#define VP_AIE_SAMPLE_LOG_DOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xdp {
+
+  // The AIE counter samples of one device, stored by column in chunks of
+  //  fixed size.  The polling thread of the device is the only writer.
+  //  It appends the counters read in one sweep and then publishes them
+  //  with a single release store, so writers can read all published
+  //  samples at any time without a lock.  Appending only allocates when
+  //  a chunk is full.
+  class AIESampleLog
+  {
+  public:
+    static constexpr size_t chunkSize = 4096 ;
+
+    struct Sample
+    {
+      double timestamp ; // ms
+      uint16_t column ;
+      uint16_t row ;
+      uint16_t startEvent ;
+      uint16_t endEvent ;
+      uint8_t  resetEvent ;
+      uint32_t value ;
+      uint64_t timer ;
+      uint32_t payload ;
+    } ;
+
+  private:
+    struct Chunk
+    {
+      double   timestamp[chunkSize] ;
+      uint16_t column[chunkSize] ;
+      uint16_t row[chunkSize] ;
+      uint16_t startEvent[chunkSize] ;
+      uint16_t endEvent[chunkSize] ;
+      uint8_t  resetEvent[chunkSize] ;
+      uint32_t value[chunkSize] ;
+      uint64_t timer[chunkSize] ;
+      uint32_t payload[chunkSize] ;
+      std::atomic<Chunk*> next ;
+
+      Chunk() : next(nullptr) { }
+    } ;
+
+    Chunk* first ;
+
+    // Only used by the polling thread
+    Chunk* tail ;
+    size_t tailCount ;
+    uint64_t appended ;
+
+    std::atomic<uint64_t> published ;
+
+  public:
+    AIESampleLog() : first(new Chunk), tailCount(0), appended(0), published(0)
+    {
+      tail = first ;
+    }
+
+    ~AIESampleLog()
+    {
+      Chunk* c = first ;
+      while (c != nullptr) {
+        Chunk* next = c->next.load(std::memory_order_relaxed) ;
+        delete c ;
+        c = next ;
+      }
+    }
+
+    AIESampleLog(const AIESampleLog&) = delete ;
+    AIESampleLog& operator=(const AIESampleLog&) = delete ;
+
+    void append(double timestamp, uint16_t column, uint16_t row,
+                uint16_t startEvent, uint16_t endEvent, uint8_t resetEvent,
+                uint32_t value, uint64_t timer, uint32_t payload)
+    {
+      if (tailCount == chunkSize) {
+        Chunk* c = new Chunk ;
+        tail->next.store(c, std::memory_order_release) ;
+        tail = c ;
+        tailCount = 0 ;
+      }
+      size_t i = tailCount++ ;
+      tail->timestamp[i]  = timestamp ;
+      tail->column[i]     = column ;
+      tail->row[i]        = row ;
+      tail->startEvent[i] = startEvent ;
+      tail->endEvent[i]   = endEvent ;
+      tail->resetEvent[i] = resetEvent ;
+      tail->value[i]      = value ;
+      tail->timer[i]      = timer ;
+      tail->payload[i]    = payload ;
+      ++appended ;
+    }
+
+    // Make the samples appended so far visible to readers
+    void publish()
+    {
+      published.store(appended, std::memory_order_release) ;
+    }
+
+    uint64_t size() const { return published.load(std::memory_order_acquire) ; }
+
+    // Call f with every published sample, in the order appended
+    template <typename Function>
+    void forEach(Function f) const
+    {
+      uint64_t n = size() ;
+      const Chunk* c = first ;
+      while (n > 0 && c != nullptr) {
+        size_t count = n < chunkSize ? static_cast<size_t>(n) : chunkSize ;
+        for (size_t i = 0 ; i < count ; ++i) {
+          Sample s = { c->timestamp[i], c->column[i], c->row[i],
+                       c->startEvent[i], c->endEvent[i], c->resetEvent[i],
+                       c->value[i], c->timer[i], c->payload[i] } ;
+          f(s) ;
+        }
+        n -= count ;
+        c = c->next.load(std::memory_order_acquire) ;
+      }
+    }
+  } ;
+
+} // end namespace xdp
+
+#endif
@@ -20,15 +20,57 @@
 #include "xdp/profile/database/dynamic_event_database.h"
 #include "xdp/profile/database/events/device_events.h"
 
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
 #include "core/common/time.h"
 
+#include <algorithm>
 #include <iostream>
 
+namespace {
+
+  void appendVarint(std::vector<uint8_t>& buf, uint64_t value)
+  {
+    while (value >= 0x80) {
+      buf.push_back(static_cast<uint8_t>(value | 0x80)) ;
+      value >>= 7 ;
+    }
+    buf.push_back(static_cast<uint8_t>(value)) ;
+  }
+
+  uint64_t extractVarint(const std::vector<uint8_t>& buf, size_t& pos)
+  {
+    uint64_t value = 0 ;
+    unsigned int shift = 0 ;
+    while (pos < buf.size()) {
+      uint8_t byte = buf[pos++] ;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift ;
+      if (!(byte & 0x80))
+        break ;
+      shift += 7 ;
+    }
+    return value ;
+  }
+
+} // end anonymous namespace
+
 namespace xdp {
   
   VPDynamicDatabase::VPDynamicDatabase(VPDatabase* d) :
-    db(d), eventId(1), stringId(1)
+    db(d), eventId(1), removedEvents(0), droppedEvents(0),
+    deviceEventStartMap(NumDeviceTraceIDs),
+    stringBuckets(new std::atomic<StringEntry*>[numStringBuckets]),
+    stringId(1),
+    stringPointerCache(new std::atomic<StringEntry*>[numStringPointerSlots])
   {
+    for (size_t i = 0 ; i < numStringBuckets ; ++i)
+      stringBuckets[i].store(nullptr, std::memory_order_relaxed) ;
+    for (size_t i = 0 ; i < numStringPointerSlots ; ++i)
+      stringPointerCache[i].store(nullptr, std::memory_order_relaxed) ;
+
+    eventLimit = static_cast<uint64_t>(xrt_core::config::get_trace_memory_limit_mb())
+                 * 1024 * 1024 / ApproxEventSize ;
+
     // For low overhead profiling, we will reserve space for 
     //  a set number of events.  This won't change HAL or OpenCL 
     //  profiling either.
@@ -50,6 +92,7 @@ namespace xdp {
 
     {
       std::lock_guard<std::mutex> lock(hostEventsLock) ;
+      mergeHostEvents() ;
       for (auto event : hostEvents) {
       delete event.second;
       }
@@ -71,30 +114,76 @@ namespace xdp {
     addDeviceEvent(deviceId, new XclbinEnd(0, (double)(xrt_core::time_ns())/1e6, 0, 0)) ;
   }
 
+  VPDynamicDatabase::HostEventBuffer* VPDynamicDatabase::getHostEventBuffer()
+  {
+    // Each thread registers its buffer the first time it logs an event
+    thread_local VPDynamicDatabase* owner = nullptr ;
+    thread_local HostEventBuffer* buffer = nullptr ;
+    if (owner == this)
+      return buffer ;
+
+    std::lock_guard<std::mutex> lock(hostEventBuffersLock) ;
+    hostEventBuffers.emplace_back(std::make_unique<HostEventBuffer>()) ;
+    owner = this ;
+    buffer = hostEventBuffers.back().get() ;
+    return buffer ;
+  }
+
   void VPDynamicDatabase::addHostEvent(VTFEvent* event)
   {
-    std::lock_guard<std::mutex> lock(hostEventsLock) ;
+    uint64_t id = eventId++ ;
+    event->setEventId(id) ;
+    {
+      HostEventBuffer* buffer = getHostEventBuffer() ;
+      std::lock_guard<std::mutex> lock(buffer->lock) ;
+      buffer->events.push_back(event) ;
+    }
+    checkEventLimit(id) ;
+  }
 
-    event->setEventId(eventId++) ;
-    hostEvents.emplace(event->getTimestamp(), event) ;
-    //hostEvents.push_back(event) ;
+  void VPDynamicDatabase::mergeHostEvents()
+  {
+    std::vector<VTFEvent*> events ;
+    {
+      std::lock_guard<std::mutex> lock(hostEventBuffersLock) ;
+      for (auto& buffer : hostEventBuffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->lock) ;
+        events.insert(events.end(), buffer->events.begin(), buffer->events.end()) ;
+        buffer->events.clear() ;
+      }
+    }
+
+    // Sort the new events once, so inserting with a hint at the end is
+    //  constant time whenever they are later than the events already
+    //  in hostEvents
+    std::stable_sort(events.begin(), events.end(),
+                     [](VTFEvent* l, VTFEvent* r)
+                     { return l->getTimestamp() < r->getTimestamp() ; }) ;
+    for (auto event : events)
+      hostEvents.emplace_hint(hostEvents.end(), event->getTimestamp(), event) ;
   }
 
   void VPDynamicDatabase::addUnsortedEvent(VTFEvent* event)
   {
-    std::lock_guard<std::mutex> lock(unsortedEventsLock) ;
-    event->setEventId(eventId++) ;
+    uint64_t id = eventId++ ;
+    {
+      std::lock_guard<std::mutex> lock(unsortedEventsLock) ;
+      event->setEventId(id) ;
 
-    unsortedHostEvents.push_back(event) ;
+      unsortedHostEvents.push_back(event) ;
+    }
+    checkEventLimit(id) ;
   }
 
   void VPDynamicDatabase::addDeviceEvent(uint64_t deviceId, VTFEvent* event)
   {
     bool overLimit = false ;
+    uint64_t id = 0 ;
     {
       std::lock_guard<std::mutex> lock(deviceEventsLock) ;
 
-      event->setEventId(eventId++) ;
+      id = eventId++ ;
+      event->setEventId(id) ;
       deviceEvents[deviceId].emplace(event->getTimestamp(), event) ;
       if (deviceEvents[deviceId].size() > DeviceEventThreshold) {
         overLimit = true ;
@@ -104,6 +193,86 @@ namespace xdp {
     if (overLimit) {
       db->broadcast(VPDatabase::DUMP_TRACE) ;
     }
+    checkEventLimit(id) ;
+  }
+
+  void VPDynamicDatabase::checkEventLimit(uint64_t id)
+  {
+    // Ids up to id have been handed out, so more than eventLimit events
+    //  are retained if fewer than id - eventLimit have been removed
+    if (eventLimit != 0 && id > removedEvents + eventLimit)
+      evictOldestEvents() ;
+  }
+
+  std::unique_lock<std::mutex> VPDynamicDatabase::holdEvents()
+  {
+    return std::unique_lock<std::mutex>(evictLock) ;
+  }
+
+  // Drop the same fraction of the oldest events of the host and of every
+  //  device, until the retained events are 10% below the limit so that
+  //  eviction does not run for every new event.  Host and device
+  //  timestamps are in different units, so the oldest events across
+  //  all of them cannot be compared directly.
+  void VPDynamicDatabase::evictOldestEvents()
+  {
+    // If another thread is evicting, or a writer is using the events,
+    //  try again on a later event
+    std::unique_lock<std::mutex> evictGuard(evictLock, std::try_to_lock) ;
+    if (!evictGuard.owns_lock())
+      return ;
+
+    uint64_t handedOut = eventId - 1 ;
+    uint64_t retained = handedOut - removedEvents ;
+    if (retained <= eventLimit)
+      return ;
+    uint64_t target = eventLimit - (eventLimit / 10) ;
+    double fraction = static_cast<double>(retained - target) / retained ;
+
+    uint64_t dropped = 0 ;
+    {
+      std::lock_guard<std::mutex> lock(hostEventsLock) ;
+      mergeHostEvents() ;
+      auto count = static_cast<uint64_t>(hostEvents.size() * fraction) ;
+      for (uint64_t i = 0 ; i < count ; ++i) {
+        delete hostEvents.begin()->second ;
+        hostEvents.erase(hostEvents.begin()) ;
+      }
+      dropped += count ;
+    }
+    {
+      std::lock_guard<std::mutex> lock(unsortedEventsLock) ;
+      auto count = static_cast<uint64_t>(unsortedHostEvents.size() * fraction) ;
+      for (uint64_t i = 0 ; i < count ; ++i)
+        delete unsortedHostEvents[i] ;
+      unsortedHostEvents.erase(unsortedHostEvents.begin(),
+                               unsortedHostEvents.begin() + count) ;
+      dropped += count ;
+    }
+    {
+      std::lock_guard<std::mutex> lock(deviceEventsLock) ;
+      for (auto& device : deviceEvents) {
+        auto& events = device.second ;
+        auto count = static_cast<uint64_t>(events.size() * fraction) ;
+        for (auto it = events.begin() ; it != events.end() && count > 0 ; ) {
+          // The device trace writers rely on the xclbin end markers
+          if (it->second->getEventType() == XCLBIN_END) {
+            ++it ;
+            continue ;
+          }
+          delete it->second ;
+          it = events.erase(it) ;
+          --count ;
+          ++dropped ;
+        }
+      }
+    }
+
+    removedEvents += dropped ;
+    if (droppedEvents.fetch_add(dropped) == 0 && dropped != 0) {
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+        "Trace memory limit reached, the oldest trace events are dropped.  Set Debug.trace_memory_limit_mb in xrt.ini to retain more events.") ;
+    }
   }
 
   void VPDynamicDatabase::addEvent(VTFEvent* event)
@@ -123,6 +292,8 @@ namespace xdp {
   void VPDynamicDatabase::markDeviceEventStart(uint64_t traceID,
     std::tuple<VTFEventType, uint64_t, double, uint64_t> info)
   {
+    if (traceID >= NumDeviceTraceIDs)
+      return ;
     std::lock_guard<std::mutex> lock(deviceLock) ;
     deviceEventStartMap[traceID].push_back(info) ;
   }
@@ -130,36 +301,30 @@ namespace xdp {
   std::tuple<VTFEventType, uint64_t, double, uint64_t>
   VPDynamicDatabase::matchingDeviceEventStart(uint64_t traceID, VTFEventType type)
   {
-    std::lock_guard<std::mutex> lock(deviceLock) ;
     std::tuple<VTFEventType, uint64_t, double, uint64_t> startEvent ;
     std::get<0>(startEvent) = UNKNOWN_EVENT ;
     std::get<1>(startEvent) = 0 ;
     std::get<2>(startEvent) = 0.0 ;
     std::get<3>(startEvent) = 0 ;
-    auto& lst = deviceEventStartMap[traceID] ;
-    if (!lst.empty()) {
-      for (auto iter = lst.begin() ; iter != lst.end() ; ++iter) {
-        if (std::get<0>(*iter) == type) {
-          startEvent = (*iter);
-          lst.erase(iter);
-          break;
-	}
-      }
-    }
+    if (traceID >= NumDeviceTraceIDs)
+      return startEvent ;
+
+    std::lock_guard<std::mutex> lock(deviceLock) ;
+    auto match = [type](const std::tuple<VTFEventType, uint64_t, double, uint64_t>& e)
+                 { return std::get<0>(e) == type ; } ;
+    deviceEventStartMap[traceID].take(match, startEvent) ;
     return startEvent ;
   }
 
   bool VPDynamicDatabase::hasMatchingDeviceEventStart(uint64_t traceID, VTFEventType type)
   {
-    std::lock_guard<std::mutex> lock(deviceLock) ;
-    if (deviceEventStartMap.find(traceID) == deviceEventStartMap.end())
+    if (traceID >= NumDeviceTraceIDs)
       return false ;
-    auto& lst = deviceEventStartMap[traceID] ;
-    for (auto e : lst) {
-      if (std::get<0>(e) == type)
-        return true ;
-    }
-    return false ;
+
+    std::lock_guard<std::mutex> lock(deviceLock) ;
+    auto match = [type](const std::tuple<VTFEventType, uint64_t, double, uint64_t>& e)
+                 { return std::get<0>(e) == type ; } ;
+    return deviceEventStartMap[traceID].find(match) != nullptr ;
   }
 
   void VPDynamicDatabase::markStart(uint64_t functionID, uint64_t eventID)
@@ -224,13 +389,67 @@ namespace xdp {
     return value ;
   }
 
-  uint64_t VPDynamicDatabase::addString(const std::string& value)
+  VPDynamicDatabase::StringEntry*
+  VPDynamicDatabase::findString(std::string_view value, size_t hash)
+  {
+    StringEntry* entry =
+      stringBuckets[hash % numStringBuckets].load(std::memory_order_acquire) ;
+    for ( ; entry != nullptr ; entry = entry->next)
+      if (entry->value == value)
+        return entry ;
+    return nullptr ;
+  }
+
+  VPDynamicDatabase::StringEntry*
+  VPDynamicDatabase::internString(std::string_view value)
   {
+    size_t hash = std::hash<std::string_view>()(value) ;
+    if (StringEntry* entry = findString(value, hash))
+      return entry ;
+
     std::lock_guard<std::mutex> lock(stringLock) ;
-    if (stringTable.find(value) == stringTable.end()) {
-      stringTable[value] = stringId++ ;
-    }
-    return stringTable[value] ;
+    // Another thread may have added the string in the meantime
+    if (StringEntry* entry = findString(value, hash))
+      return entry ;
+
+    auto& bucket = stringBuckets[hash % numStringBuckets] ;
+    auto entry = std::make_unique<StringEntry>() ;
+    entry->value = std::string(value) ;
+    entry->id = stringId++ ;
+    entry->next = bucket.load(std::memory_order_relaxed) ;
+    // Publish the entry only once it is complete
+    bucket.store(entry.get(), std::memory_order_release) ;
+    stringIndex.push_back(std::move(entry)) ;
+    return stringIndex.back().get() ;
+  }
+
+  uint64_t VPDynamicDatabase::addString(std::string_view value)
+  {
+    return internString(value)->id ;
+  }
+
+  uint64_t VPDynamicDatabase::addString(const char* value)
+  {
+    auto slot =
+      (reinterpret_cast<uintptr_t>(value) >> 3) % numStringPointerSlots ;
+    StringEntry* cached =
+      stringPointerCache[slot].load(std::memory_order_acquire) ;
+    // The memory at this address may hold a different string by now
+    if (cached != nullptr && cached->value.compare(value) == 0)
+      return cached->id ;
+
+    StringEntry* entry = internString(value) ;
+    stringPointerCache[slot].store(entry, std::memory_order_release) ;
+    return entry->id ;
+  }
+
+  std::string VPDynamicDatabase::getString(uint64_t id)
+  {
+    std::lock_guard<std::mutex> lock(stringLock) ;
+    // String ids start at 1
+    if (id == 0 || id > stringIndex.size())
+      return "" ;
+    return stringIndex[id - 1]->value ;
   }
 
   // This needs to be sped up significantly.
@@ -241,6 +460,7 @@ namespace xdp {
     // For now, go through both host events and device events.
     {
       std::lock_guard<std::mutex> lock(hostEventsLock) ;
+      mergeHostEvents() ;
       for (auto e : hostEvents) {
         if (filter(e.second)) collected.push_back(e.second) ;
       }
@@ -261,6 +481,7 @@ namespace xdp {
   std::vector<VTFEvent*> VPDynamicDatabase::filterHostEvents(std::function<bool(VTFEvent*)> filter)
   {
     std::lock_guard<std::mutex> lock(hostEventsLock) ;
+    mergeHostEvents() ;
     std::vector<VTFEvent*> collected ;
 
     for (auto e : hostEvents)
@@ -273,6 +494,7 @@ namespace xdp {
   std::vector<std::unique_ptr<VTFEvent>> VPDynamicDatabase::filterEraseHostEvents(std::function<bool(VTFEvent*)> filter)
   {
     std::lock_guard<std::mutex> lock(hostEventsLock) ;
+    mergeHostEvents() ;
     std::vector<std::unique_ptr<VTFEvent>> collected ;
 
     for (auto it=hostEvents.begin(); it!=hostEvents.end();) {
@@ -283,6 +505,7 @@ namespace xdp {
         ++it;
       }
     }
+    removedEvents += collected.size() ;
     return collected ;
   }
 
@@ -301,12 +524,14 @@ namespace xdp {
         ++it ;
       }
     }
+    removedEvents += collected.size() ;
     return collected ;
   }
 
   std::vector<VTFEvent*> VPDynamicDatabase::getHostEvents()
   {
     std::lock_guard<std::mutex> lock(hostEventsLock) ;
+    mergeHostEvents() ;
     std::vector<VTFEvent*> events;
     for(auto e : hostEvents) {
       events.push_back(e.second);
@@ -317,6 +542,7 @@ namespace xdp {
   bool VPDynamicDatabase::hostEventsExist(std::function<bool(VTFEvent*)> filter)
   {
     std::lock_guard<std::mutex> lock(hostEventsLock) ;
+    mergeHostEvents() ;
     for (auto it=hostEvents.begin(); it!=hostEvents.end(); it++) {
       if (filter(it->second))
         return true;
@@ -354,6 +580,7 @@ namespace xdp {
       events.emplace_back(it->second);
       it = mmap.erase(it);
     }
+    removedEvents += events.size() ;
     return events;
   }
 
@@ -361,9 +588,9 @@ namespace xdp {
   {
     std::lock_guard<std::mutex> lock(stringLock) ;
     // Windows compilation fails unless c_str() is used
-    for (auto s : stringTable)
+    for (auto& s : stringIndex)
     {
-      fout << s.second << "," << s.first.c_str() << std::endl ;
+      fout << s->id << "," << s->value.c_str() << std::endl ;
     }
   }
 
@@ -483,71 +710,89 @@ namespace xdp {
     return powerSamples[deviceId] ;
   }
 
-  void VPDynamicDatabase::addAIESample(uint64_t deviceId, double timestamp,
-          const std::vector<uint64_t>& values)
+  AIESampleLog* VPDynamicDatabase::getAIESampleLog(uint64_t deviceId)
   {
     std::lock_guard<std::mutex> lock(aieLock) ;
 
-    if (aieSamples.find(deviceId) == aieSamples.end())
-    {
-      std::vector<CounterSample> blank ;
-      aieSamples[deviceId] = blank ;
-    }
-
-    aieSamples[deviceId].push_back(std::make_pair(timestamp, values)) ;
+    auto& log = aieSamples[deviceId] ;
+    if (!log)
+      log = std::make_unique<AIESampleLog>() ;
+    return log.get() ;
   }
 
-  std::vector<VPDynamicDatabase::CounterSample>
-  VPDynamicDatabase::getAIESamples(uint64_t deviceId)
+  NOCSampleLog* VPDynamicDatabase::getNOCSampleLog(uint64_t deviceId)
   {
-    std::lock_guard<std::mutex> lock(aieLock) ;
-
-    if (aieSamples.find(deviceId) == aieSamples.end()) {
-      std::vector<CounterSample> empty;
-      aieSamples[deviceId] = empty;
-    }
+    std::lock_guard<std::mutex> lock(nocLock) ;
 
-    return aieSamples[deviceId] ;
+    auto& log = nocSamples[deviceId] ;
+    if (!log)
+      log = std::make_unique<NOCSampleLog>() ;
+    return log.get() ;
   }
 
-  void VPDynamicDatabase::addNOCSample(uint64_t deviceId, double timestamp,
-          std::string name, const std::vector<uint64_t>& values)
+  void VPDynamicDatabase::setDeviceCounterNames(uint64_t deviceId,
+                                    const std::vector<std::string>& names)
   {
-    std::lock_guard<std::mutex> lock(nocLock) ;
-
-    // Store name
-    if (nocNames.find(deviceId) == nocNames.end())
-    {
-      CounterNames blank ;
-      nocNames[deviceId] = blank ;
-    }
+    std::lock_guard<std::mutex> lock(deviceCounterLock) ;
 
-    nocNames[deviceId][timestamp] = name ;
-
-    // Store vector of values
-    if (nocSamples.find(deviceId) == nocSamples.end())
-    {
-      std::vector<CounterSample> blank ;
-      nocSamples[deviceId] = blank ;
-    }
-
-    nocSamples[deviceId].push_back(std::make_pair(timestamp, values)) ;
+    DeviceCounterSamples& samples = deviceCounterSamples[deviceId] ;
+    samples.names = names ;
+    samples.last.assign(names.size(), 0) ;
   }
 
-  std::vector<VPDynamicDatabase::CounterSample>
-  VPDynamicDatabase::getNOCSamples(uint64_t deviceId)
+  std::vector<std::string>
+  VPDynamicDatabase::getDeviceCounterNames(uint64_t deviceId)
   {
-    std::lock_guard<std::mutex> lock(nocLock) ;
+    std::lock_guard<std::mutex> lock(deviceCounterLock) ;
 
-    return nocSamples[deviceId] ;
+    return deviceCounterSamples[deviceId].names ;
   }
 
-  VPDynamicDatabase::CounterNames
-  VPDynamicDatabase::getNOCNames(uint64_t deviceId)
+  // Each sample is the number of values, the time since the previous
+  //  sample in ns, and the increase of each value.  A value smaller than
+  //  the previous one means the counter was reset, so the increase is
+  //  the value itself.
+  void VPDynamicDatabase::addDeviceCounterSample(uint64_t deviceId,
+                                                 uint64_t timestamp,
+                                     const std::vector<uint64_t>& values)
   {
-    std::lock_guard<std::mutex> lock(nocLock) ;
+    std::lock_guard<std::mutex> lock(deviceCounterLock) ;
+
+    DeviceCounterSamples& samples = deviceCounterSamples[deviceId] ;
+    if (samples.last.size() != values.size())
+      samples.last.assign(values.size(), 0) ;
+
+    appendVarint(samples.encoded, values.size()) ;
+    appendVarint(samples.encoded, timestamp - samples.lastTimestamp) ;
+    for (size_t i = 0 ; i < values.size() ; ++i) {
+      uint64_t delta = values[i] >= samples.last[i] ?
+                       values[i] - samples.last[i] : values[i] ;
+      appendVarint(samples.encoded, delta) ;
+    }
+    samples.last = values ;
+    samples.lastTimestamp = timestamp ;
+  }
 
-    return nocNames[deviceId] ;
+  std::vector<VPDynamicDatabase::CounterSample>
+  VPDynamicDatabase::getDeviceCounterSamples(uint64_t deviceId)
+  {
+    std::lock_guard<std::mutex> lock(deviceCounterLock) ;
+
+    std::vector<CounterSample> decoded ;
+    const std::vector<uint8_t>& encoded = deviceCounterSamples[deviceId].encoded;
+    uint64_t timestamp = 0 ;
+    size_t pos = 0 ;
+    while (pos < encoded.size()) {
+      uint64_t numValues = extractVarint(encoded, pos) ;
+      timestamp += extractVarint(encoded, pos) ;
+      std::vector<uint64_t> deltas ;
+      deltas.reserve(numValues) ;
+      for (uint64_t i = 0 ; i < numValues ; ++i)
+        deltas.push_back(extractVarint(encoded, pos)) ;
+      decoded.push_back(std::make_pair(static_cast<double>(timestamp) / 1.0e6,
+                                       deltas)) ;
+    }
+    return decoded ;
   }
 
   void VPDynamicDatabase::setTraceBufferFull(uint64_t deviceId, bool val)
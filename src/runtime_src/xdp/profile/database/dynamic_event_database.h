@@ -25,7 +25,12 @@
 #include <functional>
 #include <memory>
 #include <atomic>
+#include <string>
+#include <string_view>
 
+#include "xdp/profile/database/aie_sample_log.h"
+#include "xdp/profile/database/noc_sample_log.h"
+#include "xdp/profile/database/start_ring.h"
 #include "xdp/profile/database/events/vtf_event.h"
 
 #include "xdp/config.h"
@@ -54,17 +59,32 @@ namespace xdp {
     // Number of events to store before flushing to disk
     const uint64_t DeviceEventThreshold = 10000000 ;
 
+    // Approximate memory used by a retained event, including the
+    //  container that holds it, used to convert the configured trace
+    //  memory limit into a number of events
+    const uint64_t ApproxEventSize = 256 ;
+
   public:
     // Define a public typedef for all plugins that get information
     //  from counters
     typedef std::pair<double, std::vector<uint64_t>> CounterSample ;
-    typedef std::map<double, std::string> CounterNames ;
 
   private:
     // For sorted host events, we need a multimap because multithreaded
     //  applications can create unsorted events
     std::multimap<double, VTFEvent*> hostEvents ;
 
+    // Host events are first appended to a buffer owned by the thread
+    //  that logged them, so threads logging events do not contend on
+    //  hostEventsLock.  The buffers are merged into hostEvents only when
+    //  the host events are read.
+    struct HostEventBuffer
+    {
+      std::mutex lock ; // Only contended while merging
+      std::vector<VTFEvent*> events ;
+    } ;
+    std::vector<std::unique_ptr<HostEventBuffer>> hostEventBuffers ;
+
     // For host events that we don't care about sorting, we can just store
     //  in a simple vector
     std::vector<VTFEvent*> unsortedHostEvents ;
@@ -77,14 +97,35 @@ namespace xdp {
     // For all plugins that read counters, we will store that information
     //  here.
     std::map<uint64_t, std::vector<CounterSample>> powerSamples ;
-    std::map<uint64_t, std::vector<CounterSample>> aieSamples ;
-    std::map<uint64_t, std::vector<CounterSample>> nocSamples ;
-    std::map<uint64_t, CounterNames> nocNames ;
+    std::map<uint64_t, std::unique_ptr<AIESampleLog>> aieSamples ;
+    std::map<uint64_t, std::unique_ptr<NOCSampleLog>> nocSamples ;
+
+    // Periodic samples of the device monitor counters.  Counters only
+    //  grow between resets, so each sample is stored as the varint
+    //  encoded differences from the previous sample.
+    struct DeviceCounterSamples
+    {
+      std::vector<std::string> names ;
+      std::vector<uint64_t> last ;
+      uint64_t lastTimestamp = 0 ;
+      std::vector<uint8_t> encoded ;
+    } ;
+    std::map<uint64_t, DeviceCounterSamples> deviceCounterSamples ;
 
     // A unique event id for every event added to the database.
     //  It starts with 1 so we can use 0 as an indicator of NULL
     std::atomic<uint64_t> eventId ;
 
+    // In bounded mode, at most eventLimit events are retained, and the
+    //  oldest events are dropped when the limit is exceeded.  The number
+    //  of retained events is the number of event ids handed out minus
+    //  the events taken by writers or dropped, so logging an event does
+    //  not update another shared counter.
+    uint64_t eventLimit ;
+    std::atomic<uint64_t> removedEvents ;
+    std::atomic<uint64_t> droppedEvents ;
+    std::mutex evictLock ;
+
     // Data structure for matching start events with end events, 
     //  as in API calls.  This will match a function ID to event IDs.
     std::map<uint64_t, uint64_t> startMap ;
@@ -93,11 +134,12 @@ namespace xdp {
     //  the label and tooltip
     std::map<uint64_t, std::tuple<const char*, const char*, uint64_t>> userMap ;
 
-    // For device events - a map from trace ID to a list of start event
-    //  information (type, event ID, host timestamp, and device timestamp) we
-    //  have not yet matched with an end event
-    std::map<uint64_t,
-             std::list<std::tuple<VTFEventType, uint64_t, double, uint64_t>>>
+    // For device events - start event information (type, event ID, host
+    //  timestamp, and device timestamp) we have not yet matched with an
+    //  end event.  Trace IDs in device packets are 12 bits, so the
+    //  pending starts are indexed directly by trace ID.
+    static constexpr uint64_t NumDeviceTraceIDs = 0x1000 ;
+    std::vector<StartRing<std::tuple<VTFEventType, uint64_t, double, uint64_t>>>
       deviceEventStartMap ;
 
     // For Trace Buffer Fullness Status 
@@ -126,9 +168,31 @@ namespace xdp {
 
     // In order to reduce memory overhead, instead of each event holding
     //  strings, each event will instead point to a unique
-    //  instance of that string
-    std::map<std::string, uint64_t> stringTable ;
+    //  instance of that string.
+    //
+    // The string table is a hash table of chained entries that are never
+    //  removed.  Lookups only follow atomic pointers, so they never take
+    //  a lock or allocate.  Adding a string takes stringLock.
+    struct StringEntry
+    {
+      std::string value ;
+      uint64_t id ;
+      StringEntry* next ;
+    } ;
+    static constexpr size_t numStringBuckets = 4096 ;
+    std::unique_ptr<std::atomic<StringEntry*>[]> stringBuckets ;
     uint64_t stringId ;
+    // The strings in the table by id, for lookups that go the other way
+    std::vector<std::unique_ptr<StringEntry>> stringIndex ;
+
+    // Most strings are passed as pointers to the same static names,
+    //  such as API function names.  The last string seen at each
+    //  hashed address is cached, and used if its contents still match.
+    static constexpr size_t numStringPointerSlots = 1024 ;
+    std::unique_ptr<std::atomic<StringEntry*>[]> stringPointerCache ;
+
+    StringEntry* findString(std::string_view value, size_t hash) ;
+    StringEntry* internString(std::string_view value) ;
 
     // Since events can be logged from multiple threads simultaneously,
     //  we have to maintain exclusivity
@@ -136,10 +200,12 @@ namespace xdp {
     std::mutex powerLock ;
     std::mutex nocLock ;
     std::mutex ctrLock ;
+    std::mutex deviceCounterLock ;
 
     // Event loggers and filters
     std::mutex deviceEventsLock ;
     std::mutex hostEventsLock ;
+    std::mutex hostEventBuffersLock ;
     std::mutex unsortedEventsLock ;
 
     // Trace parser states and other metadata data structures
@@ -148,7 +214,12 @@ namespace xdp {
     std::mutex stringLock ;
 
     void addHostEvent(VTFEvent* event) ;
+    HostEventBuffer* getHostEventBuffer() ;
+    // Must be called with hostEventsLock held
+    void mergeHostEvents() ;
     void addDeviceEvent(uint64_t deviceId, VTFEvent* event) ;
+    void checkEventLimit(uint64_t id) ;
+    void evictOldestEvents() ;
 
   public:
     XDP_EXPORT VPDynamicDatabase(VPDatabase* d) ;
@@ -187,7 +258,9 @@ namespace xdp {
     XDP_EXPORT uint64_t matchingXRTUIDStart(uint64_t uid);
 
     // A lookup into the string table
-    XDP_EXPORT uint64_t addString(const std::string& value) ;
+    XDP_EXPORT uint64_t addString(std::string_view value) ;
+    XDP_EXPORT uint64_t addString(const char* value) ;
+    XDP_EXPORT std::string getString(uint64_t id) ;
 
     // A function that iterates on the dynamic events and returns
     //  events based upon the filter passed in
@@ -233,14 +306,32 @@ namespace xdp {
 				   const std::vector<uint64_t>& values) ;
     XDP_EXPORT std::vector<CounterSample> getPowerSamples(uint64_t deviceId) ;
 
-    XDP_EXPORT void addAIESample(uint64_t deviceId, double timestamp,
-				   const std::vector<uint64_t>& values) ;
-    XDP_EXPORT std::vector<CounterSample> getAIESamples(uint64_t deviceId) ;
-
-    XDP_EXPORT void addNOCSample(uint64_t deviceId, double timestamp, std::string name,
-				   const std::vector<uint64_t>& values) ;
-    XDP_EXPORT std::vector<CounterSample> getNOCSamples(uint64_t deviceId) ;
-    XDP_EXPORT CounterNames getNOCNames(uint64_t deviceId) ;
+    // The log is created on the first call and stays valid as long as
+    //  the database, samples are appended and read without the lock
+    XDP_EXPORT AIESampleLog* getAIESampleLog(uint64_t deviceId) ;
+
+    // The log is created on the first call and stays valid as long as
+    //  the database, samples are appended and read without the lock
+    XDP_EXPORT NOCSampleLog* getNOCSampleLog(uint64_t deviceId) ;
+
+    // Samples of the device monitor counters.  Names are set whenever
+    //  the monitors of the device change, and the next sample is then
+    //  taken relative to 0.  Samples are returned with the timestamp in
+    //  ms and the increase of each counter since the previous sample.
+    XDP_EXPORT void setDeviceCounterNames(uint64_t deviceId,
+                                          const std::vector<std::string>& names);
+    XDP_EXPORT std::vector<std::string> getDeviceCounterNames(uint64_t deviceId);
+    XDP_EXPORT void addDeviceCounterSample(uint64_t deviceId,
+                                           uint64_t timestamp,
+                                           const std::vector<uint64_t>& values);
+    XDP_EXPORT std::vector<CounterSample> getDeviceCounterSamples(uint64_t deviceId);
+
+    // Bounded trace collection.  Writers that use events without taking
+    //  them out of the database hold the returned lock while they use
+    //  the events, so the events are not dropped under them.
+    XDP_EXPORT std::unique_lock<std::mutex> holdEvents() ;
+    inline uint64_t getEventLimit() const { return eventLimit ; }
+    inline uint64_t getDroppedEvents() const { return droppedEvents ; }
 
     // Device Trace Buffer Fullness Status
     XDP_EXPORT void setTraceBufferFull(uint64_t deviceId, bool val);
@@ -14,6 +14,7 @@
  * under the License.
  */
 
+#include <cmath>
 #include <iomanip>
 
 #define XDP_SOURCE
@@ -55,6 +56,13 @@ namespace xdp {
     fout << std::endl;
   } 
 
+  void VTFDeviceEvent::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    // Device timestamps are in milliseconds
+    record.timestamp = static_cast<uint64_t>(std::llround(timestamp * 1.0e6)) ;
+  }
+
   KernelEvent::KernelEvent(uint64_t s_id, double ts, VTFEventType ty,
                            uint64_t devId, uint32_t monId, int32_t cuIdx)
              : VTFDeviceEvent(s_id, ts, ty, devId, monId),
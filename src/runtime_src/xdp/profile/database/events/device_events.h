@@ -48,6 +48,7 @@ namespace xdp {
     XDP_EXPORT ~VTFDeviceEvent() ;
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket);
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
 
     virtual bool     isDeviceEvent() { return true ; }
     virtual uint64_t getDevice()     { return deviceId ; }
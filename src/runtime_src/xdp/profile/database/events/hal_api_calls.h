@@ -37,6 +37,7 @@ namespace xdp {
     virtual bool isHALHostEvent() { return true ; }
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class AllocBoCall : public HALAPICall
@@ -36,10 +36,20 @@ namespace xdp {
     fout << "," << functionName << "\n" ;
   }
 
+  void NativeAPICall::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    record.addField(functionName) ;
+  }
+
   void NativeAPICall::dumpSync(std::ofstream& /*fout*/, uint32_t /*bucket*/)
   {
   }
 
+  void NativeAPICall::dumpSyncBinary(VTFBinaryRecord& /*record*/, uint32_t /*bucket*/)
+  {
+  }
+
   NativeSyncRead::NativeSyncRead(uint64_t s_id, double ts, uint64_t name,
                                  uint64_t r) :
     NativeAPICall(s_id, ts, name), readStr(r)
@@ -52,6 +62,12 @@ namespace xdp {
     fout << "," << readStr << "\n" ;
   }
 
+  void NativeSyncRead::dumpSyncBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    record.addField(readStr) ;
+  }
+
   NativeSyncWrite::NativeSyncWrite(uint64_t s_id, double ts, uint64_t name,
                                    uint64_t w) :
     NativeAPICall(s_id, ts, name), writeStr(w)
@@ -64,4 +80,10 @@ namespace xdp {
     fout << "," << writeStr << "\n" ;
   }
 
+  void NativeSyncWrite::dumpSyncBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    record.addField(writeStr) ;
+  }
+
 } // end namespace xdp
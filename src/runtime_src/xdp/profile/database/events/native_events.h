@@ -32,10 +32,12 @@ namespace xdp {
     XDP_EXPORT virtual bool isRead()  { return false ; }
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
 
     // For printing out the event in a different bucket as a different
     //  type of event, without having to store additional events in the database
     XDP_EXPORT virtual void dumpSync(std::ofstream& fout, uint32_t bucket);
+    XDP_EXPORT virtual void dumpSyncBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class NativeSyncRead : public NativeAPICall
@@ -49,6 +51,7 @@ namespace xdp {
 
     XDP_EXPORT virtual bool isRead() { return true ; }
     XDP_EXPORT virtual void dumpSync(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpSyncBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class NativeSyncWrite : public NativeAPICall
@@ -62,6 +65,7 @@ namespace xdp {
 
     XDP_EXPORT virtual bool isWrite() { return true ; }
     XDP_EXPORT virtual void dumpSync(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpSyncBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
 } // end namespace xdp
@@ -38,4 +38,10 @@ namespace xdp {
     fout << "," << functionName << std::endl ;
   }
 
+  void OpenCLAPICall::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    record.addField(functionName) ;
+  }
+
 } // end namespace xdp
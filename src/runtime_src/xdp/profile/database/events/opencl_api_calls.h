@@ -40,6 +40,7 @@ namespace xdp {
     virtual bool isLOPAPI() { return isLOP ; }
     virtual bool isOpenCLHostEvent() { return !isLOP ; }
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
 } // end namespace xdp
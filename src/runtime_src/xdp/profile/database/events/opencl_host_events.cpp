@@ -16,10 +16,22 @@
 
 #define XDP_SOURCE
 
+#include <algorithm>
+#include <cstring>
+
 #include "xdp/profile/database/events/opencl_host_events.h"
 
 namespace xdp {
 
+  // The numeric value of a thread id as printed by operator<<, for
+  //  binary trace records
+  static uint64_t threadIdValue(const std::thread::id& tid)
+  {
+    uint64_t value = 0 ;
+    std::memcpy(&value, &tid, std::min(sizeof(value), sizeof(tid))) ;
+    return value ;
+  }
+
   // **************************
   // Host event definitions
   // **************************
@@ -53,6 +65,15 @@ namespace xdp {
     fout << std::endl; 
   }
 
+  void KernelEnqueue::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    record.addField(kernelName) ;
+    record.addField(workgroupConfiguration) ;
+    record.addField(workgroupSize) ;
+    record.addField(0) ; // This is the "size"
+  }
+
   LOPKernelEnqueue::LOPKernelEnqueue(uint64_t s_id, double ts) :
     VTFEvent(s_id, ts, LOP_KERNEL_ENQUEUE)
   {
@@ -102,6 +123,13 @@ namespace xdp {
     fout << std::endl;
   }
 
+  void BufferTransfer::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    if (0 == start_id)
+      record.addField(size) ;
+  }
+
   OpenCLBufferTransfer::OpenCLBufferTransfer(uint64_t s_id, double ts,
 					     VTFEventType ty,
 					     uint64_t address,
@@ -130,6 +158,18 @@ namespace xdp {
     fout << std::endl ;
   }
 
+  void OpenCLBufferTransfer::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    if (0 == start_id)
+    {
+      record.addField(bufferSize) ;
+      record.addField(deviceAddress, true) ;
+      record.addField(memoryResource) ;
+      record.addField(threadIdValue(threadId), true) ;
+    }
+  }
+
 
   OpenCLCopyBuffer::OpenCLCopyBuffer(uint64_t s_id, double ts, VTFEventType ty,
 				     uint64_t srcAddress, uint64_t srcResource,
@@ -162,6 +202,21 @@ namespace xdp {
     fout << std::endl ;
   }
 
+  void OpenCLCopyBuffer::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    if (0 == start_id)
+    {
+      record.addField(1) ; // Transfer type
+      record.addField(bufferSize) ;
+      record.addField(srcDeviceAddress) ;
+      record.addField(srcMemoryResource) ;
+      record.addField(dstDeviceAddress) ;
+      record.addField(dstMemoryResource) ;
+      record.addField(threadIdValue(threadId), true) ;
+    }
+  }
+
   LOPBufferTransfer::LOPBufferTransfer(uint64_t s_id, double ts, 
 				       VTFEventType ty) :
     VTFEvent(s_id, ts, ty), threadId(std::this_thread::get_id())
@@ -179,6 +234,12 @@ namespace xdp {
     fout << "," << std::hex << "0x" << threadId << std::dec << std::endl ;
   }
 
+  void LOPBufferTransfer::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    record.addField(threadIdValue(threadId), true) ;
+  }
+
   StreamRead::StreamRead(uint64_t s_id, double ts) :
     VTFEvent(s_id, ts, STREAM_READ)
   {
@@ -55,6 +55,7 @@ namespace xdp {
     virtual bool isOpenCLHostEvent() { return true ; }
     
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class LOPKernelEnqueue : public VTFEvent
@@ -107,6 +108,7 @@ namespace xdp {
     virtual bool isHostEvent() { return true ; } 
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class OpenCLBufferTransfer : public VTFEvent
@@ -128,6 +130,7 @@ namespace xdp {
     virtual bool isOpenCLHostEvent() { return true ; }
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class OpenCLCopyBuffer : public VTFEvent
@@ -152,6 +155,7 @@ namespace xdp {
     virtual bool isOpenCLHostEvent() { return true ; }
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class LOPBufferTransfer : public VTFEvent
@@ -166,6 +170,7 @@ namespace xdp {
     virtual bool isLOPHostEvent() { return true ; }
 
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
   } ;
 
   class StreamRead : public VTFEvent
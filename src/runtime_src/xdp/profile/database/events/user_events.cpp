@@ -40,6 +40,12 @@ namespace xdp {
     fout << std::endl ;
   }
 
+  void UserMarker::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    if (label != 0) record.addField(label) ;
+  }
+
   UserRange::UserRange(uint64_t s_id, double ts, bool s, 
 		       uint64_t l, uint64_t tt) :
     VTFEvent(s_id, ts, USER_RANGE), isStart(s), label(l), tooltip(tt)
@@ -61,4 +67,14 @@ namespace xdp {
     fout << std::endl ;
   }
 
+  void UserRange::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    VTFEvent::dumpBinary(record, bucket) ;
+    if (isStart)
+    {
+      record.addField(label) ;
+      record.addField(tooltip) ;
+    }
+  }
+
 } // end namespace xdp
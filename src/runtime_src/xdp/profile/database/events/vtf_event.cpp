@@ -14,13 +14,161 @@
  * under the License.
  */
 
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <mutex>
+#include <new>
+#include <vector>
 
 #define XDP_SOURCE
 
 #include "xdp/profile/database/events/vtf_event.h"
 
+namespace {
+
+  // Slab allocator for VTFEvents.  Events are rounded up to a multiple
+  //  of 16 bytes and each size class has a free list per thread.
+  //  Events are typically created on application threads and deleted
+  //  on the thread that writes the trace, so free lists that grow past
+  //  a limit hand a batch of blocks to a central store, from which
+  //  threads with empty free lists take a batch before carving a new
+  //  slab.  Slabs are never returned to the heap.
+  constexpr std::size_t granularity = 16 ;
+  constexpr std::size_t numClasses = 16 ; // Up to 256 byte events
+  constexpr std::size_t slabSize = 64 * 1024 ;
+  constexpr uint32_t batchSize = 128 ;
+  constexpr uint32_t maxCached = 2 * batchSize ;
+
+  struct FreeBlock
+  {
+    FreeBlock* next ;
+  } ;
+
+  struct Batch
+  {
+    FreeBlock* head ;
+    uint32_t count ;
+  } ;
+
+  class CentralStore
+  {
+  private:
+    std::mutex lock ;
+    std::vector<Batch> batches[numClasses] ;
+
+  public:
+    void put(std::size_t sizeClass, FreeBlock* head, uint32_t count)
+    {
+      std::lock_guard<std::mutex> guard(lock) ;
+      batches[sizeClass].push_back({head, count}) ;
+    }
+
+    Batch get(std::size_t sizeClass)
+    {
+      std::lock_guard<std::mutex> guard(lock) ;
+      if (batches[sizeClass].empty())
+        return {nullptr, 0} ;
+      Batch b = batches[sizeClass].back() ;
+      batches[sizeClass].pop_back() ;
+      return b ;
+    }
+  } ;
+
+  // Intentionally leaked, events may be deleted during static destruction
+  CentralStore& getCentralStore()
+  {
+    static CentralStore* store = new CentralStore ;
+    return *store ;
+  }
+
+  Batch newSlab(std::size_t sizeClass)
+  {
+    std::size_t blockSize = (sizeClass + 1) * granularity ;
+    char* slab = static_cast<char*>(::operator new(slabSize)) ;
+    uint32_t count = static_cast<uint32_t>(slabSize / blockSize) ;
+
+    FreeBlock* head = nullptr ;
+    for (uint32_t i = count ; i > 0 ; --i) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + ((i - 1) * blockSize)) ;
+      block->next = head ;
+      head = block ;
+    }
+    return {head, count} ;
+  }
+
+  // Set once the cache of this thread is destroyed at thread exit.
+  //  Events deleted after that, for example by static destructors on
+  //  the main thread, go straight to the central store.
+  thread_local bool threadCacheGone = false ;
+
+  struct ThreadCache
+  {
+    FreeBlock* lists[numClasses] = {} ;
+    uint32_t counts[numClasses] = {} ;
+
+    ~ThreadCache()
+    {
+      for (std::size_t c = 0 ; c < numClasses ; ++c)
+        if (lists[c] != nullptr)
+          getCentralStore().put(c, lists[c], counts[c]) ;
+      threadCacheGone = true ;
+    }
+
+    void* allocate(std::size_t sizeClass)
+    {
+      if (lists[sizeClass] == nullptr) {
+        Batch b = getCentralStore().get(sizeClass) ;
+        if (b.head == nullptr)
+          b = newSlab(sizeClass) ;
+        lists[sizeClass] = b.head ;
+        counts[sizeClass] = b.count ;
+      }
+      FreeBlock* block = lists[sizeClass] ;
+      lists[sizeClass] = block->next ;
+      --counts[sizeClass] ;
+      return block ;
+    }
+
+    void deallocate(void* ptr, std::size_t sizeClass)
+    {
+      FreeBlock* block = static_cast<FreeBlock*>(ptr) ;
+      block->next = lists[sizeClass] ;
+      lists[sizeClass] = block ;
+      if (++counts[sizeClass] < maxCached)
+        return ;
+
+      // Hand the oldest blocks in the list to the central store
+      FreeBlock* last = lists[sizeClass] ;
+      for (uint32_t i = 1 ; i < maxCached - batchSize ; ++i)
+        last = last->next ;
+      getCentralStore().put(sizeClass, last->next, counts[sizeClass] - (maxCached - batchSize)) ;
+      last->next = nullptr ;
+      counts[sizeClass] = maxCached - batchSize ;
+    }
+  } ;
+
+  thread_local ThreadCache threadCache ;
+
+  void* allocateUncached(std::size_t sizeClass)
+  {
+    Batch b = getCentralStore().get(sizeClass) ;
+    if (b.head == nullptr)
+      b = newSlab(sizeClass) ;
+    if (b.count > 1)
+      getCentralStore().put(sizeClass, b.head->next, b.count - 1) ;
+    return b.head ;
+  }
+
+  void deallocateUncached(void* ptr, std::size_t sizeClass)
+  {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr) ;
+    block->next = nullptr ;
+    getCentralStore().put(sizeClass, block, 1) ;
+  }
+
+} // end anonymous namespace
+
 namespace xdp {
 
   // **************************
@@ -36,6 +184,29 @@ namespace xdp {
   {
   }
 
+  void* VTFEvent::operator new(std::size_t size)
+  {
+    std::size_t sizeClass = (size - 1) / granularity ;
+    if (sizeClass >= numClasses)
+      return ::operator new(size) ;
+    if (threadCacheGone)
+      return allocateUncached(sizeClass) ;
+    return threadCache.allocate(sizeClass) ;
+  }
+
+  void VTFEvent::operator delete(void* ptr, std::size_t size)
+  {
+    if (ptr == nullptr)
+      return ;
+    std::size_t sizeClass = (size - 1) / granularity ;
+    if (sizeClass >= numClasses)
+      ::operator delete(ptr) ;
+    else if (threadCacheGone)
+      deallocateUncached(ptr, sizeClass) ;
+    else
+      threadCache.deallocate(ptr, sizeClass) ;
+  }
+
   void VTFEvent::dump(std::ofstream& fout, uint32_t bucket)
   {
     fout << id << "," << start_id << "," ;
@@ -54,115 +225,67 @@ namespace xdp {
     fout.flags(flags) ;
   }
 
-  void VTFEvent::dumpType(std::ofstream& fout, bool humanReadable)
+  void VTFEvent::dumpBinary(VTFBinaryRecord& record, uint32_t bucket)
+  {
+    record.id        = id ;
+    record.start_id  = start_id ;
+    record.timestamp = static_cast<uint64_t>(std::llround(timestamp)) ;
+    record.bucket    = bucket ;
+    record.type      = static_cast<uint16_t>(type) ;
+  }
+
+  const char* VTFEvent::getTypeName(VTFEventType type)
   {
     switch (type)
     {
-    case USER_MARKER:
-      humanReadable ? (fout << "USER_MARKER") : (fout << USER_MARKER) ;
-      break ;
-    case USER_RANGE:
-      humanReadable ? (fout << "USER_RANGE") : (fout << USER_RANGE) ;
-      break ;
-    case KERNEL_ENQUEUE:
-      humanReadable ? (fout << "KERNEL_ENQUEUE") : (fout << KERNEL_ENQUEUE) ;
-      break ;
-    case CU_ENQUEUE:
-      humanReadable ? (fout << "CU_ENQUEUE") : (fout << CU_ENQUEUE) ;
-      break ;
-    case READ_BUFFER:
-      humanReadable ? (fout << "READ_BUFFER") : (fout << READ_BUFFER) ;
-      break ;
-    case READ_BUFFER_P2P:
-      humanReadable ? (fout << "READ_BUFFER_P2P") : (fout << READ_BUFFER_P2P) ;
-      break ;
-    case WRITE_BUFFER:
-      humanReadable ? (fout << "WRITE_BUFFER") : (fout << WRITE_BUFFER) ;
-      break ;
-    case WRITE_BUFFER_P2P:
-      humanReadable ? (fout << "WRITE_BUFFER_P2P") : (fout << WRITE_BUFFER_P2P);
-      break ;
-    case COPY_BUFFER:
-      humanReadable ? (fout << "COPY_BUFFER") : (fout << COPY_BUFFER) ;
-      break ;
-    case COPY_BUFFER_P2P:
-      humanReadable ? (fout << "COPY_BUFFER_P2P") : (fout << COPY_BUFFER_P2P) ;
-      break ;
-    case OPENCL_API_CALL:
-      humanReadable ? (fout << "OPENCL_API_CALL") : (fout << OPENCL_API_CALL) ;
-      break ;
-    case STREAM_READ:
-      humanReadable ? (fout << "STREAM_READ") : (fout << STREAM_READ) ;
-      break ;
-    case STREAM_WRITE:
-      humanReadable ? (fout << "STREAM_WRITE") : (fout << STREAM_WRITE) ;
-      break ;
-    case LOP_READ_BUFFER:
-      humanReadable ? (fout << "LOP_READ_BUFFER") : (fout << LOP_READ_BUFFER) ;
-      break ;
-    case LOP_WRITE_BUFFER:
-      humanReadable ? (fout << "LOP_WRITE_BUFFER") : (fout << LOP_WRITE_BUFFER);
-      break ;
-    case LOP_KERNEL_ENQUEUE:
-      humanReadable ? (fout << "LOP_KERNEL_ENQUEUE") : (fout << LOP_KERNEL_ENQUEUE) ;
-      break ;
-    case KERNEL:
-      humanReadable ? (fout << "KERNEL") : (fout << KERNEL) ;
-      break ;
-    case KERNEL_STALL:
-      humanReadable ? (fout << "KERNEL_STALL") : (fout << KERNEL_STALL) ;
-      break ;
-    case KERNEL_STALL_EXT_MEM:
-      humanReadable ? (fout << "KERNEL_STALL_EXT_MEM") : (fout << KERNEL_STALL_EXT_MEM) ;
-      break ;
-    case KERNEL_STALL_DATAFLOW:
-      humanReadable ? (fout << "KERNEL_STALL_DATAFLOW") : (fout << KERNEL_STALL_DATAFLOW) ;
-      break ;
-    case KERNEL_STALL_PIPE:
-      humanReadable ? (fout << "KERNEL_STALL_PIPE") : (fout << KERNEL_STALL_PIPE) ;
-      break ;
-    case KERNEL_READ:
-      humanReadable ? (fout << "KERNEL_READ") : (fout << KERNEL_READ) ;
-      break ;
-    case KERNEL_WRITE:
-      humanReadable ? (fout << "KERNEL_WRITE") : (fout << KERNEL_WRITE) ;
-      break ;
-    case KERNEL_STREAM_READ:
-      humanReadable ? (fout << "KERNEL_STREAM_READ") : (fout << KERNEL_STREAM_READ) ;
-      break ;
-    case KERNEL_STREAM_READ_STALL:
-      humanReadable ? (fout << "KERNEL_STREAM_READ_STALL") : (fout << KERNEL_STREAM_READ_STALL) ;
-      break ;
-    case KERNEL_STREAM_READ_STARVE:
-      humanReadable ? (fout << "KERNEL_STREAM_READ_STARVE") : (fout << KERNEL_STREAM_READ_STARVE) ;
-      break ;
-    case KERNEL_STREAM_WRITE:
-      humanReadable ? (fout << "KERNEL_STREAM_WRITE") : (fout << KERNEL_STREAM_WRITE) ;
-      break ;
-    case KERNEL_STREAM_WRITE_STALL:
-      humanReadable ? (fout << "KERNEL_STREAM_WRITE_STALL") : (fout << KERNEL_STREAM_WRITE_STALL) ;
-      break ;
-    case KERNEL_STREAM_WRITE_STARVE:
-      humanReadable ? (fout << "KERNEL_STREAM_WRITE_STARVE") : (fout << KERNEL_STREAM_WRITE_STARVE) ;
-      break ;
-    case HOST_READ:
-      humanReadable ? (fout << "HOST_READ") : (fout << HOST_READ) ;
-      break ;
-    case HOST_WRITE:
-      humanReadable ? (fout << "HOST_WRITE") : (fout << HOST_WRITE) ;
-      break ;
+    case USER_MARKER:                 return "USER_MARKER" ;
+    case USER_RANGE:                  return "USER_RANGE" ;
+    case KERNEL_ENQUEUE:              return "KERNEL_ENQUEUE" ;
+    case CU_ENQUEUE:                  return "CU_ENQUEUE" ;
+    case READ_BUFFER:                 return "READ_BUFFER" ;
+    case READ_BUFFER_P2P:             return "READ_BUFFER_P2P" ;
+    case WRITE_BUFFER:                return "WRITE_BUFFER" ;
+    case WRITE_BUFFER_P2P:            return "WRITE_BUFFER_P2P" ;
+    case COPY_BUFFER:                 return "COPY_BUFFER" ;
+    case COPY_BUFFER_P2P:             return "COPY_BUFFER_P2P" ;
+    case OPENCL_API_CALL:             return "OPENCL_API_CALL" ;
+    case STREAM_READ:                 return "STREAM_READ" ;
+    case STREAM_WRITE:                return "STREAM_WRITE" ;
+    case LOP_READ_BUFFER:             return "LOP_READ_BUFFER" ;
+    case LOP_WRITE_BUFFER:            return "LOP_WRITE_BUFFER" ;
+    case LOP_KERNEL_ENQUEUE:          return "LOP_KERNEL_ENQUEUE" ;
+    case KERNEL:                      return "KERNEL" ;
+    case KERNEL_STALL:                return "KERNEL_STALL" ;
+    case KERNEL_STALL_EXT_MEM:        return "KERNEL_STALL_EXT_MEM" ;
+    case KERNEL_STALL_DATAFLOW:       return "KERNEL_STALL_DATAFLOW" ;
+    case KERNEL_STALL_PIPE:           return "KERNEL_STALL_PIPE" ;
+    case KERNEL_READ:                 return "KERNEL_READ" ;
+    case KERNEL_WRITE:                return "KERNEL_WRITE" ;
+    case KERNEL_STREAM_READ:          return "KERNEL_STREAM_READ" ;
+    case KERNEL_STREAM_READ_STALL:    return "KERNEL_STREAM_READ_STALL" ;
+    case KERNEL_STREAM_READ_STARVE:   return "KERNEL_STREAM_READ_STARVE" ;
+    case KERNEL_STREAM_WRITE:         return "KERNEL_STREAM_WRITE" ;
+    case KERNEL_STREAM_WRITE_STALL:   return "KERNEL_STREAM_WRITE_STALL" ;
+    case KERNEL_STREAM_WRITE_STARVE:  return "KERNEL_STREAM_WRITE_STARVE" ;
+    case HOST_READ:                   return "HOST_READ" ;
+    case HOST_WRITE:                  return "HOST_WRITE" ;
     case HAL_API_CALL:
-      humanReadable ? (fout << "API_CALL") : (fout << API_CALL) ;
-      break ;
-    case NATIVE_API_CALL:
-      humanReadable ? (fout << "API_CALL") : (fout << API_CALL) ;
-      break ;
-    default:
-      humanReadable ? (fout << "UNKNOWN") : (fout << -1) ;
-      break ;
+    case NATIVE_API_CALL:             return "API_CALL" ;
+    default:                          return nullptr ;
     }
   }
 
+  void VTFEvent::dumpType(std::ofstream& fout, bool humanReadable)
+  {
+    const char* name = getTypeName(type) ;
+    if (humanReadable)
+      fout << (name ? name : "UNKNOWN") ;
+    else if (type == HAL_API_CALL || type == NATIVE_API_CALL)
+      fout << API_CALL ;
+    else
+      fout << (name ? static_cast<int>(type) : -1) ;
+  }
+
   // **************************
   // API Call definitions
   // **************************
@@ -17,6 +17,7 @@
 #ifndef VTF_EVENT_DOT_H
 #define VTF_EVENT_DOT_H
 
+#include <cstddef>
 #include <fstream>
 
 #include "xdp/config.h"
@@ -75,6 +76,30 @@ namespace xdp {
     UNKNOWN_EVENT = 70,
   } ;
 
+  // The fixed width binary form of a trace event in binary trace files
+  //  (see writer/vp_base/vp_binary_trace.h).  The fields are the
+  //  values that dump() writes after the event type, in the same order.
+  struct VTFBinaryRecord
+  {
+    static constexpr unsigned int maxFields = 8 ;
+
+    uint64_t id = 0 ;
+    uint64_t start_id = 0 ;
+    uint64_t timestamp = 0 ; // nanoseconds
+    uint32_t bucket = 0 ;
+    uint16_t type = 0 ;
+    uint8_t  numFields = 0 ;
+    uint8_t  hexFields = 0 ; // Bit i is set if field i is dumped in hex
+    uint64_t fields[maxFields] = {} ;
+
+    void addField(uint64_t value, bool hex = false)
+    {
+      if (numFields == maxFields) return ;
+      if (hex) hexFields |= static_cast<uint8_t>(1 << numFields) ;
+      fields[numFields++] = value ;
+    }
+  } ;
+
   class VTFEvent
   {
   private:
@@ -94,6 +119,11 @@ namespace xdp {
     XDP_EXPORT VTFEvent(uint64_t s_id, double ts, VTFEventType ty) ;
     XDP_EXPORT virtual ~VTFEvent() ;
 
+    // Events are created on every traced call, so they are allocated
+    //  from slabs cached per thread instead of the general heap
+    XDP_EXPORT static void* operator new(std::size_t size) ;
+    XDP_EXPORT static void operator delete(void* ptr, std::size_t size) ;
+
     // Getters and Setters
     inline double       getTimestamp()    const { return timestamp ; }
     inline void         setTimestamp(double ts) { timestamp = ts ; }
@@ -131,6 +161,11 @@ namespace xdp {
 
     virtual uint64_t getDevice() { return 0 ; } // CHECK
     XDP_EXPORT virtual void dump(std::ofstream& fout, uint32_t bucket) ;
+    XDP_EXPORT virtual void dumpBinary(VTFBinaryRecord& record, uint32_t bucket) ;
+
+    // The name of an event type as dumped in human readable traces,
+    //  or nullptr if the type has no name
+    XDP_EXPORT static const char* getTypeName(VTFEventType type) ;
   } ;
 
   // Used so the database can sort based on timestamp order
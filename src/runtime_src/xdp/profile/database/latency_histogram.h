@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_LATENCY_HISTOGRAM_DOT_H
+#define VP_LATENCY_HISTOGRAM_DOT_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace xdp {
+
+  // A histogram of durations in ns with a bounded relative error, in
+  //  the style of an HDR histogram.  Durations below 128 ns have their
+  //  own bucket.  Above that, every power of two range is split into 64
+  //  buckets, so a percentile is within 1/64 (1.6%) of the exact value.
+  //  Durations above 2^42 ns (73 minutes) fall in the last bucket.
+  //
+  // Recording a duration is one relaxed atomic increment, so any number
+  //  of threads can record without a lock while others read percentiles.
+  class LatencyHistogram
+  {
+  private:
+    static constexpr unsigned int subBucketBits = 7 ;
+    static constexpr uint64_t subBucketCount = 1ull << subBucketBits ;
+    static constexpr uint64_t subBucketHalf  = subBucketCount / 2 ;
+    static constexpr unsigned int maxExponent = 42 ;
+
+  public:
+    static constexpr size_t numBuckets =
+      subBucketCount + (maxExponent - subBucketBits + 1) * subBucketHalf ;
+
+  private:
+    std::atomic<uint64_t> buckets[numBuckets] ;
+    std::atomic<uint64_t> total ;
+
+    static unsigned int log2(uint64_t value)
+    {
+      unsigned int e = 0 ;
+      while (value >>= 1)
+        ++e ;
+      return e ;
+    }
+
+    static size_t index(uint64_t value)
+    {
+      if (value < subBucketCount)
+        return static_cast<size_t>(value) ;
+      unsigned int e = log2(value) ;
+      if (e > maxExponent)
+        return numBuckets - 1 ;
+      unsigned int shift = e - (subBucketBits - 1) ;
+      uint64_t sub = (value >> shift) - subBucketHalf ;
+      return static_cast<size_t>(subBucketCount +
+                                 (e - subBucketBits) * subBucketHalf + sub) ;
+    }
+
+    // The largest duration recorded in the bucket
+    static uint64_t upperBound(size_t i)
+    {
+      if (i < subBucketCount)
+        return i ;
+      size_t range = (i - subBucketCount) / subBucketHalf ;
+      uint64_t sub = (i - subBucketCount) % subBucketHalf + subBucketHalf ;
+      unsigned int shift = static_cast<unsigned int>(range) + 1 ;
+      return ((sub + 1) << shift) - 1 ;
+    }
+
+  public:
+    LatencyHistogram() : total(0)
+    {
+      for (auto& b : buckets)
+        b.store(0, std::memory_order_relaxed) ;
+    }
+
+    void record(uint64_t duration)
+    {
+      buckets[index(duration)].fetch_add(1, std::memory_order_relaxed) ;
+      total.fetch_add(1, std::memory_order_relaxed) ;
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed) ; }
+
+    // The duration that q (0 to 1) of the recorded durations do not
+    //  exceed, or 0 if nothing was recorded
+    uint64_t percentile(double q) const
+    {
+      uint64_t n = count() ;
+      if (n == 0)
+        return 0 ;
+      auto target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(n)));
+      if (target == 0)
+        target = 1 ;
+
+      uint64_t seen = 0 ;
+      for (size_t i = 0 ; i < numBuckets ; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed) ;
+        if (seen >= target)
+          return upperBound(i) ;
+      }
+      // Durations recorded while scanning are not all included
+      return upperBound(numBuckets - 1) ;
+    }
+  } ;
+
+} // end namespace xdp
+
+#endif
@@ -0,0 +1,265 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "xdp/profile/database/live_metrics.h"
+#include "core/common/message.h"
+
+namespace {
+
+  struct FamilyInfo
+  {
+    const char* countName ;
+    const char* prefix ;
+    const char* label ;  // nullptr if the label is a formatted label set
+    const char* help ;
+    bool hasBytes ;
+  } ;
+
+  const FamilyInfo families[xdp::LiveMetrics::NUM_FAMILIES] = {
+    { "xrt_api_calls_total", "xrt_api_call", "function",
+      "host API calls", false },
+    { "xrt_kernel_executions_total", "xrt_kernel_execution", "kernel",
+      "kernel executions", false },
+    { "xrt_compute_unit_executions_total", "xrt_compute_unit_execution",
+      "compute_unit", "compute unit executions", false },
+    { "xrt_host_reads_total", "xrt_host_read", "max_size_bytes",
+      "buffer reads from the device", true },
+    { "xrt_host_writes_total", "xrt_host_write", "max_size_bytes",
+      "buffer writes to the device", true },
+    { "xrt_hal_transfers_total", "xrt_hal_transfer", nullptr,
+      "buffer transfers timed at the HAL level", true }
+  } ;
+
+  const char* quantiles[] = { "0.5", "0.9", "0.99", "0.999" } ;
+
+  // Label values are quoted, so escape what the text format requires
+  std::string escape(const std::string& value)
+  {
+    std::string escaped ;
+    for (char c : value) {
+      if (c == '\\')      escaped += "\\\\" ;
+      else if (c == '"')  escaped += "\\\"" ;
+      else if (c == '\n') escaped += "\\n" ;
+      else                escaped += c ;
+    }
+    return escaped ;
+  }
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  LiveMetrics::LiveMetrics(unsigned int port) : listenSocket(-1), stop(false)
+  {
+#ifdef _WIN32
+    (void)port ;
+    xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                            "Debug.live_metrics_port is not supported on Windows") ;
+#else
+    listenSocket = socket(AF_INET, SOCK_STREAM, 0) ;
+    if (listenSocket < 0)
+      return ;
+
+    int reuse = 1 ;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) ;
+
+    // Only serve local scrapers
+    sockaddr_in addr = {} ;
+    addr.sin_family      = AF_INET ;
+    addr.sin_port        = htons(static_cast<uint16_t>(port)) ;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK) ;
+
+    if (bind(listenSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || listen(listenSocket, 4) < 0) {
+      std::string msg = "Unable to serve live metrics on port "
+                        + std::to_string(port) ;
+      xrt_core::message::send(xrt_core::message::severity_level::warning,
+                              "XRT", msg) ;
+      close(listenSocket) ;
+      listenSocket = -1 ;
+      return ;
+    }
+    server = std::thread(&LiveMetrics::serve, this) ;
+#endif
+  }
+
+  LiveMetrics::~LiveMetrics()
+  {
+    stop = true ;
+    if (server.joinable())
+      server.join() ;
+#ifndef _WIN32
+    if (listenSocket >= 0)
+      close(listenSocket) ;
+#endif
+  }
+
+  LiveCounter* LiveMetrics::getCounter(Family family, const std::string& label)
+  {
+    std::lock_guard<std::mutex> lock(countersLock) ;
+    auto& counter = counters[std::make_pair(family, label)] ;
+    if (!counter)
+      counter = std::make_unique<LiveCounter>() ;
+    return counter.get() ;
+  }
+
+  void LiveMetrics::record(Family family, const std::string& label,
+                           uint64_t time, uint64_t bytes,
+                           const LatencyHistogram* histogram)
+  {
+    LiveCounter* counter = getCounter(family, label) ;
+    if (histogram)
+      counter->histogram.store(histogram, std::memory_order_relaxed) ;
+
+    counter->count.fetch_add(1, std::memory_order_relaxed) ;
+    counter->totalTime.fetch_add(time, std::memory_order_relaxed) ;
+    if (bytes != 0)
+      counter->bytes.fetch_add(bytes, std::memory_order_relaxed) ;
+
+    uint64_t max = counter->maxTime.load(std::memory_order_relaxed) ;
+    while (time > max &&
+           !counter->maxTime.compare_exchange_weak(max, time,
+                                                   std::memory_order_relaxed))
+      ;
+  }
+
+  std::string LiveMetrics::format()
+  {
+    // Copy the counter pointers so logging threads only wait for the
+    //  copy, not for the formatting
+    std::vector<std::pair<std::pair<Family, std::string>, LiveCounter*>> all ;
+    {
+      std::lock_guard<std::mutex> lock(countersLock) ;
+      all.reserve(counters.size()) ;
+      for (auto& c : counters)
+        all.emplace_back(c.first, c.second.get()) ;
+    }
+
+    std::stringstream count, time, max, bytes, latency ;
+    std::stringstream out ;
+    auto start = all.begin() ;
+    for (int f = 0 ; f < NUM_FAMILIES ; ++f) {
+      const FamilyInfo& info = families[f] ;
+      count.str("") ; time.str("") ; max.str("") ; bytes.str("") ;
+      latency.str("") ;
+
+      // The map is ordered by family, so each family is a contiguous range
+      for ( ; start != all.end() && start->first.first == f ; ++start) {
+        std::string label = info.label == nullptr ? start->first.second
+          : std::string(info.label) + "=\"" + escape(start->first.second)
+            + "\"" ;
+        std::string labels = "{" + label + "} " ;
+        LiveCounter* c = start->second ;
+        count << info.countName << labels
+              << c->count.load(std::memory_order_relaxed) << "\n" ;
+        time << info.prefix << "_time_ns_total" << labels
+             << c->totalTime.load(std::memory_order_relaxed) << "\n" ;
+        max << info.prefix << "_max_time_ns" << labels
+            << c->maxTime.load(std::memory_order_relaxed) << "\n" ;
+        if (info.hasBytes)
+          bytes << info.prefix << "_bytes_total" << labels
+                << c->bytes.load(std::memory_order_relaxed) << "\n" ;
+
+        const LatencyHistogram* h = c->histogram.load(std::memory_order_relaxed);
+        if (h) {
+          for (auto q : quantiles)
+            latency << info.prefix << "_latency_ns{" << label
+                    << ",quantile=\"" << q << "\"} "
+                    << h->percentile(std::stod(q)) << "\n" ;
+        }
+      }
+      if (count.tellp() <= 0)
+        continue ;
+
+      out << "# HELP " << info.countName << " Number of " << info.help << "\n"
+          << "# TYPE " << info.countName << " counter\n" << count.str()
+          << "# HELP " << info.prefix << "_time_ns_total Total time of "
+          << info.help << " in ns\n"
+          << "# TYPE " << info.prefix << "_time_ns_total counter\n"
+          << time.str()
+          << "# HELP " << info.prefix << "_max_time_ns Longest of the "
+          << info.help << " in ns\n"
+          << "# TYPE " << info.prefix << "_max_time_ns gauge\n" << max.str() ;
+      if (info.hasBytes)
+        out << "# HELP " << info.prefix << "_bytes_total Bytes of "
+            << info.help << "\n"
+            << "# TYPE " << info.prefix << "_bytes_total counter\n"
+            << bytes.str() ;
+      if (latency.tellp() > 0)
+        out << "# HELP " << info.prefix << "_latency_ns Percentiles of the "
+            << info.help << " in ns\n"
+            << "# TYPE " << info.prefix << "_latency_ns gauge\n"
+            << latency.str() ;
+    }
+    return out.str() ;
+  }
+
+  // Every connection is answered with the current values as a minimal
+  //  HTTP response, whatever the path requested, and closed
+  void LiveMetrics::serve()
+  {
+#ifndef _WIN32
+    while (!stop) {
+      pollfd pfd = { listenSocket, POLLIN, 0 } ;
+      if (poll(&pfd, 1, 200) <= 0)
+        continue ;
+
+      int client = accept(listenSocket, nullptr, nullptr) ;
+      if (client < 0)
+        continue ;
+
+      // Wait briefly for the request, its content is not needed
+      pollfd cfd = { client, POLLIN, 0 } ;
+      if (poll(&cfd, 1, 1000) > 0) {
+        char request[1024] ;
+        (void)recv(client, request, sizeof(request), 0) ;
+      }
+
+      std::string body = format() ;
+      std::string response =
+        "HTTP/1.0 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + body ;
+
+      const char* p = response.data() ;
+      size_t left = response.size() ;
+      while (left > 0) {
+        ssize_t sent = send(client, p, left, MSG_NOSIGNAL) ;
+        if (sent <= 0)
+          break ;
+        p += sent ;
+        left -= static_cast<size_t>(sent) ;
+      }
+      close(client) ;
+    }
+#endif
+  }
+
+} // end namespace xdp
@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_LIVE_METRICS_DOT_H
+#define VP_LIVE_METRICS_DOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "xdp/profile/database/latency_histogram.h"
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // Counters of one API function, kernel, compute unit, or host
+  //  transfer direction.  They are only ever incremented, so a scraper
+  //  computes throughput and average latency from successive values.
+  struct LiveCounter
+  {
+    std::atomic<uint64_t> count ;
+    std::atomic<uint64_t> totalTime ; // ns
+    std::atomic<uint64_t> maxTime ;   // ns
+    std::atomic<uint64_t> bytes ;
+
+    // Distribution of the durations, owned by the statistics database
+    std::atomic<const LatencyHistogram*> histogram ;
+
+    LiveCounter() : count(0), totalTime(0), maxTime(0), bytes(0),
+                    histogram(nullptr) { }
+  } ;
+
+  // When Debug.live_metrics_port is set, the statistics database also
+  //  keeps a LiveMetrics object that serves the counters in the
+  //  Prometheus text format on the loopback interface while the
+  //  application runs.  Each request is answered from a background
+  //  thread with the current values, logging never waits for a scrape.
+  class LiveMetrics
+  {
+  public:
+    enum Family {
+      API_CALL     = 0,
+      KERNEL       = 1,
+      COMPUTE_UNIT = 2,
+      HOST_READ    = 3,
+      HOST_WRITE   = 4,
+      HAL_TRANSFER = 5,
+      NUM_FAMILIES = 6
+    } ;
+
+  private:
+    // Counters are never removed, so pointers handed out stay valid.
+    //  The lock only protects insertion and iteration of the map.
+    std::mutex countersLock ;
+    std::map<std::pair<Family, std::string>, std::unique_ptr<LiveCounter>>
+      counters ;
+
+    int listenSocket ;
+    std::atomic<bool> stop ;
+    std::thread server ;
+
+    void serve() ;
+    std::string format() ;
+
+  public:
+    LiveMetrics(unsigned int port) ;
+    ~LiveMetrics() ;
+
+    // The counter for the given label, added the first time
+    XDP_EXPORT LiveCounter* getCounter(Family family, const std::string& label);
+
+    XDP_EXPORT void record(Family family, const std::string& label,
+                           uint64_t time, uint64_t bytes = 0,
+                           const LatencyHistogram* histogram = nullptr) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
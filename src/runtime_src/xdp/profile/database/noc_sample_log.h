@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_NOC_SAMPLE_LOG_DOT_H
+#define VP_NOC_SAMPLE_LOG_DOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xdp {
+
+  // The NoC counter samples of one device, stored by column in chunks of
+  //  fixed size.  A sample holds the counters of one NMU.  The polling
+  //  thread is the only writer.  It appends the samples of all NMUs read
+  //  in one sweep and then publishes them with a single release store,
+  //  so readers can read all published samples at any time without a
+  //  lock.  Appending only allocates when a chunk is full.
+  class NOCSampleLog
+  {
+  public:
+    static constexpr size_t chunkSize = 4096 ;
+
+    // Counters of an NMU, in the order they are reported
+    enum Counter {
+      READ_BYTE_COUNT = 0,
+      READ_BURST_COUNT,
+      READ_TOTAL_LATENCY,
+      READ_MIN_LATENCY,
+      READ_MAX_LATENCY,
+      WRITE_BYTE_COUNT,
+      WRITE_BURST_COUNT,
+      WRITE_TOTAL_LATENCY,
+      WRITE_MIN_LATENCY,
+      WRITE_MAX_LATENCY,
+      NUM_COUNTERS
+    } ;
+
+    struct Sample
+    {
+      double timestamp ; // ms
+      uint32_t nmu ;     // Index of the NMU in the static database
+      uint64_t values[NUM_COUNTERS] ;
+    } ;
+
+  private:
+    struct Chunk
+    {
+      double   timestamp[chunkSize] ;
+      uint32_t nmu[chunkSize] ;
+      uint64_t values[NUM_COUNTERS][chunkSize] ;
+      std::atomic<Chunk*> next ;
+
+      Chunk() : next(nullptr) { }
+    } ;
+
+    Chunk* first ;
+
+    // Only used by the polling thread
+    Chunk* tail ;
+    size_t tailCount ;
+    uint64_t appended ;
+
+    std::atomic<uint64_t> published ;
+
+  public:
+    NOCSampleLog() : first(new Chunk), tailCount(0), appended(0), published(0)
+    {
+      tail = first ;
+    }
+
+    ~NOCSampleLog()
+    {
+      Chunk* c = first ;
+      while (c != nullptr) {
+        Chunk* next = c->next.load(std::memory_order_relaxed) ;
+        delete c ;
+        c = next ;
+      }
+    }
+
+    NOCSampleLog(const NOCSampleLog&) = delete ;
+    NOCSampleLog& operator=(const NOCSampleLog&) = delete ;
+
+    // Append the counters of count NMUs read at the same time.  The
+    //  counters of NMU i are values[i * NUM_COUNTERS ...].
+    void append(double timestamp, uint32_t firstNmu, size_t count,
+                const uint64_t* values)
+    {
+      for (size_t n = 0 ; n < count ; ++n) {
+        if (tailCount == chunkSize) {
+          Chunk* c = new Chunk ;
+          tail->next.store(c, std::memory_order_release) ;
+          tail = c ;
+          tailCount = 0 ;
+        }
+        size_t i = tailCount++ ;
+        tail->timestamp[i] = timestamp ;
+        tail->nmu[i] = firstNmu + static_cast<uint32_t>(n) ;
+        for (size_t v = 0 ; v < NUM_COUNTERS ; ++v)
+          tail->values[v][i] = values[n * NUM_COUNTERS + v] ;
+      }
+      appended += count ;
+    }
+
+    // Make the samples appended so far visible to readers
+    void publish()
+    {
+      published.store(appended, std::memory_order_release) ;
+    }
+
+    uint64_t size() const { return published.load(std::memory_order_acquire) ; }
+
+    // Call f with every published sample, in the order appended
+    template <typename Function>
+    void forEach(Function f) const
+    {
+      uint64_t n = size() ;
+      const Chunk* c = first ;
+      while (n > 0 && c != nullptr) {
+        size_t count = n < chunkSize ? static_cast<size_t>(n) : chunkSize ;
+        for (size_t i = 0 ; i < count ; ++i) {
+          Sample s ;
+          s.timestamp = c->timestamp[i] ;
+          s.nmu = c->nmu[i] ;
+          for (size_t v = 0 ; v < NUM_COUNTERS ; ++v)
+            s.values[v] = c->values[v][i] ;
+          f(s) ;
+        }
+        n -= count ;
+        c = c->next.load(std::memory_order_acquire) ;
+      }
+    }
+  } ;
+
+} // end namespace xdp
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_START_RING_DOT_H
+#define VP_START_RING_DOT_H
+
+#include <cstddef>
+#include <vector>
+
+namespace xdp {
+
+  // A first in, first out queue of start events waiting for their
+  //  end event.  The entries live in a ring that is reused as starts
+  //  are matched, so matching device events does not allocate once
+  //  the ring has grown to the number of starts a monitor keeps
+  //  outstanding, which is almost always one or two.
+  //
+  // Ends are usually matched with the oldest start, but a monitor can
+  //  have starts of several types outstanding, so an entry can also be
+  //  taken from the middle of the ring.
+  template <typename T>
+  class StartRing
+  {
+  private:
+    std::vector<T> slots ;
+    size_t head = 0 ;
+    size_t count = 0 ;
+
+    size_t index(size_t i) const { return (head + i) % slots.size() ; }
+
+    void grow()
+    {
+      std::vector<T> bigger ;
+      bigger.reserve(slots.empty() ? 2 : slots.size() * 2) ;
+      for (size_t i = 0 ; i < count ; ++i)
+        bigger.push_back(slots[index(i)]) ;
+      bigger.resize(bigger.capacity()) ;
+      slots.swap(bigger) ;
+      head = 0 ;
+    }
+
+  public:
+    bool empty() const { return count == 0 ; }
+    size_t size() const { return count ; }
+
+    void push_back(const T& value)
+    {
+      if (count == slots.size())
+        grow() ;
+      slots[index(count)] = value ;
+      ++count ;
+    }
+
+    const T& front() const { return slots[head] ; }
+
+    void pop_front()
+    {
+      head = index(1) ;
+      --count ;
+    }
+
+    // Find the oldest entry satisfying pred
+    template <typename Pred>
+    const T* find(Pred pred) const
+    {
+      for (size_t i = 0 ; i < count ; ++i) {
+        const T& value = slots[index(i)] ;
+        if (pred(value))
+          return &value ;
+      }
+      return nullptr ;
+    }
+
+    // Remove the oldest entry satisfying pred and return it in value
+    template <typename Pred>
+    bool take(Pred pred, T& value)
+    {
+      for (size_t i = 0 ; i < count ; ++i) {
+        if (!pred(slots[index(i)]))
+          continue ;
+        value = slots[index(i)] ;
+        if (i == 0) {
+          pop_front() ;
+          return true ;
+        }
+        // Close the gap, later entries keep their order
+        for (size_t j = i + 1 ; j < count ; ++j)
+          slots[index(j - 1)] = slots[index(j)] ;
+        --count ;
+        return true ;
+      }
+      return false ;
+    }
+  } ;
+
+} // end namespace xdp
+
+#endif
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include "core/common/clock_correlation.h"
 #include "core/common/system.h"
 
 #include "xdp/config.h"
@@ -73,6 +74,10 @@ namespace xdp {
     //  string is reset every time we load a new xclbin
     std::string ctxInfo ;
 
+    // Correlation of the device trace clock with host time, shared
+    //  with XRT and the application
+    std::shared_ptr<xrt_core::clock_correlation> clock ;
+
     ~DeviceInfo() ;
 
     // ****** Functions for information on the device ******
@@ -364,6 +364,16 @@ namespace xdp {
     xclbin->deviceIntf = devIntf ;
   }
 
+  std::shared_ptr<xrt_core::clock_correlation>
+  VPStaticDatabase::getClockCorrelation(uint64_t deviceId)
+  {
+    std::lock_guard<std::mutex> lock(deviceLock) ;
+
+    if (deviceInfo.find(deviceId) == deviceInfo.end())
+      return nullptr ;
+    return deviceInfo[deviceId]->clock ;
+  }
+
   DeviceIntf* VPStaticDatabase::getDeviceIntf(uint64_t deviceId)
   {
     std::lock_guard<std::mutex> lock(deviceLock) ;
@@ -1299,6 +1309,11 @@ namespace xdp {
       devInfo = itr->second ;
       devInfo->cleanCurrentXclbinInfo() ;
     }
+
+    // Loading an xclbin resets the trace clock, so previous clock
+    //  training no longer applies
+    devInfo->clock = xrt_core::clock_correlation::get(device->get_device_id()) ;
+    devInfo->clock->reset() ;
     
     XclbinInfo* currentXclbin = new XclbinInfo() ;
     currentXclbin->uuid = device->get_xclbin_uuid() ;
@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "core/common/clock_correlation.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
 
@@ -214,6 +215,8 @@ namespace xdp {
     XDP_EXPORT void deleteCurrentlyUsedDeviceInterface(uint64_t deviceId) ;
     XDP_EXPORT bool isDeviceReady(uint64_t deviceId) ;
     XDP_EXPORT double getClockRateMHz(uint64_t deviceId, bool PL = true) ;
+    XDP_EXPORT std::shared_ptr<xrt_core::clock_correlation>
+    getClockCorrelation(uint64_t deviceId) ;
     XDP_EXPORT void setDeviceName(uint64_t deviceId, const std::string& name) ;
     XDP_EXPORT std::string getDeviceName(uint64_t deviceId) ;
     XDP_EXPORT void setDeviceIntf(uint64_t deviceId, DeviceIntf* devIntf) ;
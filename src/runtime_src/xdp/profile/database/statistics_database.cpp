@@ -14,6 +14,7 @@
  * under the License.
  */
 
+#include <algorithm>
 #include <vector>
 #include <thread>
 #include <iostream>
@@ -21,6 +22,7 @@
 #define XDP_SOURCE
 
 #include "xdp/profile/database/statistics_database.h"
+#include "core/common/config_reader.h"
 
 namespace xdp {
 
@@ -28,14 +30,27 @@ namespace xdp {
     db(d), numMigrateMemCalls(0), numHostP2PTransfers(0),
     numObjectsReleased(0), contextEnabled(false),
     totalHostReadTime(0), totalHostWriteTime(0), totalBufferStartTime(0),
-    totalBufferEndTime(0), firstKernelStartTime(0.0), lastKernelEndTime(0.0)
+    totalBufferEndTime(0), kernelSeen(false),
+    busyStart(0.0), busyEnd(0.0), idleWritesEnd(0.0), idleWriteTime(0.0),
+    firstKernelStartTime(0.0), lastKernelEndTime(0.0)
   {
+    unsigned int port = xrt_core::config::get_live_metrics_port() ;
+    if (port != 0)
+      liveMetrics = std::make_unique<LiveMetrics>(port) ;
   }
 
   VPStatisticsDatabase::~VPStatisticsDatabase()
   {
   }
 
+  uint64_t VPStatisticsDatabase::getSizeBucket(uint64_t size)
+  {
+    uint64_t bucket = 1 ;
+    while (bucket < size && bucket < (1ull << 63))
+      bucket <<= 1 ;
+    return bucket ;
+  }
+
   void VPStatisticsDatabase::addTopHostRead(BufferTransferStats& transfer)
   {
     // Edge case: First read.
@@ -158,12 +173,27 @@ namespace xdp {
     return calls;
   }
 
+  std::map<std::string, TimeStatistics> VPStatisticsDatabase::getCallStats()
+  {
+    std::lock_guard<std::mutex> lock(dbLock) ;
+    return callStats ;
+  }
+
+  std::map<std::string, SerialWriteStatistics>
+  VPStatisticsDatabase::getSerialWrites()
+  {
+    std::lock_guard<std::mutex> lock(serialLock) ;
+    return serialWrites ;
+  }
+
   uint64_t VPStatisticsDatabase::getDeviceActiveTime(const std::string& deviceName)
   {
-    if (deviceActiveTimes.find(deviceName) == deviceActiveTimes.end())
+    // Summary tables are generated in parallel, so look up without
+    //  inserting
+    auto time = deviceActiveTimes.find(deviceName) ;
+    if (time == deviceActiveTimes.end())
       return 0 ;
-    std::pair<uint64_t, uint64_t> time = deviceActiveTimes[deviceName] ;
-    return time.second - time.first ;
+    return time->second.second - time->second.first ;
   }
 
   void VPStatisticsDatabase::addEventCount(const char* label)
@@ -211,19 +241,7 @@ namespace xdp {
     std::lock_guard<std::mutex> lock(dbLock) ;
 
     auto threadId = std::this_thread::get_id() ;
-    auto key      = std::make_pair(name, threadId) ;
-    auto value    = std::make_pair(timestamp, (double)0.0) ;
-
-    if (callCount.find(key) == callCount.end())
-    {
-      std::vector<std::pair<double, double>> newVector ;
-      newVector.push_back(value) ;
-      callCount[key] = newVector ;
-    }
-    else
-    {
-      callCount[key].push_back(value) ;
-    }
+    callStarts[std::make_pair(name, threadId)] = timestamp ;
 
     // OpenCL specific information 
     if (name == "clEnqueueMigrateMemObjects") addMigrateMemCall() ;
@@ -235,9 +253,46 @@ namespace xdp {
     std::lock_guard<std::mutex> lock(dbLock) ;
 
     auto threadId = std::this_thread::get_id() ;
-    auto key      = std::make_pair(name, threadId) ;
-    
-    callCount[key].back().second = timestamp ;
+    auto start    = callStarts.find(std::make_pair(name, threadId)) ;
+    if (start == callStarts.end())
+      return ;
+
+    double startTime = start->second ;
+    callStarts.erase(start) ;
+    if (timestamp < startTime)
+      return ;
+
+    auto duration = static_cast<uint64_t>(timestamp - startTime) ;
+    callStats[name].update(duration) ;
+
+    if (liveMetrics && startTime != 0.0)
+      liveMetrics->record(LiveMetrics::API_CALL, name, duration) ;
+  }
+
+  void VPStatisticsDatabase::logHALTransfer(uint64_t deviceId,
+                                            HALTransferStatistics::TransferType type,
+                                            uint64_t size, uint64_t duration)
+  {
+    uint64_t sizeBucket = getSizeBucket(size) ;
+    HALTransferStatistics* stats =
+      getHistogram(halTransfers, std::make_tuple(deviceId,
+                                                 static_cast<uint64_t>(type),
+                                                 sizeBucket)) ;
+    stats->totalBytes.fetch_add(size, std::memory_order_relaxed) ;
+    stats->totalTime.fetch_add(duration, std::memory_order_relaxed) ;
+    stats->durations.record(duration) ;
+    // Bytes per nanosecond is GB/s
+    if (duration != 0)
+      stats->bandwidth.record(size * 1000 / duration) ;
+
+    if (liveMetrics) {
+      static const char* directions[] = { "read", "write", "copy" } ;
+      std::string labels = "device=\"" + std::to_string(deviceId)
+        + "\",direction=\"" + directions[type]
+        + "\",max_size_bytes=\"" + std::to_string(sizeBucket) + "\"" ;
+      liveMetrics->record(LiveMetrics::HAL_TRANSFER, labels, duration, size,
+                          &stats->durations) ;
+    }
   }
 
   void VPStatisticsDatabase::logMemoryTransfer(uint64_t deviceId,
@@ -291,6 +346,11 @@ namespace xdp {
       kernelExecutionStats[kernelName] = blank ;
     }
     (kernelExecutionStats[kernelName]).update(executionTime) ;
+    LatencyHistogram* histogram = getHistogram(kernelHistograms, kernelName) ;
+    histogram->record(executionTime) ;
+    if (liveMetrics)
+      liveMetrics->record(LiveMetrics::KERNEL, kernelName, executionTime, 0,
+                          histogram) ;
     kernelGlobalWorkGroups[kernelName] = globalWorkSize ;
 
     // Also keep track of top kernel executions
@@ -340,6 +400,11 @@ namespace xdp {
       computeUnitExecutionStats[combinedName] = blank ;
     }
     (computeUnitExecutionStats[combinedName]).update(executionTime) ;
+    LatencyHistogram* histogram = getHistogram(cuHistograms, computeUnitName) ;
+    histogram->record(executionTime) ;
+    if (liveMetrics)
+      liveMetrics->record(LiveMetrics::COMPUTE_UNIT, computeUnitName,
+                          executionTime, 0, histogram) ;
   }
 
   void VPStatisticsDatabase::logHostRead(uint64_t contextId, uint64_t deviceId,
@@ -360,6 +425,13 @@ namespace xdp {
     }
 
     hostReads[identifier].update(size, transferTime) ;
+    uint64_t sizeBucket = getSizeBucket(size) ;
+    LatencyHistogram* histogram =
+      getHistogram(hostReadHistograms, sizeBucket) ;
+    histogram->record(transferTime) ;
+    if (liveMetrics)
+      liveMetrics->record(LiveMetrics::HOST_READ, std::to_string(sizeBucket),
+                          transferTime, size, histogram) ;
 
     totalHostReadTime += transferTime ;
 
@@ -392,6 +464,13 @@ namespace xdp {
     }
 
     hostWrites[identifier].update(size, transferTime) ;
+    uint64_t sizeBucket = getSizeBucket(size) ;
+    LatencyHistogram* histogram =
+      getHistogram(hostWriteHistograms, sizeBucket) ;
+    histogram->record(transferTime) ;
+    if (liveMetrics)
+      liveMetrics->record(LiveMetrics::HOST_WRITE, std::to_string(sizeBucket),
+                          transferTime, size, histogram) ;
 
     totalHostWriteTime += transferTime ;
 
@@ -406,6 +485,68 @@ namespace xdp {
     addTopHostWrite(transfer) ;
   }
 
+  // Host events arrive in time order.  A kernel enqueue that starts
+  //  with no kernel running closes the idle period since the last
+  //  kernel ended, and the writes done in that period could have
+  //  overlapped the kernels before it.
+  void VPStatisticsDatabase::logKernelEnqueue(uint64_t id, bool isStart,
+                                              const std::string& kernelName,
+                                              double timestamp)
+  {
+    std::lock_guard<std::mutex> lock(serialLock) ;
+
+    if (!isStart) {
+      if (runningEnqueues.erase(id) == 0)
+        return ;
+      busyEnd = std::max(busyEnd, timestamp) ;
+      idleWritesEnd = busyEnd ;
+      return ;
+    }
+
+    bool idle = runningEnqueues.empty() ;
+    runningEnqueues.insert(id) ;
+    if (!idle)
+      return ;
+
+    if (kernelSeen && idleWriteTime > 0) {
+      SerialWriteStatistics& stats = serialWrites[kernelName] ;
+      if (stats.count == 0)
+        stats.firstTime = timestamp ;
+      ++stats.count ;
+      stats.timeLost += std::min(idleWriteTime, busyEnd - busyStart) ;
+    }
+    kernelSeen = true ;
+    busyStart = timestamp ;
+    busyEnd = timestamp ;
+    idleWriteTime = 0 ;
+  }
+
+  void VPStatisticsDatabase::logBufferWrite(uint64_t id, bool isStart,
+                                            double timestamp)
+  {
+    std::lock_guard<std::mutex> lock(serialLock) ;
+
+    if (isStart) {
+      writeStarts[id] = timestamp ;
+      return ;
+    }
+
+    auto start = writeStarts.find(id) ;
+    if (start == writeStarts.end())
+      return ;
+    double startTime = start->second ;
+    writeStarts.erase(start) ;
+
+    // Only writes entirely inside an idle period count, and writes that
+    //  overlap each other are only counted once
+    if (!kernelSeen || !runningEnqueues.empty() || startTime < busyEnd)
+      return ;
+    double from = std::max(startTime, idleWritesEnd) ;
+    if (timestamp > from)
+      idleWriteTime += timestamp - from ;
+    idleWritesEnd = std::max(idleWritesEnd, timestamp) ;
+  }
+
   void VPStatisticsDatabase::updateCounters(uint64_t /*deviceId*/,
                                              xclCounterResults& /*counters*/)
   {
@@ -423,25 +564,11 @@ namespace xdp {
 
   void VPStatisticsDatabase::dumpCallCount(std::ofstream& fout)
   {
-    // For each function call, across all of the threads, find out
+    // For each function call, across all of the threads, dump
     //  the number of calls
-    std::map<std::string, uint64_t> counts ;
-
-    for (auto c : callCount)
-    {
-      if (counts.find(c.first.first) == counts.end())
-      {
-        counts[c.first.first] = c.second.size() ;
-      }
-      else
-      {
-        counts[c.first.first] += c.second.size() ;
-      }
-    }
-
-    for (auto i : counts)
+    for (auto& call : getCallStats())
     {
-      fout << i.first << "," << i.second << std::endl ;
+      fout << call.first << "," << call.second.numExecutions << std::endl ;
     }
   }
 
@@ -17,18 +17,23 @@
 #ifndef VP_STATISTICS_DATABASE_DOT_H
 #define VP_STATISTICS_DATABASE_DOT_H
 
+#include <atomic>
 #include <string>
 #include <mutex>
 #include <thread>
 #include <map>
+#include <set>
 #include <vector>
 #include <fstream>
 #include <tuple>
 #include <list>
+#include <memory>
 
 // For the device results structures
 #include "xclperf.h"
 
+#include "xdp/profile/database/latency_histogram.h"
+#include "xdp/profile/database/live_metrics.h"
 #include "xdp/config.h"
 
 namespace xdp {
@@ -147,6 +152,15 @@ namespace xdp {
     }
   } ;
 
+  struct SerialWriteStatistics
+  {
+    uint64_t count ;
+    double timeLost ;  // Write time that could have overlapped a kernel
+    double firstTime ; // Start of the first kernel that waited
+
+    SerialWriteStatistics() : count(0), timeLost(0), firstTime(0) { }
+  } ;
+
   struct MemoryChannelStatistics
   {
     uint64_t transactionCount ;
@@ -168,15 +182,36 @@ namespace xdp {
     MemoryChannelStatistics channels[6] ;
   } ;
 
+  // Buffer transfers timed at the HAL level, collected per device,
+  //  direction, and size bucket without trace.  The totals and
+  //  histograms are recorded without a lock.
+  struct HALTransferStatistics
+  {
+    enum TransferType {
+      READ  = 0,
+      WRITE = 1,
+      COPY  = 2
+    } ;
+
+    std::atomic<uint64_t> totalBytes ;
+    std::atomic<uint64_t> totalTime ; // ns
+    LatencyHistogram durations ;      // ns
+    LatencyHistogram bandwidth ;      // MB/s
+
+    HALTransferStatistics() : totalBytes(0), totalTime(0) { }
+  } ;
+
   class VPStatisticsDatabase 
   {
   private:
     VPDatabase* db ;
 
   private:
-    // Statistics on API calls (OpenCL and HAL) have to be thread specific
-    std::map<std::pair<std::string, std::thread::id>,
-             std::vector<std::pair<double, double>>> callCount ;
+    // Statistics on API calls (OpenCL and HAL) are aggregated as each
+    //  call ends.  Only the start times of the calls in progress are
+    //  kept, and those have to be thread specific.
+    std::map<std::pair<std::string, std::thread::id>, double> callStarts ;
+    std::map<std::string, TimeStatistics> callStats ;
 
     // **** User Level Event Statistics ****
     std::map<std::string, uint64_t> eventCounts ;
@@ -229,6 +264,19 @@ namespace xdp {
     const uint64_t numTopKernelExecutions = 10 ;
     std::list<KernelExecutionStats> topKernelExecutions ;
 
+    // Buffer writes done while no kernel was running, right before a
+    //  kernel started, per kernel.  These are found as the host events
+    //  arrive, so only the current state of the host is kept.
+    std::map<std::string, SerialWriteStatistics> serialWrites ;
+    std::set<uint64_t> runningEnqueues ;
+    std::map<uint64_t, double> writeStarts ;
+    bool kernelSeen ;
+    double busyStart ;
+    double busyEnd ;
+    double idleWritesEnd ;
+    double idleWriteTime ;
+    std::mutex serialLock ;
+
     // Keep track of the device start and end times
     std::map<std::string, std::pair<uint64_t, uint64_t>> deviceActiveTimes ;
 
@@ -236,12 +284,39 @@ namespace xdp {
     double firstKernelStartTime ;
     double lastKernelEndTime ;
 
+    // Distributions of kernel, compute unit, and host transfer durations
+    //  for percentiles.  Host transfers are bucketed by size, the key is
+    //  the power of two the transfer size does not exceed.  Histograms
+    //  are never removed, so lookup takes a lock but recording does not.
+    std::mutex histogramLock ;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> kernelHistograms ;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> cuHistograms ;
+    std::map<uint64_t, std::unique_ptr<LatencyHistogram>> hostReadHistograms ;
+    std::map<uint64_t, std::unique_ptr<LatencyHistogram>> hostWriteHistograms ;
+    std::map<std::tuple<uint64_t, uint64_t, uint64_t>,
+             std::unique_ptr<HALTransferStatistics>> halTransfers ;
+
+    // Counters served while the application runs, if enabled
+    std::unique_ptr<LiveMetrics> liveMetrics ;
+
     // Since the host code can be multithreaded, we must protect 
     //  the data
     std::mutex readsLock ;
     std::mutex writesLock ;
     std::mutex dbLock ;
 
+    template <typename Key, typename Histogram>
+    Histogram*
+    getHistogram(std::map<Key, std::unique_ptr<Histogram>>& histograms,
+                 const Key& key)
+    {
+      std::lock_guard<std::mutex> lock(histogramLock) ;
+      auto& histogram = histograms[key] ;
+      if (!histogram)
+        histogram = std::make_unique<Histogram>() ;
+      return histogram.get() ;
+    }
+
     // Helper functions for OpenCL
     void addTopHostRead(BufferTransferStats& transfer) ;
     void addTopHostWrite(BufferTransferStats& transfer) ;
@@ -252,9 +327,7 @@ namespace xdp {
     XDP_EXPORT ~VPStatisticsDatabase() ;
 
     // Getters and setters
-    inline const std::map<std::pair<std::string, std::thread::id>,
-                    std::vector<std::pair<double, double>>>& getCallCount() 
-      { return callCount ; }
+    XDP_EXPORT std::map<std::string, TimeStatistics> getCallStats() ;
     inline const std::map<uint64_t, DeviceMemoryStatistics>& getMemoryStats() 
       { return memoryStats ; }
     inline const std::map<std::string, TimeStatistics>& getKernelExecutionStats() 
@@ -264,6 +337,19 @@ namespace xdp {
       { return computeUnitExecutionStats ; }
     inline std::map<std::pair<uint64_t, uint64_t>, BufferStatistics>& getHostReads() { return hostReads ; }
     inline std::map<std::pair<uint64_t, uint64_t>, BufferStatistics>& getHostWrites() { return hostWrites ; }
+    inline const std::map<std::string, std::unique_ptr<LatencyHistogram>>&
+    getKernelHistograms() { return kernelHistograms ; }
+    inline const std::map<std::string, std::unique_ptr<LatencyHistogram>>&
+    getComputeUnitHistograms() { return cuHistograms ; }
+    inline const std::map<uint64_t, std::unique_ptr<LatencyHistogram>>&
+    getHostReadHistograms() { return hostReadHistograms ; }
+    inline const std::map<uint64_t, std::unique_ptr<LatencyHistogram>>&
+    getHostWriteHistograms() { return hostWriteHistograms ; }
+    // Keyed by device ID, transfer type, and size bucket
+    inline const std::map<std::tuple<uint64_t, uint64_t, uint64_t>,
+                          std::unique_ptr<HALTransferStatistics>>&
+    getHALTransfers() { return halTransfers ; }
+    XDP_EXPORT static uint64_t getSizeBucket(uint64_t size) ;
     inline std::list<BufferTransferStats>& getTopHostReads() { return topHostReads ; }
     inline std::list<BufferTransferStats>& getTopHostWrites() { return topHostWrites ; }
     inline std::list<KernelExecutionStats>& getTopKernelExecutions() { return topKernelExecutions ; }
@@ -303,6 +389,7 @@ namespace xdp {
     inline void setCommandQueueOOO(uint64_t cq, bool value)
       { commandQueuesAreOOO[cq] = value ; }
     XDP_EXPORT uint64_t getDeviceActiveTime(const std::string& deviceName) ;
+    XDP_EXPORT std::map<std::string, SerialWriteStatistics> getSerialWrites() ;
 
     // Functions specific to compute unit executions
     XDP_EXPORT
@@ -336,6 +423,10 @@ namespace xdp {
     XDP_EXPORT void logFunctionCallEnd(const std::string& name, 
                                        double timestamp) ;
 
+    XDP_EXPORT void logHALTransfer(uint64_t deviceId,
+                                   HALTransferStatistics::TransferType type,
+                                   uint64_t size, uint64_t duration) ;
+
     XDP_EXPORT void logMemoryTransfer(uint64_t deviceId, 
                                       DeviceMemoryStatistics::ChannelType channelType,
                                       size_t byteCount) ;
@@ -371,6 +462,12 @@ namespace xdp {
                                  uint64_t address,
                                  uint64_t commandQueueId) ;
 
+    XDP_EXPORT void logKernelEnqueue(uint64_t id, bool isStart,
+                                     const std::string& kernelName,
+                                     double timestamp) ;
+    XDP_EXPORT void logBufferWrite(uint64_t id, bool isStart,
+                                   double timestamp) ;
+
     XDP_EXPORT void updateCounters(uint64_t deviceId, 
                                    xclCounterResults& counters) ;
     XDP_EXPORT void updateCounters(xclCounterResults& counters) ;
@@ -17,8 +17,11 @@
 #define XDP_SOURCE
 
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "core/common/message.h"
+#include "core/common/thread.h"
 
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/database/static_info/aie_constructs.h"
@@ -197,24 +200,28 @@ void AIETraceOffload::endReadTrace()
 
 void AIETraceOffload::readTrace()
 {
-  for(uint64_t i = 0; i < numStream; ++i) {
-    if(isPLIO) {
-      configAIETs2mm(i);
-    } else { 
-      buffers[i].usedSz = bufAllocSz;
-    }
-    uint64_t totalBytesRead = 0;
-    while (1) {
-      auto bytes = readPartialTrace(i);
-      totalBytesRead += bytes;
-      if (totalBytesRead >= bufAllocSz) {
-        buffers[i].isFull = true;
-        break;
-      }
+  for(uint64_t i = 0; i < numStream; ++i)
+    readStreamTrace(i);
+}
 
-      if (bytes != CHUNK_SZ)
-        break;
+void AIETraceOffload::readStreamTrace(uint64_t i)
+{
+  if(isPLIO) {
+    configAIETs2mm(i);
+  } else { 
+    buffers[i].usedSz = bufAllocSz;
+  }
+  uint64_t totalBytesRead = 0;
+  while (1) {
+    auto bytes = readPartialTrace(i);
+    totalBytesRead += bytes;
+    if (totalBytesRead >= bufAllocSz) {
+      buffers[i].isFull = true;
+      break;
     }
+
+    if (bytes != CHUNK_SZ)
+      break;
   }
 }
 
@@ -279,7 +286,7 @@ void AIETraceOffload::startOffload()
   std::lock_guard<std::mutex> lock(statusLock);
   offloadStatus = AIEOffloadThreadStatus::RUNNING;
 
-  offloadThread = std::thread(&AIETraceOffload::continuousOffload, this);
+  offloadThread = xrt_core::thread(xrt_core::thread_class::profile, &AIETraceOffload::continuousOffload, this);
 }
 
 void AIETraceOffload::continuousOffload()
@@ -289,14 +296,35 @@ void AIETraceOffload::continuousOffload()
     return;
   }
 
+  // One worker per stream, up to the number of cores.  Worker w offloads
+  //  streams w, w + numWorkers, ...
+  uint64_t numWorkers = std::thread::hardware_concurrency();
+  if (numWorkers == 0 || numWorkers > numStream)
+    numWorkers = numStream;
+  if (numWorkers == 0)
+    numWorkers = 1;
+
+  std::vector<std::thread> workers;
+  for (uint64_t w = 1; w < numWorkers; ++w)
+    workers.emplace_back(&AIETraceOffload::offloadStreams, this, w, numWorkers);
+  offloadStreams(0, numWorkers);
+  for (auto& w : workers)
+    w.join();
+
+  endReadTrace();
+  offloadFinished();
+}
+
+void AIETraceOffload::offloadStreams(uint64_t first, uint64_t step)
+{
   while (keepOffloading()) {
-    readTrace();
+    for (uint64_t i = first; i < numStream; i += step)
+      readStreamTrace(i);
     std::this_thread::sleep_for(std::chrono::milliseconds(offloadIntervalms));
   }
 
-  readTrace();
-  endReadTrace();
-  offloadFinished();
+  for (uint64_t i = first; i < numStream; i += step)
+    readStreamTrace(i);
 }
 
 bool AIETraceOffload::keepOffloading()
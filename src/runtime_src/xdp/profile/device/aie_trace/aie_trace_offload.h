@@ -113,9 +113,13 @@ private:
     std::thread offloadThread;
 
     uint64_t readPartialTrace(uint64_t);
+    void readStreamTrace(uint64_t);
     void configAIETs2mm(uint64_t wordCount);
 
+    // In continuous offload, the streams are split among workers so a
+    //  stream filling up is drained without waiting for the others
     void continuousOffload();
+    void offloadStreams(uint64_t first, uint64_t step);
     bool keepOffloading();
     void offloadFinished();
 
@@ -49,6 +49,7 @@
 #include "tracedefs.h"
 #include "core/common/message.h"
 #include "core/common/system.h"
+#include "xdp/profile/device/utility.h"
 
 #include <iostream>
 #include <cstdio>
@@ -224,6 +225,14 @@ DeviceIntf::~DeviceIntf()
     return std::string("");
   }
 
+  uint64_t DeviceIntf::getMonitorSlot(xclPerfMonType type, uint32_t index)
+  {
+    if((type == XCL_PERF_MON_MEMORY) && (index < mAimList.size())) { return getAIMSlotId(mAimList[index]->getMIndex()); }
+    if((type == XCL_PERF_MON_ACCEL)  && (index < mAmList.size()))  { return getAMSlotId(mAmList[index]->getMIndex()); }
+    if((type == XCL_PERF_MON_STR)    && (index < mAsmList.size())) { return getASMSlotId(mAsmList[index]->getMIndex()); }
+    return 0;
+  }
+
   // Same as defined in vpl tcl
   // NOTE: This converts the property on the FIFO IP in debug_ip_layout to the corresponding FIFO depth.
   uint64_t DeviceIntf::getFifoSize()
@@ -883,6 +892,29 @@ DeviceIntf::~DeviceIntf()
     return static_cast<char*>(addr) + offset;
   }
 
+  /**
+  * Map a trace buffer for as long as it is in use.  The mapping
+  * stays valid until unmapTraceBuf, so trace data synced with
+  * syncMappedTraceBuf can be processed in place.
+  */
+  void* DeviceIntf::mapTraceBuf(size_t bufHandle)
+  {
+    std::lock_guard<std::mutex> lock(traceLock);
+    return mDevice->map(bufHandle);
+  }
+
+  void DeviceIntf::unmapTraceBuf(size_t bufHandle)
+  {
+    std::lock_guard<std::mutex> lock(traceLock);
+    mDevice->unmap(bufHandle);
+  }
+
+  void DeviceIntf::syncMappedTraceBuf(size_t bufHandle, uint64_t offset, uint64_t bytes)
+  {
+    std::lock_guard<std::mutex> lock(traceLock);
+    mDevice->sync(bufHandle, bytes, offset, xdp::Device::direction::DEVICE2HOST);
+  }
+
   uint64_t DeviceIntf::getDeviceAddr(size_t bufHandle)
   {
     return mDevice->getDeviceAddr(bufHandle);
@@ -74,6 +74,9 @@ class DeviceIntf {
     uint32_t getNumMonitors(xclPerfMonType type);
     XDP_EXPORT
     std::string getMonitorName(xclPerfMonType type, uint32_t index);
+    // Index of the monitor's counters in xclCounterResults
+    XDP_EXPORT
+    uint64_t getMonitorSlot(xclPerfMonType type, uint32_t index);
     XDP_EXPORT
     uint64_t getFifoSize();
 
@@ -105,6 +108,12 @@ class DeviceIntf {
     XDP_EXPORT
     void* syncTraceBuf(size_t bufHandle ,uint64_t offset, uint64_t bytes);
     XDP_EXPORT
+    void* mapTraceBuf(size_t bufHandle);
+    XDP_EXPORT
+    void unmapTraceBuf(size_t bufHandle);
+    XDP_EXPORT
+    void syncMappedTraceBuf(size_t bufHandle, uint64_t offset, uint64_t bytes);
+    XDP_EXPORT
     uint64_t getDeviceAddr(size_t bufHandle);
 
     // Trace FIFO Management
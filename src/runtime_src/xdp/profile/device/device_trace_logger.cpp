@@ -32,12 +32,19 @@ namespace xdp {
   DeviceTraceLogger::DeviceTraceLogger(uint64_t devId)
     : deviceId(devId),
       db(VPDatabase::Instance()),
-      clockTrainOffset(0),
-      traceClockRateMHz(0),
-      clockTrainSlope(0)
+      traceClockRateMHz(0)
   {
     traceClockRateMHz = db->getStaticInfo().getClockRateMHz(deviceId);
-    clockTrainSlope = 1000.0/traceClockRateMHz;
+
+    clock = db->getStaticInfo().getClockCorrelation(deviceId) ;
+    if (!clock)
+      clock = std::make_shared<xrt_core::clock_correlation>() ;
+
+    // The trace clock runs at the nominal rate in hardware, so the
+    //  rate is only fitted from training samples to correct drift.
+    //  Emulation clocks have no relation to the nominal rate.
+    if (xdp::getFlowMode() == HW)
+      clock->set_nominal_rate(traceClockRateMHz) ;
 
     xclbin = (db->getStaticInfo()).getCurrentlyLoadedXclbin(devId) ;
 
@@ -664,37 +671,17 @@ namespace xdp {
 
   // Complete training to convert device timestamp to host time domain
   // NOTE: see description of PTP @ http://en.wikipedia.org/wiki/Precision_Time_Protocol
-  // clock training relation is linear within small durations (1 sec)
-  // x, y coordinates are used for clock training
+  // The model is maintained by the clock correlation of the device,
+  //  which fits it to a window of recent training samples
   void DeviceTraceLogger::trainDeviceHostTimestamps(uint64_t deviceTimestamp, uint64_t hostTimestamp)
   {
-    static double y1 = 0.0;
-    static double y2 = 0.0;
-    static double x1 = 0.0;
-    static double x2 = 0.0;
-    if (!y1 && !x1) {
-      y1 = static_cast <double> (hostTimestamp);
-      x1 = static_cast <double> (deviceTimestamp);
-    } else {
-      y2 = static_cast <double> (hostTimestamp);
-      x2 = static_cast <double> (deviceTimestamp);
-      // slope in ns/cycle
-      if (xdp::getFlowMode() == HW) {
-        clockTrainSlope = 1000.0/traceClockRateMHz;
-      } else {
-        clockTrainSlope = (y2 - y1) / (x2 - x1);
-      }
-      clockTrainOffset = y2 - clockTrainSlope * x2;
-      // next time update x1, y1
-      y1 = 0.0;
-      x1 = 0.0;
-    }
+    clock->add_sample(deviceTimestamp, hostTimestamp) ;
   }
 
   // Convert device timestamp to host time domain (in msec)
   double DeviceTraceLogger::convertDeviceToHostTimestamp(uint64_t deviceTimestamp)
   {
-    return ((clockTrainSlope * (double)deviceTimestamp) + clockTrainOffset)/1e6;
+    return clock->device_to_host_ns(deviceTimestamp)/1e6;
   }
 
   void DeviceTraceLogger::processTraceData(void* data, uint64_t numBytes)
@@ -17,10 +17,13 @@
 #ifndef _XDP_PROFILE_DEVICE_BASE_TRACE_LOGGER_H
 #define _XDP_PROFILE_DEVICE_BASE_TRACE_LOGGER_H
 
+#include <memory>
 #include <vector>
 
+#include "core/common/clock_correlation.h"
 #include "xdp/config.h"
 #include "xdp/profile/database/database.h"
+#include "xdp/profile/database/start_ring.h"
 #include "xdp/profile/database/events/device_events.h"
 
 namespace xdp {
@@ -35,8 +38,9 @@ namespace xdp {
     VPDatabase* db = nullptr;
 
     std::vector<uint64_t>  traceIDs;
-    // Keep track of the event ID and device timestamp of CU starts
-    std::vector<std::list<std::pair<uint64_t, uint64_t>>> cuStarts;
+    // Keep track of the event ID and device timestamp of CU starts,
+    //  one ring per accelerator monitor slot
+    std::vector<StartRing<std::pair<uint64_t, uint64_t>>> cuStarts;
 
     // Last Transactions
     std::vector<uint64_t> amLastTrans;
@@ -57,9 +61,11 @@ namespace xdp {
     inline bool isClockTraining(uint64_t trace)
       { return (((trace >> 63) & 0x1) == 1) ;}
 
-    double clockTrainOffset;
     double traceClockRateMHz;
-    double clockTrainSlope;
+
+    // Shared by all users of the device clock, trained from the
+    //  clock training packets in the trace
+    std::shared_ptr<xrt_core::clock_correlation> clock ;
 
     bool warnCUIncomplete=false;
 
@@ -106,6 +112,9 @@ namespace xdp {
 
     XDP_EXPORT void processTraceData(void* data, uint64_t numBytes) ;
     XDP_EXPORT void endProcessTraceData();
+
+    inline const std::shared_ptr<xrt_core::clock_correlation>&
+    getClockCorrelation() const { return clock ; }
   } ;
 
 }
@@ -19,6 +19,7 @@
 #include "xdp/profile/device/device_trace_offload.h"
 #include "xdp/profile/device/device_trace_logger.h"
 #include "core/common/message.h"
+#include "core/common/thread.h"
 #include "experimental/xrt_profile.h"
 
 namespace xdp {
@@ -94,16 +95,6 @@ void DeviceTraceOffload::offload_device_continuous()
   offload_finished();
 }
 
-void DeviceTraceOffload::train_clock_continuous()
-{
-  while (should_continue()) {
-    train_clock();
-    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_interval_ms));
-  }
-
-  offload_finished();
-}
-
 void DeviceTraceOffload::process_trace_continuous()
 {
   if (!has_ts2mm())
@@ -128,26 +119,32 @@ void DeviceTraceOffload::process_trace()
 
   bool q_read = false;
   bool q_empty = true;
-  std::unique_ptr<char[]> buf;
-  uint64_t size = 0;
+  TraceChunk chunk;
   do {
     q_read=false;
     ts2mm_info.process_queue_lock.lock();
     if (!ts2mm_info.data_queue.empty()) {
-      buf = std::move(ts2mm_info.data_queue.front());
-      size = ts2mm_info.size_queue.front();
-      ts2mm_info.data_queue.pop();
-      ts2mm_info.size_queue.pop();
+      chunk = std::move(ts2mm_info.data_queue.front());
+      ts2mm_info.data_queue.pop_front();
       q_read = true;
       q_empty = ts2mm_info.data_queue.empty();
+      if (!chunk.copy) {
+        auto& buffer = ts2mm_info.buffers[chunk.buf_index];
+        buffer.in_use = true;
+        buffer.in_use_start = chunk.end - chunk.size;
+      }
     }
     ts2mm_info.process_queue_lock.unlock();
 
     // Processing takes a lot more time compared to everything else
     if (q_read) {
-      debug_stream << "Process " << size << " bytes of trace" << std::endl;
-      deviceTraceLogger->processTraceData(buf.get(), size) ;
-      buf.reset();
+      debug_stream << "Process " << chunk.size << " bytes of trace" << std::endl;
+      deviceTraceLogger->processTraceData(chunk.data, chunk.size) ;
+      if (!chunk.copy) {
+        std::lock_guard<std::mutex> lock(ts2mm_info.process_queue_lock);
+        ts2mm_info.buffers[chunk.buf_index].in_use = false;
+      }
+      chunk.copy.reset();
     }
   } while (!q_empty);
 }
@@ -167,10 +164,14 @@ void DeviceTraceOffload::start_offload(OffloadThreadType type)
   status = OffloadThreadStatus::RUNNING;
 
   if (type == OffloadThreadType::TRACE) {
-    offload_thread = std::thread(&DeviceTraceOffload::offload_device_continuous, this);
-    process_thread = std::thread(&DeviceTraceOffload::process_trace_continuous, this);
+    offload_thread = xrt_core::thread(xrt_core::thread_class::profile, &DeviceTraceOffload::offload_device_continuous, this);
+    process_thread = xrt_core::thread(xrt_core::thread_class::profile, &DeviceTraceOffload::process_trace_continuous, this);
   } else if (type == OffloadThreadType::CLOCK_TRAIN) {
-    offload_thread = std::thread(&DeviceTraceOffload::train_clock_continuous, this);
+    // The clock correlation thread calls trainers every 500 ms
+    m_clock_trainer = xrt_core::clock_correlation::add_trainer([this] {
+      dev_intf->clockTraining(m_force_clk_train);
+      m_force_clk_train = false;
+    });
   }
 
 }
@@ -179,6 +180,13 @@ void DeviceTraceOffload::stop_offload()
 {
   std::lock_guard<std::mutex> lock(status_lock);
   if (status == OffloadThreadStatus::STOPPED) return ;
+  if (m_clock_trainer) {
+    // No thread to wind down, the trainer is not running when removed
+    xrt_core::clock_correlation::remove_trainer(m_clock_trainer);
+    m_clock_trainer = 0;
+    status = OffloadThreadStatus::STOPPED;
+    return ;
+  }
   status = OffloadThreadStatus::STOPPING;
 }
 
@@ -297,13 +305,38 @@ void DeviceTraceOffload::read_trace_s2mm(bool force)
   // There's enough data available
   ts2mm_info.buffers[i].prv_wordcount = wordcount;
 
-  if (!config_s2mm_reader(i, wordcount))
-    return;
+  protect_in_place_chunks(i, wordcount * TRACE_PACKET_SIZE);
 
-  uint64_t nBytes = ts2mm_info.buffers[i].used_size - ts2mm_info.buffers[i].offset;
+  // With double buffering a read ends at the end of a half, so
+  //  continue into the other half if the hardware is already there
+  while (config_s2mm_reader(i, wordcount)) {
+    if (!read_s2mm_chunk(i))
+      return;
+
+    auto& buffer = ts2mm_info.buffers[i];
+    auto bytes_read = buffer.rollover_count*buffer.buf_size + buffer.used_size;
+    if (!ts2mm_info.use_double_buf || buffer.used_size == buffer.offset
+        || bytes_read >= wordcount * TRACE_PACKET_SIZE)
+      break;
+  }
+  }
+}
+
+// Sync the range selected by config_s2mm_reader and queue it for processing
+bool DeviceTraceOffload::read_s2mm_chunk(uint64_t i)
+{
+  auto& buffer = ts2mm_info.buffers[i];
+  uint64_t nBytes = buffer.used_size - buffer.offset;
 
   auto start = std::chrono::steady_clock::now();
-  void* host_buf = dev_intf->syncTraceBuf( ts2mm_info.buffers[i].buf, ts2mm_info.buffers[i].offset, nBytes);
+  char* host_buf = nullptr;
+  if (buffer.host_addr) {
+    dev_intf->syncMappedTraceBuf(buffer.buf, buffer.offset, nBytes);
+    host_buf = buffer.host_addr + buffer.offset;
+  }
+  else {
+    host_buf = static_cast<char*>(dev_intf->syncTraceBuf(buffer.buf, buffer.offset, nBytes));
+  }
   auto end = std::chrono::steady_clock::now();
   debug_stream
     << "For " << i << " ts2mm : Elapsed time in microseconds for sync : "
@@ -311,24 +344,75 @@ void DeviceTraceOffload::read_trace_s2mm(bool force)
     << " µs" << " nBytes : " << nBytes << std::endl;
 
   if (!host_buf)
-    return;
+    return false;
+
+  TraceChunk chunk;
+  chunk.size = nBytes;
+  chunk.buf_index = i;
+  chunk.end = buffer.rollover_count*buffer.buf_size + buffer.used_size;
+
+  // The hardware never writes over data it wrote before unless the
+  //  buffer is circular.  A circular buffer is processed in place only
+  //  with double buffering, which copies chunks before they get
+  //  overwritten.
+  if (buffer.host_addr && (!ts2mm_info.use_circ_buf || ts2mm_info.use_double_buf)) {
+    chunk.data = host_buf;
+  }
+  else {
+    chunk.copy = std::make_unique<char[]>(nBytes);
+    std::memcpy(chunk.copy.get(), host_buf, nBytes);
+    chunk.data = chunk.copy.get();
+  }
 
-  auto tmp = std::make_unique<char[]>(nBytes);
-  std::memcpy(tmp.get(), host_buf, nBytes);
   // Push new data into queue for processing
   ts2mm_info.process_queue_lock.lock();
-  ts2mm_info.data_queue.push(std::move(tmp));
-  ts2mm_info.size_queue.push(nBytes);
+  ts2mm_info.data_queue.push_back(std::move(chunk));
   ts2mm_info.process_queue_lock.unlock();
 
   // Print warning if processing large amount of trace
-  if (nBytes > TS2MM_WARN_BIG_BUF_SIZE && !ts2mm_info.buffers[i].big_trace_warn_done) {
+  if (nBytes > TS2MM_WARN_BIG_BUF_SIZE && !buffer.big_trace_warn_done) {
     xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", TS2MM_WARN_MSG_BIG_BUF);
-    ts2mm_info.buffers[i].big_trace_warn_done = true;
+    buffer.big_trace_warn_done = true;
   }
 
-  if (ts2mm_info.buffers[i].used_size == ts2mm_info.buffers[i].buf_size && ts2mm_info.use_circ_buf == false)
-    ts2mm_info.buffers[i].full = true;
+  if (buffer.used_size == buffer.buf_size && ts2mm_info.use_circ_buf == false)
+    buffer.full = true;
+
+  return true;
+}
+
+// Chunks of a double buffered circular buffer are processed in place
+//  while the hardware keeps writing.  If processing falls behind so that
+//  the hardware is within half a buffer of overwriting queued chunks,
+//  copy them out of the buffer.
+void DeviceTraceOffload::protect_in_place_chunks(uint64_t i, uint64_t bytes_written)
+{
+  if (!ts2mm_info.use_double_buf)
+    return;
+
+  auto& buffer = ts2mm_info.buffers[i];
+  uint64_t half = buffer.buf_size / 2;
+
+  std::lock_guard<std::mutex> lock(ts2mm_info.process_queue_lock);
+  for (auto& chunk : ts2mm_info.data_queue) {
+    if (chunk.copy || chunk.buf_index != i)
+      continue;
+    uint64_t chunk_start = chunk.end - chunk.size;
+    if (bytes_written + half <= chunk_start + buffer.buf_size)
+      continue;
+
+    debug_stream
+      << "Copy " << chunk.size << " bytes of trace out of buffer " << i << std::endl;
+    chunk.copy = std::make_unique<char[]>(chunk.size);
+    std::memcpy(chunk.copy.get(), chunk.data, chunk.size);
+    chunk.data = chunk.copy.get();
+  }
+
+  // The chunk being processed cannot be copied
+  if (buffer.in_use && bytes_written > buffer.in_use_start + buffer.buf_size
+      && !buffer.overwrite_warn_done) {
+    xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", TS2MM_WARN_MSG_CIRC_BUF_OVERWRITE);
+    buffer.overwrite_warn_done = true;
   }
 }
 
@@ -373,6 +457,13 @@ bool DeviceTraceOffload::config_s2mm_reader(uint64_t i, uint64_t wordCount)
     ts2mm_info.buffers[i].used_size = ts2mm_info.full_buf_size;
   }
 
+  // With double buffering, end at the end of the half being read
+  if (ts2mm_info.use_double_buf) {
+    uint64_t half = ts2mm_info.buffers[i].buf_size / 2;
+    if (ts2mm_info.buffers[i].offset < half && ts2mm_info.buffers[i].used_size > half)
+      ts2mm_info.buffers[i].used_size = half;
+  }
+
   debug_stream
     << "DeviceTraceOffload::config_s2mm_reader for " << i << " ts2mm " 
     << "Reading from 0x"
@@ -413,6 +504,15 @@ bool DeviceTraceOffload::init_s2mm(bool circ_buf, const std::vector<uint64_t> &b
     }
   }
 
+  // Double buffering needs each half of the buffer to be offloaded
+  //  fast enough.  The halves are kept aligned to trace packets.
+  ts2mm_info.use_double_buf = ts2mm_info.use_circ_buf &&
+    (sleep_interval_ms == 0 || ts2mm_info.circ_buf_cur_rate / 2 >= ts2mm_info.circ_buf_min_rate);
+  for(uint64_t i = 0; i < ts2mm_info.num_ts2mm; i++) {
+    if ((buf_sizes[i] / 2) % TRACE_PACKET_SIZE)
+      ts2mm_info.use_double_buf = false;
+  }
+
   for(uint64_t i = 0; i < ts2mm_info.num_ts2mm; i++) {
     ts2mm_info.buffers[i].buf_size = buf_sizes[i];
 
@@ -422,6 +522,11 @@ bool DeviceTraceOffload::init_s2mm(bool circ_buf, const std::vector<uint64_t> &b
       return false;
     }
 
+    // Keep the buffer mapped so trace can be processed in place
+    ts2mm_info.buffers[i].host_addr = static_cast<char*>(dev_intf->mapTraceBuf(ts2mm_info.buffers[i].buf));
+    if (!ts2mm_info.buffers[i].host_addr)
+      ts2mm_info.use_double_buf = false;
+
     // Data Mover will write input stream to this address
     ts2mm_info.buffers[i].address = dev_intf->getDeviceAddr(ts2mm_info.buffers[i].buf);
     dev_intf->initTS2MM(i, ts2mm_info.buffers[i].buf_size, ts2mm_info.buffers[i].address, ts2mm_info.use_circ_buf);
@@ -444,6 +549,8 @@ void DeviceTraceOffload::reset_s2mm()
       dev_intf->initTS2MM(i, 0, ts2mm_info.buffers[i].address, 0);
 
     dev_intf->resetTS2MM(i);
+    if (ts2mm_info.buffers[i].host_addr)
+      dev_intf->unmapTraceBuf(ts2mm_info.buffers[i].buf);
     dev_intf->freeTraceBuf(ts2mm_info.buffers[i].buf);
     ts2mm_info.buffers[i].buf = 0;
   }
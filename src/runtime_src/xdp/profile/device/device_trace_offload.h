@@ -22,7 +22,7 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
-#include <queue>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <cstring>
@@ -58,7 +58,15 @@ struct TraceBufferInfo {
   bool     full;
   bool     offload_done;
   bool     big_trace_warn_done;
-  
+
+  // Persistent host mapping of the buffer
+  char*    host_addr;
+  // Start (in bytes written since init) of the chunk of this buffer
+  //  being processed in place.  Guarded by process_queue_lock.
+  uint64_t in_use_start;
+  bool     in_use;
+  bool     overwrite_warn_done;
+
   TraceBufferInfo()
     : buf(0),
       buf_size(0),
@@ -69,11 +77,34 @@ struct TraceBufferInfo {
       rollover_count(0),
       full(false),
       offload_done(false),
-      big_trace_warn_done(false)
+      big_trace_warn_done(false),
+      host_addr(nullptr),
+      in_use_start(0),
+      in_use(false),
+      overwrite_warn_done(false)
   {}
        
 };
 
+// Trace read from a buffer, waiting to be processed.  Chunks read
+//  in place point into the host mapping of the buffer, other chunks
+//  own a copy of the data.
+struct TraceChunk {
+  std::unique_ptr<char[]> copy;
+  char*    data;
+  uint64_t size;
+  uint64_t buf_index;
+  // Bytes written to the buffer since init, up to the end of the chunk
+  uint64_t end;
+
+  TraceChunk()
+    : data(nullptr),
+      size(0),
+      buf_index(0),
+      end(0)
+  {}
+};
+
 struct Ts2mmInfo {
   size_t   num_ts2mm;
   uint64_t full_buf_size;
@@ -86,15 +117,19 @@ struct Ts2mmInfo {
   uint64_t circ_buf_min_rate = TS2MM_DEF_BUF_SIZE * 100;
   uint64_t circ_buf_cur_rate;
 
-  std::queue<std::unique_ptr<char[]>> data_queue;
-  std::queue<uint64_t> size_queue;
+  // Double buffering of circular buffers: the hardware writes one
+  //  half of a buffer while the other half is processed in place
+  bool use_double_buf;
+
+  std::deque<TraceChunk> data_queue;
   std::mutex process_queue_lock;
 
   Ts2mmInfo()
     : num_ts2mm(0),
       full_buf_size(0),
       use_circ_buf(false),
-      circ_buf_cur_rate(0)
+      circ_buf_cur_rate(0),
+      use_double_buf(false)
   {}
   
 };
@@ -167,11 +202,12 @@ private:
     void read_trace_s2mm(bool force=true);
     uint64_t read_trace_s2mm_partial();
     bool config_s2mm_reader(uint64_t i, uint64_t wordCount);
+    bool read_s2mm_chunk(uint64_t i);
+    void protect_in_place_chunks(uint64_t i, uint64_t bytes_written);
     bool init_s2mm(bool circ_buf, const std::vector<uint64_t> &);
     void reset_s2mm();
 
     bool should_continue();
-    void train_clock_continuous();
     void offload_device_continuous();
     void offload_finished();
     void process_trace_continuous();
@@ -206,6 +242,9 @@ private:
 
     // Clock Training Params
     bool m_force_clk_train = true;
+    // Periodic training without trace offload is serviced by the shared
+    //  clock correlation thread
+    xrt_core::clock_correlation::trainer_handle m_clock_trainer = 0;
     std::chrono::time_point<std::chrono::system_clock> m_prev_clk_train_time;
 
     // Internal flag to end trace processing thread
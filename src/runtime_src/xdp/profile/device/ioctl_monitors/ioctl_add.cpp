@@ -50,10 +50,19 @@ IOCtlDeadlockDetector::IOCtlDeadlockDetector(Device* handle, uint64_t index, deb
     showWarning("Could not open device file.");
     return;
   }
+
+  // The status register is the first register of the IP, so one page
+  //  is enough.  If the mapping fails, fall back to the ioctl.
+  mapped_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  void* mapped = mmap(NULL, mapped_size, PROT_READ, MAP_SHARED, driver_FD, 0);
+  if (mapped != MAP_FAILED)
+    mapped_status = static_cast<volatile uint32_t*>(mapped);
 }
 
 IOCtlDeadlockDetector::~IOCtlDeadlockDetector()
 {
+  if (mapped_status)
+    munmap(const_cast<uint32_t*>(mapped_status), mapped_size);
   close(driver_FD);
 }
 
@@ -77,6 +86,9 @@ uint32_t IOCtlDeadlockDetector::getDeadlockStatus()
   if (out_stream)
     (*out_stream) << " IOCtlDeadlockDetector::getDeadlockStatus " << std::endl;
 
+  if (mapped_status)
+    return *mapped_status;
+
   uint32_t status = 0;
   ioctl(driver_FD, ACCEL_DEADLOCK_DETECTOR_IOC_GET_STATUS, &status);
 
@@ -44,6 +44,10 @@ public:
 
 protected:
   int driver_FD = -1;
+  // Status register mapped from the subdevice, if the driver allows it.
+  //  Reading it directly avoids a system call and the driver lock.
+  volatile uint32_t* mapped_status = nullptr;
+  size_t mapped_size = 0;
 };
 
 }
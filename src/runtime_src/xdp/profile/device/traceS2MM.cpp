@@ -17,8 +17,11 @@
 #include "traceS2MM.h"
 #include "tracedefs.h"
 //#include "xdp/profile/core/rt_util.h"
+#include <algorithm>
 #include <bitset>
+#include <functional>
 #include <iomanip>
+#include <thread>
 
 namespace xdp {
 
@@ -225,6 +228,16 @@ uint64_t TraceS2MM::seekClockTraining(uint64_t* arr, uint64_t count)
   return count;
 }
 
+// Buffers of at least this many packets per thread are decoded in parallel
+static const uint64_t TS2MM_PARALLEL_CHUNK_PACKETS = 0x100000;
+
+bool TraceS2MM::isClockTrainPacket(uint64_t packet, uint64_t i)
+{
+    if (mTraceFormat == 1)
+      return ((packet >> 63) & 0x1);
+    return (i < 8 && !mclockTrainingdone);
+}
+
 void TraceS2MM::parseTraceBuf(void* buf, uint64_t size, std::vector<xclTraceResults>& traceVector)
 {
     if(out_stream)
@@ -247,39 +260,105 @@ void TraceS2MM::parseTraceBuf(void* buf, uint64_t size, std::vector<xclTraceResu
     if (idx == count)
       return;
 
-    for (auto i = idx; i < count; i++) {
-      auto currentPacket = pos[i];
-      if (!currentPacket)
-        break;
-      // Poor man's reset
-      if (i == 0 && !mPacketFirstTs)
-        mPacketFirstTs = currentPacket & 0x1FFFFFFFFFFF;
-
-      bool isClockTrain = false;
-      if (mTraceFormat == 1) {
-        isClockTrain = ((currentPacket >> 63) & 0x1);
-      } else {
-        isClockTrain = (i < 8 && !mclockTrainingdone);
+    // Valid trace data ends at the first empty packet
+    uint64_t end = idx;
+    while (end < count && pos[end])
+      ++end;
+
+    // Poor man's reset
+    if (idx == 0 && end > 0 && !mPacketFirstTs)
+      mPacketFirstTs = pos[0] & 0x1FFFFFFFFFFF;
+
+    /*
+    * Decoding a packet only depends on its position, except for clock
+    * training packets, 4 of which make up one result.  The buffer is
+    * split into chunks that are decoded in parallel:
+    * 1. Count the clock training packets of each chunk, to get the
+    *    position of each chunk's results in traceVector
+    * 2. Decode the other packets of each chunk into place, and reserve
+    *    a result for every 4th clock training packet
+    * 3. Assemble the clock training results in order
+    * Debug output is written in packet order, so it is sequential.
+    */
+    uint64_t numChunks = 1;
+    if (!out_stream) {
+      uint64_t threads = std::max(1u, std::thread::hardware_concurrency());
+      numChunks = std::min(threads, (end - idx) / TS2MM_PARALLEL_CHUNK_PACKETS);
+      numChunks = std::max(numChunks, static_cast<uint64_t>(1));
+    }
+    uint64_t chunkSize = (end - idx + numChunks - 1) / numChunks;
+
+    auto forEachChunk = [numChunks](const std::function<void(uint64_t)>& f) {
+      if (numChunks == 1) {
+        f(0);
+        return;
+      }
+      std::vector<std::thread> threads;
+      for (uint64_t c = 1; c < numChunks; ++c)
+        threads.emplace_back(f, c);
+      f(0);
+      for (auto& t : threads)
+        t.join();
+    };
+
+    std::vector<uint64_t> clockTrainCount(numChunks, 0);
+    forEachChunk([&](uint64_t c) {
+      uint64_t first = idx + c * chunkSize;
+      uint64_t last = std::min(first + chunkSize, end);
+      uint64_t n = 0;
+      for (auto i = first; i < last; i++)
+        n += isClockTrainPacket(pos[i], i) ? 1 : 0;
+      clockTrainCount[c] = n;
+    });
+
+    std::vector<uint32_t> chunkModulus(numChunks, 0);
+    std::vector<uint64_t> chunkResult(numChunks, 0);
+    uint32_t modulus = mModulus;
+    uint64_t results = 0;
+    for (uint64_t c = 0; c < numChunks; ++c) {
+      uint64_t first = idx + c * chunkSize;
+      uint64_t last = std::min(first + chunkSize, end);
+      uint64_t packets = (last > first) ? last - first : 0;
+      chunkModulus[c] = modulus;
+      chunkResult[c] = results;
+      results += (packets - clockTrainCount[c]) + (modulus + clockTrainCount[c]) / 4;
+      modulus = static_cast<uint32_t>((modulus + clockTrainCount[c]) % 4);
+    }
+    traceVector.resize(results);
+
+    // Clock training packets of each chunk, with the index of the result
+    //  reserved for the packet that completes a clock training sample
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> clockTrain(numChunks);
+    forEachChunk([&](uint64_t c) {
+      uint64_t first = idx + c * chunkSize;
+      uint64_t last = std::min(first + chunkSize, end);
+      uint32_t m = chunkModulus[c];
+      uint64_t r = chunkResult[c];
+      for (auto i = first; i < last; i++) {
+        auto currentPacket = pos[i];
+        if (isClockTrainPacket(currentPacket, i)) {
+          clockTrain[c].emplace_back(currentPacket, (m == 3) ? r++ : 0);
+          m = (m == 3) ? 0 : m + 1;
+        }
+        else {
+          parsePacket(currentPacket, mPacketFirstTs, traceVector[r++]);
+        }
       }
+    });
 
-      if (isClockTrain) {
-        parsePacketClockTrain(currentPacket);
+    for (auto& chunk : clockTrain) {
+      for (auto& packet : chunk) {
+        parsePacketClockTrain(packet.first);
         if (mModulus == 3) {
           mModulus = 0 ;
-          traceVector.push_back(partialResult) ;
+          traceVector[packet.second] = partialResult ;
           partialResult = {} ;
         }
         else {
           mModulus = mModulus + 1 ;
-	}
-      }
-      else {
-        xclTraceResults result = {};
-        parsePacket(currentPacket, mPacketFirstTs, result);
-        traceVector.push_back(result);
+        }
       }
-
-    } // For i < count
+    }
     mclockTrainingdone = true;
 }
 
@@ -88,6 +88,7 @@ protected:
     void parsePacketClockTrain(uint64_t packet);
     void parsePacket(uint64_t packet, uint64_t firstTimestamp, xclTraceResults &result);
     uint64_t seekClockTraining(uint64_t* arr, uint64_t count);
+    bool isClockTrainPacket(uint64_t packet, uint64_t i);
 
 protected:
     uint64_t mPacketFirstTs = 0;
@@ -21,6 +21,7 @@
 #include "core/common/config_reader.h"
 #include "core/common/message.h"
 #include "core/common/system.h"
+#include "core/common/thread.h"
 #include "core/common/time.h"
 #include "core/edge/user/shim.h"
 #include "core/include/experimental/xrt-next.h"
@@ -754,19 +755,26 @@ namespace xdp {
       return;
 
     auto& should_continue = it->second;
+    AIESampleLog* samples = db->getDynamicInfo().getAIESampleLog(index);
+
     while (should_continue) {
       // Wait until xclbin has been loaded and device has been updated in database
-      if (!(db->getStaticInfo().isDeviceReady(index)))
-        continue;
-      XAie_DevInst* aieDevInst =
-        static_cast<XAie_DevInst*>(db->getStaticInfo().getAieDevInst(fetchAieDevInst, handle)) ;
-      if (!aieDevInst)
+      XAie_DevInst* aieDevInst = nullptr;
+      if (db->getStaticInfo().isDeviceReady(index))
+        aieDevInst =
+          static_cast<XAie_DevInst*>(db->getStaticInfo().getAieDevInst(fetchAieDevInst, handle)) ;
+      if (!aieDevInst) {
+        std::this_thread::sleep_for(std::chrono::microseconds(mPollingInterval));
         continue;
+      }
 
       uint32_t prevColumn = 0;
       uint32_t prevRow = 0;
       uint64_t timerValue = 0;
 
+      // All counters read in one sweep share a timestamp in milliseconds
+      double timestamp = xrt_core::time_ns() / 1.0e6;
+
       // Iterate over all AIE Counters & Timers
       auto numCounters = db->getStaticInfo().getNumAIECounter(index);
       for (uint64_t c=0; c < numCounters; c++) {
@@ -774,15 +782,8 @@ namespace xdp {
         if (!aie)
           continue;
 
-        std::vector<uint64_t> values;
-        values.push_back(aie->column);
-        values.push_back(aie->row);
-        values.push_back(aie->startEvent);
-        values.push_back(aie->endEvent);
-        values.push_back(aie->resetEvent);
-
         // Read counter value from device
-        uint32_t counterValue;
+        uint32_t counterValue = 0;
         if (mPerfCounters.empty()) {
           // Compiler-defined counters
           XAie_LocType tileLocation = XAie_TileLoc(aie->column, aie->row + 1);
@@ -790,10 +791,8 @@ namespace xdp {
         }
         else {
           // Runtime-defined counters
-          auto perfCounter = mPerfCounters.at(c);
-          perfCounter->readResult(counterValue);
+          mPerfCounters.at(c)->readResult(counterValue);
         }
-        values.push_back(counterValue);
 
         // Read tile timer (once per tile to minimize overhead)
         if ((aie->column != prevColumn) || (aie->row != prevRow)) {
@@ -802,13 +801,12 @@ namespace xdp {
           XAie_LocType tileLocation = XAie_TileLoc(aie->column, aie->row + 1);
           XAie_ReadTimer(aieDevInst, tileLocation, XAIE_CORE_MOD, &timerValue);
         }
-        values.push_back(timerValue);
-        values.push_back(aie->payload);
 
-        // Get timestamp in milliseconds
-        double timestamp = xrt_core::time_ns() / 1.0e6;
-        db->getDynamicInfo().addAIESample(index, timestamp, values);
+        samples->append(timestamp, aie->column, aie->row, aie->startEvent,
+                        aie->endEvent, aie->resetEvent, counterValue,
+                        timerValue, aie->payload);
       }
+      samples->publish();
 
       std::this_thread::sleep_for(std::chrono::microseconds(mPollingInterval));     
     }
@@ -890,7 +888,7 @@ namespace xdp {
 
     // Start the AIE profiling thread
     mThreadCtrlMap[handle] = true;
-    auto device_thread = std::thread(&AIEProfilingPlugin::pollAIECounters, this, mIndex, handle);
+    auto device_thread = xrt_core::thread(xrt_core::thread_class::profile, &AIEProfilingPlugin::pollAIECounters, this, mIndex, handle);
     mThreadMap[handle] = std::move(device_thread);
 
     ++mIndex;
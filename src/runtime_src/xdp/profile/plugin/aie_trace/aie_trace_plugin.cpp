@@ -26,7 +26,6 @@
 #include "core/edge/user/shim.h"
 
 #include "xdp/profile/database/database.h"
-#include "xdp/profile/database/events/creator/aie_trace_data_logger.h"
 #include "xdp/profile/database/static_info/aie_constructs.h"
 #include "xdp/profile/database/static_info/pl_constructs.h"
 #include "xdp/profile/device/aie_trace/aie_trace_offload.h"
@@ -35,8 +34,8 @@
 #include "xdp/profile/device/tracedefs.h"
 #include "xdp/profile/plugin/aie_trace/aie_trace_plugin.h"
 #include "xdp/profile/plugin/vp_base/info.h"
-#include "xdp/profile/writer/aie_trace/aie_trace_writer.h"
 #include "xdp/profile/writer/aie_trace/aie_trace_config_writer.h"
+#include "xdp/profile/writer/aie_trace/aie_trace_file_logger.h"
 
 #define NUM_CORE_TRACE_EVENTS   8
 #define NUM_MEMORY_TRACE_EVENTS 8
@@ -958,17 +957,13 @@ namespace xdp {
       (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "AIE_EVENT_RUNTIME_CONFIG");
     }
 
-    // Create trace output files
+    // Trace output files, written by the logger as trace is offloaded
+    std::vector<std::string> traceFileNames;
     for(uint64_t n = 0; n < numAIETraceOutput; n++) {
       // Consider both Device Id and Stream Id to create the output file name
       std::string fileName = "aie_trace_" + std::to_string(deviceId) + "_" + std::to_string(n) + ".txt";
-      VPWriter* writer = new AIETraceWriter(fileName.c_str(), deviceId, n,
-                                            "" /*version*/,
-                                            "" /*creationTime*/,
-                                            "" /*xrtVersion*/,
-                                            "" /*toolVersion*/);
-      writers.push_back(writer);
-      (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "AIE_EVENT_TRACE");
+      traceFileNames.push_back(fileName);
+      (db->getStaticInfo()).addOpenedFile(fileName, "AIE_EVENT_TRACE");
 
       std::stringstream msg;
       msg << "Creating AIE trace file " << fileName << " for device " << deviceId;
@@ -979,11 +974,6 @@ namespace xdp {
     uint64_t aieTraceBufSize = GetTS2MMBufSize(true /*isAIETrace*/);
     bool isPLIO = (db->getStaticInfo()).getNumTracePLIO(deviceId) ? true : false;
 
-    // Continuous Trace Offload is supported only for PLIO flow
-    if (continuousTrace && isPLIO) {
-      XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), "AIE_EVENT_TRACE");
-    }
-
     // First, check against memory bank size
     // NOTE: Check first buffer for PLIO; assume bank 0 for GMIO
     uint8_t memIndex = isPLIO ? deviceIntf->getAIETs2mmMemIndex(0) : 0;
@@ -1047,7 +1037,7 @@ namespace xdp {
 #endif
 
     // Create AIE Trace Offloader
-    AIETraceDataLogger* aieTraceLogger = new AIETraceDataLogger(deviceId);
+    AIETraceFileLogger* aieTraceLogger = new AIETraceFileLogger(traceFileNames);
 
     if (xrt_core::config::get_verbosity() >= static_cast<uint32_t>(severity_level::debug)) {
       std::string flowType = (isPLIO) ? "PLIO" : "GMIO";
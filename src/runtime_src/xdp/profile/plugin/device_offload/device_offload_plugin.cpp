@@ -26,11 +26,14 @@
 #include "xdp/profile/plugin/device_offload/device_offload_plugin.h"
 #include "xdp/profile/plugin/vp_base/utility.h"
 #include "xdp/profile/plugin/vp_base/info.h"
+#include "xdp/profile/writer/device_trace/device_counter_writer.h"
 #include "xdp/profile/writer/device_trace/device_trace_writer.h"
 #include "xdp/profile/device/device_trace_logger.h"
 
 #include "core/common/config_reader.h"
 #include "core/common/message.h"
+#include "core/common/thread.h"
+#include "core/common/time.h"
 #include "experimental/xrt_profile.h"
 
 // Anonymous namespace for helper functions
@@ -86,7 +89,8 @@ namespace {
 namespace xdp {
 
   DeviceOffloadPlugin::DeviceOffloadPlugin() :
-    XDPPlugin(), continuous_trace(false), trace_buffer_offload_interval_ms(10)
+    XDPPlugin(), continuous_trace(false), trace_buffer_offload_interval_ms(10),
+    counter_sampling_interval_ms(0), keepSampling(false)
   {
     db->registerPlugin(this) ;
 
@@ -104,6 +108,11 @@ namespace xdp {
         xrt_core::config::get_trace_buffer_offload_interval_ms();
 
       m_enable_circular_buffer = continuous_trace;
+
+      counter_sampling_interval_ms =
+        xrt_core::config::get_device_counter_sampling_interval_ms() ;
+      if (counter_sampling_interval_ms != 0)
+        perfettoTrace = VPPerfettoTrace::instance() ;
     }
     else {
       if (xrt_core::config::get_continuous_trace()) {
@@ -136,10 +145,25 @@ namespace xdp {
     writers.push_back(writer) ;
     (db->getStaticInfo()).addOpenedFile(writer->getcurrentFileName(), "VP_TRACE") ;
 
+    if (counter_sampling_interval_ms != 0) {
+      std::string counterFile =
+        "device_counters_" + std::to_string(deviceId) + ".csv" ;
+      VPWriter* counterWriter =
+        new DeviceCounterWriter(counterFile.c_str(), deviceId) ;
+      writers.push_back(counterWriter) ;
+      (db->getStaticInfo()).addOpenedFile(counterWriter->getcurrentFileName(),
+                                          "DEVICE_COUNTERS") ;
+    }
+
     if (continuous_trace)
       XDPPlugin::startWriteThread(XDPPlugin::get_trace_file_dump_int_s(), "VP_TRACE");
   }
 
+  DeviceOffloadPlugin::~DeviceOffloadPlugin()
+  {
+    stopCounterSampling() ;
+  }
+
   void DeviceOffloadPlugin::configureDataflow(uint64_t deviceId,
                                               DeviceIntf* devInterface)
   {
@@ -230,7 +254,150 @@ namespace xdp {
       }
     }
 
-    offloaders[deviceId] = std::make_tuple(offloader, logger, devInterface) ;
+    {
+      std::lock_guard<std::mutex> lock(offloadersLock) ;
+      offloaders[deviceId] = std::make_tuple(offloader, logger, devInterface) ;
+      if (counter_sampling_interval_ms != 0)
+        configureCounterSampling(deviceId, devInterface) ;
+    }
+
+    if (counter_sampling_interval_ms != 0 && !samplingThread.joinable()) {
+      keepSampling = true ;
+      samplingThread = xrt_core::thread(xrt_core::thread_class::profile, &DeviceOffloadPlugin::sampleCounters, this) ;
+    }
+  }
+
+  void DeviceOffloadPlugin::configureCounterSampling(uint64_t deviceId,
+                                                     DeviceIntf* devInterface)
+  {
+    struct FieldInfo
+    {
+      xclPerfMonType type ;
+      CounterField field ;
+      const char* column ;
+      const char* track ;
+    } ;
+    static const FieldInfo fields[] = {
+      { XCL_PERF_MON_MEMORY, AIM_READ_BYTES,      "read_bytes",      "Read (MB/s)"        },
+      { XCL_PERF_MON_MEMORY, AIM_WRITE_BYTES,     "write_bytes",     "Write (MB/s)"       },
+      { XCL_PERF_MON_ACCEL,  AM_BUSY_CYCLES,      "busy_cycles",     "Busy Cycles"        },
+      { XCL_PERF_MON_ACCEL,  AM_STALL_INT_CYCLES, "stall_int_cycles","Intra-Kernel Stall Cycles" },
+      { XCL_PERF_MON_ACCEL,  AM_STALL_STR_CYCLES, "stall_str_cycles","Stream Stall Cycles" },
+      { XCL_PERF_MON_ACCEL,  AM_STALL_EXT_CYCLES, "stall_ext_cycles","External Memory Stall Cycles" },
+      { XCL_PERF_MON_STR,    ASM_DATA_BYTES,      "data_bytes",      "Data (MB/s)"        },
+      { XCL_PERF_MON_STR,    ASM_STALL_CYCLES,    "stall_cycles",    "Stall Cycles"       },
+      { XCL_PERF_MON_STR,    ASM_STARVE_CYCLES,   "starve_cycles",   "Starve Cycles"      }
+    } ;
+
+    SampledDevice sampled ;
+    std::vector<std::string> names ;
+    uint64_t group = 0 ;
+    if (perfettoTrace)
+      group = perfettoTrace->getTrack("Device Counters " + std::to_string(deviceId), 0) ;
+
+    for (auto& f : fields) {
+      uint32_t numMonitors = devInterface->getNumMonitors(f.type) ;
+      for (uint32_t i = 0 ; i < numMonitors ; ++i) {
+        std::string monitor = devInterface->getMonitorName(f.type, i) ;
+        SampledCounter counter ;
+        counter.field = f.field ;
+        counter.slot  = devInterface->getMonitorSlot(f.type, i) ;
+        counter.track = 0 ;
+        if (perfettoTrace)
+          counter.track =
+            perfettoTrace->getTrack(monitor + " " + f.track, group, true) ;
+        sampled.counters.push_back(counter) ;
+        names.push_back(monitor + "/" + f.column) ;
+      }
+    }
+    sampled.last.assign(sampled.counters.size(), 0) ;
+    sampledDevices[deviceId] = sampled ;
+    (db->getDynamicInfo()).setDeviceCounterNames(deviceId, names) ;
+  }
+
+  void DeviceOffloadPlugin::sampleCounters()
+  {
+    auto interval = std::chrono::milliseconds(counter_sampling_interval_ms) ;
+    auto next = std::chrono::steady_clock::now() ;
+    while (keepSampling) {
+      {
+        std::lock_guard<std::mutex> lock(offloadersLock) ;
+        uint64_t timestamp = xrt_core::time_ns() ;
+        for (auto& o : offloaders)
+          sampleDevice(o.first, std::get<2>(o.second), timestamp) ;
+      }
+
+      // Keep samples of all devices aligned to the same interval even if
+      //  reading the counters takes a while
+      next += interval ;
+      auto now = std::chrono::steady_clock::now() ;
+      if (next < now)
+        next = now ;
+      std::this_thread::sleep_until(next) ;
+    }
+  }
+
+  void DeviceOffloadPlugin::sampleDevice(uint64_t deviceId,
+                                         DeviceIntf* devInterface,
+                                         uint64_t timestamp)
+  {
+    auto iter = sampledDevices.find(deviceId) ;
+    if (iter == sampledDevices.end() || devInterface == nullptr)
+      return ;
+    SampledDevice& sampled = iter->second ;
+
+    xclCounterResults results ;
+    try {
+      devInterface->readCounters(results) ;
+    }
+    catch (std::exception& /*e*/) {
+      // Reading the counters could throw an exception if ioctls fail
+      return ;
+    }
+
+    std::vector<uint64_t> values ;
+    values.reserve(sampled.counters.size()) ;
+    for (auto& c : sampled.counters) {
+      switch (c.field) {
+      case AIM_READ_BYTES:      values.push_back(results.ReadBytes[c.slot]) ;        break ;
+      case AIM_WRITE_BYTES:     values.push_back(results.WriteBytes[c.slot]) ;       break ;
+      case AM_BUSY_CYCLES:      values.push_back(results.CuBusyCycles[c.slot]) ;     break ;
+      case AM_STALL_INT_CYCLES: values.push_back(results.CuStallIntCycles[c.slot]) ; break ;
+      case AM_STALL_STR_CYCLES: values.push_back(results.CuStallStrCycles[c.slot]) ; break ;
+      case AM_STALL_EXT_CYCLES: values.push_back(results.CuStallExtCycles[c.slot]) ; break ;
+      case ASM_DATA_BYTES:      values.push_back(results.StrDataBytes[c.slot]) ;     break ;
+      case ASM_STALL_CYCLES:    values.push_back(results.StrStallCycles[c.slot]) ;   break ;
+      case ASM_STARVE_CYCLES:   values.push_back(results.StrStarveCycles[c.slot]) ;  break ;
+      }
+    }
+    (db->getDynamicInfo()).addDeviceCounterSample(deviceId, timestamp, values) ;
+
+    // Counter tracks show bytes as bandwidth and cycles as the increase
+    //  over the interval
+    if (perfettoTrace && sampled.lastTimestamp != 0 &&
+        timestamp > sampled.lastTimestamp) {
+      double intervalUs =
+        static_cast<double>(timestamp - sampled.lastTimestamp) / 1000.0 ;
+      for (size_t i = 0 ; i < values.size() ; ++i) {
+        uint64_t delta = values[i] >= sampled.last[i] ?
+                         values[i] - sampled.last[i] : values[i] ;
+        CounterField field = sampled.counters[i].field ;
+        bool bytes = field == AIM_READ_BYTES || field == AIM_WRITE_BYTES ||
+                     field == ASM_DATA_BYTES ;
+        double value = bytes ? static_cast<double>(delta) / intervalUs
+                             : static_cast<double>(delta) ;
+        perfettoTrace->writeCounter(sampled.counters[i].track, timestamp, value);
+      }
+    }
+    sampled.last = values ;
+    sampled.lastTimestamp = timestamp ;
+  }
+
+  void DeviceOffloadPlugin::stopCounterSampling()
+  {
+    keepSampling = false ;
+    if (samplingThread.joinable())
+      samplingThread.join() ;
   }
 
   void DeviceOffloadPlugin::startContinuousThreads(uint64_t deviceId)
@@ -317,6 +484,7 @@ namespace xdp {
 
   void DeviceOffloadPlugin::readCounters()
   {
+    std::lock_guard<std::mutex> lock(offloadersLock) ;
     for (auto o : offloaders)
     {
       uint64_t deviceId = o.first ;
@@ -424,6 +592,7 @@ namespace xdp {
 
   void DeviceOffloadPlugin::clearOffloader(uint64_t deviceId)
   {
+    std::lock_guard<std::mutex> lock(offloadersLock) ;
     if(offloaders.find(deviceId) == offloaders.end()) {
       return;
     }
@@ -435,10 +604,12 @@ namespace xdp {
     delete logger;
 
     offloaders.erase(deviceId);
+    sampledDevices.erase(deviceId);
   }
 
   void DeviceOffloadPlugin::clearOffloaders()
   {
+    std::lock_guard<std::mutex> lock(offloadersLock) ;
     for(auto entry : offloaders) {
       auto offloader = std::get<0>(entry.second);
       auto logger    = std::get<1>(entry.second);
@@ -447,6 +618,7 @@ namespace xdp {
       delete logger;
     }
     offloaders.clear();
+    sampledDevices.clear();
   }
 
 } // end namespace xdp
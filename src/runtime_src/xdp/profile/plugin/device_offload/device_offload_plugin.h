@@ -17,13 +17,19 @@
 #ifndef DEVICE_OFFLOAD_PLUGIN_DOT_H
 #define DEVICE_OFFLOAD_PLUGIN_DOT_H
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 #include "xdp/profile/device/device_intf.h"
 #include "xdp/profile/device/device_trace_offload.h"
+#include "xdp/profile/writer/vp_base/vp_perfetto_trace.h"
 
 namespace xdp {
 
@@ -49,6 +55,41 @@ namespace xdp {
     unsigned int trace_buffer_offload_interval_ms ;
     bool m_enable_circular_buffer = false;
 
+    // When Debug.device_counter_sampling_interval_ms is set, a thread
+    //  reads the monitor counters of all devices at that interval, so
+    //  bandwidth and stalls can be followed while kernels run.  The
+    //  samples are kept in the dynamic database and are also written to
+    //  Perfetto counter tracks if enabled.
+    unsigned int counter_sampling_interval_ms ;
+    std::atomic<bool> keepSampling ;
+    std::thread samplingThread ;
+    std::shared_ptr<VPPerfettoTrace> perfettoTrace ;
+
+    enum CounterField {
+      AIM_READ_BYTES, AIM_WRITE_BYTES,
+      AM_BUSY_CYCLES, AM_STALL_INT_CYCLES, AM_STALL_STR_CYCLES,
+      AM_STALL_EXT_CYCLES,
+      ASM_DATA_BYTES, ASM_STALL_CYCLES, ASM_STARVE_CYCLES
+    } ;
+    struct SampledCounter
+    {
+      CounterField field ;
+      uint64_t slot ;
+      uint64_t track ;
+    } ;
+    struct SampledDevice
+    {
+      std::vector<SampledCounter> counters ;
+      std::vector<uint64_t> last ;
+      uint64_t lastTimestamp = 0 ;
+    } ;
+    std::map<uint64_t, SampledDevice> sampledDevices ;
+
+    void configureCounterSampling(uint64_t deviceId, DeviceIntf* devInterface) ;
+    void sampleCounters() ;
+    void sampleDevice(uint64_t deviceId, DeviceIntf* devInterface,
+                      uint64_t timestamp) ;
+
   protected:
     // Each device offload plugin is responsible for offloading
     //  information from all devices.  This holds all the objects
@@ -59,6 +100,10 @@ namespace xdp {
 
     std::map<uint64_t, DeviceData> offloaders;
 
+    // Held while offloaders are added or removed and while counters are
+    //  read, as the sampling thread reads counters of all offloaders
+    std::mutex offloadersLock ;
+
     XDP_EXPORT void addDevice(const std::string& sysfsPath) ;
     XDP_EXPORT void configureDataflow(uint64_t deviceId, DeviceIntf* devInterface) ;
     XDP_EXPORT void configureFa(uint64_t deviceId, DeviceIntf* devInterface) ;
@@ -68,13 +113,14 @@ namespace xdp {
     XDP_EXPORT void startContinuousThreads(uint64_t deviceId) ;
 
     XDP_EXPORT void readCounters() ;
+    XDP_EXPORT void stopCounterSampling() ;
     XDP_EXPORT virtual void readTrace() = 0 ;
     XDP_EXPORT void checkTraceBufferFullness(DeviceTraceOffload* offloader, uint64_t deviceId) ;
     XDP_EXPORT bool flushTraceOffloader(DeviceTraceOffload* offloader);
 
   public:
     XDP_EXPORT DeviceOffloadPlugin() ;
-    XDP_EXPORT virtual ~DeviceOffloadPlugin() = default ;
+    XDP_EXPORT virtual ~DeviceOffloadPlugin() ;
 
     virtual void writeAll(bool openNewFiles) ;
 
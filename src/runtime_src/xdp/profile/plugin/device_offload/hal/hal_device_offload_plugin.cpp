@@ -70,6 +70,9 @@ namespace xdp {
 
   HALDeviceOffloadPlugin::~HALDeviceOffloadPlugin()
   {
+    // The sampling thread reads devices that are closed below
+    stopCounterSampling() ;
+
     if (VPDatabase::alive())
     {
       // If we are destroyed before the database, we need to
@@ -29,6 +29,7 @@
 
 #include "core/common/xrt_profiling.h"
 #include "core/common/message.h"
+#include "core/common/config_reader.h"
 
 #define MAX_PATH_SZ 512
 
@@ -45,7 +46,13 @@ namespace xdp {
     std::string xrtVersion   = xdp::getXRTVersion() ;
     std::string toolVersion  = xdp::getToolVersion() ;
 
-    // Based upon the configuration, create the appropriate writers
+    // Based upon the configuration, create the appropriate writers.
+    //  When only transfer histograms are collected there is no trace.
+    if (xrt_core::config::get_hal_transfer_stats() &&
+        !xrt_core::config::get_xrt_trace() &&
+        !xrt_core::config::get_host_trace())
+      return ;
+
     VPWriter* writer = new HALHostTraceWriter("hal_host_trace.csv",
                                               version,
                                               creationTime,
@@ -23,6 +23,9 @@
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/database/events/hal_api_calls.h"
 #include "xdp/profile/database/events/opencl_host_events.h"
+#include "xdp/profile/plugin/vp_base/api_sampler.h"
+#include "core/common/device.h"
+#include "core/common/system.h"
 #include "core/common/time.h"
 
 #include "hal_plugin.h"
@@ -32,7 +35,8 @@ namespace xdp {
   // This object is created when the plugin library is loaded
   static HALPlugin halPluginInstance ;
 
-  static void generic_log_function_start(const char* functionName, uint64_t id)
+  // Return false if the call is not traced because of API sampling
+  static bool generic_log_function_start(const char* functionName, uint64_t id)
   {
     auto timestamp = xrt_core::time_ns() ;
     VPDatabase* db = halPluginInstance.getDatabase() ;
@@ -40,6 +44,9 @@ namespace xdp {
     // Update counters
     (db->getStats()).logFunctionCallStart(functionName, timestamp) ;
 
+    if (!APISampler::instance().sample(functionName))
+      return false ;
+
     // Update trace
     VTFEvent* event =
       new HALAPICall(0,
@@ -47,9 +54,10 @@ namespace xdp {
                      (db->getDynamicInfo()).addString(functionName));
     (db->getDynamicInfo()).addEvent(event) ;
     (db->getDynamicInfo()).markStart(id, event->getEventId()) ;
+    return true ;
   }
 
-  static void generic_log_function_end(const char* functionName, uint64_t id)
+  static bool generic_log_function_end(const char* functionName, uint64_t id)
   {
     auto timestamp = xrt_core::time_ns() ;
     VPDatabase* db = halPluginInstance.getDatabase() ;
@@ -57,18 +65,25 @@ namespace xdp {
     // Update counters
     (db->getStats()).logFunctionCallEnd(functionName, timestamp) ;
 
+    // The start of this call was not sampled
+    uint64_t start = (db->getDynamicInfo()).matchingStart(id) ;
+    if (start == 0 && APISampler::instance().isActive())
+      return false ;
+
     // Update trace
     VTFEvent* event =
-      new HALAPICall((db->getDynamicInfo()).matchingStart(id),
+      new HALAPICall(start,
 		     timestamp,
 		     (db->getDynamicInfo()).addString(functionName));
     (db->getDynamicInfo()).addEvent(event) ;
+    return true ;
   }
 
   static void write_bo_start(const char* name, uint64_t id,
                              uint64_t bufferId, uint64_t size)
   {
-    generic_log_function_start(name, id) ;
+    if (!generic_log_function_start(name, id))
+      return ;
 
     // Also create a buffer transfer event
     VPDatabase* db = halPluginInstance.getDatabase() ;
@@ -81,7 +96,8 @@ namespace xdp {
 
   static void write_bo_end(const char* name, uint64_t id, uint64_t bufferId)
   {
-    generic_log_function_end(name, id) ;
+    if (!generic_log_function_end(name, id))
+      return ;
 
     // Add trace event for end of Buffer Transfer
     auto timestamp = xrt_core::time_ns();
@@ -95,7 +111,8 @@ namespace xdp {
   static void read_bo_start(const char* name, uint64_t id,
                             uint64_t bufferId, uint64_t size)
   {
-    generic_log_function_start(name, id) ;
+    if (!generic_log_function_start(name, id))
+      return ;
 
     // Also create a buffer transfer event
     VPDatabase* db = halPluginInstance.getDatabase() ;
@@ -108,7 +125,8 @@ namespace xdp {
 
   static void read_bo_end(const char* name, uint64_t id, uint64_t bufferId)
   {
-    generic_log_function_end(name, id) ;
+    if (!generic_log_function_end(name, id))
+      return ;
 
     // Add trace event for end of Buffer Transfer
     auto timestamp = xrt_core::time_ns();
@@ -119,8 +137,39 @@ namespace xdp {
     (db->getDynamicInfo()).addEvent(event);
   }
 
+  static void log_transfer_stats(void* handle, unsigned int direction,
+                                 uint64_t size, uint64_t duration)
+  {
+    uint64_t deviceId = 0 ;
+    try {
+      deviceId = xrt_core::get_userpf_device(handle)->get_device_id() ;
+    }
+    catch (...) {
+      return ;
+    }
+
+    VPDatabase* db = halPluginInstance.getDatabase() ;
+    (db->getStats()).logHALTransfer(deviceId,
+      static_cast<HALTransferStatistics::TransferType>(direction),
+      size, duration) ;
+  }
+
 } //  xdp
 
+extern "C"
+void hal_transfer_stats_cb(void* handle, unsigned int direction,
+                           const char* /*name*/,
+                           unsigned long long int size,
+                           unsigned long long int duration)
+{
+  if(!xdp::VPDatabase::alive()) {
+    return;
+  }
+  xdp::log_transfer_stats(handle, direction,
+                          static_cast<uint64_t>(size),
+                          static_cast<uint64_t>(duration)) ;
+}
+
 extern "C"
 void hal_generic_cb(bool isStart, const char* name, unsigned long long int id)
 {
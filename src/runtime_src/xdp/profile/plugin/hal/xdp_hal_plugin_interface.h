@@ -33,6 +33,14 @@ void buffer_transfer_cb(bool isWrite,
 			unsigned long long int id,
 			unsigned long long int bufferId,
 			unsigned long long int size) ;
+
+// Duration of a buffer transfer for the transfer histograms
+XDP_EXPORT
+void hal_transfer_stats_cb(void* handle,
+                           unsigned int direction,
+                           const char* name,
+                           unsigned long long int size,
+                           unsigned long long int duration) ;
 }
 
 #endif
@@ -33,6 +33,10 @@ namespace xdp {
     // Since these are OpenCL level events, we must use the OpenCL
     //  level time functions to get the proper value of time zero.
     double timestamp = xrt_xocl::time_ns() ;
+    if (auto trace = lopPluginInstance.getBinaryTrace()) {
+      trace->log(OPENCL_API_CALL, true, timestamp, functionID, queueAddress, functionName) ;
+      return ;
+    }
     VPDatabase* db = lopPluginInstance.getDatabase() ;
 
     if (queueAddress != 0) 
@@ -53,6 +57,10 @@ namespace xdp {
 				      unsigned long long int functionID)
   {
     double timestamp = xrt_xocl::time_ns() ;
+    if (auto trace = lopPluginInstance.getBinaryTrace()) {
+      trace->log(OPENCL_API_CALL, false, timestamp, functionID, queueAddress, functionName) ;
+      return ;
+    }
     VPDatabase* db = lopPluginInstance.getDatabase() ;
 
     uint64_t start = (db->getDynamicInfo()).matchingStart(functionID) ;
@@ -69,6 +77,10 @@ namespace xdp {
   static void lop_read(unsigned int XRTEventId, bool isStart)
   {
     double timestamp = xrt_xocl::time_ns() ;
+    if (auto trace = lopPluginInstance.getBinaryTrace()) {
+      trace->log(LOP_READ_BUFFER, isStart, timestamp, XRTEventId) ;
+      return ;
+    }
     VPDatabase* db = lopPluginInstance.getDatabase() ;
     
     uint64_t start = 0 ;
@@ -87,6 +99,10 @@ namespace xdp {
   static void lop_write(unsigned int XRTEventId, bool isStart)
   {
     double timestamp = xrt_xocl::time_ns() ;
+    if (auto trace = lopPluginInstance.getBinaryTrace()) {
+      trace->log(LOP_WRITE_BUFFER, isStart, timestamp, XRTEventId) ;
+      return ;
+    }
     VPDatabase* db = lopPluginInstance.getDatabase() ;
 
     uint64_t start = 0 ;
@@ -104,6 +120,10 @@ namespace xdp {
   static void lop_kernel_enqueue(unsigned int XRTEventId, bool isStart)
   {
     double timestamp = xrt_xocl::time_ns() ;
+    if (auto trace = lopPluginInstance.getBinaryTrace()) {
+      trace->log(LOP_KERNEL_ENQUEUE, isStart, timestamp, XRTEventId) ;
+      return ;
+    }
     VPDatabase* db = lopPluginInstance.getDatabase() ;
 
     uint64_t start = 0 ;
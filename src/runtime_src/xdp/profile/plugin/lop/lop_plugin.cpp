@@ -18,6 +18,7 @@
 #include "xdp/profile/plugin/lop/lop_plugin.h"
 #include "xdp/profile/writer/lop/low_overhead_trace_writer.h"
 #include "core/common/config_reader.h"
+#include "core/common/message.h"
 
 namespace xdp {
 
@@ -131,6 +132,15 @@ namespace xdp {
     db->registerPlugin(this) ;
     db->registerInfo(info::lop);
 
+    if (xrt_core::config::get_lop_trace_binary()) {
+      binaryTrace = std::make_unique<LOPBinaryTrace>("lop_trace.bin") ;
+      if (binaryTrace->isOpen())
+        return ;
+      binaryTrace.reset() ;
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Unable to create lop_trace.bin, low overhead trace will be written as lop_trace.csv") ;
+    }
+
     VPWriter* writer = new LowOverheadTraceWriter("lop_trace.csv") ;
     writers.push_back(writer) ;
 
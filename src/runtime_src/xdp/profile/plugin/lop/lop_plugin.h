@@ -17,7 +17,10 @@
 #ifndef LOP_PLUGIN_DOT_H
 #define LOP_PLUGIN_DOT_H
 
+#include <memory>
+
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
+#include "xdp/profile/writer/vp_base/lop_binary_trace.h"
 
 namespace xdp {
 
@@ -29,9 +32,15 @@ namespace xdp {
   {
   private:
     static const char* APIs[] ;
+
+    // When recording binary trace, events bypass the database
+    std::unique_ptr<LOPBinaryTrace> binaryTrace ;
+
   public:
     LowOverheadProfilingPlugin() ;
     ~LowOverheadProfilingPlugin() ;
+
+    LOPBinaryTrace* getBinaryTrace() { return binaryTrace.get() ; }
   } ;
 
 }
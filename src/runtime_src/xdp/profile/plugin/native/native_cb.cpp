@@ -20,6 +20,7 @@
 #include "xdp/profile/plugin/native/native_cb.h"
 #include "xdp/profile/plugin/native/native_plugin.h"
 #include "xdp/profile/database/events/native_events.h"
+#include "xdp/profile/plugin/vp_base/api_sampler.h"
 
 #include "core/common/time.h"
 
@@ -41,6 +42,11 @@ void native_function_start(const char* functionName, unsigned long long int func
   //  the profiling overhead exists.
   xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase() ;
 
+  if (!xdp::APISampler::instance().sample(functionName)) {
+    db->getStats().logFunctionCallStart(functionName, static_cast<double>(xrt_core::time_ns()));
+    return ;
+  }
+
   xdp::VTFEvent* event =
     new xdp::NativeAPICall(0,
                            0,
@@ -60,6 +66,9 @@ void native_function_end(const char* functionName, unsigned long long int functi
 
   uint64_t start =
     (db->getDynamicInfo()).matchingStart(static_cast<uint64_t>(functionID)) ;
+  // The start of this call was not sampled
+  if (start == 0 && xdp::APISampler::instance().isActive())
+    return ;
 
   xdp::VTFEvent* event =
     new xdp::NativeAPICall(start,
@@ -76,6 +85,15 @@ void native_sync_start(const char* functionName, unsigned long long int function
   //  the profiling overhead exists.
   xdp::VPDatabase* db = xdp::nativePluginInstance.getDatabase() ;
 
+  if (!xdp::APISampler::instance().sample(functionName)) {
+    {
+      std::lock_guard<std::mutex> lock(xdp::timestampLock) ;
+      xdp::nativeTimestamps[static_cast<uint64_t>(functionID)] = xrt_core::time_ns() ;
+    }
+    db->getStats().logFunctionCallStart(functionName, static_cast<double>(xrt_core::time_ns()));
+    return ;
+  }
+
   xdp::VTFEvent* event = nullptr ;
   if (isWrite) {
     event =
@@ -121,23 +139,28 @@ void native_sync_end(const char* functionName, unsigned long long int functionID
 
   uint64_t start =
     (db->getDynamicInfo()).matchingStart(static_cast<uint64_t>(functionID)) ;
-
-  xdp::VTFEvent* event = nullptr ;
-  if (isWrite) {
-    event =
-      new xdp::NativeSyncWrite(start,
-                               static_cast<double>(timestamp),
-                               db->getDynamicInfo().addString(functionName),
-                               db->getDynamicInfo().addString("WRITE")) ;
-  }
-  else {
-    event =
-      new xdp::NativeSyncRead(start,
-                              static_cast<double>(timestamp),
-                              db->getDynamicInfo().addString(functionName),
-                              db->getDynamicInfo().addString("READ")) ;
+  // Calls whose start was not sampled are not traced, but the transfer
+  //  statistics are still logged
+  bool sampled = (start != 0 || !xdp::APISampler::instance().isActive()) ;
+
+  if (sampled) {
+    xdp::VTFEvent* event = nullptr ;
+    if (isWrite) {
+      event =
+        new xdp::NativeSyncWrite(start,
+                                 static_cast<double>(timestamp),
+                                 db->getDynamicInfo().addString(functionName),
+                                 db->getDynamicInfo().addString("WRITE")) ;
+    }
+    else {
+      event =
+        new xdp::NativeSyncRead(start,
+                                static_cast<double>(timestamp),
+                                db->getDynamicInfo().addString(functionName),
+                                db->getDynamicInfo().addString("READ")) ;
+    }
+    (db->getDynamicInfo()).addUnsortedEvent(event) ;
   }
-  (db->getDynamicInfo()).addUnsortedEvent(event) ;
 
   if (isWrite) {
     db->getStats().logHostWrite(0, 0, size, startTimestamp, transferTime, 0, 0);
@@ -22,11 +22,41 @@
 #include "xdp/profile/plugin/vp_base/info.h"
 
 #include "core/common/system.h"
+#include "core/common/thread.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
 #include "core/include/experimental/xrt-next.h"
 
-#include <boost/algorithm/string.hpp>
+namespace {
+
+  // Read the counters of the first numNOC NMUs of a device into values,
+  //  NOCSampleLog::NUM_COUNTERS per NMU.  All NMUs of a device are read
+  //  in one sweep, so the counters of an NMU region can be fetched with
+  //  one batched transaction.
+  // TODO: replace dummy data with counter values
+  void readNOCCounters(uint64_t pollnum, uint64_t numNOC, uint64_t* values)
+  {
+    using log = xdp::NOCSampleLog;
+    for (uint64_t n = 0; n < numNOC; ++n) {
+      uint64_t* v = values + n * log::NUM_COUNTERS;
+
+      // Read
+      v[log::READ_BYTE_COUNT]    = pollnum * 128;
+      v[log::READ_BURST_COUNT]   = pollnum * 10;
+      v[log::READ_TOTAL_LATENCY] = pollnum * 1000;
+      v[log::READ_MIN_LATENCY]   = 42;
+      v[log::READ_MAX_LATENCY]   = 100;
+
+      // Write
+      v[log::WRITE_BYTE_COUNT]    = pollnum * 234;
+      v[log::WRITE_BURST_COUNT]   = pollnum * 21;
+      v[log::WRITE_TOTAL_LATENCY] = pollnum * 1234;
+      v[log::WRITE_MIN_LATENCY]   = 24;
+      v[log::WRITE_MAX_LATENCY]   = 123;
+    }
+  }
+
+} // end anonymous namespace
 
 namespace xdp {
 
@@ -45,6 +75,7 @@ namespace xdp {
       xclGetDeviceInfo2(handle, &info);
       std::string deviceName = std::string(info.mName);
       mDevices.push_back(deviceName);
+      mSampleLogs.push_back(db->getDynamicInfo().getNOCSampleLog(index));
 
       std::string outputFile = "noc_profile_" + deviceName + ".csv"; 
       VPWriter* writer = new NOCProfilingWriter(outputFile.c_str(),
@@ -59,11 +90,15 @@ namespace xdp {
       handle = xclOpen(index, "/dev/null", XCL_INFO);
     }
 
-    // Get polling interval (in msec)
-    mPollingInterval = xrt_core::config::get_noc_profile_interval_ms();
+    // Get polling interval, in usec if specified, otherwise in msec
+    auto intervalUs = xrt_core::config::get_noc_profile_interval_us();
+    if (intervalUs)
+      mPollingInterval = std::chrono::microseconds(intervalUs);
+    else
+      mPollingInterval = std::chrono::milliseconds(xrt_core::config::get_noc_profile_interval_ms());
 
     // Start the NOC profiling thread
-    mPollingThread = std::thread(&NOCProfilingPlugin::pollNOCCounters, this);
+    mPollingThread = xrt_core::thread(xrt_core::thread_class::profile, &NOCProfilingPlugin::pollNOCCounters, this);
   }
 
   NOCProfilingPlugin::~NOCProfilingPlugin()
@@ -85,59 +120,42 @@ namespace xdp {
   {
     uint64_t pollnum = 0;
 
+    // Counters of all NMUs of one device, reused for every sweep
+    std::vector<uint64_t> values;
+
+    // Polls are scheduled at fixed times, so the time it takes to read
+    //  the counters does not add to the interval
+    auto next = std::chrono::steady_clock::now();
+
     while (mKeepPolling) {
       // Get timestamp in milliseconds
       double timestamp = xrt_core::time_ns() / 1.0e6;
-      uint64_t index = 0;
 
       // Iterate over all devices
-      for (auto device : mDevices) {
+      for (uint64_t index = 0; index < mDevices.size(); ++index) {
         XclbinInfo* currentXclbin = db->getStaticInfo().getCurrentlyLoadedXclbin(index);
-        // Iterate over all NOC NMUs
         auto numNOC = db->getStaticInfo().getNumNOC(index, currentXclbin);
-        for (uint64_t n=0; n < numNOC; n++) {
-          auto noc = db->getStaticInfo().getNOC(index, currentXclbin, n);
-
-          // Name = <master>-<NMU cell>-<read QoS>-<write QoS>-<NPI freq>-<AIE freq>
-          std::vector<std::string> result; 
-          boost::split(result, noc->name, boost::is_any_of("-"));
-          std::string cellName = (result.size() > 1) ? result[1] : "N/A";
-
-          // TODO: replace dummy data with counter values
-          std::vector<uint64_t> values;
-
-          // Read
-          uint64_t readByteCount    = pollnum * 128;
-          uint64_t readBurstCount   = pollnum * 10;
-          uint64_t readTotalLatency = pollnum * 1000;
-          uint64_t readMinLatency   = 42;
-          uint64_t readMaxLatency   = 100;
-          values.push_back(readByteCount);
-          values.push_back(readBurstCount);
-          values.push_back(readTotalLatency);
-          values.push_back(readMinLatency);
-          values.push_back(readMaxLatency);
-
-          // Write
-          uint64_t writeByteCount    = pollnum * 234;
-          uint64_t writeBurstCount   = pollnum * 21;
-          uint64_t writeTotalLatency = pollnum * 1234;
-          uint64_t writeMinLatency   = 24;
-          uint64_t writeMaxLatency   = 123;
-          values.push_back(writeByteCount);
-          values.push_back(writeBurstCount);
-          values.push_back(writeTotalLatency);
-          values.push_back(writeMinLatency);
-          values.push_back(writeMaxLatency);
-
-          // Add sample to dynamic database
-	        db->getDynamicInfo().addNOCSample(index, timestamp, cellName, values);
-	        ++index;
-        }
+        if (numNOC == 0)
+          continue;
+
+        values.resize(numNOC * NOCSampleLog::NUM_COUNTERS);
+        readNOCCounters(pollnum, numNOC, values.data());
+
+        // Add samples of all NMUs to the log of the device at once
+        NOCSampleLog* log = mSampleLogs[index];
+        log->append(timestamp, 0, numNOC, values.data());
+        log->publish();
       }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(mPollingInterval));
-      ++pollnum;      
+      ++pollnum;
+
+      // If a sweep overran the interval, skip the missed polls rather
+      //  than polling back to back to catch up
+      next += mPollingInterval;
+      auto now = std::chrono::steady_clock::now();
+      if (next < now)
+        next = now;
+      std::this_thread::sleep_until(next);
     }
   }
 
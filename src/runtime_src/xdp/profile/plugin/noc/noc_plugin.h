@@ -17,10 +17,13 @@
 #ifndef XDP_NOC_PLUGIN_DOT_H
 #define XDP_NOC_PLUGIN_DOT_H
 
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <thread>
 
+#include "xdp/profile/database/noc_sample_log.h"
 #include "xdp/profile/plugin/vp_base/vp_base_plugin.h"
 #include "xdp/config.h"
 
@@ -37,10 +40,11 @@ namespace xdp {
 
   private:
     // NOC profiling uses its own thread
-    bool mKeepPolling;
-    unsigned int mPollingInterval;
+    std::atomic<bool> mKeepPolling;
+    std::chrono::microseconds mPollingInterval;
     std::thread mPollingThread;
     std::vector<std::string> mDevices;
+    std::vector<NOCSampleLog*> mSampleLogs;
   };
 
 } // end namespace xdp
@@ -22,6 +22,7 @@
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/database/events/opencl_api_calls.h"
 #include "xdp/profile/database/events/opencl_host_events.h"
+#include "xdp/profile/plugin/vp_base/api_sampler.h"
 #include "core/common/time.h"
 
 namespace xdp {
@@ -38,6 +39,11 @@ namespace xdp {
     if (queueAddress != 0) 
       (db->getStaticInfo()).addCommandQueueAddress(queueAddress) ;
 
+    // API call counters are collected by the OpenCL counters plugin, so
+    //  unsampled calls only skip the trace
+    if (!APISampler::instance().sample(functionName))
+      return ;
+
     VTFEvent* event = new OpenCLAPICall(0,
 					timestamp,
 					functionID,
@@ -56,6 +62,9 @@ namespace xdp {
     VPDatabase* db = openclPluginInstance.getDatabase() ;
 
     uint64_t start = (db->getDynamicInfo()).matchingStart(functionID) ;
+    // The start of this call was not sampled
+    if (start == 0 && APISampler::instance().isActive())
+      return ;
 
     VTFEvent* event = new OpenCLAPICall(start,
 					timestamp,
@@ -123,6 +132,8 @@ namespace xdp {
     if (!isStart && start == 0 && bufferSize == 0)
       return ;
 
+    (db->getStats()).logBufferWrite(id, isStart, timestamp) ;
+
     VTFEvent* event = 
       new OpenCLBufferTransfer(start,
 			       timestamp,
@@ -206,6 +217,10 @@ namespace xdp {
       (db->getStaticInfo()).addEnqueuedKernel(enqueueIdentifier) ;
     }
 
+    (db->getStats()).logKernelEnqueue(id, isStart,
+                                      kernelName ? kernelName : "",
+                                      timestamp) ;
+
     VTFEvent* event = 
       new KernelEnqueue(start, 
 			timestamp,
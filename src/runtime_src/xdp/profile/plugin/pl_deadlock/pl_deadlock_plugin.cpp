@@ -16,6 +16,7 @@
 
 #define XDP_SOURCE
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -30,6 +31,7 @@
 #include "xdp/profile/device/device_intf.h"
 #include "xdp/profile/device/hal_device/xdp_hal_device.h"
 
+#include "core/common/config_reader.h"
 #include "core/common/system.h"
 #include "core/common/message.h"
 
@@ -40,6 +42,10 @@ namespace xdp {
   PLDeadlockPlugin::PLDeadlockPlugin() : XDPPlugin()
   {
     db->registerPlugin(this);
+
+    mPollingIntervalMs =
+      std::max(xrt_core::config::get_pl_deadlock_detection_interval_ms(), 1u);
+    mMaxPollingIntervalMs = 16 * mPollingIntervalMs;
   }
 
   PLDeadlockPlugin::~PLDeadlockPlugin()
@@ -79,6 +85,9 @@ namespace xdp {
       return;
     auto& should_continue = it->second;
 
+    // Sleep in steps of the initial interval so the thread still ends
+    //  promptly after backing off
+    uint32_t intervalMs = mPollingIntervalMs;
     while (should_continue) {
       if (deviceIntf->getDeadlockStatus()) {
         std::string msg = "System Deadlock detected on device " + deviceName +
@@ -86,7 +95,10 @@ namespace xdp {
         xrt_core::message::send(severity_level::warning, "XRT", msg);
         return;
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(mPollingIntervalMs));
+      for (uint32_t slept = 0; should_continue && slept < intervalMs;
+           slept += mPollingIntervalMs)
+        std::this_thread::sleep_for(std::chrono::milliseconds(mPollingIntervalMs));
+      intervalMs = std::min(2 * intervalMs, mMaxPollingIntervalMs);
     }
   }
 
@@ -30,7 +30,10 @@ namespace xdp {
     XDP_EXPORT virtual void pollDeadlock(void* handle, uint64_t index);
   
   private:
+    // The polling interval doubles while no deadlock is found, up to
+    //  the maximum
     uint32_t mPollingIntervalMs = 100;
+    uint32_t mMaxPollingIntervalMs = 1600;
     std::map<void*, std::thread> mThreadMap;
     std::map<void*,std::atomic<bool>> mThreadCtrlMap;
 
@@ -16,12 +16,19 @@
 
 #define XDP_SOURCE
 
+#include <chrono>
+#include <cstdlib>
 #include <map>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "xdp/profile/plugin/power/power_plugin.h"
 #include "xdp/profile/writer/power/power_writer.h"
+#include "xdp/profile/writer/vp_base/vp_perfetto_trace.h"
 #include "xdp/profile/plugin/vp_base/info.h"
 #include "core/common/system.h"
+#include "core/common/thread.h"
 #include "core/common/time.h"
 #include "core/common/config_reader.h"
 #include "core/include/experimental/xrt-next.h"
@@ -63,6 +70,7 @@ namespace xdp {
     db->registerInfo(info::power) ;
 
     pollingInterval = xrt_core::config::get_power_profile_interval_ms() ;
+    perfettoTrace = VPPerfettoTrace::instance() ;
 
     // There can be multiple boards with the same shell loaded as well as
     //  different boards.  We number them all individually.
@@ -74,15 +82,17 @@ namespace xdp {
     void* handle = xclOpen(index, "/dev/null", XCL_INFO) ;
     while (handle != nullptr)
     {
-      // For each device, keep track of the paths to the sysfs files
-      std::vector<std::string> paths ;
+      // For each device, open the sysfs files once.  Reopening them
+      //  for every sample costs more than reading them.
+      std::vector<int> files ;
       for (auto f : powerFiles)
       {
-	char sysfsPath[512] ;
+	char sysfsPath[512] = "" ;
 	xclGetSysfsPath(handle, "xmc", f, sysfsPath, 512) ;
-	paths.push_back(sysfsPath) ;
+	files.push_back(sysfsPath[0] == '\0' ? -1
+	                : open(sysfsPath, O_RDONLY | O_CLOEXEC)) ;
       }
-      filePaths.push_back(paths) ;
+      sensorFiles.push_back(files) ;
 
       // Determine the name of the device
       struct xclDeviceInfo2 info ;
@@ -96,6 +106,14 @@ namespace xdp {
       deviceName += std::to_string(deviceNumbering[deviceName]) ;
       deviceNumbering[deviceName]++ ;
 
+      if (perfettoTrace) {
+        uint64_t group = perfettoTrace->getTrack("Power " + deviceName, 0) ;
+        std::vector<uint64_t> counters ;
+        for (auto f : powerFiles)
+          counters.push_back(perfettoTrace->getTrack(f, group, true)) ;
+        perfettoTracks.push_back(counters) ;
+      }
+
       std::string outputFile = "power_profile_" + deviceName + ".csv" ; 
 
       VPWriter* writer = new PowerProfilingWriter(outputFile.c_str(),
@@ -112,7 +130,7 @@ namespace xdp {
     }
 
     // Start the power profiling thread
-    pollingThread = std::thread(&PowerProfilingPlugin::pollPower, this) ;
+    pollingThread = xrt_core::thread(xrt_core::thread_class::profile, &PowerProfilingPlugin::pollPower, this) ;
   }
 
   PowerProfilingPlugin::~PowerProfilingPlugin()
@@ -121,6 +139,11 @@ namespace xdp {
     keepPolling = false ;
     pollingThread.join() ;
 
+    for (auto& device : sensorFiles)
+      for (auto fd : device)
+        if (fd >= 0)
+          close(fd) ;
+
     if (VPDatabase::alive())
     {
       for (auto w : writers)
@@ -132,39 +155,57 @@ namespace xdp {
     }
   }
 
+  uint64_t PowerProfilingPlugin::readSensor(int fd)
+  {
+    // A sysfs attribute regenerates its contents when read from offset 0
+    char data[32] ;
+    if (fd < 0)
+      return 0 ;
+    ssize_t n = pread(fd, data, sizeof(data) - 1, 0) ;
+    if (n <= 0)
+      return 0 ;
+    data[n] = '\0' ;
+    return std::strtoull(data, nullptr, 10) ;
+  }
+
   void PowerProfilingPlugin::pollPower()
   {
+    // Samples are taken on a fixed schedule so the time spent reading
+    //  the sensors does not stretch the interval
+    auto interval = std::chrono::milliseconds(pollingInterval) ;
+    auto next = std::chrono::steady_clock::now() ;
+    std::vector<uint64_t> values ;
+
     while(keepPolling)
     {
-      // Get timestamp in milliseconds
-      double timestamp = xrt_core::time_ns() / 1.0e6 ;
+      // All devices share the timestamp of the sample
+      uint64_t timestampNs = xrt_core::time_ns() ;
+      double timestamp = timestampNs / 1.0e6 ;
       uint64_t index = 0 ;
-      for (auto device : filePaths)
+      for (auto& device : sensorFiles)
       {
-	std::vector<uint64_t> values ;
-	for (auto file : device)
-	{
-	  std::ifstream fs(file) ;
-	  if (!fs)
-	  {
-	    // When we tried to get the path to this file, we got a bad
-	    //  result (like empty string).  So all devices are aligned and
-	    //  have the same amount of information we'll just record this
-	    //  data element as 0.
-	    values.push_back(0) ;
-	    continue ;
-	  }
-	  std::string data ;
-	  std::getline(fs, data) ;
-	  uint64_t dp = data.empty() ? 0 : std::stoul(data) ;
-	  values.push_back(dp) ;
-	  fs.close() ;
+	// When we tried to get the path to a file, we got a bad
+	//  result (like empty string).  So all devices are aligned and
+	//  have the same amount of information we'll just record this
+	//  data element as 0.
+	values.clear() ;
+	for (auto fd : device)
+	  values.push_back(readSensor(fd)) ;
+
+	if (perfettoTrace) {
+	  for (size_t i = 0 ; i < values.size() ; ++i)
+	    perfettoTrace->writeCounter(perfettoTracks[index][i], timestampNs,
+	                                static_cast<double>(values[i])) ;
 	}
 	(db->getDynamicInfo()).addPowerSample(index, timestamp, values) ;
 	++index ;	
       }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(pollingInterval)) ;
+      next += interval ;
+      auto now = std::chrono::steady_clock::now() ;
+      if (next < now)
+        next = now ;
+      std::this_thread::sleep_until(next) ;
     }
   }
 
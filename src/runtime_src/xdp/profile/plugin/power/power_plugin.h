@@ -17,6 +17,8 @@
 #ifndef POWER_PROFILING_DOT_H
 #define POWER_PROFILING_DOT_H
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <string>
 #include <thread>
@@ -26,6 +28,8 @@
 
 namespace xdp {
 
+  class VPPerfettoTrace ;
+
   class PowerProfilingPlugin : public XDPPlugin
   {
   private:
@@ -33,10 +37,19 @@ namespace xdp {
     static const char* powerFiles[] ;
 
   private:
-    std::vector<std::vector<std::string>> filePaths ;
+    // The sysfs files of each device stay open for the whole run and are
+    //  reread from the start for every sample, -1 if a file is missing
+    std::vector<std::vector<int>> sensorFiles ;
+    static uint64_t readSensor(int fd) ;
+
+    // Counter tracks of each device, when samples are also written to
+    //  the Perfetto trace
+    std::shared_ptr<VPPerfettoTrace> perfettoTrace ;
+    std::vector<std::vector<uint64_t>> perfettoTracks ;
 
-    // Power profiling requires its own thread
-    bool keepPolling ;
+    // Power profiling requires its own thread, which samples all
+    //  devices at the same time
+    std::atomic<bool> keepPolling ;
     std::thread pollingThread ;
     unsigned int pollingInterval ;
     void pollPower() ;
@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+#include "xdp/profile/plugin/vp_base/api_sampler.h"
+
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
+
+namespace xdp {
+
+  APISampler::APISampler() : active(false), defaultInterval(1)
+  {
+    std::stringstream setting(xrt_core::config::get_api_trace_sampling()) ;
+    std::string entry ;
+    while (std::getline(setting, entry, ',')) {
+      auto colon = entry.rfind(':') ;
+      uint64_t interval = 0 ;
+      if (colon != std::string::npos) {
+        try {
+          interval = std::stoull(entry.substr(colon + 1)) ;
+        }
+        catch (const std::exception&) {
+          interval = 0 ;
+        }
+      }
+      if (interval == 0) {
+        std::string msg = "Ignoring invalid Debug.api_trace_sampling entry: " + entry ;
+        xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg) ;
+        continue ;
+      }
+
+      std::string name = entry.substr(0, colon) ;
+      if (name == "*")
+        defaultInterval = interval ;
+      else
+        apis[name] = std::make_unique<API>(name, interval) ;
+      if (interval > 1)
+        active = true ;
+    }
+  }
+
+  APISampler& APISampler::instance()
+  {
+    static APISampler sampler ;
+    return sampler ;
+  }
+
+  APISampler::API* APISampler::lookup(const char* functionName)
+  {
+    // Function names are almost always string literals, so cache the
+    //  lookup by pointer in each thread
+    thread_local std::unordered_map<const char*, API*> cache ;
+    auto cached = cache.find(functionName) ;
+    if (cached != cache.end() && cached->second->name == functionName)
+      return cached->second ;
+
+    API* api = nullptr ;
+    {
+      std::lock_guard<std::mutex> lock(apisLock) ;
+      auto& entry = apis[functionName] ;
+      if (!entry)
+        entry = std::make_unique<API>(functionName, defaultInterval) ;
+      api = entry.get() ;
+    }
+    cache[functionName] = api ;
+    return api ;
+  }
+
+  bool APISampler::sample(const char* functionName)
+  {
+    if (!active || functionName == nullptr)
+      return true ;
+
+    API* api = lookup(functionName) ;
+    if (api->interval <= 1)
+      return true ;
+    return (api->calls++ % api->interval) == 0 ;
+  }
+
+} // end namespace xdp
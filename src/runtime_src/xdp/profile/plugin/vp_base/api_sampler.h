@@ -0,0 +1,66 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef API_SAMPLER_DOT_H
+#define API_SAMPLER_DOT_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // When Debug.api_trace_sampling is set, the host API trace plugins
+  //  only trace 1 in N calls of each API listed in the setting.  Calls
+  //  that are not traced are still logged in the statistics, so the
+  //  summaries are exact.
+  class APISampler
+  {
+  private:
+    struct API
+    {
+      std::string name ;
+      uint64_t interval ;
+      std::atomic<uint64_t> calls ;
+
+      API(const std::string& n, uint64_t i) : name(n), interval(i), calls(0) {}
+    } ;
+
+    bool active ;
+    uint64_t defaultInterval ;
+
+    std::mutex apisLock ;
+    std::map<std::string, std::unique_ptr<API>> apis ;
+
+    APISampler() ;
+    API* lookup(const char* functionName) ;
+
+  public:
+    XDP_EXPORT static APISampler& instance() ;
+
+    inline bool isActive() const { return active ; }
+
+    // Return true if this call of the API should be traced
+    XDP_EXPORT bool sample(const char* functionName) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
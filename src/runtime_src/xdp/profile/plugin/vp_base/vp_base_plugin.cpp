@@ -24,6 +24,7 @@
 #include "xdp/profile/device/tracedefs.h"
 #include "core/common/config_reader.h"
 #include "core/common/message.h"
+#include "core/common/thread.h"
 #include "core/common/time.h"
 
 #ifdef _WIN32
@@ -134,7 +135,7 @@ namespace xdp {
   {
     if (is_write_thread_active)
       return;
-    write_thread = std::thread(&XDPPlugin::writeContinuous, this, interval, type);
+    write_thread = xrt_core::thread(xrt_core::thread_class::profile, &XDPPlugin::writeContinuous, this, interval, type);
   }
 
   void XDPPlugin::endWrite(bool openNewFiles)
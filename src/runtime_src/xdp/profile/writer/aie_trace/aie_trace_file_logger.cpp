@@ -0,0 +1,65 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <algorithm>
+#include <charconv>
+
+#include "xdp/profile/writer/aie_trace/aie_trace_file_logger.h"
+
+namespace xdp {
+
+  AIETraceFileLogger::AIETraceFileLogger(const std::vector<std::string>& fileNames)
+  {
+    for (auto& name : fileNames)
+      files.push_back(std::make_unique<std::ofstream>(name)) ;
+  }
+
+  AIETraceFileLogger::~AIETraceFileLogger()
+  {
+    for (auto& f : files)
+      *f << std::endl ;
+  }
+
+  void AIETraceFileLogger::addAIETraceData(uint64_t strmIndex, void* buffer, uint64_t bufferSz)
+  {
+    if (strmIndex >= files.size() || buffer == nullptr)
+      return ;
+    std::ofstream& fout = *files[strmIndex] ;
+
+    // Trace is written 4 bytes at a time, always in full packets
+    const uint32_t* data = static_cast<const uint32_t*>(buffer) ;
+    uint64_t numWords = bufferSz / 4 ;
+
+    // Format a block of words at a time rather than streaming each one
+    constexpr uint64_t blockWords = 1024 ;
+    char text[blockWords * 11] ;
+    for (uint64_t start = 0 ; start < numWords ; start += blockWords) {
+      uint64_t end = std::min(numWords, start + blockWords) ;
+      char* p = text ;
+      for (uint64_t i = start ; i < end ; ++i) {
+        *p++ = '0' ;
+        *p++ = 'x' ;
+        p = std::to_chars(p, p + 8, data[i], 16).ptr ;
+        *p++ = '\n' ;
+      }
+      fout.write(text, p - text) ;
+    }
+    fout.flush() ;
+  }
+
+}
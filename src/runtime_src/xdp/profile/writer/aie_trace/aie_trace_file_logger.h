@@ -0,0 +1,51 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef AIE_TRACE_FILE_LOGGER_H
+#define AIE_TRACE_FILE_LOGGER_H
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xdp/config.h"
+#include "xdp/profile/device/aie_trace/aie_trace_logger.h"
+
+namespace xdp {
+
+  // Writes the AIE trace of each stream to its own file as soon as it
+  //  is offloaded, in the same format as the AIE trace writer, instead
+  //  of keeping the buffers in the database until the end.  Each stream
+  //  is only offloaded by one thread at a time, so the files need no lock.
+  class AIETraceFileLogger : public AIETraceLogger
+  {
+  private:
+    std::vector<std::unique_ptr<std::ofstream>> files ;
+
+  public:
+    XDP_EXPORT
+    AIETraceFileLogger(const std::vector<std::string>& fileNames) ;
+    XDP_EXPORT
+    virtual ~AIETraceFileLogger() ;
+
+    XDP_EXPORT
+    virtual void addAIETraceData(uint64_t strmIndex, void* buffer, uint64_t bufferSz) ;
+  } ;
+
+}
+
+#endif
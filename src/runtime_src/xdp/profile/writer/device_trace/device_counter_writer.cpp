@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <vector>
+
+#include "xdp/profile/writer/device_trace/device_counter_writer.h"
+#include "xdp/profile/database/database.h"
+
+namespace xdp {
+
+  DeviceCounterWriter::DeviceCounterWriter(const char* filename,
+                                           uint64_t devId) :
+    VPWriter(filename), deviceId(devId)
+  {
+  }
+
+  DeviceCounterWriter::~DeviceCounterWriter()
+  {
+  }
+
+  bool DeviceCounterWriter::write(bool /*openNewFile*/)
+  {
+    std::vector<VPDynamicDatabase::CounterSample> samples =
+      (db->getDynamicInfo()).getDeviceCounterSamples(deviceId) ;
+    if (samples.empty())
+      return true ;
+
+    // Write header
+    fout << "timestamp" ;
+    for (auto& name : (db->getDynamicInfo()).getDeviceCounterNames(deviceId))
+      fout << "," << name ;
+    fout << std::endl ;
+
+    // Write all of the data elements
+    for (auto& sample : samples) {
+      fout << sample.first ; // Timestamp
+      for (auto value : sample.second)
+        fout << "," << value ;
+      fout << std::endl ;
+    }
+    return true ;
+  }
+
+} // end namespace xdp
@@ -0,0 +1,40 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef DEVICE_COUNTER_WRITER_DOT_H
+#define DEVICE_COUNTER_WRITER_DOT_H
+
+#include "xdp/profile/writer/vp_base/vp_writer.h"
+
+namespace xdp {
+
+  // Writes the periodic samples of the device monitor counters, one row
+  //  per sample with the increase of each counter since the previous row
+  class DeviceCounterWriter : public VPWriter
+  {
+  private:
+    uint64_t deviceId ;
+
+  public:
+    DeviceCounterWriter(const char* filename, uint64_t devId) ;
+    ~DeviceCounterWriter() ;
+
+    virtual bool write(bool openNewFile) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
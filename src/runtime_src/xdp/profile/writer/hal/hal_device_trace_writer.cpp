@@ -210,6 +210,7 @@ namespace xdp {
   void HALDeviceTraceWriter::writeTraceEvents()
   {
     fout << "EVENTS" << std::endl;
+    auto hold = (db->getDynamicInfo()).holdEvents() ;
     std::vector<VTFEvent*> DeviceEvents = (db->getDynamicInfo()).getDeviceEvents(deviceId);
 
     for(auto e : DeviceEvents) {
@@ -217,7 +218,7 @@ namespace xdp {
       if(!deviceEvent)
         continue;
       if(deviceEvent->getCUId() >= 0) {
-        deviceEvent->dump(fout, cuBucketIdMap[deviceEvent->getCUId()] + deviceEvent->getEventType() - KERNEL);
+        dumpEvent(deviceEvent, cuBucketIdMap[deviceEvent->getCUId()] + deviceEvent->getEventType() - KERNEL);
       } else {
         /* Device Events which may not be directly associated with a Kernel using available metadata.
          * For example, AXI monitors for System Compiler, Slave Bridge designs.
@@ -225,7 +226,7 @@ namespace xdp {
         uint32_t monId = deviceEvent->getMonitorId();
         DeviceMemoryAccess* memoryEvent = dynamic_cast<DeviceMemoryAccess*>(e);
         if(memoryEvent) {
-          deviceEvent->dump(fout, aimBucketIdMap[monId] + deviceEvent->getEventType() - KERNEL_READ);
+          dumpEvent(deviceEvent, aimBucketIdMap[monId] + deviceEvent->getEventType() - KERNEL_READ);
           continue;
         }
         DeviceStreamAccess* streamEvent = dynamic_cast<DeviceStreamAccess*>(e);
@@ -233,9 +234,9 @@ namespace xdp {
           VTFEventType eventType = deviceEvent->getEventType();
           if(KERNEL_STREAM_READ == eventType || KERNEL_STREAM_READ_STALL == eventType
                                              || KERNEL_STREAM_READ_STARVE == eventType) {
-            deviceEvent->dump(fout, asmBucketIdMap[monId] + eventType - KERNEL_STREAM_READ);
+            dumpEvent(deviceEvent, asmBucketIdMap[monId] + eventType - KERNEL_STREAM_READ);
           } else {
-            deviceEvent->dump(fout, asmBucketIdMap[monId] + eventType - KERNEL_STREAM_WRITE);
+            dumpEvent(deviceEvent, asmBucketIdMap[monId] + eventType - KERNEL_STREAM_WRITE);
           }
           continue;
         }
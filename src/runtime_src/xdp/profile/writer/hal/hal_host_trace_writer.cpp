@@ -76,6 +76,7 @@ namespace xdp {
   void HALHostTraceWriter::writeTraceEvents()
   {
     fout << "EVENTS" << std::endl ;
+    auto hold = (db->getDynamicInfo()).holdEvents() ;
     std::vector<VTFEvent*> HALAPIEvents = 
       (db->getDynamicInfo()).filterEvents( [](VTFEvent* e)
 					   {
@@ -87,7 +88,7 @@ namespace xdp {
     for (auto e : HALAPIEvents)
     {
       VTFEventType eventType = e->getEventType();
-      e->dump(fout, eventTypeBucketIdMap[eventType]) ;
+      dumpEvent(e, eventTypeBucketIdMap[eventType]) ;
     }
   }
 
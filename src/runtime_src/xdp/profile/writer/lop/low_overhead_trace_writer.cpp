@@ -128,7 +128,7 @@ namespace xdp {
       {
         bucket = enqueueBucket ;
       }
-      e->dump(fout, bucket) ;
+      dumpEvent(e.get(), bucket) ;
     }
   }
 
@@ -140,24 +140,33 @@ namespace xdp {
 
   // ************** Binary output functions ******************
 
+  // In binary trace files, the sections are the same as in human
+  //  readable files.  The text sections are stored as is and events
+  //  are stored as binary records by dumpEvent.
+
   void LowOverheadTraceWriter::writeBinaryHeader()
   {
+    writeHumanReadableHeader() ;
   }
 
   void LowOverheadTraceWriter::writeBinaryStructure()
   {
+    writeHumanReadableStructure() ;
   }
 
   void LowOverheadTraceWriter::writeBinaryStringTable()
   {
+    writeHumanReadableStringTable() ;
   }
 
   void LowOverheadTraceWriter::writeBinaryTraceEvents()
   {
+    writeHumanReadableTraceEvents() ;
   }
 
   void LowOverheadTraceWriter::writeBinaryDependencies()
   {
+    writeHumanReadableDependencies() ;
   }
 
   // ************** Virtual output functions ******************
@@ -216,15 +225,15 @@ namespace xdp {
     //setupCommandQueueBuckets() ;
 
     writeHeader() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeStructure() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeStringTable() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeTraceEvents() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeDependencies() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
 
     if (openNewFile) switchFiles() ;
     return true;
@@ -58,6 +58,18 @@ namespace xdp {
     (db->getDynamicInfo()).dumpStringTable(fout) ;
   }
 
+  void NativeTraceWriter::dumpSyncEvent(NativeAPICall* call, uint32_t bucket)
+  {
+    if (humanReadable) {
+      call->dumpSync(fout, bucket) ;
+      if (!needsRecords())
+        return ;
+    }
+    VTFBinaryRecord record ;
+    call->dumpSyncBinary(record, bucket) ;
+    writeRecord(record) ;
+  }
+
   void NativeTraceWriter::writeTraceEvents()
   {
     std::vector<VTFEvent*> APIEvents =
@@ -76,15 +88,15 @@ namespace xdp {
 
     fout << "EVENTS" << "\n" ;
     for (auto& e : APIEvents) {
-      e->dump(fout, APIBucket) ;
+      dumpEvent(e, APIBucket) ;
       // If this is also a read/write, then dump the event in the other bucket
       NativeAPICall* call = dynamic_cast<NativeAPICall*>(e) ;
       if (call != nullptr) {
         if (call->isRead()) {
-          call->dumpSync(fout, readBucket) ;
+          dumpSyncEvent(call, readBucket) ;
         }
         if (call->isWrite()) {
-          call->dumpSync(fout, writeBucket) ;
+          dumpSyncEvent(call, writeBucket) ;
         }
       }
     }
@@ -21,6 +21,9 @@
 
 namespace xdp {
 
+  // Forward declarations
+  class NativeAPICall ;
+
   class NativeTraceWriter : public VPTraceWriter
   {
   private:
@@ -30,6 +33,8 @@ namespace xdp {
     const uint32_t readBucket = 2 ;
     const uint32_t writeBucket = 3 ;
 
+    void dumpSyncEvent(NativeAPICall* call, uint32_t bucket) ;
+
   protected:
     virtual void writeHeader() ;
     virtual void writeStructure() ;
@@ -57,6 +57,8 @@ namespace xdp {
 
     XclbinInfo* currentXclbin = db->getStaticInfo().getCurrentlyLoadedXclbin(mDeviceIndex);
     auto numNOC = (db->getStaticInfo()).getNumNOC(mDeviceIndex, currentXclbin);
+    std::vector<std::string> cellNames;
+    cellNames.reserve(numNOC);
     for (uint64_t n=0; n < numNOC; n++) {
       auto noc = (db->getStaticInfo()).getNOC(mDeviceIndex, currentXclbin, n);
 
@@ -70,6 +72,7 @@ namespace xdp {
       std::string cellName   = (result.size() > 1) ? result[1] : "";
       uint64_t readQos       = (result.size() > 2) ? std::stoull(result[2]) : 0;
       uint64_t writeQos      = (result.size() > 3) ? std::stoull(result[3]) : 0;
+      cellNames.push_back(cellName.empty() ? "N/A" : cellName);
 
       fout << cellName          << ","
            << masterName        << ","
@@ -96,25 +99,19 @@ namespace xdp {
          << std::endl;
 
     // Write all data elements
-    std::vector<VPDynamicDatabase::CounterSample> samples =
-      (db->getDynamicInfo()).getNOCSamples(mDeviceIndex);
-    VPDynamicDatabase::CounterNames names =
-      (db->getDynamicInfo()).getNOCNames(mDeviceIndex);
-
-    for (auto sample : samples) {
-      fout << sample.first << ","; // Timestamp
+    NOCSampleLog* log = (db->getDynamicInfo()).getNOCSampleLog(mDeviceIndex);
+    log->forEach([this, &cellNames](const NOCSampleLog::Sample& sample) {
+      fout << sample.timestamp << ",";
 
       // Report NMU cell name for this sample
-      auto iter = names.find(sample.first);
-      std::string cellName = (iter == names.end()) ? "N/A" : iter->second;
-      fout << cellName << ",";
+      fout << ((sample.nmu < cellNames.size()) ? cellNames[sample.nmu] : "N/A") << ",";
 
-      // Report all samples at this timestamp for this NMU cell
-      for (auto value : sample.second) {
+      // Report all counters of this NMU cell at this timestamp
+      for (auto value : sample.values)
         fout << value << ",";
-      }
-      fout << std::endl;
-    }
+      fout << "\n";
+    });
+    fout.flush();
     return true;
   }
 
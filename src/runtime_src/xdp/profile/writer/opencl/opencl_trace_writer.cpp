@@ -152,7 +152,7 @@ namespace xdp {
 	else
 	  bucket = generalAPIBucket; // Should never happen
       }
-      e->dump(fout, bucket) ;
+      dumpEvent(e.get(), bucket) ;
     }
   }
 
@@ -217,24 +217,33 @@ namespace xdp {
 
   // ************** Binary output functions ******************
 
+  // In binary trace files, the sections are the same as in human
+  //  readable files.  The text sections are stored as is and events
+  //  are stored as binary records by dumpEvent.
+
   void OpenCLTraceWriter::writeBinaryHeader()
   {
+    writeHumanReadableHeader() ;
   }
 
   void OpenCLTraceWriter::writeBinaryStructure()
   {
+    writeHumanReadableStructure() ;
   }
 
   void OpenCLTraceWriter::writeBinaryStringTable()
   {
+    writeHumanReadableStringTable() ;
   }
 
   void OpenCLTraceWriter::writeBinaryTraceEvents()
   {
+    writeHumanReadableTraceEvents() ;
   }
 
   void OpenCLTraceWriter::writeBinaryDependencies()
   {
+    writeHumanReadableDependencies() ;
   }
 
   // ************** Virtual output functions ******************
@@ -292,15 +301,15 @@ namespace xdp {
     //setupCommandQueueBuckets() ;
 
     writeHeader() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeStructure() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeStringTable() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeTraceEvents() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
     writeDependencies() ;
-    if (humanReadable) fout << std::endl ;
+    fout << std::endl ;
 
     if (openNewFile) switchFiles() ;
 
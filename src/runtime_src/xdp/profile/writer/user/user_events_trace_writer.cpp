@@ -60,6 +60,7 @@ namespace xdp {
   void UserEventsTraceWriter::writeTraceEvents()
   {
     fout << "EVENTS" << std::endl ;
+    auto hold = (db->getDynamicInfo()).holdEvents() ;
     std::vector<VTFEvent*> userEvents = 
       (db->getDynamicInfo()).filterEvents( [](VTFEvent* e)
 					   {
@@ -68,7 +69,7 @@ namespace xdp {
 					 ) ;
     for (auto e : userEvents)
     {
-      e->dump(fout, bucketId) ;
+      dumpEvent(e, bucketId) ;
     }
   }
 
@@ -32,7 +32,7 @@
 // An anonymous namespace for all of the different guidance rules
 namespace {
 
-  static void deviceExecTime(xdp::VPDatabase* db, std::ofstream& fout)
+  static void deviceExecTime(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_counters)) return ;
 
@@ -57,7 +57,7 @@ namespace {
     }
   }
 
-  static void cuCalls(xdp::VPDatabase* db, std::ofstream& fout)
+  static void cuCalls(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (xdp::getFlowMode() == xdp::SW_EMU) {
       std::map<std::tuple<std::string, std::string, std::string>,
@@ -94,7 +94,7 @@ namespace {
     }
   }
 
-  static void numMonitors(xdp::VPDatabase* db, std::ofstream& fout)
+  static void numMonitors(xdp::VPDatabase* db, std::ostream& fout)
   {
     struct MonInfo {
       std::string type ;
@@ -151,7 +151,7 @@ namespace {
     }
   }
 
-  static void migrateMem(xdp::VPDatabase* db, std::ofstream& fout)
+  static void migrateMem(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -160,7 +160,7 @@ namespace {
     fout << "MIGRATE_MEM,host," << numCalls << ",\n" ;
   }
 
-  static void memoryUsage(xdp::VPDatabase* db, std::ofstream& fout)
+  static void memoryUsage(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (xdp::getFlowMode() == xdp::SW_EMU) {
       std::map<std::string, bool> memUsage =
@@ -187,7 +187,7 @@ namespace {
     }
   }
 
-  static void PLRAMDevice(xdp::VPDatabase* db, std::ofstream& fout)
+  static void PLRAMDevice(xdp::VPDatabase* db, std::ostream& fout)
   {
     bool hasPLRAM = false ;
 
@@ -213,7 +213,7 @@ namespace {
     fout << "PLRAM_DEVICE,all," << hasPLRAM << ",\n" ;
   }
 
-  static void HBMDevice(xdp::VPDatabase* db, std::ofstream& fout)
+  static void HBMDevice(xdp::VPDatabase* db, std::ostream& fout)
   {
     bool hasHBM = false ;
 
@@ -246,7 +246,7 @@ namespace {
     fout << "HBM_DEVICE,all," << hasHBM << ",\n" ;
   }
 
-  static void KDMADevice(xdp::VPDatabase* db, std::ofstream& fout)
+  static void KDMADevice(xdp::VPDatabase* db, std::ostream& fout)
   {
     bool hasKDMA = false ;
 
@@ -276,7 +276,7 @@ namespace {
     fout << "KDMA_DEVICE,all," << hasKDMA << ",\n" ;
   }
 
-  static void P2PDevice(xdp::VPDatabase* db, std::ofstream& fout)
+  static void P2PDevice(xdp::VPDatabase* db, std::ostream& fout)
   {
     bool hasP2P = false ;
 
@@ -307,7 +307,7 @@ namespace {
     fout << "P2P_DEVICE,all," << hasP2P << ",\n" ;
   }
 
-  static void P2PHostTransfers(xdp::VPDatabase* db, std::ofstream& fout)
+  static void P2PHostTransfers(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -315,7 +315,7 @@ namespace {
     fout << "P2P_HOST_TRANSFERS,host," << hostP2PTransfers << ",\n" ;
   }
 
-  static void portBitWidth(xdp::VPDatabase* db, std::ofstream& fout)
+  static void portBitWidth(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (xdp::getFlowMode() == xdp::SW_EMU) {
       std::vector<std::string> portBitWidths =
@@ -351,7 +351,7 @@ namespace {
     }
   }
 
-  void kernelCount(xdp::VPDatabase* db, std::ofstream& fout)
+  void kernelCount(xdp::VPDatabase* db, std::ostream& fout)
   {
     std::map<std::string, uint64_t> kernelCounts ;
 
@@ -380,7 +380,7 @@ namespace {
     }
   }
 
-  static void objectsReleased(xdp::VPDatabase* db, std::ofstream& fout)
+  static void objectsReleased(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -389,7 +389,7 @@ namespace {
     fout << "OBJECTS_RELEASED,all," << numReleased << ",\n" ;
   }
 
-  static void CUContextEn(xdp::VPDatabase* db, std::ofstream& fout)
+  static void CUContextEn(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -398,7 +398,7 @@ namespace {
     fout << "CU_CONTEXT_EN,all," << (uint64_t)(isContextEnabled) << ",\n" ;
   }
 
-  static void traceMemory(xdp::VPDatabase* db, std::ofstream& fout)
+  static void traceMemory(xdp::VPDatabase* db, std::ostream& fout)
   {
     std::string memType = "FIFO" ;
 
@@ -422,7 +422,7 @@ namespace {
   }
 
   static void maxParallelKernelEnqueues(xdp::VPDatabase* db,
-                                        std::ofstream& fout)
+                                        std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -434,7 +434,7 @@ namespace {
     }
   }
 
-  static void commandQueueOOO(xdp::VPDatabase* db, std::ofstream& fout)
+  static void commandQueueOOO(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -445,7 +445,7 @@ namespace {
     }
   }
 
-  static void PLRAMSizeBytes(xdp::VPDatabase* db, std::ofstream& fout)
+  static void PLRAMSizeBytes(xdp::VPDatabase* db, std::ostream& fout)
   {
     auto deviceInfos = db->getStaticInfo().getDeviceInfos() ;
     bool done = false ;
@@ -469,7 +469,7 @@ namespace {
     }
   }
 
-  static void kernelBufferInfo(xdp::VPDatabase* db, std::ofstream& fout)
+  static void kernelBufferInfo(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -483,7 +483,7 @@ namespace {
     }
   }
 
-  static void traceBufferFull(xdp::VPDatabase* db, std::ofstream& fout)
+  static void traceBufferFull(xdp::VPDatabase* db, std::ostream& fout)
   {
     auto deviceInfos = db->getStaticInfo().getDeviceInfos() ;
     for (auto device : deviceInfos) {
@@ -495,7 +495,7 @@ namespace {
     }
   }
 
-  static void memoryTypeBitWidth(xdp::VPDatabase* db, std::ofstream& fout)
+  static void memoryTypeBitWidth(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (xdp::getFlowMode() == xdp::SW_EMU) {
       std::string deviceName =
@@ -529,7 +529,7 @@ namespace {
     }
   }
 
-  static void bufferRdActiveTimeMs(xdp::VPDatabase* db, std::ofstream& fout)
+  static void bufferRdActiveTimeMs(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -538,7 +538,7 @@ namespace {
          << ",\n" ;
   }
 
-  static void bufferWrActiveTimeMs(xdp::VPDatabase* db, std::ofstream& fout)
+  static void bufferWrActiveTimeMs(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -547,7 +547,7 @@ namespace {
          << ",\n" ;
   }
 
-  static void bufferTxActiveTimeMs(xdp::VPDatabase* db, std::ofstream& fout)
+  static void bufferTxActiveTimeMs(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -556,7 +556,7 @@ namespace {
          << ",\n" ;
   }
 
-  static void applicationRunTimeMs(xdp::VPDatabase* db, std::ofstream& fout)
+  static void applicationRunTimeMs(xdp::VPDatabase* db, std::ostream& fout)
   {
     uint64_t startTime = db->getStaticInfo().getApplicationStartTime() ;
     uint64_t endTime = xrt_core::time_ns() ; 
@@ -566,7 +566,7 @@ namespace {
          << ",\n" ;
   }
 
-  static void totalKernelRunTimeMs(xdp::VPDatabase* db, std::ofstream& fout)
+  static void totalKernelRunTimeMs(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::opencl_trace)) return ;
 
@@ -577,7 +577,7 @@ namespace {
          << lastKernelEndTime - firstKernelStartTime << ",\n" ;
   }
 
-  static void aieCounterResources(xdp::VPDatabase* db, std::ofstream& fout)
+  static void aieCounterResources(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::aie_profile)) return ;
 
@@ -602,7 +602,7 @@ namespace {
     }
   }
 
-  static void aieTraceEvents(xdp::VPDatabase* db, std::ofstream& fout)
+  static void aieTraceEvents(xdp::VPDatabase* db, std::ostream& fout)
   {
     if (!db->infoAvailable(xdp::info::aie_trace)) return ;
 
@@ -672,7 +672,7 @@ namespace xdp {
   {
   }
 
-  void GuidanceRules::write(VPDatabase* db, std::ofstream& fout)
+  void GuidanceRules::write(VPDatabase* db, std::ostream& fout)
   {
     // Dump the header
     fout << "Guidance Parameters\n" ;
@@ -19,7 +19,7 @@
 
 #include <vector>
 #include <functional>
-#include <fstream>
+#include <ostream>
 
 #include "xdp/profile/database/database.h"
 #include "xdp/profile/writer/vp_base/ini_parameters.h"
@@ -29,14 +29,14 @@ namespace xdp {
   class GuidanceRules
   {
   private:
-    std::vector<std::function<void (VPDatabase*, std::ofstream&)>> rules ;
+    std::vector<std::function<void (VPDatabase*, std::ostream&)>> rules ;
 
     IniParameters iniParameters ;
   public:
     GuidanceRules() ;
     ~GuidanceRules() ;
 
-    void write(VPDatabase* db, std::ofstream& fout) ;
+    void write(VPDatabase* db, std::ostream& fout) ;
   } ;
 
 } // end namespace xdp
@@ -63,8 +63,12 @@ namespace xdp {
     addParameter("trace_buffer_offload_interval_ms",
                  xrt_core::config::get_trace_buffer_offload_interval_ms(),
                  "Interval for reading of device data to host (in ms)");
+    addParameter("hal_transfer_stats", xrt_core::config::get_hal_transfer_stats(),
+                 "Histograms of HAL buffer transfers by size, without trace");
     addParameter("lop_trace", xrt_core::config::get_lop_trace(),
                  "Generation of lower overhead OpenCL trace. Should not be used with other OpenCL options.");
+    addParameter("lop_trace_binary", xrt_core::config::get_lop_trace_binary(),
+                 "Record lower overhead OpenCL trace in binary per thread buffers for offline conversion");
     addParameter("debug_mode", xrt_core::config::get_launch_waveform(),
                  "Debug mode (emulation only)");
     addParameter("aie_trace", xrt_core::config::get_aie_trace(),
@@ -99,7 +103,7 @@ namespace xdp {
   {
   }
 
-  void IniParameters::write(std::ofstream& fout)
+  void IniParameters::write(std::ostream& fout)
   {
     for (auto& setting : settings) {
       fout << setting << "\n" ;
@@ -40,7 +40,7 @@ namespace xdp {
       settings.push_back(setting.str()) ;
     }
 
-    void write(std::ofstream& fout);
+    void write(std::ostream& fout);
   } ;
 
 } // end namespace xdp
@@ -0,0 +1,439 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "xdp/profile/writer/vp_base/lop_binary_trace.h"
+#include "xdp/profile/plugin/vp_base/utility.h"
+
+namespace {
+
+  struct ChunkHeader
+  {
+    uint64_t count ;
+    uint64_t threadId ;
+    uint64_t reserved[2] ;
+  } ;
+  static_assert(sizeof(ChunkHeader) == sizeof(xdp::LOPBinaryRecord),
+                "chunk header must fill one record") ;
+  static_assert(sizeof(xdp::LOPBinaryRecord) == 32,
+                "binary trace records are 32 bytes") ;
+
+  constexpr size_t creationTimeSize = 64 ;
+
+  // The chunk a thread is currently writing to.  Names are remembered
+  //  by address, so each name is stored once per thread.
+  struct ThreadChunk
+  {
+    const xdp::LOPBinaryTrace* owner = nullptr ;
+    char* base = nullptr ;
+    size_t used = 0 ;
+    std::unordered_map<const char*, uint32_t> names ;
+
+    void release()
+    {
+#ifndef _WIN32
+      if (base)
+        ::munmap(base, xdp::LOPBinaryTrace::chunkSize) ;
+#endif
+      base = nullptr ;
+      used = 0 ;
+    }
+
+    ~ThreadChunk() { release() ; }
+  } ;
+
+  thread_local ThreadChunk threadChunk ;
+
+  uint64_t threadIdValue()
+  {
+    auto tid = std::this_thread::get_id() ;
+    uint64_t value = 0 ;
+    std::memcpy(&value, &tid, std::min(sizeof(value), sizeof(tid))) ;
+    return value ;
+  }
+
+  size_t recordsForName(size_t length)
+  {
+    return (length + sizeof(xdp::LOPBinaryRecord) - 1)
+           / sizeof(xdp::LOPBinaryRecord) ;
+  }
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  const char LOPBinaryTrace::magic[8] =
+    { 'X', 'D', 'P', 'L', 'O', 'P', 'B', '\0' } ;
+
+  LOPBinaryTrace::LOPBinaryTrace(const std::string& file) :
+    filename(file), fd(-1), numChunks(0), nextNameId(1)
+  {
+#ifndef _WIN32
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) ;
+    if (fd < 0)
+      return ;
+
+    std::vector<char> header(headerSize, 0) ;
+    char* p = header.data() ;
+    uint32_t size = static_cast<uint32_t>(chunkSize) ;
+    uint64_t pid = static_cast<uint64_t>(::getpid()) ;
+    std::string creationTime = getCurrentDateTime() ;
+    std::memcpy(p, magic, sizeof(magic)) ;            p += sizeof(magic) ;
+    std::memcpy(p, &version, sizeof(version)) ;       p += sizeof(version) ;
+    std::memcpy(p, &size, sizeof(size)) ;             p += sizeof(size) ;
+    std::memcpy(p, &pid, sizeof(pid)) ;               p += sizeof(pid) ;
+    std::memcpy(p, creationTime.c_str(),
+                std::min(creationTime.size(), creationTimeSize - 1)) ;
+
+    if (::pwrite(fd, header.data(), header.size(), 0) !=
+        static_cast<ssize_t>(header.size())) {
+      ::close(fd) ;
+      fd = -1 ;
+    }
+#endif
+  }
+
+  LOPBinaryTrace::~LOPBinaryTrace()
+  {
+    // Chunks still mapped by other threads remain valid after the file
+    //  is closed and are released when those threads exit
+    std::lock_guard<std::mutex> lock(chunkLock) ;
+#ifndef _WIN32
+    if (fd >= 0)
+      ::close(fd) ;
+#endif
+    fd = -1 ;
+  }
+
+  // Grow the file by one chunk and map it for the calling thread
+  bool LOPBinaryTrace::mapChunk()
+  {
+#ifndef _WIN32
+    auto& tc = threadChunk ;
+    tc.release() ;
+
+    std::lock_guard<std::mutex> lock(chunkLock) ;
+    if (fd < 0)
+      return false ;
+
+    off_t offset = static_cast<off_t>(headerSize + numChunks * chunkSize) ;
+    if (::ftruncate(fd, offset + static_cast<off_t>(chunkSize)))
+      return false ;
+
+    void* addr = ::mmap(nullptr, chunkSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, offset) ;
+    if (addr == MAP_FAILED)
+      return false ;
+    ++numChunks ;
+
+    tc.base = static_cast<char*>(addr) ;
+    reinterpret_cast<ChunkHeader*>(tc.base)->threadId = threadIdValue() ;
+    return true ;
+#else
+    return false ;
+#endif
+  }
+
+  LOPBinaryRecord* LOPBinaryTrace::reserve(size_t count)
+  {
+    auto& tc = threadChunk ;
+    if (!tc.base || tc.used + count > recordsPerChunk) {
+      if (!mapChunk())
+        return nullptr ;
+    }
+    return reinterpret_cast<LOPBinaryRecord*>(tc.base) + 1 + tc.used ;
+  }
+
+  void LOPBinaryTrace::commit(size_t count)
+  {
+    auto& tc = threadChunk ;
+    tc.used += count ;
+    // The count is stored after the records, so a reader of the file
+    //  never sees a count covering records not yet written
+    std::atomic_signal_fence(std::memory_order_release) ;
+    reinterpret_cast<volatile ChunkHeader*>(tc.base)->count = tc.used ;
+  }
+
+  uint32_t LOPBinaryTrace::nameId(const char* name)
+  {
+    auto& tc = threadChunk ;
+    auto itr = tc.names.find(name) ;
+    if (itr != tc.names.end())
+      return itr->second ;
+
+    size_t length = std::min(std::strlen(name), maxNameLength) ;
+    size_t count = 1 + recordsForName(length) ;
+    LOPBinaryRecord* r = reserve(count) ;
+    if (!r)
+      return 0 ;
+
+    uint32_t id = nextNameId.fetch_add(1, std::memory_order_relaxed) ;
+    std::memset(r, 0, count * sizeof(LOPBinaryRecord)) ;
+    r->type = STRING ;
+    r->name = id ;
+    r->id = length ;
+    std::memcpy(r + 1, name, length) ;
+    commit(count) ;
+
+    tc.names[name] = id ;
+    return id ;
+  }
+
+  void LOPBinaryTrace::log(VTFEventType type, bool isStart, double timestamp,
+                           uint64_t id, uint64_t queue, const char* name)
+  {
+    auto& tc = threadChunk ;
+    if (tc.owner != this) {
+      tc.release() ;
+      tc.names.clear() ;
+      tc.owner = this ;
+    }
+
+    uint32_t name_id = name ? nameId(name) : 0 ;
+    LOPBinaryRecord* r = reserve(1) ;
+    if (!r)
+      return ;
+
+    r->timestamp = static_cast<uint64_t>(timestamp) ;
+    r->id = id ;
+    r->queue = queue ;
+    r->name = name_id ;
+    r->type = static_cast<uint16_t>(type) ;
+    r->flags = isStart ? START : 0 ;
+    commit(1) ;
+  }
+
+  namespace {
+
+    struct DecodedEvent
+    {
+      LOPBinaryRecord record ;
+      uint64_t threadId ;
+    } ;
+
+    // Read all chunks of the file.  Name ids are remapped so a name
+    //  stored by several threads has one entry in the string table.
+    bool readLOPBinaryTrace(std::ifstream& fin, size_t size,
+                            std::vector<DecodedEvent>& events,
+                            std::map<uint32_t, std::string>& strings)
+    {
+      std::vector<char> chunk(size) ;
+      std::map<std::string, uint32_t> stringIds ;
+      std::map<uint32_t, uint32_t> remap ;
+
+      while (fin.read(chunk.data(), size)) {
+        ChunkHeader header ;
+        std::memcpy(&header, chunk.data(), sizeof(header)) ;
+        size_t maxRecords = size / sizeof(LOPBinaryRecord) - 1 ;
+        if (header.count > maxRecords)
+          return false ;
+
+        auto records = reinterpret_cast<const LOPBinaryRecord*>(chunk.data()) + 1 ;
+        for (size_t i = 0 ; i < header.count ; ++i) {
+          LOPBinaryRecord r ;
+          std::memcpy(&r, records + i, sizeof(r)) ;
+          if (r.type != LOPBinaryTrace::STRING) {
+            auto itr = remap.find(r.name) ;
+            r.name = (itr != remap.end()) ? itr->second : 0 ;
+            events.push_back({r, header.threadId}) ;
+            continue ;
+          }
+
+          size_t length = std::min<uint64_t>(r.id, LOPBinaryTrace::maxNameLength) ;
+          size_t n = recordsForName(length) ;
+          if (i + n >= header.count)
+            return false ;
+          std::string name(reinterpret_cast<const char*>(records + i + 1), length) ;
+          auto ins = stringIds.emplace(name, static_cast<uint32_t>(stringIds.size() + 1)) ;
+          if (ins.second)
+            strings[ins.first->second] = name ;
+          remap[r.name] = ins.first->second ;
+          i += n ;
+        }
+      }
+      return true ;
+    }
+
+    void dumpTimestamp(std::ofstream& fout, uint64_t timestamp)
+    {
+      std::ios_base::fmtflags flags = fout.flags() ;
+      fout << std::fixed << std::setprecision(6) << (timestamp/1.0e6) ;
+      fout.flags(flags) ;
+    }
+
+  } // end anonymous namespace
+
+  bool convertLOPBinaryTrace(const std::string& binaryFile,
+                             const std::string& textFile)
+  {
+    std::ifstream fin(binaryFile, std::ios::binary) ;
+    if (!fin)
+      return false ;
+
+    std::vector<char> header(LOPBinaryTrace::headerSize) ;
+    if (!fin.read(header.data(), header.size()))
+      return false ;
+
+    const char* p = header.data() ;
+    uint32_t fileVersion = 0 ;
+    uint32_t size = 0 ;
+    uint64_t pid = 0 ;
+    if (std::memcmp(p, LOPBinaryTrace::magic, sizeof(LOPBinaryTrace::magic)))
+      return false ;
+    p += sizeof(LOPBinaryTrace::magic) ;
+    std::memcpy(&fileVersion, p, sizeof(fileVersion)) ;  p += sizeof(fileVersion) ;
+    std::memcpy(&size, p, sizeof(size)) ;                p += sizeof(size) ;
+    std::memcpy(&pid, p, sizeof(pid)) ;                  p += sizeof(pid) ;
+    std::string creationTime(p, strnlen(p, creationTimeSize)) ;
+    if (fileVersion != LOPBinaryTrace::version ||
+        size < 2 * sizeof(LOPBinaryRecord) || size % sizeof(LOPBinaryRecord))
+      return false ;
+
+    std::vector<DecodedEvent> events ;
+    std::map<uint32_t, std::string> strings ;
+    if (!readLOPBinaryTrace(fin, size, events, strings))
+      return false ;
+
+    // Chunks of different threads interleave in time
+    std::stable_sort(events.begin(), events.end(),
+                     [](const DecodedEvent& a, const DecodedEvent& b)
+                     { return a.record.timestamp < b.record.timestamp ; }) ;
+
+    // Same rows as the LowOverheadTraceWriter
+    std::set<uint64_t> queues ;
+    for (auto& e : events)
+      if (e.record.type == OPENCL_API_CALL && e.record.queue != 0)
+        queues.insert(e.record.queue) ;
+
+    int rowID = 1 ;
+    int generalAPIBucket = rowID++ ;
+    std::map<uint64_t, int> commandQueueToBucket ;
+    for (auto q : queues)
+      commandQueueToBucket[q] = rowID++ ;
+    int readBucket = rowID++ ;
+    int writeBucket = rowID++ ;
+    int enqueueBucket = rowID ;
+
+    std::ofstream fout(textFile) ;
+    if (!fout)
+      return false ;
+
+    fout << "HEADER" << std::endl
+         << "VTF File Version,1.1" << std::endl
+         << "VTF File Type,0" << std::endl
+         << "PID," << pid << std::endl
+         << "Generated on," << creationTime << std::endl
+         << "Resolution,ms" << std::endl
+         << "Min Resolution,ns" << std::endl
+         << "Trace Version,1.1" << std::endl
+         << "TraceID," << pid << std::endl
+         << "XRT Version," << getToolVersion() << std::endl
+         << std::endl ;
+
+    fout << "STRUCTURE" << std::endl
+         << "Group_Start,Low Overhead OpenCL Host Trace" << std::endl
+         << "Group_Start,OpenCL API Calls" << std::endl
+         << "Dynamic_Row," << generalAPIBucket
+         << ",General,API Events not associated with a Queue" << std::endl ;
+    for (auto q : queues)
+      fout << "Static_Row," << commandQueueToBucket[q] << ",Queue 0x"
+           << std::hex << q << ",API events associated with the command queue"
+           << std::dec << std::endl ;
+    fout << "Group_End,OpenCL API Calls" << std::endl
+         << "Group_Start,Data Transfer" << std::endl
+         << "Dynamic_Row," << readBucket
+         << ",Read,Read data transfers from global memory to host" << std::endl
+         << "Dynamic_Row," << writeBucket
+         << ",Write,Write data transfer from host to global memory" << std::endl
+         << "Group_End,Data Transfer" << std::endl
+         << "Dynamic_Row_Summary," << enqueueBucket
+         << ",Kernel Enqueues,Activity in kernel enqueues" << std::endl
+         << "Group_End,Low Overhead OpenCL Host Trace" << std::endl
+         << std::endl ;
+
+    fout << "MAPPING" << std::endl ;
+    for (auto& s : strings)
+      fout << s.first << "," << s.second << std::endl ;
+    fout << std::endl ;
+
+    // Event ids are assigned in time order, and ends are matched with
+    //  starts as the plugin would have through the dynamic database
+    fout << "EVENTS" << std::endl ;
+    std::map<std::pair<bool, uint64_t>, uint64_t> starts ;
+    uint64_t eventId = 1 ;
+    for (auto& e : events) {
+      auto& r = e.record ;
+      auto type = static_cast<VTFEventType>(r.type) ;
+      auto key = std::make_pair(type == OPENCL_API_CALL, r.id) ;
+      uint64_t startId = 0 ;
+      if (r.flags & LOPBinaryTrace::START)
+        starts[key] = eventId ;
+      else {
+        auto itr = starts.find(key) ;
+        if (itr != starts.end()) {
+          startId = itr->second ;
+          starts.erase(itr) ;
+        }
+      }
+
+      int bucket = 0 ;
+      if (type == OPENCL_API_CALL) {
+        auto itr = commandQueueToBucket.find(r.queue) ;
+        bucket = (itr != commandQueueToBucket.end()) ? itr->second : generalAPIBucket ;
+      }
+      else if (type == LOP_READ_BUFFER)
+        bucket = readBucket ;
+      else if (type == LOP_WRITE_BUFFER)
+        bucket = writeBucket ;
+      else if (type == LOP_KERNEL_ENQUEUE)
+        bucket = enqueueBucket ;
+
+      const char* typeName = VTFEvent::getTypeName(type) ;
+      fout << eventId << "," << startId << "," ;
+      dumpTimestamp(fout, r.timestamp) ;
+      fout << "," << bucket << "," << (typeName ? typeName : "UNKNOWN") ;
+      if (type == OPENCL_API_CALL)
+        fout << "," << r.name ;
+      else if (type == LOP_READ_BUFFER || type == LOP_WRITE_BUFFER)
+        fout << "," << std::hex << "0x" << e.threadId << std::dec ;
+      fout << std::endl ;
+      ++eventId ;
+    }
+    fout << std::endl ;
+
+    fout << "DEPENDENCIES" << std::endl << std::endl ;
+    return true ;
+  }
+
+} // end namespace xdp
@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef LOP_BINARY_TRACE_DOT_H
+#define LOP_BINARY_TRACE_DOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "xdp/profile/database/events/vtf_event.h"
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // Low overhead profiling can record its events straight into a
+  //  binary file instead of the dynamic database.  Every thread writes
+  //  fixed size records into its own chunk of a memory mapped file, so
+  //  logging an event is a handful of stores with no locks, no
+  //  allocation, and no string lookups.  Because the chunks are shared
+  //  file mappings, the records written so far survive a crash of the
+  //  application.  convertLOPBinaryTrace turns the file into the same
+  //  trace format written by the LowOverheadTraceWriter.
+  //
+  // The file starts with a header of headerSize bytes:
+  //
+  //   char     magic[8]
+  //   uint32_t version
+  //   uint32_t chunkSize
+  //   uint64_t pid
+  //   char     creationTime[64]
+  //
+  //  followed by chunks of chunkSize bytes.  A chunk starts with a 32
+  //  byte chunk header holding the number of records written to the
+  //  chunk and the id of the thread that owns it, followed by records.
+  //  Names of API calls are stored once per thread as a STRING record
+  //  whose id is the length of the name, followed by the characters of
+  //  the name padded to whole records.
+  struct LOPBinaryRecord
+  {
+    uint64_t timestamp ; // ns
+    uint64_t id ;        // Function ID of API calls, XRT event ID otherwise
+    uint64_t queue ;     // Command queue address of API calls
+    uint32_t name ;      // String ID of the API call name
+    uint16_t type ;      // VTFEventType or STRING
+    uint16_t flags ;
+  } ;
+
+  class LOPBinaryTrace
+  {
+  public:
+    static constexpr uint16_t STRING = 0xffff ;
+    static constexpr uint16_t START = 0x1 ;
+
+    static constexpr uint32_t version = 1 ;
+    static const char magic[8] ;
+
+    // Chunks are mapped at multiples of headerSize, which must be a
+    //  multiple of the page size
+    static constexpr size_t headerSize = 64 * 1024 ;
+    static constexpr size_t chunkSize = 1024 * 1024 ;
+    static constexpr size_t recordsPerChunk =
+      chunkSize / sizeof(LOPBinaryRecord) - 1 ;
+    static constexpr size_t maxNameLength = 255 ;
+
+  private:
+    std::string filename ;
+    int fd ;
+
+    // Chunks handed out so far, and the lock for growing the file
+    std::mutex chunkLock ;
+    uint64_t numChunks ;
+
+    std::atomic<uint32_t> nextNameId ;
+
+    LOPBinaryRecord* reserve(size_t count) ;
+    void commit(size_t count) ;
+    bool mapChunk() ;
+    uint32_t nameId(const char* name) ;
+
+  public:
+    XDP_EXPORT explicit LOPBinaryTrace(const std::string& file) ;
+    XDP_EXPORT ~LOPBinaryTrace() ;
+
+    LOPBinaryTrace(const LOPBinaryTrace&) = delete ;
+    LOPBinaryTrace& operator=(const LOPBinaryTrace&) = delete ;
+
+    bool isOpen() const { return fd >= 0 ; }
+    const std::string& getFileName() const { return filename ; }
+
+    // Record an event.  API calls pass the function name, which must
+    //  point to storage that outlives the trace (a string literal).
+    XDP_EXPORT void log(VTFEventType type, bool isStart, double timestamp,
+                        uint64_t id, uint64_t queue = 0,
+                        const char* name = nullptr) ;
+  } ;
+
+  // Convert a low overhead binary trace file to the human readable
+  //  low overhead trace format.  Return false if the binary trace file
+  //  cannot be read.
+  XDP_EXPORT bool convertLOPBinaryTrace(const std::string& binaryFile,
+                                        const std::string& textFile) ;
+
+} // end namespace xdp
+
+#endif
@@ -0,0 +1,321 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "xdp/profile/database/static_info/device_info.h"
+#include "xdp/profile/database/static_info/pl_constructs.h"
+#include "xdp/profile/database/static_info/xclbin_info.h"
+#include "xdp/profile/writer/vp_base/performance_advisor.h"
+
+// An anonymous namespace for all of the advisor rules
+namespace {
+
+  using Finding = xdp::PerformanceAdvisor::Finding ;
+
+  // Transfers smaller than this pay more for the fixed cost of a DMA
+  //  than for moving the data
+  constexpr uint64_t smallTransferBytes = 64 * 1024 ;
+  constexpr uint64_t minSmallTransfers  = 16 ;
+
+  // A compute unit idle for more than this fraction of the time the
+  //  device was active is not kept busy by the host
+  constexpr double maxIdleFraction = 0.2 ;
+
+  // Compute units of one kernel are unbalanced when the busiest one is
+  //  busy this many times longer than the least busy one
+  constexpr double maxImbalance = 2.0 ;
+
+  // A memory bank delivering this fraction of the maximum bandwidth to
+  //  the ports attached to it is saturated
+  constexpr double saturatedFraction = 0.9 ;
+
+  constexpr double nsPerMs = 1.0e6 ;
+
+  double cyclesToMs(uint64_t cycles, double clockMHz)
+  {
+    return (clockMHz == 0) ? 0 :
+      static_cast<double>(cycles) / (clockMHz * 1000.0) ;
+  }
+
+  // Many small host transfers: if they were batched into transfers of
+  //  smallTransferBytes, each transfer saved would save at least the
+  //  shortest transfer time seen
+  void smallTransfers(xdp::VPDatabase* db, std::vector<Finding>& findings)
+  {
+    auto check = [&findings](const std::pair<uint64_t, uint64_t>& key,
+                             const xdp::BufferStatistics& stats,
+                             const char* type) {
+      if (stats.count < minSmallTransfers ||
+          stats.averageSize >= smallTransferBytes)
+        return ;
+
+      uint64_t batched =
+        (stats.totalSize + smallTransferBytes - 1) / smallTransferBytes ;
+      if (batched >= stats.count)
+        return ;
+
+      std::stringstream element ;
+      element << "Context " << key.first << "|Device " << key.second ;
+      std::stringstream details ;
+      details << type << " transfers average "
+              << (stats.averageSize / 1024.0) << " KB. "
+              << "Batch them into transfers of at least "
+              << (smallTransferBytes / 1024) << " KB" ;
+
+      findings.push_back({ "SMALL_DMA_TRANSFERS", element.str(),
+                           static_cast<double>((stats.count - batched) * stats.minTime) / nsPerMs,
+                           stats.count, details.str() }) ;
+    } ;
+
+    for (auto& read : db->getStats().getHostReads())
+      check(read.first, read.second, "READ") ;
+    for (auto& write : db->getStats().getHostWrites())
+      check(write.first, write.second, "WRITE") ;
+  }
+
+  // Buffer writes done while no kernel was running, right before a
+  //  kernel starts.  They could have overlapped the previous kernel, so
+  //  the time lost is the part of them that fits in that kernel.  The
+  //  statistics database finds these as the host events arrive.
+  void serialSyncStart(xdp::VPDatabase* db, std::vector<Finding>& findings)
+  {
+    for (auto& s : db->getStats().getSerialWrites()) {
+      std::stringstream details ;
+      details << "Buffers were written with no kernel running and the "
+              << "kernel started after them, first at "
+              << (s.second.firstTime / nsPerMs) << " ms. "
+              << "Write the next inputs while the previous run executes" ;
+      std::string name = s.first.empty() ? "unknown" : s.first ;
+      findings.push_back({ "SERIAL_SYNC_THEN_START", name,
+                           s.second.timeLost / nsPerMs, s.second.count,
+                           details.str() }) ;
+    }
+  }
+
+  // Compute units idle for much of the time the device was active
+  void cuIdleGaps(xdp::VPDatabase* db, std::vector<Finding>& findings)
+  {
+    for (auto device : db->getStaticInfo().getDeviceInfos()) {
+      std::string deviceName = device->getUniqueDeviceName() ;
+      double activeMs =
+        static_cast<double>(db->getStats().getDeviceActiveTime(deviceName)) / nsPerMs ;
+      if (activeMs <= 0)
+        continue ;
+
+      for (auto xclbin : device->loadedXclbins) {
+        xclCounterResults values =
+          db->getDynamicInfo().getCounterResults(device->deviceId, xclbin->uuid) ;
+        for (auto& cu : xclbin->pl.cus) {
+          auto slot = static_cast<uint64_t>(cu.second->getAccelMon()) ;
+          if (slot >= XAM_MAX_NUMBER_SLOTS || values.CuExecCount[slot] < 2)
+            continue ;
+
+          double busyMs =
+            cyclesToMs(values.CuBusyCycles[slot], xclbin->pl.clockRatePLMHz) ;
+          double idleMs = activeMs - busyMs ;
+          if (busyMs <= 0 || idleMs <= maxIdleFraction * activeMs)
+            continue ;
+
+          std::stringstream details ;
+          details << "Busy " << (100.0 * busyMs / activeMs) << "% of the "
+                  << activeMs << " ms the device was active. "
+                  << "Keep more executions enqueued so the next run starts "
+                  << "as soon as the previous one ends" ;
+          findings.push_back({ "CU_IDLE_GAPS",
+                               deviceName + "|" + cu.second->getName(),
+                               idleMs, values.CuExecCount[slot],
+                               details.str() }) ;
+        }
+      }
+    }
+  }
+
+  // Kernels with several compute units where the work is not spread
+  //  evenly.  If it were, the busiest unit would finish at the average.
+  void unbalancedCUs(xdp::VPDatabase* db, std::vector<Finding>& findings)
+  {
+    for (auto device : db->getStaticInfo().getDeviceInfos()) {
+      for (auto xclbin : device->loadedXclbins) {
+        xclCounterResults values =
+          db->getDynamicInfo().getCounterResults(device->deviceId, xclbin->uuid) ;
+
+        // Busy time and executions of the compute units of each kernel
+        std::map<std::string, std::vector<std::pair<double, uint64_t>>> kernels ;
+        for (auto& cu : xclbin->pl.cus) {
+          auto slot = static_cast<uint64_t>(cu.second->getAccelMon()) ;
+          if (slot >= XAM_MAX_NUMBER_SLOTS)
+            continue ;
+          double busyMs =
+            cyclesToMs(values.CuBusyCycles[slot], xclbin->pl.clockRatePLMHz) ;
+          kernels[cu.second->getKernelName()].push_back(
+            std::make_pair(busyMs, values.CuExecCount[slot])) ;
+        }
+
+        for (auto& kernel : kernels) {
+          auto& cus = kernel.second ;
+          if (cus.size() < 2)
+            continue ;
+
+          auto minmax = std::minmax_element(cus.begin(), cus.end()) ;
+          double total = 0 ;
+          for (auto& cu : cus)
+            total += cu.first ;
+          double average = total / static_cast<double>(cus.size()) ;
+          double maxBusy = minmax.second->first ;
+          double minBusy = minmax.first->first ;
+          if (maxBusy <= 0 || maxBusy < maxImbalance * minBusy)
+            continue ;
+
+          uint64_t executions = 0 ;
+          for (auto& cu : cus)
+            executions += cu.second ;
+
+          std::stringstream details ;
+          details << "The busiest of " << cus.size() << " compute units ran "
+                  << minmax.second->second << " times for " << maxBusy
+                  << " ms, the least busy " << minmax.first->second
+                  << " times for " << minBusy << " ms. "
+                  << "Enqueue work so all compute units are used" ;
+          findings.push_back({ "UNBALANCED_CU_UTILIZATION",
+                               device->getUniqueDeviceName() + "|" + kernel.first,
+                               maxBusy - average, executions, details.str() }) ;
+        }
+      }
+    }
+  }
+
+  // Kernel ports on host memory that together get close to the maximum
+  //  bandwidth.  The time lost is how much longer the ports were busy
+  //  than the same bytes need at the maximum bandwidth.
+  void hostBankSaturation(xdp::VPDatabase* db, std::vector<Finding>& findings)
+  {
+    for (auto device : db->getStaticInfo().getDeviceInfos()) {
+      for (auto xclbin : device->loadedXclbins) {
+        xclCounterResults values =
+          db->getDynamicInfo().getCounterResults(device->deviceId, xclbin->uuid) ;
+
+        struct Traffic
+        {
+          uint64_t ports = 0 ;
+          uint64_t bytes = 0 ;
+          double busyMs = 0 ;
+          double maxBusyMs = 0 ;
+        } ;
+        Traffic reads, writes ;
+
+        // Counter results are in the order the monitors were found
+        uint64_t monitorId = 0 ;
+        for (auto monitor : xclbin->pl.aims) {
+          uint64_t id = monitorId++ ;
+          if (monitor->cuIndex == -1 || id >= XAIM_MAX_NUMBER_SLOTS)
+            continue ;
+          auto memory = xclbin->pl.memoryInfo.find(monitor->memIndex) ;
+          if (memory == xclbin->pl.memoryInfo.end() ||
+              memory->second->name.find("HOST") == std::string::npos)
+            continue ;
+
+          double readMs =
+            cyclesToMs(values.ReadBusyCycles[id], xclbin->pl.clockRatePLMHz) ;
+          double writeMs =
+            cyclesToMs(values.WriteBusyCycles[id], xclbin->pl.clockRatePLMHz) ;
+          if (values.ReadBytes[id] > 0) {
+            ++reads.ports ;
+            reads.bytes += values.ReadBytes[id] ;
+            reads.busyMs += readMs ;
+            reads.maxBusyMs = std::max(reads.maxBusyMs, readMs) ;
+          }
+          if (values.WriteBytes[id] > 0) {
+            ++writes.ports ;
+            writes.bytes += values.WriteBytes[id] ;
+            writes.busyMs += writeMs ;
+            writes.maxBusyMs = std::max(writes.maxBusyMs, writeMs) ;
+          }
+        }
+
+        auto check = [&](const Traffic& t, double maxBW, const char* type) {
+          if (t.ports == 0 || t.maxBusyMs <= 0 || maxBW <= 0)
+            return ;
+          // MB/s while the busiest port was transferring
+          double rate = static_cast<double>(t.bytes) / (1000.0 * t.maxBusyMs) ;
+          if (rate < saturatedFraction * maxBW)
+            return ;
+          double neededMs = static_cast<double>(t.bytes) / (1000.0 * maxBW) ;
+
+          std::stringstream details ;
+          details << t.ports << " kernel ports " << type << " host memory at "
+                  << rate << " MB/s of a maximum of " << maxBW << " MB/s. "
+                  << "Move buffers that are used often to device memory" ;
+          findings.push_back({ "HOST_MEMORY_BANDWIDTH_SATURATION",
+                               device->getUniqueDeviceName() + "|HOST",
+                               std::max(0.0, t.busyMs - neededMs), t.ports,
+                               details.str() }) ;
+        } ;
+        check(reads,  xclbin->pl.maxReadBW,  "read from") ;
+        check(writes, xclbin->pl.maxWriteBW, "write to") ;
+      }
+    }
+  }
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  PerformanceAdvisor::PerformanceAdvisor()
+  {
+    rules.push_back(smallTransfers) ;
+    rules.push_back(serialSyncStart) ;
+    rules.push_back(cuIdleGaps) ;
+    rules.push_back(unbalancedCUs) ;
+    rules.push_back(hostBankSaturation) ;
+  }
+
+  PerformanceAdvisor::~PerformanceAdvisor()
+  {
+  }
+
+  void PerformanceAdvisor::write(VPDatabase* db, std::ostream& fout)
+  {
+    std::vector<Finding> findings ;
+    for (auto& rule : rules)
+      rule(db, findings) ;
+
+    if (findings.empty())
+      return ;
+
+    std::stable_sort(findings.begin(), findings.end(),
+                     [](const Finding& l, const Finding& r) {
+                       return l.timeLost > r.timeLost ;
+                     }) ;
+
+    // Caption
+    fout << "Performance Advisor\n" ;
+
+    // Column headers
+    fout << "Rule,Element,Estimated Time Lost (ms),Occurrences,Details,\n" ;
+
+    for (auto& f : findings) {
+      fout << f.rule << "," << f.element << "," << f.timeLost << ","
+           << f.occurrences << "," << f.details << ",\n" ;
+    }
+    fout << "\n" ;
+  }
+
+} // end namespace xdp
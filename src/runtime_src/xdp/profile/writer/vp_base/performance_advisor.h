@@ -0,0 +1,58 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PERFORMANCE_ADVISOR_DOT_H
+#define PERFORMANCE_ADVISOR_DOT_H
+
+#include <cstdint>
+#include <ostream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "xdp/profile/database/database.h"
+
+namespace xdp {
+
+  // The guidance rules only report raw values.  The advisor looks at
+  //  the same databases for known performance problems and reports each
+  //  one found with an estimate of the time it cost and where it
+  //  happened, ordered by the time lost.
+  class PerformanceAdvisor
+  {
+  public:
+    struct Finding
+    {
+      std::string rule ;
+      std::string element ;   // Where the problem was seen
+      double timeLost ;       // Estimated, in ms
+      uint64_t occurrences ;
+      std::string details ;
+    } ;
+
+  private:
+    std::vector<std::function<void (VPDatabase*, std::vector<Finding>&)>> rules ;
+
+  public:
+    PerformanceAdvisor() ;
+    ~PerformanceAdvisor() ;
+
+    void write(VPDatabase* db, std::ostream& fout) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
@@ -16,6 +16,8 @@
 
 #define XDP_SOURCE
 
+#include <future>
+
 #include "xdp/profile/database/static_info/device_info.h"
 #include "xdp/profile/database/static_info/pl_constructs.h"
 #include "xdp/profile/database/static_info/xclbin_info.h"
@@ -33,13 +35,13 @@
 namespace xdp {
 
   SummaryWriter::SummaryWriter(const char* filename) 
-    : VPSummaryWriter(filename), guidance()
+    : VPSummaryWriter(filename), guidance(), advisor()
   {
     initializeAPIs() ;
   }
 
   SummaryWriter::SummaryWriter(const char* filename, VPDatabase* inst) :
-    VPSummaryWriter(filename, inst), guidance()
+    VPSummaryWriter(filename, inst), guidance(), advisor()
   {
     initializeAPIs() ;
   }
@@ -287,7 +289,7 @@ namespace xdp {
     HALAPIs.emplace("xclRegRead") ;
   }
 
-  void SummaryWriter::writeHeader()
+  void SummaryWriter::writeHeader(std::ostream& fout)
   {
     std::string currentTime = "0000-00-00 0000" ;
 
@@ -367,23 +369,12 @@ namespace xdp {
   }
 
   void
-  SummaryWriter::writeAPICalls(APIType type)
+  SummaryWriter::writeAPICalls(std::ostream& fout, APIType type)
   {
-    // For each function call, across all of the threads, 
-    //  consolidate all the information into what we need
-    std::map<std::string,
-	     std::tuple<uint64_t,
-			double,
-			double,
-			double> > rows ;
-
-    std::map<std::pair<std::string, std::thread::id>,
-	     std::vector<std::pair<double, double>>> callCount =
-      (db->getStats()).getCallCount() ;
-    
-    for (auto call : callCount) {
-      auto callAndThread = call.first ;
-      auto APIName = callAndThread.first ;
+    // The statistics database consolidates every call, across all of
+    //  the threads, as it ends
+    for (auto& row : (db->getStats()).getCallStats()) {
+      auto& APIName = row.first ;
 
       switch (type) {
       case OPENCL:
@@ -400,51 +391,27 @@ namespace xdp {
         break ;
       }
 
-      std::vector<std::pair<double, double>> timesOfCalls = call.second ;
-
-      if (rows.find(APIName) == rows.end()) {
-	std::tuple<uint64_t, double, double, double> blank = 
-	  std::make_tuple<uint64_t, double, double, double>(0,0,std::numeric_limits<double>::max(),0) ;
-
-	rows[APIName] = blank ;
-      }
-
-      for (auto executionTime : timesOfCalls) {
-	auto timeTaken = executionTime.second - executionTime.first ;
-
-	++(std::get<0>(rows[APIName])) ;
-	std::get<1>(rows[APIName]) += timeTaken ;
-	if (timeTaken < std::get<2>(rows[APIName]))
-	  std::get<2>(rows[APIName]) = timeTaken ;
-	if (timeTaken > std::get<3>(rows[APIName]))
-	  std::get<3>(rows[APIName]) = timeTaken ;
-      }
-    }
-
-    for (auto row : rows) {
-      auto averageTime = 
-	(double)(std::get<1>(row.second)) / (double)(std::get<0>(row.second)) ;
       if (type != OPENCL) fout << "ENTRY:" ;
-      fout << row.first                      << ","     // API Name
-	   << std::get<0>(row.second)        << ","     // Number of calls
-	   << (std::get<1>(row.second)/one_million) << ","     // Total time
-	   << (std::get<2>(row.second)/one_million) << ","     // Minimum time
-	   << (averageTime/one_million)             << ","     // Average time
-	   << (std::get<3>(row.second)/one_million) << ",\n" ; // Maximum time
+      fout << APIName                                  << ","     // API Name
+	   << row.second.numExecutions                 << ","     // Number of calls
+	   << (row.second.totalTime/one_million)       << ","     // Total time
+	   << (row.second.minTime/one_million)         << ","     // Minimum time
+	   << (row.second.averageTime/one_million)     << ","     // Average time
+	   << (row.second.maxTime/one_million)         << ",\n" ; // Maximum time
     }
   }
 
-  void SummaryWriter::writeOpenCLAPICalls()
+  void SummaryWriter::writeOpenCLAPICalls(std::ostream& fout)
   {
     // Title
     fout << "OpenCL API Calls\n" ;
     // Columns
     fout << "API Name,Number Of Calls,Total Time (ms),Minimum Time (ms),"
 	 << "Average Time (ms),Maximum Time (ms),\n" ;
-    writeAPICalls(OPENCL) ;
+    writeAPICalls(fout, OPENCL) ;
   }
 
-  void SummaryWriter::writeNativeAPICalls()
+  void SummaryWriter::writeNativeAPICalls(std::ostream& fout)
   {
     fout << "TITLE:Native API Calls\n" ;
     fout << "SECTION:API Calls,Native API Calls\n" ;
@@ -459,10 +426,10 @@ namespace xdp {
          << "Average execution time (in ms),\n";
     fout << "COLUMN:<html>Maximum<br>Time (ms)</html>,float,"
          << "Maximum execution time (in ms),\n";
-    writeAPICalls(NATIVE) ;
+    writeAPICalls(fout, NATIVE) ;
   }
 
-  void SummaryWriter::writeHALAPICalls()
+  void SummaryWriter::writeHALAPICalls(std::ostream& fout)
   {
     fout << "TITLE:HAL API Calls\n" ;
     fout << "SECTION:API Calls,HAL API Calls\n" ;
@@ -477,10 +444,10 @@ namespace xdp {
          << "Average execution time (in ms),\n";
     fout << "COLUMN:<html>Maximum<br>Time (ms)</html>,float,"
          << "Maximum execution time (in ms),\n";
-    writeAPICalls(HAL) ;
+    writeAPICalls(fout, HAL) ;
   }
 
-  void SummaryWriter::writeHALTransfers()
+  void SummaryWriter::writeHALTransfers(std::ostream& fout)
   {
     fout << "HAL data transfers\n" ;
     fout << "Device ID,"
@@ -511,7 +478,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeKernelExecutionSummary()
+  void SummaryWriter::writeKernelExecutionSummary(std::ostream& fout)
   {
     // On Edge hardware emuation, the numbers for the top kernel executions
     //  don't align with the other numbers we display, so don't print this
@@ -534,19 +501,120 @@ namespace xdp {
 
     // Column headers
     fout << "Kernel,Number Of Enqueues,Total Time (ms),Minimum Time (ms),"
-	 << "Average Time (ms),Maximum Time (ms),\n" ; 
+	 << "Average Time (ms),Maximum Time (ms),"
+	 << "P50 Time (ms),P90 Time (ms),P99 Time (ms),P99.9 Time (ms),\n" ;
 
+    auto& histograms = (db->getStats()).getKernelHistograms() ;
     for (auto execution : kernelExecutions) {
       fout << execution.first                         << ","
 	   << (execution.second).numExecutions        << ","
 	   << ((execution.second).totalTime / one_million)   << ","
 	   << ((execution.second).minTime / one_million)     << ","
 	   << ((execution.second).averageTime / one_million) << ","
-	   << ((execution.second).maxTime / one_million)     << ",\n" ;
+	   << ((execution.second).maxTime / one_million)     << "," ;
+      auto histogram = histograms.find(execution.first) ;
+      if (histogram != histograms.end())
+        writePercentiles(fout, *(histogram->second)) ;
+      else
+        fout << "N/A,N/A,N/A,N/A," ;
+      fout << "\n" ;
+    }
+  }
+
+  void SummaryWriter::writePercentiles(std::ostream& fout,
+                                       const LatencyHistogram& histogram)
+  {
+    for (auto q : { 0.5, 0.9, 0.99, 0.999 })
+      fout << (static_cast<double>(histogram.percentile(q)) / one_million)
+           << "," ;
+  }
+
+  void SummaryWriter::writeComputeUnitPercentiles(std::ostream& fout)
+  {
+    auto& histograms = (db->getStats()).getComputeUnitHistograms() ;
+    if (histograms.size() == 0)
+      return ;
+
+    // Caption
+    fout << "Compute Unit Execution Percentiles\n" ;
+
+    // Column headers
+    fout << "Compute Unit,Number Of Calls,"
+	 << "P50 Time (ms),P90 Time (ms),P99 Time (ms),P99.9 Time (ms),\n" ;
+
+    for (auto& histogram : histograms) {
+      fout << histogram.first << "," << (histogram.second)->count() << "," ;
+      writePercentiles(fout, *(histogram.second)) ;
+      fout << "\n" ;
     }
   }
 
-  void SummaryWriter::writeTopKernelExecution()
+  void SummaryWriter::writeHostTransferPercentiles(std::ostream& fout)
+  {
+    auto& reads  = (db->getStats()).getHostReadHistograms() ;
+    auto& writes = (db->getStats()).getHostWriteHistograms() ;
+    if (reads.size() == 0 && writes.size() == 0)
+      return ;
+
+    // Caption
+    fout << "Host Transfer Percentiles\n" ;
+
+    // Column headers.  Transfers are grouped by the power of two their
+    //  size does not exceed.
+    fout << "Transfer Type,Maximum Buffer Size (KB),Number Of Transfers,"
+	 << "P50 Time (ms),P90 Time (ms),P99 Time (ms),P99.9 Time (ms),\n" ;
+
+    for (auto& histogram : reads) {
+      fout << "READ," << (static_cast<double>(histogram.first) / one_thousand)
+           << "," << (histogram.second)->count() << "," ;
+      writePercentiles(fout, *(histogram.second)) ;
+      fout << "\n" ;
+    }
+    for (auto& histogram : writes) {
+      fout << "WRITE," << (static_cast<double>(histogram.first) / one_thousand)
+           << "," << (histogram.second)->count() << "," ;
+      writePercentiles(fout, *(histogram.second)) ;
+      fout << "\n" ;
+    }
+  }
+
+  void SummaryWriter::writeHALTransferHistograms(std::ostream& fout)
+  {
+    auto& transfers = (db->getStats()).getHALTransfers() ;
+    if (transfers.size() == 0)
+      return ;
+
+    // Caption
+    fout << "HAL Transfer Histograms\n" ;
+
+    // Column headers.  Transfers are grouped by device, direction, and
+    //  the power of two their size does not exceed.
+    fout << "Device ID,Transfer Type,Maximum Buffer Size (KB),"
+         << "Number Of Transfers,Total Data (MB),Total Time (ms),"
+         << "Average Bandwidth (MB/s),P50 Bandwidth (MB/s),"
+         << "P50 Time (ms),P90 Time (ms),P99 Time (ms),P99.9 Time (ms),\n" ;
+
+    const char* types[] = { "READ", "WRITE", "COPY" } ;
+    for (auto& transfer : transfers) {
+      const HALTransferStatistics& stats = *(transfer.second) ;
+      uint64_t bytes = stats.totalBytes.load(std::memory_order_relaxed) ;
+      uint64_t time  = stats.totalTime.load(std::memory_order_relaxed) ;
+      double bandwidth = (time == 0) ? 0 :
+        static_cast<double>(bytes) * one_thousand / time ;
+
+      fout << std::get<0>(transfer.first) << ","
+           << types[std::get<1>(transfer.first)] << ","
+           << (static_cast<double>(std::get<2>(transfer.first)) / one_thousand)
+           << "," << stats.durations.count() << ","
+           << (static_cast<double>(bytes) / one_million) << ","
+           << (static_cast<double>(time) / one_million) << ","
+           << bandwidth << "," << stats.bandwidth.percentile(0.5) << "," ;
+      writePercentiles(fout, stats.durations) ;
+      fout << "\n" ;
+    }
+  }
+
+  void SummaryWriter::writeTopKernelExecution(std::ostream& fout)
   {
     // On Edge hardware emuation, the numbers for the top kernel executions
     //  don't align with the other numbers we display, so don't print this
@@ -579,7 +647,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeTopMemoryWrites()
+  void SummaryWriter::writeTopMemoryWrites(std::ostream& fout)
   {
     if (db->getStats().getTopHostWrites().size() == 0)
       return ;
@@ -613,7 +681,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeTopMemoryReads()
+  void SummaryWriter::writeTopMemoryReads(std::ostream& fout)
   {
     if (db->getStats().getTopHostReads().size() == 0)
       return ;
@@ -647,7 +715,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeSoftwareEmulationComputeUnitUtilization()
+  void SummaryWriter::writeSoftwareEmulationComputeUnitUtilization(std::ostream& fout)
   {
     std::map<std::tuple<std::string, std::string, std::string>,
 	     TimeStatistics> cuStats = 
@@ -704,7 +772,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeComputeUnitUtilization()
+  void SummaryWriter::writeComputeUnitUtilization(std::ostream& fout)
   {
     std::vector<DeviceInfo*> infos = (db->getStaticInfo()).getDeviceInfos() ;
 
@@ -814,7 +882,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeComputeUnitStallInformation()
+  void SummaryWriter::writeComputeUnitStallInformation(std::ostream& fout)
   {
     if (!(db->getStaticInfo().hasStallInfo())) return ;
 
@@ -853,7 +921,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeDataTransferHostToGlobalMemory()
+  void SummaryWriter::writeDataTransferHostToGlobalMemory(std::ostream& fout)
   {
     std::map<std::pair<uint64_t, uint64_t>, BufferStatistics> hostReads =
       (db->getStats()).getHostReads() ;
@@ -953,7 +1021,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeHostReadsFromGlobalMemory()
+  void SummaryWriter::writeHostReadsFromGlobalMemory(std::ostream& fout)
   {
     std::map<std::pair<uint64_t, uint64_t>, BufferStatistics> hostReads =
       (db->getStats()).getHostReads() ;
@@ -1018,7 +1086,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeHostWritesToGlobalMemory()
+  void SummaryWriter::writeHostWritesToGlobalMemory(std::ostream& fout)
   {
     std::map<std::pair<uint64_t, uint64_t>, BufferStatistics> hostWrites =
       (db->getStats()).getHostWrites() ;
@@ -1082,7 +1150,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeStreamDataTransfers()
+  void SummaryWriter::writeStreamDataTransfers(std::ostream& fout)
   {
     std::vector<DeviceInfo*> infos = db->getStaticInfo().getDeviceInfos() ;
     
@@ -1193,7 +1261,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeDataTransferDMA()
+  void SummaryWriter::writeDataTransferDMA(std::ostream& fout)
   {
     // Only output this table and header if some device has 
     //  DMA monitors in the shell
@@ -1325,7 +1393,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeDataTransferDMABypass()
+  void SummaryWriter::writeDataTransferDMABypass(std::ostream& fout)
   {
     std::vector<DeviceInfo*> infos = (db->getStaticInfo()).getDeviceInfos() ;
 
@@ -1458,7 +1526,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeDataTransferMemory()
+  void SummaryWriter::writeDataTransferMemory(std::ostream& fout)
   {
     std::vector<DeviceInfo*> infos = db->getStaticInfo().getDeviceInfos() ;
     if (infos.size() == 0) return ;
@@ -1544,7 +1612,7 @@ namespace xdp {
 
   }
 
-  void SummaryWriter::writeDataTransferGlobalMemoryToGlobalMemory()
+  void SummaryWriter::writeDataTransferGlobalMemoryToGlobalMemory(std::ostream& fout)
   {
     std::vector<DeviceInfo*> infos = (db->getStaticInfo()).getDeviceInfos() ;
 
@@ -1666,7 +1734,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeDataTransferKernelsToGlobalMemory()
+  void SummaryWriter::writeDataTransferKernelsToGlobalMemory(std::ostream& fout)
   {
     // Only print out if information exists
     std::vector<DeviceInfo*> infos = (db->getStaticInfo()).getDeviceInfos() ;
@@ -1803,7 +1871,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeTopDataTransferKernelAndGlobal()
+  void SummaryWriter::writeTopDataTransferKernelAndGlobal(std::ostream& fout)
   {
     std::vector<DeviceInfo*> infos = (db->getStaticInfo()).getDeviceInfos() ;
     if (infos.size() == 0) return ;
@@ -1907,7 +1975,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeTopSyncReads()
+  void SummaryWriter::writeTopSyncReads(std::ostream& fout)
   {
     if (db->getStats().getTopHostReads().size() == 0)
       return ;
@@ -1939,7 +2007,7 @@ namespace xdp {
     }    
   }
 
-  void SummaryWriter::writeTopSyncWrites()
+  void SummaryWriter::writeTopSyncWrites(std::ostream& fout)
   {
     if (db->getStats().getTopHostWrites().size() == 0)
       return ;
@@ -1971,7 +2039,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeUserLevelEvents()
+  void SummaryWriter::writeUserLevelEvents(std::ostream& fout)
   {
     if (!db->getStats().eventInformationPresent()) return ;
 
@@ -1984,7 +2052,7 @@ namespace xdp {
     }
   }
 
-  void SummaryWriter::writeUserLevelRanges()
+  void SummaryWriter::writeUserLevelRanges(std::ostream& fout)
   {
     if (!db->getStats().rangeInformationPresent()) return ;
 
@@ -2019,58 +2087,88 @@ namespace xdp {
 
   bool SummaryWriter::write(bool /*openNewFile*/)
   {
+    // Every table is built from aggregates the databases keep up to
+    //  date as the events arrive, so the tables are independent of each
+    //  other.  Generate them in parallel and write them out in order.
+    std::vector<std::function<void (std::ostream&)>> sections ;
+    auto table = [this, &sections](void (SummaryWriter::*section)(std::ostream&)) {
+      sections.push_back([this, section](std::ostream& out) {
+        (this->*section)(out) ;
+        out << "\n" ;
+      }) ;
+    } ;
+
     // Every summary has to have a header
-    writeHeader() ;                                      fout << "\n" ;
+    table(&SummaryWriter::writeHeader) ;
 
     if (db->infoAvailable(info::opencl_counters)) {
-      writeOpenCLAPICalls() ;                            fout << "\n" ;
-      writeKernelExecutionSummary() ;                    fout << "\n" ;
-      writeTopKernelExecution() ;                        fout << "\n" ;
-      writeTopMemoryWrites() ;                           fout << "\n" ;
-      writeTopMemoryReads() ;                            fout << "\n" ;
+      table(&SummaryWriter::writeOpenCLAPICalls) ;
+      table(&SummaryWriter::writeKernelExecutionSummary) ;
+      table(&SummaryWriter::writeTopKernelExecution) ;
+      table(&SummaryWriter::writeTopMemoryWrites) ;
+      table(&SummaryWriter::writeTopMemoryReads) ;
       if (getFlowMode() == SW_EMU) {
-        writeSoftwareEmulationComputeUnitUtilization() ; fout << "\n" ;
+        table(&SummaryWriter::writeSoftwareEmulationComputeUnitUtilization) ;
       }
       else if (db->infoAvailable(info::device_offload)) {
         // OpenCL specific device tables
-        writeDataTransferHostToGlobalMemory() ;          fout << "\n" ;
+        table(&SummaryWriter::writeDataTransferHostToGlobalMemory) ;
       }
     }
 
     // Generic device tables
     if (db->infoAvailable(info::device_offload)) {
       if (getFlowMode() != SW_EMU) {
-        writeComputeUnitUtilization() ;                  fout << "\n" ;
+        table(&SummaryWriter::writeComputeUnitUtilization) ;
       }
-      writeDataTransferDMA() ;                           fout << "\n" ;
-      writeDataTransferDMABypass() ;                     fout << "\n" ;
-      writeDataTransferMemory() ;                        fout << "\n" ;
-      writeStreamDataTransfers() ;                       fout << "\n" ;
-      writeDataTransferKernelsToGlobalMemory() ;         fout << "\n" ;
-      writeTopDataTransferKernelAndGlobal() ;            fout << "\n" ;
-      writeDataTransferGlobalMemoryToGlobalMemory() ;    fout << "\n" ;
-      writeComputeUnitStallInformation() ;               fout << "\n" ;
+      table(&SummaryWriter::writeDataTransferDMA) ;
+      table(&SummaryWriter::writeDataTransferDMABypass) ;
+      table(&SummaryWriter::writeDataTransferMemory) ;
+      table(&SummaryWriter::writeStreamDataTransfers) ;
+      table(&SummaryWriter::writeDataTransferKernelsToGlobalMemory) ;
+      table(&SummaryWriter::writeTopDataTransferKernelAndGlobal) ;
+      table(&SummaryWriter::writeDataTransferGlobalMemoryToGlobalMemory) ;
+      table(&SummaryWriter::writeComputeUnitStallInformation) ;
     }
 
+    // Percentiles of everything timed on the host or from device trace
+    table(&SummaryWriter::writeComputeUnitPercentiles) ;
+    table(&SummaryWriter::writeHostTransferPercentiles) ;
+    table(&SummaryWriter::writeHALTransferHistograms) ;
+
     if (db->infoAvailable(info::user)) {
-      writeUserLevelEvents() ;                           fout << "\n" ;
-      writeUserLevelRanges() ;                           fout << "\n" ;
+      table(&SummaryWriter::writeUserLevelEvents) ;
+      table(&SummaryWriter::writeUserLevelRanges) ;
     }
 
     if (db->infoAvailable(info::native)) {
-      writeNativeAPICalls() ;                            fout << "\n" ;
-      writeHostReadsFromGlobalMemory() ;                 fout << "\n" ;
-      writeHostWritesToGlobalMemory() ;                  fout << "\n" ;
-      writeTopSyncReads() ;                              fout << "\n" ; 
-      writeTopSyncWrites() ;                             fout << "\n" ;
+      table(&SummaryWriter::writeNativeAPICalls) ;
+      table(&SummaryWriter::writeHostReadsFromGlobalMemory) ;
+      table(&SummaryWriter::writeHostWritesToGlobalMemory) ;
+      table(&SummaryWriter::writeTopSyncReads) ;
+      table(&SummaryWriter::writeTopSyncWrites) ;
     }
 
     if (db->infoAvailable(info::hal)) {
-      writeHALAPICalls() ;                               fout << "\n" ;
+      table(&SummaryWriter::writeHALAPICalls) ;
     }
 
     // Generate all the applicable guidance rules
-    guidance.write(db, fout) ;
+    sections.push_back([this](std::ostream& out) { guidance.write(db, out) ; }) ;
+
+    // Flag the performance problems found in the same data
+    sections.push_back([this](std::ostream& out) { advisor.write(db, out) ; }) ;
+
+    std::vector<std::stringstream> buffers(sections.size()) ;
+    std::vector<std::future<void>> results ;
+    for (size_t i = 0 ; i < sections.size() ; ++i)
+      results.push_back(std::async(std::launch::async, sections[i],
+                                   std::ref(buffers[i]))) ;
+
+    for (size_t i = 0 ; i < sections.size() ; ++i) {
+      results[i].get() ;
+      fout << buffers[i].str() ;
+    }
 
     fout.flush() ;
     return true ;
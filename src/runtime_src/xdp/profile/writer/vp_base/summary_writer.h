@@ -25,8 +25,10 @@
 #include <set>
 
 #include "xdp/config.h"
+#include "xdp/profile/database/latency_histogram.h"
 #include "xdp/profile/writer/vp_base/vp_summary_writer.h"
 #include "xdp/profile/writer/vp_base/guidance_rules.h"
+#include "xdp/profile/writer/vp_base/performance_advisor.h"
 
 namespace xdp {
 
@@ -35,6 +37,7 @@ namespace xdp {
   private:
     SummaryWriter() = delete ;
     GuidanceRules guidance ;
+    PerformanceAdvisor advisor ;
 
     std::set<std::string> OpenCLAPIs ;
     std::set<std::string> NativeAPIs ;
@@ -42,48 +45,55 @@ namespace xdp {
 
     void initializeAPIs() ;
 
-    void writeHeader() ;
+    void writeHeader(std::ostream& fout) ;
 
     // OpenCL host tables
-    void writeOpenCLAPICalls() ;
-    void writeKernelExecutionSummary() ;
-    void writeTopKernelExecution() ;
-    void writeTopMemoryWrites() ;
-    void writeTopMemoryReads() ;
+    void writeOpenCLAPICalls(std::ostream& fout) ;
+    void writeKernelExecutionSummary(std::ostream& fout) ;
+    void writeTopKernelExecution(std::ostream& fout) ;
+    void writeTopMemoryWrites(std::ostream& fout) ;
+    void writeTopMemoryReads(std::ostream& fout) ;
 
     // Generic host tables
     enum APIType { OPENCL, NATIVE, HAL, ALL } ;
-    void writeAPICalls(APIType type) ;
+    void writeAPICalls(std::ostream& fout, APIType type) ;
 
     // OpenCL specific device tables
-    void writeSoftwareEmulationComputeUnitUtilization() ;
-    void writeComputeUnitStallInformation() ;
-    void writeDataTransferHostToGlobalMemory() ;
+    void writeSoftwareEmulationComputeUnitUtilization(std::ostream& fout) ;
+    void writeComputeUnitStallInformation(std::ostream& fout) ;
+    void writeDataTransferHostToGlobalMemory(std::ostream& fout) ;
 
     // Generic device tables
-    void writeDataTransferDMA() ;
-    void writeDataTransferDMABypass() ;
-    void writeDataTransferMemory() ;
-    void writeStreamDataTransfers() ;
-    void writeDataTransferKernelsToGlobalMemory() ;
-    void writeTopDataTransferKernelAndGlobal() ;
-    void writeDataTransferGlobalMemoryToGlobalMemory() ;
-    void writeComputeUnitUtilization() ;
+    void writeDataTransferDMA(std::ostream& fout) ;
+    void writeDataTransferDMABypass(std::ostream& fout) ;
+    void writeDataTransferMemory(std::ostream& fout) ;
+    void writeStreamDataTransfers(std::ostream& fout) ;
+    void writeDataTransferKernelsToGlobalMemory(std::ostream& fout) ;
+    void writeTopDataTransferKernelAndGlobal(std::ostream& fout) ;
+    void writeDataTransferGlobalMemoryToGlobalMemory(std::ostream& fout) ;
+    void writeComputeUnitUtilization(std::ostream& fout) ;
 
     // User event tables
-    void writeUserLevelEvents() ;
-    void writeUserLevelRanges() ;
+    void writeUserLevelEvents(std::ostream& fout) ;
+    void writeUserLevelRanges(std::ostream& fout) ;
 
     // Native XRT tables
-    void writeNativeAPICalls() ;
-    void writeHostReadsFromGlobalMemory() ;
-    void writeHostWritesToGlobalMemory() ;
-    void writeTopSyncReads() ;
-    void writeTopSyncWrites() ;
+    void writeNativeAPICalls(std::ostream& fout) ;
+    void writeHostReadsFromGlobalMemory(std::ostream& fout) ;
+    void writeHostWritesToGlobalMemory(std::ostream& fout) ;
+    void writeTopSyncReads(std::ostream& fout) ;
+    void writeTopSyncWrites(std::ostream& fout) ;
+
+    // Percentile tables
+    void writePercentiles(std::ostream& fout,
+                          const LatencyHistogram& histogram) ;
+    void writeComputeUnitPercentiles(std::ostream& fout) ;
+    void writeHostTransferPercentiles(std::ostream& fout) ;
+    void writeHALTransferHistograms(std::ostream& fout) ;
 
     // HAL tables
-    void writeHALAPICalls() ;
-    void writeHALTransfers() ;
+    void writeHALAPICalls(std::ostream& fout) ;
+    void writeHALTransfers(std::ostream& fout) ;
 
     // Handy values used for conversion
     const double zero         = 0.0 ;
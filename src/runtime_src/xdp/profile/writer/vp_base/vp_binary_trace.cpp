@@ -0,0 +1,338 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <cstring>
+#include <iomanip>
+#include <limits>
+
+#include "xdp/profile/writer/vp_base/vp_binary_trace.h"
+
+namespace {
+
+  // Text and events are handed to the writer thread in blocks of
+  //  about this size
+  constexpr size_t blockSize = 1024 * 1024 ;
+
+  constexpr size_t blockHeaderSize = sizeof(uint8_t) + sizeof(uint32_t) ;
+
+  template <typename T>
+  void append(std::vector<char>& buf, T value)
+  {
+    const char* p = reinterpret_cast<const char*>(&value) ;
+    buf.insert(buf.end(), p, p + sizeof(T)) ;
+  }
+
+  template <typename T>
+  bool extract(const char*& p, const char* end, T& value)
+  {
+    if (static_cast<size_t>(end - p) < sizeof(T))
+      return false ;
+    std::memcpy(&value, p, sizeof(T)) ;
+    p += sizeof(T) ;
+    return true ;
+  }
+
+  void setBlockHeader(std::vector<char>& block, uint8_t tag)
+  {
+    uint32_t size = static_cast<uint32_t>(block.size() - blockHeaderSize) ;
+    block[0] = static_cast<char>(tag) ;
+    std::memcpy(block.data() + 1, &size, sizeof(size)) ;
+  }
+
+  bool fitsInt32(int64_t value)
+  {
+    return value >= std::numeric_limits<int32_t>::min() &&
+           value <= std::numeric_limits<int32_t>::max() ;
+  }
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  const char VPBinaryTraceStream::magic[8] =
+    { 'X', 'D', 'P', 'V', 'T', 'F', 'B', '\0' } ;
+
+  VPBinaryTraceStream::VPBinaryTraceStream(std::filebuf* f) :
+    file(f), lastTimestamp(0), lastId(0), busy(false), stop(false)
+  {
+    events.resize(blockHeaderSize) ;
+    writer = std::thread(&VPBinaryTraceStream::writeBlocks, this) ;
+  }
+
+  VPBinaryTraceStream::~VPBinaryTraceStream()
+  {
+    flush() ;
+    {
+      std::lock_guard<std::mutex> lock(blocksLock) ;
+      stop = true ;
+    }
+    blocksCond.notify_all() ;
+    writer.join() ;
+  }
+
+  // The writer thread takes formatting and file output off the critical
+  //  path of the thread that dumps the database
+  void VPBinaryTraceStream::writeBlocks()
+  {
+    std::unique_lock<std::mutex> lock(blocksLock) ;
+    while (true) {
+      blocksCond.wait(lock, [this] { return stop || !blocks.empty() ; }) ;
+      if (blocks.empty())
+        return ;
+
+      std::vector<char> block = std::move(blocks.front()) ;
+      blocks.pop_front() ;
+      busy = true ;
+      lock.unlock() ;
+      file->sputn(block.data(), static_cast<std::streamsize>(block.size())) ;
+      lock.lock() ;
+      busy = false ;
+      blocksCond.notify_all() ;
+    }
+  }
+
+  void VPBinaryTraceStream::queueBlock(std::vector<char>&& block)
+  {
+    {
+      std::lock_guard<std::mutex> lock(blocksLock) ;
+      blocks.push_back(std::move(block)) ;
+    }
+    blocksCond.notify_all() ;
+  }
+
+  void VPBinaryTraceStream::queueText()
+  {
+    if (text.empty())
+      return ;
+
+    std::vector<char> block(blockHeaderSize) ;
+    block.insert(block.end(), text.begin(), text.end()) ;
+    setBlockHeader(block, TEXT) ;
+    queueBlock(std::move(block)) ;
+    text.clear() ;
+  }
+
+  void VPBinaryTraceStream::queueEvents()
+  {
+    if (events.size() == blockHeaderSize)
+      return ;
+
+    setBlockHeader(events, EVENTS) ;
+    queueBlock(std::move(events)) ;
+    events.clear() ;
+    events.resize(blockHeaderSize) ;
+  }
+
+  VPBinaryTraceStream::int_type VPBinaryTraceStream::overflow(int_type c)
+  {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      return traits_type::not_eof(c) ;
+
+    // Keep text and events in the order they were written
+    queueEvents() ;
+    text.push_back(traits_type::to_char_type(c)) ;
+    if (text.size() >= blockSize)
+      queueText() ;
+    return c ;
+  }
+
+  std::streamsize VPBinaryTraceStream::xsputn(const char* s, std::streamsize n)
+  {
+    queueEvents() ;
+    text.append(s, static_cast<size_t>(n)) ;
+    if (text.size() >= blockSize)
+      queueText() ;
+    return n ;
+  }
+
+  void VPBinaryTraceStream::writeFileHeader()
+  {
+    flush() ;
+    lastTimestamp = 0 ;
+    lastId = 0 ;
+
+    std::vector<char> header(magic, magic + sizeof(magic)) ;
+    append(header, version) ;
+    queueBlock(std::move(header)) ;
+  }
+
+  void VPBinaryTraceStream::writeEvent(const VTFBinaryRecord& record)
+  {
+    queueText() ;
+
+    int64_t tsDelta = static_cast<int64_t>(record.timestamp - lastTimestamp) ;
+    int64_t idDelta = static_cast<int64_t>(record.id - lastId) ;
+    uint64_t startDelta = record.start_id ? record.id - record.start_id : 0 ;
+
+    uint8_t flags = 0 ;
+    if (!fitsInt32(tsDelta) || !fitsInt32(idDelta) ||
+        startDelta > std::numeric_limits<uint32_t>::max() ||
+        (record.start_id != 0 && startDelta == 0))
+      flags |= ABSOLUTE ;
+    for (unsigned int i = 0 ; i < record.numFields ; ++i)
+      if (record.fields[i] > std::numeric_limits<uint32_t>::max())
+        flags |= WIDE ;
+
+    append(events, static_cast<uint8_t>(record.type)) ;
+    append(events, record.numFields) ;
+    append(events, record.hexFields) ;
+    append(events, flags) ;
+    append(events, record.bucket) ;
+    if (flags & ABSOLUTE) {
+      append(events, static_cast<int32_t>(0)) ;
+      append(events, static_cast<int32_t>(0)) ;
+      append(events, static_cast<uint32_t>(0)) ;
+      append(events, record.timestamp) ;
+      append(events, record.id) ;
+      append(events, record.start_id) ;
+    }
+    else {
+      append(events, static_cast<int32_t>(tsDelta)) ;
+      append(events, static_cast<int32_t>(idDelta)) ;
+      append(events, static_cast<uint32_t>(startDelta)) ;
+    }
+    for (unsigned int i = 0 ; i < record.numFields ; ++i) {
+      if (flags & WIDE) append(events, record.fields[i]) ;
+      else              append(events, static_cast<uint32_t>(record.fields[i])) ;
+    }
+
+    lastTimestamp = record.timestamp ;
+    lastId = record.id ;
+
+    if (events.size() >= blockSize)
+      queueEvents() ;
+  }
+
+  void VPBinaryTraceStream::flush()
+  {
+    queueText() ;
+    queueEvents() ;
+
+    std::unique_lock<std::mutex> lock(blocksLock) ;
+    blocksCond.wait(lock, [this] { return blocks.empty() && !busy ; }) ;
+    file->pubsync() ;
+  }
+
+  // ************** Conversion to human readable format ******************
+
+  static bool convertEvents(const char* p, const char* end, std::ofstream& fout,
+                            uint64_t& lastTimestamp, uint64_t& lastId)
+  {
+    while (p != end) {
+      uint8_t type = 0, numFields = 0, hexFields = 0, flags = 0 ;
+      uint32_t bucket = 0, startDelta = 0 ;
+      int32_t tsDelta = 0, idDelta = 0 ;
+      if (!extract(p, end, type)      || !extract(p, end, numFields) ||
+          !extract(p, end, hexFields) || !extract(p, end, flags)     ||
+          !extract(p, end, bucket)    || !extract(p, end, tsDelta)   ||
+          !extract(p, end, idDelta)   || !extract(p, end, startDelta))
+        return false ;
+
+      uint64_t timestamp = 0, id = 0, start_id = 0 ;
+      if (flags & VPBinaryTraceStream::ABSOLUTE) {
+        if (!extract(p, end, timestamp) || !extract(p, end, id) ||
+            !extract(p, end, start_id))
+          return false ;
+      }
+      else {
+        timestamp = lastTimestamp + static_cast<int64_t>(tsDelta) ;
+        id = lastId + static_cast<int64_t>(idDelta) ;
+        start_id = startDelta ? id - startDelta : 0 ;
+      }
+      lastTimestamp = timestamp ;
+      lastId = id ;
+
+      const char* name =
+        VTFEvent::getTypeName(static_cast<VTFEventType>(type)) ;
+      fout << id << "," << start_id << ","
+           << std::fixed << std::setprecision(6)
+           << (static_cast<double>(timestamp) / 1.0e6)
+           << std::defaultfloat << "," << bucket << ","
+           << (name ? name : "UNKNOWN") ;
+
+      for (unsigned int i = 0 ; i < numFields ; ++i) {
+        uint64_t value = 0 ;
+        if (flags & VPBinaryTraceStream::WIDE) {
+          if (!extract(p, end, value))
+            return false ;
+        }
+        else {
+          uint32_t narrow = 0 ;
+          if (!extract(p, end, narrow))
+            return false ;
+          value = narrow ;
+        }
+        if (hexFields & (1 << i))
+          fout << ",0x" << std::hex << value << std::dec ;
+        else
+          fout << "," << value ;
+      }
+      fout << "\n" ;
+    }
+    return true ;
+  }
+
+  bool convertBinaryTrace(const std::string& binaryFile,
+                          const std::string& textFile)
+  {
+    std::ifstream fin(binaryFile, std::ios::binary) ;
+    if (!fin)
+      return false ;
+
+    char fileMagic[sizeof(VPBinaryTraceStream::magic)] = {} ;
+    uint32_t fileVersion = 0 ;
+    fin.read(fileMagic, sizeof(fileMagic)) ;
+    fin.read(reinterpret_cast<char*>(&fileVersion), sizeof(fileVersion)) ;
+    if (!fin ||
+        std::memcmp(fileMagic, VPBinaryTraceStream::magic, sizeof(fileMagic)) ||
+        fileVersion != VPBinaryTraceStream::version)
+      return false ;
+
+    std::ofstream fout(textFile) ;
+    if (!fout)
+      return false ;
+
+    uint64_t lastTimestamp = 0 ;
+    uint64_t lastId = 0 ;
+    std::vector<char> payload ;
+    while (true) {
+      uint8_t tag = 0 ;
+      uint32_t size = 0 ;
+      fin.read(reinterpret_cast<char*>(&tag), sizeof(tag)) ;
+      if (fin.eof())
+        break ;
+      fin.read(reinterpret_cast<char*>(&size), sizeof(size)) ;
+      payload.resize(size) ;
+      fin.read(payload.data(), size) ;
+      if (!fin)
+        return false ;
+
+      if (tag == VPBinaryTraceStream::TEXT)
+        fout.write(payload.data(), size) ;
+      else if (tag == VPBinaryTraceStream::EVENTS) {
+        if (!convertEvents(payload.data(), payload.data() + size, fout,
+                           lastTimestamp, lastId))
+          return false ;
+      }
+      else
+        return false ;
+    }
+    return true ;
+  }
+
+} // end namespace xdp
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_BINARY_TRACE_DOT_H
+#define VP_BINARY_TRACE_DOT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xdp/profile/database/events/vtf_event.h"
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // Binary trace files hold the same information as the human readable
+  //  trace files, but trace events are stored as fixed width records
+  //  rather than formatted text.
+  //
+  // A binary trace file starts with an 8 byte magic number and a 4 byte
+  //  format version, followed by blocks.  Each block is a 1 byte tag, a
+  //  4 byte payload size, and the payload.  All integers are in the byte
+  //  order of the host that wrote the file.
+  //
+  //   TEXT   - Text of the trace file, verbatim (header, structure,
+  //            string table, dependencies)
+  //   EVENTS - Event records
+  //
+  // An event record is a 20 byte header:
+  //
+  //   uint8_t  type
+  //   uint8_t  numFields
+  //   uint8_t  hexFields       (bit i set if field i is printed in hex)
+  //   uint8_t  flags
+  //   uint32_t bucket
+  //   int32_t  timestampDelta  (ns since the previous record)
+  //   int32_t  idDelta         (event id minus id of the previous record)
+  //   uint32_t startDelta      (event id minus start id, 0 for start events)
+  //
+  //  followed by the timestamp, id, and start id as 8 byte values if the
+  //  ABSOLUTE flag is set (the deltas are then not used), followed by the
+  //  fields as 4 byte values, or 8 byte values if the WIDE flag is set.
+  //  Timestamps and ids are delta encoded across all the records of a file.
+  class VPBinaryTraceStream : public std::streambuf
+  {
+  public:
+    enum BlockTag : uint8_t { TEXT = 1, EVENTS = 2 } ;
+    enum RecordFlags : uint8_t { ABSOLUTE = 0x1, WIDE = 0x2 } ;
+
+    static constexpr uint32_t version = 1 ;
+    static const char magic[8] ;
+
+  private:
+    // The file all blocks are written to by the writer thread
+    std::filebuf* file ;
+
+    // Text and event records not yet handed to the writer thread.
+    //  The first bytes of the events buffer are reserved for the block
+    //  header.
+    std::string text ;
+    std::vector<char> events ;
+    uint64_t lastTimestamp ;
+    uint64_t lastId ;
+
+    // Blocks waiting to be written by the writer thread
+    std::mutex blocksLock ;
+    std::condition_variable blocksCond ;
+    std::deque<std::vector<char>> blocks ;
+    bool busy ;
+    bool stop ;
+    std::thread writer ;
+
+    void writeBlocks() ;
+    void queueBlock(std::vector<char>&& block) ;
+    void queueText() ;
+    void queueEvents() ;
+
+  protected:
+    // Text written to the stream is stored in TEXT blocks
+    virtual int_type overflow(int_type c) ;
+    virtual std::streamsize xsputn(const char* s, std::streamsize n) ;
+
+  public:
+    XDP_EXPORT VPBinaryTraceStream(std::filebuf* f) ;
+    XDP_EXPORT ~VPBinaryTraceStream() ;
+
+    // Start a new binary trace file, the file must be empty
+    XDP_EXPORT void writeFileHeader() ;
+
+    XDP_EXPORT void writeEvent(const VTFBinaryRecord& record) ;
+
+    // Wait until everything written to the stream is in the file
+    XDP_EXPORT void flush() ;
+  } ;
+
+  // Convert a binary trace file to the human readable trace format.
+  //  Return false if the binary trace file cannot be read.
+  XDP_EXPORT bool convertBinaryTrace(const std::string& binaryFile,
+                                     const std::string& textFile) ;
+
+} // end namespace xdp
+
+#endif
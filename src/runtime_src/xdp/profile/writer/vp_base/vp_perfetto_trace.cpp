@@ -0,0 +1,386 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define XDP_SOURCE
+
+#include <cstring>
+#include <sstream>
+
+#include "xdp/profile/writer/vp_base/vp_perfetto_trace.h"
+#include "xdp/profile/database/database.h"
+#include "core/common/config_reader.h"
+
+namespace {
+
+  // Packets are written to the file once this much is buffered
+  constexpr size_t flushSize = 64 * 1024 ;
+
+  // Interned ids of event type names, above all string table ids
+  constexpr uint64_t typeNameBase = 1ULL << 48 ;
+
+  // Field numbers of the Perfetto protos used (protos/perfetto/trace)
+  namespace field {
+    constexpr uint32_t tracePacket = 1 ;          // Trace.packet
+
+    constexpr uint32_t timestamp = 8 ;            // TracePacket
+    constexpr uint32_t sequenceId = 10 ;
+    constexpr uint32_t trackEvent = 11 ;
+    constexpr uint32_t internedData = 12 ;
+    constexpr uint32_t sequenceFlags = 13 ;
+    constexpr uint32_t trackDescriptor = 60 ;
+
+    constexpr uint32_t eventType = 9 ;            // TrackEvent
+    constexpr uint32_t nameIid = 10 ;
+    constexpr uint32_t trackUuid = 11 ;
+    constexpr uint32_t doubleCounterValue = 44 ;
+
+    constexpr uint32_t eventNames = 2 ;           // InternedData
+    constexpr uint32_t iid = 1 ;                  // EventName
+    constexpr uint32_t name = 2 ;
+
+    constexpr uint32_t uuid = 1 ;                 // TrackDescriptor
+    constexpr uint32_t trackName = 2 ;
+    constexpr uint32_t parentUuid = 5 ;
+    constexpr uint32_t counter = 8 ;
+  }
+
+  // TrackEvent.Type
+  constexpr uint64_t sliceBegin = 1 ;
+  constexpr uint64_t sliceEnd = 2 ;
+  constexpr uint64_t instant = 3 ;
+  constexpr uint64_t counterValue = 4 ;
+
+  // TracePacket.SequenceFlags
+  constexpr uint64_t incrementalStateCleared = 1 ;
+  constexpr uint64_t needsIncrementalState = 2 ;
+
+  // All packets are written on one sequence
+  constexpr uint64_t sequence = 1 ;
+
+  void putVarint(std::string& out, uint64_t value)
+  {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7f) | 0x80)) ;
+      value >>= 7 ;
+    }
+    out.push_back(static_cast<char>(value)) ;
+  }
+
+  void putUint(std::string& out, uint32_t f, uint64_t value)
+  {
+    putVarint(out, (static_cast<uint64_t>(f) << 3) | 0) ;
+    putVarint(out, value) ;
+  }
+
+  void putDouble(std::string& out, uint32_t f, double value)
+  {
+    putVarint(out, (static_cast<uint64_t>(f) << 3) | 1) ;
+    uint64_t bits = 0 ;
+    std::memcpy(&bits, &value, sizeof(bits)) ;
+    for (int i = 0 ; i < 8 ; ++i)
+      out.push_back(static_cast<char>((bits >> (8 * i)) & 0xff)) ;
+  }
+
+  void putBytes(std::string& out, uint32_t f, const std::string& value)
+  {
+    putVarint(out, (static_cast<uint64_t>(f) << 3) | 2) ;
+    putVarint(out, value.size()) ;
+    out.append(value) ;
+  }
+
+  // Events with a name in the string table as their first field
+  bool hasNameField(uint16_t type)
+  {
+    switch (type) {
+    case xdp::USER_MARKER:
+    case xdp::USER_RANGE:
+    case xdp::KERNEL_ENQUEUE:
+    case xdp::OPENCL_API_CALL:
+    case xdp::API_CALL:
+    case xdp::HAL_API_CALL:
+    case xdp::NATIVE_API_CALL:
+    case xdp::KERNEL:
+      return true ;
+    default:
+      return false ;
+    }
+  }
+
+} // end anonymous namespace
+
+namespace xdp {
+
+  VPPerfettoTrace::VPPerfettoTrace() :
+    VPWriter("xdp_trace.perfetto-trace"), nextTrack(1)
+  {
+    fout.close() ;
+    fout.clear() ;
+    fout.open(getcurrentFileName(), std::ios::out | std::ios::binary) ;
+
+    // Interned names are only valid after this packet
+    std::string packet ;
+    putUint(packet, field::sequenceId, sequence) ;
+    putUint(packet, field::sequenceFlags, incrementalStateCleared) ;
+    addPacket(packet) ;
+  }
+
+  VPPerfettoTrace::~VPPerfettoTrace()
+  {
+    std::lock_guard<std::mutex> lock(traceLock) ;
+    flushPackets() ;
+  }
+
+  std::shared_ptr<VPPerfettoTrace> VPPerfettoTrace::instance()
+  {
+    static bool enabled = xrt_core::config::get_perfetto_trace() ;
+    if (!enabled)
+      return nullptr ;
+    static std::shared_ptr<VPPerfettoTrace> trace =
+      std::make_shared<VPPerfettoTrace>() ;
+    return trace ;
+  }
+
+  void VPPerfettoTrace::addPacket(const std::string& packet)
+  {
+    putBytes(packets, field::tracePacket, packet) ;
+    if (packets.size() >= flushSize)
+      flushPackets() ;
+  }
+
+  void VPPerfettoTrace::flushPackets()
+  {
+    if (packets.empty())
+      return ;
+    fout.write(packets.data(), static_cast<std::streamsize>(packets.size())) ;
+    fout.flush() ;
+    packets.clear() ;
+  }
+
+  bool VPPerfettoTrace::write(bool /*openNewFile*/)
+  {
+    std::lock_guard<std::mutex> lock(traceLock) ;
+    flushPackets() ;
+    return true ;
+  }
+
+  uint64_t VPPerfettoTrace::getTrack(const std::string& name, uint64_t parent,
+                                     bool counter)
+  {
+    std::lock_guard<std::mutex> lock(traceLock) ;
+    auto key = std::make_pair(parent, name) ;
+    auto iter = tracks.find(key) ;
+    if (iter != tracks.end())
+      return iter->second ;
+
+    uint64_t uuid = nextTrack++ ;
+    tracks[key] = uuid ;
+
+    std::string descriptor ;
+    putUint(descriptor, field::uuid, uuid) ;
+    putBytes(descriptor, field::trackName, name) ;
+    if (parent != 0)
+      putUint(descriptor, field::parentUuid, parent) ;
+    if (counter)
+      putBytes(descriptor, field::counter, "") ;
+
+    std::string packet ;
+    putUint(packet, field::sequenceId, sequence) ;
+    putBytes(packet, field::trackDescriptor, descriptor) ;
+    addPacket(packet) ;
+    return uuid ;
+  }
+
+  // Return the interned id of the event's name.  If the name is used for
+  //  the first time, its InternedData.event_names entry is added to
+  //  interned.
+  uint64_t VPPerfettoTrace::internName(const VTFBinaryRecord& record,
+                                       std::string& interned)
+  {
+    uint64_t iid = typeNameBase + record.type ;
+    std::string name ;
+    if (hasNameField(record.type) && record.numFields > 0 &&
+        record.fields[0] != 0) {
+      iid = record.fields[0] ;
+      if (internedNames.find(iid) != internedNames.end())
+        return iid ;
+      name = (db->getDynamicInfo()).getString(iid) ;
+    }
+    else {
+      if (internedNames.find(iid) != internedNames.end())
+        return iid ;
+      const char* typeName =
+        VTFEvent::getTypeName(static_cast<VTFEventType>(record.type)) ;
+      name = typeName ? typeName : "UNKNOWN" ;
+    }
+
+    internedNames.insert(iid) ;
+    std::string eventName ;
+    putUint(eventName, field::iid, iid) ;
+    putBytes(eventName, field::name, name) ;
+    putBytes(interned, field::eventNames, eventName) ;
+    return iid ;
+  }
+
+  void VPPerfettoTrace::writeEvent(uint64_t track, const VTFBinaryRecord& record)
+  {
+    uint64_t type = sliceBegin ;
+    if (record.type == USER_MARKER || record.type == XCLBIN_END)
+      type = instant ;
+    else if (record.start_id != 0)
+      type = sliceEnd ;
+
+    std::lock_guard<std::mutex> lock(traceLock) ;
+
+    std::string event ;
+    std::string interned ;
+    putUint(event, field::eventType, type) ;
+    putUint(event, field::trackUuid, track) ;
+    if (type != sliceEnd)
+      putUint(event, field::nameIid, internName(record, interned)) ;
+
+    std::string packet ;
+    putUint(packet, field::timestamp, record.timestamp) ;
+    putUint(packet, field::sequenceId, sequence) ;
+    putUint(packet, field::sequenceFlags, needsIncrementalState) ;
+    if (!interned.empty())
+      putBytes(packet, field::internedData, interned) ;
+    putBytes(packet, field::trackEvent, event) ;
+    addPacket(packet) ;
+  }
+
+  void VPPerfettoTrace::writeCounter(uint64_t track, uint64_t timestamp,
+                                     double value)
+  {
+    std::string event ;
+    putUint(event, field::eventType, counterValue) ;
+    putUint(event, field::trackUuid, track) ;
+    putDouble(event, field::doubleCounterValue, value) ;
+
+    std::string packet ;
+    putUint(packet, field::timestamp, timestamp) ;
+    putUint(packet, field::sequenceId, sequence) ;
+    putBytes(packet, field::trackEvent, event) ;
+
+    std::lock_guard<std::mutex> lock(traceLock) ;
+    addPacket(packet) ;
+  }
+
+  // ************************ Track scanner ******************************
+
+  VPPerfettoTrackScanner::VPPerfettoTrackScanner(std::streambuf* t,
+                                                 VPPerfettoTrace* p,
+                                                 const std::string& name) :
+    target(t), trace(p), writerName(name), scanning(false)
+  {
+  }
+
+  void VPPerfettoTrackScanner::startFile()
+  {
+    scanning = true ;
+    line.clear() ;
+    groups.clear() ;
+    rows.clear() ;
+  }
+
+  uint64_t VPPerfettoTrackScanner::getTrack(uint32_t bucket)
+  {
+    auto iter = rows.find(bucket) ;
+    if (iter != rows.end())
+      return iter->second ;
+
+    // A row that is not in the structure
+    uint64_t track =
+      trace->getTrack(writerName + " row " + std::to_string(bucket), 0) ;
+    rows[bucket] = track ;
+    return track ;
+  }
+
+  void VPPerfettoTrackScanner::scan(const char* s, std::streamsize n)
+  {
+    for (std::streamsize i = 0 ; i < n && scanning ; ++i) {
+      if (s[i] == '\n')
+        scanLine() ;
+      else if (s[i] != '\r')
+        line.push_back(s[i]) ;
+    }
+  }
+
+  // Structure lines are:
+  //   Group_Start,<name>[,<tool tip>]
+  //   Group_End,<name>
+  //   <kind>_Row[_Summary],<bucket>,<name>[,<tool tip>]
+  void VPPerfettoTrackScanner::scanLine()
+  {
+    std::vector<std::string> fields ;
+    std::stringstream ss(line) ;
+    std::string f ;
+    while (std::getline(ss, f, ','))
+      fields.push_back(f) ;
+    line.clear() ;
+
+    if (fields.empty())
+      return ;
+
+    // The string table follows the structure
+    if (fields[0] == "MAPPING") {
+      scanning = false ;
+      return ;
+    }
+
+    uint64_t parent = groups.empty() ? 0 : groups.back() ;
+    if (fields[0] == "Group_Start" && fields.size() > 1) {
+      groups.push_back(trace->getTrack(fields[1], parent)) ;
+    }
+    else if (fields[0] == "Group_End") {
+      if (!groups.empty())
+        groups.pop_back() ;
+    }
+    else if (fields.size() > 2 &&
+             (fields[0].find("_Row") != std::string::npos)) {
+      try {
+        uint32_t bucket = static_cast<uint32_t>(std::stoul(fields[1])) ;
+        rows[bucket] = trace->getTrack(fields[2], parent) ;
+      }
+      catch (std::exception&) {
+        // Not a row of the structure
+      }
+    }
+  }
+
+  VPPerfettoTrackScanner::int_type VPPerfettoTrackScanner::overflow(int_type c)
+  {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      return traits_type::not_eof(c) ;
+
+    char ch = traits_type::to_char_type(c) ;
+    if (scanning)
+      scan(&ch, 1) ;
+    return target->sputc(ch) ;
+  }
+
+  std::streamsize VPPerfettoTrackScanner::xsputn(const char* s, std::streamsize n)
+  {
+    if (scanning)
+      scan(s, n) ;
+    return target->sputn(s, n) ;
+  }
+
+  int VPPerfettoTrackScanner::sync()
+  {
+    return target->pubsync() ;
+  }
+
+} // end namespace xdp
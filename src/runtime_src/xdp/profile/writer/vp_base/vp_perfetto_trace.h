@@ -0,0 +1,127 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef VP_PERFETTO_TRACE_DOT_H
+#define VP_PERFETTO_TRACE_DOT_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xdp/profile/database/events/vtf_event.h"
+#include "xdp/profile/writer/vp_base/vp_writer.h"
+#include "xdp/config.h"
+
+namespace xdp {
+
+  // When Debug.perfetto_trace is set, all trace writers also write their
+  //  events to a single trace in the Perfetto protobuf format, which can
+  //  be opened directly in the Perfetto UI or chrome://tracing.
+  //
+  // The file is the Perfetto "Trace" message: a sequence of TracePacket
+  //  messages.  Packets are appended as the trace writers dump their
+  //  events, so the file is a complete trace at any point of the run.
+  //
+  // Each row of a trace writer's structure becomes a track, nested in
+  //  the tracks of its groups.  Event names are interned once per trace,
+  //  using the string table ids of the database as interned ids.  Power
+  //  samples are written to counter tracks.
+  class VPPerfettoTrace : public VPWriter
+  {
+  private:
+    std::mutex traceLock ;
+
+    // Encoded packets not yet written to the file
+    std::string packets ;
+
+    // Tracks by parent track and name
+    std::map<std::pair<uint64_t, std::string>, uint64_t> tracks ;
+    uint64_t nextTrack ;
+
+    // Interned ids of the event names already written
+    std::set<uint64_t> internedNames ;
+
+    void addPacket(const std::string& packet) ;
+    void flushPackets() ;
+    uint64_t internName(const VTFBinaryRecord& record, std::string& interned) ;
+
+  public:
+    XDP_EXPORT VPPerfettoTrace() ;
+    XDP_EXPORT ~VPPerfettoTrace() ;
+
+    // The trace all writers write to, or nullptr if not enabled.  Trace
+    //  writers keep a reference, as they write their last events when
+    //  plugins are destroyed at exit.
+    XDP_EXPORT static std::shared_ptr<VPPerfettoTrace> instance() ;
+
+    // Return the track with the given name and parent (0 for a top level
+    //  track), adding it to the trace the first time
+    XDP_EXPORT uint64_t getTrack(const std::string& name, uint64_t parent,
+                                 bool counter = false) ;
+
+    XDP_EXPORT void writeEvent(uint64_t track, const VTFBinaryRecord& record) ;
+    XDP_EXPORT void writeCounter(uint64_t track, uint64_t timestamp,
+                                 double value) ;
+
+    // Write all packets to the file
+    XDP_EXPORT virtual bool write(bool openNewFile = true) ;
+  } ;
+
+  // A trace writer's output stream goes through a VPPerfettoTrackScanner,
+  //  which reads the STRUCTURE section of each file written and maps the
+  //  rows of the file to Perfetto tracks.  All output is passed on to the
+  //  writer's file unchanged.
+  class VPPerfettoTrackScanner : public std::streambuf
+  {
+  private:
+    std::streambuf* target ;
+    VPPerfettoTrace* trace ;
+
+    // Name of the top level track for rows outside of any group
+    std::string writerName ;
+
+    bool scanning ;
+    std::string line ;
+    std::vector<uint64_t> groups ;
+    std::map<uint32_t, uint64_t> rows ;
+
+    void scan(const char* s, std::streamsize n) ;
+    void scanLine() ;
+
+  protected:
+    virtual int_type overflow(int_type c) ;
+    virtual std::streamsize xsputn(const char* s, std::streamsize n) ;
+    virtual int sync() ;
+
+  public:
+    XDP_EXPORT VPPerfettoTrackScanner(std::streambuf* t, VPPerfettoTrace* p,
+                                      const std::string& name) ;
+
+    // Called when the writer starts writing a new file
+    XDP_EXPORT void startFile() ;
+
+    XDP_EXPORT uint64_t getTrack(uint32_t bucket) ;
+  } ;
+
+} // end namespace xdp
+
+#endif
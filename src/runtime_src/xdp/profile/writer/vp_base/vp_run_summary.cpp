@@ -131,6 +131,18 @@ namespace xdp {
       ptRunSummary.add_child("system_diagram", ptSystemDiagram) ;
     }
 
+    // In bounded trace collection, report how many events were dropped
+    //  so the trace files are known to be incomplete
+    if ((db->getDynamicInfo()).getEventLimit() != 0)
+    {
+      boost::property_tree::ptree ptTraceMemory ;
+      ptTraceMemory.put("event_limit",
+                        std::to_string((db->getDynamicInfo()).getEventLimit())) ;
+      ptTraceMemory.put("dropped_events",
+                        std::to_string((db->getDynamicInfo()).getDroppedEvents())) ;
+      ptRunSummary.add_child("trace_memory", ptTraceMemory) ;
+    }
+
     boost::property_tree::write_json(fout, ptRunSummary, true) ;
     return true;
   }
@@ -18,6 +18,7 @@
 
 #include "xdp/profile/writer/vp_base/vp_trace_writer.h"
 #include "xdp/profile/database/database.h"
+#include "core/common/config_reader.h"
 #include <iostream>
 
 namespace xdp {
@@ -30,17 +31,95 @@ namespace xdp {
 				 uint16_t r) :
     VPWriter(filename),
     version(v), creationTime(c), resolution(r),
-    humanReadable(true)
+    humanReadable(xrt_core::config::get_trace_file_format() != "binary")
   {
     setUniqueTraceID();
+    if (!humanReadable)
+      openBinaryFile() ;
+
+    perfettoTrace = VPPerfettoTrace::instance() ;
+    if (perfettoTrace) {
+      std::ostream& out = fout ;
+      perfettoScanner =
+        std::make_unique<VPPerfettoTrackScanner>(out.rdbuf(),
+                                                 perfettoTrace.get(),
+                                                 getRawBasename()) ;
+      out.rdbuf(perfettoScanner.get()) ;
+    }
   }
 
   VPTraceWriter::~VPTraceWriter()
   {
+    if (binaryStream)
+      binaryStream->flush() ;
+    static_cast<std::ostream&>(fout).rdbuf(fout.rdbuf()) ;
+    if (perfettoTrace)
+      perfettoTrace->write() ;
+  }
+
+  // Reopen the current file in binary mode and redirect fout through the
+  //  binary stream so the text sections written by each writer end up
+  //  in TEXT blocks
+  void VPTraceWriter::openBinaryFile()
+  {
+    fout.close() ;
+    fout.clear() ;
+    fout.open(getcurrentFileName(), std::ios::out | std::ios::binary) ;
+
+    if (!binaryStream) {
+      binaryStream = std::make_unique<VPBinaryTraceStream>(fout.rdbuf()) ;
+      static_cast<std::ostream&>(fout).rdbuf(binaryStream.get()) ;
+    }
+    binaryStream->writeFileHeader() ;
+  }
+
+  void VPTraceWriter::switchFiles()
+  {
+    if (binaryStream)
+      binaryStream->flush() ;
+    if (perfettoTrace)
+      perfettoTrace->write() ;
+    VPWriter::switchFiles() ;
+    if (!humanReadable)
+      openBinaryFile() ;
+  }
+
+  void VPTraceWriter::refreshFile()
+  {
+    if (binaryStream)
+      binaryStream->flush() ;
+    if (perfettoTrace)
+      perfettoTrace->write() ;
+    VPWriter::refreshFile() ;
+    if (!humanReadable)
+      openBinaryFile() ;
+  }
+
+  void VPTraceWriter::dumpEvent(VTFEvent* e, uint32_t bucket)
+  {
+    if (humanReadable) {
+      e->dump(fout, bucket) ;
+      if (!perfettoTrace)
+        return ;
+    }
+    VTFBinaryRecord record ;
+    e->dumpBinary(record, bucket) ;
+    writeRecord(record) ;
+  }
+
+  void VPTraceWriter::writeRecord(const VTFBinaryRecord& record)
+  {
+    if (binaryStream)
+      binaryStream->writeEvent(record) ;
+    if (perfettoTrace)
+      perfettoTrace->writeEvent(perfettoScanner->getTrack(record.bucket),
+                                record) ;
   }
 
   void VPTraceWriter::writeHeader()
   {
+    if (perfettoScanner)
+      perfettoScanner->startFile() ;
     fout << "HEADER" << std::endl
          << "VTF File Version," << version << std::endl ;
     fout << "VTF File Type," ;
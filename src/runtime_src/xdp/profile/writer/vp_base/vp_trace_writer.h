@@ -19,8 +19,11 @@
 
 #include <string>
 #include <atomic>
+#include <memory>
 
 #include "xdp/profile/writer/vp_base/vp_writer.h"
+#include "xdp/profile/writer/vp_base/vp_binary_trace.h"
+#include "xdp/profile/writer/vp_base/vp_perfetto_trace.h"
 #include "xdp/config.h"
 
 namespace xdp {
@@ -36,6 +39,17 @@ namespace xdp {
     std::string creationTime ;
     uint16_t resolution ;
     static std::atomic<unsigned int> traceIDCtr;
+
+    // When trace files are dumped in binary, all output to fout goes
+    //  through this stream
+    std::unique_ptr<VPBinaryTraceStream> binaryStream ;
+    void openBinaryFile() ;
+
+    // When the Perfetto trace is enabled, events are also written to it,
+    //  and all output to fout goes through the scanner that maps rows
+    //  to Perfetto tracks
+    std::shared_ptr<VPPerfettoTrace> perfettoTrace ;
+    std::unique_ptr<VPPerfettoTrackScanner> perfettoScanner ;
     
   protected:
     // Each new trace CSV file has the following sections
@@ -58,6 +72,19 @@ namespace xdp {
     // Return a unique ID everytime we're called
     XDP_EXPORT void setUniqueTraceID();
 
+    // Dump a trace event in the format of the trace file.  Extra values
+    //  that follow an event on the same line, like tool tips, are
+    //  added to the record before it is written.
+    XDP_EXPORT void dumpEvent(VTFEvent* e, uint32_t bucket) ;
+    XDP_EXPORT void writeRecord(const VTFBinaryRecord& record) ;
+
+    // Writers that dump events without dumpEvent have to pass records
+    //  of the events to writeRecord if this is true
+    bool needsRecords() { return !humanReadable || perfettoTrace != nullptr ; }
+
+    XDP_EXPORT virtual void switchFiles() ;
+    XDP_EXPORT virtual void refreshFile() ;
+
   public:
     XDP_EXPORT VPTraceWriter(const char* filename, const std::string& v,
 			     const std::string& c, uint16_t r) ;
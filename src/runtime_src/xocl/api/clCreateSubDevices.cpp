@@ -21,6 +21,8 @@
 #include "api.h"
 #include "plugin/xdp/profile_v2.h"
 #include <CL/cl.h>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning ( disable : 4267 )
@@ -29,11 +31,57 @@
 namespace xocl {
 
 
-// TODO: partition cus properly
-static size_t
-number_of_clusters(const device::compute_unit_range& cu_range)
+using compute_unit_vector_type = device::compute_unit_vector_type;
+
+// Partition the CUs of a device per partition properties.
+//
+// CL_DEVICE_PARTITION_EQUALLY creates as many sub-devices as possible
+// with the specified number of CUs each; remaining CUs are not used.
+// CL_DEVICE_PARTITION_BY_COUNTS assigns the CUs in order to
+// sub-devices with the specified number of CUs each.
+// CL_DEVICE_PARTITION_BY_CONNECTIVITY creates a sub-device per CU.
+//
+// Each sub-device restricts kernel execution to its own CUs, see
+// xocl::kernel constructor, so command queues of different
+// sub-devices do not compete for CUs.
+static std::vector<compute_unit_vector_type>
+partition(const device* in_device, const cl_device_partition_property* properties)
 {
-  return cu_range.size();
+  auto& cus = in_device->get_cu_range();
+  std::vector<compute_unit_vector_type> partitions;
+
+  switch (properties[0]) {
+  case CL_DEVICE_PARTITION_EQUALLY: {
+    auto n = properties[1];
+    if (n <= 0 || static_cast<size_t>(n) > cus.size())
+      throw error(CL_INVALID_VALUE,"Invalid number of CUs per subdevice: " + std::to_string(n));
+    for (size_t idx = 0; idx + n <= cus.size(); idx += n)
+      partitions.emplace_back(cus.begin() + idx, cus.begin() + idx + n);
+    break;
+  }
+  case CL_DEVICE_PARTITION_BY_COUNTS: {
+    size_t idx = 0;
+    for (auto count = properties + 1; *count != CL_DEVICE_PARTITION_BY_COUNTS_LIST_END; ++count) {
+      auto n = *count;
+      if (n < 0 || idx + static_cast<size_t>(n) > cus.size() || partitions.size() == cus.size())
+        throw error(CL_INVALID_DEVICE_PARTITION_COUNT,"Invalid partition count");
+      partitions.emplace_back(cus.begin() + idx, cus.begin() + idx + n);
+      idx += n;
+    }
+    if (partitions.empty())
+      throw error(CL_INVALID_VALUE,"No partition counts provided");
+    break;
+  }
+  case CL_DEVICE_PARTITION_BY_CONNECTIVITY:
+    for (auto& cu : cus)
+      partitions.emplace_back(1, cu);
+    break;
+  default:
+    throw error(CL_INVALID_VALUE,"Invalid partition property, only CL_DEVICE_PARTITION_EQUALLY, "
+                "CL_DEVICE_PARTITION_BY_COUNTS, and CL_DEVICE_PARTITION_BY_CONNECTIVITY supported");
+  }
+
+  return partitions;
 }
 
 static void
@@ -55,30 +103,15 @@ validOrError(cl_device_id                        in_device,
   if (!properties)
     throw error(CL_INVALID_VALUE,"No device partitioning property provided");
 
-  // Support CL_DEVICE_PARTITION_EQUALLY
-  if (properties[0] == CL_DEVICE_PARTITION_EQUALLY) {
-    if (properties[1] != 1)
-      throw error(CL_INVALID_VALUE,"Only one CU per subdevice is supported");
-  }
-  else if (properties[0] == CL_DEVICE_PARTITION_BY_CONNECTIVITY) {
-  }
-  else {
-    throw error(CL_INVALID_VALUE,"Invalid partition property, \
-                only CL_DEVICE_PARTITION_EQUALLY and CL_DEVICE_PARTITION_BY_CONNECTIVITY supported");
-  }
-
   // CL_INVALID_VALUE if out_devices is not NULL and num_devices is
   // less than the number of sub-devices created by the partition
   // scheme.
   detail::device::validOrError(num_entries,out_devices);
-  auto clusters = number_of_clusters(xocl(in_device)->get_cu_range());
-  if (out_devices && num_entries && num_entries < clusters)
-    throw error(CL_INVALID_VALUE,"Not enough entries in out_devices");
 
   // CL_DEVICE_PARTITION_FAILED if the partition name is supported by
   // the implementation but in_device could not be further
   // partitioned.
-  if (clusters==1)
+  if (xocl(in_device)->get_num_cus() < 2)
     throw error(CL_DEVICE_PARTITION_FAILED,"Nothing to partition");
 
   // CL_INVALID_DEVICE_PARTITION_COUNT if the partition name specified
@@ -89,6 +122,7 @@ validOrError(cl_device_id                        in_device,
   // number of compute units requested for one or more sub-devices is
   // less than zero or the number of sub-devices requested exceeds
   // CL_DEVICE_PARTITION_MAX_COMPUTE_UNITS for in_device.
+  //  -> checked in partition()
 
   // CL_OUT_OF_RESOURCES if there is a failure to allocate resources
   // required by the OpenCL implementation on the device.
@@ -107,13 +141,12 @@ clCreateSubDevices(cl_device_id                        in_device,
 {
   validOrError(in_device,properties,num_entries,out_devices,num_devices);
 
-  // For experimentation, create a subdevice per CU in in_device
-  size_t count = 0;
-  for (auto cuin : xocl(in_device)->get_cu_range()) {
-    std::vector<decltype(cuin)> cus;
-    cus.push_back(cuin);
-    ++count;
-    if (out_devices) {
+  auto partitions = partition(xocl(in_device),properties);
+  if (out_devices && num_entries < partitions.size())
+    throw error(CL_INVALID_VALUE,"Not enough entries in out_devices");
+
+  if (out_devices) {
+    for (auto& cus : partitions) {
       auto sd  = std::make_unique<device>(xocl(in_device),cus);
       *out_devices = sd.release();
       ++out_devices;
@@ -121,7 +154,7 @@ clCreateSubDevices(cl_device_id                        in_device,
   }
 
   if (num_devices)
-    *num_devices = count;
+    *num_devices = static_cast<cl_uint>(partitions.size());
 
   return CL_SUCCESS;
 }
@@ -237,45 +237,13 @@ clEnqueueCopyBufferRect(cl_command_queue     command_queue ,
      src_row_pitch,src_slice_pitch,dst_row_pitch,dst_slice_pitch,
      num_events_in_wait_list,event_wait_list,event_parameter);
 
-  // Soft event
-  auto context = xocl(command_queue)->get_context();
-  auto uevent = xocl::create_soft_event(context,CL_COMMAND_COPY_BUFFER_RECT,num_events_in_wait_list,event_wait_list);
-  // queue the event, block until successfully submitted
-  uevent->queue(true/*wait*/);
-  uevent->set_status(CL_RUNNING);
-
-  //memcpy
-  {
-    auto device = xocl(command_queue)->get_device();
-    auto xdevice = device->get_xdevice();
-    auto src_boh = xocl(src_buffer)->get_buffer_object(device);
-    auto dst_boh = xocl(dst_buffer)->get_buffer_object(device);
-    void* host_ptr_src = xdevice->map(src_boh);
-    void* host_ptr_dst = xdevice->map(dst_boh);
-
-    for(size_t zit=0;zit<region[2];++zit) {
-      for(size_t yit=0;yit<region[1];++yit) {
-        size_t src_row_origin_in_bytes =
-          origin_in_bytes(src_origin,src_row_pitch,src_slice_pitch)
-          + zit*src_slice_pitch
-          + yit*src_row_pitch;
-
-        size_t dst_row_origin_in_bytes =
-          origin_in_bytes(dst_origin,dst_row_pitch,dst_slice_pitch)
-          + zit*dst_slice_pitch
-          + yit*dst_row_pitch;
-
-        std::memcpy( &((uint8_t *)(host_ptr_dst))[dst_row_origin_in_bytes],
-                     &((uint8_t *)(host_ptr_src))[src_row_origin_in_bytes],
-                     region[0]);
-      }
-    }
-    xdevice->unmap(src_boh);
-    xdevice->unmap(dst_boh);
-  }
+  auto uevent = xocl::create_hard_event
+    (command_queue,CL_COMMAND_COPY_BUFFER_RECT,num_events_in_wait_list,event_wait_list);
+  xocl::enqueue::set_event_action
+    (uevent.get(),xocl::enqueue::action_copy_buffer_rect,src_buffer,dst_buffer,src_origin,dst_origin,region
+     ,src_row_pitch,src_slice_pitch,dst_row_pitch,dst_slice_pitch);
 
-  //set event CL_COMPLETE
-  uevent->set_status(CL_COMPLETE);
+  uevent->queue();
   xocl::assign(event_parameter,uevent.get());
   return CL_SUCCESS;
 }
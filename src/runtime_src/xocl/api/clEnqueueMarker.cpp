@@ -54,26 +54,13 @@ clEnqueueMarker(cl_command_queue command_queue,
 {
   validOrError(command_queue,event_parameter);
 
-  // A marker is complete when all events ahead of it is complete, so
-  // create the event with an event wait list consisting of all
-  // currently queued events.
-  //
-  // Be very careful controlling the scope here.  It is important that
-  // the current command_queue events are valid while the event is
-  // constructed.  To make this possible, the event_range returned by
-  // the command queue also retains a mutex lock on the command queue.
-  // Since the command queue should not remained locked, we want the
-  // lock (event_range) released immedidately after the event has been
-  // constructed.  This interface to event/queue doesn't look quite right
-  xocl::ptr<xocl::event> pevent;
-  {
-    auto wait_range = xocl::xocl(command_queue)->get_event_range();
-    std::vector<cl_event> wait_list(wait_range.begin(),wait_range.end());
-    pevent = xocl::create_hard_event
-      (command_queue,CL_COMMAND_MARKER,wait_list.size(),wait_list.data());
-    xocl::appdebug::set_event_action
-      (pevent.get(),xocl::appdebug::action_barrier_marker,wait_list.size(),wait_list.data());
-  }
+  // A marker is complete when all events ahead of it is complete.
+  // The command queue adds the dependencies on the currently queued
+  // events when the marker is queued.
+  auto pevent = xocl::create_hard_event(command_queue,CL_COMMAND_MARKER,0,nullptr);
+  pevent->set_wait_all();
+  xocl::appdebug::set_event_action
+    (pevent.get(),xocl::appdebug::action_barrier_marker,0,nullptr);
   pevent->queue();
   xocl::assign(event_parameter,pevent.get());
   return CL_SUCCESS;
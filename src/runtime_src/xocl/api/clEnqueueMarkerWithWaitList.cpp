@@ -65,16 +65,11 @@ clEnqueueMarkerWithWaitList(cl_command_queue  command_queue ,
   validOrError(command_queue,num_events_in_wait_list,event_wait_list,event);
 
   // If the list is empty it waits for all commands previously
-  // enqueued in command_queue to complete before it completes.
-  xocl::ptr<xocl::event> uevent;
-  if (!num_events_in_wait_list) {
-    auto wait_range = xocl::xocl(command_queue)->get_event_range();
-    std::vector<cl_event> ewl(wait_range.begin(),wait_range.end());
-    uevent = xocl::create_hard_event(command_queue,CL_COMMAND_MARKER,ewl.size(),ewl.data());
-  }
-  else {
-    uevent = xocl::create_hard_event(command_queue,CL_COMMAND_MARKER,num_events_in_wait_list,event_wait_list);
-  }
+  // enqueued in command_queue to complete before it completes.  The
+  // command queue adds these dependencies when the event is queued.
+  auto uevent = xocl::create_hard_event(command_queue,CL_COMMAND_MARKER,num_events_in_wait_list,event_wait_list);
+  if (!num_events_in_wait_list)
+    uevent->set_wait_all();
   uevent->queue();
   xocl::assign(event,uevent.get());
   return CL_SUCCESS;
@@ -67,6 +67,14 @@ enqueueReadPrintfBuffer(cl_kernel kernel, cl_command_queue queue,
                         cl_mem mem, cl_event waitEvent,
                         cl_event* event_param);
 
+static xocl::ptr<xocl::memory>
+acquireRingPrintfBuffer(cl_context context, cl_kernel kernel,
+                        const std::array<size_t,3>& gsz, const std::array<size_t,3>& lsz);
+
+static void
+drainRingPrintfBuffer(cl_kernel kernel, cl_command_queue queue,
+                      cl_mem mem, cl_event waitEvent);
+
 static cl_uint
 getDeviceAddressBits(cl_device_id device)
 {
@@ -374,12 +382,19 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
 
   // PRINTF - we need to allocate a buffer and do an initial memory transfer before kernel
   // execution starts to initialize the printf buffer to known values.
-  auto printf_buffer_scoped = createPrintfBuffer(context, kernel, global_work_size_3D, local_work_size_3D);
+  // In ring buffer mode, a recycled buffer is already initialized on device.
+  auto printf_ring = XCL::Printf::isPrintfRingMode();
+  auto printf_buffer_scoped = printf_ring
+    ? acquireRingPrintfBuffer(context, kernel, global_work_size_3D, local_work_size_3D)
+    : createPrintfBuffer(context, kernel, global_work_size_3D, local_work_size_3D);
   cl_mem printf_buffer = printf_buffer_scoped.get(); // cast to cl_mem is important befure passing as void*
   cl_event printf_init_event = nullptr;
   if (printf_buffer) {
     xocl(kernel)->set_printf_argument(sizeof(cl_mem),&printf_buffer);
-    printf_init_event = enqueueInitializePrintfBuffer(kernel, command_queue, printf_buffer);
+    if (printf_ring)
+      XCL::Printf::initializeRingBuffer(printf_buffer, xocl(command_queue)->get_device());
+    else
+      printf_init_event = enqueueInitializePrintfBuffer(kernel, command_queue, printf_buffer);
   }
 
   // Add printf buffer initialization to wait list to ensure this is forced to happen
@@ -436,7 +451,9 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
   // execution completes (wait on ueEvent).  The execution event may
   // have already completed (it was queued above), but this function
   // has a reference to ueEvent so the event is alive and well.
-  if (printf_buffer)
+  if (printf_buffer && printf_ring)
+    drainRingPrintfBuffer(kernel,command_queue,printf_buffer,eEvent);
+  else if (printf_buffer)
     enqueueReadPrintfBuffer(kernel,command_queue,printf_buffer,eEvent,nullptr);
 
   xocl::assign(event_parameter,ueEvent.get());
@@ -504,6 +521,21 @@ void CL_CALLBACK cb_BufferReturned(cl_event event, cl_int status, void *data)
   xocl::api::clReleaseEvent(event);
 }
 
+struct RingCallbackArgs {
+  xocl::ptr<xocl::kernel> kernel;
+  xocl::ptr<xocl::memory> mem;
+  cl_device_id device;
+};
+
+// Kernel execution completed, hand the printf buffer to the drain
+// thread.  The buffer of a failed execution is not recycled.
+void CL_CALLBACK cb_RingBufferComplete(cl_event event, cl_int status, void *data)
+{
+  std::unique_ptr<RingCallbackArgs> args(reinterpret_cast<RingCallbackArgs*>(data));
+  if (status == CL_COMPLETE)
+    XCL::Printf::drainRingBuffer(args->kernel.get(), args->mem.get(), args->device);
+}
+
 // Creates a device printf buffer but does not initialize
 // Allocate device printf buffer if printf is needed for this workgroup.
 xocl::ptr<xocl::memory>
@@ -523,6 +555,22 @@ createPrintfBuffer(cl_context context, cl_kernel kernel
   return retval;
 }
 
+// Get an idle printf buffer of the kernel if one is large enough,
+// otherwise create a new buffer that is recycled when drained.
+xocl::ptr<xocl::memory>
+acquireRingPrintfBuffer(cl_context context, cl_kernel kernel
+                        ,const std::array<size_t,3>& gsz, const std::array<size_t,3>& lsz)
+{
+  if (!XCL::Printf::kernelHasPrintf(kernel))
+    return nullptr;
+
+  auto mem = xocl::xocl(kernel)->acquire_printf_buffer(XCL::Printf::getPrintfBufferSize(gsz,lsz));
+  if (mem.get())
+    return mem;
+
+  return createPrintfBuffer(context, kernel, gsz, lsz);
+}
+
 // Initialize the device printf buffer to known values. This must execute
 // BEFORE the clEnqueueNDRangeKernel starts so the event is returned so it
 // can be appended to the list of events the enqueue must wait for.
@@ -586,6 +634,22 @@ cl_int enqueueReadPrintfBuffer(cl_kernel kernel, cl_command_queue queue,
   return err;
 }
 
+// Drain the device printf buffer asynchronously after the
+// clEnqueueNDRangeKernel event completes.  Nothing is enqueued on the
+// command queue.
+void drainRingPrintfBuffer(cl_kernel kernel, cl_command_queue queue,
+                           cl_mem mem, cl_event waitEvent)
+{
+  auto args = std::make_unique<RingCallbackArgs>();
+  args->kernel = xocl::xocl(kernel);
+  args->mem = xocl::xocl(mem);
+  args->device = xocl::xocl(queue)->get_device();
+  auto err = xocl::api::clSetEventCallback(waitEvent, CL_COMPLETE, cb_RingBufferComplete, args.get());
+  if (err != CL_SUCCESS)
+    throw xocl::error(err,"drainRingPrintfBuffer");
+  args.release();
+}
+
 } // namespace
 
 cl_int
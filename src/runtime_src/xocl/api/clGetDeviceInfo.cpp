@@ -275,7 +275,8 @@ clGetDeviceInfo(cl_device_id   device,
     break;
   case CL_DEVICE_PARTITION_PROPERTIES:
     buffer.as<cl_device_partition_property>() =
-      xocl::get_range(std::initializer_list<cl_device_partition_property>({0,0,0,0}));
+      xocl::get_range(std::initializer_list<cl_device_partition_property>
+                      ({CL_DEVICE_PARTITION_EQUALLY,CL_DEVICE_PARTITION_BY_COUNTS,0}));
     break;
   case CL_DEVICE_PARTITION_AFFINITY_DOMAIN:
     buffer.as<cl_device_affinity_domain>() = 0;
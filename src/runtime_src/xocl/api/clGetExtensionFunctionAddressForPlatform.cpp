@@ -28,6 +28,10 @@ static const std::map<const std::string, void *> extensionFunctionTable = {
   std::pair<const std::string, void *>("xclGetXrtDevice", (void *)xclGetXrtDevice),
   std::pair<const std::string, void *>("xclGetMemObjDeviceAddress", (void *)xclGetMemObjDeviceAddress),
   std::pair<const std::string, void *>("xclGetComputeUnitInfo", (void *)xclGetComputeUnitInfo),
+  std::pair<const std::string, void *>("xclHostMemAlloc", (void *)xclHostMemAlloc),
+  std::pair<const std::string, void *>("xclSharedMemAlloc", (void *)xclSharedMemAlloc),
+  std::pair<const std::string, void *>("xclDeviceMemAlloc", (void *)xclDeviceMemAlloc),
+  std::pair<const std::string, void *>("xclMemFree", (void *)xclMemFree),
   std::pair<const std::string, void *>("clIcdGetPlatformIDsKHR", (void *)clIcdGetPlatformIDsKHR),
 };
 
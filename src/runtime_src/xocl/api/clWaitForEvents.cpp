@@ -21,6 +21,7 @@
 #include "detail/event.h"
 
 #include <iostream>
+#include <vector>
 
 #include "xocl/config.h"
 #include "plugin/xdp/profile_v2.h"
@@ -40,8 +41,11 @@ static cl_int
 clWaitForEvents(cl_uint num_events, const cl_event* event_list)
 {
   validOrError(num_events, event_list);
+  std::vector<xocl::event*> events;
+  events.reserve(num_events);
   for (auto event : get_range(event_list,event_list+num_events))
-    xocl(event)->wait();  
+    events.push_back(xocl(event));
+  xocl::event::wait_all(events);
   return CL_SUCCESS;
 }
 
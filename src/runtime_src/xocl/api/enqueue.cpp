@@ -30,6 +30,10 @@
 #include "xocl/core/device.h"
 #include "xocl/core/kernel.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 namespace {
 
 // Exception pointer for device exceptions during enqueue tasks.  The
@@ -228,6 +232,57 @@ migrate_buffer(shared_event_completer sec,xocl::device* device
   }
 }
 
+// Migrate a group of buffers in one task.  The groups of one
+// clEnqueueMigrateMemObjects run concurrently on the DMA queue
+// workers and share the event completer.
+static void
+migrate_buffers(shared_event_completer sec,xocl::device* device
+                ,const std::vector<cl_mem>& buffers,cl_mem_migration_flags flags)
+{
+  try {
+    sec->set_status(CL_RUNNING);
+    for (auto buffer : buffers)
+      device->migrate_buffer(xocl::xocl(buffer),flags);
+  }
+  catch (const std::exception& ex) {
+    handle_device_exception(sec.get(),ex);
+  }
+}
+
+// Split buffers to migrate into at most one group per DMA channel.
+// Buffers are ordered by memory bank so that a group mostly targets
+// one bank, and groups are balanced by bytes to migrate.
+static std::vector<std::vector<cl_mem>>
+get_migrate_groups(std::vector<cl_mem> buffers)
+{
+  auto channels = xrt_xocl::config::get_dma_threads();
+  if (!channels)
+    channels = 2;   // default number of DMA channels
+
+  std::stable_sort(buffers.begin(),buffers.end(),[](cl_mem lhs, cl_mem rhs) {
+      return xocl::xocl(lhs)->get_memidx() < xocl::xocl(rhs)->get_memidx();
+    });
+
+  size_t total = 0;
+  for (auto mem : buffers)
+    total += xocl::xocl(mem)->get_size();
+
+  auto groups = std::min<size_t>(channels,buffers.size());
+  std::vector<std::vector<cl_mem>> migrate_groups(groups);
+  size_t bytes = 0;
+  for (auto mem : buffers) {
+    // group of this buffer per bytes migrated before it
+    auto idx = total ? std::min<size_t>(groups-1, bytes*groups/total) : 0;
+    migrate_groups[idx].push_back(mem);
+    bytes += xocl::xocl(mem)->get_size();
+  }
+
+  migrate_groups.erase(std::remove_if(migrate_groups.begin(),migrate_groups.end()
+                                      ,[](const std::vector<cl_mem>& group) { return group.empty(); })
+                       ,migrate_groups.end());
+  return migrate_groups;
+}
+
 static void
 read_image(xocl::event* event,xocl::device* device,cl_mem image,
 	const size_t* origin,const size_t* region, size_t row_pitch,size_t slice_pitch,
@@ -258,6 +313,69 @@ write_image(xocl::event* event,xocl::device* device,cl_mem image,
   }
 }
 
+// Rectangle of a rect transfer.  The origins and region are copied
+// because the transfer runs after the enqueue API has returned.
+struct rect_type
+{
+  std::array<size_t,3> src_origin;
+  std::array<size_t,3> dst_origin;
+  std::array<size_t,3> region;
+  size_t src_row_pitch;
+  size_t src_slice_pitch;
+  size_t dst_row_pitch;
+  size_t dst_slice_pitch;
+
+  rect_type(const size_t* so, const size_t* dor, const size_t* r,
+            size_t srp, size_t ssp, size_t drp, size_t dsp)
+    : src_origin{{so[0],so[1],so[2]}}, dst_origin{{dor[0],dor[1],dor[2]}}, region{{r[0],r[1],r[2]}}
+    , src_row_pitch(srp), src_slice_pitch(ssp), dst_row_pitch(drp), dst_slice_pitch(dsp)
+  {}
+};
+
+// Buffer is source, host memory is destination
+static void
+read_buffer_rect(xocl::event* event,xocl::device* device,cl_mem buffer,const rect_type& rect,void* ptr)
+{
+  try {
+    event->set_status(CL_RUNNING);
+    device->read_buffer_rect(xocl::xocl(buffer),rect.src_origin.data(),rect.dst_origin.data(),rect.region.data(),
+                             rect.src_row_pitch,rect.src_slice_pitch,rect.dst_row_pitch,rect.dst_slice_pitch,ptr);
+    event->set_status(CL_COMPLETE);
+  }
+  catch (const std::exception& ex) {
+    handle_device_exception(event,ex);
+  }
+}
+
+// Host memory is source, buffer is destination
+static void
+write_buffer_rect(xocl::event* event,xocl::device* device,cl_mem buffer,const rect_type& rect,const void* ptr)
+{
+  try {
+    event->set_status(CL_RUNNING);
+    device->write_buffer_rect(xocl::xocl(buffer),rect.dst_origin.data(),rect.src_origin.data(),rect.region.data(),
+                              rect.dst_row_pitch,rect.dst_slice_pitch,rect.src_row_pitch,rect.src_slice_pitch,ptr);
+    event->set_status(CL_COMPLETE);
+  }
+  catch (const std::exception& ex) {
+    handle_device_exception(event,ex);
+  }
+}
+
+static void
+copy_buffer_rect(xocl::event* event,xocl::device* device,cl_mem src_buffer,cl_mem dst_buffer,const rect_type& rect)
+{
+  try {
+    event->set_status(CL_RUNNING);
+    device->copy_buffer_rect(xocl::xocl(src_buffer),xocl::xocl(dst_buffer),
+                             rect.src_origin.data(),rect.dst_origin.data(),rect.region.data(),
+                             rect.src_row_pitch,rect.src_slice_pitch,rect.dst_row_pitch,rect.dst_slice_pitch);
+    event->set_status(CL_COMPLETE);
+  }
+  catch (const std::exception& ex) {
+    handle_device_exception(event,ex);
+  }
+}
 
 } // namespace
 
@@ -356,6 +474,16 @@ action_map_buffer(cl_event event,cl_mem buffer,cl_map_flags map_flags,size_t off
   auto userptr = device->map_buffer(xocl(buffer),map_flags,offset,size,nullptr,true/*nosync*/);
   *hostbase = userptr;
 
+  // Mapping host coherent buffers involves no data movement, so
+  // complete the event when submitted rather than through a worker
+  if (device->is_host_coherent(xocl(buffer))) {
+    return [](xocl::event* ev) {
+      XOCL_DEBUG(std::cout,"completing host coherent map buffer event(",ev->get_uid(),")\n");
+      ev->set_status(CL_RUNNING);
+      ev->set_status(CL_COMPLETE);
+    };
+  }
+
   // Event scheduler schedules the actual map copy through this lambda
   // stored as an event action.   We pass in the ptr computed for user
   // as a sanity check to ensure device->enqueueMapBuffer computes the
@@ -400,9 +528,17 @@ action_unmap_buffer(cl_mem memobj,void* mapped_ptr)
 {
   throw_if_error();
   return [=](xocl::event* ev) {
-    XOCL_DEBUG(std::cout,"launching unmap DMA event(",ev->get_uid(),")\n");
     auto command_queue = ev->get_command_queue();
     auto device = command_queue->get_device();
+
+    // Unmap of host coherent buffers only updates the map bookkeeping
+    if (device->is_host_coherent(xocl::xocl(memobj))) {
+      XOCL_DEBUG(std::cout,"completing host coherent unmap event(",ev->get_uid(),")\n");
+      unmap_buffer(ev,device,memobj,mapped_ptr);
+      return;
+    }
+
+    XOCL_DEBUG(std::cout,"launching unmap DMA event(",ev->get_uid(),")\n");
     auto xdevice = device->get_xdevice();
     xdevice->schedule(unmap_buffer,async_type::write,ev,device,memobj,mapped_ptr);
   };
@@ -459,19 +595,76 @@ action_migrate_memobjects(size_t num, const cl_mem* memobjs, cl_mem_migration_fl
     auto device = command_queue->get_device();
     auto xdevice = device->get_xdevice();
     auto ec = make_shared_event_completer(ev);
-    for (auto mem : mo) {
-      // do not migrate if argument is CL_MIGRATE_MEM_OBJECT_CONTENT_UNDERFINED
-      // but trick code into assuming that the argument is resident
-      if (flags & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) {
+
+    // do not migrate if argument is CL_MIGRATE_MEM_OBJECT_CONTENT_UNDERFINED
+    // but trick code into assuming that the argument is resident
+    if (flags & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) {
+      for (auto mem : mo) {
         // at least allocate buffer on device if necessary
         xocl::xocl(mem)->get_buffer_object(device);
         xocl::xocl(mem)->set_resident(device);
-        continue;
       }
-
-      auto at = (flags & CL_MIGRATE_MEM_OBJECT_HOST) ? async_type::read : async_type::write;
-      xdevice->schedule(migrate_buffer,at,ec,device,mem,flags);
+      return;
     }
+
+    // Allocate buffers to host to device migrate so that buffers
+    // are grouped by their memory bank
+    auto at = (flags & CL_MIGRATE_MEM_OBJECT_HOST) ? async_type::read : async_type::write;
+    if (at == async_type::write)
+      for (auto mem : mo)
+        xocl::xocl(mem)->get_buffer_object(device);
+
+    // Task per group rather than per buffer, the event is complete
+    // when the last group is done
+    for (auto& group : get_migrate_groups(mo))
+      xdevice->schedule(migrate_buffers,at,ec,device,std::move(group),flags);
+  };
+}
+
+xocl::event::action_enqueue_type
+action_read_buffer_rect(cl_mem buffer,const size_t* buffer_origin,const size_t* host_origin,const size_t* region,
+                        size_t buffer_row_pitch,size_t buffer_slice_pitch,size_t host_row_pitch,size_t host_slice_pitch,
+                        void* ptr)
+{
+  throw_if_error();
+  rect_type rect(buffer_origin,host_origin,region,buffer_row_pitch,buffer_slice_pitch,host_row_pitch,host_slice_pitch);
+  return [=](xocl::event* ev) {
+    XOCL_DEBUG(std::cout,"launching read buffer rect DMA event(",ev->get_uid(),")\n");
+    auto command_queue = ev->get_command_queue();
+    auto device = command_queue->get_device();
+    auto xdevice = device->get_xdevice();
+    xdevice->schedule(read_buffer_rect,async_type::read,ev,device,buffer,rect,ptr);
+  };
+}
+
+xocl::event::action_enqueue_type
+action_write_buffer_rect(cl_mem buffer,const size_t* buffer_origin,const size_t* host_origin,const size_t* region,
+                         size_t buffer_row_pitch,size_t buffer_slice_pitch,size_t host_row_pitch,size_t host_slice_pitch,
+                         const void* ptr)
+{
+  throw_if_error();
+  rect_type rect(host_origin,buffer_origin,region,host_row_pitch,host_slice_pitch,buffer_row_pitch,buffer_slice_pitch);
+  return [=](xocl::event* ev) {
+    XOCL_DEBUG(std::cout,"launching write buffer rect DMA event(",ev->get_uid(),")\n");
+    auto command_queue = ev->get_command_queue();
+    auto device = command_queue->get_device();
+    auto xdevice = device->get_xdevice();
+    xdevice->schedule(write_buffer_rect,async_type::write,ev,device,buffer,rect,ptr);
+  };
+}
+
+xocl::event::action_enqueue_type
+action_copy_buffer_rect(cl_mem src_buffer,cl_mem dst_buffer,const size_t* src_origin,const size_t* dst_origin,const size_t* region,
+                        size_t src_row_pitch,size_t src_slice_pitch,size_t dst_row_pitch,size_t dst_slice_pitch)
+{
+  throw_if_error();
+  rect_type rect(src_origin,dst_origin,region,src_row_pitch,src_slice_pitch,dst_row_pitch,dst_slice_pitch);
+  return [=](xocl::event* ev) {
+    XOCL_DEBUG(std::cout,"launching copy buffer rect event(",ev->get_uid(),")\n");
+    auto command_queue = ev->get_command_queue();
+    auto device = command_queue->get_device();
+    auto xdevice = device->get_xdevice();
+    xdevice->schedule(copy_buffer_rect,async_type::misc,ev,device,src_buffer,dst_buffer,rect);
   };
 }
 
@@ -71,6 +71,20 @@ action_write_image(cl_mem image,const size_t* origin,const size_t* region,size_t
 xocl::event::action_enqueue_type
 action_migrate_memobjects(size_t num, const cl_mem* memobjs, cl_mem_migration_flags flags);
 
+xocl::event::action_enqueue_type
+action_read_buffer_rect(cl_mem buffer,const size_t* buffer_origin,const size_t* host_origin,const size_t* region,
+                        size_t buffer_row_pitch,size_t buffer_slice_pitch,size_t host_row_pitch,size_t host_slice_pitch,
+                        void* ptr);
+
+xocl::event::action_enqueue_type
+action_write_buffer_rect(cl_mem buffer,const size_t* buffer_origin,const size_t* host_origin,const size_t* region,
+                         size_t buffer_row_pitch,size_t buffer_slice_pitch,size_t host_row_pitch,size_t host_slice_pitch,
+                         const void* ptr);
+
+xocl::event::action_enqueue_type
+action_copy_buffer_rect(cl_mem src_buffer,cl_mem dst_buffer,const size_t* src_origin,const size_t* dst_origin,const size_t* region,
+                        size_t src_row_pitch,size_t src_slice_pitch,size_t dst_row_pitch,size_t dst_slice_pitch);
+
 xocl::event::action_enqueue_type
 action_ndrange_execute();
 
@@ -42,6 +42,13 @@ namespace lop {
   std::function<void (unsigned int, bool)> write_cb ;
   std::function<void (unsigned int, bool)> enqueue_cb ;
 
+  static std::atomic<bool> s_loaded {false} ;
+
+  bool loaded()
+  {
+    return s_loaded ;
+  }
+
   void register_functions(void* handle)
   {
     typedef void (*ftype)(const char*, long long int, unsigned long long int) ;
@@ -61,6 +68,8 @@ namespace lop {
 
     enqueue_cb = (btype)(xrt_core::dlsym(handle, "lop_kernel_enqueue")) ;
     if (xrt_core::dlerror() != NULL) enqueue_cb = nullptr ;
+
+    s_loaded = true ;
   }
 
   void warning_function()
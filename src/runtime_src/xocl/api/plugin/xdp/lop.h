@@ -42,6 +42,9 @@ namespace lop {
 
   // A function that outputs any warnings based upon status and configuration
   void warning_function() ;
+
+  // True if the plugin was loaded and its callbacks are registered
+  bool loaded() ;
   
   // Every OpenCL API we are interested in will have an instance
   //  of this class constructed at the start
@@ -67,7 +70,8 @@ namespace xocl {
     inline void
     set_event_action(xocl::event* event, F&& f, Args&&... args)
     {
-      if (xrt_core::config::get_lop_trace())
+      // Save on creating the action if the plugin is not loaded
+      if (xrt_core::config::get_lop_trace() && xdp::lop::loaded())
 	event->set_lop_action(f(std::forward<Args>(args)...));
     }
 
@@ -14,6 +14,7 @@
  * under the License.
  */
 
+#include <atomic>
 #include <functional>
 
 #include "plugin/xdp/profile_counters.h"
@@ -72,6 +73,13 @@ namespace xocl {
                         unsigned long long int)> counter_action_write_cb ;
     std::function<void ()> counter_mark_objects_released_cb ;
 
+    static std::atomic<bool> s_loaded {false} ;
+
+    bool opencl_counters_loaded()
+    {
+      return s_loaded ;
+    }
+
     void register_opencl_counters_functions(void* handle)
     {
       using start_type       = void (*)(const char*,            // Function name
@@ -142,6 +150,8 @@ namespace xocl {
       // For logging counter information for compute unit executions
       xocl::add_command_start_callback(xocl::profile::log_cu_start) ;
       xocl::add_command_done_callback(xocl::profile::log_cu_end) ;
+
+      s_loaded = true ;
     }
     
     void opencl_counters_warning_function()
@@ -25,14 +25,19 @@ namespace xocl {
 
   namespace profile {
 
+    // True if the counters plugin was loaded and its callbacks are registered
+    bool opencl_counters_loaded() ;
+
      namespace counters {
       template<typename F, typename ...Args>
       inline void
       set_event_action(xocl::event* e, F&& f, Args&&... args)
       {
-	if (xrt_core::config::get_opencl_summary() ||
-            xrt_core::config::get_opencl_trace() ||
-            xrt_core::config::get_host_trace())
+        // Save on creating the action if the plugin is not loaded
+	if ((xrt_core::config::get_opencl_summary() ||
+             xrt_core::config::get_opencl_trace() ||
+             xrt_core::config::get_host_trace()) &&
+            opencl_counters_loaded())
 	  e->set_profile_counter_action(f(std::forward<Args>(args)...)) ;
       }
      } // end namespace counters
@@ -14,6 +14,7 @@
  * under the License.
  */
 
+#include <atomic>
 #include <functional>
 
 #include "plugin/xdp/plugin_loader.h"
@@ -76,6 +77,13 @@ namespace opencl_trace {
 		      size_t,
 		      size_t)> ndrange_cb ;
 
+  static std::atomic<bool> s_loaded {false} ;
+
+  bool loaded()
+  {
+    return s_loaded ;
+  }
+
   void register_opencl_trace_functions(void* handle)
   {
     using func_type     = void (*)(const char*, unsigned long long int,
@@ -121,6 +129,8 @@ namespace opencl_trace {
     ndrange_cb =
       reinterpret_cast<ndrange_type>(xrt_core::dlsym(handle, "action_ndrange"));
     if (xrt_core::dlerror() != NULL) ndrange_cb = nullptr ;
+
+    s_loaded = true ;
   }
 
   void opencl_trace_warning_function()
@@ -24,6 +24,9 @@ namespace xdp {
 
 namespace opencl_trace {
   void load() ;
+
+  // True if the plugin was loaded and its callbacks are registered
+  bool loaded() ;
 } // end namespace opencl_trace
 
 namespace device_offload {
@@ -40,8 +43,10 @@ namespace xocl {
     inline void
     set_event_action(xocl::event* e, F&& f, Args&&... args)
     {
-      if (xrt_core::config::get_opencl_trace() ||
-          xrt_core::config::get_host_trace())
+      // Save on creating the action if the plugin is not loaded
+      if ((xrt_core::config::get_opencl_trace() ||
+           xrt_core::config::get_host_trace()) &&
+          xdp::opencl_trace::loaded())
 	e->set_profile_action(f(std::forward<Args>(args)...)) ;
     }
 
@@ -19,6 +19,17 @@
 #include "xocl/config.h"
 #include "rt_printf.h"
 #include "xocl/core/kernel.h"
+#include "xocl/core/device.h"
+#include "xocl/core/memory.h"
+
+#include "core/common/config_reader.h"
+#include "core/common/thread.h"
+#include "core/include/experimental/xrt_bo_fill.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
 
 #ifdef _WIN32
 # pragma warning( disable : 4996 )
@@ -80,5 +91,138 @@ bool isPrintfDebugMode()
   return retval;
 }
 
+/////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Fill printf buffer on device with 0xFF, the value of an empty
+// printf buffer.  Fall back to host fill if device fill fails.
+void fillRingBuffer(xocl::memory* mem, xocl::device* device)
+{
+  auto boh = mem->get_buffer_object(device);
+  const uint8_t empty = 0xFF;
+  try {
+    xrt::fill(boh, &empty, sizeof(empty), mem->get_size(), 0);
+  }
+  catch (const std::exception&) {
+    std::vector<uint8_t> buf(mem->get_size(), empty);
+    boh.write(buf.data(), buf.size(), 0);
+    boh.sync(XCL_BO_SYNC_BO_TO_DEVICE, buf.size(), 0);
+  }
+  mem->set_resident(device);
+}
+
+// Background thread that prints and recycles printf buffers of
+// completed launches in the order the launches completed.
+class RingDrain
+{
+  struct Item
+  {
+    xocl::ptr<xocl::kernel> kernel;
+    xocl::ptr<xocl::memory> mem;
+    xocl::device* device;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::queue<Item> m_items;
+  bool m_stop = false;
+  std::thread m_thread;
+
+  static void drain(Item& item)
+  {
+    auto boh = item.mem->get_buffer_object(item.device);
+    std::vector<uint8_t> buf(item.mem->get_size());
+    boh.sync(XCL_BO_SYNC_BO_FROM_DEVICE, buf.size(), 0);
+    boh.read(buf.data(), buf.size(), 0);
+
+    PrintfManager printfManager;
+    printfManager.enqueueBuffer(item.kernel.get(), buf);
+    if (isPrintfDebugMode()) {
+      std::cout << "printf ring buffer drained\n";
+      printfManager.dbgDump();
+    }
+    printfManager.print();
+
+    fillRingBuffer(item.mem.get(), item.device);
+    item.kernel->release_printf_buffer(std::move(item.mem));
+  }
+
+  // Remaining items are drained before the thread exits so that no
+  // printf output is lost at process exit
+  void run()
+  {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    while (true) {
+      m_work.wait(lk, [this] { return m_stop || !m_items.empty(); });
+      if (m_items.empty())
+        break;
+      auto item = std::move(m_items.front());
+      m_items.pop();
+      lk.unlock();
+      try {
+        drain(item);
+      }
+      catch (const std::exception& ex) {
+        // The buffer is not recycled
+        std::cerr << "printf ring buffer drain failed: " << ex.what() << "\n";
+      }
+      lk.lock();
+    }
+  }
+
+public:
+  RingDrain()
+    : m_thread(xrt_core::thread(&RingDrain::run, this))
+  {}
+
+  ~RingDrain()
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+    }
+    m_work.notify_one();
+    m_thread.join();
+  }
+
+  void push(Item&& item)
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_items.push(std::move(item));
+    }
+    m_work.notify_one();
+  }
+};
+
+// Constructed on first use, which is after the platform, and
+// therefore destructed before the platform at exit
+RingDrain& getRingDrain()
+{
+  static RingDrain drain;
+  return drain;
+}
+
+} // namespace
+
+bool isPrintfRingMode()
+{
+  return xrt_core::config::get_printf_ring_buffer();
+}
+
+void initializeRingBuffer(cl_mem mem, cl_device_id device)
+{
+  auto xmem = xocl::xocl(mem);
+  auto xdevice = xocl::xocl(device);
+  if (!xmem->is_resident(xdevice))
+    fillRingBuffer(xmem, xdevice);
+}
+
+void drainRingBuffer(cl_kernel kernel, cl_mem mem, cl_device_id device)
+{
+  getRingDrain().push({xocl::xocl(kernel), xocl::xocl(mem), xocl::xocl(device)});
+}
+
 } // namespace Printf
 } // namespace XCL
@@ -58,6 +58,25 @@ private:
 bool kernelHasPrintf(cl_kernel kernel);
 bool isPrintfDebugMode();
 
+/////////////////////////////////////////////////////////////////////////
+// PRINTF RING BUFFER MODE (xrt.ini Runtime.printf_ring_buffer)
+//
+// Printf buffers are long lived and recycled across launches of a
+// kernel.  When a launch completes its buffer is handed to a background
+// drain thread that reads it back, prints it, reinitializes it on device,
+// and returns it to the kernel for reuse.  The completion of a launch
+// does not wait for readback and parsing of the printf buffer.
+
+bool isPrintfRingMode();
+
+// Initialize printf buffer on device to known values and make the
+// device copy the valid copy, so that no transfer is needed before
+// kernel execution.  No-op if the buffer is already resident.
+void initializeRingBuffer(cl_mem mem, cl_device_id device);
+
+// Hand the printf buffer of a completed launch to the drain thread
+void drainRingBuffer(cl_kernel kernel, cl_mem mem, cl_device_id device);
+
 /////////////////////////////////////////////////////////////////////////
 
 } // namespace Printf
@@ -0,0 +1,145 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xocl/config.h"
+#include "xocl/core/context.h"
+#include "xocl/core/device.h"
+#include "xocl/core/usm.h"
+#include "xocl/api/detail/context.h"
+#include "xocl/api/detail/device.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+namespace xocl {
+
+static void
+validOrError(cl_context context, cl_device_id device, size_t size)
+{
+  if (!config::api_checks())
+    return;
+
+  detail::context::validOrError(context);
+  if (device) {
+    detail::device::validOrError(device);
+    if (!xocl(context)->has_device(xocl(device)))
+      throw error(CL_INVALID_DEVICE,"device is not in context");
+  }
+  else if (!xocl(context)->get_device_if_one())
+    throw error(CL_INVALID_DEVICE,"device must be specified for context with multiple devices");
+
+  if (!size)
+    throw error(CL_INVALID_BUFFER_SIZE,"size==0");
+}
+
+static void*
+xclMemAlloc(cl_context context, cl_device_id device, size_t size, usm::kind kind)
+{
+  validOrError(context,device,size);
+
+  auto xdevice = device ? xocl(device) : xocl(context)->get_device_if_one();
+  return usm::alloc(xdevice,kind,size);
+}
+
+static cl_int
+xclMemFree(cl_context context, void* ptr)
+{
+  if (config::api_checks())
+    detail::context::validOrError(context);
+
+  if (!ptr)
+    return CL_SUCCESS;
+
+  if (!usm::free(ptr))
+    throw error(CL_INVALID_VALUE,"ptr is not a USM allocation");
+
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+namespace xlnx {
+
+static void*
+xclMemAlloc(cl_context context, cl_device_id device, size_t size,
+            xocl::usm::kind kind, cl_int* errcode_ret)
+{
+  try {
+    auto ptr = xocl::xclMemAlloc(context,device,size,kind);
+    xocl::assign(errcode_ret,CL_SUCCESS);
+    return ptr;
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    xocl::assign(errcode_ret,ex.get_code());
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    xocl::assign(errcode_ret,CL_OUT_OF_RESOURCES);
+  }
+  return nullptr;
+}
+
+static cl_int
+xclMemFree(cl_context context, void* ptr)
+{
+  try {
+    return xocl::xclMemFree(context,ptr);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
+
+} // xlnx
+
+void*
+xclHostMemAlloc(cl_context context,
+                cl_device_id device,
+                size_t size,
+                cl_int* errcode_ret)
+{
+  return xlnx::xclMemAlloc(context,device,size,xocl::usm::kind::host,errcode_ret);
+}
+
+void*
+xclDeviceMemAlloc(cl_context context,
+                  cl_device_id device,
+                  size_t size,
+                  cl_int* errcode_ret)
+{
+  return xlnx::xclMemAlloc(context,device,size,xocl::usm::kind::device,errcode_ret);
+}
+
+void*
+xclSharedMemAlloc(cl_context context,
+                  cl_device_id device,
+                  size_t size,
+                  cl_int* errcode_ret)
+{
+  return xlnx::xclMemAlloc(context,device,size,xocl::usm::kind::shared,errcode_ret);
+}
+
+cl_int
+xclMemFree(cl_context context,
+           void* ptr)
+{
+  return xlnx::xclMemFree(context,ptr);
+}
@@ -87,16 +87,37 @@ queue(event* ev)
   }
 
   if (ooo) {
-    for (auto b: m_barriers) {
+    // A barrier depends on the previous barrier, so chaining to the
+    // most recent barrier orders this event after all of them.
+    if (!m_barriers.empty()) {
+      auto b = m_barriers.back();
       b->chain(ev);
       xocl::profile::log_dependency(ev->get_uid(), b->get_uid()) ;
     }
 
-    if (ev->get_command_type()==CL_COMMAND_BARRIER)
+    // Barriers and markers with empty wait list depend on all events
+    // enqueued since the most recent barrier
+    if (ev->get_wait_all()) {
+      for (auto e : m_since_barrier) {
+        e->chain(ev);
+        xocl::profile::log_dependency(ev->get_uid(), e->get_uid()) ;
+      }
+    }
+
+    if (ev->get_command_type()==CL_COMMAND_BARRIER) {
       m_barriers.push_back(ev);
+      if (ev->get_wait_all())
+        m_since_barrier.clear();
+      else
+        m_since_barrier.insert(ev);
+    }
+    else
+      m_since_barrier.insert(ev);
   }
 
   m_events.insert(ev);
+  ev->m_queue_seq = ++m_queue_seq;
+  m_pending_seq.insert(ev->m_queue_seq);
   m_last_queued_event = ev;
   ev->retain();
 
@@ -141,6 +162,7 @@ remove(event* ev)
   if (it==m_events.end())
     throw xocl::error(CL_INVALID_EVENT,"event " + ev->get_suid() + " never submitted");
   m_events.erase(it);
+  m_since_barrier.erase(ev);
   if (m_last_queued_event==ev)
     m_last_queued_event = nullptr;
 
@@ -150,8 +172,13 @@ remove(event* ev)
     m_barriers.erase(bit);
   }
 
+  // notify if oldest pending event is complete and waited for
+  bool oldest = (*m_pending_seq.begin() == ev->m_queue_seq);
+  m_pending_seq.erase(ev->m_queue_seq);
+
   ev->release();
-  if (m_events.empty())
+  if (m_events.empty()
+      || (oldest && !m_wait_epochs.empty() && *m_pending_seq.begin() > *m_wait_epochs.begin()))
     m_has_events.notify_all();
 
 #if 0
@@ -173,14 +200,29 @@ abort(event* ev,bool)
   return remove(ev);
 }
 
+// Wait for events queued before this call.  Events queued while
+// waiting, possibly by other threads, are not waited for.
+void
+command_queue::
+wait_epoch(std::unique_lock<std::mutex>& lk) const
+{
+  auto epoch = m_queue_seq;
+  auto done = [this, epoch] { return m_pending_seq.empty() || *m_pending_seq.begin() > epoch; };
+  if (done())
+    return;
+
+  auto itr = m_wait_epochs.insert(epoch);
+  m_has_events.wait(lk, done);
+  m_wait_epochs.erase(itr);
+}
+
 void
 command_queue::
 wait() const
 {
   XOCL_DEBUG(std::cout,"xocl::command_queue::wait(",m_uid,")\n");
   std::unique_lock<std::mutex> lk(m_events_mutex);
-  while (m_events.size())
-    m_has_events.wait(lk);
+  wait_epoch(lk);
 }
 
 void
@@ -189,8 +231,7 @@ flush() const
 {
   XOCL_DEBUG(std::cout,"xocl::command_queue::flush(",m_uid,")\n");
   std::unique_lock<std::mutex> lk(m_events_mutex);
-  while (m_events.size())
-    m_has_events.wait(lk);
+  wait_epoch(lk);
 }
 
 command_queue::queue_lock
@@ -205,6 +205,17 @@ private:
   mutable std::condition_variable m_has_events;
   event_queue_type m_events;
   std::vector<event*> m_barriers;
+  event_queue_type m_since_barrier;  // ooo events queued after last wait-all barrier
+
+  // Queue order of events not yet complete.  wait() returns when all
+  // events queued before the call are complete, waiters record their
+  // epoch so that completions before it are not notified
+  uint64_t m_queue_seq = 0;
+  std::set<uint64_t> m_pending_seq;
+  mutable std::multiset<uint64_t> m_wait_epochs;
+
+  void
+  wait_epoch(std::unique_lock<std::mutex>& lk) const;
   ptr<event> m_last_queued_event;
   property_type m_props;
 };
@@ -29,6 +29,7 @@
 #include "core/common/device.h"
 #include "core/common/query_requests.h"
 #include "core/common/xclbin_parser.h"
+#include "core/include/experimental/xrt_bo_fill.h"
 
 #include <iostream>
 #include <fstream>
@@ -509,7 +510,8 @@ map_buffer(memory* buffer, cl_map_flags map_flags, size_t offset, size_t size, v
 
   // If buffer is resident it must be refreshed unless CL_MAP_INVALIDATE_REGION
   // is specified in which case host will discard current content
-  if (!nosync && !(map_flags & CL_MAP_WRITE_INVALIDATE_REGION) && buffer->is_resident(this) && !buffer->no_host_memory()) {
+  if (!nosync && !(map_flags & CL_MAP_WRITE_INVALIDATE_REGION) && buffer->is_resident(this)
+      && !buffer->no_host_memory() && !is_host_coherent(buffer)) {
     boh = buffer->get_buffer_object_or_error(this);
     m_xdevice->sync(boh,size,offset,xrt_xocl::hal::device::direction::DEVICE2HOST,false);
   }
@@ -572,8 +574,9 @@ unmap_buffer(memory* buffer, void* mapped_ptr)
 
   auto boh = buffer->get_buffer_object_or_error(this);
 
-  // Sync data to boh if write flags, and sync to device if resident
-  if (flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION)) {
+  // Sync data to boh if write flags, and sync to device if resident.
+  // Host coherent buffers were written in place by the host.
+  if ((flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION)) && !is_host_coherent(buffer)) {
     if (auto ubuf = static_cast<char*>(buffer->get_host_ptr()))
       m_xdevice->write(boh,ubuf+offset,size,offset,false);
     if (buffer->is_resident(this) && !buffer->no_host_memory())
@@ -581,6 +584,29 @@ unmap_buffer(memory* buffer, void* mapped_ptr)
   }
 }
 
+bool
+device::
+is_host_coherent(const memory* buffer) const
+{
+  if (buffer->no_host_memory())
+    return false;
+
+  auto boh = buffer->get_buffer_object_or_null(this);
+  if (!boh)
+    return false;
+
+  // An unaligned user pointer is shadowed by the buffer object and
+  // must be copied on map and unmap
+  auto ubuf = buffer->get_host_ptr();
+  if (ubuf && (!is_aligned_ptr(ubuf) || buffer->need_extra_sync()))
+    return false;
+
+  if (buffer->is_host_only())
+    return true;
+
+  return get_boh_banktag(boh).compare(0,4,"HOST")==0;
+}
+
 void
 device::
 migrate_buffer(memory* buffer,cl_mem_migration_flags flags)
@@ -680,6 +706,23 @@ device::
 fill_buffer(memory* buffer, const void* pattern, size_t pattern_size, size_t offset, size_t size)
 {
   auto boh = xocl::xocl(buffer)->get_buffer_object(this);
+
+  // Fill on device if possible, only a seed of the pattern is
+  // transferred and the remainder is filled by device side copies.
+  // The device copy of the buffer is then the valid copy, which
+  // requires that it is valid already outside the filled range.
+  bool whole = (offset == 0 && size == buffer->get_size());
+  if (size % pattern_size == 0 && (whole || buffer->is_resident(this))) {
+    try {
+      xrt::fill(boh, pattern, pattern_size, size, offset);
+      buffer->set_resident(this);
+      return;
+    }
+    catch (const std::exception& ex) {
+      XOCL_DEBUG(std::cout,"fill_buffer reverting to host fill (",ex.what(),")\n");
+    }
+  }
+
   char* hbuf = static_cast<char*>(map_buffer(buffer,CL_MAP_WRITE_INVALIDATE_REGION,offset,size,nullptr));
   char* dst = hbuf;
   for (; pattern_size <= size; size-=pattern_size, dst+=pattern_size)
@@ -689,6 +732,103 @@ fill_buffer(memory* buffer, const void* pattern, size_t pattern_size, size_t off
   unmap_buffer(buffer,hbuf);
 }
 
+// Rows of a buffer rectangle with the offset of each row in the
+// source and destination.  Rows that are contiguous in both source and
+// destination are merged into one range.
+struct rect_range
+{
+  size_t src_offset;
+  size_t dst_offset;
+  size_t size;
+};
+
+static std::vector<rect_range>
+get_rect_ranges(const size_t* src_origin, const size_t* dst_origin, const size_t* region,
+                size_t src_row_pitch, size_t src_slice_pitch,
+                size_t dst_row_pitch, size_t dst_slice_pitch)
+{
+  std::vector<rect_range> ranges;
+  size_t src_base = src_origin[2]*src_slice_pitch + src_origin[1]*src_row_pitch + src_origin[0];
+  size_t dst_base = dst_origin[2]*dst_slice_pitch + dst_origin[1]*dst_row_pitch + dst_origin[0];
+  for (size_t z=0; z<region[2]; ++z) {
+    for (size_t y=0; y<region[1]; ++y) {
+      size_t src = src_base + z*src_slice_pitch + y*src_row_pitch;
+      size_t dst = dst_base + z*dst_slice_pitch + y*dst_row_pitch;
+      if (!ranges.empty()) {
+        auto& last = ranges.back();
+        if (last.src_offset + last.size == src && last.dst_offset + last.size == dst) {
+          last.size += region[0];
+          continue;
+        }
+      }
+      ranges.push_back({src, dst, region[0]});
+    }
+  }
+  return ranges;
+}
+
+void
+device::
+write_buffer_rect(memory* buffer, const size_t* buffer_origin, const size_t* host_origin, const size_t* region,
+                  size_t buffer_row_pitch, size_t buffer_slice_pitch,
+                  size_t host_row_pitch, size_t host_slice_pitch, const void* ptr)
+{
+  auto boh = buffer->get_buffer_object(this);
+  auto ranges = get_rect_ranges(host_origin, buffer_origin, region,
+                                host_row_pitch, host_slice_pitch, buffer_row_pitch, buffer_slice_pitch);
+
+  // Only the rows of the rectangle can be synced to device, the rest
+  // of the host side buffer may be stale
+  bool sync = buffer->is_resident(this) && !buffer->no_host_memory();
+  auto src = static_cast<const char*>(ptr);
+  for (auto& range : ranges) {
+    m_xdevice->write(boh,src+range.src_offset,range.size,range.dst_offset,false);
+    sync_to_ubuf(buffer,range.dst_offset,range.size,m_xdevice,boh);
+    if (sync)
+      m_xdevice->sync(boh,range.size,range.dst_offset,xrt_xocl::hal::device::direction::HOST2DEVICE,false);
+  }
+}
+
+void
+device::
+read_buffer_rect(memory* buffer, const size_t* buffer_origin, const size_t* host_origin, const size_t* region,
+                 size_t buffer_row_pitch, size_t buffer_slice_pitch,
+                 size_t host_row_pitch, size_t host_slice_pitch, void* ptr)
+{
+  auto boh = buffer->get_buffer_object(this);
+  auto ranges = get_rect_ranges(buffer_origin, host_origin, region,
+                                buffer_row_pitch, buffer_slice_pitch, host_row_pitch, host_slice_pitch);
+  if (ranges.empty())
+    return;
+
+  // Device is authoritative for resident buffers, so syncing the
+  // span between rows is harmless and one transfer is cheaper than
+  // one per row
+  if (buffer->is_resident(this) && !buffer->no_host_memory()) {
+    auto begin = ranges.front().src_offset;
+    auto end = ranges.back().src_offset + ranges.back().size;
+    m_xdevice->sync(boh,end-begin,begin,xrt_xocl::hal::device::direction::DEVICE2HOST,false);
+  }
+
+  auto dst = static_cast<char*>(ptr);
+  for (auto& range : ranges) {
+    m_xdevice->read(boh,dst+range.dst_offset,range.size,range.src_offset,false);
+    sync_to_ubuf(buffer,range.src_offset,range.size,m_xdevice,boh);
+  }
+}
+
+void
+device::
+copy_buffer_rect(memory* src_buffer, memory* dst_buffer, const size_t* src_origin, const size_t* dst_origin,
+                 const size_t* region, size_t src_row_pitch, size_t src_slice_pitch,
+                 size_t dst_row_pitch, size_t dst_slice_pitch)
+{
+  auto ranges = get_rect_ranges(src_origin, dst_origin, region,
+                                src_row_pitch, src_slice_pitch, dst_row_pitch, dst_slice_pitch);
+  for (auto& range : ranges)
+    copy_buffer(src_buffer,dst_buffer,range.src_offset,range.dst_offset,range.size);
+}
+
 static void
 rw_image(device* device,
          memory* image,const size_t* origin,const size_t* region,size_t row_pitch,size_t slice_pitch
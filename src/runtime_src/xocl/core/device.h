@@ -334,6 +334,20 @@ public:
   void
   unmap_buffer(memory* mem, void* mapped_ptr);
 
+  /**
+   * Check if map and unmap of buffer need no data movement
+   *
+   * This is the case when the mapped host pointer is the buffer
+   * object itself and the buffer object is allocated in host memory,
+   * e.g. XCL_MEM_EXT_HOST_ONLY or a HOST bank.  The buffer object
+   * must have been allocated on this device.
+   *
+   * @return
+   *   true if mapped host memory is coherent with buffer object
+   */
+  bool
+  is_host_coherent(const memory* mem) const;
+
   /**
    * Migrate buffer to this device (clEnqueueMigrateMemObjects)
    *
@@ -413,6 +427,52 @@ public:
   void
   fill_buffer(memory* buffer, const void* pattern, size_t pattern_size, size_t offset, size_t size);
 
+  /**
+   * Write a 2D or 3D rectangle to buffer (clEnqueueWriteBufferRect)
+   *
+   * @param buffer
+   *  Buffer to write to.  Only the rows of the rectangle are synced
+   *  to device, and only if the buffer is resident on the device.
+   * @param buffer_origin
+   *  Origin of rectangle in buffer, in bytes, rows, and slices
+   * @param host_origin
+   *  Origin of rectangle in host memory
+   * @param region
+   *  Size of rectangle, in bytes, rows, and slices
+   * @param data
+   *  The host memory to write from
+   *
+   * Rows that are contiguous in both buffer and host memory are
+   * written and synced as one range.
+   */
+  void
+  write_buffer_rect(memory* buffer, const size_t* buffer_origin, const size_t* host_origin, const size_t* region,
+                    size_t buffer_row_pitch, size_t buffer_slice_pitch,
+                    size_t host_row_pitch, size_t host_slice_pitch, const void* data);
+
+  /**
+   * Read a 2D or 3D rectangle from buffer (clEnqueueReadBufferRect)
+   *
+   * If the buffer is resident on device, the span of buffer covered
+   * by the rectangle is synced from device in one transfer before
+   * the rows are read.
+   */
+  void
+  read_buffer_rect(memory* buffer, const size_t* buffer_origin, const size_t* host_origin, const size_t* region,
+                   size_t buffer_row_pitch, size_t buffer_slice_pitch,
+                   size_t host_row_pitch, size_t host_slice_pitch, void* data);
+
+  /**
+   * Copy a 2D or 3D rectangle between buffers (clEnqueueCopyBufferRect)
+   *
+   * The rows are copied by device, see copy_buffer(), there is no
+   * round trip through host memory.
+   */
+  void
+  copy_buffer_rect(memory* src_buffer, memory* dst_buffer, const size_t* src_origin, const size_t* dst_origin,
+                   const size_t* region, size_t src_row_pitch, size_t src_slice_pitch,
+                   size_t dst_row_pitch, size_t dst_slice_pitch);
+
   void
   write_image(memory* image,const size_t* origin,const size_t* region,size_t row_pitch,size_t slice_pitch,const void *ptr);
 
@@ -53,6 +53,72 @@ to_string(cl_int status)
 
 static xocl::event::event_callback_list sg_constructor_callbacks;
 static xocl::event::event_callback_list sg_destructor_callbacks;
+
+// Recycled memory of deleted event objects.  Events are allocated
+// in the host thread and mostly deleted in the thread that completes
+// them, so the free lists are shared between threads.  Event types
+// differ in size, there is one free list per 64 byte size class.
+class event_pool
+{
+  static constexpr size_t granularity = 64;
+  static constexpr size_t max_classes = 8;    // events up to 512 bytes
+  static constexpr size_t max_blocks = 1024;  // per size class
+
+  std::mutex m_mutex;
+  std::vector<void*> m_free[max_classes];
+
+  static size_t
+  size_class(size_t sz)
+  {
+    return (sz + granularity - 1) / granularity - 1;
+  }
+
+public:
+  void*
+  alloc(size_t sz)
+  {
+    auto sc = size_class(sz);
+    if (sc >= max_classes)
+      return ::operator new(sz);
+
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      auto& free = m_free[sc];
+      if (!free.empty()) {
+        auto ptr = free.back();
+        free.pop_back();
+        return ptr;
+      }
+    }
+
+    return ::operator new((sc + 1) * granularity);
+  }
+
+  void
+  free(void* ptr, size_t sz)
+  {
+    auto sc = size_class(sz);
+    if (sc < max_classes) {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      auto& free = m_free[sc];
+      if (free.size() < max_blocks) {
+        free.push_back(ptr);
+        return;
+      }
+    }
+
+    ::operator delete(ptr);
+  }
+};
+
+// Not destructed, events may be deleted during static destruction
+static event_pool*
+get_event_pool()
+{
+  static auto pool = new event_pool;
+  return pool;
+}
+
 } // namespace
 
 namespace xocl {
@@ -91,6 +157,20 @@ event::
     cb(this);
 }
 
+void*
+event::
+operator new(size_t sz)
+{
+  return get_event_pool()->alloc(sz);
+}
+
+void
+event::
+operator delete(void* ptr, size_t sz)
+{
+  get_event_pool()->free(ptr, sz);
+}
+
 cl_int
 event::
 set_status(cl_int s)
@@ -137,6 +217,10 @@ set_status(cl_int s)
     run_callbacks(CL_COMPLETE);
 
     m_event_complete.notify_all();
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      notify_waiters_nolock();
+    }
 
     // remove the completed event from queue (submitted queue)
     // before event_scheduler attempts to submit next event.
@@ -238,6 +322,7 @@ abort(cl_int status,bool fatal)
       abort_ev->m_status = status;  // abort ev
       abort_ev->queue_abort(fatal); // remove from queue if any
       m_event_complete.notify_all();
+      notify_waiters_nolock();
     }
     else if (abort_ev!=this) {
       // recursively abort event that depends on this
@@ -263,6 +348,50 @@ wait() const
     m_event_complete.wait(lk);
 }
 
+void
+event::
+wait_all(const std::vector<event*>& events)
+{
+  if (events.size() < 2) {
+    for (auto ev : events)
+      ev->wait();
+    return;
+  }
+
+  // Count events that are already done, these are not registered
+  // with the waiter.  The pending count is not adjusted until all
+  // events are processed, so it cannot reach zero prematurely.
+  completion_waiter waiter;
+  waiter.pending = events.size();
+  size_t done = 0;
+  for (auto ev : events) {
+    std::lock_guard<std::mutex> lk(ev->m_mutex);
+    if (ev->m_status <= 0)  // (<0 => aborted) (==0 => CL_COMPLETE)
+      ++done;
+    else
+      ev->m_waiters.push_back(&waiter);
+  }
+
+  std::unique_lock<std::mutex> lk(waiter.mutex);
+  waiter.pending -= done;
+  waiter.done.wait(lk, [&waiter] { return waiter.pending == 0; });
+}
+
+// The waiter is notified while its mutex is held, so the waiter, which
+// lives on the waiting thread's stack, cannot go away before this
+// function is done with it.
+void
+event::
+notify_waiters_nolock()
+{
+  for (auto waiter : m_waiters) {
+    std::lock_guard<std::mutex> lk(waiter->mutex);
+    if (--waiter->pending == 0)
+      waiter->done.notify_all();
+  }
+  m_waiters.clear();
+}
+
 void
 event::
 add_callback(callback_function_type fcn)
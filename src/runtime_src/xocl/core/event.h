@@ -27,12 +27,163 @@
 
 #include "xrt/config.h"
 
-#include <vector>
+#include <cstddef>
 #include <functional>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <vector>
 
 namespace xocl {
 
+/**
+ * Move only callable with inline storage
+ *
+ * Enqueue actions are lambdas that capture a few arguments of the
+ * enqueue API call.  The lambda is stored inline in the event object
+ * rather than allocated by std::function.  Callables that do not fit
+ * are allocated.
+ */
+template <typename ...Args>
+class inline_action
+{
+  struct iholder
+  {
+    virtual ~iholder() {}
+    virtual void call(Args... args) = 0;
+    virtual iholder* move_to(void* storage) = 0;
+  };
+
+  template <typename Callable>
+  struct holder : iholder
+  {
+    Callable m_held;
+
+    holder(Callable&& c)
+      : m_held(std::move(c))
+    {}
+
+    holder(const Callable& c)
+      : m_held(c)
+    {}
+
+    void call(Args... args)
+    {
+      m_held(args...);
+    }
+
+    iholder* move_to(void* storage)
+    {
+      return new (storage) holder(std::move(m_held));
+    }
+  };
+
+  // Room for holder of a lambda capturing up to seven pointer size values
+  static constexpr size_t inline_size = 8 * sizeof(void*);
+  alignas(std::max_align_t) unsigned char m_storage[inline_size];
+  iholder* m_content = nullptr;
+
+  template <typename Holder>
+  static constexpr bool
+  fits_inline()
+  {
+    return sizeof(Holder) <= inline_size
+      && alignof(Holder) <= alignof(std::max_align_t)
+      && std::is_nothrow_move_constructible<Holder>::value;
+  }
+
+  bool
+  is_inline() const
+  {
+    return static_cast<const void*>(m_content) == static_cast<const void*>(m_storage);
+  }
+
+  void
+  reset()
+  {
+    if (is_inline())
+      m_content->~iholder();
+    else
+      delete m_content;
+    m_content = nullptr;
+  }
+
+  template <typename Holder, typename Callable>
+  iholder*
+  make_holder(Callable&& c, std::true_type)
+  {
+    return new (m_storage) Holder(std::forward<Callable>(c));
+  }
+
+  template <typename Holder, typename Callable>
+  iholder*
+  make_holder(Callable&& c, std::false_type)
+  {
+    return new Holder(std::forward<Callable>(c));
+  }
+
+  void
+  take(inline_action& rhs)
+  {
+    if (rhs.is_inline()) {
+      m_content = rhs.m_content->move_to(m_storage);
+      rhs.reset();
+    }
+    else {
+      m_content = rhs.m_content;
+      rhs.m_content = nullptr;
+    }
+  }
+
+public:
+  inline_action()
+  {}
+
+  inline_action(std::nullptr_t)
+  {}
+
+  template <typename Callable,
+            typename = std::enable_if_t<!std::is_same<std::decay_t<Callable>, inline_action>::value>>
+  inline_action(Callable&& c)
+  {
+    using holder_type = holder<std::decay_t<Callable>>;
+    m_content = make_holder<holder_type>
+      (std::forward<Callable>(c), std::integral_constant<bool, fits_inline<holder_type>()>{});
+  }
+
+  inline_action(inline_action&& rhs)
+  {
+    take(rhs);
+  }
+
+  ~inline_action()
+  {
+    reset();
+  }
+
+  inline_action&
+  operator=(inline_action&& rhs)
+  {
+    if (this != &rhs) {
+      reset();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  explicit
+  operator bool() const
+  {
+    return m_content != nullptr;
+  }
+
+  void
+  operator() (Args... args)
+  {
+    m_content->call(args...);
+  }
+};
+
 /**
  * The event class consists of a base event class and a
  * derived event_with_wait_list class.
@@ -56,7 +207,7 @@ public:
   using event_callback_type = std::function<void(event*)>;
   using event_callback_list = std::vector<event_callback_type>;
 
-  using action_enqueue_type = std::function<void (event*)>;
+  using action_enqueue_type = inline_action<event*>;
   using action_profile_type = std::function<void (event*, cl_int)>;
   using action_debug_type = std::function<void (event*)>;
   using action_lop_type = std::function<void (event*, cl_int)>;
@@ -65,6 +216,15 @@ public:
   event(command_queue* cq, context* ctx, cl_command_type cmd, cl_uint num_deps, const cl_event* deps);
   virtual ~event();
 
+  // Event objects are allocated from a recycling pool, one is
+  // created for every enqueued command.  The size is that of the
+  // most derived event type.
+  static void*
+  operator new(size_t sz);
+
+  static void
+  operator delete(void* ptr, size_t sz);
+
   /**
    */
   unsigned int
@@ -269,6 +429,32 @@ public:
     m_command_type = ct;
   }
 
+  /**
+   * Mark this event as depending on all commands previously enqueued
+   * in its command queue.
+   *
+   * Used for barriers and markers with an empty wait list.  The
+   * dependencies are added by the command queue when the event is
+   * queued, so callers do not have to scan the queued events.
+   *
+   * Pre-condition (unchecked): Event is not yet queued
+   */
+  void
+  set_wait_all()
+  {
+    m_wait_all = true;
+  }
+
+  /**
+   * @return
+   *   true if this event depends on all previously enqueued commands
+   */
+  bool
+  get_wait_all() const
+  {
+    return m_wait_all;
+  }
+
   /**
    * Hook for overriding the autmatic time setting of
    * a profiling event.
@@ -333,6 +519,16 @@ public:
   void
   wait() const;
 
+  /**
+   * Wait for all events to complete
+   *
+   * The calling thread registers one aggregate waiter with the events
+   * and is woken once when the last event completes, rather than once
+   * per event.
+   */
+  static void
+  wait_all(const std::vector<event*>& events);
+
   /**
    * If a profiling event, then support return requested values
    *
@@ -547,8 +743,25 @@ private:
 
   cl_int m_status = -1;
   cl_command_type m_command_type = 0;
+  bool m_wait_all = false;
+  uint64_t m_queue_seq = 0;   // queue order in command queue
   mutable std::mutex m_mutex;
   mutable std::condition_variable m_event_complete;
+
+  // Aggregate waiter for multiple events, see wait_all()
+  struct completion_waiter
+  {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pending = 0;
+  };
+
+  // Waiters to notify when this event completes or is aborted.
+  // Protected by m_mutex.
+  std::vector<completion_waiter*> m_waiters;
+
+  void
+  notify_waiters_nolock();
   mutable std::condition_variable m_event_submitted;
 
   // List of callback functions. On heap to avoid
@@ -76,6 +76,30 @@ set_global_arg_at_index(xrt::run& run, size_t argidx, const xocl::memory* mem)
   run.set_arg(argidx, xbo);
 }
 
+xrt::run
+execution_context::
+acquire_run()
+{
+  m_runs.push_back(m_kernel->acquire_run(m_device));
+  auto& crun = m_runs.back();
+
+  // populate run object with global kernel arguments
+  size_t argidx = 0;
+  for (auto& arg : m_kernel->get_indexed_xargument_range()) {
+    auto mem = arg->get_memory_object();
+    if (mem && crun.mem_uids[argidx] != mem->get_uid()) {
+      set_global_arg_at_index(crun.run, argidx, mem);
+      crun.mem_uids[argidx] = mem->get_uid();
+    }
+    ++argidx;
+  }
+
+  // the callback identifies the run object by its run_impl, which
+  // remains valid as long as some run refers to it.
+  crun.run.add_callback(ERT_CMD_STATE_COMPLETED, run_done, this);
+  return crun.run;
+}
+
 void
 execution_context::
 set_rtinfo_printf(xrt::run& run, size_t arginfo_idx, const xocl::memory* printf_buffer)
@@ -189,9 +213,6 @@ execution_context(device* device
   , m_event(event)
   , m_kernel(kd)
   , m_device(device)
-    // cloning could potentially be managed in xocl::kernel
-    // such that run behaves as copy-on-write if usecount>1
-  , m_run(xrt_core::kernel_int::clone(kd->get_xrt_run(device)))
 {
   static unsigned int count = 0;
   m_uid = count++;
@@ -201,15 +222,8 @@ execution_context(device* device
   std::copy(global_work_size,global_work_size+work_dim,m_gsize.begin());
   std::copy(local_work_size,local_work_size+work_dim,m_lsize.begin());
 
-  m_run.add_callback(ERT_CMD_STATE_COMPLETED, run_done, this);
-
-  // populate run object with global kernel arguments
-  size_t argidx = 0;
-  for (auto& arg : m_kernel->get_indexed_xargument_range()) {
-    if (auto mem = arg->get_memory_object())
-      set_global_arg_at_index(m_run, argidx, mem);
-    ++argidx;
-  }
+  // Run objects are recycled by the kernel across executions
+  m_run = acquire_run();
 
   m_num_cus = xrt_core::kernel_int::get_num_cus(m_run);
   m_control = xrt_core::kernel_int::get_control_protocol(m_run);
@@ -221,26 +235,18 @@ execution_context::
 ~execution_context()
 {
   XOCL_DEBUGF("execution_context::~execution_context(%d) for kernel(%s)\n",m_uid,m_kernel->get_name().c_str());
-  xrt_core::kernel_int::pop_callback(m_run);
+  for (auto& crun : m_runs) {
+    xrt_core::kernel_int::pop_callback(crun.run);
+    m_kernel->release_run(m_device, std::move(crun));
+  }
 }
 
 xrt::run
 execution_context::
 get_free_run()
 {
-  if (m_freeruns.empty()) {
-    auto run = xrt_core::kernel_int::clone(m_run);
-    // the callback must be able to identify the run object
-    // but run objects are transient, so use run_impl, which
-    // remains valid as long as some run refers to it.  The
-    // callback may not retain the handle as it would prevent
-    // deletion unless callback was removed
-    auto handle = run.get_handle();
-
-    
-    run.add_callback(ERT_CMD_STATE_COMPLETED, run_done, this);
-    return run;
-  }
+  if (m_freeruns.empty())
+    return acquire_run();
     
   auto run = m_freeruns.back();
   m_freeruns.pop_back();
@@ -92,6 +92,10 @@ private:
   // The kernel run object to be started and managed by this context
   xrt::run m_run;
 
+  // Run objects acquired from the kernel run cache, returned to the
+  // cache when this context is deleted
+  std::vector<kernel::cached_run> m_runs;
+
   // For work-group reuse
   std::vector<xrt::run> m_freeruns;
 
@@ -112,6 +116,11 @@ private:
   void
   set_global_arg_at_index(xrt::run&, size_t index, const xocl::memory* mem);
 
+  // Acquire run object from kernel run cache and set global
+  // arguments that differ from its previous use
+  xrt::run
+  acquire_run();
+
   // Set printf specific argument on xrt::run object
   void
   set_rtinfo_printf(xrt::run&, size_t index, const xocl::memory*);
@@ -19,6 +19,7 @@
 #include "context.h"
 #include "device.h"
 #include "compute_unit.h"
+#include "usm.h"
 
 #include "core/common/api/kernel_int.h"
 #include "core/common/api/xclbin_int.h"
@@ -117,6 +118,16 @@ set_svm(const void* cvalue, size_t sz)
 {
   if (sz != sizeof(void*))
     throw error(CL_INVALID_ARG_SIZE,"Invalid global_argument size for svm kernel arg");
+
+  // Pointers into USM allocations are passed as device address
+  size_t offset = 0;
+  if (auto bo = usm::lookup(cvalue, &offset)) {
+    uint64_t addr = bo.address() + offset;
+    m_kernel->set_run_arg_at_index(m_arginfo->index, &addr, sizeof(addr));
+    m_set = true;
+    return;
+  }
+
   m_kernel->set_run_arg_at_index(m_arginfo->index, cvalue, sz);
   m_set = true;
 }
@@ -251,10 +262,56 @@ void
 kernel::
 set_run_arg_at_index(unsigned long idx, const void* cvalue, size_t sz)
 {
+  std::lock_guard<std::mutex> lk(m_run_mutex);
   for (const auto& v : m_xruns) {
     auto& run = v.second.xrun;
     xrt_core::kernel_int::set_arg_at_index(run, idx, cvalue, sz);
   }
+
+  auto& arg = m_run_args[idx];
+  arg.generation = ++m_run_arg_generation;
+  arg.value.assign(static_cast<const char*>(cvalue), static_cast<const char*>(cvalue) + sz);
+}
+
+kernel::cached_run
+kernel::
+acquire_run(const device* device)
+{
+  std::lock_guard<std::mutex> lk(m_run_mutex);
+  auto& cache = m_run_cache[device];
+  if (cache.empty()) {
+    cached_run crun;
+    crun.run = xrt_core::kernel_int::clone(get_xrt_run(device));
+    crun.generation = m_run_arg_generation;
+    crun.mem_uids.assign(m_indexed_xargs.size(), cached_run::no_memory);
+    return crun;
+  }
+
+  auto crun = std::move(cache.back());
+  cache.pop_back();
+
+  // Update scalar arguments changed since the run was last used
+  if (crun.generation != m_run_arg_generation) {
+    for (const auto& arg : m_run_args)
+      if (arg.second.generation > crun.generation)
+        xrt_core::kernel_int::set_arg_at_index(crun.run, arg.first, arg.second.value.data(), arg.second.value.size());
+    crun.generation = m_run_arg_generation;
+  }
+
+  return crun;
+}
+
+void
+kernel::
+release_run(const device* device, cached_run&& crun)
+{
+  // Bound the number of cached runs per device, excess runs are
+  // released when the last reference goes away
+  constexpr size_t max_cached_runs = 128;
+  std::lock_guard<std::mutex> lk(m_run_mutex);
+  auto& cache = m_run_cache[device];
+  if (cache.size() < max_cached_runs)
+    cache.push_back(std::move(crun));
 }
 
 void
@@ -278,6 +335,28 @@ set_printf_argument(size_t sz, const void* cvalue)
   m_printf_xargs.at(0)->set(cvalue, sz);
 }
 
+ptr<memory>
+kernel::
+acquire_printf_buffer(size_t sz)
+{
+  std::lock_guard<std::mutex> lk(m_printf_mutex);
+  auto itr = std::find_if(m_printf_buffers.begin(), m_printf_buffers.end(),
+                          [sz](auto& mem) { return mem->get_size() >= sz; });
+  if (itr == m_printf_buffers.end())
+    return nullptr;
+  auto mem = std::move(*itr);
+  m_printf_buffers.erase(itr);
+  return mem;
+}
+
+void
+kernel::
+release_printf_buffer(ptr<memory> mem)
+{
+  std::lock_guard<std::mutex> lk(m_printf_mutex);
+  m_printf_buffers.push_back(std::move(mem));
+}
+
 const xrt_core::xclbin::kernel_argument*
 kernel::
 get_arg_info(unsigned long idx) const
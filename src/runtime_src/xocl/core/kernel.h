@@ -27,6 +27,9 @@
 
 #include "xrt/util/td.h"
 #include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #include <iostream>
 
@@ -261,6 +264,15 @@ public:
   void
   set_printf_argument(size_t sz, const void* arg);
 
+  // Get an idle recycled printf buffer of at least sz bytes, or
+  // nullptr if none.  Used in printf ring buffer mode only.
+  ptr<memory>
+  acquire_printf_buffer(size_t sz);
+
+  // Return a printf buffer for reuse by later launches
+  void
+  release_printf_buffer(ptr<memory> mem);
+
   // Get argument info meta data for specified argument
   const xrt_core::xclbin::kernel_argument*
   get_arg_info(unsigned long idx) const;
@@ -318,6 +330,31 @@ public:
   const xrt::run&
   get_xrt_run(const device* device = nullptr) const;
 
+  // Run object recycled across kernel executions.  The run carries
+  // the argument values of its previous execution, the generation
+  // and memory object uids record what those values are so that only
+  // changed arguments are set before the run is reused.
+  struct cached_run
+  {
+    static constexpr unsigned int no_memory = std::numeric_limits<unsigned int>::max();
+
+    xrt::run run;
+    uint64_t generation = 0;              // scalar argument generation of run
+    std::vector<unsigned int> mem_uids;   // memory object uid per indexed argument
+  };
+
+  // Get a run object for an execution of this kernel on device.
+  // Scalar arguments of a recycled run are updated to the current
+  // argument values of the kernel.  Global arguments are managed by
+  // the caller through cached_run::mem_uids.
+  cached_run
+  acquire_run(const device* device);
+
+  // Return a run object to the cache when an execution is done.  The
+  // run must not be running and must have no callbacks.
+  void
+  release_run(const device* device, cached_run&& run);
+
 
   // Get the set of memory banks an argument can connect to given the
   // current set of kernel compute units for specified device
@@ -388,6 +425,20 @@ private:
   struct xkr { xrt::kernel xkernel; xrt::run xrun; };
   std::map<const device*, xkr> m_xruns;
 
+  // Scalar argument values set on the run objects, and the generation
+  // when each was last changed.  Used to update recycled runs.
+  struct run_arg { uint64_t generation; std::vector<char> value; };
+  std::map<unsigned long, run_arg> m_run_args;
+  uint64_t m_run_arg_generation = 0;
+
+  // Recycled run objects per device
+  std::map<const device*, std::vector<cached_run>> m_run_cache;
+  std::mutex m_run_mutex;
+
+  // Idle printf buffers in printf ring buffer mode
+  memory_vector_type m_printf_buffers;
+  std::mutex m_printf_mutex;
+
   // Arguments in indexed order per xrt::kernel object
   using xarg = xrt_core::xclbin::kernel_argument;
   std::vector<const xarg*> m_arginfo;
@@ -0,0 +1,143 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "usm.h"
+#include "device.h"
+#include "error.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace {
+
+// Address ranges of USM allocations.  Allocations never overlap, so
+// a map ordered by start address is sufficient as interval tree; the
+// allocation containing an address is the last allocation starting
+// at or before the address, provided its range extends beyond it.
+//
+// Host and shared allocations are keyed by host address, device
+// allocations by device address.  These are different address spaces
+// and are kept in separate maps.
+class usm_table
+{
+  struct allocation
+  {
+    size_t size;
+    xrt::bo bo;
+  };
+
+  using map_type = std::map<uintptr_t, allocation>;
+
+  std::mutex m_mutex;
+  map_type m_host;
+  map_type m_device;
+
+  static const map_type::value_type*
+  find(const map_type& map, uintptr_t addr)
+  {
+    auto itr = map.upper_bound(addr);
+    if (itr == map.begin())
+      return nullptr;
+    --itr;
+    return (addr < itr->first + itr->second.size) ? &(*itr) : nullptr;
+  }
+
+public:
+  void
+  add(xocl::usm::kind k, uintptr_t addr, xrt::bo&& bo)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto& map = (k == xocl::usm::kind::device) ? m_device : m_host;
+    auto size = bo.size();
+    map.emplace(addr, allocation{size, std::move(bo)});
+  }
+
+  bool
+  remove(uintptr_t addr)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_host.erase(addr) || m_device.erase(addr);
+  }
+
+  xrt::bo
+  lookup(uintptr_t addr, size_t* offset)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto entry = find(m_host, addr);
+    if (!entry)
+      entry = find(m_device, addr);
+    if (!entry)
+      return {};
+    *offset = addr - entry->first;
+    return entry->second.bo;
+  }
+};
+
+// Never destructed, allocations not freed by the application must not
+// be released during static destruction when the devices may be gone
+static usm_table*
+get_usm_table()
+{
+  static auto table = new usm_table;
+  return table;
+}
+
+} // namespace
+
+namespace xocl { namespace usm {
+
+void*
+alloc(device* device, kind k, size_t size)
+{
+  if (!device->is_active())
+    throw error(CL_INVALID_OPERATION,"USM allocation requires a loaded program");
+
+  auto xclbin = device->get_xclbin();
+  xrt::bo bo;
+  if (k == kind::device) {
+    auto memidx = device->get_cu_memidx();
+    bo = xrt::bo(device->get_xrt_device(), size, xrt::bo::flags::device_only,
+                 static_cast<xrt::memory_group>(memidx < 0 ? 0 : memidx));
+  }
+  else {
+    auto memidx = xclbin.banktag_to_memidx("HOST[0]");
+    if (memidx < 0)
+      throw error(CL_INVALID_OPERATION,"USM host allocation requires host memory bank");
+    bo = xrt::bo(device->get_xrt_device(), size, xrt::bo::flags::host_only,
+                 static_cast<xrt::memory_group>(memidx));
+  }
+
+  void* ptr = (k == kind::device)
+    ? reinterpret_cast<void*>(static_cast<uintptr_t>(bo.address()))
+    : bo.map();
+  get_usm_table()->add(k, reinterpret_cast<uintptr_t>(ptr), std::move(bo));
+  return ptr;
+}
+
+bool
+free(void* ptr)
+{
+  return get_usm_table()->remove(reinterpret_cast<uintptr_t>(ptr));
+}
+
+xrt::bo
+lookup(const void* ptr, size_t* offset)
+{
+  return get_usm_table()->lookup(reinterpret_cast<uintptr_t>(ptr), offset);
+}
+
+}} // usm,xocl
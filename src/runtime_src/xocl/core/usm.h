@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) 2022 Xilinx, Inc
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef xocl_core_usm_h_
+#define xocl_core_usm_h_
+
+#include "xocl/config.h"
+#include "core/include/experimental/xrt_bo.h"
+
+#include <cstddef>
+
+namespace xocl {
+
+class device;
+
+/**
+ * Unified shared memory (USM) allocations
+ *
+ * A USM allocation is a buffer object that is referenced by pointer
+ * rather than by cl_mem.  A pointer into an allocation can be passed
+ * directly as a global kernel argument, the argument is set to the
+ * device address of the pointer without any map or unmap.
+ *
+ * host:   host memory accessible by device, pointer is host address
+ * shared: same as host, data is accessed by the device over PCIe
+ *         rather than migrated
+ * device: device memory, pointer is device address and cannot be
+ *         dereferenced by host
+ *
+ * Host and shared allocations require a host memory bank in the
+ * xclbin loaded on the device.
+ */
+namespace usm {
+
+enum class kind { host, device, shared };
+
+/**
+ * alloc() - Allocate USM memory on device
+ *
+ * Throws xocl::error on failure
+ */
+void*
+alloc(device* device, kind k, size_t size);
+
+/**
+ * free() - Free USM allocation
+ *
+ * @ptr: Pointer returned by alloc()
+ * Return: true if ptr was a USM allocation, false otherwise
+ */
+bool
+free(void* ptr);
+
+/**
+ * lookup() - Look up USM allocation containing pointer
+ *
+ * @ptr:    Pointer into an allocation
+ * @offset: Output, offset of ptr into returned buffer object
+ * Return:  Buffer object of allocation, or empty buffer object if ptr
+ *          is not in any USM allocation
+ */
+xrt::bo
+lookup(const void* ptr, size_t* offset);
+
+} // usm
+
+} // xocl
+
+#endif
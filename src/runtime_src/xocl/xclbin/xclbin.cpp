@@ -24,6 +24,9 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
 #ifdef _WIN32
@@ -245,10 +248,33 @@ struct xclbin::impl
     , m_xclbin(device->get_xclbin(uuid))
   {}
 
+  // Parsed meta data is shared by all devices and programs that load
+  // the same xclbin.  The uuid identifies the xclbin content, and the
+  // impl holds on to the xrt::xclbin that owns the section data, so
+  // an impl created from one device is valid for all.  Cached entries
+  // are weak so meta data is freed when no device has it loaded.
   static std::shared_ptr<impl>
   get_impl(const xrt_core::device* device, const xrt_core::uuid& uuid)
   {
-    return std::make_shared<impl>(device, uuid);
+    static std::mutex mutex;
+    static std::map<xrt_core::uuid, std::weak_ptr<impl>> cache;
+
+    std::lock_guard<std::mutex> lk(mutex);
+    auto& entry = cache[uuid];
+    if (auto cached = entry.lock())
+      return cached;
+
+    // prune entries of unloaded xclbins while here
+    for (auto itr = cache.begin(); itr != cache.end(); ) {
+      if (itr->second.expired() && itr->first != uuid)
+        itr = cache.erase(itr);
+      else
+        ++itr;
+    }
+
+    auto metadata = std::make_shared<impl>(device, uuid);
+    entry = metadata;
+    return metadata;
   }
 };
 
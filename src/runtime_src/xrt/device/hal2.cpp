@@ -25,11 +25,17 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring> // for std::memcpy
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <regex>
+#include <sstream>
 #include <string>
 
 #ifdef _WIN32
@@ -57,6 +63,29 @@ send_exception_message(const std::string& msg)
   send_exception_message(msg.c_str());
 }
 
+// Convert a sysfs cpulist, e.g. "0-7,16-23", to comma separated cpus
+// as expected by xrt_core::detail::set_cpu_affinity()
+static std::string
+expand_cpulist(const std::string& cpulist)
+{
+  std::string cpus;
+  std::istringstream istr(cpulist);
+  std::string range;
+  while (std::getline(istr, range, ',')) {
+    if (range.empty() || !std::isdigit(static_cast<unsigned char>(range[0])))
+      continue;
+    auto dash = range.find('-');
+    auto first = std::stoul(range.substr(0, dash));
+    auto last = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      if (!cpus.empty())
+        cpus += ',';
+      cpus += std::to_string(cpu);
+    }
+  }
+  return cpus;
+}
+
 }
 
 namespace xrt_xocl { namespace hal2 {
@@ -82,6 +111,7 @@ device::
 
   for (auto& q : m_queue)
     q.stop();
+  m_chunk_queue.stop();
   for (auto& t : m_workers)
     t.join();
 }
@@ -172,14 +202,56 @@ setup()
   if (!threads) // Guard against drivers who do not set m_devinfo.mDMAThreads
     threads = 2;
 
+  // DMA workers run on the CPUs of the device NUMA node if configured
+  auto cpus = get_numa_cpus();
+  auto set_numa_affinity = [&cpus](std::thread& thread) {
+    if (!cpus.empty())
+      xrt_core::detail::set_cpu_affinity(thread, cpus);
+  };
+
   XRT_DEBUG(std::cout,"Creating ",2*threads," DMA worker threads\n");
   for (unsigned int i=0; i<threads; ++i) {
     // read and write queue workers
-    m_workers.emplace_back(xrt_core::thread(task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::read)]),"read"));
-    m_workers.emplace_back(xrt_core::thread(task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::write)]),"write"));
+    m_workers.emplace_back(xrt_core::thread(xrt_core::thread_class::dma,task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::read)]),"read"));
+    set_numa_affinity(m_workers.back());
+    m_workers.emplace_back(xrt_core::thread(xrt_core::thread_class::dma,task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::write)]),"write"));
+    set_numa_affinity(m_workers.back());
   }
+
+  // chunk workers, one per channel, if large syncs are split
+  if (config::get_dma_chunk_size() && threads > 1) {
+    for (unsigned int i=0; i<threads; ++i) {
+      m_workers.emplace_back(xrt_core::thread(xrt_core::thread_class::dma,task::worker2,std::ref(m_chunk_queue),"chunk"));
+      set_numa_affinity(m_workers.back());
+    }
+    m_chunk_workers = threads;
+  }
+
   // single misc queue worker
-  m_workers.emplace_back(xrt_core::thread(task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::misc)]),"misc"));
+  m_workers.emplace_back(xrt_core::thread(xrt_core::thread_class::dma,task::worker2,std::ref(m_queue[static_cast<qtype>(hal::queue_type::misc)]),"misc"));
+}
+
+std::string
+device::
+get_numa_cpus() const
+{
+  if (!config::get_dma_numa_affinity())
+    return "";
+  if (config::detail::get_string_value("Runtime.cpu_affinity","default") != "default")
+    return "";
+
+  try {
+    auto node = std::stoi(xrt_core::device_query<xrt_core::query::numa_node>(get_core_device()));
+    if (node < 0)
+      return "";
+    std::ifstream istr("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string cpulist;
+    std::getline(istr, cpulist);
+    return expand_cpulist(cpulist);
+  }
+  catch (const std::exception&) {
+    return "";
+  }
 }
 
 device::ExecBufferObject*
@@ -381,10 +453,67 @@ device::
 sync(const buffer_object_handle& boh, size_t sz, size_t offset, direction dir1, bool async)
 {
   auto dir = (dir1 == direction::HOST2DEVICE) ? XCL_BO_SYNC_BO_TO_DEVICE : XCL_BO_SYNC_BO_FROM_DEVICE;
-  const_cast<buffer_object_handle&>(boh).sync(dir, sz, offset);
+  auto& bo = const_cast<buffer_object_handle&>(boh);
+
+  // page align chunks
+  size_t chunk = config::get_dma_chunk_size() & ~size_t(4095);
+  if (m_chunk_workers && chunk && sz >= 2*chunk)
+    sync_chunked(bo, dir, sz, offset, chunk);
+  else
+    bo.sync(dir, sz, offset);
   return event(typed_event<int>(0));
 }
 
+// Split sync of [offset,offset+sz) into chunks that are synced
+// concurrently by the chunk workers and the calling thread.  Each
+// participant syncs the next unclaimed chunk until all chunks are
+// claimed, so the transfer is balanced across the DMA channels
+// regardless of chunk completion order.
+void
+device::
+sync_chunked(xrt::bo& bo, xclBOSyncDirection dir, size_t sz, size_t offset, size_t chunk)
+{
+  auto chunks = (sz + chunk - 1) / chunk;
+  std::atomic<size_t> next{0};
+  auto sync_chunks = [&bo, dir, sz, offset, chunk, chunks, &next] {
+    for (auto idx = next++; idx < chunks; idx = next++) {
+      auto off = idx * chunk;
+      bo.sync(dir, std::min(chunk, sz - off), offset + off);
+    }
+  };
+
+  // workers besides the calling thread
+  auto helpers = std::min(m_chunk_workers, chunks - 1);
+  std::vector<task::event<void>> events;
+  events.reserve(helpers);
+  for (size_t i = 0; i < helpers; ++i)
+    events.emplace_back(task::createF(m_chunk_queue, sync_chunks));
+
+  // claim remaining chunks on failure so helpers finish quickly,
+  // then wait for all helpers before the shared state goes away
+  std::exception_ptr eptr;
+  try {
+    sync_chunks();
+  }
+  catch (...) {
+    next = chunks;
+    eptr = std::current_exception();
+  }
+
+  for (auto& ev : events) {
+    try {
+      ev.get();
+    }
+    catch (...) {
+      if (!eptr)
+        eptr = std::current_exception();
+    }
+  }
+
+  if (eptr)
+    std::rethrow_exception(eptr);
+}
+
 event
 device::
 copy(const buffer_object_handle& dst_boh, const buffer_object_handle& src_boh, size_t sz, size_t dst_offset, size_t src_offset)
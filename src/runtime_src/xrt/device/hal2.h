@@ -67,6 +67,12 @@ class device : public xrt_xocl::hal::device
   using qtype = std::underlying_type<hal::queue_type>::type;
   std::array<task::queue,static_cast<qtype>(hal::queue_type::max)> m_queue;
   std::vector<std::thread> m_workers;
+
+  // queue for chunks of large buffer syncs, serviced by one worker
+  // per DMA channel.  Separate from the read and write queues since
+  // the syncs themselves are typically executed by those workers.
+  task::queue m_chunk_queue;
+  size_t m_chunk_workers = 0;
   svmbomap_type m_svmbomap;
 
   std::shared_ptr<hal2::operations> m_ops;
@@ -100,6 +106,13 @@ class device : public xrt_xocl::hal::device
   hal2::device_info*
   get_device_info_nolock() const;
 
+  // Comma separated CPUs of device NUMA node, empty if not applicable
+  std::string
+  get_numa_cpus() const;
+
+  void
+  sync_chunked(xrt::bo& bo, xclBOSyncDirection dir, size_t sz, size_t offset, size_t chunk);
+
   task::queue&
   get_queue(hal::queue_type qt)
   {
@@ -21,7 +21,9 @@
 
 #include "xrt/util/task.h"
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <iostream>
 
 BOOST_AUTO_TEST_SUITE ( test_task )
@@ -110,6 +112,46 @@ BOOST_AUTO_TEST_CASE( test_task1 )
     t.join();
 }
 
+BOOST_AUTO_TEST_CASE( test_task2 )
+{
+  xrt_xocl::task::stealing_queue queue;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 4; ++i)
+    workers.push_back(std::thread(xrt_xocl::task::stealing_worker,std::ref(queue)));
+
+  {
+    // create task from free function with args
+    auto tev = xrt_xocl::task::createF(queue,&sleepy_waiter,100);
+    BOOST_CHECK_EQUAL(tev.get(),100);
+  }
+
+  {
+    // create task from member function with args
+    API api;
+    auto tev = xrt_xocl::task::createM(queue,&API::foo,api,10,'a');
+    BOOST_CHECK_EQUAL(tev.get(),10);
+  }
+
+  {
+    // tasks adding tasks go to worker deques and are stolen by idle workers
+    std::atomic<int> count{0};
+    std::function<void(int)> spawn = [&](int depth) {
+      ++count;
+      if (depth)
+        for (int i = 0; i < 2; ++i)
+          xrt_xocl::task::createF(queue,spawn,depth-1);
+    };
+    xrt_xocl::task::createF(queue,spawn,10);
+    while (count < (1 << 11) - 1)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    BOOST_CHECK_EQUAL(count,(1 << 11) - 1);
+  }
+
+  queue.stop();
+  for (auto& t : workers)
+    t.join();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
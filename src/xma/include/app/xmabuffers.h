@@ -233,10 +233,67 @@ xma_frame_from_device_buffers(XmaFrameProperties *frame_props,
  * Note: A buffer with is_clone flag set will not be freed
  * by XMA when the refcount is == 0.  Any XMA container with
  * references to this buffer will be freed (e.g. XmaFrame), however.
+ * A frame obtained from an XmaFramePool is returned to its pool
+ * rather than freed.
 */
 void
 xma_frame_free(XmaFrame *frame);
 
+/**
+ * XmaFramePool - Handle to a pool of preallocated frames
+ *
+ * Frames are taken from the pool with xma_frame_pool_get() and go
+ * back to it when their last reference is dropped with
+ * xma_frame_free(), so no buffers are allocated per frame.
+*/
+typedef struct XmaFramePool XmaFramePool;
+
+/**
+ * xma_frame_pool_create() - Create a pool of host frames
+ *
+ * @frame_props: Description of the frames, as for xma_frame_alloc()
+ * @num_frames: Number of frames to preallocate
+ *
+ * RETURN: XmaFramePool pointer or NULL on failure
+*/
+XmaFramePool*
+xma_frame_pool_create(XmaFrameProperties *frame_props, int32_t num_frames);
+
+/**
+ * xma_frame_pool_create_from_frames() - Create a pool of existing frames
+ * Used for frames backed by device buffers, see
+ * xma_plg_frame_pool_create().  The pool takes ownership of the frames,
+ * which must not be referenced elsewhere.
+ *
+ * @frames: Frames to put in the pool
+ * @num_frames: Number of frames in @frames
+ *
+ * RETURN: XmaFramePool pointer or NULL on failure
+*/
+XmaFramePool*
+xma_frame_pool_create_from_frames(XmaFrame **frames, int32_t num_frames);
+
+/**
+ * xma_frame_pool_get() - Take a frame from the pool
+ * The frame has a reference count of one, no side data, and
+ * timestamps and flags cleared.
+ *
+ * @pool: Pool to take the frame from
+ *
+ * RETURN: XmaFrame pointer or NULL when all frames are in use
+*/
+XmaFrame*
+xma_frame_pool_get(XmaFramePool *pool);
+
+/**
+ * xma_frame_pool_destroy() - Destroy a frame pool
+ * Frames still in use are freed when their last reference is dropped.
+ *
+ * @pool: Pool to destroy
+*/
+void
+xma_frame_pool_destroy(XmaFramePool *pool);
+
 /**
  * xma_side_data_alloc() - Allocates side data handle, with
  * reference count equal to 1. The side data buffer 'side_data'
@@ -24,4 +24,5 @@
 #define MAX_VENDOR_NAME         256
 #define XMA_MAX_PLANES           3
 #define MAX_CONNECTION_ENTRIES  64
+#define XMA_AUTO_PLACEMENT      (-1) //dev_index for XMA to select device & cu by current load
 #endif
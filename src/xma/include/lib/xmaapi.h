@@ -28,16 +28,6 @@
 #include <future>
 #include <chrono>
 
-typedef struct XmaLogMsg
-{
-    XmaLogLevelType level;
-    std::string msg;
-
-  XmaLogMsg() {
-    level = XMA_DEBUG_LOG;
-  }
-} XmaLogMsg;
-
 typedef struct XmaSingleton
 {
     XmaHwCfg          hwcfg;
@@ -53,9 +43,10 @@ typedef struct XmaSingleton
     std::atomic<uint32_t> num_admins;
     std::atomic<uint32_t> num_of_sessions;
     std::vector<XmaSession> all_sessions_vec;// XMASessions
-    std::list<XmaLogMsg>   log_msg_list;
-    std::atomic<bool> log_msg_list_locked;
     std::atomic<uint32_t> num_execbos;
+    std::mutex            cu_cmd_done_mutex;
+    std::condition_variable cu_cmd_done_any;//Notified when CU cmds of any session complete
+    std::atomic<uint64_t> cu_cmd_done_gen{ 0 };//Incremented before cu_cmd_done_any is notified
 
     std::atomic<bool> xma_exit;
     std::thread       xma_thread1;
@@ -76,7 +67,6 @@ typedef struct XmaSingleton
     num_admins = 0;
     num_execbos = XMA_NUM_EXECBO_DEFAULT;
     num_of_sessions = 0;
-    log_msg_list_locked = false;
     xma_exit = false;
     cpu_mode = 0;
   }
@@ -99,6 +99,7 @@ typedef struct XmaHwExecBO
 {
     xrt::kernel xrt_kernel;
     xrt::run xrt_run;
+    int32_t     regmap_size = 0;//Bytes of regmap written by last command
     bool        in_use = false;
     uint32_t    cu_cmd_id1 = 0;//Counter
     int32_t     cu_cmd_id2 = 0;//Random num
@@ -173,7 +174,8 @@ typedef struct XmaHwSessionPrivate
     std::condition_variable work_item_done_1plus;//Use with xma_plg_work_item_done
     std::condition_variable execbo_is_free; //Use with xma_plg_schedule_work_item and xma_plg_schedule_cu_cmd
     std::condition_variable kernel_done_or_free;//Use with xma_plg_cu_cmd_status; CU completion is must every outstanding cmd;
-    std::vector<uint32_t> execbo_lru;
+    std::atomic<uint64_t> execbo_free_mask{ 0 };//Bit per free execbo; claimed without execbo lock
+    std::atomic<int32_t> execbo_last{ -1 };//Last claimed execbo
     std::vector<uint32_t> execbo_to_check;
     bool     using_work_item_done = false;
     std::atomic<bool> using_cu_cmd_status{ false };
@@ -31,6 +31,10 @@
 
 #define XMA_MAX_LOGMSG_SIZE          512
 //#define XMA_MAX_LOGMSG_Q_ENTRIES     128
+#define XMA_LOGMSG_RING_SIZE         64 //Log msgs buffered per thread
+
+/* Send log msgs buffered by all threads to XRT */
+void xma_flush_log_rings();
 
 /*
 typedef enum xrtLogMsgLevel XmaLogLevelType;
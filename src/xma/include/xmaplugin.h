@@ -134,6 +134,66 @@ xma_plg_buffer_alloc_ddr(XmaSession s_handle, size_t size, bool device_only_buff
  */
 void xma_plg_buffer_free(XmaSession s_handle, XmaBufferObj b_obj);
 
+/**
+ *  xma_plg_frame_pool_create() - Create a pool of device buffer frames
+ *  This function preallocates @num_frames frames whose planes are
+ *  device buffers on the DDR bank of this session, sized as for
+ *  @ref xma_frame_alloc().  Frames are taken from the pool with
+ *  xma_frame_pool_get() and return to it on xma_frame_free(), so
+ *  no device memory is allocated per frame.
+ *
+ *  @s_handle:  The session handle associated with this plugin instance
+ *  @frame_props: Description of the frames
+ *  @num_frames: Number of frames to preallocate
+ *  @device_only_buffer: Allocate device only buffers without any host space
+ *  @return_code:  XMA_SUCESS or XMA_ERROR.
+ *
+ *  RETURN:    XmaFramePool pointer on success; NULL on failure
+ *
+ */
+XmaFramePool*
+xma_plg_frame_pool_create(XmaSession s_handle, XmaFrameProperties *frame_props,
+                          int32_t num_frames, bool device_only_buffer,
+                          int32_t* return_code);
+
+/**
+ *  xma_plg_frame_handoff() - Take a zero-copy reference to a frame
+ *  This function lets a session use a frame produced by another session
+ *  on the same device without copying it through the host.  Every plane
+ *  must be a device buffer on the device of this session, in a DDR bank
+ *  the kernel argument @arg_num is connected to.  On success the plane
+ *  refcounts are incremented; release the frame with xma_frame_free().
+ *  No buffer sync is done, the buffers are used as they are on the device.
+ *
+ *  @s_handle:  The session handle associated with this plugin instance
+ *  @frame:     Frame to take a reference to
+ *  @arg_num:   Kernel argument the frame is passed to; if < 0 any DDR bank
+ *              connected to the kernel is accepted
+ *
+ *  RETURN:     XMA_SUCCESS on success
+ *              XMA_ERROR if the frame cannot be used without a copy
+ *
+ */
+int32_t
+xma_plg_frame_handoff(XmaSession s_handle, XmaFrame *frame, int32_t arg_num);
+
+/**
+ *  xma_plg_data_buffer_handoff() - Take a zero-copy reference to a data buffer
+ *  Same as @ref xma_plg_frame_handoff() for an XmaDataBuffer; release it
+ *  with xma_data_buffer_free().
+ *
+ *  @s_handle:  The session handle associated with this plugin instance
+ *  @data:      Data buffer to take a reference to
+ *  @arg_num:   Kernel argument the buffer is passed to; if < 0 any DDR bank
+ *              connected to the kernel is accepted
+ *
+ *  RETURN:     XMA_SUCCESS on success
+ *              XMA_ERROR if the buffer cannot be used without a copy
+ *
+ */
+int32_t
+xma_plg_data_buffer_handoff(XmaSession s_handle, XmaDataBuffer *data, int32_t arg_num);
+
 /**
  *  xma_plg_buffer_write() - Write data from host to device buffer
  *  This function copies data from host memory to device memory.
@@ -191,6 +251,29 @@ XmaCUCmdObj xma_plg_schedule_cu_cmd(XmaSession s_handle,
 
 int32_t xma_plg_cu_cmd_status(XmaSession s_handle, XmaCUCmdObj* cmd_obj_array, int32_t num_cu_objs, bool wait_for_cu_cmds);
 
+/**
+ * xma_plg_cu_cmd_status_multi() - Check or wait for cu cmds of several sessions
+ * with one call.  cmd_obj_array[i] must have been scheduled on s_handles[i];
+ * sessions may repeat.  cmd_finished of every command object is updated.
+ * Sessions must not use xma_plg_is_work_item_done().
+ *
+ * @s_handles:     Array of session handles, one per command object
+ * @cmd_obj_array: An array of command objects
+ * @num_cu_objs:   Num of cu cmd objects in above arrays
+ * @wait_for_all:  Wait for all cu cmds to finish, else for at least one
+ * @timeout_ms:    Max time to wait; 0 to only check; negative to wait without limit
+ * @num_done:      Optional; set to num of finished cu cmds
+ *
+ * RETURN:         XMA_SUCCESS when all (or at least one) cu cmds finished
+ *
+ * XMA_ERROR_TIMEOUT if the timeout expired first
+ *
+ * XMA_ERROR on failure
+ *
+ */
+int32_t xma_plg_cu_cmd_status_multi(XmaSession* s_handles, XmaCUCmdObj* cmd_obj_array, int32_t num_cu_objs,
+                                    bool wait_for_all, int32_t timeout_ms, int32_t* num_done);
+
 /**
  * xma_plg_is_work_item_done() - This function checks if at least one work item
  * previously submitted via xma_plg_schedule_work_item() has completed.  If the
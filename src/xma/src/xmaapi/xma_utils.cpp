@@ -127,7 +127,10 @@ namespace xma_core {
                 std::string inst_name = cu_name.substr(pos + 1);
                 std::string updated_cu_name = kernel_name + ":{" + inst_name + "}";
                 dev_execbo.xrt_kernel = xrt::kernel(priv->dev_handle, priv->dev_handle.get_xclbin_uuid(), updated_cu_name);
+                // Run is reused by every command scheduled with this execbo
+                dev_execbo.xrt_run = xrt::run(dev_execbo.xrt_kernel);
             }
+            priv->execbo_free_mask = (count >= 64) ? ~0ULL : ((1ULL << count) - 1);
             return XMA_SUCCESS;
         }
         catch (const xrt_core::system_error&) {
@@ -407,22 +410,7 @@ void get_system_info() {
     }
     xma_logmsg(level, "XMA-System-Info", "======= END =============");
 
-    bool expected = false;
-    bool desired = true;
-    while (!g_xma_singleton->log_msg_list_locked.compare_exchange_weak(expected, desired)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        expected = false;
-    }
-    //log msg list lock acquired
-
-    while (!g_xma_singleton->log_msg_list.empty()) {
-        auto itr1 = g_xma_singleton->log_msg_list.begin();
-        xclLogMsg(NULL, (xrtLogMsgLevel)itr1->level, "XMA", itr1->msg.c_str());
-        g_xma_singleton->log_msg_list.pop_front();
-    }
-
-    //Release log msg list lock
-    g_xma_singleton->log_msg_list_locked = false;
+    xma_flush_log_rings();
 }
 
 // get_session_cmd_load() - Used for logging of XMA session info.
@@ -509,6 +497,73 @@ int32_t get_cu_index(int32_t dev_index, char* cu_name1) {
     return -1;
 }
 
+// select_session_cu() - Selects the least loaded device & cu for a new session.
+// Candidates are cus named cu_name, or all instances of kernel cu_name, on any
+// device. Load of a cu is its sessions plus their outstanding cu cmds and
+// measured busy fraction; ties go to the cu whose default ddr bank has fewer
+// sessions. Load is sampled at each session creation, so new sessions follow
+// the current load.
+int32_t select_session_cu(const char* cu_name1, int32_t& dev_index, int32_t& cu_index, const std::string& prefix) {
+    if (cu_name1 == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, prefix.c_str(),
+                   "XMA session creation failed. cu_name must be set for automatic placement\n");
+        return XMA_ERROR;
+    }
+    std::string cu_name = std::string(cu_name1);
+    bool match_kernel = cu_name.find(':') == std::string::npos;
+
+    std::lock_guard<std::mutex> guard1(g_xma_singleton->m_mutex);
+    std::map<XmaHwKernel*, float> cu_load;
+    std::map<std::pair<XmaHwDevice*, int32_t>, uint32_t> bank_sessions;
+    for (auto& itr1: g_xma_singleton->all_sessions_vec) {
+        XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) itr1.hw_session.private_do_not_use;
+        if (priv1 == NULL || priv1->kernel_info == NULL) {
+            continue;
+        }
+        float busy = 0;
+        uint32_t busy_ticks = priv1->cmd_busy + priv1->cmd_idle;
+        if (busy_ticks > 0) {
+            busy = priv1->cmd_busy / (float)busy_ticks;
+        }
+        cu_load[priv1->kernel_info] += 1 + priv1->num_cu_cmds + busy;
+        bank_sessions[{priv1->device, itr1.hw_session.bank_index}]++;
+    }
+
+    XmaHwKernel* best_kernel = nullptr;
+    float best_load = 0;
+    uint32_t best_bank_sessions = 0;
+    for (XmaHwDevice& hw_device: g_xma_singleton->hwcfg.devices) {
+        for (XmaHwKernel& kernel: hw_device.kernels) {
+            std::string name = std::string((char*)kernel.name);
+            if (match_kernel) {
+                name = name.substr(0, name.find(':'));
+            }
+            if (name != cu_name) {
+                continue;
+            }
+            float load = cu_load[&kernel];
+            uint32_t bank_load = bank_sessions[{&hw_device, kernel.default_ddr_bank}];
+            if (best_kernel == nullptr || load < best_load ||
+                (load == best_load && bank_load < best_bank_sessions)) {
+                best_kernel = &kernel;
+                best_load = load;
+                best_bank_sessions = bank_load;
+                dev_index = hw_device.dev_index;
+                cu_index = kernel.cu_index;
+            }
+        }
+    }
+    if (best_kernel == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, prefix.c_str(),
+                   "XMA session creation failed. cu %s not found on any device\n", cu_name.c_str());
+        return XMA_ERROR;
+    }
+    xma_logmsg(XMA_DEBUG_LOG, prefix.c_str(),
+               "Automatic placement selected dev_index %d, cu %s with load %.2f\n",
+               dev_index, best_kernel->name, best_load);
+    return XMA_SUCCESS;
+}
+
 // get_default_ddr_index() - Returns default ddr index for the given cu index.
 int32_t get_default_ddr_index(int32_t dev_index, int32_t cu_index) {
     //singleton should be locked before calling this function
@@ -555,6 +610,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
     //Check only for commands in-progress in this sessions else too much checking will waste CPU cycles
 
     XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) s_handle.hw_session.private_do_not_use;
+    uint32_t num_cmds_before = priv1->num_cu_cmds;
 
     if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
         bool notify_execbo_is_free = false;
@@ -579,6 +635,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
                         }
                         notify_execbo_is_free = true;
                         ebo.in_use = false;
+                        priv1->execbo_free_mask |= 1ULL << i;
                         //cu_cmd->state = ERT_CMD_STATE_MAX;
                         priv1->CU_cmds.erase(ebo.cu_cmd_id1);
                         priv1->num_cu_cmds--;
@@ -591,6 +648,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
                         }
                         notify_execbo_is_free = true;
                         ebo.in_use = false;
+                        priv1->execbo_free_mask |= 1ULL << i;
                         //cu_cmd->state = ERT_CMD_STATE_MAX;
                         auto itr_tmp1 = priv1->CU_error_cmds.emplace(ebo.cu_cmd_id1, std::move(priv1->CU_cmds[ebo.cu_cmd_id1]));
                         priv1->CU_cmds.erase(ebo.cu_cmd_id1);
@@ -644,6 +702,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
                             priv1->kernel_complete_total++;
                         }
                         ebo.in_use = false;
+                        priv1->execbo_free_mask |= 1ULL << val;
                         //cu_cmd->state = ERT_CMD_STATE_MAX;
                         notify_work_item_done_1plus = true;
                         notify_execbo_is_free = true;
@@ -661,6 +720,7 @@ int32_t check_all_execbo(XmaSession s_handle) {
                         notify_execbo_is_free = true;
                         notify_work_item_done_1plus = true;
                         ebo.in_use = false;
+                        priv1->execbo_free_mask |= 1ULL << val;
                         //cu_cmd->state = ERT_CMD_STATE_MAX;
                         auto itr_tmp1 = priv1->CU_error_cmds.emplace(ebo.cu_cmd_id1, std::move(priv1->CU_cmds[ebo.cu_cmd_id1]));
                         priv1->CU_cmds.erase(ebo.cu_cmd_id1);
@@ -713,6 +773,13 @@ int32_t check_all_execbo(XmaSession s_handle) {
         }
     }
 
+    //Unblock xma_plg_cu_cmd_status_multi waiting across sessions
+    if (priv1->num_cu_cmds != num_cmds_before) {
+        std::lock_guard<std::mutex> lk(g_xma_singleton->cu_cmd_done_mutex);
+        g_xma_singleton->cu_cmd_done_gen++;
+        g_xma_singleton->cu_cmd_done_any.notify_all();
+    }
+
     return XMA_SUCCESS;
 }
 
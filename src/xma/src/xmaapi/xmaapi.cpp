@@ -32,6 +32,7 @@
 #include <algorithm>
 #include "core/common/config_reader.h"
 #include "core/common/device.h"
+#include "core/common/thread.h"
 
 #define XMAAPI_MOD "xmaapi"
 
@@ -77,30 +78,9 @@ void xma_thread1() {
     g_xma_singleton->thread1_future = p.get_future();
     p.set_value_at_thread_exit(true);
 
-    bool expected = false;
-    bool desired = true;
-    std::list<XmaLogMsg> list1;
     while (!g_xma_singleton->xma_exit) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        while (!g_xma_singleton->log_msg_list_locked.compare_exchange_weak(expected, desired)) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            expected = false;
-        }
-        //log msg list lock acquired
-
-        if (!g_xma_singleton->log_msg_list.empty()) {
-            auto itr1 = list1.end();
-            list1.splice(itr1, g_xma_singleton->log_msg_list);
-        }
-
-        //Release log msg list lock
-        g_xma_singleton->log_msg_list_locked = false;
-
-        while (!list1.empty()) {
-            auto itr1 = list1.begin();
-            xclLogMsg(NULL, (xrtLogMsgLevel)itr1->level, "XMA", itr1->msg.c_str());
-            list1.pop_front();
-        }
+        xma_flush_log_rings();
 
         if (!g_xma_singleton->xma_exit) {
             //Check Session loading
@@ -259,7 +239,8 @@ void xma_thread2(uint32_t hw_dev_index) {
 
     bool expected = false;
     bool desired = true;
-    auto xrt_device_obj = g_xma_singleton->hwcfg.devices[hw_dev_index].xrt_device;
+    XmaHwDevice *dev = &g_xma_singleton->hwcfg.devices[hw_dev_index];
+    auto xrt_device_obj = dev->xrt_device;
     while (!g_xma_singleton->xma_exit) {
         if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
             std::this_thread::sleep_for(std::chrono::milliseconds(3));
@@ -272,6 +253,10 @@ void xma_thread2(uint32_t hw_dev_index) {
                 break;
             }
             XmaHwSessionPrivate *priv1 = (XmaHwSessionPrivate*) itr1.hw_session.private_do_not_use;
+            //Only sessions of this device with commands in flight can have completions
+            if (priv1->device != dev || priv1->num_cu_cmds == 0) {
+                continue;
+            }
             expected = false;
 /*
             while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
@@ -424,12 +409,12 @@ int32_t xma_initialize(XmaXclbinParameter *devXclbins, int32_t num_parms)
     g_xma_singleton->cpu_mode = xrt_core::config::get_xma_cpu_mode();
     xma_logmsg(XMA_DEBUG_LOG, XMAAPI_MOD, "XMA CPU Mode is: %d", g_xma_singleton->cpu_mode);
 
-    g_xma_singleton->xma_thread1 = std::thread(xma_thread1);
+    g_xma_singleton->xma_thread1 = xrt_core::thread(xrt_core::thread_class::xma, xma_thread1);
     g_xma_singleton->all_thread2.reserve(MAX_XILINX_DEVICES);
     g_xma_singleton->all_thread2_futures.reserve(MAX_XILINX_DEVICES);
     uint32_t num_devices = g_xma_singleton->hwcfg.devices.size();
     for (uint32_t i = 0; i < num_devices; i++) {
-        g_xma_singleton->all_thread2.emplace_back(std::thread(xma_thread2, i));
+        g_xma_singleton->all_thread2.emplace_back(xrt_core::thread(xrt_core::thread_class::xma, xma_thread2, i));
         g_xma_singleton->all_thread2.back().detach();
     }
     //Detach threads to let them run independently
@@ -26,6 +26,10 @@
 //#include <cstdio>
 #include <iostream>
 #include <cstring>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #define XMA_BUFFER_MOD "xmabuffer"
 
@@ -36,6 +40,22 @@ typedef struct XmaFrameSideData
     enum XmaFrameSideDataType type;
 } XmaFrameSideData;
 
+struct XmaFramePool
+{
+    std::mutex             m_mutex;
+    std::vector<XmaFrame*> frames_free;
+    int32_t                num_frames = 0; // Frames not yet freed for good
+    bool                   destroyed = false;
+};
+
+namespace {
+// Pool of each pooled frame; XmaFrame has no field to hold it
+std::mutex pool_frames_mutex;
+std::unordered_map<XmaFrame*, XmaFramePool*> pool_frames;
+// Lets xma_frame_free of frames not from a pool skip the lookup
+std::atomic<uint32_t> num_pool_frames{0};
+}
+
 int32_t
 xma_frame_planes_get(XmaFrameProperties *frame_props)
 {
@@ -213,20 +233,10 @@ xma_device_buffer_free(XmaBufferObj *b_obj)
     b_obj = nullptr;
 }
 
-void
-xma_frame_free(XmaFrame *frame)
+static void
+frame_buffers_free(XmaFrame *frame)
 {
-    int32_t num_planes;
-
-    xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
-               "%s() Free frame %p\n", __func__, frame);
-    num_planes = xma_frame_planes_get(&frame->frame_props);
-
-    for (int32_t i = 0; i < num_planes; i++)
-        frame->data[i].refcount--;
-
-    if (frame->data[0].refcount > 0)
-        return;
+    int32_t num_planes = xma_frame_planes_get(&frame->frame_props);
 
     for (int32_t i = 0; i < num_planes; i++) {
         if (!frame->data[i].is_clone) {
@@ -251,6 +261,171 @@ xma_frame_free(XmaFrame *frame)
     frame = nullptr;
 }
 
+// Return a frame to its pool, false if the frame is not from a pool
+static bool
+frame_pool_put(XmaFrame *frame)
+{
+    XmaFramePool *pool;
+    {
+        std::lock_guard<std::mutex> lk(pool_frames_mutex);
+        auto it = pool_frames.find(frame);
+        if (it == pool_frames.end())
+            return false;
+        pool = it->second;
+    }
+
+    xma_frame_clear_all_side_data(frame);
+    std::unique_lock<std::mutex> lk(pool->m_mutex);
+    if (!pool->destroyed) {
+        pool->frames_free.push_back(frame);
+        return true;
+    }
+
+    // Pool is gone, free the frame for good
+    bool last = --pool->num_frames == 0;
+    lk.unlock();
+    {
+        std::lock_guard<std::mutex> plk(pool_frames_mutex);
+        pool_frames.erase(frame);
+        num_pool_frames--;
+    }
+    frame_buffers_free(frame);
+    if (last)
+        delete pool;
+    return true;
+}
+
+XmaFramePool*
+xma_frame_pool_create_from_frames(XmaFrame **frames, int32_t num_frames)
+{
+    xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
+               "%s() num_frames %d\n", __func__, num_frames);
+    if (!frames || num_frames <= 0)
+        return nullptr;
+    for (int32_t i = 0; i < num_frames; i++) {
+        if (!frames[i]) {
+            xma_logmsg(XMA_ERROR_LOG, XMA_BUFFER_MOD,
+                       "%s() frame %d is NULL\n", __func__, i);
+            return nullptr;
+        }
+    }
+
+    XmaFramePool *pool = new XmaFramePool;
+    pool->frames_free.assign(frames, frames + num_frames);
+    pool->num_frames = num_frames;
+    std::lock_guard<std::mutex> lk(pool_frames_mutex);
+    for (int32_t i = 0; i < num_frames; i++)
+        pool_frames[frames[i]] = pool;
+    num_pool_frames += num_frames;
+
+    return pool;
+}
+
+XmaFramePool*
+xma_frame_pool_create(XmaFrameProperties *frame_props, int32_t num_frames)
+{
+    xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
+               "%s() num_frames %d\n", __func__, num_frames);
+    if (!frame_props || num_frames <= 0)
+        return nullptr;
+
+    std::vector<XmaFrame*> frames;
+    for (int32_t i = 0; i < num_frames; i++) {
+        XmaFrame *frame = xma_frame_alloc(frame_props, false);
+        if (!frame) {
+            xma_logmsg(XMA_ERROR_LOG, XMA_BUFFER_MOD,
+                       "%s() Failed to allocate frame %d\n", __func__, i);
+            for (auto f : frames)
+                frame_buffers_free(f);
+            return nullptr;
+        }
+        frames.push_back(frame);
+    }
+
+    return xma_frame_pool_create_from_frames(frames.data(), num_frames);
+}
+
+XmaFrame*
+xma_frame_pool_get(XmaFramePool *pool)
+{
+    if (!pool)
+        return nullptr;
+
+    XmaFrame *frame;
+    {
+        std::lock_guard<std::mutex> lk(pool->m_mutex);
+        if (pool->destroyed || pool->frames_free.empty())
+            return nullptr;
+        frame = pool->frames_free.back();
+        pool->frames_free.pop_back();
+    }
+
+    int32_t num_planes = xma_frame_planes_get(&frame->frame_props);
+    for (int32_t i = 0; i < num_planes; i++)
+        frame->data[i].refcount = 1;
+    frame->time_base = XmaFraction{};
+    frame->frame_rate = XmaFraction{};
+    frame->pts = 0;
+    frame->is_idr = 0;
+    frame->do_not_encode = 0;
+    frame->is_last_frame = 0;
+
+    return frame;
+}
+
+void
+xma_frame_pool_destroy(XmaFramePool *pool)
+{
+    xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
+               "%s() Destroy frame pool %p\n", __func__, pool);
+    if (!pool)
+        return;
+
+    std::vector<XmaFrame*> frames;
+    bool last;
+    {
+        std::lock_guard<std::mutex> lk(pool->m_mutex);
+        if (pool->destroyed)
+            return;
+        pool->destroyed = true;
+        frames.swap(pool->frames_free);
+        pool->num_frames -= static_cast<int32_t>(frames.size());
+        last = pool->num_frames == 0;
+    }
+    {
+        std::lock_guard<std::mutex> lk(pool_frames_mutex);
+        for (auto frame : frames)
+            pool_frames.erase(frame);
+        num_pool_frames -= static_cast<uint32_t>(frames.size());
+    }
+    for (auto frame : frames)
+        frame_buffers_free(frame);
+    // Frames still in use free the pool with the last of them
+    if (last)
+        delete pool;
+}
+
+void
+xma_frame_free(XmaFrame *frame)
+{
+    int32_t num_planes;
+
+    xma_logmsg(XMA_DEBUG_LOG, XMA_BUFFER_MOD,
+               "%s() Free frame %p\n", __func__, frame);
+    num_planes = xma_frame_planes_get(&frame->frame_props);
+
+    for (int32_t i = 0; i < num_planes; i++)
+        frame->data[i].refcount--;
+
+    if (frame->data[0].refcount > 0)
+        return;
+
+    if (num_pool_frames.load() && frame_pool_put(frame))
+        return;
+
+    frame_buffers_free(frame);
+}
+
 XmaSideDataHandle
 xma_side_data_alloc(void                      *side_data,
                     enum XmaFrameSideDataType sd_type,
@@ -93,6 +93,15 @@ xma_dec_session_create(XmaDecoderProperties *dec_props)
     int32_t rc, dev_index, cu_index;
     dev_index = dec_props->dev_index;
     cu_index = dec_props->cu_index;
+    if (dev_index == XMA_AUTO_PLACEMENT) {
+        if (xma_core::utils::select_session_cu(dec_props->cu_name, dev_index, cu_index, XMA_DECODER_MOD) != XMA_SUCCESS) {
+            free(dec_session);
+            return nullptr;
+        }
+        //Report placement back to application
+        dec_props->dev_index = dec_session->decoder_props.dev_index = dev_index;
+        dec_props->cu_index = dec_session->decoder_props.cu_index = cu_index;
+    }
     
     XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
     if (dev_index >= hwcfg->num_devices || dev_index < 0) {
@@ -132,6 +132,15 @@ xma_enc_session_create(XmaEncoderProperties *enc_props)
     int32_t rc, dev_index, cu_index;
     dev_index = enc_props->dev_index;
     cu_index = enc_props->cu_index;
+    if (dev_index == XMA_AUTO_PLACEMENT) {
+        if (xma_core::utils::select_session_cu(enc_props->cu_name, dev_index, cu_index, XMA_ENCODER_MOD) != XMA_SUCCESS) {
+            free(enc_session);
+            return nullptr;
+        }
+        //Report placement back to application
+        enc_props->dev_index = enc_session->encoder_props.dev_index = dev_index;
+        enc_props->cu_index = enc_session->encoder_props.cu_index = cu_index;
+    }
 
     XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
     if (dev_index >= hwcfg->num_devices || dev_index < 0) {
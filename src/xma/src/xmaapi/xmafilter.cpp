@@ -89,6 +89,15 @@ xma_filter_session_create(XmaFilterProperties *filter_props)
     int32_t rc, dev_index, cu_index;
     dev_index = filter_props->dev_index;
     cu_index = filter_props->cu_index;
+    if (dev_index == XMA_AUTO_PLACEMENT) {
+        if (xma_core::utils::select_session_cu(filter_props->cu_name, dev_index, cu_index, XMA_FILTER_MOD) != XMA_SUCCESS) {
+            free(filter_session);
+            return nullptr;
+        }
+        //Report placement back to application
+        filter_props->dev_index = filter_session->props.dev_index = dev_index;
+        filter_props->cu_index = filter_session->props.cu_index = cu_index;
+    }
 
     XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
     if (dev_index >= hwcfg->num_devices || dev_index < 0) {
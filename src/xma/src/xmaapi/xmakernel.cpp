@@ -88,6 +88,15 @@ xma_kernel_session_create(XmaKernelProperties *props)
     int32_t rc, dev_index, cu_index;
     dev_index = props->dev_index;
     cu_index = props->cu_index;
+    if (dev_index == XMA_AUTO_PLACEMENT) {
+        if (xma_core::utils::select_session_cu(props->cu_name, dev_index, cu_index, XMA_KERNEL_MOD) != XMA_SUCCESS) {
+            free(session);
+            return nullptr;
+        }
+        //Report placement back to application
+        props->dev_index = session->kernel_props.dev_index = dev_index;
+        props->cu_index = session->kernel_props.cu_index = cu_index;
+    }
 
     XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
     if (dev_index >= hwcfg->num_devices || dev_index < 0) {
@@ -33,6 +33,12 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "lib/xmaapi.h"
 #include "app/xmalogger.h"
@@ -48,6 +54,91 @@
 
 extern XmaSingleton *g_xma_singleton;
 
+namespace {
+
+// Ring of formatted log messages of one thread. The owning thread is the
+// only producer; draining is serialized by the draining flag, which only
+// the owner (on errors or a full ring) and xma_thread1 contend for.
+struct XmaLogRing
+{
+    struct Slot {
+        XmaLogLevelType level;
+        char            msg[XMA_MAX_LOGMSG_SIZE];
+    };
+    Slot                  slots[XMA_LOGMSG_RING_SIZE];
+    std::atomic<uint32_t> head{0};//Next slot to fill
+    std::atomic<uint32_t> tail{0};//Next slot to drain
+    std::atomic<bool>     draining{false};
+    std::atomic<bool>     thread_exited{false};
+};
+
+std::mutex log_rings_mutex;//Only for adding & removing rings
+std::vector<std::shared_ptr<XmaLogRing>> log_rings;
+
+struct XmaLogRingOwner
+{
+    std::shared_ptr<XmaLogRing> ring;
+
+    ~XmaLogRingOwner() {
+        if (ring)
+            ring->thread_exited = true;
+    }
+};
+
+thread_local XmaLogRingOwner log_ring_owner;
+
+XmaLogRing*
+get_log_ring()
+{
+    if (!log_ring_owner.ring) {
+        log_ring_owner.ring = std::make_shared<XmaLogRing>();
+        std::lock_guard<std::mutex> lk(log_rings_mutex);
+        log_rings.push_back(log_ring_owner.ring);
+    }
+    return log_ring_owner.ring.get();
+}
+
+// Send messages of the ring to the xrt_core message sink
+void
+drain_log_ring(XmaLogRing* ring, bool wait)
+{
+    bool expected = false;
+    while (!ring->draining.compare_exchange_weak(expected, true)) {
+        if (!wait)
+            return;
+        std::this_thread::yield();
+        expected = false;
+    }
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        auto& slot = ring->slots[tail % XMA_LOGMSG_RING_SIZE];
+        xclLogMsg(NULL, (xrtLogMsgLevel)slot.level, "XMA", slot.msg);
+    }
+    ring->tail.store(tail, std::memory_order_release);
+    ring->draining = false;
+}
+
+} // namespace
+
+void
+xma_flush_log_rings()
+{
+    std::vector<std::shared_ptr<XmaLogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lk(log_rings_mutex);
+        rings = log_rings;
+    }
+    for (auto& ring : rings)
+        drain_log_ring(ring.get(), true);
+
+    //Drop rings of exited threads once drained
+    std::lock_guard<std::mutex> lk(log_rings_mutex);
+    log_rings.erase(std::remove_if(log_rings.begin(), log_rings.end(),
+        [](const std::shared_ptr<XmaLogRing>& ring) {
+            return ring->thread_exited && ring->tail == ring->head;
+        }), log_rings.end());
+}
 
 void
 xma_logmsg(XmaLogLevelType level, const char *name, const char *msg, ...)
@@ -57,54 +148,48 @@ xma_logmsg(XmaLogLevelType level, const char *name, const char *msg, ...)
         /* Handle variable arguments */
         va_list ap;
 
-        /* Create message buffer on the stack */
-        char            msg_buff[XMA_MAX_LOGMSG_SIZE];
         char            log_name[40] = {0};
         int32_t         hdr_offset;
 
-        memset(msg_buff, 0, sizeof(msg_buff));
-
         /* Set component name */
         if (name == NULL)
             strncpy(log_name, "XMA-default", sizeof(log_name));
         else
             strncpy(log_name, name, sizeof(log_name)-1);
 
+        if (!g_xma_singleton) {
+            /* Create message buffer on the stack */
+            char msg_buff[XMA_MAX_LOGMSG_SIZE];
+            snprintf(msg_buff, sizeof(msg_buff), "%s %s ", program_invocation_short_name, log_name);
+            hdr_offset = strlen(msg_buff);
+            va_start(ap, msg);
+            vsnprintf(&msg_buff[hdr_offset], (XMA_MAX_LOGMSG_SIZE - hdr_offset), msg, ap);
+            va_end(ap);
+            xclLogMsg(NULL, (xrtLogMsgLevel)level, "XMA", msg_buff);
+            return;
+        }
+
+        XmaLogRing* ring = get_log_ring();
+        uint32_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->tail.load(std::memory_order_acquire) >= XMA_LOGMSG_RING_SIZE) {
+            //Ring is full; send its messages now rather than drop any
+            drain_log_ring(ring, true);
+        }
 
-        sprintf(msg_buff, "%s %s ", program_invocation_short_name, log_name);
-        hdr_offset = strlen(msg_buff);
+        /* Format the message in place in the ring */
+        auto& slot = ring->slots[head % XMA_LOGMSG_RING_SIZE];
+        slot.level = level;
+        snprintf(slot.msg, sizeof(slot.msg), "%s %s ", program_invocation_short_name, log_name);
+        hdr_offset = strlen(slot.msg);
         va_start(ap, msg);
-        vsnprintf(&msg_buff[hdr_offset], (XMA_MAX_LOGMSG_SIZE - hdr_offset), msg, ap);
+        vsnprintf(&slot.msg[hdr_offset], (XMA_MAX_LOGMSG_SIZE - hdr_offset), msg, ap);
         va_end(ap);
-        if (g_xma_singleton) {
-            bool expected = false;
-            bool desired = true;
-            while (!g_xma_singleton->log_msg_list_locked.compare_exchange_weak(expected, desired)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                expected = false;
-            }
-            //log msg list lock acquired
-
-            g_xma_singleton->log_msg_list.emplace_back(XmaLogMsg{});
-            auto& tmp1 = g_xma_singleton->log_msg_list.back();
-            tmp1.level = level;
-            tmp1.msg = std::string(msg_buff);
-
-            if (level <= XMA_ERROR_LOG) {
-                //Flush log msg queue for all error
-                //Else application may exit/crash early
-                while (!g_xma_singleton->log_msg_list.empty()) {
-                    auto itr1 = g_xma_singleton->log_msg_list.begin();
-                    xclLogMsg(NULL, (xrtLogMsgLevel)itr1->level, "XMA", itr1->msg.c_str());
-                    g_xma_singleton->log_msg_list.pop_front();
-                }
-            }
-
-            //Release log msg list lock
-            g_xma_singleton->log_msg_list_locked = false;
-        } else {
-            xclLogMsg(NULL, (xrtLogMsgLevel)level, "XMA", msg_buff);
+        ring->head.store(head + 1, std::memory_order_release);
+
+        if (level <= XMA_ERROR_LOG) {
+            //Flush log msgs of this thread for all error
+            //Else application may exit/crash early
+            drain_log_ring(ring, true);
         }
     }
 }
-
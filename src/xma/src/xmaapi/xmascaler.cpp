@@ -184,6 +184,15 @@ xma_scaler_session_create(XmaScalerProperties *sc_props)
     int32_t rc, dev_index, cu_index;
     dev_index = sc_props->dev_index;
     cu_index = sc_props->cu_index;
+    if (dev_index == XMA_AUTO_PLACEMENT) {
+        if (xma_core::utils::select_session_cu(sc_props->cu_name, dev_index, cu_index, XMA_SCALER_MOD) != XMA_SUCCESS) {
+            free(sc_session);
+            return nullptr;
+        }
+        //Report placement back to application
+        sc_props->dev_index = sc_session->props.dev_index = dev_index;
+        sc_props->cu_index = sc_session->props.cu_index = cu_index;
+    }
 
     XmaHwCfg *hwcfg = &g_xma_singleton->hwcfg;
     if (dev_index >= hwcfg->num_devices || dev_index < 0) {
@@ -25,11 +25,13 @@
 #include "core/common/device.h"
 
 #include <algorithm>
+#include <bitset>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 
 using namespace std;
@@ -237,6 +239,145 @@ xma_plg_buffer_free(XmaSession s_handle, XmaBufferObj b_obj)
     delete b_obj_priv;
 }
 
+XmaFramePool*
+xma_plg_frame_pool_create(XmaSession s_handle, XmaFrameProperties *frame_props,
+                          int32_t num_frames, bool device_only_buffer,
+                          int32_t* return_code)
+{
+    if (return_code) *return_code = XMA_ERROR;
+    if (!frame_props || num_frames <= 0) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_frame_pool_create failed. Invalid frame properties or number of frames.");
+        return nullptr;
+    }
+    if (frame_props->width <= 0 || frame_props->height <= 0 ||
+        frame_props->width > MAX_FRAME_W_H || frame_props->height > MAX_FRAME_W_H) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_frame_pool_create failed. Frame size is invalid: w=%d, h=%d", frame_props->width, frame_props->height);
+        return nullptr;
+    }
+
+    // TODO: Get plane size for each plane, as in xma_frame_alloc
+    size_t plane_size = static_cast<size_t>(frame_props->width) * frame_props->height;
+    int32_t num_planes = xma_frame_planes_get(frame_props);
+    std::vector<XmaFrame*> frames;
+    for (int32_t i = 0; i < num_frames; i++) {
+        XmaFrameData frame_data;
+        memset(&frame_data, 0, sizeof(frame_data));
+        bool failed = false;
+        for (int32_t p = 0; p < num_planes && !failed; p++) {
+            int32_t rc = XMA_ERROR;
+            XmaBufferObj b_obj = xma_plg_buffer_alloc(s_handle, plane_size, device_only_buffer, &rc);
+            if (rc != XMA_SUCCESS) {
+                failed = true;
+                break;
+            }
+            frame_data.dev_buf[p] = new XmaBufferObj(b_obj);
+        }
+
+        XmaFrame* frame = failed ? nullptr : xma_frame_from_device_buffers(frame_props, &frame_data, false);
+        if (!frame) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_frame_pool_create failed to allocate frame %d", i);
+            for (int32_t p = 0; p < num_planes; p++) {
+                if (!frame_data.dev_buf[p])
+                    continue;
+                xma_plg_buffer_free(s_handle, *frame_data.dev_buf[p]);
+                delete frame_data.dev_buf[p];
+            }
+            for (auto f : frames)
+                xma_frame_free(f);
+            return nullptr;
+        }
+        frames.push_back(frame);
+    }
+
+    XmaFramePool* pool = xma_frame_pool_create_from_frames(frames.data(), num_frames);
+    if (!pool) {
+        for (auto f : frames)
+            xma_frame_free(f);
+        return nullptr;
+    }
+
+    if (return_code) *return_code = XMA_SUCCESS;
+    return pool;
+}
+
+// Check that a buffer can be used by the session's kernel as it is on the device
+static int32_t
+check_zero_copy_buffer(XmaSession s_handle, const XmaBufferRef& ref, int32_t arg_num)
+{
+    if (ref.buffer_type != XMA_DEVICE_BUFFER_TYPE && ref.buffer_type != XMA_DEVICE_ONLY_BUFFER_TYPE) {
+        xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "Zero-copy handoff needs device buffers");
+        return XMA_ERROR;
+    }
+    XmaBufferObj* b_obj = ref.xma_device_buf;
+    if (xma_core::utils::xma_check_device_buffer(b_obj) != XMA_SUCCESS)
+        return XMA_ERROR;
+    if (b_obj->dev_index != s_handle.hw_session.dev_index) {
+        xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "Zero-copy handoff not possible. Buffer is on device %d, session on device %d",
+                   b_obj->dev_index, s_handle.hw_session.dev_index);
+        return XMA_ERROR;
+    }
+
+    auto priv1 = reinterpret_cast<XmaHwSessionPrivate*>(s_handle.hw_session.private_do_not_use);
+    XmaHwKernel* kernel_info = priv1->kernel_info;
+    if (kernel_info->soft_kernel)
+        return XMA_SUCCESS;
+    auto arg_to_mem_itr1 = kernel_info->CU_arg_to_mem_info.find(arg_num);
+    if (arg_num >= 0 && arg_to_mem_itr1 != kernel_info->CU_arg_to_mem_info.end()) {
+        if (arg_to_mem_itr1->second == b_obj->bank_index)
+            return XMA_SUCCESS;
+        xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "Zero-copy handoff not possible. Buffer is in ddr_bank %d, arg_num %d is connected to ddr_bank %d",
+                   b_obj->bank_index, arg_num, arg_to_mem_itr1->second);
+        return XMA_ERROR;
+    }
+    std::bitset<MAX_DDR_MAP> tmp_bset = kernel_info->ip_ddr_mapping;
+    if (b_obj->bank_index >= 0 && b_obj->bank_index < MAX_DDR_MAP && tmp_bset[b_obj->bank_index])
+        return XMA_SUCCESS;
+    xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "Zero-copy handoff not possible. Buffer is in ddr_bank %d, CU ddr_bank mapping: %s",
+               b_obj->bank_index, tmp_bset.to_string().c_str());
+    return XMA_ERROR;
+}
+
+int32_t
+xma_plg_frame_handoff(XmaSession s_handle, XmaFrame *frame, int32_t arg_num)
+{
+    if (xma_core::utils::check_xma_session(s_handle) != XMA_SUCCESS) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_frame_handoff failed. XMASession is corrupted.");
+        return XMA_ERROR;
+    }
+    if (!frame) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_frame_handoff failed. frame is NULL");
+        return XMA_ERROR;
+    }
+
+    int32_t num_planes = xma_frame_planes_get(&frame->frame_props);
+    for (int32_t i = 0; i < num_planes; i++) {
+        if (check_zero_copy_buffer(s_handle, frame->data[i], arg_num) != XMA_SUCCESS)
+            return XMA_ERROR;
+    }
+    for (int32_t i = 0; i < num_planes; i++)
+        frame->data[i].refcount++;
+
+    return XMA_SUCCESS;
+}
+
+int32_t
+xma_plg_data_buffer_handoff(XmaSession s_handle, XmaDataBuffer *data, int32_t arg_num)
+{
+    if (xma_core::utils::check_xma_session(s_handle) != XMA_SUCCESS) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_data_buffer_handoff failed. XMASession is corrupted.");
+        return XMA_ERROR;
+    }
+    if (!data) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_data_buffer_handoff failed. data buffer is NULL");
+        return XMA_ERROR;
+    }
+    if (check_zero_copy_buffer(s_handle, data->data, arg_num) != XMA_SUCCESS)
+        return XMA_ERROR;
+    data->data.refcount++;
+
+    return XMA_SUCCESS;
+}
+
 int32_t
 xma_plg_buffer_write(XmaSession s_handle,
                      XmaBufferObj  b_obj,
@@ -312,57 +453,24 @@ xma_plg_buffer_read(XmaSession s_handle,
     } 
 }
 
+// Claim a free execbo without the execbo lock. Search starts after the last
+// claimed execbo so that an execbo is not reused right after completion.
 int32_t xma_plg_execbo_avail_get(XmaSession s_handle)
 {
     auto priv1 = reinterpret_cast<XmaHwSessionPrivate*>(s_handle.hw_session.private_do_not_use);
-    //std::cout << "Debug - " << __func__ << "; " << __LINE__ << std::endl;    
-    int32_t num_execbo = priv1->num_execbo_allocated;
-    if (priv1->execbo_lru.size() == 0) {
-        int32_t i;
-        for (i = 0; i < num_execbo; i++) {
-            XmaHwExecBO* execbo_tmp1 = &priv1->kernel_execbos[i];
-            if (!execbo_tmp1->in_use) {
-                priv1->execbo_lru.emplace_back(i);
-            }
+    uint64_t mask = priv1->execbo_free_mask;
+    while (mask != 0) {
+        int32_t last = priv1->execbo_last;
+        uint64_t after = (last < 0 || last >= 63) ? 0 : mask & (~0ULL << (last + 1));
+        int32_t i = __builtin_ctzll(after ? after : mask);
+        if (priv1->execbo_free_mask.compare_exchange_weak(mask, mask & ~(1ULL << i))) {
+            priv1->execbo_last = i;
+            return i;
         }
     }
-    if (priv1->execbo_lru.size() != 0) {
-        uint32_t val = priv1->execbo_lru.back();
-        priv1->execbo_lru.pop_back();
-        XmaHwExecBO* execbo_tmp1 = &priv1->kernel_execbos[val];
-        execbo_tmp1->in_use = true;
-        priv1->execbo_to_check.emplace_back(val);
-        return val;
-    }
     return -1;
 }
 
-int32_t xma_plg_execbo_avail_get2(XmaSession s_handle)
-{
-    auto priv1 = reinterpret_cast<XmaHwSessionPrivate*>(s_handle.hw_session.private_do_not_use);
-    //std::cout << "Debug - " << __func__ << "; " << __LINE__ << std::endl;
-    int32_t num_execbo = priv1->num_execbo_allocated;
-    int32_t i; 
-    int32_t rc = -1;
-    bool    found = false;
-    //NOTE: execbo lock must be already acquired
-
-    for (i = 0; i < num_execbo; i++) {
-        XmaHwExecBO* execbo_tmp1 = &priv1->kernel_execbos[i];
-        if (!execbo_tmp1->in_use) {
-            found = true;
-        }
-        if (found) {
-            execbo_tmp1->in_use = true;
-            rc = i;
-            break;
-        }
-    }
-    //std::cout << "Sarab: Debug - " << __func__ << "; " << __LINE__ << std::endl;
-
-    return rc;
-}
-
 XmaCUCmdObj xma_plg_schedule_work_item(XmaSession s_handle,
                                  void            *regmap,
                                  int32_t         regmap_size,
@@ -426,56 +534,45 @@ XmaCUCmdObj xma_plg_schedule_work_item(XmaSession s_handle,
     bool expected = false;
     bool desired = true;
     int32_t bo_idx = -1;
-    //With KDS2.0 ensure no outstanding command
-    while (priv1->num_cu_cmds != 0 && !g_xma_singleton->kds_old) {
+    //With KDS2.0 commands of a session run in order on its CU, so up to
+    //num_execbo_allocated commands (xma_exec_mode) are kept in flight.
+    //Finding a free execbo below waits for a slot when all are in use.
+
+    // Find an available execBO buffer, waiting for one to complete
+    // while all are in use
+    bo_idx = xma_plg_execbo_avail_get(s_handle);
+    while (bo_idx == -1) {
+        xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "No available execbo found");
         std::unique_lock<std::mutex> lk(priv1->m_mutex);
-        priv1->kernel_done_or_free.wait_for(lk, std::chrono::milliseconds(1));
+        //Timeout as a free execbo may be reported before this wait
+        priv1->execbo_is_free.wait_for(lk, std::chrono::milliseconds(100),
+            [priv1] { return priv1->execbo_free_mask != 0; });
+        lk.unlock();
+        bo_idx = xma_plg_execbo_avail_get(s_handle);
     }
 
-    // Find an available execBO buffer
-    uint32_t itr = 0;
-    while (true) {
+    expected = false;
+    while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
+        std::this_thread::yield();
         expected = false;
-        while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
-            std::this_thread::yield();
-            expected = false;
-        }
-
-        if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
-            bo_idx = xma_plg_execbo_avail_get2(s_handle);
-        } else {
-            bo_idx = xma_plg_execbo_avail_get(s_handle);
-        }
-        if (bo_idx != -1) {
-            break;
-        }
-        xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "No available execbo found");
-        priv1->execbo_locked = false;
-        if (itr > 15) {
-            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "Unable to find free execbo to use\n");
-            if (return_code) *return_code = XMA_ERROR;
-            return cmd_obj_error;
-        }
-        std::unique_lock<std::mutex> lk(priv1->m_mutex);
-        priv1->execbo_is_free.wait(lk);
-        lk.unlock();
-        itr++;
     }
-            
-    priv1->kernel_execbos[bo_idx].xrt_run =  xrt::run(priv1->kernel_execbos[bo_idx].xrt_kernel);
-    auto cu_cmd = reinterpret_cast<ert_start_kernel_cmd*>(priv1->kernel_execbos[bo_idx].xrt_run.get_ert_packet());
-    // Copy reg_map into execBO buffer 
-    memcpy(&cu_cmd->data + cu_cmd->extra_cu_masks, src, regmap_size);
-
-    //With KDS2.0 ensure no outstanding command
-    if (priv1->num_cu_cmds != 0 && !g_xma_singleton->kds_old) {
-        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "Session id: %d, type: %s. Unexpected error. Outstanding cmd found.", s_handle.session_id, xma_core::get_session_name(s_handle.session_type).c_str());
-        priv1->execbo_locked = false;
-        if (return_code) *return_code = XMA_ERROR;
-        return cmd_obj_error;
+    priv1->kernel_execbos[bo_idx].in_use = true;
+    if (g_xma_singleton->cpu_mode != XMA_CPU_MODE2) {
+        priv1->execbo_to_check.emplace_back(bo_idx);
     }
-
-    if (priv1->num_cu_cmds != 0) {
+            
+    // Run of the execbo is reused; its previous command has completed
+    auto& execbo = priv1->kernel_execbos[bo_idx];
+    auto cu_cmd = reinterpret_cast<ert_start_kernel_cmd*>(execbo.xrt_run.get_ert_packet());
+    // Copy reg_map into execBO buffer, clearing what a longer reg_map
+    // of the previous command left behind
+    uint8_t* cmd_regmap = reinterpret_cast<uint8_t*>(&cu_cmd->data + cu_cmd->extra_cu_masks);
+    memcpy(cmd_regmap, src, regmap_size);
+    if (execbo.regmap_size > regmap_size)
+        memset(cmd_regmap + regmap_size, 0, execbo.regmap_size - regmap_size);
+    execbo.regmap_size = regmap_size;
+
+    if (priv1->num_cu_cmds != 0 && g_xma_singleton->kds_old) {
 //#ifdef __GNUC__
 //# pragma GCC diagnostic push
 //# pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -499,6 +596,11 @@ XmaCUCmdObj xma_plg_schedule_work_item(XmaSession s_handle,
         catch (const xrt_core::system_error&) {
             xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD,
                 "Failed to submit kernel start with xclExecBuf");
+            execbo.in_use = false;
+            if (g_xma_singleton->cpu_mode != XMA_CPU_MODE2) {
+                priv1->execbo_to_check.pop_back();
+            }
+            priv1->execbo_free_mask |= 1ULL << bo_idx;
             priv1->execbo_locked = false;
             if (return_code) *return_code = XMA_ERROR;
             return cmd_obj_error;
@@ -634,56 +736,45 @@ XmaCUCmdObj xma_plg_schedule_cu_cmd(XmaSession s_handle,
     bool expected = false;
     bool desired = true;
     int32_t bo_idx = -1;
-    //With KDS2.0 ensure no outstanding command
-    while (priv1->num_cu_cmds != 0 && !g_xma_singleton->kds_old) {
-        std::unique_lock<std::mutex> lk(priv1->m_mutex);
-        priv1->kernel_done_or_free.wait_for(lk, std::chrono::milliseconds(1));
-    }
-
-    // Find an available execBO buffer
-    uint32_t itr = 0;
-    while (true) {
-        expected = false;
-        while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
-            std::this_thread::yield();
-            expected = false;
-        }
-
-        if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
-            bo_idx = xma_plg_execbo_avail_get2(s_handle);
-        } else {
-            bo_idx = xma_plg_execbo_avail_get(s_handle);
-        }
-        if (bo_idx != -1) {
-            break;
-        }
-        priv1->execbo_locked = false;
+    //With KDS2.0 commands of a session run in order on its CU, so up to
+    //num_execbo_allocated commands (xma_exec_mode) are kept in flight.
+    //Finding a free execbo below waits for a slot when all are in use.
+
+    // Find an available execBO buffer, waiting for one to complete
+    // while all are in use
+    bo_idx = xma_plg_execbo_avail_get(s_handle);
+    while (bo_idx == -1) {
         xma_logmsg(XMA_DEBUG_LOG, XMAPLUGIN_MOD, "No available execbo found");
-        if (itr > 15) {
-            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "Unable to find free execbo to use\n");
-            if (return_code) *return_code = XMA_ERROR;
-            return cmd_obj_error;
-        }
         std::unique_lock<std::mutex> lk(priv1->m_mutex);
-        priv1->execbo_is_free.wait(lk);
+        //Timeout as a free execbo may be reported before this wait
+        priv1->execbo_is_free.wait_for(lk, std::chrono::milliseconds(100),
+            [priv1] { return priv1->execbo_free_mask != 0; });
         lk.unlock();
-        itr++;
+        bo_idx = xma_plg_execbo_avail_get(s_handle);
     }
 
-    priv1->kernel_execbos[bo_idx].xrt_run = xrt::run(priv1->kernel_execbos[bo_idx].xrt_kernel);
-    auto cu_cmd = reinterpret_cast<ert_start_kernel_cmd*>(priv1->kernel_execbos[bo_idx].xrt_run.get_ert_packet());
-    // Copy reg_map into execBO buffer 
-    memcpy(&cu_cmd->data + cu_cmd->extra_cu_masks, src, regmap_size);
-
-    //With KDS2.0 ensure no outstanding command
-    if (priv1->num_cu_cmds != 0 && !g_xma_singleton->kds_old) {
-        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "Session id: %d, type: %s. Unexpected error. Outstanding cmd found.", s_handle.session_id, xma_core::get_session_name(s_handle.session_type).c_str());
-        priv1->execbo_locked = false;
-        if (return_code) *return_code = XMA_ERROR;
-        return cmd_obj_error;
+    expected = false;
+    while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
+        std::this_thread::yield();
+        expected = false;
+    }
+    priv1->kernel_execbos[bo_idx].in_use = true;
+    if (g_xma_singleton->cpu_mode != XMA_CPU_MODE2) {
+        priv1->execbo_to_check.emplace_back(bo_idx);
     }
 
-    if (priv1->num_cu_cmds != 0) {
+    // Run of the execbo is reused; its previous command has completed
+    auto& execbo = priv1->kernel_execbos[bo_idx];
+    auto cu_cmd = reinterpret_cast<ert_start_kernel_cmd*>(execbo.xrt_run.get_ert_packet());
+    // Copy reg_map into execBO buffer, clearing what a longer reg_map
+    // of the previous command left behind
+    uint8_t* cmd_regmap = reinterpret_cast<uint8_t*>(&cu_cmd->data + cu_cmd->extra_cu_masks);
+    memcpy(cmd_regmap, src, regmap_size);
+    if (execbo.regmap_size > regmap_size)
+        memset(cmd_regmap + regmap_size, 0, execbo.regmap_size - regmap_size);
+    execbo.regmap_size = regmap_size;
+
+    if (priv1->num_cu_cmds != 0 && g_xma_singleton->kds_old) {
 //#ifdef __GNUC__
 //# pragma GCC diagnostic push
 //# pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -707,6 +798,11 @@ XmaCUCmdObj xma_plg_schedule_cu_cmd(XmaSession s_handle,
         catch (const xrt_core::system_error&) {
             xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD,
                 "Failed to submit kernel start with xclExecBuf");
+            execbo.in_use = false;
+            if (g_xma_singleton->cpu_mode != XMA_CPU_MODE2) {
+                priv1->execbo_to_check.pop_back();
+            }
+            priv1->execbo_free_mask |= 1ULL << bo_idx;
             priv1->execbo_locked = false;
             if (return_code) *return_code = XMA_ERROR;
             return cmd_obj_error;
@@ -842,7 +938,8 @@ int32_t xma_plg_cu_cmd_status(XmaSession s_handle, XmaCUCmdObj* cmd_obj_array, i
         } else if (!all_done) {
             if (g_xma_singleton->cpu_mode == XMA_CPU_MODE1) {
                 std::unique_lock<std::mutex> lk(priv1->m_mutex);
-                priv1->kernel_done_or_free.wait(lk);
+                //Timeout as the completion may be reported before this wait
+                priv1->kernel_done_or_free.wait_for(lk, std::chrono::milliseconds(100));
             } else if (g_xma_singleton->cpu_mode == XMA_CPU_MODE2) {
                 std::this_thread::yield();
             } else {
@@ -858,6 +955,101 @@ int32_t xma_plg_cu_cmd_status(XmaSession s_handle, XmaCUCmdObj* cmd_obj_array, i
     return XMA_SUCCESS;
 }
 
+int32_t xma_plg_cu_cmd_status_multi(XmaSession* s_handles, XmaCUCmdObj* cmd_obj_array, int32_t num_cu_objs,
+                                    bool wait_for_all, int32_t timeout_ms, int32_t* num_done)
+{
+    if (s_handles == nullptr || cmd_obj_array == nullptr) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "s_handles or cmd_obj_array is NULL");
+        return XMA_ERROR;
+    }
+    if (num_cu_objs <= 0) {
+        xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "num_cu_objs of %d is invalid", num_cu_objs);
+        return XMA_ERROR;
+    }
+    for (int32_t i = 0; i < num_cu_objs; i++) {
+        XmaSession& s_handle = s_handles[i];
+        XmaCUCmdObj& cmd = cmd_obj_array[i];
+        if (xma_core::utils::check_xma_session(s_handle) != XMA_SUCCESS) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "xma_plg_cu_cmd_status_multi failed. XMASession is corrupted.");
+            return XMA_ERROR;
+        }
+        auto priv1 = reinterpret_cast<XmaHwSessionPrivate*>(s_handle.hw_session.private_do_not_use);
+        if (priv1->using_work_item_done) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "Session id: %d, type: %s. xma_plg_cu_cmd_status_multi & xma_plg_is_work_item_done both can not be used in same session", s_handle.session_id, xma_core::get_session_name(s_handle.session_type).c_str());
+            return XMA_ERROR;
+        }
+        if (cmd.do_not_use1 != s_handle.session_signature) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "cmd_obj_array is corrupted-5");
+            return XMA_ERROR;
+        }
+        if (s_handle.session_type < XMA_ADMIN && cmd.cu_index != priv1->kernel_info->cu_index) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "cmd_obj_array is corrupted-1");
+            return XMA_ERROR;
+        }
+        if (cmd.cmd_id1 == 0 || cmd.cu_index == -1) {
+            xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "cmd_obj is invalid. Schedule_command may have  failed");
+            return XMA_ERROR;
+        }
+        priv1->using_cu_cmd_status = true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+    std::vector<bool> finished(num_cu_objs, false);
+    int32_t done = 0;
+    while (true) {
+        uint64_t done_gen = g_xma_singleton->cu_cmd_done_gen;
+        //Reap completions and check pending cmds, one execbo lock per session
+        for (int32_t i = 0; i < num_cu_objs; i++) {
+            if (finished[i]) {
+                continue;
+            }
+            auto priv1 = reinterpret_cast<XmaHwSessionPrivate*>(s_handles[i].hw_session.private_do_not_use);
+            bool expected = false;
+            bool desired = true;
+            while (!priv1->execbo_locked.compare_exchange_weak(expected, desired)) {
+                std::this_thread::yield();
+                expected = false;
+            }
+            if (xma_core::utils::check_all_execbo(s_handles[i]) != XMA_SUCCESS) {
+                xma_logmsg(XMA_ERROR_LOG, XMAPLUGIN_MOD, "cu_cmd_status_multi->check_all_execbo. Unexpected error");
+                priv1->execbo_locked = false;
+                return XMA_ERROR;
+            }
+            for (int32_t j = i; j < num_cu_objs; j++) {
+                if (finished[j] || s_handles[j].hw_session.private_do_not_use != priv1) {
+                    continue;
+                }
+                if (priv1->CU_cmds.find(cmd_obj_array[j].cmd_id1) == priv1->CU_cmds.end()) {
+                    finished[j] = true;
+                    cmd_obj_array[j].cmd_finished = true;
+                    done++;
+                }
+            }
+            priv1->execbo_locked = false;
+        }
+
+        if (wait_for_all ? done == num_cu_objs : done > 0) {
+            break;
+        }
+        if (timeout_ms == 0 || (timeout_ms > 0 && std::chrono::steady_clock::now() >= deadline)) {
+            if (num_done) *num_done = done;
+            return XMA_ERROR_TIMEOUT;
+        }
+        //Completions are reaped by xma_thread2 or other callers; wait for any of them.
+        //Timeout as a cu may be stuck or complete without being reaped yet
+        std::unique_lock<std::mutex> lk(g_xma_singleton->cu_cmd_done_mutex);
+        auto wait_until = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+        if (timeout_ms > 0 && deadline < wait_until) {
+            wait_until = deadline;
+        }
+        g_xma_singleton->cu_cmd_done_any.wait_until(lk, wait_until,
+            [done_gen] { return g_xma_singleton->cu_cmd_done_gen != done_gen; });
+    }
+
+    if (num_done) *num_done = done;
+    return XMA_SUCCESS;
+}
+
 int32_t xma_plg_is_work_item_done(XmaSession s_handle, uint32_t timeout_ms)
 {
     if (xma_core::utils::check_xma_session(s_handle) != XMA_SUCCESS) {
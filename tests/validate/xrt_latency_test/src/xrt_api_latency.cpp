@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+
+#include <sched.h>
+
+#include "cmdlineparser.h"
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_kernel.h"
+
+using us_t = std::chrono::duration<double, std::micro>;
+using Clock = std::chrono::steady_clock;
+
+struct krnl_info {
+    std::string     name;
+    bool            new_style;
+};
+
+struct krnl_info krnl = {"hello", false};
+
+/*
+ * How a single outstanding command is waited for
+ *   interrupt: block in xrt::run::wait()
+ *   poll:      spin on xrt::run::state() until the command is done
+ *   hybrid:    spin for a bounded time, then block in xrt::run::wait()
+ */
+enum class wait_mode { interrupt, poll, hybrid };
+
+static const char*
+to_string(wait_mode mode)
+{
+  switch (mode) {
+  case wait_mode::interrupt:
+    return "interrupt";
+  case wait_mode::poll:
+    return "poll";
+  case wait_mode::hybrid:
+    return "hybrid";
+  }
+  return "unknown";
+}
+
+static void usage(const char *prog)
+{
+  std::cout << "Usage: " << prog << " -p <Platform Test Area Path> [options]\n"
+    << "options:\n"
+    << "    -k       xclbin (imply old style verify.xclbin is used)\n"
+    << "    -d       device index or BDF\n"
+    << "    -a       number of commands measured per wait mode\n"
+    << "    -m       wait mode: interrupt, poll, hybrid or all\n"
+    << "    -s       spin time in us before blocking in hybrid mode\n"
+    << "    -c       pin the test to this CPU (-1 to not pin)\n"
+    << "    -v       verbose result\n"
+    << std::endl;
+}
+
+static bool
+is_done(ert_cmd_state state)
+{
+  return state >= ERT_CMD_STATE_COMPLETED && state != ERT_CMD_STATE_SUBMITTED;
+}
+
+/*
+ * Issue one command at a time and return the start to completion
+ * latency of each command in us.
+ */
+static std::vector<double>
+runTest(xrt::run& run, unsigned int total, wait_mode mode, unsigned int spin_us)
+{
+  std::vector<double> latency;
+  latency.reserve(total);
+  auto spin = std::chrono::microseconds(spin_us);
+
+  for (unsigned int i = 0; i < total; i++) {
+    auto start = Clock::now();
+    run.start();
+
+    Clock::time_point end;
+    switch (mode) {
+    case wait_mode::interrupt:
+      run.wait();
+      end = Clock::now();
+      break;
+    case wait_mode::poll:
+      while (!is_done(run.state()))
+        ;
+      end = Clock::now();
+      break;
+    case wait_mode::hybrid:
+      while (!is_done(run.state()) && Clock::now() - start < spin)
+        ;
+      if (!is_done(run.state()))
+        run.wait();
+      end = Clock::now();
+      break;
+    }
+
+    // Reap the command outside of the measured interval
+    if (run.wait() != ERT_CMD_STATE_COMPLETED)
+      throw std::runtime_error(std::string("Command failed in ") + to_string(mode) + " mode");
+
+    latency.push_back(us_t(end - start).count());
+  }
+
+  return latency;
+}
+
+/* Nearest rank percentile of sorted samples */
+static double
+percentile(const std::vector<double>& sorted, double pct)
+{
+  auto rank = static_cast<size_t>(std::ceil(pct / 100.0 * sorted.size()));
+  return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+}
+
+static void
+report(wait_mode mode, std::vector<double>& latency, bool verbose)
+{
+  std::sort(latency.begin(), latency.end());
+
+  if (verbose) {
+    double sum = 0;
+    for (auto l : latency)
+      sum += l;
+    std::cout << "Mode " << to_string(mode)
+              << " Commands: " << latency.size()
+              << std::setprecision(2) << std::fixed
+              << " avg: " << sum / latency.size() << " us"
+              << std::endl;
+  }
+
+  std::cout << "Latency (" << to_string(mode) << "):"
+            << std::setprecision(2) << std::fixed
+            << " min " << latency.front()
+            << " p50 " << percentile(latency, 50)
+            << " p99 " << percentile(latency, 99)
+            << " p99.9 " << percentile(latency, 99.9)
+            << " max " << latency.back()
+            << " us (" << krnl.name << ")"
+            << std::endl;
+}
+
+static void
+pinCpu(int cpu)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set))
+    throw std::runtime_error("Failed to pin test to CPU " + std::to_string(cpu));
+}
+
+int testLatency(const std::string& dev, const std::string& xclbin_fn, const std::vector<wait_mode>& modes,
+                unsigned int total, unsigned int spin_us, bool verbose)
+{
+  xrt::device device(dev);
+  auto uuid = device.load_xclbin(xclbin_fn);
+  auto hello = xrt::kernel(device, uuid.get(), krnl.name);
+
+  auto run = xrt::run(hello);
+  run.set_arg(0, xrt::bo(device, 20, hello.group_id(0)));
+
+  /* Warm up so first command setup cost is not measured */
+  for (int i = 0; i < 16; i++) {
+    run.start();
+    run.wait();
+  }
+
+  for (auto mode : modes) {
+    auto latency = runTest(run, total, mode, spin_us);
+    report(mode, latency, verbose);
+  }
+
+  return 0;
+}
+
+int _main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    usage(argv[0]);
+    throw std::runtime_error("Number of argument should not less than 2");
+  }
+
+  // Command Line Parser
+  sda::utils::CmdLineParser parser;
+
+  // Switches
+  //**************//"<Full Arg>",  "<Short Arg>", "<Description>", "<Default>"
+  parser.addSwitch("--path",    "-p", "platform test area path", "");
+  parser.addSwitch("--kernel",  "-k", "kernel (imply old style verify.xclbin is used)", "");
+  parser.addSwitch("--device",  "-d", "device id", "0");
+  parser.addSwitch("--total",   "-a", "number of commands measured per wait mode", "10000");
+  parser.addSwitch("--mode",    "-m", "wait mode: interrupt, poll, hybrid or all", "all");
+  parser.addSwitch("--spin",    "-s", "spin time in us before blocking in hybrid mode", "50");
+  parser.addSwitch("--cpu",     "-c", "pin the test to this CPU", "-1");
+  parser.addSwitch("--verbose", "-v", "verbose output", "", true);
+  parser.parse(argc, argv);
+
+  /* Could be BDF or device index */
+  std::string device_str = parser.value("device");
+  int total = parser.value_to_int("total");
+  int spin_us = parser.value_to_int("spin");
+  int cpu = parser.value_to_int("cpu");
+  std::string mode_str = parser.value("mode");
+  std::string xclbin_fn = parser.value("kernel");
+  if (xclbin_fn.empty()) {
+      std::string test_path = parser.value("path");
+      if (test_path.empty()) {
+        usage(argv[0]);
+        throw std::runtime_error("Platform test area path or xclbin is required");
+      }
+      xclbin_fn = test_path + "/verify.xclbin";
+      krnl.name = "verify";
+      krnl.new_style = true;
+  }
+  bool verbose = parser.isValid("verbose");
+
+  std::vector<wait_mode> modes;
+  if (mode_str == "interrupt" || mode_str == "all")
+    modes.push_back(wait_mode::interrupt);
+  if (mode_str == "poll" || mode_str == "all")
+    modes.push_back(wait_mode::poll);
+  if (mode_str == "hybrid" || mode_str == "all")
+    modes.push_back(wait_mode::hybrid);
+
+  /* Sanity check */
+  std::ifstream infile(xclbin_fn);
+  if (!infile.good())
+    throw std::runtime_error("Wrong xclbin file " + xclbin_fn);
+
+  if (modes.empty())
+    throw std::runtime_error("Invalid wait mode " + mode_str);
+
+  if (total <= 0)
+    throw std::runtime_error("Negative/Zero total command number");
+
+  if (spin_us < 0)
+    throw std::runtime_error("Negative spin time");
+
+  if (cpu >= 0)
+    pinCpu(cpu);
+
+  testLatency(device_str, xclbin_fn, modes, total, spin_us, verbose);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  try {
+    _main(argc, argv);
+    std::cout << "TEST PASSED" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return EXIT_FAILURE;
+};
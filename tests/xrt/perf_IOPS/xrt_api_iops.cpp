@@ -1,32 +1,103 @@
 /**
  * SPDX-License-Identifier: Apache-2.0
- * Copyright (C) 2020-2021 Xilinx, Inc. All rights reserved.
+ * Copyright (C) 2020-2022 Xilinx, Inc. All rights reserved.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 #include <chrono>
 
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_bo.h"
 #include "xrt/xrt_kernel.h"
+#include "experimental/xrt_runlist.h"
+#include "experimental/xrt_xclbin.h"
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 )
 #endif
 
+using Clock = std::chrono::high_resolution_clock;
+
 static void usage()
 {
-  std::cout  << "Usage: test -k <xclbin>\n";
+  std::cout << "Usage: test -k <xclbin> [options]\n"
+            << "options:\n"
+            << "    -d <index>        device index (default 0)\n"
+            << "    -n <name>         kernel name (default hello)\n"
+            << "    -t <n,n,...>      host thread counts to sweep (default 1,2,4,8)\n"
+            << "    -l <n,n,...>      queue depths per thread to sweep (default 1,8,32,128)\n"
+            << "    -c <n,n,...>      CU counts to sweep (default 1,2,4,... up to all CUs)\n"
+            << "    -a <n>            commands per thread per configuration (default 10000)\n"
+            << "    -b <n>            runlist batch size (default 64)\n"
+            << "    -j <file>         write results as JSON to file\n";
+}
+
+// Submission API used by a configuration
+enum class api_type { run, runlist };
+
+static const char*
+to_string(api_type api)
+{
+  return api == api_type::run ? "run" : "runlist";
 }
 
-static double
+struct config
+{
+  api_type api;
+  unsigned int cus;
+  unsigned int threads;
+  unsigned int depth;
+};
+
+struct result
+{
+  config cfg;
+  unsigned long commands;
+  double duration_us;
+
+  double
+  iops() const
+  {
+    return commands * 1000.0 * 1000.0 / duration_us;
+  }
+};
+
+// Start gate shared by the threads of one configuration
+struct gate
+{
+  std::atomic<unsigned int> ready{0};
+  std::atomic<bool> go{false};
+};
+
+static std::vector<unsigned int>
+parse_list(const std::string& str)
+{
+  std::vector<unsigned int> values;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    auto value = std::stoul(item);
+    if (value == 0)
+      throw std::runtime_error("Zero value in list '" + str + "'");
+    values.push_back(static_cast<unsigned int>(value));
+  }
+  return values;
+}
+
+// Keep 'depth' native runs in flight until 'total' commands completed
+static void
 runTest(std::vector<xrt::run>& cmds, unsigned int total)
 {
-  int i = 0;
+  size_t i = 0;
   unsigned int issued = 0, completed = 0;
-  auto start = std::chrono::high_resolution_clock::now();
 
   for (auto& cmd : cmds) {
     cmd.start();
@@ -34,7 +105,7 @@ runTest(std::vector<xrt::run>& cmds, unsigned int total)
       break;
   }
 
-  while (completed < total) {
+  while (completed < issued) {
     cmds[i].wait();
 
     completed++;
@@ -46,51 +117,245 @@ runTest(std::vector<xrt::run>& cmds, unsigned int total)
     if (++i == cmds.size())
       i = 0;
   }
-
-  auto end = std::chrono::high_resolution_clock::now();
-  return (std::chrono::duration_cast<std::chrono::microseconds>(end - start)).count();
 }
 
+// Submit the runs in batches of 'batch_size' using xrt::runlist
 static void
-testSingleThread(const xrt::device& device, const xrt::uuid& uuid)
+runBatchTest(const xrt::device& device, std::vector<xrt::run>& cmds, unsigned int total,
+             unsigned int batch_size)
 {
-  /* The command would incease */
-  std::vector<unsigned int> cmds_per_run = { 10,50,100,200,500,1000,1500,2000,3000,5000,10000,50000,100000,500000,1000000 };
-  int expected_cmds = 10000;
+  std::vector<xrt::runlist> lists;
+  for (size_t i = 0; i < cmds.size(); i += batch_size) {
+    xrt::runlist list{device};
+    for (size_t j = i; j < std::min<size_t>(i + batch_size, cmds.size()); ++j)
+      list.add(cmds[j]);
+    lists.push_back(std::move(list));
+  }
 
-  auto hello = xrt::kernel(device, uuid.get(), "hello");
+  unsigned int issued = 0, completed = 0;
+
+  size_t i = 0;
+  for (auto& list : lists) {
+    list.execute();
+    issued += list.size();
+    if (issued >= total)
+      break;
+  }
 
-  /* Create 'expected_cmds' commands if possible */
+  while (completed < issued) {
+    lists[i].wait();
+    completed += lists[i].size();
+    if (issued < total) {
+      lists[i].execute();
+      issued += lists[i].size();
+    }
+
+    if (++i == lists.size())
+      i = 0;
+  }
+}
+
+static void
+runThread(const xrt::device& device, const xrt::kernel& kernel, const config& cfg,
+          unsigned int total, unsigned int batch_size, gate& g,
+          Clock::time_point& start, Clock::time_point& end)
+{
   std::vector<xrt::run> cmds;
-  for (int i = 0; i < expected_cmds; i++) {
-    auto run = xrt::run(hello);
-    run.set_arg(0, xrt::bo(device, 20, hello.group_id(0)));
+  for (unsigned int i = 0; i < cfg.depth; i++) {
+    auto run = xrt::run(kernel);
+    run.set_arg(0, xrt::bo(device, 20, kernel.group_id(0)));
     cmds.push_back(std::move(run));
   }
-  std::cout << "Allocated commands, expect " << expected_cmds << ", created " << cmds.size() << std::endl;
 
-  for (auto num_cmds : cmds_per_run) {
-    double duration = runTest(cmds, num_cmds);
-    std::cout << "Commands: " << std::setw(7) << num_cmds
-              << " iops: " << (num_cmds * 1000.0 * 1000.0 / duration)
+  ++g.ready;
+  while (!g.go)
+    std::this_thread::yield();
+
+  start = Clock::now();
+  if (cfg.api == api_type::run)
+    runTest(cmds, total);
+  else
+    runBatchTest(device, cmds, total, std::min(batch_size, cfg.depth));
+  end = Clock::now();
+}
+
+static result
+runConfig(const xrt::device& device, const xrt::kernel& kernel, const config& cfg,
+          unsigned int total, unsigned int batch_size)
+{
+  gate g;
+  std::vector<Clock::time_point> start(cfg.threads), end(cfg.threads);
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < cfg.threads; i++)
+    threads.emplace_back(runThread, std::cref(device), std::cref(kernel), std::cref(cfg),
+                         total, batch_size, std::ref(g), std::ref(start[i]), std::ref(end[i]));
+
+  // Release all threads at once after their runs are created
+  while (g.ready < cfg.threads)
+    std::this_thread::yield();
+  g.go = true;
+
+  for (auto& t : threads)
+    t.join();
+
+  auto first = *std::min_element(start.begin(), start.end());
+  auto last = *std::max_element(end.begin(), end.end());
+  double duration = std::chrono::duration_cast<std::chrono::microseconds>(last - first).count();
+  return { cfg, static_cast<unsigned long>(total) * cfg.threads, duration };
+}
+
+static void
+printTable(const std::vector<result>& results)
+{
+  std::cout << std::setw(8) << "API"
+            << std::setw(6) << "CUs"
+            << std::setw(9) << "Threads"
+            << std::setw(7) << "Depth"
+            << std::setw(10) << "Commands"
+            << std::setw(12) << "IOPS"
+            << std::endl;
+  for (auto& r : results) {
+    std::cout << std::setw(8) << to_string(r.cfg.api)
+              << std::setw(6) << r.cfg.cus
+              << std::setw(9) << r.cfg.threads
+              << std::setw(7) << r.cfg.depth
+              << std::setw(10) << r.commands
+              << std::setw(12) << std::setprecision(0) << std::fixed << r.iops()
               << std::endl;
   }
 }
 
+static void
+writeJson(const std::string& fnm, const std::string& kname, const std::vector<result>& results)
+{
+  std::ofstream ofs(fnm);
+  if (!ofs)
+    throw std::runtime_error("Failed to open " + fnm);
+
+  ofs << "{\n  \"kernel\": \"" << kname << "\",\n  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto& r = results[i];
+    ofs << "    { \"api\": \"" << to_string(r.cfg.api) << "\""
+        << ", \"cus\": " << r.cfg.cus
+        << ", \"threads\": " << r.cfg.threads
+        << ", \"depth\": " << r.cfg.depth
+        << ", \"commands\": " << r.commands
+        << ", \"duration_us\": " << std::setprecision(0) << std::fixed << r.duration_us
+        << ", \"iops\": " << r.iops()
+        << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  ofs << "  ]\n}\n";
+}
+
+// Kernel object restricted to the first 'num' compute units
+static xrt::kernel
+getKernel(const xrt::device& device, const xrt::uuid& uuid, const std::string& kname,
+          const std::vector<std::string>& cu_names, unsigned int num)
+{
+  std::string name = kname + ":{";
+  for (unsigned int i = 0; i < num; i++)
+    name += (i ? "," : "") + cu_names[i];
+  name += "}";
+  return xrt::kernel(device, uuid.get(), name);
+}
+
 static int
 _main(int argc, char* argv[])
 {
-  if (argc < 3 || argv[1] != std::string("-k")) {
+  std::string xclbin_fn;
+  std::string kname = "hello";
+  std::string json_fn;
+  unsigned int device_index = 0;
+  unsigned int total = 10000;
+  unsigned int batch_size = 64;
+  std::vector<unsigned int> thread_counts = { 1, 2, 4, 8 };
+  std::vector<unsigned int> depths = { 1, 8, 32, 128 };
+  std::vector<unsigned int> cu_counts;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "-k")
+      xclbin_fn = value;
+    else if (arg == "-d")
+      device_index = std::stoi(value);
+    else if (arg == "-n")
+      kname = value;
+    else if (arg == "-t")
+      thread_counts = parse_list(value);
+    else if (arg == "-l")
+      depths = parse_list(value);
+    else if (arg == "-c")
+      cu_counts = parse_list(value);
+    else if (arg == "-a")
+      total = std::stoi(value);
+    else if (arg == "-b")
+      batch_size = std::stoi(value);
+    else if (arg == "-j")
+      json_fn = value;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (xclbin_fn.empty() || !total || !batch_size) {
     usage();
     return 1;
   }
 
-  std::string xclbin_fn = argv[2];
+  auto xclbin = xrt::xclbin(xclbin_fn);
+  std::vector<std::string> cu_names;
+  for (auto& cu : xclbin.get_kernel(kname).get_cus()) {
+    auto name = cu.get_name();
+    cu_names.push_back(name.substr(name.find(':') + 1));
+  }
+  if (cu_names.empty())
+    throw std::runtime_error("No compute units for kernel " + kname);
+
+  if (cu_counts.empty()) {
+    for (unsigned int n = 1; n < cu_names.size(); n *= 2)
+      cu_counts.push_back(n);
+    cu_counts.push_back(static_cast<unsigned int>(cu_names.size()));
+  }
+
+  auto device = xrt::device(device_index);
+  auto uuid = device.load_xclbin(xclbin);
+
+  std::vector<result> results;
+  for (auto api : { api_type::run, api_type::runlist }) {
+    for (auto cus : cu_counts) {
+      if (cus > cu_names.size()) {
+        std::cout << "Skipping " << cus << " CUs, kernel has " << cu_names.size() << std::endl;
+        continue;
+      }
+      auto kernel = getKernel(device, uuid, kname, cu_names, cus);
+      for (auto threads : thread_counts) {
+        for (auto depth : depths) {
+          results.push_back(runConfig(device, kernel, { api, cus, threads, depth }, total, batch_size));
+          auto& r = results.back();
+          std::cout << "api: " << to_string(api) << " cus: " << cus
+                    << " threads: " << threads << " depth: " << depth
+                    << " iops: " << std::setprecision(0) << std::fixed << r.iops()
+                    << std::endl;
+        }
+      }
+    }
+  }
 
-  auto device = xrt::device(0);
-  auto uuid = device.load_xclbin(xclbin_fn);
+  std::cout << std::endl;
+  printTable(results);
 
-  testSingleThread(device, uuid);
+  if (!json_fn.empty())
+    writeJson(json_fn, kname, results);
 
   return 0;
 }
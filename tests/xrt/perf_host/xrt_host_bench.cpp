@@ -0,0 +1,341 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2022 Xilinx, Inc. All rights reserved.
+ */
+
+// Microbenchmarks of the host code paths of XRT.  Meant to run on the
+// noop shim (XCL_EMULATION_MODE=noop) where commands complete as soon
+// as they are submitted, so the numbers are the cost of XRT itself.
+//
+// % XCL_EMULATION_MODE=noop xrt_host_bench -k verify.xclbin -n verify \
+//     --benchmark_out=host_bench.json --benchmark_out_format=json
+
+#include <CL/cl.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "experimental/xrt_enqueue.h"
+
+namespace {
+
+std::string xclbin_fnm;
+std::string kernel_name = "hello";
+unsigned int device_index = 0;
+
+// Device with the xclbin loaded, shared by all native API benchmarks
+struct native_env
+{
+  xrt::device device;
+  xrt::uuid uuid;
+  xrt::kernel kernel;
+
+  native_env()
+    : device(device_index)
+    , uuid(device.load_xclbin(xclbin_fnm))
+    , kernel(device, uuid, kernel_name)
+  {}
+
+  static native_env&
+  get()
+  {
+    static native_env env;
+    return env;
+  }
+};
+
+// OpenCL objects for the xclbin, shared by all OpenCL benchmarks
+struct ocl_env
+{
+  cl_context context = nullptr;
+  cl_command_queue queue = nullptr;
+  cl_program program = nullptr;
+  cl_kernel kernel = nullptr;
+  cl_mem mem = nullptr;
+
+  static void
+  check(cl_int err, const char* what)
+  {
+    if (err != CL_SUCCESS)
+      throw std::runtime_error(std::string(what) + " failed with " + std::to_string(err));
+  }
+
+  ocl_env()
+  {
+    cl_int err = CL_SUCCESS;
+    cl_platform_id platform = nullptr;
+    check(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+
+    cl_uint num_devices = 0;
+    check(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 0, nullptr, &num_devices), "clGetDeviceIDs");
+    if (device_index >= num_devices)
+      throw std::runtime_error("No OpenCL device " + std::to_string(device_index));
+    std::vector<cl_device_id> devices(num_devices);
+    check(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, num_devices, devices.data(), nullptr), "clGetDeviceIDs");
+    auto device = devices[device_index];
+
+    context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+    check(err, "clCreateContext");
+    queue = clCreateCommandQueue(context, device, 0, &err);
+    check(err, "clCreateCommandQueue");
+
+    std::ifstream stream(xclbin_fnm, std::ios::binary);
+    std::vector<unsigned char> binary((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    auto data = binary.data();
+    auto size = binary.size();
+    program = clCreateProgramWithBinary(context, 1, &device, &size, const_cast<const unsigned char**>(&data), nullptr, &err);
+    check(err, "clCreateProgramWithBinary");
+    kernel = clCreateKernel(program, kernel_name.c_str(), &err);
+    check(err, "clCreateKernel");
+    mem = clCreateBuffer(context, CL_MEM_READ_WRITE, 1024, nullptr, &err);
+    check(err, "clCreateBuffer");
+    check(clSetKernelArg(kernel, 0, sizeof(cl_mem), &mem), "clSetKernelArg");
+  }
+
+  ~ocl_env()
+  {
+    clReleaseMemObject(mem);
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+  }
+
+  static ocl_env&
+  get()
+  {
+    static ocl_env env;
+    return env;
+  }
+};
+
+// Construct kernel object, includes xclbin metadata lookup and CU context
+void
+kernel_construct(benchmark::State& state)
+{
+  auto& env = native_env::get();
+  for (auto _ : state) {
+    xrt::kernel kernel(env.device, env.uuid, kernel_name);
+    benchmark::DoNotOptimize(kernel);
+  }
+}
+BENCHMARK(kernel_construct);
+
+// Create a run object for an existing kernel
+void
+run_create(benchmark::State& state)
+{
+  auto& env = native_env::get();
+  for (auto _ : state) {
+    xrt::run run(env.kernel);
+    benchmark::DoNotOptimize(run);
+  }
+}
+BENCHMARK(run_create);
+
+// Start and wait for one command at a time
+void
+run_start_wait(benchmark::State& state)
+{
+  auto& env = native_env::get();
+  xrt::run run(env.kernel);
+  run.set_arg(0, xrt::bo(env.device, 1024, env.kernel.group_id(0)));
+  for (auto _ : state) {
+    run.start();
+    run.wait();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(run_start_wait);
+
+// Set a scalar argument and start a command, the argument update
+// path of xrt::run
+void
+run_set_arg_start_wait(benchmark::State& state)
+{
+  auto& env = native_env::get();
+  xrt::run run(env.kernel);
+  xrt::bo bo(env.device, 1024, env.kernel.group_id(0));
+  for (auto _ : state) {
+    run.set_arg(0, bo);
+    run.start();
+    run.wait();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(run_set_arg_start_wait);
+
+// Allocate and free a buffer of range(0) bytes
+void
+bo_alloc(benchmark::State& state)
+{
+  auto& env = native_env::get();
+  auto size = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    xrt::bo bo(env.device, size, env.kernel.group_id(0));
+    benchmark::DoNotOptimize(bo);
+  }
+}
+BENCHMARK(bo_alloc)->RangeMultiplier(16)->Range(4 << 10, 64 << 20);
+
+// Sync a buffer of range(0) bytes, on the noop shim this is the
+// bookkeeping of the sync without any data transfer
+void
+bo_sync(benchmark::State& state)
+{
+  auto& env = native_env::get();
+  auto size = static_cast<size_t>(state.range(0));
+  xrt::bo bo(env.device, size, env.kernel.group_id(0));
+  for (auto _ : state) {
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(bo_sync)->RangeMultiplier(16)->Range(4 << 10, 64 << 20);
+
+// Enqueue a chain of range(0) dependent syncs and runs on an event
+// queue and wait for the last event
+void
+event_chain(benchmark::State& state)
+{
+  static xrt::event_queue queue;
+  static xrt::event_handler handler(queue);
+
+  auto& env = native_env::get();
+  auto length = static_cast<size_t>(state.range(0));
+  xrt::bo bo(env.device, 1024, env.kernel.group_id(0));
+  std::vector<xrt::run> runs;
+  for (size_t i = 0; i < length; ++i)
+    runs.emplace_back(env.kernel);
+
+  auto sync = [] (xrt::bo& bo, xclBOSyncDirection dir) { bo.sync(dir); };
+  for (auto _ : state) {
+    xrt::event ev;
+    for (auto& run : runs) {
+      auto es = ev
+        ? queue.enqueue_with_waitlist(sync, {ev}, bo, XCL_BO_SYNC_BO_TO_DEVICE)
+        : queue.enqueue(sync, bo, XCL_BO_SYNC_BO_TO_DEVICE);
+      ev = queue.enqueue_with_waitlist(run, {es}, bo);
+    }
+    ev.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * length * 2);
+}
+BENCHMARK(event_chain)->RangeMultiplier(4)->Range(1, 64);
+
+// clEnqueueTask to completion
+void
+ocl_enqueue_task(benchmark::State& state)
+{
+  auto& env = ocl_env::get();
+  for (auto _ : state) {
+    ocl_env::check(clEnqueueTask(env.queue, env.kernel, 0, nullptr, nullptr), "clEnqueueTask");
+    ocl_env::check(clFinish(env.queue), "clFinish");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ocl_enqueue_task);
+
+// range(0) clEnqueueTask commands in flight before clFinish
+void
+ocl_enqueue_task_batch(benchmark::State& state)
+{
+  auto& env = ocl_env::get();
+  auto batch = state.range(0);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < batch; ++i)
+      ocl_env::check(clEnqueueTask(env.queue, env.kernel, 0, nullptr, nullptr), "clEnqueueTask");
+    ocl_env::check(clFinish(env.queue), "clFinish");
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(ocl_enqueue_task_batch)->RangeMultiplier(4)->Range(4, 256);
+
+// Blocking write of a small buffer
+void
+ocl_enqueue_write(benchmark::State& state)
+{
+  auto& env = ocl_env::get();
+  char data[1024] = {0};
+  for (auto _ : state)
+    ocl_env::check(clEnqueueWriteBuffer(env.queue, env.mem, CL_TRUE, 0, sizeof(data), data, 0, nullptr, nullptr),
+                   "clEnqueueWriteBuffer");
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ocl_enqueue_write);
+
+void
+usage()
+{
+  std::cout << "Usage: xrt_host_bench -k <xclbin> [options] [benchmark options]\n"
+            << "options:\n"
+            << "    -d <index>        device index (default 0)\n"
+            << "    -n <name>         kernel name, first argument must be a buffer (default hello)\n"
+            << "Run with XCL_EMULATION_MODE=noop to measure host code only. Google Benchmark\n"
+            << "options, e.g. --benchmark_out=<file> --benchmark_out_format=json, are passed through.\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  // Consumes the --benchmark_* options
+  benchmark::Initialize(&argc, argv);
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "-k")
+      xclbin_fnm = value;
+    else if (arg == "-d")
+      device_index = std::stoi(value);
+    else if (arg == "-n")
+      kernel_name = value;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (xclbin_fnm.empty()) {
+    usage();
+    return 1;
+  }
+
+  auto emulation = std::getenv("XCL_EMULATION_MODE");
+  benchmark::AddCustomContext("xcl_emulation_mode", emulation ? emulation : "");
+  auto ini = std::getenv("XRT_INI_PATH");
+  benchmark::AddCustomContext("xrt_ini_path", ini ? ini : "");
+  benchmark::AddCustomContext("xclbin", xclbin_fnm);
+  benchmark::AddCustomContext("kernel", kernel_name);
+
+  try {
+    benchmark::RunSpecifiedBenchmarks();
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+    return 1;
+  }
+  benchmark::Shutdown();
+  return 0;
+}
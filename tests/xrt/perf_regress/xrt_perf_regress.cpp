@@ -0,0 +1,513 @@
+/**
+ * SPDX-License-Identifier: Apache-2.0
+ * Copyright (C) 2022 Xilinx, Inc. All rights reserved.
+ */
+
+// Performance regression harness.  Runs a fixed set of throughput and
+// latency scenarios, repeats each scenario to get a confidence interval,
+// writes the results as JSON and compares against a stored baseline
+// for the platform.
+//
+// % xrt_perf_regress -k verify.xclbin -n verify -o results.json -b baselines
+//
+// The baseline for a platform is baselines/<platform>.json, where the
+// platform is the device name as reported by xrt::info::device::name.
+// A baseline is created from a results file of a known good run, e.g.
+//
+// % xrt_perf_regress -k verify.xclbin -n verify -o baselines/<platform>.json
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+using Clock = std::chrono::steady_clock;
+using us_t = std::chrono::duration<double, std::micro>;
+
+namespace {
+
+struct options
+{
+  std::string xclbin_fnm;
+  std::string kernel_name = "hello";
+  std::string device = "0";
+  std::string output_fnm;
+  std::string baseline_dir;
+  std::string filter;
+  unsigned int repeat = 5;
+  double tolerance = 5.0;  // percent
+  bool quick = false;
+};
+
+// Environment shared by all scenarios
+struct env
+{
+  xrt::device device;
+  xrt::uuid uuid;
+  xrt::kernel kernel;
+
+  env(const options& opt)
+    : device(opt.device)
+    , uuid(device.load_xclbin(opt.xclbin_fnm))
+    , kernel(device, uuid, opt.kernel_name)
+  {}
+};
+
+// A scenario produces one value of its metric per repetition
+struct scenario
+{
+  std::string name;
+  std::string unit;
+  bool higher_is_better;
+  std::function<double(env&)> measure;
+};
+
+// Statistics of the repetitions of a scenario
+struct stats
+{
+  std::vector<double> samples;
+  double mean = 0;
+  double stddev = 0;
+  double ci95 = 0;  // half width of 95% confidence interval of mean
+  double min = 0;
+  double max = 0;
+};
+
+enum class verdict { pass, regression, improvement, no_baseline };
+
+const char*
+to_string(verdict v)
+{
+  switch (v) {
+  case verdict::pass:
+    return "pass";
+  case verdict::regression:
+    return "regression";
+  case verdict::improvement:
+    return "improvement";
+  case verdict::no_baseline:
+    return "no_baseline";
+  }
+  return "unknown";
+}
+
+struct result
+{
+  const scenario* sc;
+  stats st;
+  verdict vd = verdict::no_baseline;
+  double baseline_mean = 0;
+  double change_pct = 0;
+};
+
+// Two sided 95% Student t critical value for n-1 degrees of freedom
+double
+t_critical(size_t n)
+{
+  static const double table[] = {
+    0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+    2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+    2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+    2.042
+  };
+  auto df = n - 1;
+  return df < std::size(table) ? table[df] : 1.960;
+}
+
+stats
+compute_stats(std::vector<double> samples)
+{
+  stats st;
+  st.samples = std::move(samples);
+  auto n = st.samples.size();
+  st.mean = std::accumulate(st.samples.begin(), st.samples.end(), 0.0) / n;
+  st.min = *std::min_element(st.samples.begin(), st.samples.end());
+  st.max = *std::max_element(st.samples.begin(), st.samples.end());
+  if (n < 2)
+    return st;
+
+  double sq = 0;
+  for (auto s : st.samples)
+    sq += (s - st.mean) * (s - st.mean);
+  st.stddev = std::sqrt(sq / (n - 1));
+  st.ci95 = t_critical(n) * st.stddev / std::sqrt(static_cast<double>(n));
+  return st;
+}
+
+// Nearest rank percentile of sorted samples
+double
+percentile(const std::vector<double>& sorted, double pct)
+{
+  auto rank = static_cast<size_t>(std::ceil(pct / 100.0 * sorted.size()));
+  return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+}
+
+////////////////////////////////////////////////////////////////
+// Scenarios
+////////////////////////////////////////////////////////////////
+unsigned int commands = 10000;  // commands per repetition
+unsigned int iterations = 20;   // bo syncs per repetition
+
+// Commands per second with 'depth' runs kept in flight
+double
+iops(env& e, unsigned int depth)
+{
+  std::vector<xrt::run> runs;
+  for (unsigned int i = 0; i < depth; ++i) {
+    xrt::run run(e.kernel);
+    run.set_arg(0, xrt::bo(e.device, 20, e.kernel.group_id(0)));
+    runs.push_back(std::move(run));
+  }
+
+  unsigned int issued = 0, completed = 0;
+  auto start = Clock::now();
+  for (auto& run : runs) {
+    run.start();
+    if (++issued == commands)
+      break;
+  }
+
+  for (size_t i = 0; completed < issued; i = (i + 1) % runs.size()) {
+    runs[i].wait();
+    ++completed;
+    if (issued < commands) {
+      runs[i].start();
+      ++issued;
+    }
+  }
+  auto end = Clock::now();
+  return completed / std::chrono::duration<double>(end - start).count();
+}
+
+// Start to completion latency percentile of one command at a time in us
+double
+latency(env& e, double pct)
+{
+  xrt::run run(e.kernel);
+  run.set_arg(0, xrt::bo(e.device, 20, e.kernel.group_id(0)));
+
+  std::vector<double> samples;
+  samples.reserve(commands / 10);
+  for (unsigned int i = 0; i < commands / 10; ++i) {
+    auto start = Clock::now();
+    run.start();
+    run.wait();
+    samples.push_back(us_t(Clock::now() - start).count());
+  }
+  std::sort(samples.begin(), samples.end());
+  return percentile(samples, pct);
+}
+
+// Buffer sync bandwidth in MB/s
+double
+bandwidth(env& e, size_t size, xclBOSyncDirection dir)
+{
+  xrt::bo bo(e.device, size, e.kernel.group_id(0));
+  bo.sync(dir);
+  auto start = Clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    bo.sync(dir);
+  auto end = Clock::now();
+  return size * iterations / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+std::vector<scenario>
+get_scenarios()
+{
+  return {
+    { "iops_depth1",     "cmd/s", true,  [](env& e) { return iops(e, 1); } },
+    { "iops_depth32",    "cmd/s", true,  [](env& e) { return iops(e, 32); } },
+    { "iops_depth128",   "cmd/s", true,  [](env& e) { return iops(e, 128); } },
+    { "latency_p50",     "us",    false, [](env& e) { return latency(e, 50.0); } },
+    { "latency_p99",     "us",    false, [](env& e) { return latency(e, 99.0); } },
+    { "h2d_4KB",         "MB/s",  true,  [](env& e) { return bandwidth(e, 4 << 10, XCL_BO_SYNC_BO_TO_DEVICE); } },
+    { "d2h_4KB",         "MB/s",  true,  [](env& e) { return bandwidth(e, 4 << 10, XCL_BO_SYNC_BO_FROM_DEVICE); } },
+    { "h2d_1MB",         "MB/s",  true,  [](env& e) { return bandwidth(e, 1 << 20, XCL_BO_SYNC_BO_TO_DEVICE); } },
+    { "d2h_1MB",         "MB/s",  true,  [](env& e) { return bandwidth(e, 1 << 20, XCL_BO_SYNC_BO_FROM_DEVICE); } },
+    { "h2d_64MB",        "MB/s",  true,  [](env& e) { return bandwidth(e, 64 << 20, XCL_BO_SYNC_BO_TO_DEVICE); } },
+    { "d2h_64MB",        "MB/s",  true,  [](env& e) { return bandwidth(e, 64 << 20, XCL_BO_SYNC_BO_FROM_DEVICE); } },
+  };
+}
+
+////////////////////////////////////////////////////////////////
+// Baseline comparison
+////////////////////////////////////////////////////////////////
+
+// Compare against baseline mean.  A scenario regresses only when the
+// whole confidence interval of the current run is worse than the
+// baseline by more than the tolerance, so noise within the interval
+// does not fail the run.
+void
+compare(result& r, double baseline_mean, double tolerance)
+{
+  r.baseline_mean = baseline_mean;
+  r.change_pct = (r.st.mean - baseline_mean) * 100.0 / baseline_mean;
+  auto band = baseline_mean * tolerance / 100.0;
+  auto lo = r.st.mean - r.st.ci95;
+  auto hi = r.st.mean + r.st.ci95;
+
+  bool worse = r.sc->higher_is_better ? hi < baseline_mean - band : lo > baseline_mean + band;
+  bool better = r.sc->higher_is_better ? lo > baseline_mean + band : hi < baseline_mean - band;
+  r.vd = worse ? verdict::regression : better ? verdict::improvement : verdict::pass;
+}
+
+// Map of scenario name to baseline mean
+std::map<std::string, double>
+read_baseline(const std::string& fnm)
+{
+  std::map<std::string, double> baseline;
+  std::ifstream ifs(fnm);
+  if (!ifs)
+    return baseline;
+
+  boost::property_tree::ptree pt;
+  boost::property_tree::read_json(ifs, pt);
+  for (auto& entry : pt.get_child("results"))
+    baseline[entry.second.get<std::string>("name")] = entry.second.get<double>("mean");
+  return baseline;
+}
+
+// Platform names can contain characters not suited for file names
+std::string
+baseline_file(const std::string& dir, std::string platform)
+{
+  std::replace_if(platform.begin(), platform.end(),
+                  [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-'; },
+                  '_');
+  return dir + "/" + platform + ".json";
+}
+
+////////////////////////////////////////////////////////////////
+// Output
+////////////////////////////////////////////////////////////////
+std::string
+timestamp()
+{
+  auto now = std::time(nullptr);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  return buf;
+}
+
+void
+write_json(const std::string& fnm, const options& opt, const std::string& platform,
+           const std::string& baseline, const std::vector<result>& results, bool regressed)
+{
+  std::ofstream ofs(fnm);
+  if (!ofs)
+    throw std::runtime_error("Failed to open " + fnm);
+
+  ofs << std::setprecision(6) << std::fixed;
+  ofs << "{\n"
+      << "  \"platform\": \"" << platform << "\",\n"
+      << "  \"xclbin\": \"" << opt.xclbin_fnm << "\",\n"
+      << "  \"kernel\": \"" << opt.kernel_name << "\",\n"
+      << "  \"date\": \"" << timestamp() << "\",\n"
+      << "  \"repeat\": " << opt.repeat << ",\n"
+      << "  \"tolerance_pct\": " << opt.tolerance << ",\n"
+      << "  \"baseline\": \"" << baseline << "\",\n"
+      << "  \"verdict\": \"" << (regressed ? "fail" : "pass") << "\",\n"
+      << "  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto& r = results[i];
+    ofs << "    { \"name\": \"" << r.sc->name << "\""
+        << ", \"unit\": \"" << r.sc->unit << "\""
+        << ", \"higher_is_better\": " << (r.sc->higher_is_better ? "true" : "false")
+        << ", \"mean\": " << r.st.mean
+        << ", \"stddev\": " << r.st.stddev
+        << ", \"ci95\": " << r.st.ci95
+        << ", \"min\": " << r.st.min
+        << ", \"max\": " << r.st.max
+        << ", \"samples\": [";
+    for (size_t s = 0; s < r.st.samples.size(); ++s)
+      ofs << (s ? ", " : "") << r.st.samples[s];
+    ofs << "]"
+        << ", \"verdict\": \"" << to_string(r.vd) << "\"";
+    if (r.vd != verdict::no_baseline)
+      ofs << ", \"baseline_mean\": " << r.baseline_mean
+          << ", \"change_pct\": " << r.change_pct;
+    ofs << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  ofs << "  ]\n}\n";
+}
+
+void
+print_table(const std::vector<result>& results)
+{
+  std::cout << std::left << std::setw(16) << "Scenario" << std::right
+            << std::setw(14) << "Mean"
+            << std::setw(12) << "+/-95%"
+            << std::setw(14) << "Baseline"
+            << std::setw(10) << "Change"
+            << "  " << "Verdict" << std::endl;
+  for (auto& r : results) {
+    std::cout << std::left << std::setw(16) << r.sc->name << std::right
+              << std::setprecision(2) << std::fixed
+              << std::setw(14) << r.st.mean
+              << std::setw(12) << r.st.ci95;
+    if (r.vd == verdict::no_baseline)
+      std::cout << std::setw(14) << "-" << std::setw(10) << "-";
+    else
+      std::cout << std::setw(14) << r.baseline_mean
+                << std::setw(9) << r.change_pct << "%";
+    std::cout << "  " << to_string(r.vd) << " (" << r.sc->unit << ")" << std::endl;
+  }
+}
+
+void
+usage()
+{
+  std::cout << "Usage: xrt_perf_regress -k <xclbin> [options]\n"
+            << "options:\n"
+            << "    -d <device>       device index or BDF (default 0)\n"
+            << "    -n <name>         kernel name, first argument must be a buffer (default hello)\n"
+            << "    -r <n>            repetitions of each scenario (default 5)\n"
+            << "    -t <percent>      regression tolerance in percent (default 5)\n"
+            << "    -s <substring>    run only scenarios whose name contains substring\n"
+            << "    -o <file>         write results as JSON to file\n"
+            << "    -b <dir>          compare against baseline <dir>/<platform>.json\n"
+            << "    -q                quick run with fewer commands per repetition\n"
+            << "Exit status is 1 when any scenario regressed against the baseline.\n";
+}
+
+int
+run(int argc, char* argv[])
+{
+  options opt;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h") {
+      usage();
+      return 0;
+    }
+    if (arg == "-q") {
+      opt.quick = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "-k")
+      opt.xclbin_fnm = value;
+    else if (arg == "-d")
+      opt.device = value;
+    else if (arg == "-n")
+      opt.kernel_name = value;
+    else if (arg == "-r")
+      opt.repeat = std::stoi(value);
+    else if (arg == "-t")
+      opt.tolerance = std::stod(value);
+    else if (arg == "-s")
+      opt.filter = value;
+    else if (arg == "-o")
+      opt.output_fnm = value;
+    else if (arg == "-b")
+      opt.baseline_dir = value;
+    else {
+      usage();
+      return 1;
+    }
+  }
+
+  if (opt.xclbin_fnm.empty() || !opt.repeat) {
+    usage();
+    return 1;
+  }
+
+  if (opt.quick) {
+    commands = 1000;
+    iterations = 4;
+  }
+
+  env e(opt);
+  auto platform = e.device.get_info<xrt::info::device::name>();
+  std::cout << "Platform: " << platform << std::endl;
+
+  std::string baseline_fnm;
+  std::map<std::string, double> baseline;
+  if (!opt.baseline_dir.empty()) {
+    baseline_fnm = baseline_file(opt.baseline_dir, platform);
+    baseline = read_baseline(baseline_fnm);
+    if (baseline.empty())
+      std::cout << "No baseline " << baseline_fnm << ", reporting results only" << std::endl;
+  }
+
+  auto scenarios = get_scenarios();
+  std::vector<result> results;
+  bool regressed = false;
+  for (auto& sc : scenarios) {
+    if (!opt.filter.empty() && sc.name.find(opt.filter) == std::string::npos)
+      continue;
+
+    // One warm up repetition, not recorded
+    sc.measure(e);
+
+    std::vector<double> samples;
+    for (unsigned int i = 0; i < opt.repeat; ++i)
+      samples.push_back(sc.measure(e));
+
+    result r;
+    r.sc = &sc;
+    r.st = compute_stats(std::move(samples));
+    auto itr = baseline.find(sc.name);
+    if (itr != baseline.end() && itr->second != 0)
+      compare(r, itr->second, opt.tolerance);
+    regressed = regressed || r.vd == verdict::regression;
+
+    std::cout << sc.name << ": " << std::setprecision(2) << std::fixed
+              << r.st.mean << " +/- " << r.st.ci95 << " " << sc.unit << std::endl;
+    results.push_back(std::move(r));
+  }
+
+  std::cout << std::endl;
+  print_table(results);
+
+  if (!opt.output_fnm.empty())
+    write_json(opt.output_fnm, opt, platform, baseline_fnm, results, regressed);
+
+  if (regressed) {
+    std::cout << "TEST FAILED: performance regression" << std::endl;
+    return 1;
+  }
+
+  std::cout << "TEST PASSED" << std::endl;
+  return 0;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return run(argc, argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+  }
+  catch (...) {
+    std::cout << "TEST FAILED" << std::endl;
+  }
+
+  return 1;
+}